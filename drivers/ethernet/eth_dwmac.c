@@ -133,6 +133,7 @@ static int dwmac_send(const struct device *dev, struct net_pkt *pkt)
 	unsigned int d_idx;
 	struct dwmac_dma_desc *d;
 	uint32_t des2_flags, des3_flags;
+	uintptr_t addr;
 
 	LOG_DBG("pkt len/frags=%d/%d", pkt_len, net_pkt_get_nbfrags(pkt));
 
@@ -161,7 +162,7 @@ static int dwmac_send(const struct device *dev, struct net_pkt *pkt)
 			k_sem_give(&p->free_tx_descs);
 			goto abort;
 		}
-		sys_cache_data_flush_range(pinned->data, pinned->len);
+		addr = net_pkt_frag_dma_map(pinned);
 		p->tx_frags[d_idx] = pinned;
 		LOG_DBG("d[%d]: frag %p pinned %p len %d", d_idx,
 			frag->data, pinned->data, pinned->len);
@@ -175,8 +176,8 @@ static int dwmac_send(const struct device *dev, struct net_pkt *pkt)
 
 		/* fill the descriptor */
 		d = &p->tx_descs[d_idx];
-		d->des0 = phys_lo32(pinned->data);
-		d->des1 = phys_hi32(pinned->data);
+		d->des0 = lo32(addr);
+		d->des1 = hi32(addr);
 		d->des2 = pinned->len | des2_flags;
 		d->des3 = pkt_len | des3_flags;
 
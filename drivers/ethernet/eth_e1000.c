@@ -47,6 +47,7 @@ static const char *e1000_reg_to_string(enum e1000_reg_t r)
 	_(ICR);
 	_(ICS);
 	_(IMS);
+	_(IMC);
 	_(RCTL);
 	_(TCTL);
 	_(RDBAL);
@@ -112,55 +113,94 @@ static const struct device *e1000_get_ptp_clock(const struct device *dev)
 }
 #endif
 
-static int e1000_tx(struct e1000_dev *dev, void *buf, size_t len)
+/* Fill one descriptor per segment and wait until the last one is sent.
+ * Called with tx_lock held, which is kept until the packet is sent, so
+ * the ring is empty on entry even with several TX threads.
+ */
+static int e1000_tx(struct e1000_dev *dev, struct net_pkt_dma_seg *segs,
+		    int count)
 {
-	hexdump(buf, len, "%zu byte(s)", len);
+	unsigned int idx = dev->tx_tail;
+	volatile struct e1000_tx *desc = NULL;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		desc = &dev->tx[idx];
+
+		desc->addr = segs[i].addr;
+		desc->len = segs[i].len;
+		desc->sta = 0;
+		desc->cmd = (i == count - 1) ? (TDESC_EOP | TDESC_RS) : 0;
+
+		idx = (idx + 1) % E1000_TX_DESC_COUNT;
+	}
 
-	dev->tx.addr = POINTER_TO_INT(buf);
-	dev->tx.len = len;
-	dev->tx.cmd = TDESC_EOP | TDESC_RS;
+	dev->tx_tail = idx;
 
-	iow32(dev, TDT, 1);
+	iow32(dev, TDT, idx);
 
-	while (!(dev->tx.sta)) {
+	while (!(desc->sta)) {
 		k_yield();
 	}
 
-	LOG_DBG("tx.sta: 0x%02hx", dev->tx.sta);
+	LOG_DBG("tx.sta: 0x%02hx", desc->sta);
 
-	return (dev->tx.sta & TDESC_STA_DD) ? 0 : -EIO;
+	return (desc->sta & TDESC_STA_DD) ? 0 : -EIO;
 }
 
 static int e1000_send(const struct device *ddev, struct net_pkt *pkt)
 {
 	struct e1000_dev *dev = ddev->data;
+	/* One descriptor stays free so that the ring never looks empty */
+	struct net_pkt_dma_seg segs[E1000_TX_DESC_COUNT - 1];
 	size_t len = net_pkt_get_len(pkt);
+	int count;
+	int ret;
+
+	k_mutex_lock(&dev->tx_lock, K_FOREVER);
+
+	count = net_pkt_dma_map(pkt, segs, ARRAY_SIZE(segs));
+	if (count == -E2BIG) {
+		/* Too many fragments for the ring, send a linear copy */
+		if (net_pkt_read(pkt, dev->txb, len)) {
+			ret = -EIO;
+			goto out;
+		}
+
+		hexdump(dev->txb, len, "%zu byte(s)", len);
 
-	if (net_pkt_read(pkt, dev->txb, len)) {
-		return -EIO;
+		segs[0].addr = net_pkt_dma_map_data(dev->txb, len);
+		segs[0].len = len;
+		count = 1;
+	} else if (count < 0) {
+		ret = count;
+		goto out;
 	}
 
-	return e1000_tx(dev, dev->txb, len);
+	LOG_DBG("%zu byte(s) in %d segment(s)", len, count);
+
+	ret = e1000_tx(dev, segs, count);
+
+out:
+	k_mutex_unlock(&dev->tx_lock);
+
+	return ret;
 }
 
-static struct net_pkt *e1000_rx(struct e1000_dev *dev)
+static struct net_pkt *e1000_rx(struct e1000_dev *dev,
+				volatile struct e1000_rx *desc)
 {
 	struct net_pkt *pkt = NULL;
 	void *buf;
 	ssize_t len;
 
-	LOG_DBG("rx.sta: 0x%02hx", dev->rx.sta);
+	LOG_DBG("rx.sta: 0x%02hx", desc->sta);
 
-	if (!(dev->rx.sta & RDESC_STA_DD)) {
-		LOG_ERR("RX descriptor not ready");
-		goto out;
-	}
-
-	buf = INT_TO_POINTER((uint32_t)dev->rx.addr);
-	len = dev->rx.len - 4;
+	buf = INT_TO_POINTER((uint32_t)desc->addr);
+	len = desc->len - 4;
 
 	if (len <= 0) {
-		LOG_ERR("Invalid RX descriptor length: %hu", dev->rx.len);
+		LOG_ERR("Invalid RX descriptor length: %hu", desc->len);
 		goto out;
 	}
 
@@ -183,48 +223,119 @@ out:
 	return pkt;
 }
 
-static void e1000_isr(const struct device *ddev)
+static struct net_if *e1000_rx_iface(struct e1000_dev *dev,
+				     struct net_pkt *pkt)
 {
-	struct e1000_dev *dev = ddev->data;
-	uint32_t icr = ior32(dev, ICR); /* Cleared upon read */
 	uint16_t vlan_tag = NET_VLAN_TAG_UNSPEC;
 
-	icr &= ~(ICR_TXDW | ICR_TXQE);
-
-	if (icr & ICR_RXO) {
-		struct net_pkt *pkt = e1000_rx(dev);
-
-		icr &= ~ICR_RXO;
-
-		if (pkt) {
 #if defined(CONFIG_NET_VLAN)
-			struct net_eth_hdr *hdr = NET_ETH_HDR(pkt);
+	struct net_eth_hdr *hdr = NET_ETH_HDR(pkt);
 
-			if (ntohs(hdr->type) == NET_ETH_PTYPE_VLAN) {
-				struct net_eth_vlan_hdr *hdr_vlan =
-					(struct net_eth_vlan_hdr *)
-					NET_ETH_HDR(pkt);
+	if (ntohs(hdr->type) == NET_ETH_PTYPE_VLAN) {
+		struct net_eth_vlan_hdr *hdr_vlan =
+			(struct net_eth_vlan_hdr *)NET_ETH_HDR(pkt);
 
-				net_pkt_set_vlan_tci(
-					pkt, ntohs(hdr_vlan->vlan.tci));
-				vlan_tag = net_pkt_vlan_tag(pkt);
+		net_pkt_set_vlan_tci(pkt, ntohs(hdr_vlan->vlan.tci));
+		vlan_tag = net_pkt_vlan_tag(pkt);
 
 #if CONFIG_NET_TC_RX_COUNT > 1
-				enum net_priority prio;
+		enum net_priority prio;
 
-				prio = net_vlan2priority(
-						net_pkt_vlan_priority(pkt));
-				net_pkt_set_priority(pkt, prio);
+		prio = net_vlan2priority(net_pkt_vlan_priority(pkt));
+		net_pkt_set_priority(pkt, prio);
 #endif
-			}
+	}
+#else
+	ARG_UNUSED(pkt);
 #endif /* CONFIG_NET_VLAN */
 
-			net_recv_data(get_iface(dev, vlan_tag), pkt);
-		} else {
-			eth_stats_update_errors_rx(get_iface(dev, vlan_tag));
+	return get_iface(dev, vlan_tag);
+}
+
+/* Take the frame of the next completed RX descriptor, if any. The
+ * descriptor is given back to the device, which owns the descriptors from
+ * RDH up to the one before RDT. The last processed one stays unused, so that
+ * a full ring never looks empty.
+ */
+static bool e1000_rx_next(struct e1000_dev *dev, struct net_pkt **pkt)
+{
+	unsigned int idx = dev->rx_head;
+	volatile struct e1000_rx *desc = &dev->rx[idx];
+
+	if (!(desc->sta & RDESC_STA_DD)) {
+		return false;
+	}
+
+	*pkt = e1000_rx(dev, desc);
+
+	desc->sta = 0;
+	dev->rx_head = (idx + 1) % E1000_RX_DESC_COUNT;
+
+	iow32(dev, RDT, idx);
+
+	return true;
+}
+
+#if defined(CONFIG_NET_NAPI)
+static int e1000_poll(struct net_napi *napi, int budget)
+{
+	struct e1000_dev *dev = CONTAINER_OF(napi, struct e1000_dev, napi);
+	struct net_pkt *pkt;
+	struct net_if *iface;
+	int done = 0;
+
+	while (done < budget && e1000_rx_next(dev, &pkt)) {
+		done++;
+
+		if (!pkt) {
+			eth_stats_update_errors_rx(dev->iface);
+			continue;
+		}
+
+		iface = e1000_rx_iface(dev, pkt);
+
+		if (net_napi_recv(napi, iface, pkt) < 0) {
+			net_pkt_unref(pkt);
 		}
 	}
 
+	if (done < budget) {
+		iow32(dev, IMS, IMS_RXT0 | IMS_RXO);
+	}
+
+	return done;
+}
+#endif /* CONFIG_NET_NAPI */
+
+static void e1000_isr(const struct device *ddev)
+{
+	struct e1000_dev *dev = ddev->data;
+	uint32_t icr = ior32(dev, ICR); /* Cleared upon read */
+
+	icr &= ~(ICR_TXDW | ICR_TXQE);
+
+	if (icr & (ICR_RXT0 | ICR_RXO)) {
+		icr &= ~(ICR_RXT0 | ICR_RXO);
+
+#if defined(CONFIG_NET_NAPI)
+		/* Keep the RX interrupt off until polling catches up, the
+		 * frames received meanwhile wait in the ring.
+		 */
+		iow32(dev, IMC, IMS_RXT0 | IMS_RXO);
+		net_napi_schedule(&dev->napi);
+#else
+		struct net_pkt *pkt;
+
+		while (e1000_rx_next(dev, &pkt)) {
+			if (pkt) {
+				net_recv_data(e1000_rx_iface(dev, pkt), pkt);
+			} else {
+				eth_stats_update_errors_rx(dev->iface);
+			}
+		}
+#endif
+	}
+
 	if (icr) {
 		LOG_ERR("Unhandled interrupt, ICR: 0x%x", icr);
 	}
@@ -249,30 +360,36 @@ int e1000_probe(const struct device *ddev)
 	device_map(&dev->address, mbar.phys_addr, mbar.size,
 		   K_MEM_CACHE_NONE);
 
+	k_mutex_init(&dev->tx_lock);
+
 	/* Setup TX descriptor */
 
-	iow32(dev, TDBAL, (uint32_t)POINTER_TO_UINT(&dev->tx));
-	iow32(dev, TDBAH, (uint32_t)((POINTER_TO_UINT(&dev->tx) >> 16) >> 16));
-	iow32(dev, TDLEN, 1*16);
+	iow32(dev, TDBAL, (uint32_t)POINTER_TO_UINT(dev->tx));
+	iow32(dev, TDBAH, (uint32_t)((POINTER_TO_UINT(dev->tx) >> 16) >> 16));
+	iow32(dev, TDLEN, sizeof(dev->tx));
 
 	iow32(dev, TDH, 0);
 	iow32(dev, TDT, 0);
 
 	iow32(dev, TCTL, TCTL_EN);
 
-	/* Setup RX descriptor */
+	/* Setup RX descriptors */
 
-	dev->rx.addr = POINTER_TO_INT(dev->rxb);
-	dev->rx.len = sizeof(dev->rxb);
+	for (int i = 0; i < E1000_RX_DESC_COUNT; i++) {
+		dev->rx[i].addr = POINTER_TO_INT(dev->rxb[i]);
+		dev->rx[i].sta = 0;
+	}
+
+	dev->rx_head = 0;
 
-	iow32(dev, RDBAL, (uint32_t)POINTER_TO_UINT(&dev->rx));
-	iow32(dev, RDBAH, (uint32_t)((POINTER_TO_UINT(&dev->rx) >> 16) >> 16));
-	iow32(dev, RDLEN, 1*16);
+	iow32(dev, RDBAL, (uint32_t)POINTER_TO_UINT(dev->rx));
+	iow32(dev, RDBAH, (uint32_t)((POINTER_TO_UINT(dev->rx) >> 16) >> 16));
+	iow32(dev, RDLEN, sizeof(dev->rx));
 
 	iow32(dev, RDH, 0);
-	iow32(dev, RDT, 1);
+	iow32(dev, RDT, E1000_RX_DESC_COUNT - 1);
 
-	iow32(dev, IMS, IMS_RXO);
+	iow32(dev, IMS, IMS_RXT0 | IMS_RXO);
 
 	ral = ior32(dev, RAL);
 	rah = ior32(dev, RAH);
@@ -298,6 +415,10 @@ static void e1000_iface_init(struct net_if *iface)
 	if (dev->iface == NULL) {
 		dev->iface = iface;
 
+#if defined(CONFIG_NET_NAPI)
+		net_napi_init(&dev->napi, e1000_poll, 0);
+#endif
+
 		/* Do the phy link up only once */
 		config->config_func(dev);
 	}
@@ -192,25 +192,240 @@ static inline int net_capture_send(const struct device *dev, struct net_if *ifac
 #endif
 }
 
+/**
+ * @brief Direction of a captured packet.
+ *
+ * The values match the direction bits of the pcapng epb_flags option.
+ */
+enum net_capture_dir {
+	/** Direction is not known */
+	NET_CAPTURE_DIR_UNKNOWN = 0,
+	/** Packet was received */
+	NET_CAPTURE_DIR_INBOUND = 1,
+	/** Packet is being sent */
+	NET_CAPTURE_DIR_OUTBOUND = 2,
+};
+
+/**
+ * @typedef net_capture_write_cb_t
+ * @brief Callback used to output the pcapng data of the local capture.
+ *
+ * @param data Pointer to the data to write
+ * @param len Length of the data
+ * @param user_data A valid pointer to user data or NULL
+ *
+ * @return 0 if ok, <0 if the data could not be written.
+ */
+typedef int (*net_capture_write_cb_t)(const void *data, size_t len, void *user_data);
+
+/**
+ * @brief Statistics of the local packet capture.
+ */
+struct net_capture_local_stats {
+	/** Number of packets stored in the capture rings */
+	uint32_t captured;
+	/** Number of packets dropped because a capture ring was full */
+	uint32_t dropped;
+	/** Number of packets written out by net_capture_local_drain() */
+	uint32_t drained;
+};
+
+/**
+ * @brief Start capturing network packets to the local capture rings.
+ *
+ * @details Each captured packet is stored, truncated to @a snaplen bytes,
+ * together with its interface, direction and timestamp into a ring buffer
+ * of the CPU that handles the packet. No network packet is allocated or
+ * sent when capturing. The packets that are stored can be selected with
+ * the npf_capture_rules packet filter rule list.
+ *
+ * @param iface Network interface to capture, or NULL to capture all of them.
+ * @param snaplen Max number of bytes stored from each packet. If 0, then
+ *        CONFIG_NET_CAPTURE_LOCAL_SNAPLEN is used.
+ *
+ * @return 0 if ok, <0 if the local capture could not be started.
+ */
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+int net_capture_local_start(struct net_if *iface, size_t snaplen);
+#else
+static inline int net_capture_local_start(struct net_if *iface, size_t snaplen)
+{
+	ARG_UNUSED(iface);
+	ARG_UNUSED(snaplen);
+
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @brief Stop capturing network packets to the local capture rings.
+ *
+ * @details The packets that are already stored can still be drained.
+ *
+ * @return 0 if ok, <0 if the local capture was not running.
+ */
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+int net_capture_local_stop(void);
+#else
+static inline int net_capture_local_stop(void)
+{
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @brief Output the pcapng section header of the local capture.
+ *
+ * @details This writes the pcapng section header block and one interface
+ * description block for each network interface. It must be written once
+ * at the start of each pcapng file, before the data returned by
+ * net_capture_local_drain().
+ *
+ * @param cb Callback that writes the data
+ * @param user_data User supplied data
+ *
+ * @return 0 if ok, <0 if the callback failed.
+ */
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+int net_capture_local_write_header(net_capture_write_cb_t cb, void *user_data);
+#else
+static inline int net_capture_local_write_header(net_capture_write_cb_t cb,
+						 void *user_data)
+{
+	ARG_UNUSED(cb);
+	ARG_UNUSED(user_data);
+
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @brief Drain the local capture rings in pcapng format.
+ *
+ * @details Every stored packet is output as a pcapng enhanced packet
+ * block, in timestamp order, and then removed from the capture rings.
+ * Only one caller may drain the rings at a time.
+ *
+ * @param cb Callback that writes the data
+ * @param user_data User supplied data
+ *
+ * @return Number of packets written if ok, <0 if the callback failed.
+ */
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+int net_capture_local_drain(net_capture_write_cb_t cb, void *user_data);
+#else
+static inline int net_capture_local_drain(net_capture_write_cb_t cb,
+					  void *user_data)
+{
+	ARG_UNUSED(cb);
+	ARG_UNUSED(user_data);
+
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @brief Drain the local capture rings to a pcapng file.
+ *
+ * @details The packets are appended to the file. The pcapng header is
+ * written first if the file is empty or does not exist.
+ *
+ * @param path Path of the file
+ *
+ * @return Number of packets written if ok, <0 if the file could not be
+ * written.
+ */
+#if defined(CONFIG_NET_CAPTURE_LOCAL) && defined(CONFIG_FILE_SYSTEM)
+int net_capture_local_save(const char *path);
+#else
+static inline int net_capture_local_save(const char *path)
+{
+	ARG_UNUSED(path);
+
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @brief Get statistics of the local packet capture.
+ *
+ * @param stats Statistics are returned here
+ * @param snaplen Current snap length is returned here, or NULL
+ *
+ * @return True if the local capture is running, False otherwise.
+ */
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+bool net_capture_local_get_stats(struct net_capture_local_stats *stats,
+				 size_t *snaplen);
+#else
+static inline bool net_capture_local_get_stats(struct net_capture_local_stats *stats,
+					       size_t *snaplen)
+{
+	ARG_UNUSED(stats);
+	ARG_UNUSED(snaplen);
+
+	return false;
+}
+#endif
+
 /** @cond INTERNAL_HIDDEN */
 
 /**
  * @brief Check if the network packet needs to be captured or not.
- *        This is called for every network packet being sent.
+ *        This is called for every network packet being sent or received.
  *
- * @param iface Network interface the packet is being sent
- * @param pkt The network packet that is sent
+ * @param iface Network interface the packet is being sent or received
+ * @param pkt The network packet that is sent or received
+ * @param dir Direction of the packet
  */
 #if defined(CONFIG_NET_CAPTURE)
-void net_capture_pkt(struct net_if *iface, struct net_pkt *pkt);
+void net_capture_pkt_with_dir(struct net_if *iface, struct net_pkt *pkt,
+			      enum net_capture_dir dir);
 #else
-static inline void net_capture_pkt(struct net_if *iface, struct net_pkt *pkt)
+static inline void net_capture_pkt_with_dir(struct net_if *iface,
+					    struct net_pkt *pkt,
+					    enum net_capture_dir dir)
 {
 	ARG_UNUSED(iface);
 	ARG_UNUSED(pkt);
+	ARG_UNUSED(dir);
 }
 #endif
 
+/**
+ * @brief Store the network packet to the local capture ring if the local
+ *        capture is running and the packet passes the capture filter.
+ *
+ * @param iface Network interface the packet is being sent or received
+ * @param pkt The network packet that is sent or received
+ * @param dir Direction of the packet
+ */
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+void net_capture_local_pkt(struct net_if *iface, struct net_pkt *pkt,
+			   enum net_capture_dir dir);
+#else
+static inline void net_capture_local_pkt(struct net_if *iface,
+					 struct net_pkt *pkt,
+					 enum net_capture_dir dir)
+{
+	ARG_UNUSED(iface);
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(dir);
+}
+#endif
+
+/**
+ * @brief Check if the network packet needs to be captured or not.
+ *        This is called for every network packet being sent.
+ *
+ * @param iface Network interface the packet is being sent
+ * @param pkt The network packet that is sent
+ */
+static inline void net_capture_pkt(struct net_if *iface, struct net_pkt *pkt)
+{
+	net_capture_pkt_with_dir(iface, pkt, NET_CAPTURE_DIR_OUTBOUND);
+}
+
 struct net_capture_info {
 	const struct device *capture_dev;
 	struct net_if *capture_iface;
@@ -242,6 +242,10 @@ struct coap_packet {
 #if defined(CONFIG_COAP_KEEP_USER_DATA)
 	void *user_data; /* Application specific user data */
 #endif
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	const struct coap_option *options; /* Options parsed by coap_packet_parse() */
+	uint8_t opt_count; /* Number of parsed options */
+#endif
 };
 
 struct coap_option {
@@ -353,6 +357,11 @@ const uint8_t *coap_packet_get_payload(const struct coap_packet *cpkt,
  * @brief Parses the CoAP packet in data, validating it and
  * initializing @a cpkt. @a data must remain valid while @a cpkt is used.
  *
+ * With CONFIG_COAP_OPTION_INDEX, when all the options of the packet fit
+ * in @a options, coap_find_options() looks them up in @a options instead
+ * of parsing the packet again. @a options must then remain valid while
+ * @a cpkt is used as well.
+ *
  * @param cpkt Packet to be initialized from received @a data.
  * @param data Data containing a CoAP packet, its @a data pointer is
  * positioned on the start of the CoAP packet.
@@ -680,6 +689,179 @@ int coap_next_block_for_option(const struct coap_packet *cpkt,
 size_t coap_next_block(const struct coap_packet *cpkt,
 		       struct coap_block_context *ctx);
 
+/** Maximum number of Block2 requests a block stream has in flight. */
+#define COAP_BLOCK_STREAM_MAX_WINDOW 32
+
+struct coap_block_stream;
+
+/**
+ * @brief Callback sending the request for a block of a block stream.
+ *
+ * The request carries the Block2 option added by
+ * coap_block_stream_append_option() for the same @p num. Its response,
+ * or its loss, is reported with coap_block_stream_response() or
+ * coap_block_stream_lost().
+ *
+ * @param stream Block stream.
+ * @param num Number of the block to request.
+ *
+ * @return 0 if the request was sent, negative to abort the transfer.
+ */
+typedef int (*coap_block_stream_request_t)(struct coap_block_stream *stream, uint32_t num);
+
+/**
+ * @brief Callback receiving the data of a block stream.
+ *
+ * Called with the blocks in order, whatever order their responses
+ * arrive in.
+ *
+ * @param stream Block stream.
+ * @param data Block data.
+ * @param len Length of @p data.
+ * @param offset Offset of @p data in the resource.
+ * @param last True for the last block of the resource.
+ *
+ * @return 0 to go on, negative to abort the transfer.
+ */
+typedef int (*coap_block_stream_sink_t)(struct coap_block_stream *stream, const uint8_t *data,
+					size_t len, size_t offset, bool last);
+
+/**
+ * @brief Configuration of a block stream.
+ */
+struct coap_block_stream_config {
+	/** Sends the request for a block. */
+	coap_block_stream_request_t request;
+	/** Receives the data. */
+	coap_block_stream_sink_t sink;
+	/** Application data, not used by the stream. */
+	void *user_data;
+	/** Preferred block size, the server may choose a smaller one. */
+	enum coap_block_size block_size;
+	/** Maximum number of requests in flight, 1 for stop-and-wait. */
+	uint8_t window;
+	/** Number of times a lost request is sent again before giving up. */
+	uint8_t max_retries;
+	/**
+	 * Buffer for the blocks received ahead of the sink. The window is
+	 * limited to one more block than fits in it.
+	 */
+	uint8_t *buf;
+	/** Size of @a buf. */
+	size_t buf_len;
+};
+
+/**
+ * @brief State of a Block2 download streamed to a sink.
+ *
+ * The stream requests up to @a window blocks in parallel once the first
+ * response has told the size of the resource, with its Size2 option, so
+ * the first request should carry a Size2 option of 0. Without the size
+ * the download is stop-and-wait. A 4.29 or 5.03 response from the
+ * server makes the stream fall back to stop-and-wait as well.
+ */
+struct coap_block_stream {
+	/** Configuration given to coap_block_stream_init(). */
+	struct coap_block_stream_config config;
+	/** Size of the resource, 0 if unknown. */
+	size_t total_size;
+	/** Number of bytes given to the sink, including the initial offset. */
+	size_t offset;
+	/** @cond INTERNAL_HIDDEN */
+	uint32_t base;
+	uint32_t last;
+	uint32_t in_flight;
+	uint32_t buffered;
+	uint16_t last_len;
+	uint8_t slots;
+	uint8_t window;
+	uint8_t retries;
+	uint8_t etag_len;
+	uint8_t etag[8];
+	enum coap_block_size block_size;
+	bool negotiated;
+	bool complete;
+	/** @endcond */
+};
+
+/**
+ * @brief Initialize a block stream.
+ *
+ * @param stream Block stream to initialize.
+ * @param config Stream configuration, copied.
+ * @param offset Offset to resume the download from, rounded down to the
+ *        block size. 0 to download the whole resource.
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_block_stream_init(struct coap_block_stream *stream,
+			   const struct coap_block_stream_config *config, size_t offset);
+
+/**
+ * @brief Send the first request of a block stream.
+ *
+ * @param stream Block stream.
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_block_stream_start(struct coap_block_stream *stream);
+
+/**
+ * @brief Append the Block2 option for a block to a request.
+ *
+ * @param stream Block stream.
+ * @param cpkt Request to append the option to.
+ * @param num Number of the requested block.
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_block_stream_append_option(const struct coap_block_stream *stream,
+				    struct coap_packet *cpkt, uint32_t num);
+
+/**
+ * @brief Handle the response to a block request.
+ *
+ * Gives the block to the sink, with the ones received ahead of it, or
+ * keeps it until the blocks before it arrive. Then requests the next
+ * blocks. Duplicate and late responses are ignored.
+ *
+ * @param stream Block stream.
+ * @param num Number of the block the request was for.
+ * @param response Response received.
+ *
+ * @return 0 in case of success, -ENOMSG for an unexpected response code,
+ *         -ESTALE if the resource changed, -EPROTO for an invalid
+ *         Block2 option, or the error returned by a callback.
+ */
+int coap_block_stream_response(struct coap_block_stream *stream, uint32_t num,
+			       const struct coap_packet *response);
+
+/**
+ * @brief Handle the loss of a block request.
+ *
+ * The block is requested again, up to @a max_retries times in a row
+ * without progress.
+ *
+ * @param stream Block stream.
+ * @param num Number of the block the request was for.
+ *
+ * @return 0 in case of success, -ETIMEDOUT if there are no retries left,
+ *         or the error returned by the request callback.
+ */
+int coap_block_stream_lost(struct coap_block_stream *stream, uint32_t num);
+
+/**
+ * @brief Check whether a block stream has received the whole resource.
+ *
+ * @param stream Block stream.
+ *
+ * @return true if the last block was given to the sink.
+ */
+static inline bool coap_block_stream_is_complete(const struct coap_block_stream *stream)
+{
+	return stream->complete;
+}
+
 /**
  * @brief Indicates that the remote device referenced by @a addr, with
  * @a request, wants to observe a resource.
@@ -0,0 +1,285 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ * @brief CoAP service API
+ *
+ * A CoAP server framework serving statically defined resources from a
+ * single thread.
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_COAP_SERVICE_H_
+#define ZEPHYR_INCLUDE_NET_COAP_SERVICE_H_
+
+/**
+ * @brief CoAP service API
+ * @defgroup coap_service CoAP service API
+ * @ingroup networking
+ * @{
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/coap.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/sys/iterable_sections.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Start the service when the CoAP server thread starts. */
+#define COAP_SERVICE_AUTOSTART BIT(0)
+
+/** @cond INTERNAL_HIDDEN */
+
+#if defined(CONFIG_COAP_SERVER)
+#define COAP_SERVER_MESSAGE_SIZE CONFIG_COAP_SERVER_MESSAGE_SIZE
+#define COAP_SERVICE_PENDING_MESSAGES CONFIG_COAP_SERVICE_PENDING_MESSAGES
+#define COAP_SERVICE_OBSERVERS CONFIG_COAP_SERVICE_OBSERVERS
+#define COAP_SERVICE_DEDUP_CACHE_SIZE CONFIG_COAP_SERVICE_DEDUP_CACHE_SIZE
+#else
+#define COAP_SERVER_MESSAGE_SIZE 0
+#define COAP_SERVICE_PENDING_MESSAGES 0
+#define COAP_SERVICE_OBSERVERS 0
+#define COAP_SERVICE_DEDUP_CACHE_SIZE 0
+#endif
+
+struct coap_service;
+
+/* Confirmable message sent by a service, awaiting an ACK or RST */
+struct coap_service_pending {
+	/* In the retransmission timer wheel slot of its expiry */
+	sys_dnode_t node;
+	const struct coap_service *service;
+	struct coap_pending pending;
+	uint8_t buf[COAP_SERVER_MESSAGE_SIZE];
+};
+
+/* Request received by a service, with the ACK or RST sent for it */
+struct coap_service_exchange {
+	struct sockaddr addr;
+	uint32_t timestamp;
+	uint16_t id;
+	uint16_t len;
+	bool used;
+	uint8_t buf[COAP_SERVER_MESSAGE_SIZE];
+};
+
+struct coap_service_data {
+	int sock_fd;
+	/* Root of the URI path trie, negative if not built */
+	int16_t trie_root;
+	struct coap_observer observers[COAP_SERVICE_OBSERVERS];
+	struct coap_service_pending pending[COAP_SERVICE_PENDING_MESSAGES];
+	struct coap_service_exchange exchanges[COAP_SERVICE_DEDUP_CACHE_SIZE];
+};
+
+/** @endcond */
+
+/** CoAP service, defined with @ref COAP_SERVICE_DEFINE. */
+struct coap_service {
+	/** Name of the service. */
+	const char *name;
+	/** Address the service is bound to, NULL for any address. */
+	const char *host;
+	/** Port of the service, 0 for an ephemeral port. */
+	uint16_t *port;
+	/** Service flags, see @ref COAP_SERVICE_AUTOSTART. */
+	uint8_t flags;
+	/** @cond INTERNAL_HIDDEN */
+	struct coap_resource *res_begin;
+	struct coap_resource *res_end;
+	struct coap_service_data *data;
+	/** @endcond */
+};
+
+/**
+ * @brief Define a CoAP service.
+ *
+ * The resources of the service are defined with @ref COAP_RESOURCE_DEFINE.
+ * They are placed in a RAM iterable section named after the service, the
+ * application adds it to the linker script, for example with
+ * @code
+ * zephyr_linker_sources(DATA_SECTIONS sections-ram.ld)
+ * @endcode
+ * where sections-ram.ld contains
+ * @code
+ * ITERABLE_SECTION_RAM(coap_resource_<service name>, 4)
+ * @endcode
+ *
+ * @note If the port pointed to by @p _port is 0, an ephemeral port is used
+ * and written back when the service starts.
+ *
+ * @param _name Name of the service.
+ * @param _host IPv4 or IPv6 address the service is bound to, NULL for the
+ *        unspecified address.
+ * @param[inout] _port Pointer to the port of the service.
+ * @param _flags Service flags, see @ref COAP_SERVICE_AUTOSTART.
+ */
+#define COAP_SERVICE_DEFINE(_name, _host, _port, _flags)                                           \
+	extern struct coap_resource _CONCAT(_coap_resource_##_name, _list_start)[];                \
+	extern struct coap_resource _CONCAT(_coap_resource_##_name, _list_end)[];                  \
+	static struct coap_service_data coap_service_data_##_name = {                              \
+		.sock_fd = -1,                                                                     \
+		.trie_root = -1,                                                                   \
+	};                                                                                         \
+	const STRUCT_SECTION_ITERABLE(coap_service, _name) = {                                     \
+		.name = STRINGIFY(_name),                                                          \
+		.host = _host,                                                                     \
+		.port = (uint16_t *)(_port),                                                       \
+		.flags = (_flags),                                                                 \
+		.res_begin = &_CONCAT(_coap_resource_##_name, _list_start)[0],                     \
+		.res_end = &_CONCAT(_coap_resource_##_name, _list_end)[0],                         \
+		.data = &coap_service_data_##_name,                                                \
+	}
+
+/**
+ * @brief Define a resource of a CoAP service.
+ *
+ * Example:
+ * @code
+ * static const char * const led_path[] = { "led", NULL };
+ *
+ * COAP_RESOURCE_DEFINE(led, my_service, {
+ *	.get = led_get,
+ *	.put = led_put,
+ *	.path = led_path,
+ * });
+ * @endcode
+ *
+ * @param _name Name of the resource.
+ * @param _service Name of the service the resource belongs to.
+ * @param ... Initializer of the @ref coap_resource.
+ */
+#define COAP_RESOURCE_DEFINE(_name, _service, ...)                                                 \
+	STRUCT_SECTION_ITERABLE_ALTERNATE(coap_resource_##_service, coap_resource, _name) =        \
+		__VA_ARGS__
+
+/**
+ * @brief Count the resources of a CoAP service.
+ *
+ * @param _service Pointer to a service.
+ */
+#define COAP_SERVICE_RESOURCE_COUNT(_service) ((_service)->res_end - (_service)->res_begin)
+
+/**
+ * @brief Iterate over all CoAP services.
+ *
+ * @param _it Name of iterator (of type @ref coap_service)
+ */
+#define COAP_SERVICE_FOREACH(_it) STRUCT_SECTION_FOREACH(coap_service, _it)
+
+/**
+ * @brief Iterate over the resources of a CoAP service.
+ *
+ * @param _service Pointer to a service.
+ * @param _it Name of iterator (of type @ref coap_resource)
+ */
+#define COAP_SERVICE_FOREACH_RESOURCE(_service, _it)                                               \
+	for (struct coap_resource *_it = (_service)->res_begin; ({                                 \
+		     __ASSERT(_it <= (_service)->res_end, "unexpected list end location");         \
+		     _it < (_service)->res_end;                                                    \
+	     });                                                                                   \
+	     _it++)
+
+/**
+ * @brief Start a CoAP service.
+ *
+ * Opens the UDP socket of the service and starts serving its resources
+ * from the CoAP server thread.
+ *
+ * @param service Service to start.
+ *
+ * @return 0 if ok, -EALREADY if the service is running, <0 if error.
+ */
+int coap_service_start(const struct coap_service *service);
+
+/**
+ * @brief Stop a CoAP service.
+ *
+ * Closes the socket of the service, pending messages and observers are
+ * dropped.
+ *
+ * @param service Service to stop.
+ *
+ * @return 0 if ok, -EALREADY if the service is not running, <0 if error.
+ */
+int coap_service_stop(const struct coap_service *service);
+
+/**
+ * @brief Check whether a CoAP service is running.
+ *
+ * @param service Service to check.
+ *
+ * @return true if the service is running.
+ */
+bool coap_service_is_running(const struct coap_service *service);
+
+/**
+ * @brief Send a CoAP message from a service.
+ *
+ * A confirmable message is retransmitted until it is acknowledged. An ACK
+ * or RST is remembered as the answer to the request it matches, so that a
+ * duplicate of that request gets the same answer.
+ *
+ * When a resource handler does not send an ACK for a confirmable request,
+ * the server sends an empty one after the handler returns and the
+ * response is expected to follow as a separate confirmable message.
+ *
+ * @param service Service sending the message.
+ * @param cpkt Message to send.
+ * @param addr Destination address.
+ * @param addr_len Length of @a addr.
+ *
+ * @return 0 if ok, <0 if error.
+ */
+int coap_service_send(const struct coap_service *service, const struct coap_packet *cpkt,
+		      const struct sockaddr *addr, socklen_t addr_len);
+
+/**
+ * @brief Send a CoAP message from the service of a resource.
+ *
+ * Same as @ref coap_service_send for the service the resource belongs to.
+ *
+ * @param resource Resource sending the message.
+ * @param cpkt Message to send.
+ * @param addr Destination address.
+ * @param addr_len Length of @a addr.
+ *
+ * @return 0 if ok, <0 if error.
+ */
+int coap_resource_send(const struct coap_resource *resource, const struct coap_packet *cpkt,
+		       const struct sockaddr *addr, socklen_t addr_len);
+
+/**
+ * @brief Handle the Observe option of a request.
+ *
+ * Registers the requester as an observer of the resource, or removes it,
+ * according to the Observe option of the request. Observers are taken from
+ * the pool of the service, and removed automatically when they reject a
+ * notification or stop acknowledging them.
+ *
+ * @param resource Resource the request is for.
+ * @param request Request received by the resource handler.
+ * @param addr Address of the requester.
+ *
+ * @return Value of the Observe option, -ENOENT if the request has none,
+ *         -ENOMEM if no observer is available, <0 if error.
+ */
+int coap_resource_parse_observe(struct coap_resource *resource,
+				const struct coap_packet *request,
+				const struct sockaddr *addr);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* ZEPHYR_INCLUDE_NET_COAP_SERVICE_H_ */
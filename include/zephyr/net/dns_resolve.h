@@ -446,6 +446,91 @@ static inline int dns_cancel_addr_info(uint16_t dns_id)
 	return dns_resolve_cancel(dns_resolve_get_default(), dns_id);
 }
 
+/**
+ * DNS answer cache statistics.
+ */
+struct dns_resolve_cache_stats {
+	/** Queries answered from the cache, including negative answers */
+	uint32_t hits;
+
+	/** Queries answered with a cached "no such name" answer */
+	uint32_t negative_hits;
+
+	/** Queries not found in the cache */
+	uint32_t misses;
+
+	/** Answers stored in the cache */
+	uint32_t insertions;
+
+	/** Live entries replaced to make room for new answers */
+	uint32_t evictions;
+};
+
+/**
+ * @typedef dns_resolve_cache_cb_t
+ * @brief Callback used while iterating over DNS answer cache entries.
+ *
+ * @param name Cached host name.
+ * @param type Query type of the cached answer.
+ * @param addr_count Number of cached addresses, 0 for a negative answer.
+ * @param ttl Remaining time to live of the answer in seconds.
+ * @param user_data User supplied data.
+ */
+typedef void (*dns_resolve_cache_cb_t)(const char *name,
+				       enum dns_query_type type,
+				       int addr_count,
+				       uint32_t ttl,
+				       void *user_data);
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+/**
+ * @brief Remove all answers from the DNS answer cache.
+ *
+ * @return 0 if ok, <0 if error.
+ */
+int dns_resolve_cache_flush(void);
+
+/**
+ * @brief Get DNS answer cache statistics.
+ *
+ * @param stats Statistics are copied here.
+ *
+ * @return 0 if ok, <0 if error.
+ */
+int dns_resolve_cache_get_stats(struct dns_resolve_cache_stats *stats);
+
+/**
+ * @brief Go through all unexpired answers in the DNS answer cache.
+ *
+ * @param cb Callback to call for each cached answer.
+ * @param user_data User supplied data.
+ *
+ * @return Number of cached answers, <0 if error.
+ */
+int dns_resolve_cache_foreach(dns_resolve_cache_cb_t cb, void *user_data);
+#else
+static inline int dns_resolve_cache_flush(void)
+{
+	return -ENOTSUP;
+}
+
+static inline int dns_resolve_cache_get_stats(struct dns_resolve_cache_stats *stats)
+{
+	ARG_UNUSED(stats);
+
+	return -ENOTSUP;
+}
+
+static inline int dns_resolve_cache_foreach(dns_resolve_cache_cb_t cb,
+					    void *user_data)
+{
+	ARG_UNUSED(cb);
+	ARG_UNUSED(user_data);
+
+	return -ENOTSUP;
+}
+#endif /* CONFIG_DNS_RESOLVER_CACHE */
+
 /**
  * @}
  */
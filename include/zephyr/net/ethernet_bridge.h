@@ -28,12 +28,54 @@ extern "C" {
  * @{
  */
 
+/**
+ * @brief Bridge forwarding database entry
+ *
+ * Maps a learned source MAC address to the bridged interface it was
+ * last seen on.
+ */
+struct eth_bridge_fdb_entry {
+	/** Node in the hash bucket of the MAC address */
+	sys_snode_t node;
+	/** Interface the address was learned on, NULL if entry is free */
+	struct net_if *iface;
+	/** Uptime in milliseconds when the address was last seen */
+	uint32_t last_seen;
+	/** Learned MAC address */
+	uint8_t addr[6];
+};
+
+/**
+ * @brief Bridge forwarding statistics
+ */
+struct eth_bridge_stats {
+	/** Frames received from bridged interfaces */
+	uint32_t rx;
+	/** Frames sent to a single learned interface */
+	uint32_t forwarded;
+	/** Frames sent to all interfaces */
+	uint32_t flooded;
+	/** Frames dropped because destination is on the incoming interface */
+	uint32_t filtered;
+	/** Addresses learned */
+	uint32_t learned;
+	/** Addresses that moved to a different interface */
+	uint32_t moved;
+	/** Learned addresses removed by ageing or to make room */
+	uint32_t aged;
+};
+
 /** @cond INTERNAL_HIDDEN */
 
 struct eth_bridge {
 	struct k_mutex lock;
 	sys_slist_t interfaces;
 	sys_slist_t listeners;
+#if defined(CONFIG_NET_ETHERNET_BRIDGE_FDB)
+	struct eth_bridge_fdb_entry fdb[CONFIG_NET_ETHERNET_BRIDGE_FDB_SIZE];
+	sys_slist_t fdb_hash[CONFIG_NET_ETHERNET_BRIDGE_FDB_HASH_SIZE];
+	struct eth_bridge_stats stats;
+#endif
 	bool initialized;
 };
 
@@ -160,6 +202,54 @@ int eth_bridge_get_index(struct eth_bridge *br);
  */
 struct eth_bridge *eth_bridge_get_by_index(int index);
 
+/**
+ * @typedef eth_bridge_fdb_cb_t
+ * @brief Callback used while iterating over forwarding database entries
+ *
+ * @param entry Pointer to forwarding database entry
+ * @param user_data User supplied data
+ */
+typedef void (*eth_bridge_fdb_cb_t)(struct eth_bridge_fdb_entry *entry,
+				    void *user_data);
+
+/**
+ * @brief Go through all the learned addresses of a bridge.
+ *
+ * Expired entries are skipped. The bridge is locked while the callback
+ * is called so the callback must not call other bridge functions.
+ *
+ * @param br Pointer to bridge instance
+ * @param cb Callback to call for each forwarding database entry
+ * @param user_data User supplied data
+ *
+ * @return Number of entries found, or negative error code if the
+ *         forwarding database is not enabled.
+ */
+int eth_bridge_fdb_foreach(struct eth_bridge *br, eth_bridge_fdb_cb_t cb,
+			   void *user_data);
+
+/**
+ * @brief Remove learned addresses from the bridge.
+ *
+ * @param br Pointer to bridge instance
+ * @param iface Remove only the addresses learned on this interface,
+ *        or all addresses if NULL.
+ *
+ * @return 0 if OK, negative error code otherwise.
+ */
+int eth_bridge_fdb_flush(struct eth_bridge *br, struct net_if *iface);
+
+/**
+ * @brief Get the forwarding statistics of a bridge.
+ *
+ * @param br Pointer to bridge instance
+ * @param stats Statistics are copied here
+ *
+ * @return 0 if OK, negative error code if the forwarding database is
+ *         not enabled.
+ */
+int eth_bridge_get_stats(struct eth_bridge *br, struct eth_bridge_stats *stats);
+
 /**
  * @typedef eth_bridge_cb_t
  * @brief Callback used while iterating over bridge instances
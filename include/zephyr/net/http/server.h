@@ -0,0 +1,268 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ * @brief HTTP server API
+ *
+ * An event driven HTTP/1.1 server serving the services and resources
+ * defined with the macros in @ref zephyr/net/http/service.h.
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_HTTP_SERVER_H_
+#define ZEPHYR_INCLUDE_NET_HTTP_SERVER_H_
+
+/**
+ * @brief HTTP server API
+ * @defgroup http_server HTTP server API
+ * @ingroup networking
+ * @{
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/http/method.h>
+#include <zephyr/net/http/parser.h>
+#include <zephyr/net/http/service.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @cond INTERNAL_HIDDEN */
+
+#if defined(CONFIG_HTTP_SERVER)
+#define HTTP_SERVER_CLIENT_BUFFER_SIZE CONFIG_HTTP_SERVER_CLIENT_BUFFER_SIZE
+#define HTTP_SERVER_TX_BUFFER_SIZE CONFIG_HTTP_SERVER_TX_BUFFER_SIZE
+#define HTTP_SERVER_MAX_URL_LENGTH CONFIG_HTTP_SERVER_MAX_URL_LENGTH
+#else
+#define HTTP_SERVER_CLIENT_BUFFER_SIZE 0
+#define HTTP_SERVER_TX_BUFFER_SIZE 0
+#define HTTP_SERVER_MAX_URL_LENGTH 0
+#endif
+
+/** @endcond */
+
+/** Bit of an HTTP method in the supported method mask of a resource. */
+#define HTTP_METHOD_BIT(method) BIT(method)
+
+/** HTTP resource types. */
+enum http_resource_type {
+	/** Resource content is a constant buffer, for example in flash. */
+	HTTP_RESOURCE_TYPE_STATIC,
+
+	/** Resource content is generated by a callback. */
+	HTTP_RESOURCE_TYPE_DYNAMIC,
+};
+
+/**
+ * @brief Common part of the resource details.
+ *
+ * The @a detail pointer given to @ref HTTP_RESOURCE_DEFINE points to one of
+ * the resource specific detail structures, which all start with this one.
+ */
+struct http_resource_detail {
+	/** Mask of the supported methods, see @ref HTTP_METHOD_BIT. */
+	uint32_t bitmask_of_supported_http_methods;
+
+	/** Resource type. */
+	enum http_resource_type type;
+
+	/** Value of the Content-Encoding header, NULL if none. */
+	const char *content_encoding;
+
+	/** Value of the Content-Type header, NULL if none. */
+	const char *content_type;
+};
+
+/**
+ * @brief Details of a static resource.
+ *
+ * The content is sent directly from @a static_data, it is never copied to
+ * a RAM buffer. Typically it is a compressed web page placed in flash at
+ * build time.
+ */
+struct http_resource_detail_static {
+	/** Common resource details. */
+	struct http_resource_detail common;
+
+	/** Resource content. */
+	const void *static_data;
+
+	/** Length of the resource content. */
+	size_t static_data_len;
+};
+
+/** Status of the data passed to a dynamic resource callback. */
+enum http_data_status {
+	/** The request was aborted, the connection is closed. */
+	HTTP_SERVER_DATA_ABORTED = -1,
+
+	/** Part of the request body, more is to come. */
+	HTTP_SERVER_DATA_MORE = 0,
+
+	/** Last part of the request body, may be empty. */
+	HTTP_SERVER_DATA_FINAL = 1,
+
+	/** The buffer is to be filled with response data. */
+	HTTP_SERVER_DATA_RESPONSE = 2,
+};
+
+struct http_client_ctx;
+
+/**
+ * @brief Callback of a dynamic resource.
+ *
+ * The callback is first called with the request body, in one or more parts,
+ * the last one having the @ref HTTP_SERVER_DATA_FINAL status. A negative
+ * return value makes the server answer with 500 Internal Server Error.
+ *
+ * After that, the callback is called with @ref HTTP_SERVER_DATA_RESPONSE
+ * to generate the response: it writes at most @p data_len bytes to
+ * @p data_buffer and returns the number of bytes written. Each call results
+ * in one chunk of a chunked response, returning 0 ends the response.
+ *
+ * If the connection is closed before the response is complete, the callback
+ * is called with @ref HTTP_SERVER_DATA_ABORTED so that the resource can
+ * release any state it keeps for the client.
+ *
+ * @param client Client connection.
+ * @param status Status of the data.
+ * @param data_buffer Request data, or buffer for the response data.
+ * @param data_len Length of the request data, or size of the buffer.
+ * @param user_data User data given in the resource details.
+ *
+ * @return Number of response bytes written, or a negative error code.
+ */
+typedef int (*http_resource_dynamic_cb_t)(struct http_client_ctx *client,
+					  enum http_data_status status,
+					  uint8_t *data_buffer, size_t data_len,
+					  void *user_data);
+
+/** Details of a dynamic resource. */
+struct http_resource_detail_dynamic {
+	/** Common resource details. */
+	struct http_resource_detail common;
+
+	/** Callback generating the resource content. */
+	http_resource_dynamic_cb_t cb;
+
+	/** User data passed to the callback. */
+	void *user_data;
+};
+
+/** @cond INTERNAL_HIDDEN */
+
+enum http_client_state {
+	HTTP_CLIENT_FREE,
+	HTTP_CLIENT_RECV,
+	HTTP_CLIENT_SEND,
+};
+
+enum http_response_state {
+	HTTP_RESPONSE_HEADERS,
+	HTTP_RESPONSE_BODY,
+	HTTP_RESPONSE_LAST_CHUNK,
+	HTTP_RESPONSE_DONE,
+};
+
+/** @endcond */
+
+/**
+ * @brief HTTP client connection.
+ *
+ * All the state of a connection, its size is the RAM needed per
+ * concurrent client.
+ */
+struct http_client_ctx {
+	/** @cond INTERNAL_HIDDEN */
+	int fd;
+	const struct http_service_desc *service;
+	const struct http_resource_detail *resource;
+
+	struct http_parser parser;
+
+	/* Uptime after which an idle connection is closed */
+	int64_t timeout;
+
+	/* Data being sent: first the tx buffer, then the zero copy data */
+	const uint8_t *tx_buf_data;
+	size_t tx_buf_len;
+	const uint8_t *tx_data;
+	size_t tx_len;
+
+	/* Received data not handled by the parser yet */
+	size_t data_len;
+
+	uint16_t url_len;
+	uint16_t status;
+
+	enum http_client_state state;
+	enum http_response_state response;
+
+	bool keep_alive : 1;
+	bool chunked : 1;
+	bool head : 1;
+
+	uint8_t buffer[HTTP_SERVER_CLIENT_BUFFER_SIZE];
+	uint8_t tx_buf[HTTP_SERVER_TX_BUFFER_SIZE];
+	char url[HTTP_SERVER_MAX_URL_LENGTH];
+	/** @endcond */
+};
+
+/**
+ * @brief Get the URL of the request being served.
+ *
+ * @param client Client connection.
+ *
+ * @return Request URL, including any query string.
+ */
+static inline const char *http_client_get_url(const struct http_client_ctx *client)
+{
+	return client->url;
+}
+
+/**
+ * @brief Get the method of the request being served.
+ *
+ * @param client Client connection.
+ *
+ * @return Request method.
+ */
+static inline enum http_method http_client_get_method(const struct http_client_ctx *client)
+{
+	return (enum http_method)client->parser.method;
+}
+
+/**
+ * @brief Start the HTTP server.
+ *
+ * Opens a listening socket for every service defined with
+ * @ref HTTP_SERVICE_DEFINE or @ref HTTP_SERVICE_DEFINE_EMPTY and starts
+ * serving them from a single thread.
+ *
+ * @return 0 if ok, <0 if error.
+ */
+int http_server_start(void);
+
+/**
+ * @brief Stop the HTTP server.
+ *
+ * Closes all the client connections and the listening sockets.
+ *
+ * @return 0 if ok, <0 if error.
+ */
+int http_server_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* ZEPHYR_INCLUDE_NET_HTTP_SERVER_H_ */
@@ -444,6 +444,23 @@ struct mqtt_transport {
 #endif
 };
 
+/**
+ * @brief Outgoing QoS 1 or QoS 2 publish message awaiting acknowledgment.
+ */
+struct mqtt_outgoing {
+	/** Internal. Message to retransmit, topic and payload are not copied.
+	 */
+	struct mqtt_publish_param param;
+
+	/** Internal. Wall clock value (in milliseconds) of the last
+	 *  transmission.
+	 */
+	uint32_t timestamp;
+
+	/** Internal. Acknowledgment awaited, free entry if zero. */
+	uint8_t state;
+};
+
 /** @brief MQTT internal state. */
 struct mqtt_internal {
 	/** Internal. Mutex to protect access to the client instance. */
@@ -462,6 +479,11 @@ struct mqtt_internal {
 
 	/** Internal. Remaining payload length to read. */
 	uint32_t remaining_payload;
+
+#if defined(CONFIG_MQTT_PUBLISH_WINDOW) && (CONFIG_MQTT_PUBLISH_WINDOW > 0)
+	/** Internal. QoS 1 and QoS 2 publishes awaiting acknowledgment. */
+	struct mqtt_outgoing outgoing[CONFIG_MQTT_PUBLISH_WINDOW];
+#endif
 };
 
 /**
@@ -596,11 +618,40 @@ int mqtt_connect(struct mqtt_client *client);
  * @param[in] param Parameters to be used for the publish message.
  *                  Shall not be NULL.
  *
+ * @note The payload is sent from the application buffer, it is not copied
+ *       in the TX buffer. With @kconfig{CONFIG_MQTT_PUBLISH_WINDOW}, a QoS 1
+ *       or QoS 2 message is tracked until it is acknowledged, and its topic
+ *       and payload must stay valid until then.
+ *
  * @return 0 or a negative error code (errno.h) indicating reason of failure.
+ *         -ENOBUFS if the window of unacknowledged messages is full.
  */
 int mqtt_publish(struct mqtt_client *client,
 		 const struct mqtt_publish_param *param);
 
+/**
+ * @brief API to publish several messages with as few transport writes as
+ *        possible.
+ *
+ * Up to @kconfig{CONFIG_MQTT_PUBLISH_BATCH_SIZE} messages, whose headers fit
+ * in the TX buffer together, are sent in a single transport write. This
+ * saves a TCP segment per message for small telemetry messages.
+ *
+ * @param[in] client Client instance for which the procedure is requested.
+ *                   Shall not be NULL.
+ * @param[in] params Parameters of the publish messages, sent in order.
+ *                   Shall not be NULL.
+ * @param[in] count Number of messages in @p params.
+ *
+ * @note Same as @ref mqtt_publish for each message. If the window of
+ *       unacknowledged messages has no room for all of them, none is sent.
+ *
+ * @return 0 or a negative error code (errno.h) indicating reason of failure.
+ *         -ENOBUFS if the window of unacknowledged messages is full.
+ */
+int mqtt_publish_batch(struct mqtt_client *client,
+		       const struct mqtt_publish_param *params, size_t count);
+
 /**
  * @brief API used by client to send acknowledgment on receiving QoS1 publish
  *        message. Should be called on reception of @ref MQTT_EVT_PUBLISH with
@@ -727,6 +778,9 @@ int mqtt_abort(struct mqtt_client *client);
  *        makes it possible to respect the Keep Alive time agreed with the
  *        broker on connection. @ref mqtt_connect for details on Keep Alive
  *        time.
+ * @note  With @kconfig{CONFIG_MQTT_PUBLISH_WINDOW}, the publish messages not
+ *        acknowledged within @kconfig{CONFIG_MQTT_PUBLISH_RETRANSMIT_TIMEOUT}
+ *        are retransmitted from this function too.
  *
  * @return 0 or a negative error code (errno.h) indicating reason of failure.
  */
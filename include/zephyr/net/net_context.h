@@ -975,6 +975,36 @@ int net_context_sendto(struct net_context *context,
 		       k_timeout_t timeout,
 		       void *user_data);
 
+/**
+ * @brief Send a network buffer chain without copying it.
+ *
+ * @details This function works like net_context_sendto() but instead of
+ * copying the payload into the packet, the @a frags buffer chain is linked
+ * after the protocol headers. The packet takes its own reference to
+ * @a frags, so the caller must still release its reference. The data in
+ * @a frags must not be modified until the last reference is released,
+ * which can happen after this function has returned. This variant can
+ * only be used for UDP connections.
+ *
+ * @param context The network context to use.
+ * @param frags The network buffer chain holding the payload.
+ * @param dst_addr Destination address. If NULL, the address set by
+ *        net_context_connect() is used.
+ * @param addrlen Length of the address.
+ * @param cb Caller-supplied callback function.
+ * @param timeout Currently this value is not used.
+ * @param user_data Caller-supplied user data.
+ *
+ * @return numbers of bytes sent on success, a negative errno otherwise
+ */
+int net_context_sendto_buf(struct net_context *context,
+			   struct net_buf *frags,
+			   const struct sockaddr *dst_addr,
+			   socklen_t addrlen,
+			   net_context_send_cb_t cb,
+			   k_timeout_t timeout,
+			   void *user_data);
+
 /**
  * @brief Send data in iovec to a peer specified in msghdr struct.
  *
@@ -149,8 +149,99 @@ int net_send_data(struct net_pkt *pkt);
 #define NET_TC_COUNT 0
 #endif /* CONFIG_NET_TC_TX_COUNT && CONFIG_NET_TC_RX_COUNT */
 
+#if defined(CONFIG_NET_TC_TX_QUEUE_COUNT)
+#define NET_TC_TX_QUEUE_COUNT CONFIG_NET_TC_TX_QUEUE_COUNT
+#else
+#define NET_TC_TX_QUEUE_COUNT 1
+#endif
+
+#if defined(CONFIG_NET_TC_RX_QUEUE_COUNT)
+#define NET_TC_RX_QUEUE_COUNT CONFIG_NET_TC_RX_QUEUE_COUNT
+#else
+#define NET_TC_RX_QUEUE_COUNT 1
+#endif
+
 /* @endcond */
 
+#if defined(CONFIG_NET_NAPI) || defined(__DOXYGEN__)
+struct net_napi;
+
+/**
+ * @brief Driver callback that polls the device for received packets.
+ *
+ * @details The callback is run from the network polling thread after the
+ * driver has called net_napi_schedule(). It should pass at most @a budget
+ * received packets to net_napi_recv(). If fewer than @a budget packets were
+ * available, the driver must re-enable its RX interrupt before returning.
+ * If the whole budget was used, the RX interrupt is kept disabled and the
+ * callback is called again after other pending polling work has been done.
+ *
+ * @param napi Polling context of the device.
+ * @param budget Max number of packets to pass up in this call.
+ *
+ * @return Number of packets passed to net_napi_recv().
+ */
+typedef int (*net_napi_poll_cb_t)(struct net_napi *napi, int budget);
+
+/**
+ * @brief Polled RX context of a network device.
+ *
+ * @details Packets received within one poll call are queued to the RX
+ * traffic class threads as one batch, which takes the queue lock and wakes
+ * the RX thread once per batch instead of once per packet.
+ */
+struct net_napi {
+	/** @cond INTERNAL_HIDDEN */
+	struct k_work work;
+	sys_slist_t batch[NET_TC_RX_COUNT > 0 ? NET_TC_RX_COUNT : 1];
+	sys_snode_t node;
+	bool deferred;
+	/** @endcond */
+
+	/** Driver poll callback */
+	net_napi_poll_cb_t poll;
+
+	/** Max number of packets to process in one poll call */
+	int budget;
+};
+
+/**
+ * @brief Initialize the polled RX context of a network device.
+ *
+ * @param napi Polling context to initialize.
+ * @param poll Driver poll callback.
+ * @param budget Max number of packets to process in one poll call. If 0,
+ *        then CONFIG_NET_NAPI_BUDGET is used.
+ */
+void net_napi_init(struct net_napi *napi, net_napi_poll_cb_t poll, int budget);
+
+/**
+ * @brief Schedule polling of a network device.
+ *
+ * @details Typically called from the RX interrupt handler after the driver
+ * has disabled the RX interrupt. Can be called from ISR context. If the
+ * network stack is not ready to receive yet, the poll is run once it is.
+ *
+ * @param napi Polling context of the device.
+ */
+void net_napi_schedule(struct net_napi *napi);
+
+/**
+ * @brief Pass a received packet up from the driver poll callback.
+ *
+ * @details This is the polled counterpart of net_recv_data(). The packet is
+ * queued to the RX traffic class threads when the poll callback returns.
+ *
+ * @param napi Polling context of the device.
+ * @param iface Network interface where the packet was received.
+ * @param pkt Network packet data.
+ *
+ * @return 0 if ok, <0 if error. On error the caller needs to unref the pkt.
+ */
+int net_napi_recv(struct net_napi *napi, struct net_if *iface,
+		  struct net_pkt *pkt);
+#endif /* CONFIG_NET_NAPI */
+
 /**
  * @}
  */
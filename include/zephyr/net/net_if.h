@@ -500,6 +500,15 @@ struct net_if_dev {
 	enum net_if_oper_state oper_state;
 };
 
+#if defined(CONFIG_NET_PKT_POOL_BINDING)
+/** @cond INTERNAL_HIDDEN */
+struct net_pkt_pool;
+
+#define NET_IF_PKT_POOL_RX_TC_COUNT MAX(NET_TC_RX_COUNT, 1)
+#define NET_IF_PKT_POOL_TX_TC_COUNT MAX(NET_TC_TX_COUNT, 1)
+/** @endcond */
+#endif /* CONFIG_NET_PKT_POOL_BINDING */
+
 /**
  * @brief Network Interface structure
  *
@@ -511,6 +520,14 @@ struct net_if {
 	/** The net_if_dev instance the net_if is related to */
 	struct net_if_dev *if_dev;
 
+#if defined(CONFIG_NET_PKT_POOL_BINDING)
+	/** Dedicated RX packet pools, one per traffic class */
+	struct net_pkt_pool *rx_pools[NET_IF_PKT_POOL_RX_TC_COUNT];
+
+	/** Dedicated TX packet pools, one per traffic class */
+	struct net_pkt_pool *tx_pools[NET_IF_PKT_POOL_TX_TC_COUNT];
+#endif /* CONFIG_NET_PKT_POOL_BINDING */
+
 #if defined(CONFIG_NET_STATISTICS_PER_INTERFACE)
 	/** Network statistics related to this network interface */
 	struct net_stats stats;
@@ -2416,6 +2433,50 @@ int net_if_resume(struct net_if *iface);
 bool net_if_is_suspended(struct net_if *iface);
 #endif /* CONFIG_NET_POWER_MANAGEMENT */
 
+#if defined(CONFIG_NET_PKT_POOL_BINDING) || defined(__DOXYGEN__)
+/** Direction of the traffic that uses a dedicated packet pool */
+enum net_if_pkt_pool_dir {
+	/** Received packets */
+	NET_IF_PKT_POOL_RX,
+	/** Packets to send */
+	NET_IF_PKT_POOL_TX,
+};
+
+/** Bind a packet pool to all traffic classes, see net_if_pkt_pool_bind() */
+#define NET_IF_PKT_POOL_ALL_TC -1
+
+/**
+ * @brief Bind a dedicated packet pool to a network interface
+ *
+ * @details Packets allocated for the interface and traffic class are taken
+ *          from the pool instead of the shared packet pools. The same pool
+ *          can be bound to several interfaces or traffic classes. Binding
+ *          NULL restores the use of the shared pools.
+ *
+ * @param iface Pointer to network interface
+ * @param dir Whether the pool is used for received or sent packets
+ * @param tc Traffic class, or NET_IF_PKT_POOL_ALL_TC for all of them
+ * @param pool Packet pool, see NET_PKT_POOL_DEFINE()
+ *
+ * @return 0 on success, -EINVAL if the traffic class is invalid.
+ */
+int net_if_pkt_pool_bind(struct net_if *iface, enum net_if_pkt_pool_dir dir,
+			 int tc, struct net_pkt_pool *pool);
+
+/**
+ * @brief Get the packet pool used for a given packet priority
+ *
+ * @param iface Pointer to network interface
+ * @param dir Whether the pool is used for received or sent packets
+ * @param priority Packet priority, mapped to a traffic class
+ *
+ * @return Dedicated packet pool, or NULL if the shared pools are used.
+ */
+struct net_pkt_pool *net_if_pkt_pool_get(struct net_if *iface,
+					 enum net_if_pkt_pool_dir dir,
+					 uint8_t priority);
+#endif /* CONFIG_NET_PKT_POOL_BINDING */
+
 /** @cond INTERNAL_HIDDEN */
 struct net_if_api {
 	void (*init)(struct net_if *iface);
@@ -69,6 +69,11 @@ struct net_pkt {
 	/** Slab pointer from where it belongs to */
 	struct k_mem_slab *slab;
 
+#if defined(CONFIG_NET_PKT_POOL_BINDING)
+	/** Dedicated pool the packet was allocated from, if any */
+	struct net_pkt_pool *pool;
+#endif
+
 	/** buffer holding the packet */
 	union {
 		struct net_buf *frags;
@@ -125,6 +130,11 @@ struct net_pkt {
 	uint64_t txtime;
 #endif /* CONFIG_NET_PKT_TXTIME */
 
+#if defined(CONFIG_NET_PKT_FLOW_HASH)
+	/** Hash of the flow the packet belongs to, 0 if not known */
+	uint32_t flow_hash;
+#endif /* CONFIG_NET_PKT_FLOW_HASH */
+
 	/** Reference counter */
 	atomic_t atomic_ref;
 
@@ -190,6 +200,11 @@ struct net_pkt {
 	uint8_t l2_processed : 1; /* Set to 1 if this packet has already been
 				   * processed by the L2
 				   */
+	uint8_t chksum_partial : 1; /* Set to 1 if the payload checksum was
+				     * calculated when the payload was
+				     * written, and stored in the transport
+				     * header checksum field.
+				     */
 
 	/* bitfield byte alignment boundary */
 
@@ -392,6 +407,17 @@ static inline void net_pkt_set_l2_processed(struct net_pkt *pkt,
 	pkt->l2_processed = is_l2_processed;
 }
 
+static inline bool net_pkt_is_chksum_partial(struct net_pkt *pkt)
+{
+	return !!(pkt->chksum_partial);
+}
+
+static inline void net_pkt_set_chksum_partial(struct net_pkt *pkt,
+					      bool is_chksum_partial)
+{
+	pkt->chksum_partial = is_chksum_partial;
+}
+
 static inline uint8_t net_pkt_ip_hdr_len(struct net_pkt *pkt)
 {
 #if defined(CONFIG_NET_IP)
@@ -1018,6 +1044,51 @@ static inline void net_pkt_set_txtime(struct net_pkt *pkt, uint64_t txtime)
 }
 #endif /* CONFIG_NET_PKT_TXTIME */
 
+#if defined(CONFIG_NET_PKT_FLOW_HASH)
+/**
+ * @brief Get the flow hash of the packet.
+ *
+ * Packets with the same hash are processed by the same Rx or Tx queue.
+ * A driver with several hardware Tx queues can select one with it.
+ *
+ * @param pkt Network packet
+ *
+ * @return Flow hash, or 0 if it has not been computed yet.
+ */
+static inline uint32_t net_pkt_flow_hash(struct net_pkt *pkt)
+{
+	return pkt->flow_hash;
+}
+
+/**
+ * @brief Set the flow hash of the packet.
+ *
+ * A driver whose hardware computes a receive side scaling hash should
+ * store it here before passing the packet to net_recv_data(), so that the
+ * stack does not need to compute it in software.
+ *
+ * @param pkt Network packet
+ * @param hash Flow hash, 0 lets the stack compute it
+ */
+static inline void net_pkt_set_flow_hash(struct net_pkt *pkt, uint32_t hash)
+{
+	pkt->flow_hash = hash;
+}
+#else
+static inline uint32_t net_pkt_flow_hash(struct net_pkt *pkt)
+{
+	ARG_UNUSED(pkt);
+
+	return 0U;
+}
+
+static inline void net_pkt_set_flow_hash(struct net_pkt *pkt, uint32_t hash)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(hash);
+}
+#endif /* CONFIG_NET_PKT_FLOW_HASH */
+
 #if defined(CONFIG_NET_PKT_TXTIME_STATS_DETAIL) || \
 	defined(CONFIG_NET_PKT_RXTIME_STATS_DETAIL)
 static inline uint32_t *net_pkt_stats_tick(struct net_pkt *pkt)
@@ -1270,6 +1341,21 @@ static inline bool net_pkt_filter_recv_ok(struct net_pkt *pkt)
 
 #endif /* CONFIG_NET_PKT_FILTER */
 
+#if defined(CONFIG_NET_PKT_FILTER) && defined(CONFIG_NET_CAPTURE_LOCAL)
+
+bool net_pkt_filter_capture_ok(struct net_pkt *pkt);
+
+#else
+
+static inline bool net_pkt_filter_capture_ok(struct net_pkt *pkt)
+{
+	ARG_UNUSED(pkt);
+
+	return true;
+}
+
+#endif /* CONFIG_NET_PKT_FILTER && CONFIG_NET_CAPTURE_LOCAL */
+
 /* @endcond */
 
 /**
@@ -1308,6 +1394,96 @@ static inline bool net_pkt_filter_recv_ok(struct net_pkt *pkt)
 	NET_BUF_POOL_DEFINE(name, count, CONFIG_NET_BUF_DATA_SIZE,	\
 			    0, NULL)
 
+#if defined(CONFIG_NET_PKT_POOL_BINDING) || defined(__DOXYGEN__)
+struct net_pkt_pool;
+
+/**
+ * @typedef net_pkt_pool_cb_t
+ * @brief Called when a dedicated packet pool becomes congested, or when
+ *        the congestion is over.
+ *
+ * @details The callback is called from the context that allocates or
+ *          frees the packet, which can be an interrupt handler.
+ *
+ * @param pool Packet pool.
+ * @param congested True if the pool became congested, false otherwise.
+ */
+typedef void (*net_pkt_pool_cb_t)(struct net_pkt_pool *pool, bool congested);
+
+/**
+ * @brief Dedicated network packet pool
+ *
+ * Couples a net_pkt slab with a data buffer pool. The pool can be bound to
+ * a network interface and traffic class (see :c:func:`net_if_pkt_pool_bind`)
+ * so that the traffic of that interface does not use the shared packet
+ * pools.
+ *
+ * The pool is congested when the number of free packets falls to the low
+ * watermark, and stays congested until the number of free packets rises
+ * back to the high watermark. Non-blocking sends from a congested pool
+ * fail so that the remaining packets are left for the network stack.
+ */
+struct net_pkt_pool {
+	/** Slab for the net_pkt structures */
+	struct k_mem_slab *slab;
+
+	/** Pool for the packet data */
+	struct net_buf_pool *data_pool;
+
+	/** Optional congestion callback */
+	net_pkt_pool_cb_t cb;
+
+	/** Number of free packets at which the pool becomes congested */
+	uint16_t low_watermark;
+
+	/** Number of free packets at which the congestion is over */
+	uint16_t high_watermark;
+
+	/** Borrow packets from the shared pool when this pool is empty */
+	bool fallback;
+
+	/** @cond INTERNAL_HIDDEN */
+	atomic_t congested;
+	/** @endcond */
+};
+
+/**
+ * @brief Define a dedicated network packet pool
+ *
+ * Defines the net_pkt slab, the data buffer pool and the
+ * :c:struct:`net_pkt_pool` that ties them together. Borrowing from the
+ * shared pool is enabled by default.
+ *
+ * @param _name Name of the pool.
+ * @param _pkt_count Number of net_pkt in the pool.
+ * @param _buf_count Number of data buffers in the pool.
+ * @param _low Low watermark, see :c:struct:`net_pkt_pool`.
+ * @param _high High watermark, see :c:struct:`net_pkt_pool`.
+ */
+#define NET_PKT_POOL_DEFINE(_name, _pkt_count, _buf_count, _low, _high)	\
+	NET_PKT_SLAB_DEFINE(_name##_slab, _pkt_count);			\
+	NET_PKT_DATA_POOL_DEFINE(_name##_data, _buf_count);		\
+	struct net_pkt_pool _name = {					\
+		.slab = &_name##_slab,					\
+		.data_pool = &_name##_data,				\
+		.low_watermark = _low,					\
+		.high_watermark = _high,				\
+		.fallback = true,					\
+	}
+
+/**
+ * @brief Check if a dedicated packet pool is congested
+ *
+ * @param pool Packet pool.
+ *
+ * @return True if the pool is congested, false otherwise.
+ */
+static inline bool net_pkt_pool_is_congested(struct net_pkt_pool *pool)
+{
+	return atomic_get(&pool->congested) != 0;
+}
+#endif /* CONFIG_NET_PKT_POOL_BINDING */
+
 /** @cond INTERNAL_HIDDEN */
 
 #if defined(CONFIG_NET_DEBUG_NET_PKT_ALLOC) || \
@@ -1545,6 +1721,66 @@ void net_pkt_frag_insert(struct net_pkt *pkt, struct net_buf *frag);
  */
 void net_pkt_compact(struct net_pkt *pkt);
 
+/**
+ * @brief Data segment of a network packet, as seen by a DMA engine.
+ */
+struct net_pkt_dma_seg {
+	/** Physical address of the segment data */
+	uintptr_t addr;
+
+	/** Length of the segment in bytes */
+	size_t len;
+
+	/** Fragment holding the segment data */
+	struct net_buf *frag;
+};
+
+/**
+ * @brief Prepare a buffer for device DMA.
+ *
+ * @details The data cache is flushed for the buffer, so that the device
+ * reads what the CPU wrote. Drivers use it for their own buffers, such as
+ * a bounce buffer, so that they are translated like packet fragments.
+ *
+ * @param data Buffer start.
+ * @param len Buffer length in bytes.
+ *
+ * @return Physical address of the buffer.
+ */
+uintptr_t net_pkt_dma_map_data(void *data, size_t len);
+
+/**
+ * @brief Prepare a fragment of a network packet for device DMA.
+ *
+ * @details The data cache is flushed for the fragment data, so that the
+ * device reads what the CPU wrote. The fragment must stay referenced
+ * until the device is done with it.
+ *
+ * @param frag Fragment of a network packet.
+ *
+ * @return Physical address of the fragment data.
+ */
+uintptr_t net_pkt_frag_dma_map(struct net_buf *frag);
+
+/**
+ * @brief Prepare the data of a network packet for scatter-gather DMA.
+ *
+ * @details Each non-empty fragment of the packet is prepared with
+ * net_pkt_frag_dma_map() and described by one segment, so that a driver
+ * can fill one transmit descriptor per segment instead of copying the
+ * packet into a bounce buffer. The packet must stay referenced until the
+ * device is done with it.
+ *
+ * @param pkt Network packet.
+ * @param segs Array of segments to fill.
+ * @param max_segs Number of segments in the array.
+ *
+ * @return Number of segments filled, -E2BIG if the packet has more than
+ * max_segs non-empty fragments, or -ENODATA if it has no data.
+ */
+int net_pkt_dma_map(struct net_pkt *pkt, struct net_pkt_dma_seg *segs,
+		    size_t max_segs);
+
 /**
  * @brief Get information about predefined RX, TX and DATA pools.
  *
@@ -1600,6 +1836,16 @@ struct net_pkt *net_pkt_alloc_from_slab_debug(struct k_mem_slab *slab,
 #define net_pkt_alloc_from_slab(_slab, _timeout)			\
 	net_pkt_alloc_from_slab_debug(_slab, _timeout, __func__, __LINE__)
 
+#if defined(CONFIG_NET_PKT_POOL_BINDING)
+struct net_pkt *net_pkt_alloc_from_pool_debug(struct net_pkt_pool *pool,
+					      struct net_if *iface,
+					      k_timeout_t timeout,
+					      const char *caller, int line);
+#define net_pkt_alloc_from_pool(_pool, _iface, _timeout)		\
+	net_pkt_alloc_from_pool_debug(_pool, _iface, _timeout,		\
+				      __func__, __LINE__)
+#endif
+
 struct net_pkt *net_pkt_rx_alloc_debug(k_timeout_t timeout,
 				       const char *caller, int line);
 #define net_pkt_rx_alloc(_timeout)				\
@@ -1690,6 +1936,27 @@ struct net_pkt *net_pkt_alloc_from_slab(struct k_mem_slab *slab,
 					k_timeout_t timeout);
 #endif
 
+/**
+ * @brief Allocate an initialized TX net_pkt from a dedicated pool
+ *
+ * @details The packet is taken from the pool, or from the shared TX pool
+ *          if the pool is empty and allowed to borrow. Buffers allocated
+ *          for the packet come from the same pool. Basically, only
+ *          net_context should be using this, in order to allocate from the
+ *          pool bound to its traffic class.
+ *
+ * @param pool    The dedicated pool to allocate from
+ * @param iface   Network interface the packet is allocated for
+ * @param timeout Maximum time to wait for an allocation.
+ *
+ * @return a pointer to a newly allocated net_pkt on success, NULL otherwise.
+ */
+#if defined(CONFIG_NET_PKT_POOL_BINDING) && !defined(NET_PKT_DEBUG_ENABLED)
+struct net_pkt *net_pkt_alloc_from_pool(struct net_pkt_pool *pool,
+					struct net_if *iface,
+					k_timeout_t timeout);
+#endif
+
 /**
  * @brief Allocate an initialized net_pkt for RX
  *
@@ -2046,6 +2313,24 @@ int net_pkt_read_be32(struct net_pkt *pkt, uint32_t *data);
  */
 int net_pkt_write(struct net_pkt *pkt, const void *data, size_t length);
 
+/**
+ * @brief Write data into a net_pkt and calculate its checksum
+ *
+ * @details Works like net_pkt_write() but also adds the data to the
+ *          Internet checksum @p sum while it is being copied, so that
+ *          the data does not need to be read again later. The data is
+ *          assumed to start at an even offset of the checksummed area.
+ *
+ * @param pkt    The network packet where to write
+ * @param data   Data to be written
+ * @param length Length of the data to be written
+ * @param sum    Running 16-bit one's complement sum, updated on return
+ *
+ * @return 0 on success, negative errno code otherwise.
+ */
+int net_pkt_write_chksum(struct net_pkt *pkt, const void *data, size_t length,
+			 uint16_t *sum);
+
 /* Write uint8_t data into a net_pkt. */
 static inline int net_pkt_write_u8(struct net_pkt *pkt, uint8_t data)
 {
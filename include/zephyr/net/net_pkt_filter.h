@@ -17,6 +17,7 @@
 #include <limits.h>
 #include <stdbool.h>
 #include <zephyr/sys/slist.h>
+#include <zephyr/sys/atomic.h>
 #include <zephyr/net/net_core.h>
 #include <zephyr/net/ethernet.h>
 
@@ -57,16 +58,30 @@ extern struct npf_rule npf_default_ok;
 /** @brief Default rule list termination for rejecting a packet */
 extern struct npf_rule npf_default_drop;
 
+/** @cond INTERNAL_HIDDEN */
+struct npf_prog;
+/** @endcond */
+
 /** @brief rule set for a given test location */
 struct npf_rule_list {
 	sys_slist_t rule_head;
 	struct k_spinlock lock;
+#if defined(CONFIG_NET_PKT_FILTER_COMPILED)
+	/** @cond INTERNAL_HIDDEN */
+	atomic_ptr_t prog;		/* active compiled rule list or NULL */
+	struct npf_prog *progs;		/* two program buffers, swapped */
+	/** @endcond */
+#endif
 };
 
 /** @brief  rule list applied to outgoing packets */
 extern struct npf_rule_list npf_send_rules;
 /** @brief rule list applied to incoming packets */
 extern struct npf_rule_list npf_recv_rules;
+#if defined(CONFIG_NET_CAPTURE_LOCAL) || defined(__DOXYGEN__)
+/** @brief rule list selecting the packets stored by the local capture */
+extern struct npf_rule_list npf_capture_rules;
+#endif
 
 /**
  * @brief Insert a rule at the front of given rule list
@@ -87,6 +102,11 @@ void npf_append_rule(struct npf_rule_list *rules, struct npf_rule *rule);
 /**
  * @brief Remove a rule from the given rule list
  *
+ * The rule can be freed once this returns. With
+ * @kconfig{CONFIG_NET_PKT_FILTER_COMPILED}, this waits until no packet is
+ * being filtered with a program that still uses the rule, so it must be
+ * called from a thread, and not with a spinlock held.
+ *
  * @param rules the affected rule list
  * @param rule the rule to be removed
  * @retval true if given rule was found in the rule list and removed
@@ -96,6 +116,8 @@ bool npf_remove_rule(struct npf_rule_list *rules, struct npf_rule *rule);
 /**
  * @brief Remove all rules from the given rule list
  *
+ * Same context restrictions as npf_remove_rule().
+ *
  * @param rules the affected rule list
  * @retval true if at least one rule was removed from the rule list
  */
@@ -110,6 +132,10 @@ bool npf_remove_all_rules(struct npf_rule_list *rules);
 #define npf_remove_recv_rule(rule) npf_remove_rule(&npf_recv_rules, rule)
 #define npf_remove_all_send_rules() npf_remove_all_rules(&npf_send_rules)
 #define npf_remove_all_recv_rules() npf_remove_all_rules(&npf_recv_rules)
+#define npf_insert_capture_rule(rule) npf_insert_rule(&npf_capture_rules, rule)
+#define npf_append_capture_rule(rule) npf_append_rule(&npf_capture_rules, rule)
+#define npf_remove_capture_rule(rule) npf_remove_rule(&npf_capture_rules, rule)
+#define npf_remove_all_capture_rules() npf_remove_all_rules(&npf_capture_rules)
 
 /**
  * @brief Statically define one packet filter rule
@@ -318,6 +344,8 @@ extern npf_test_fn_t npf_eth_src_addr_unmatch;
 extern npf_test_fn_t npf_eth_dst_addr_match;
 extern npf_test_fn_t npf_eth_dst_addr_unmatch;
 
+bool npf_eth_addr_match(struct npf_test *test, struct net_eth_addr *pkt_addr);
+
 /** @endcond */
 
 /**
@@ -163,6 +163,11 @@ struct net_stats_tcp {
 
 	/** Number of connection attempts for closed ports, triggering a RST. */
 	net_stats_t connrst;
+
+	/** Number of received TCP segments coalesced into a previously
+	 * received segment.
+	 */
+	net_stats_t coalesced;
 };
 
 /**
@@ -286,6 +291,23 @@ struct net_stats_pm {
 };
 
 
+/**
+ * @brief Dedicated packet pool statistics
+ */
+struct net_stats_pkt_pool {
+	/** Packets allocated from a dedicated pool */
+	net_stats_t alloc;
+
+	/** Packets borrowed from the shared pool */
+	net_stats_t fallback;
+
+	/** Failed allocations */
+	net_stats_t alloc_failed;
+
+	/** How many times a dedicated pool became congested */
+	net_stats_t congested;
+};
+
 /**
  * @brief All network statistics in one struct.
  */
@@ -369,6 +391,11 @@ struct net_stats {
 #if defined(CONFIG_NET_STATISTICS_POWER_MANAGEMENT)
 	struct net_stats_pm pm;
 #endif
+
+#if defined(CONFIG_NET_STATISTICS_PKT_POOL)
+	/** Dedicated packet pool statistics */
+	struct net_stats_pkt_pool pkt_pool;
+#endif
 };
 
 /**
@@ -519,6 +546,7 @@ enum net_request_stats_cmd {
 	NET_REQUEST_STATS_CMD_GET_PPP,
 	NET_REQUEST_STATS_CMD_GET_PM,
 	NET_REQUEST_STATS_CMD_GET_WIFI,
+	NET_REQUEST_STATS_CMD_GET_PKT_POOL,
 };
 
 #define NET_REQUEST_STATS_GET_ALL				\
@@ -597,6 +625,13 @@ NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_ETHERNET);
 NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_PPP);
 #endif /* CONFIG_NET_STATISTICS_PPP */
 
+#if defined(CONFIG_NET_STATISTICS_PKT_POOL)
+#define NET_REQUEST_STATS_GET_PKT_POOL				\
+	(_NET_STATS_BASE | NET_REQUEST_STATS_CMD_GET_PKT_POOL)
+
+NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_PKT_POOL);
+#endif /* CONFIG_NET_STATISTICS_PKT_POOL */
+
 #endif /* CONFIG_NET_STATISTICS_USER_API */
 
 #if defined(CONFIG_NET_STATISTICS_POWER_MANAGEMENT)
@@ -63,6 +63,8 @@ struct zsock_pollfd {
 #define ZSOCK_MSG_DONTWAIT 0x40
 /** zsock_recv: block until the full amount of data can be returned */
 #define ZSOCK_MSG_WAITALL 0x100
+/** zsock_recvmmsg: block only until the first message has been received */
+#define ZSOCK_MSG_WAITFORONE 0x10000
 
 /* Well-known values, e.g. from Linux man 2 shutdown:
  * "The constants SHUT_RD, SHUT_WR, SHUT_RDWR have the value 0, 1, 2,
@@ -163,6 +165,29 @@ struct zsock_pollfd {
  *  This option accepts any value.
  */
 #define TLS_SESSION_CACHE_PURGE 13
+/** Socket option to collect small writes to a TLS socket into larger TLS
+ *  records. Accepted values:
+ *  - 0 - Disabled, data collected so far is sent.
+ *  - 1 - Enabled.
+ *  Collected data is sent when the buffer of
+ *  CONFIG_NET_SOCKETS_TLS_TX_COALESCE_SIZE bytes is full, when
+ *  TLS_TX_FLUSH or TCP_NODELAY is set, before receiving data, when the
+ *  socket is polled for POLLIN or POLLOUT and when the socket is closed.
+ *  Sending before polling or receiving does not block; data that does not
+ *  fit into the TCP send window stays collected until the next call.
+ *  Only supported on TLS (not DTLS) sockets.
+ */
+#define TLS_TX_COALESCE 14
+/** Write-only socket option to send the data collected on a socket with
+ *  TLS_TX_COALESCE immediately. This option accepts any value.
+ */
+#define TLS_TX_FLUSH 15
+/** Read-only socket option to check whether a TLS server resumed the session
+ *  of its client from the session cache or a session ticket, instead of
+ *  doing a full handshake. Returns 1 if it did, 0 otherwise. Only set on
+ *  sockets returned by accept().
+ */
+#define TLS_SESSION_RESUMED 16
 
 /** @} */
 
@@ -183,6 +208,10 @@ struct zsock_pollfd {
 #define TLS_SESSION_CACHE_DISABLED 0 /**< Disable TLS session caching. */
 #define TLS_SESSION_CACHE_ENABLED 1 /**< Enable TLS session caching. */
 
+/* Valid values for TLS_TX_COALESCE option */
+#define TLS_TX_COALESCE_DISABLED 0 /**< Send each write as a TLS record. */
+#define TLS_TX_COALESCE_ENABLED 1 /**< Collect writes into TLS records. */
+
 struct zsock_addrinfo {
 	struct zsock_addrinfo *ai_next;
 	int ai_flags;
@@ -403,6 +432,24 @@ static inline ssize_t zsock_send(int sock, const void *buf, size_t len,
 __syscall ssize_t zsock_sendmsg(int sock, const struct msghdr *msg,
 				int flags);
 
+/**
+ * @brief Send multiple messages on a socket
+ *
+ * @details
+ * @rst
+ * Sends up to ``vlen`` messages with a single call, see Linux
+ * ``sendmmsg(2)``. The number of bytes sent for each message is stored
+ * in its ``msg_len`` field. If an error occurs after at least one message
+ * has been sent, the number of sent messages is returned.
+ * This function is also exposed as ``sendmmsg()``
+ * if :kconfig:option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @return Number of messages sent, or -1 with errno set.
+ */
+__syscall int zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
 /**
  * @brief Receive data from an arbitrary network address
  *
@@ -419,6 +466,27 @@ __syscall ssize_t zsock_recvfrom(int sock, void *buf, size_t max_len,
 				 int flags, struct sockaddr *src_addr,
 				 socklen_t *addrlen);
 
+/**
+ * @brief Receive multiple datagrams from a socket
+ *
+ * @details
+ * @rst
+ * Receives up to ``vlen`` datagrams with a single call, see Linux
+ * ``recvmmsg(2)``. Each datagram is scattered into the ``msg_iov`` of one
+ * message, its length is stored in ``msg_len`` and the source address in
+ * ``msg_name``. With ``ZSOCK_MSG_WAITFORONE`` the call only blocks until
+ * the first datagram has arrived. Ancillary data and ``ZSOCK_MSG_PEEK``
+ * are not supported, and there is no timeout argument, the receive
+ * timeout of the socket is used instead.
+ * This function is also exposed as ``recvmmsg()``
+ * if :kconfig:option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @return Number of datagrams received, or -1 with errno set.
+ */
+__syscall int zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
 /**
  * @brief Receive data from a connected peer
  *
@@ -437,6 +505,72 @@ static inline ssize_t zsock_recv(int sock, void *buf, size_t max_len,
 	return zsock_recvfrom(sock, buf, max_len, flags, NULL, NULL);
 }
 
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY) || defined(__DOXYGEN__)
+struct net_pkt;
+
+/**
+ * @brief Zero-copy send completion callback
+ *
+ * @param buf Data buffer given to zsock_sendto_zerocopy().
+ * @param len Length of the data buffer.
+ * @param user_data User data given to zsock_sendto_zerocopy().
+ */
+typedef void (*zsock_zerocopy_cb_t)(const void *buf, size_t len,
+				    void *user_data);
+
+/**
+ * @brief Send data without copying it
+ *
+ * @details
+ * Works like zsock_sendto() but the network packet refers to the caller
+ * owned @a buf instead of holding a copy of it. The data must not be
+ * modified or released until @a cb is called, which happens when the
+ * network stack no longer uses it. The callback is called also if the
+ * send fails, and it can be called from the context of the network TX
+ * path, so it should not block. Only supported for native datagram
+ * sockets and only available to kernel threads.
+ *
+ * @param sock Socket descriptor.
+ * @param buf Data to send.
+ * @param len Length of the data.
+ * @param flags Send flags, only ZSOCK_MSG_DONTWAIT is supported.
+ * @param dest_addr Destination address, or NULL for a connected socket.
+ * @param addrlen Length of the destination address.
+ * @param cb Completion callback, can be NULL.
+ * @param user_data User data passed to the completion callback.
+ *
+ * @return Number of bytes queued for sending, or -1 with errno set.
+ */
+ssize_t zsock_sendto_zerocopy(int sock, const void *buf, size_t len,
+			      int flags, const struct sockaddr *dest_addr,
+			      socklen_t addrlen, zsock_zerocopy_cb_t cb,
+			      void *user_data);
+
+/**
+ * @brief Receive a network packet without copying its data
+ *
+ * @details
+ * Hands the next received network packet over to the caller. The packet
+ * cursor points to the start of the payload, so the data can be accessed
+ * with the net_pkt API or directly through the net_buf fragments. The
+ * caller owns the packet and must release it with net_pkt_unref(). For
+ * stream sockets the data is acknowledged to the peer when the packet is
+ * returned. Only supported for native sockets and only available to
+ * kernel threads.
+ *
+ * @param sock Socket descriptor.
+ * @param pkt Where to store the received packet.
+ * @param flags Receive flags, only ZSOCK_MSG_DONTWAIT is supported.
+ * @param src_addr Source address of a datagram, can be NULL.
+ * @param addrlen Length of the source address, value-result argument.
+ *
+ * @return Number of payload bytes in the packet, 0 at end of stream, or -1
+ *         with errno set.
+ */
+ssize_t zsock_recv_zerocopy(int sock, struct net_pkt **pkt, int flags,
+			    struct sockaddr *src_addr, socklen_t *addrlen);
+#endif /* CONFIG_NET_SOCKETS_ZEROCOPY */
+
 /**
  * @brief Control blocking/non-blocking mode of a socket
  *
@@ -777,6 +911,13 @@ static inline ssize_t sendmsg(int sock, const struct msghdr *message,
 	return zsock_sendmsg(sock, message, flags);
 }
 
+/** POSIX wrapper for @ref zsock_sendmmsg */
+static inline int sendmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_sendmmsg(sock, msgvec, vlen, flags);
+}
+
 /** POSIX wrapper for @ref zsock_recvfrom */
 static inline ssize_t recvfrom(int sock, void *buf, size_t max_len, int flags,
 			       struct sockaddr *src_addr, socklen_t *addrlen)
@@ -784,6 +925,13 @@ static inline ssize_t recvfrom(int sock, void *buf, size_t max_len, int flags,
 	return zsock_recvfrom(sock, buf, max_len, flags, src_addr, addrlen);
 }
 
+/** POSIX wrapper for @ref zsock_recvmmsg */
+static inline int recvmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_recvmmsg(sock, msgvec, vlen, flags);
+}
+
 /** POSIX wrapper for @ref zsock_poll */
 static inline int poll(struct zsock_pollfd *fds, int nfds, int timeout)
 {
@@ -887,6 +1035,8 @@ static inline char *inet_ntop(sa_family_t family, const void *src, char *dst,
 #define MSG_DONTWAIT ZSOCK_MSG_DONTWAIT
 /** POSIX wrapper for @ref ZSOCK_MSG_WAITALL */
 #define MSG_WAITALL ZSOCK_MSG_WAITALL
+/** POSIX wrapper for @ref ZSOCK_MSG_WAITFORONE */
+#define MSG_WAITFORONE ZSOCK_MSG_WAITFORONE
 
 /** POSIX wrapper for @ref ZSOCK_SHUT_RD */
 #define SHUT_RD ZSOCK_SHUT_RD
@@ -0,0 +1,169 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ * @brief BSD socket service API
+ *
+ * Sockets registered by the network libraries and applications are polled
+ * together by a single thread, and the handler of the service owning a
+ * socket is called when the socket has an event.
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_SOCKET_SERVICE_H_
+#define ZEPHYR_INCLUDE_NET_SOCKET_SERVICE_H_
+
+/**
+ * @brief BSD socket service API
+ * @defgroup bsd_socket_service BSD socket service API
+ * @ingroup networking
+ * @{
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/sys/iterable_sections.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct net_socket_service_desc;
+
+/**
+ * Socket registered to a service. The handler of the service gets the
+ * work item of this structure, use CONTAINER_OF() to get back to it.
+ */
+struct net_socket_service_event {
+	/** Work item given to the service handler. */
+	struct k_work work;
+	/** Socket and polled events, revents tells what woke up the service. */
+	struct zsock_pollfd event;
+	/** User data given to net_socket_service_register(). */
+	void *user_data;
+	/** Service the socket is registered to. */
+	const struct net_socket_service_desc *svc;
+	/** @cond INTERNAL_HIDDEN */
+	/* Not polled while its handler has not returned */
+	bool busy;
+	/** @endcond */
+};
+
+/** Socket service, defined with @ref NET_SOCKET_SERVICE_SYNC_DEFINE or
+ * @ref NET_SOCKET_SERVICE_ASYNC_DEFINE.
+ */
+struct net_socket_service_desc {
+	/** Name of the service, for debugging. */
+	const char *owner;
+	/** Handler called when a socket of the service has an event. */
+	k_work_handler_t handler;
+	/** Work queue running the handler, NULL to run it from the service
+	 * thread.
+	 */
+	struct k_work_q *work_q;
+	/** @cond INTERNAL_HIDDEN */
+	struct net_socket_service_event *pev;
+	int pev_len;
+	/** @endcond */
+};
+
+/** @cond INTERNAL_HIDDEN */
+
+#define Z_NET_SOCKET_SERVICE_DEFINE(_name, _work_q, _handler, _count)                              \
+	static struct net_socket_service_event                                                     \
+		_CONCAT(_net_socket_service_events_, _name)[_count];                               \
+	const STRUCT_SECTION_ITERABLE(net_socket_service_desc, _name) = {                          \
+		.owner = STRINGIFY(_name),                                                         \
+		.handler = _handler,                                                               \
+		.work_q = _work_q,                                                                 \
+		.pev = _CONCAT(_net_socket_service_events_, _name),                                \
+		.pev_len = (_count),                                                               \
+	}
+
+/** @endcond */
+
+/**
+ * @brief Define a socket service calling its handler from the service thread.
+ *
+ * The handler should not block, as it delays the events of all the other
+ * services.
+ *
+ * @param _name Name of the service.
+ * @param _handler Handler called when a socket has an event.
+ * @param _count Maximum number of sockets of the service.
+ */
+#define NET_SOCKET_SERVICE_SYNC_DEFINE(_name, _handler, _count)                                    \
+	Z_NET_SOCKET_SERVICE_DEFINE(_name, NULL, _handler, _count)
+
+/**
+ * @brief Define a socket service calling its handler from a work queue.
+ *
+ * A socket is not polled again until its handler has returned.
+ *
+ * @param _name Name of the service.
+ * @param _work_q Work queue running the handler, for example &k_sys_work_q.
+ * @param _handler Handler called when a socket has an event.
+ * @param _count Maximum number of sockets of the service.
+ */
+#define NET_SOCKET_SERVICE_ASYNC_DEFINE(_name, _work_q, _handler, _count)                          \
+	Z_NET_SOCKET_SERVICE_DEFINE(_name, _work_q, _handler, _count)
+
+/**
+ * @brief Iterate over all socket services.
+ *
+ * @param _it Name of iterator (of type @ref net_socket_service_desc)
+ */
+#define NET_SOCKET_SERVICE_FOREACH(_it) STRUCT_SECTION_FOREACH(net_socket_service_desc, _it)
+
+/**
+ * @brief Register the sockets of a service.
+ *
+ * Replaces the sockets previously registered by the service. The fd and
+ * events fields of @p fds are copied, a negative fd leaves its slot unused.
+ *
+ * @param service Service the sockets are registered to.
+ * @param fds Sockets to poll, NULL to unregister all the sockets.
+ * @param len Number of entries in @p fds.
+ * @param user_data User data given back in the events of the sockets.
+ *
+ * @return 0 if ok, -ENOMEM if the service cannot hold @p len sockets or if
+ *         all the services would have more sockets than
+ *         CONFIG_NET_SOCKETS_POLL_MAX - 1, <0 if error.
+ */
+int net_socket_service_register(const struct net_socket_service_desc *service,
+				struct zsock_pollfd *fds, int len, void *user_data);
+
+/**
+ * @brief Unregister all the sockets of a service.
+ *
+ * A handler already running or queued for one of the sockets is not
+ * cancelled.
+ *
+ * @param service Service to unregister.
+ *
+ * @return 0 if ok, <0 if error.
+ */
+static inline int net_socket_service_unregister(const struct net_socket_service_desc *service)
+{
+	return net_socket_service_register(service, NULL, 0, NULL);
+}
+
+/**
+ * @brief Get the number of times the service thread has woken up.
+ *
+ * @return Number of returns from poll since boot.
+ */
+uint32_t net_socket_service_wakeups(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* ZEPHYR_INCLUDE_NET_SOCKET_SERVICE_H_ */
@@ -151,11 +151,38 @@ int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
 		       enum websocket_opcode opcode, bool mask, bool final,
 		       int32_t timeout);
 
+/** Maximum number of buffers sent in one frame by websocket_send_frame() */
+#define WEBSOCKET_FRAME_MAX_IOV 8
+
+/**
+ * @brief Send websocket frame to peer from application buffers.
+ *
+ * @details The websocket header is built on the stack and the frame is sent
+ * with the payload taken directly from the given buffers, without copying
+ * it. If @p mask is set, the buffers are masked in place while the frame is
+ * sent and restored before the function returns, so they must be writable
+ * and must not be accessed concurrently.
+ *
+ * @param ws_sock Websocket id returned by websocket_connect().
+ * @param iov Buffers holding the payload of the frame.
+ * @param iovcnt Number of buffers, at most WEBSOCKET_FRAME_MAX_IOV.
+ * @param opcode Operation code (text, binary, ping, pong, close)
+ * @param mask Mask the data, see RFC 6455 for details
+ * @param final Is this final frame for this message, see websocket_send_msg().
+ * @param timeout How long to try to send the frame. The value is in
+ *        milliseconds. Value SYS_FOREVER_MS means to wait forever.
+ *
+ * @return <0 if error, >=0 amount of payload bytes sent
+ */
+int websocket_send_frame(int ws_sock, const struct iovec *iov, size_t iovcnt,
+			 enum websocket_opcode opcode, bool mask, bool final,
+			 int32_t timeout);
+
 /**
  * @brief Receive websocket msg from peer.
  *
  * @details The function will automatically remove websocket header from the
- * message.
+ * message. Payload that is not yet buffered is read directly into @p buf.
  *
  * @param ws_sock Websocket id returned by websocket_connect().
  * @param buf Buffer where websocket data is read.
@@ -37,6 +37,15 @@ struct zperf_upload_params {
 	struct {
 		uint8_t tos;
 		int tcp_nodelay;
+		/** Number of parallel streams, 0 or 1 for a single stream.
+		 *  Limited by CONFIG_NET_ZPERF_MAX_STREAMS.
+		 */
+		uint8_t streams;
+		/** When not 0, ask the server to send a stream back to this
+		 *  local port during the test (iperf2 dual test). A download
+		 *  server must be running on the port.
+		 */
+		uint16_t dual_port;
 	} options;
 };
 
@@ -55,6 +64,17 @@ struct zperf_results {
 	uint32_t client_time_in_us;
 	uint32_t packet_size;
 	uint32_t nb_packets_errors;
+	/** CPU load during the test in per mille, 0 if
+	 *  CONFIG_SCHED_THREAD_USAGE_ALL is not enabled.
+	 */
+	uint32_t cpu_load_permille;
+	/** Round trip times of a latency test. */
+	uint32_t latency_min_us;
+	uint32_t latency_avg_us;
+	uint32_t latency_max_us;
+	uint32_t latency_p50_us;
+	uint32_t latency_p99_us;
+	uint32_t latency_p999_us;
 };
 
 /**
@@ -92,6 +112,25 @@ int zperf_udp_upload(const struct zperf_upload_params *param,
 int zperf_tcp_upload(const struct zperf_upload_params *param,
 		     struct zperf_results *result);
 
+/**
+ * @brief Synchronous UDP latency test. The function blocks until the test
+ *        is complete.
+ *
+ * Datagrams are sent one at a time to a UDP echo server, and the round trip
+ * time of each echoed datagram is recorded. The percentiles are computed from
+ * a histogram with a bucket width of at most 1/8 of the measured value.
+ * Datagrams not echoed within a second are counted as lost, echoes arriving
+ * after that are counted as out of order. If the rate is not 0, the requests
+ * are paced to that rate, otherwise they are sent back to back.
+ *
+ * @param param Test parameters, the stream options are not supported.
+ * @param result Session results.
+ *
+ * @return 0 if session completed successfully, a negative error code otherwise.
+ */
+int zperf_udp_latency(const struct zperf_upload_params *param,
+		      struct zperf_results *result);
+
 /**
  * @brief Asynchronous UDP upload operation.
  *
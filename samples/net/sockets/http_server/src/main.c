@@ -0,0 +1,90 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_http_server_sample, LOG_LEVEL_DBG);
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/http/server.h>
+#include <zephyr/net/http/service.h>
+
+#define SERVER_PORT 8080
+
+static const uint8_t index_html_gz[] = {
+#include "index.html.gz.inc"
+};
+
+static uint16_t sample_port = SERVER_PORT;
+HTTP_SERVICE_DEFINE(sample_service, "0.0.0.0", &sample_port,
+		    CONFIG_HTTP_SERVER_MAX_CLIENTS, 4, NULL);
+
+static struct http_resource_detail_static index_html_gz_detail = {
+	.common = {
+		.bitmask_of_supported_http_methods =
+			HTTP_METHOD_BIT(HTTP_GET) | HTTP_METHOD_BIT(HTTP_HEAD),
+		.type = HTTP_RESOURCE_TYPE_STATIC,
+		.content_encoding = "gzip",
+		.content_type = "text/html",
+	},
+	.static_data = index_html_gz,
+	.static_data_len = sizeof(index_html_gz),
+};
+
+HTTP_RESOURCE_DEFINE(index_html_gz_resource, sample_service, "/",
+		     &index_html_gz_detail);
+
+/* All requests are served from the server thread, one at a time */
+static bool uptime_sent;
+
+static int uptime_handler(struct http_client_ctx *client,
+			  enum http_data_status status,
+			  uint8_t *data_buffer, size_t data_len,
+			  void *user_data)
+{
+	ARG_UNUSED(client);
+	ARG_UNUSED(user_data);
+
+	if (status != HTTP_SERVER_DATA_RESPONSE) {
+		uptime_sent = false;
+		return 0;
+	}
+
+	if (uptime_sent) {
+		uptime_sent = false;
+		return 0;
+	}
+
+	uptime_sent = true;
+
+	return snprintk((char *)data_buffer, data_len, "%lld", k_uptime_get());
+}
+
+static struct http_resource_detail_dynamic uptime_detail = {
+	.common = {
+		.bitmask_of_supported_http_methods = HTTP_METHOD_BIT(HTTP_GET),
+		.type = HTTP_RESOURCE_TYPE_DYNAMIC,
+		.content_type = "text/plain",
+	},
+	.cb = uptime_handler,
+};
+
+HTTP_RESOURCE_DEFINE(uptime_resource, sample_service, "/uptime",
+		     &uptime_detail);
+
+int main(void)
+{
+	int ret;
+
+	ret = http_server_start();
+	if (ret < 0) {
+		LOG_ERR("Cannot start HTTP server (%d)", ret);
+		return 0;
+	}
+
+	LOG_INF("HTTP server listening on port %u", sample_port);
+	LOG_INF("Up to %d connections, %zu bytes of RAM each",
+		CONFIG_HTTP_SERVER_MAX_CLIENTS, sizeof(struct http_client_ctx));
+
+	return 0;
+}
@@ -25,6 +25,7 @@ LOG_MODULE_REGISTER(net_6lo, CONFIG_NET_6LO_LOG_LEVEL);
 #if defined(CONFIG_NET_6LO_CONTEXT)
 struct net_6lo_context {
 	struct in6_addr prefix;
+	uint64_t prefix64;	/* first 64 bits of the prefix, as read */
 	struct net_if *iface;
 	uint16_t lifetime;
 	uint8_t is_used		: 1;
@@ -44,6 +45,15 @@ static inline uint8_t get_6co_cid(struct net_icmpv6_nd_opt_6co *opt)
 }
 
 static struct net_6lo_context ctx_6co[CONFIG_NET_MAX_6LO_CONTEXTS];
+
+/* Lookup tables of the context table: the slots in use, and the slots in
+ * use for each context id. They are kept up to date when the contexts are
+ * set so that the per packet lookups only visit matching slots.
+ */
+static uint16_t ctx_6co_used;
+static uint16_t ctx_6co_by_cid[16];
+
+BUILD_ASSERT(CONFIG_NET_MAX_6LO_CONTEXTS <= 16);
 #endif
 
 static const uint8_t udp_nhc_inline_size_table[] = {4, 3, 3, 1};
@@ -161,6 +171,10 @@ static inline void set_6lo_context(struct net_if *iface, uint8_t index,
 				   struct net_icmpv6_nd_opt_6co *context)
 
 {
+	if (ctx_6co[index].is_used) {
+		ctx_6co_by_cid[ctx_6co[index].cid] &= ~BIT(index);
+	}
+
 	ctx_6co[index].is_used = true;
 	ctx_6co[index].iface = iface;
 
@@ -170,6 +184,18 @@ static inline void set_6lo_context(struct net_if *iface, uint8_t index,
 	ctx_6co[index].cid = get_6co_cid(context);
 
 	net_ipv6_addr_copy_raw((uint8_t *)&ctx_6co[index].prefix, context->prefix);
+	ctx_6co[index].prefix64 = UNALIGNED_GET((uint64_t *)ctx_6co[index].prefix.s6_addr);
+
+	ctx_6co_used |= BIT(index);
+	ctx_6co_by_cid[ctx_6co[index].cid] |= BIT(index);
+}
+
+static inline void unset_6lo_context(uint8_t index)
+{
+	ctx_6co[index].is_used = false;
+
+	ctx_6co_used &= ~BIT(index);
+	ctx_6co_by_cid[ctx_6co[index].cid] &= ~BIT(index);
 }
 
 void net_6lo_set_context(struct net_if *iface,
@@ -191,7 +217,7 @@ void net_6lo_set_context(struct net_if *iface,
 		    ctx_6co[i].cid == get_6co_cid(context)) {
 			/* Remove if lifetime is zero */
 			if (!context->lifetime) {
-				ctx_6co[i].is_used = false;
+				unset_6lo_context(i);
 				return;
 			}
 
@@ -214,16 +240,16 @@ void net_6lo_set_context(struct net_if *iface,
 static inline struct net_6lo_context *
 get_6lo_context_by_cid(struct net_if *iface, uint8_t cid)
 {
-	uint8_t i;
+	uint16_t slots = ctx_6co_by_cid[cid & 0x0F];
 
-	for (i = 0U; i < CONFIG_NET_MAX_6LO_CONTEXTS; i++) {
-		if (!ctx_6co[i].is_used) {
-			continue;
-		}
+	while (slots) {
+		uint8_t i = find_lsb_set(slots) - 1;
 
-		if (ctx_6co[i].iface == iface && ctx_6co[i].cid == cid) {
+		if (ctx_6co[i].iface == iface) {
 			return &ctx_6co[i];
 		}
+
+		slots &= slots - 1U;
 	}
 
 	return NULL;
@@ -233,17 +259,23 @@ get_6lo_context_by_cid(struct net_if *iface, uint8_t cid)
 static inline struct net_6lo_context *
 get_6lo_context_by_addr(struct net_if *iface, struct in6_addr *addr)
 {
-	uint8_t i;
+	uint16_t slots = ctx_6co_used;
+	uint64_t prefix64;
 
-	for (i = 0U; i < CONFIG_NET_MAX_6LO_CONTEXTS; i++) {
-		if (!ctx_6co[i].is_used) {
-			continue;
-		}
+	if (!slots) {
+		return NULL;
+	}
 
-		if (ctx_6co[i].iface == iface &&
-		    !memcmp(ctx_6co[i].prefix.s6_addr, addr->s6_addr, 8)) {
+	prefix64 = UNALIGNED_GET((uint64_t *)addr->s6_addr);
+
+	while (slots) {
+		uint8_t i = find_lsb_set(slots) - 1;
+
+		if (ctx_6co[i].prefix64 == prefix64 && ctx_6co[i].iface == iface) {
 			return &ctx_6co[i];
 		}
+
+		slots &= slots - 1U;
 	}
 
 	return NULL;
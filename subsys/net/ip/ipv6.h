@@ -90,6 +90,9 @@ struct net_ipv6_nbr_data {
 	/** IPv6 address. */
 	struct in6_addr addr;
 
+	/** Link in the neighbor cache hash bucket of the address. */
+	sys_snode_t hash_node;
+
 	/** Reachable timer. */
 	int64_t reachable;
 
@@ -98,6 +98,22 @@ NET_NBR_TABLE_INIT(NET_NBR_GLOBAL,
 		   net_neighbor_pool,
 		   net_neighbor_table_clear);
 
+/* Neighbors in use, hashed by the last 32 bits of their address.
+ * Neighbors leave the buckets when their last reference is dropped, which
+ * can happen from any thread, for example when a route is deleted. The
+ * buckets have their own lock, as nbr_lock is held while references are
+ * dropped.
+ */
+static sys_slist_t nbr_hash[CONFIG_NET_IPV6_NBR_HASH_SIZE];
+static struct k_spinlock nbr_hash_lock;
+
+static inline sys_slist_t *nbr_hash_bucket(const struct in6_addr *addr)
+{
+	uint32_t key = ntohl(UNALIGNED_GET(&addr->s6_addr32[3]));
+
+	return &nbr_hash[key % CONFIG_NET_IPV6_NBR_HASH_SIZE];
+}
+
 const char *net_ipv6_nbr_state2str(enum net_ipv6_nbr_state state)
 {
 	switch (state) {
@@ -259,10 +275,17 @@ static struct net_nbr *nbr_lookup(struct net_nbr_table *table,
 				  struct net_if *iface,
 				  const struct in6_addr *addr)
 {
-	int i;
+	struct net_ipv6_nbr_data *data;
+	struct net_nbr *found = NULL;
+	k_spinlock_key_t key;
 
-	for (i = 0; i < CONFIG_NET_IPV6_MAX_NEIGHBORS; i++) {
-		struct net_nbr *nbr = get_nbr(i);
+	ARG_UNUSED(table);
+
+	key = k_spin_lock(&nbr_hash_lock);
+
+	SYS_SLIST_FOR_EACH_CONTAINER(nbr_hash_bucket(addr), data, hash_node) {
+		struct net_nbr *nbr = CONTAINER_OF((uint8_t *)data,
+						   struct net_nbr, __nbr);
 
 		if (!nbr->ref) {
 			continue;
@@ -273,11 +296,14 @@ static struct net_nbr *nbr_lookup(struct net_nbr_table *table,
 		}
 
 		if (net_ipv6_addr_cmp(&net_ipv6_nbr_data(nbr)->addr, addr)) {
-			return nbr;
+			found = nbr;
+			break;
 		}
 	}
 
-	return NULL;
+	k_spin_unlock(&nbr_hash_lock, key);
+
+	return found;
 }
 
 static inline void nbr_clear_ns_pending(struct net_ipv6_nbr_data *data)
@@ -403,10 +429,18 @@ static void nbr_init(struct net_nbr *nbr, struct net_if *iface,
 		     const struct in6_addr *addr, bool is_router,
 		     enum net_ipv6_nbr_state state)
 {
+	k_spinlock_key_t key;
+
 	nbr->idx = NET_NBR_LLADDR_UNKNOWN;
 	nbr->iface = iface;
 
 	net_ipaddr_copy(&net_ipv6_nbr_data(nbr)->addr, addr);
+
+	key = k_spin_lock(&nbr_hash_lock);
+	sys_slist_prepend(nbr_hash_bucket(addr),
+			  &net_ipv6_nbr_data(nbr)->hash_node);
+	k_spin_unlock(&nbr_hash_lock, key);
+
 	ipv6_nbr_set_state(nbr, state);
 	net_ipv6_nbr_data(nbr)->is_router = is_router;
 	net_ipv6_nbr_data(nbr)->pending = NULL;
@@ -648,9 +682,15 @@ struct net_nbr *net_ipv6_nbr_add(struct net_if *iface,
 
 void net_neighbor_data_remove(struct net_nbr *nbr)
 {
+	struct net_ipv6_nbr_data *data = net_ipv6_nbr_data(nbr);
+	k_spinlock_key_t key;
+
 	NET_DBG("Neighbor %p removed", nbr);
 
-	return;
+	key = k_spin_lock(&nbr_hash_lock);
+	(void)sys_slist_find_and_remove(nbr_hash_bucket(&data->addr),
+					&data->hash_node);
+	k_spin_unlock(&nbr_hash_lock, key);
 }
 
 void net_neighbor_table_clear(struct net_nbr_table *table)
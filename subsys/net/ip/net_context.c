@@ -1319,11 +1319,81 @@ static int context_write_data(struct net_pkt *pkt, const void *buf,
 	return ret;
 }
 
+/* Write the payload and calculate its checksum in the same pass. The
+ * partial sum is stored in the UDP checksum field so that finalizing the
+ * packet only needs to sum the pseudo header and the UDP header.
+ */
+static int context_write_data_chksum(struct net_pkt *pkt, const void *buf,
+				     int buf_len, const struct msghdr *msghdr)
+{
+	struct net_pkt_cursor backup;
+	size_t offset = 0;
+	uint16_t sum = 0U;
+	int ret = 0;
+
+	if (msghdr) {
+		int i;
+
+		for (i = 0; i < msghdr->msg_iovlen; i++) {
+			int len = MIN(msghdr->msg_iov[i].iov_len, buf_len);
+			uint16_t part = 0U;
+			uint32_t tmp;
+
+			ret = net_pkt_write_chksum(pkt,
+						   msghdr->msg_iov[i].iov_base,
+						   len, &part);
+			if (ret < 0) {
+				return ret;
+			}
+
+			if (offset & 1) {
+				part = __bswap_16(part);
+			}
+
+			tmp = (uint32_t)sum + part;
+			sum = (uint16_t)((tmp & 0xffff) + (tmp >> 16));
+			offset += len;
+
+			buf_len -= len;
+			if (buf_len == 0) {
+				break;
+			}
+		}
+	} else {
+		ret = net_pkt_write_chksum(pkt, buf, buf_len, &sum);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	net_pkt_cursor_backup(pkt, &backup);
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	ret = net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt) +
+			   net_pkt_ip_opts_len(pkt) +
+			   offsetof(struct net_udp_hdr, chksum));
+	if (ret == 0) {
+		/* The sum is a host value, store it in network byte order */
+		ret = net_pkt_write_be16(pkt, sum);
+	}
+
+	net_pkt_set_overwrite(pkt, false);
+	net_pkt_cursor_restore(pkt, &backup);
+
+	if (ret == 0) {
+		net_pkt_set_chksum_partial(pkt, true);
+	}
+
+	return ret;
+}
+
 static int context_setup_udp_packet(struct net_context *context,
 				    struct net_pkt *pkt,
 				    const void *buf,
 				    size_t len,
 				    const struct msghdr *msg,
+				    struct net_buf *frags,
 				    const struct sockaddr *dst_addr,
 				    socklen_t addrlen)
 {
@@ -1365,7 +1435,20 @@ static int context_setup_udp_packet(struct net_context *context,
 		return ret;
 	}
 
-	ret = context_write_data(pkt, buf, len, msg);
+	if (frags) {
+		/* The payload is referenced as is, checksum is calculated
+		 * over the whole packet when it is finalized.
+		 */
+		net_pkt_append_buffer(pkt, net_buf_ref(frags));
+		return 0;
+	}
+
+	if (net_if_need_calc_tx_checksum(net_pkt_iface(pkt))) {
+		ret = context_write_data_chksum(pkt, buf, len, msg);
+	} else {
+		ret = context_write_data(pkt, buf, len, msg);
+	}
+
 	if (ret) {
 		return ret;
 	}
@@ -1373,6 +1456,33 @@ static int context_setup_udp_packet(struct net_context *context,
 	return 0;
 }
 
+/* A datagram built from external fragments is not limited by the packet
+ * buffer allocation, so check its size against the MTU here instead.
+ */
+static bool context_dgram_fits(struct net_context *context,
+			       struct net_pkt *pkt)
+{
+	size_t max_len = net_if_get_mtu(net_pkt_iface(pkt));
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) &&
+	    net_context_get_family(context) == AF_INET6) {
+		if (IS_ENABLED(CONFIG_NET_IPV6_FRAGMENT)) {
+			return true;
+		}
+
+		max_len = MAX(max_len, NET_IPV6_MTU);
+	} else if (IS_ENABLED(CONFIG_NET_IPV4) &&
+		   net_context_get_family(context) == AF_INET) {
+		if (IS_ENABLED(CONFIG_NET_IPV4_FRAGMENT)) {
+			return true;
+		}
+
+		max_len = MAX(max_len, NET_IPV4_MTU);
+	}
+
+	return net_pkt_get_len(pkt) <= max_len;
+}
+
 static void context_finalize_packet(struct net_context *context,
 				    struct net_pkt *pkt)
 {
@@ -1416,6 +1526,42 @@ static struct net_pkt *context_alloc_pkt(struct net_context *context,
 
 		return pkt;
 	}
+#endif
+#if defined(CONFIG_NET_PKT_POOL_BINDING)
+	if (net_context_get_iface(context)) {
+		struct net_if *iface = net_context_get_iface(context);
+		struct net_pkt_pool *pool;
+		uint8_t priority = NET_PRIORITY_BE;
+
+		get_context_priority(context, &priority, NULL);
+
+		pool = net_if_pkt_pool_get(iface, NET_IF_PKT_POOL_TX, priority);
+		if (pool) {
+			/* Leave what is left of a congested pool to the
+			 * network stack, the sender has to back off.
+			 */
+			if (net_pkt_pool_is_congested(pool)) {
+				return NULL;
+			}
+
+			pkt = net_pkt_alloc_from_pool(pool, iface, timeout);
+			if (!pkt) {
+				return NULL;
+			}
+
+			net_pkt_set_family(pkt, net_context_get_family(context));
+			net_pkt_set_context(pkt, context);
+
+			if (net_pkt_alloc_buffer(pkt, len,
+						 net_context_get_proto(context),
+						 timeout)) {
+				net_pkt_unref(pkt);
+				return NULL;
+			}
+
+			return pkt;
+		}
+	}
 #endif
 	pkt = net_pkt_alloc_with_buffer(net_context_get_iface(context), len,
 					net_context_get_family(context),
@@ -1453,7 +1599,8 @@ static int context_sendto(struct net_context *context,
 			  net_context_send_cb_t cb,
 			  k_timeout_t timeout,
 			  void *user_data,
-			  bool sendto)
+			  bool sendto,
+			  struct net_buf *frags)
 {
 	const struct msghdr *msghdr = NULL;
 	struct net_if *iface;
@@ -1661,12 +1808,29 @@ static int context_sendto(struct net_context *context,
 		}
 	}
 
+	if (frags) {
+		if (!IS_ENABLED(CONFIG_NET_UDP) ||
+		    net_context_get_proto(context) != IPPROTO_UDP) {
+			return -EOPNOTSUPP;
+		}
+
+		len = net_buf_frags_len(frags);
+	}
+
 	iface = net_context_get_iface(context);
 	if (iface && !net_if_is_up(iface)) {
 		return -ENETDOWN;
 	}
 
-	pkt = context_alloc_pkt(context, len, PKT_WAIT_TIME);
+	if (frags && IS_ENABLED(CONFIG_NET_OFFLOAD) &&
+	    net_if_is_ip_offloaded(iface)) {
+		return -EOPNOTSUPP;
+	}
+
+	/* With external payload fragments only the headers need to be
+	 * allocated from the packet buffer pool.
+	 */
+	pkt = context_alloc_pkt(context, frags ? 0 : len, PKT_WAIT_TIME);
 	if (!pkt) {
 		NET_ERR("Failed to allocate net_pkt");
 		return -ENOBUFS;
@@ -1674,7 +1838,7 @@ static int context_sendto(struct net_context *context,
 
 	tmp_len = net_pkt_available_payload_buffer(
 				pkt, net_context_get_proto(context));
-	if (tmp_len < len) {
+	if (!frags && tmp_len < len) {
 		if (net_context_get_type(context) == SOCK_DGRAM) {
 			NET_ERR("Available payload buffer (%zu) is not enough for requested DGRAM (%zu)",
 				tmp_len, len);
@@ -1728,11 +1892,17 @@ static int context_sendto(struct net_context *context,
 	} else if (IS_ENABLED(CONFIG_NET_UDP) &&
 	    net_context_get_proto(context) == IPPROTO_UDP) {
 		ret = context_setup_udp_packet(context, pkt, buf, len, msghdr,
-					       dst_addr, addrlen);
+					       frags, dst_addr, addrlen);
 		if (ret < 0) {
 			goto fail;
 		}
 
+		if (frags && !context_dgram_fits(context, pkt)) {
+			NET_ERR("Datagram (%zu) does not fit to MTU", len);
+			ret = -ENOMEM;
+			goto fail;
+		}
+
 		context_finalize_packet(context, pkt);
 
 		ret = net_send_data(pkt);
@@ -1845,7 +2015,7 @@ int net_context_send(struct net_context *context,
 	}
 
 	ret = context_sendto(context, buf, len, &context->remote,
-			     addrlen, cb, timeout, user_data, false);
+			     addrlen, cb, timeout, user_data, false, NULL);
 unlock:
 	k_mutex_unlock(&context->lock);
 
@@ -1864,7 +2034,7 @@ int net_context_sendmsg(struct net_context *context,
 	k_mutex_lock(&context->lock, K_FOREVER);
 
 	ret = context_sendto(context, msghdr, 0, NULL, 0,
-			     cb, timeout, user_data, true);
+			     cb, timeout, user_data, true, NULL);
 
 	k_mutex_unlock(&context->lock);
 
@@ -1885,8 +2055,49 @@ int net_context_sendto(struct net_context *context,
 	k_mutex_lock(&context->lock, K_FOREVER);
 
 	ret = context_sendto(context, buf, len, dst_addr, addrlen,
-			     cb, timeout, user_data, true);
+			     cb, timeout, user_data, true, NULL);
+
+	k_mutex_unlock(&context->lock);
+
+	return ret;
+}
+
+int net_context_sendto_buf(struct net_context *context,
+			   struct net_buf *frags,
+			   const struct sockaddr *dst_addr,
+			   socklen_t addrlen,
+			   net_context_send_cb_t cb,
+			   k_timeout_t timeout,
+			   void *user_data)
+{
+	int ret;
+
+	if (!frags) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&context->lock, K_FOREVER);
+
+	if (!dst_addr) {
+		if (!(context->flags & NET_CONTEXT_REMOTE_ADDR_SET) ||
+		    !net_sin(&context->remote)->sin_port) {
+			ret = -EDESTADDRREQ;
+			goto unlock;
+		}
+
+		dst_addr = &context->remote;
 
+		if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		    net_context_get_family(context) == AF_INET6) {
+			addrlen = sizeof(struct sockaddr_in6);
+		} else {
+			addrlen = sizeof(struct sockaddr_in);
+		}
+	}
+
+	ret = context_sendto(context, NULL, 0, dst_addr, addrlen,
+			     cb, timeout, user_data, true, frags);
+unlock:
 	k_mutex_unlock(&context->lock);
 
 	return ret;
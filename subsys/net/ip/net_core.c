@@ -187,8 +187,63 @@ static void net_post_init(void)
 #endif
 }
 
+#if defined(CONFIG_NET_NAPI)
+#if defined(CONFIG_NET_TC_THREAD_COOPERATIVE)
+#define NAPI_THREAD_PRIORITY K_PRIO_COOP(0)
+#else
+#define NAPI_THREAD_PRIORITY K_PRIO_PREEMPT(0)
+#endif
+
+static struct k_work_q napi_work_q;
+static K_KERNEL_STACK_DEFINE(napi_work_q_stack, CONFIG_NET_NAPI_STACK_SIZE);
+
+/* Polls scheduled while the interfaces are initialized are kept here and
+ * submitted once the RX queues are ready.
+ */
+static struct k_spinlock napi_lock;
+static sys_slist_t napi_deferred = SYS_SLIST_STATIC_INIT(&napi_deferred);
+static bool napi_started;
+
+static void napi_init(void)
+{
+	const struct k_work_queue_config cfg = {
+		.name = "net_napi",
+	};
+
+	k_work_queue_start(&napi_work_q, napi_work_q_stack,
+			   K_KERNEL_STACK_SIZEOF(napi_work_q_stack),
+			   NAPI_THREAD_PRIORITY, &cfg);
+}
+
+static void napi_start(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&napi_lock);
+	struct net_napi *napi;
+	sys_snode_t *node;
+
+	napi_started = true;
+
+	while ((node = sys_slist_get(&napi_deferred)) != NULL) {
+		napi = CONTAINER_OF(node, struct net_napi, node);
+		napi->deferred = false;
+
+		(void)k_work_submit_to_queue(&napi_work_q, &napi->work);
+	}
+
+	k_spin_unlock(&napi_lock, key);
+}
+#else
+#define napi_init(...)
+#define napi_start(...)
+#endif /* CONFIG_NET_NAPI */
+
 static void init_rx_queues(void)
 {
+	/* Drivers enable their RX interrupt when their interface is
+	 * initialized, so the NAPI queue must accept polls before that.
+	 */
+	napi_init();
+
 	/* Starting TX side. The ordering is important here and the TX
 	 * can only be started when RX side is ready to receive packets.
 	 */
@@ -196,6 +251,8 @@ static void init_rx_queues(void)
 
 	net_tc_rx_init();
 
+	napi_start();
+
 	/* This will take the interface up and start everything. */
 	net_if_post_init();
 
@@ -379,7 +436,7 @@ void net_process_rx_packet(struct net_pkt *pkt)
 {
 	net_pkt_set_rx_stats_tick(pkt, k_cycle_get_32());
 
-	net_capture_pkt(net_pkt_iface(pkt), pkt);
+	net_capture_pkt_with_dir(net_pkt_iface(pkt), pkt, NET_CAPTURE_DIR_INBOUND);
 
 	net_rx(net_pkt_iface(pkt), pkt);
 }
@@ -406,8 +463,7 @@ static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
 	}
 }
 
-/* Called by driver when a packet has been received */
-int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
+static int net_recv_prepare(struct net_if *iface, struct net_pkt *pkt)
 {
 	if (!pkt || !iface) {
 		return -EINVAL;
@@ -433,6 +489,19 @@ int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
 
 	net_pkt_set_iface(pkt, iface);
 
+	return 0;
+}
+
+/* Called by driver when a packet has been received */
+int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
+{
+	int ret;
+
+	ret = net_recv_prepare(iface, pkt);
+	if (ret < 0) {
+		return ret;
+	}
+
 	if (!net_pkt_filter_recv_ok(pkt)) {
 		/* silently drop the packet */
 		net_pkt_unref(pkt);
@@ -443,6 +512,111 @@ int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
 	return 0;
 }
 
+#if defined(CONFIG_NET_NAPI)
+static void napi_flush(struct net_napi *napi)
+{
+	for (int tc = 0; tc < ARRAY_SIZE(napi->batch); tc++) {
+		if (sys_slist_is_empty(&napi->batch[tc])) {
+			continue;
+		}
+
+		net_tc_submit_list_to_rx_queue(tc, &napi->batch[tc]);
+	}
+}
+
+static void napi_poll(struct k_work *work)
+{
+	struct net_napi *napi = CONTAINER_OF(work, struct net_napi, work);
+	int done;
+
+	done = napi->poll(napi, napi->budget);
+
+	napi_flush(napi);
+
+	if (done >= napi->budget) {
+		/* The driver might have more packets pending and keeps its RX
+		 * interrupt disabled. Let other devices poll first.
+		 */
+		k_work_submit_to_queue(&napi_work_q, &napi->work);
+	}
+}
+
+void net_napi_init(struct net_napi *napi, net_napi_poll_cb_t poll, int budget)
+{
+	k_work_init(&napi->work, napi_poll);
+
+	for (int tc = 0; tc < ARRAY_SIZE(napi->batch); tc++) {
+		sys_slist_init(&napi->batch[tc]);
+	}
+
+	napi->poll = poll;
+	napi->budget = budget > 0 ? budget : CONFIG_NET_NAPI_BUDGET;
+	napi->deferred = false;
+}
+
+void net_napi_schedule(struct net_napi *napi)
+{
+	k_spinlock_key_t key;
+
+	if (likely(napi_started)) {
+		k_work_submit_to_queue(&napi_work_q, &napi->work);
+		return;
+	}
+
+	key = k_spin_lock(&napi_lock);
+
+	if (napi_started) {
+		k_spin_unlock(&napi_lock, key);
+		k_work_submit_to_queue(&napi_work_q, &napi->work);
+		return;
+	}
+
+	if (!napi->deferred) {
+		napi->deferred = true;
+		sys_slist_append(&napi_deferred, &napi->node);
+	}
+
+	k_spin_unlock(&napi_lock, key);
+}
+
+int net_napi_recv(struct net_napi *napi, struct net_if *iface,
+		  struct net_pkt *pkt)
+{
+	uint8_t prio;
+	uint8_t tc;
+	int ret;
+
+	ret = net_recv_prepare(iface, pkt);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (!net_pkt_filter_recv_ok(pkt)) {
+		/* silently drop the packet */
+		net_pkt_unref(pkt);
+		return 0;
+	}
+
+	if (NET_TC_RX_COUNT == 0) {
+		net_queue_rx(iface, pkt);
+		return 0;
+	}
+
+	prio = net_pkt_priority(pkt);
+	tc = net_rx_priority2tc(prio);
+
+#if defined(CONFIG_NET_STATISTICS)
+	net_stats_update_tc_recv_pkt(iface, tc);
+	net_stats_update_tc_recv_bytes(iface, tc, net_pkt_get_len(pkt));
+	net_stats_update_tc_recv_priority(iface, tc, prio);
+#endif
+
+	sys_slist_append(&napi->batch[tc], (sys_snode_t *)pkt);
+
+	return 0;
+}
+#endif /* CONFIG_NET_NAPI */
+
 static inline void l3_init(void)
 {
 	net_icmpv4_init();
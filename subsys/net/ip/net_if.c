@@ -26,6 +26,7 @@ LOG_MODULE_REGISTER(net_if, CONFIG_NET_IF_LOG_LEVEL);
 #include "ipv4.h"
 #include "ipv6.h"
 #include "ipv4_autoconf_internal.h"
+#include "route.h"
 
 #include "net_stats.h"
 
@@ -3113,6 +3114,15 @@ struct net_if *net_if_ipv4_select_src_iface(const struct in_addr *dst)
 		}
 	}
 
+	if (IS_ENABLED(CONFIG_NET_ROUTE_IPV4)) {
+		struct net_route_entry_ipv4 *route;
+
+		route = net_route_ipv4_lookup(NULL, dst);
+		if (route) {
+			selected = route->iface;
+		}
+	}
+
 	if (selected == NULL) {
 		selected = net_if_get_default();
 	}
@@ -4391,6 +4401,59 @@ bool net_if_is_promisc(struct net_if *iface)
 	return net_if_flag_is_set(iface, NET_IF_PROMISC);
 }
 
+#if defined(CONFIG_NET_PKT_POOL_BINDING)
+int net_if_pkt_pool_bind(struct net_if *iface, enum net_if_pkt_pool_dir dir,
+			 int tc, struct net_pkt_pool *pool)
+{
+	struct net_pkt_pool **pools;
+	int count, i;
+
+	NET_ASSERT(iface);
+
+	if (dir == NET_IF_PKT_POOL_RX) {
+		pools = iface->rx_pools;
+		count = NET_IF_PKT_POOL_RX_TC_COUNT;
+	} else {
+		pools = iface->tx_pools;
+		count = NET_IF_PKT_POOL_TX_TC_COUNT;
+	}
+
+	if (tc != NET_IF_PKT_POOL_ALL_TC && (tc < 0 || tc >= count)) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	for (i = 0; i < count; i++) {
+		if (tc == NET_IF_PKT_POOL_ALL_TC || tc == i) {
+			pools[i] = pool;
+		}
+	}
+
+	k_mutex_unlock(&lock);
+
+	NET_DBG("iface %d (%p) %s pool %p bound to tc %d",
+		net_if_get_by_iface(iface), iface,
+		dir == NET_IF_PKT_POOL_RX ? "RX" : "TX", pool, tc);
+
+	return 0;
+}
+
+struct net_pkt_pool *net_if_pkt_pool_get(struct net_if *iface,
+					 enum net_if_pkt_pool_dir dir,
+					 uint8_t priority)
+{
+	/* Called from the allocation path, which can be an interrupt
+	 * handler, so the pointer is read without locking.
+	 */
+	if (dir == NET_IF_PKT_POOL_RX) {
+		return iface->rx_pools[net_rx_priority2tc(priority)];
+	}
+
+	return iface->tx_pools[net_tx_priority2tc(priority)];
+}
+#endif /* CONFIG_NET_PKT_POOL_BINDING */
+
 #ifdef CONFIG_NET_POWER_MANAGEMENT
 
 int net_if_suspend(struct net_if *iface)
@@ -25,6 +25,8 @@ LOG_MODULE_REGISTER(net_pkt, CONFIG_NET_PKT_LOG_LEVEL);
 
 #include <zephyr/kernel.h>
 #include <zephyr/toolchain.h>
+#include <zephyr/cache.h>
+#include <zephyr/sys/mem_manage.h>
 #include <string.h>
 #include <zephyr/types.h>
 #include <sys/types.h>
@@ -39,6 +41,7 @@ LOG_MODULE_REGISTER(net_pkt, CONFIG_NET_PKT_LOG_LEVEL);
 #include <zephyr/net/udp.h>
 
 #include "net_private.h"
+#include "net_stats.h"
 #include "tcp_internal.h"
 
 /* Find max header size of IP protocol (IPv4 or IPv6) */
@@ -437,6 +440,19 @@ struct net_buf *net_pkt_get_frag(struct net_pkt *pkt, size_t min_len,
 	}
 #endif /* CONFIG_NET_CONTEXT_NET_PKT_POOL */
 
+#if defined(CONFIG_NET_PKT_POOL_BINDING)
+	if (pkt->pool) {
+#if NET_LOG_LEVEL >= LOG_LEVEL_DBG
+		return net_pkt_get_reserve_data_debug(pkt->pool->data_pool,
+						      min_len, timeout,
+						      caller, line);
+#else
+		return net_pkt_get_reserve_data(pkt->pool->data_pool, min_len,
+						timeout);
+#endif /* NET_LOG_LEVEL >= LOG_LEVEL_DBG */
+	}
+#endif /* CONFIG_NET_PKT_POOL_BINDING */
+
 	if (pkt->slab == &rx_pkts) {
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
 		return net_pkt_get_reserve_rx_data_debug(min_len, timeout,
@@ -504,6 +520,36 @@ static inline struct net_buf_pool *get_data_pool(struct net_context *context)
 #define get_data_pool(...) NULL
 #endif /* CONFIG_NET_CONTEXT_NET_PKT_POOL */
 
+#if defined(CONFIG_NET_PKT_POOL_BINDING)
+static void pkt_pool_allocated(struct net_pkt_pool *pool, struct net_if *iface)
+{
+	net_stats_update_pkt_pool_alloc(iface);
+
+	if (k_mem_slab_num_free_get(pool->slab) <= pool->low_watermark &&
+	    atomic_cas(&pool->congested, 0, 1)) {
+		NET_DBG("Pool %p congested", pool);
+
+		net_stats_update_pkt_pool_congested(iface);
+
+		if (pool->cb) {
+			pool->cb(pool, true);
+		}
+	}
+}
+
+static void pkt_pool_freed(struct net_pkt_pool *pool)
+{
+	if (k_mem_slab_num_free_get(pool->slab) >= pool->high_watermark &&
+	    atomic_cas(&pool->congested, 1, 0)) {
+		NET_DBG("Pool %p no longer congested", pool);
+
+		if (pool->cb) {
+			pool->cb(pool, false);
+		}
+	}
+}
+#endif /* CONFIG_NET_PKT_POOL_BINDING */
+
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
 void net_pkt_unref_debug(struct net_pkt *pkt, const char *caller, int line)
 {
@@ -602,6 +648,16 @@ done:
 		net_pkt_cursor_init(pkt);
 	}
 
+#if defined(CONFIG_NET_PKT_POOL_BINDING)
+	if (pkt->pool) {
+		struct net_pkt_pool *pool = pkt->pool;
+
+		k_mem_slab_free(pkt->slab, (void **)&pkt);
+		pkt_pool_freed(pool);
+		return;
+	}
+#endif
+
 	k_mem_slab_free(pkt->slab, (void **)&pkt);
 }
 
@@ -821,6 +877,47 @@ void net_pkt_compact(struct net_pkt *pkt)
 	}
 }
 
+uintptr_t net_pkt_dma_map_data(void *data, size_t len)
+{
+	/* Fails harmlessly if there is no data cache to maintain */
+	(void)sys_cache_data_flush_range(data, len);
+
+#if defined(CONFIG_MMU)
+	return z_mem_phys_addr(data);
+#else
+	return POINTER_TO_UINT(data);
+#endif
+}
+
+uintptr_t net_pkt_frag_dma_map(struct net_buf *frag)
+{
+	return net_pkt_dma_map_data(frag->data, frag->len);
+}
+
+int net_pkt_dma_map(struct net_pkt *pkt, struct net_pkt_dma_seg *segs,
+		    size_t max_segs)
+{
+	struct net_buf *frag;
+	int count = 0;
+
+	for (frag = pkt->frags; frag; frag = frag->frags) {
+		if (!frag->len) {
+			continue;
+		}
+
+		if (count == max_segs) {
+			return -E2BIG;
+		}
+
+		segs[count].addr = net_pkt_frag_dma_map(frag);
+		segs[count].len = frag->len;
+		segs[count].frag = frag;
+		count++;
+	}
+
+	return count ? count : -ENODATA;
+}
+
 void net_pkt_get_info(struct k_mem_slab **rx,
 		      struct k_mem_slab **tx,
 		      struct net_buf_pool **rx_data,
@@ -1182,6 +1279,12 @@ int net_pkt_alloc_buffer(struct net_pkt *pkt,
 		pool = get_data_pool(pkt->context);
 	}
 
+#if defined(CONFIG_NET_PKT_POOL_BINDING)
+	if (!pool && pkt->pool) {
+		pool = pkt->pool->data_pool;
+	}
+#endif
+
 	if (!pool) {
 		pool = pkt->slab == &tx_pkts ? &tx_bufs : &rx_bufs;
 	}
@@ -1336,6 +1439,96 @@ struct net_pkt *net_pkt_rx_alloc(k_timeout_t timeout)
 #endif
 }
 
+#if defined(CONFIG_NET_PKT_POOL_BINDING)
+/* An empty dedicated pool borrows from the shared slab, unless that would
+ * eat into the shared reserve. Otherwise the caller waits for the dedicated
+ * pool, which throttles the interface that is using it up. Without a shared
+ * slab, the packet always comes from the dedicated pool.
+ */
+static struct k_mem_slab *pkt_pool_select_slab(struct net_pkt_pool **pool,
+					       struct k_mem_slab *shared,
+					       struct net_if *iface)
+{
+	if (k_mem_slab_num_free_get((*pool)->slab) > 0 || !(*pool)->fallback ||
+	    shared == NULL || k_mem_slab_num_free_get(shared) <=
+					CONFIG_NET_PKT_POOL_SHARED_RESERVE) {
+		return (*pool)->slab;
+	}
+
+	net_stats_update_pkt_pool_fallback(iface);
+	*pool = NULL;
+
+	return shared;
+}
+
+#if NET_LOG_LEVEL >= LOG_LEVEL_DBG
+static struct net_pkt *pkt_alloc_from_pool(struct net_pkt_pool *pool,
+					   struct k_mem_slab *shared,
+					   struct net_if *iface,
+					   k_timeout_t timeout,
+					   const char *caller, int line)
+#else
+static struct net_pkt *pkt_alloc_from_pool(struct net_pkt_pool *pool,
+					   struct k_mem_slab *shared,
+					   struct net_if *iface,
+					   k_timeout_t timeout)
+#endif
+{
+	struct k_mem_slab *slab;
+	struct net_pkt *pkt;
+
+	slab = pkt_pool_select_slab(&pool, shared, iface);
+
+#if NET_LOG_LEVEL >= LOG_LEVEL_DBG
+	pkt = pkt_alloc(slab, timeout, caller, line);
+#else
+	pkt = pkt_alloc(slab, timeout);
+#endif
+
+	if (!pkt) {
+		net_stats_update_pkt_pool_alloc_failed(iface);
+		return NULL;
+	}
+
+	net_pkt_set_iface(pkt, iface);
+
+	if (shared != NULL && slab != shared) {
+		net_pkt_set_priority(pkt, shared == &tx_pkts ?
+				     TX_DEFAULT_PRIORITY : RX_DEFAULT_PRIORITY);
+	}
+
+	if (pool) {
+		pkt->pool = pool;
+		pkt_pool_allocated(pool, iface);
+	}
+
+	return pkt;
+}
+
+#if NET_LOG_LEVEL >= LOG_LEVEL_DBG
+struct net_pkt *net_pkt_alloc_from_pool_debug(struct net_pkt_pool *pool,
+					      struct net_if *iface,
+					      k_timeout_t timeout,
+					      const char *caller, int line)
+#else
+struct net_pkt *net_pkt_alloc_from_pool(struct net_pkt_pool *pool,
+					struct net_if *iface,
+					k_timeout_t timeout)
+#endif
+{
+	if (!pool || !iface) {
+		return NULL;
+	}
+
+#if NET_LOG_LEVEL >= LOG_LEVEL_DBG
+	return pkt_alloc_from_pool(pool, &tx_pkts, iface, timeout,
+				   caller, line);
+#else
+	return pkt_alloc_from_pool(pool, &tx_pkts, iface, timeout);
+#endif
+}
+#endif /* CONFIG_NET_PKT_POOL_BINDING */
+
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
 static struct net_pkt *pkt_alloc_on_iface(struct k_mem_slab *slab,
 					  struct net_if *iface,
@@ -1350,6 +1543,29 @@ static struct net_pkt *pkt_alloc_on_iface(struct k_mem_slab *slab,
 {
 	struct net_pkt *pkt;
 
+#if defined(CONFIG_NET_PKT_POOL_BINDING)
+	if (iface && (slab == &tx_pkts || slab == &rx_pkts)) {
+		struct net_pkt_pool *pool;
+
+		if (slab == &tx_pkts) {
+			pool = net_if_pkt_pool_get(iface, NET_IF_PKT_POOL_TX,
+						   TX_DEFAULT_PRIORITY);
+		} else {
+			pool = net_if_pkt_pool_get(iface, NET_IF_PKT_POOL_RX,
+						   RX_DEFAULT_PRIORITY);
+		}
+
+		if (pool) {
+#if NET_LOG_LEVEL >= LOG_LEVEL_DBG
+			return pkt_alloc_from_pool(pool, slab, iface, timeout,
+						   caller, line);
+#else
+			return pkt_alloc_from_pool(pool, slab, iface, timeout);
+#endif
+		}
+	}
+#endif /* CONFIG_NET_PKT_POOL_BINDING */
+
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
 	pkt = pkt_alloc(slab, timeout, caller, line);
 #else
@@ -1720,6 +1936,69 @@ int net_pkt_write(struct net_pkt *pkt, const void *data, size_t length)
 	return net_pkt_cursor_operate(pkt, (void *)data, length, true, true);
 }
 
+int net_pkt_write_chksum(struct net_pkt *pkt, const void *data, size_t length,
+			 uint16_t *sum)
+{
+	struct net_pkt_cursor *c_op = &pkt->cursor;
+	bool overwrite = net_pkt_is_being_overwritten(pkt);
+	bool odd = false;
+
+	NET_DBG("pkt %p data %p length %zu", pkt, data, length);
+
+	while (c_op->buf && length) {
+		size_t d_len, len;
+		uint16_t part;
+		uint32_t tmp;
+
+		pkt_cursor_advance(pkt, !overwrite);
+		if (c_op->buf == NULL) {
+			break;
+		}
+
+		if (!overwrite) {
+			d_len = net_buf_max_len(c_op->buf) -
+				(c_op->pos - c_op->buf->data);
+		} else {
+			d_len = c_op->buf->len - (c_op->pos - c_op->buf->data);
+		}
+
+		if (!d_len) {
+			break;
+		}
+
+		len = MIN(length, d_len);
+
+		part = calc_chksum_copy(0, c_op->pos, data, len);
+
+		/* A part starting at an odd offset has its bytes in the
+		 * other half of the 16-bit words.
+		 */
+		if (odd) {
+			part = __bswap_16(part);
+		}
+
+		tmp = (uint32_t)*sum + part;
+		*sum = (uint16_t)((tmp & 0xffff) + (tmp >> 16));
+		odd ^= (len & 1);
+
+		if (!overwrite) {
+			net_buf_add(c_op->buf, len);
+		}
+
+		pkt_cursor_update(pkt, len, true);
+
+		data = (const uint8_t *)data + len;
+		length -= len;
+	}
+
+	if (length) {
+		NET_DBG("Still some length to go %zu", length);
+		return -ENOBUFS;
+	}
+
+	return 0;
+}
+
 int net_pkt_copy(struct net_pkt *pkt_dst,
 		 struct net_pkt *pkt_src,
 		 size_t length)
@@ -1838,6 +2117,7 @@ static void clone_pkt_attributes(struct net_pkt *pkt, struct net_pkt *clone_pkt)
 	net_pkt_set_vlan_tag(clone_pkt, net_pkt_vlan_tag(pkt));
 	net_pkt_set_timestamp(clone_pkt, net_pkt_timestamp(pkt));
 	net_pkt_set_priority(clone_pkt, net_pkt_priority(pkt));
+	net_pkt_set_flow_hash(clone_pkt, net_pkt_flow_hash(pkt));
 	net_pkt_set_orig_iface(clone_pkt, net_pkt_orig_iface(pkt));
 	net_pkt_set_captured(clone_pkt, net_pkt_is_captured(pkt));
 
@@ -1883,6 +2163,56 @@ static void clone_pkt_attributes(struct net_pkt *pkt, struct net_pkt *clone_pkt)
 	clone_pkt_cb(pkt, clone_pkt);
 }
 
+#if defined(CONFIG_NET_PKT_POOL_BINDING)
+/* A clone of a packet from a dedicated pool is taken from the same pool, so
+ * that it uses the pool data buffers and is accounted when freed.
+ */
+static struct net_pkt *pkt_clone_alloc_from_pool(struct net_pkt *pkt,
+						 k_timeout_t timeout)
+{
+	uint64_t end = sys_clock_timeout_end_calc(timeout);
+	struct net_pkt *clone_pkt;
+	int ret;
+
+#if NET_LOG_LEVEL >= LOG_LEVEL_DBG
+	clone_pkt = pkt_alloc_from_pool(pkt->pool, NULL, net_pkt_iface(pkt),
+					timeout, __func__, __LINE__);
+#else
+	clone_pkt = pkt_alloc_from_pool(pkt->pool, NULL, net_pkt_iface(pkt),
+					timeout);
+#endif
+	if (!clone_pkt) {
+		return NULL;
+	}
+
+	if (!K_TIMEOUT_EQ(timeout, K_NO_WAIT) &&
+	    !K_TIMEOUT_EQ(timeout, K_FOREVER)) {
+		int64_t remaining = end - sys_clock_tick_get();
+
+		if (remaining <= 0) {
+			timeout = K_NO_WAIT;
+		} else {
+			timeout = Z_TIMEOUT_TICKS(remaining);
+		}
+	}
+
+#if NET_LOG_LEVEL >= LOG_LEVEL_DBG
+	ret = net_pkt_alloc_buffer_debug(clone_pkt, net_pkt_get_len(pkt), 0,
+					 timeout, __func__, __LINE__);
+#else
+	ret = net_pkt_alloc_buffer(clone_pkt, net_pkt_get_len(pkt), 0,
+				   timeout);
+#endif
+
+	if (ret) {
+		net_pkt_unref(clone_pkt);
+		return NULL;
+	}
+
+	return clone_pkt;
+}
+#endif /* CONFIG_NET_PKT_POOL_BINDING */
+
 static struct net_pkt *net_pkt_clone_internal(struct net_pkt *pkt,
 					      struct k_mem_slab *slab,
 					      k_timeout_t timeout)
@@ -1892,16 +2222,24 @@ static struct net_pkt *net_pkt_clone_internal(struct net_pkt *pkt,
 	struct net_pkt_cursor backup;
 	struct net_pkt *clone_pkt;
 
+#if defined(CONFIG_NET_PKT_POOL_BINDING)
+	if (pkt->pool && slab == pkt->slab) {
+		clone_pkt = pkt_clone_alloc_from_pool(pkt, timeout);
+	} else
+#endif
+	{
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
-	clone_pkt = pkt_alloc_with_buffer(slab, net_pkt_iface(pkt),
-					  net_pkt_get_len(pkt),
-					  AF_UNSPEC, 0, timeout,
-					  __func__, __LINE__);
+		clone_pkt = pkt_alloc_with_buffer(slab, net_pkt_iface(pkt),
+						  net_pkt_get_len(pkt),
+						  AF_UNSPEC, 0, timeout,
+						  __func__, __LINE__);
 #else
-	clone_pkt = pkt_alloc_with_buffer(slab, net_pkt_iface(pkt),
-					  net_pkt_get_len(pkt),
-					  AF_UNSPEC, 0, timeout);
+		clone_pkt = pkt_alloc_with_buffer(slab, net_pkt_iface(pkt),
+						  net_pkt_get_len(pkt),
+						  AF_UNSPEC, 0, timeout);
 #endif
+	}
+
 	if (!clone_pkt) {
 		return NULL;
 	}
@@ -90,6 +90,7 @@ static inline enum net_verdict net_ipv6_input(struct net_pkt *pkt,
 #endif
 extern bool net_tc_submit_to_tx_queue(uint8_t tc, struct net_pkt *pkt);
 extern void net_tc_submit_to_rx_queue(uint8_t tc, struct net_pkt *pkt);
+extern void net_tc_submit_list_to_rx_queue(uint8_t tc, sys_slist_t *list);
 extern enum net_verdict net_promisc_mode_input(struct net_pkt *pkt);
 
 char *net_sprint_addr(sa_family_t af, const void *addr);
@@ -148,7 +149,11 @@ extern char *net_byte_to_hex(char *ptr, uint8_t byte, char base, bool pad);
 extern char *net_sprint_ll_addr_buf(const uint8_t *ll, uint8_t ll_len,
 				    char *buf, int buflen);
 extern uint16_t calc_chksum(uint16_t sum_in, const uint8_t *data, size_t len);
+extern uint16_t calc_chksum_copy(uint16_t sum, uint8_t *dst,
+				 const uint8_t *src, size_t len);
 extern uint16_t net_calc_chksum(struct net_pkt *pkt, uint8_t proto);
+extern uint16_t net_calc_chksum_hdr(struct net_pkt *pkt, uint8_t proto,
+				    size_t hdr_len);
 
 /**
  * @brief Deliver the incoming packet through the recv_cb of the net_context
@@ -775,6 +775,44 @@ static void iface_per_route_cb(struct net_if *iface, void *user_data)
 }
 #endif /* CONFIG_NET_ROUTE */
 
+#if defined(CONFIG_NET_ROUTE_IPV4) && defined(CONFIG_NET_NATIVE)
+static void route_ipv4_cb(struct net_route_entry_ipv4 *entry, void *user_data)
+{
+	struct net_shell_user_data *data = user_data;
+	const struct shell *sh = data->sh;
+	struct net_if *iface = data->user_data;
+
+	if (entry->iface != iface) {
+		return;
+	}
+
+	PR("IPv4 prefix : %s/%d\t", net_sprint_ipv4_addr(&entry->addr),
+	   entry->prefix_len);
+
+	if (net_ipv4_is_addr_unspecified(&entry->gw)) {
+		PR("gateway : <on-link>\n");
+	} else {
+		PR("gateway : %s\n", net_sprint_ipv4_addr(&entry->gw));
+	}
+}
+
+static void iface_per_route_ipv4_cb(struct net_if *iface, void *user_data)
+{
+	struct net_shell_user_data *data = user_data;
+	const struct shell *sh = data->sh;
+	const char *extra;
+
+	PR("\nIPv4 routes for interface %d (%p) (%s)\n",
+	   net_if_get_by_iface(iface), iface,
+	   iface2str(iface, &extra));
+	PR("=========================================%s\n", extra);
+
+	data->user_data = iface;
+
+	net_route_ipv4_foreach(route_ipv4_cb, data);
+}
+#endif /* CONFIG_NET_ROUTE_IPV4 */
+
 #if defined(CONFIG_NET_ROUTE_MCAST) && defined(CONFIG_NET_NATIVE)
 static void route_mcast_cb(struct net_route_entry_mcast *entry,
 			   void *user_data)
@@ -1194,6 +1232,22 @@ static void print_net_pm_stats(const struct shell *sh, struct net_if *iface)
 #endif
 }
 
+static void print_net_pkt_pool_stats(const struct shell *sh,
+				     struct net_if *iface)
+{
+#if defined(CONFIG_NET_STATISTICS_PKT_POOL)
+	PR("Dedicated pkt pool alloc %u\tborrowed\t%u\tfailed\t%u\n",
+	   GET_STAT(iface, pkt_pool.alloc),
+	   GET_STAT(iface, pkt_pool.fallback),
+	   GET_STAT(iface, pkt_pool.alloc_failed));
+	PR("Dedicated pkt pool congested %u times\n",
+	   GET_STAT(iface, pkt_pool.congested));
+#else
+	ARG_UNUSED(sh);
+	ARG_UNUSED(iface);
+#endif
+}
+
 static void net_shell_print_statistics(struct net_if *iface, void *user_data)
 {
 	struct net_shell_user_data *data = user_data;
@@ -1290,6 +1344,7 @@ static void net_shell_print_statistics(struct net_if *iface, void *user_data)
 	PR("TCP conn drop  %d\tconnrst\t%d\n",
 	   GET_STAT(iface, tcp.conndrop),
 	   GET_STAT(iface, tcp.connrst));
+	PR("TCP seg coalesced %d\n", GET_STAT(iface, tcp.coalesced));
 	PR("TCP pkt drop   %d\n", GET_STAT(iface, tcp.drop));
 #endif
 
@@ -1329,6 +1384,7 @@ static void net_shell_print_statistics(struct net_if *iface, void *user_data)
 #endif /* CONFIG_NET_STATISTICS_PPP && CONFIG_NET_STATISTICS_USER_API */
 
 	print_net_pm_stats(sh, iface);
+	print_net_pkt_pool_stats(sh, iface);
 }
 #endif /* CONFIG_NET_STATISTICS */
 
@@ -2007,6 +2063,124 @@ static int cmd_net_capture_disable(const struct shell *sh, size_t argc,
 	return 0;
 }
 
+static int cmd_net_capture_local(const struct shell *sh, size_t argc,
+				 char *argv[])
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+	struct net_capture_local_stats stats;
+	size_t snaplen;
+	bool active;
+
+	active = net_capture_local_get_stats(&stats, &snaplen);
+
+	PR("Local capture %s, snaplen %zu\n", active ? "running" : "stopped",
+	   snaplen);
+	PR("Captured %u dropped %u saved %u packets\n", stats.captured,
+	   stats.dropped, stats.drained);
+#else
+	PR_INFO("Set %s to enable %s support.\n",
+		"CONFIG_NET_CAPTURE_LOCAL", "local network packet capture");
+#endif
+
+	return 0;
+}
+
+static int cmd_net_capture_local_start(const struct shell *sh, size_t argc,
+				       char *argv[])
+{
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+	struct net_if *iface = NULL;
+	int ret, if_index = 0;
+	size_t snaplen = 0;
+
+	if (argc > 1) {
+		if_index = atoi(argv[1]);
+	}
+
+	if (if_index > 0) {
+		iface = net_if_get_by_index(if_index);
+		if (iface == NULL) {
+			PR_WARNING("No such interface with index %d\n", if_index);
+			return -ENOEXEC;
+		}
+	}
+
+	if (argc > 2) {
+		snaplen = atoi(argv[2]);
+	}
+
+	ret = net_capture_local_start(iface, snaplen);
+	if (ret < 0) {
+		PR_WARNING("Capture %s failed (%d)\n", "start", ret);
+		return -ENOEXEC;
+	}
+#else
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	PR_INFO("Set %s to enable %s support.\n",
+		"CONFIG_NET_CAPTURE_LOCAL", "local network packet capture");
+#endif
+
+	return 0;
+}
+
+static int cmd_net_capture_local_stop(const struct shell *sh, size_t argc,
+				      char *argv[])
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+	int ret;
+
+	ret = net_capture_local_stop();
+	if (ret < 0) {
+		PR_WARNING("Capture %s failed (%d)\n", "stop", ret);
+		return -ENOEXEC;
+	}
+#else
+	PR_INFO("Set %s to enable %s support.\n",
+		"CONFIG_NET_CAPTURE_LOCAL", "local network packet capture");
+#endif
+
+	return 0;
+}
+
+static int cmd_net_capture_local_save(const struct shell *sh, size_t argc,
+				      char *argv[])
+{
+	ARG_UNUSED(argc);
+
+#if defined(CONFIG_NET_CAPTURE_LOCAL) && defined(CONFIG_FILE_SYSTEM)
+	int ret;
+
+	if (argv[1] == NULL) {
+		PR_WARNING("File path is missing.\n");
+		return -ENOEXEC;
+	}
+
+	ret = net_capture_local_save(argv[1]);
+	if (ret < 0) {
+		PR_WARNING("Capture %s failed (%d)\n", "save", ret);
+		return -ENOEXEC;
+	}
+
+	PR("%d packets saved to %s\n", ret, argv[1]);
+#else
+	ARG_UNUSED(argv);
+
+	PR_INFO("Set %s and %s to enable %s support.\n",
+		"CONFIG_NET_CAPTURE_LOCAL", "CONFIG_FILE_SYSTEM",
+		"saving captured packets");
+#endif
+
+	return 0;
+}
+
 static int cmd_net_conn(const struct shell *sh, size_t argc, char *argv[])
 {
 	ARG_UNUSED(argc);
@@ -2286,6 +2460,70 @@ static int cmd_net_dns_query(const struct shell *sh, size_t argc,
 	return 0;
 }
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+static void dns_cache_cb(const char *name, enum dns_query_type type,
+			 int addr_count, uint32_t ttl, void *user_data)
+{
+	const struct shell *sh = user_data;
+
+	if (addr_count == 0) {
+		PR("\t%-4s %s no such name, ttl %u\n",
+		   type == DNS_QUERY_TYPE_AAAA ? "AAAA" : "A", name, ttl);
+	} else {
+		PR("\t%-4s %s %d address%s, ttl %u\n",
+		   type == DNS_QUERY_TYPE_AAAA ? "AAAA" : "A", name,
+		   addr_count, addr_count > 1 ? "es" : "", ttl);
+	}
+}
+#endif
+
+static int cmd_net_dns_cache(const struct shell *sh, size_t argc,
+			     char *argv[])
+{
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	struct dns_resolve_cache_stats stats;
+#endif
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	(void)dns_resolve_cache_get_stats(&stats);
+
+	PR("Hits %u (negative %u), misses %u, insertions %u, "
+	   "evictions %u\n", stats.hits, stats.negative_hits, stats.misses,
+	   stats.insertions, stats.evictions);
+	PR("Cached answers:\n");
+
+	if (dns_resolve_cache_foreach(dns_cache_cb, (void *)sh) == 0) {
+		PR("\tNone\n");
+	}
+#else
+	PR_INFO("Set %s to enable %s support.\n", "CONFIG_DNS_RESOLVER_CACHE",
+		"DNS answer cache");
+#endif
+
+	return 0;
+}
+
+static int cmd_net_dns_flush(const struct shell *sh, size_t argc,
+			     char *argv[])
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	(void)dns_resolve_cache_flush();
+
+	PR("DNS answer cache flushed.\n");
+#else
+	PR_INFO("Set %s to enable %s support.\n", "CONFIG_DNS_RESOLVER_CACHE",
+		"DNS answer cache");
+#endif
+
+	return 0;
+}
+
 static int cmd_net_dns(const struct shell *sh, size_t argc, char *argv[])
 {
 #if defined(CONFIG_DNS_RESOLVER)
@@ -2511,6 +2749,18 @@ static char *get_l3_desc(struct event_msg *msg,
 		info = net_addr_ntop(AF_INET, msg->data, extra_info,
 				     extra_info_len);
 		break;
+	case NET_EVENT_IPV4_ROUTE_ADD:
+		*desc = "IPv4 route";
+		*desc2 = "add";
+		info = net_addr_ntop(AF_INET, msg->data, extra_info,
+				     extra_info_len);
+		break;
+	case NET_EVENT_IPV4_ROUTE_DEL:
+		*desc = "IPv4 route";
+		*desc2 = "del";
+		info = net_addr_ntop(AF_INET, msg->data, extra_info,
+				     extra_info_len);
+		break;
 	case NET_EVENT_IPV4_DHCP_START:
 		*desc = "DHCPv4";
 		*desc2 = "start";
@@ -3715,6 +3965,139 @@ static int cmd_net_ip6_route_del(const struct shell *sh, size_t argc, char *argv
 	return 0;
 }
 
+#if defined(CONFIG_NET_NATIVE_IPV4) && defined(CONFIG_NET_ROUTE_IPV4)
+static int parse_ipv4_prefix(const struct shell *sh, char *str,
+			     struct in_addr *addr, uint8_t *prefix_len)
+{
+	char *len_str = strchr(str, '/');
+	char *endptr;
+	long len = 32;
+
+	if (len_str) {
+		*len_str++ = '\0';
+
+		len = strtol(len_str, &endptr, 10);
+		if (*endptr != '\0' || len < 0 || len > 32) {
+			PR_ERROR("Invalid prefix length: %s\n", len_str);
+			return -EINVAL;
+		}
+	}
+
+	if (net_addr_pton(AF_INET, str, addr)) {
+		PR_ERROR("Invalid address: %s\n", str);
+		return -EINVAL;
+	}
+
+	*prefix_len = len;
+
+	return 0;
+}
+
+static int cmd_net_ip4_route_add(const struct shell *sh, size_t argc, char *argv[])
+{
+	struct net_route_entry_ipv4 *route;
+	struct in_addr gw = { 0 };
+	struct in_addr prefix;
+	struct net_if *iface;
+	uint8_t prefix_len;
+	int idx;
+
+	if (argc != 3 && argc != 4) {
+		PR_ERROR("Correct usage: net route add <index> "
+			 "<destination>[/<len>] [<gateway>]\n");
+		return -EINVAL;
+	}
+
+	idx = get_iface_idx(sh, argv[1]);
+	if (idx < 0) {
+		return -ENOEXEC;
+	}
+
+	iface = net_if_get_by_index(idx);
+	if (!iface) {
+		PR_WARNING("No such interface in index %d\n", idx);
+		return -ENOEXEC;
+	}
+
+	if (parse_ipv4_prefix(sh, argv[2], &prefix, &prefix_len) < 0) {
+		return -EINVAL;
+	}
+
+	if (argc == 4 && net_addr_pton(AF_INET, argv[3], &gw)) {
+		PR_ERROR("Invalid gateway: %s\n", argv[3]);
+		return -EINVAL;
+	}
+
+	route = net_route_ipv4_add(iface, &prefix, prefix_len, &gw);
+	if (route == NULL) {
+		PR_ERROR("Failed to add route\n");
+		return -ENOEXEC;
+	}
+
+	return 0;
+}
+
+static int cmd_net_ip4_route_del(const struct shell *sh, size_t argc, char *argv[])
+{
+	struct net_route_entry_ipv4 *route;
+	struct in_addr prefix;
+	struct net_if *iface;
+	uint8_t prefix_len;
+	int idx;
+
+	if (argc != 3) {
+		PR_ERROR("Correct usage: net route del <index> "
+			 "<destination>[/<len>]\n");
+		return -EINVAL;
+	}
+
+	idx = get_iface_idx(sh, argv[1]);
+	if (idx < 0) {
+		return -ENOEXEC;
+	}
+
+	iface = net_if_get_by_index(idx);
+	if (!iface) {
+		PR_WARNING("No such interface in index %d\n", idx);
+		return -ENOEXEC;
+	}
+
+	if (parse_ipv4_prefix(sh, argv[2], &prefix, &prefix_len) < 0) {
+		return -EINVAL;
+	}
+
+	route = net_route_ipv4_find(iface, &prefix, prefix_len);
+	if (!route) {
+		PR_WARNING("No such route %s\n", argv[2]);
+		return -ENOENT;
+	}
+
+	return net_route_ipv4_del(route);
+}
+#endif /* CONFIG_NET_NATIVE_IPV4 && CONFIG_NET_ROUTE_IPV4 */
+
+static int cmd_net_route_add(const struct shell *sh, size_t argc, char *argv[])
+{
+#if defined(CONFIG_NET_NATIVE_IPV4) && defined(CONFIG_NET_ROUTE_IPV4)
+	if (argc > 2 && strchr(argv[2], ':') == NULL) {
+		return cmd_net_ip4_route_add(sh, argc, argv);
+	}
+#endif
+
+	return cmd_net_ip6_route_add(sh, argc, argv);
+}
+
+static int cmd_net_route_del(const struct shell *sh, size_t argc, char *argv[])
+{
+#if defined(CONFIG_NET_NATIVE_IPV4) && defined(CONFIG_NET_ROUTE_IPV4)
+	if (argc > 2 && strchr(argv[2], ':') == NULL) {
+		return cmd_net_ip4_route_del(sh, argc, argv);
+	}
+#endif
+
+	return cmd_net_ip6_route_del(sh, argc, argv);
+}
+
 #if defined(CONFIG_NET_NATIVE_IPV4)
 static void ip_address_lifetime_cb(struct net_if *iface, void *user_data)
 {
@@ -4966,11 +5349,10 @@ static int cmd_net_route(const struct shell *sh, size_t argc, char *argv[])
 	ARG_UNUSED(argv);
 
 #if defined(CONFIG_NET_NATIVE)
-#if defined(CONFIG_NET_ROUTE) || defined(CONFIG_NET_ROUTE_MCAST)
+#if defined(CONFIG_NET_ROUTE) || defined(CONFIG_NET_ROUTE_MCAST) || \
+	defined(CONFIG_NET_ROUTE_IPV4)
 	struct net_shell_user_data user_data;
-#endif
 
-#if defined(CONFIG_NET_ROUTE) || defined(CONFIG_NET_ROUTE_MCAST)
 	user_data.sh = sh;
 #endif
 
@@ -4984,6 +5366,10 @@ static int cmd_net_route(const struct shell *sh, size_t argc, char *argv[])
 #if defined(CONFIG_NET_ROUTE_MCAST)
 	net_if_foreach(iface_per_mcast_route_cb, &user_data);
 #endif
+
+#if defined(CONFIG_NET_ROUTE_IPV4)
+	net_if_foreach(iface_per_route_ipv4_cb, &user_data);
+#endif
 #endif
 	return 0;
 }
@@ -6220,6 +6606,19 @@ SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_arp,
 	SHELL_SUBCMD_SET_END
 );
 
+SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_capture_local,
+	SHELL_CMD(start, NULL, "Start capturing packets to the local ring buffer.\n"
+		  "'net capture local start [<interface index>] [<snaplen>]'\n"
+		  "Interface index 0 or no index captures all interfaces.",
+		  cmd_net_capture_local_start),
+	SHELL_CMD(stop, NULL, "Stop capturing packets to the local ring buffer.",
+		  cmd_net_capture_local_stop),
+	SHELL_CMD(save, NULL, "Append the captured packets to a pcapng file.\n"
+		  "'net capture local save <file path>'",
+		  cmd_net_capture_local_save),
+	SHELL_SUBCMD_SET_END
+);
+
 SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_capture,
 	SHELL_CMD(setup, NULL, "Setup network packet capture.\n"
 		  "'net capture setup <remote-ip-addr> <local-addr> <peer-addr>'\n"
@@ -6237,12 +6636,19 @@ SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_capture,
 		  cmd_net_capture_enable),
 	SHELL_CMD(disable, NULL, "Disable network packet capture.",
 		  cmd_net_capture_disable),
+	SHELL_CMD(local, &net_cmd_capture_local,
+		  "Show local network packet capture status.",
+		  cmd_net_capture_local),
 	SHELL_SUBCMD_SET_END
 );
 
 SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_dns,
+	SHELL_CMD(cache, NULL, "Show cached DNS answers and statistics.",
+		  cmd_net_dns_cache),
 	SHELL_CMD(cancel, NULL, "Cancel all pending requests.",
 		  cmd_net_dns_cancel),
+	SHELL_CMD(flush, NULL, "Remove all cached DNS answers.",
+		  cmd_net_dns_flush),
 	SHELL_CMD(query, NULL,
 		  "'net dns <hostname> [A or AAAA]' queries IPv4 address "
 		  "(default) or IPv6 address for a host name.",
@@ -6420,12 +6826,13 @@ SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_ip6,
 SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_route,
 	SHELL_CMD(add, NULL,
 		  "'net route add <index> <destination> <gateway>'"
-		  " adds the route to the destination.",
-		  cmd_net_ip6_route_add),
+		  " adds the route to the destination. IPv4 destination"
+		  " can be given as <address>/<len>.",
+		  cmd_net_route_add),
 	SHELL_CMD(del, NULL,
 		  "'net route del <index> <destination>'"
 		  " deletes the route to the destination.",
-		  cmd_net_ip6_route_del),
+		  cmd_net_route_del),
 	SHELL_SUBCMD_SET_END
 );
 
@@ -152,6 +152,7 @@ static inline void stats(struct net_if *iface)
 		NET_INFO("TCP conn drop  %d\tconnrst\t%d",
 			 GET_STAT(iface, tcp.conndrop),
 			 GET_STAT(iface, tcp.connrst));
+		NET_INFO("TCP seg coalesced %d", GET_STAT(iface, tcp.coalesced));
 #endif
 
 		NET_INFO("Bytes received %u", GET_STAT(iface, bytes.received));
@@ -203,6 +204,15 @@ static inline void stats(struct net_if *iface)
 		NET_INFO("Total suspended time: %llu ms",
 			 GET_STAT(iface, pm.overall_suspend_time));
 #endif
+
+#if defined(CONFIG_NET_STATISTICS_PKT_POOL)
+		NET_INFO("Pkt pool alloc  %d\tfallback\t%d\tfailed\t%d",
+			 GET_STAT(iface, pkt_pool.alloc),
+			 GET_STAT(iface, pkt_pool.fallback),
+			 GET_STAT(iface, pkt_pool.alloc_failed));
+		NET_INFO("Pkt pool congested %d",
+			 GET_STAT(iface, pkt_pool.congested));
+#endif
 		next_print = curr + PRINT_STATISTICS_INTERVAL;
 	}
 }
@@ -302,6 +312,12 @@ static int net_stats_get(uint32_t mgmt_request, struct net_if *iface,
 		len_chk = sizeof(struct net_stats_pm);
 		src = GET_STAT_ADDR(iface, pm);
 		break;
+#endif
+#if defined(CONFIG_NET_STATISTICS_PKT_POOL)
+	case NET_REQUEST_STATS_CMD_GET_PKT_POOL:
+		len_chk = sizeof(struct net_stats_pkt_pool);
+		src = GET_STAT_ADDR(iface, pkt_pool);
+		break;
 #endif
 	}
 
@@ -361,6 +377,11 @@ NET_MGMT_REGISTER_REQUEST_HANDLER(NET_REQUEST_STATS_GET_PM,
 				  net_stats_get);
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_PKT_POOL)
+NET_MGMT_REGISTER_REQUEST_HANDLER(NET_REQUEST_STATS_GET_PKT_POOL,
+				  net_stats_get);
+#endif
+
 #endif /* CONFIG_NET_STATISTICS_USER_API */
 
 void net_stats_reset(struct net_if *iface)
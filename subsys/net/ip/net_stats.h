@@ -258,6 +258,11 @@ static inline void net_stats_update_tcp_seg_rexmit(struct net_if *iface)
 {
 	UPDATE_STAT(iface, stats.tcp.rexmit++);
 }
+
+static inline void net_stats_update_tcp_seg_coalesced(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.tcp.coalesced++);
+}
 #else
 #define net_stats_update_tcp_sent(iface, bytes)
 #define net_stats_update_tcp_resent(iface, bytes)
@@ -273,6 +278,7 @@ static inline void net_stats_update_tcp_seg_rexmit(struct net_if *iface)
 #define net_stats_update_tcp_seg_ackerr(iface)
 #define net_stats_update_tcp_seg_rsterr(iface)
 #define net_stats_update_tcp_seg_rexmit(iface)
+#define net_stats_update_tcp_seg_coalesced(iface)
 #endif /* CONFIG_NET_STATISTICS_TCP */
 
 static inline void net_stats_update_per_proto_recv(struct net_if *iface,
@@ -619,6 +625,33 @@ static inline void net_stats_add_suspend_end_time(struct net_if *iface,
 #define net_stats_add_suspend_end_time(iface, time)
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_PKT_POOL) && defined(CONFIG_NET_NATIVE)
+static inline void net_stats_update_pkt_pool_alloc(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.pkt_pool.alloc++);
+}
+
+static inline void net_stats_update_pkt_pool_fallback(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.pkt_pool.fallback++);
+}
+
+static inline void net_stats_update_pkt_pool_alloc_failed(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.pkt_pool.alloc_failed++);
+}
+
+static inline void net_stats_update_pkt_pool_congested(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.pkt_pool.congested++);
+}
+#else
+#define net_stats_update_pkt_pool_alloc(iface)
+#define net_stats_update_pkt_pool_fallback(iface)
+#define net_stats_update_pkt_pool_alloc_failed(iface)
+#define net_stats_update_pkt_pool_congested(iface)
+#endif /* CONFIG_NET_STATISTICS_PKT_POOL */
+
 #if defined(CONFIG_NET_STATISTICS_PERIODIC_OUTPUT) \
 	&& defined(CONFIG_NET_NATIVE)
 /* A simple periodic statistic printer, used only in net core */
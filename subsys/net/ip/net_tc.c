@@ -13,6 +13,7 @@ LOG_MODULE_REGISTER(net_tc, CONFIG_NET_TC_LOG_LEVEL);
 #include <zephyr/net/net_core.h>
 #include <zephyr/net/net_pkt.h>
 #include <zephyr/net/net_stats.h>
+#include <zephyr/net/ethernet.h>
 
 #include "net_private.h"
 #include "net_stats.h"
@@ -21,23 +22,28 @@ LOG_MODULE_REGISTER(net_tc, CONFIG_NET_TC_LOG_LEVEL);
 /* Template for thread name. The "xx" is either "TX" denoting transmit thread,
  * or "RX" denoting receive thread. The "q[y]" denotes the traffic class queue
  * where y indicates the traffic class id. The value of y can be from 0 to 7.
+ * If a traffic class has several queues, ".n" is the queue index within it.
  */
-#define MAX_NAME_LEN sizeof("xx_q[y]")
+#define MAX_NAME_LEN sizeof("xx_q[y.n]")
+
+#define TX_QUEUE_COUNT (NET_TC_TX_COUNT * NET_TC_TX_QUEUE_COUNT)
+#define RX_QUEUE_COUNT (NET_TC_RX_COUNT * NET_TC_RX_QUEUE_COUNT)
 
 /* Stacks for TX work queue */
-K_KERNEL_STACK_ARRAY_DEFINE(tx_stack, NET_TC_TX_COUNT,
+K_KERNEL_STACK_ARRAY_DEFINE(tx_stack, TX_QUEUE_COUNT,
 			    CONFIG_NET_TX_STACK_SIZE);
 
 /* Stacks for RX work queue */
-K_KERNEL_STACK_ARRAY_DEFINE(rx_stack, NET_TC_RX_COUNT,
+K_KERNEL_STACK_ARRAY_DEFINE(rx_stack, RX_QUEUE_COUNT,
 			    CONFIG_NET_RX_STACK_SIZE);
 
+/* The queues of traffic class tc start at index tc * NET_TC_xX_QUEUE_COUNT */
 #if NET_TC_TX_COUNT > 0
-static struct net_traffic_class tx_classes[NET_TC_TX_COUNT];
+static struct net_traffic_class tx_classes[TX_QUEUE_COUNT];
 #endif
 
 #if NET_TC_RX_COUNT > 0
-static struct net_traffic_class rx_classes[NET_TC_RX_COUNT];
+static struct net_traffic_class rx_classes[RX_QUEUE_COUNT];
 #endif
 
 #if NET_TC_RX_COUNT > 0 || NET_TC_TX_COUNT > 0
@@ -47,12 +53,182 @@ static void submit_to_queue(struct k_fifo *queue, struct net_pkt *pkt)
 }
 #endif
 
+#if defined(CONFIG_NET_PKT_FLOW_HASH)
+/* Hash the addresses, the protocol and the ports of the IP packet starting
+ * at the given offset. Source and destination are combined so that both
+ * directions of a flow get the same hash. Ports are left out for IPv4
+ * fragments, so all the fragments of a datagram are kept together.
+ *
+ * Returns 0 if the packet is not an IP packet.
+ */
+static uint32_t flow_hash_calc(struct net_pkt *pkt, size_t offset)
+{
+	bool overwrite = net_pkt_is_being_overwritten(pkt);
+	struct net_pkt_cursor backup;
+	uint8_t hdr[NET_IPV6H_LEN];
+	uint32_t hash = 0U;
+	size_t ports_offset;
+	uint16_t ports[2];
+	uint8_t proto;
+	int i;
+
+	net_pkt_cursor_backup(pkt, &backup);
+	net_pkt_set_overwrite(pkt, true);
+	net_pkt_cursor_init(pkt);
+
+	if (net_pkt_skip(pkt, offset) || net_pkt_read_u8(pkt, &hdr[0])) {
+		goto out;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && (hdr[0] >> 4) == 4) {
+		if (net_pkt_read(pkt, &hdr[1], NET_IPV4H_LEN - 1)) {
+			goto out;
+		}
+
+		proto = hdr[9];
+		hash = UNALIGNED_GET((uint32_t *)&hdr[12]) ^
+		       UNALIGNED_GET((uint32_t *)&hdr[16]);
+
+		/* More fragments flag or non-zero fragment offset */
+		if ((hdr[6] & 0x3f) || hdr[7]) {
+			proto = 0U;
+		}
+
+		ports_offset = (hdr[0] & 0x0f) * 4 - NET_IPV4H_LEN;
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) && (hdr[0] >> 4) == 6) {
+		if (net_pkt_read(pkt, &hdr[1], NET_IPV6H_LEN - 1)) {
+			goto out;
+		}
+
+		proto = hdr[6];
+
+		for (i = 8; i < NET_IPV6H_LEN; i += sizeof(uint32_t)) {
+			hash ^= UNALIGNED_GET((uint32_t *)&hdr[i]);
+		}
+
+		ports_offset = 0;
+	} else {
+		goto out;
+	}
+
+	hash ^= proto;
+
+	if ((proto == IPPROTO_TCP || proto == IPPROTO_UDP) &&
+	    !net_pkt_skip(pkt, ports_offset) &&
+	    !net_pkt_read(pkt, ports, sizeof(ports))) {
+		hash ^= ports[0] ^ ports[1];
+	}
+
+	/* Spread the bits, the queue is selected from the low ones */
+	hash *= 0x9e3779b1;
+	hash ^= hash >> 16;
+
+	if (hash == 0U) {
+		hash = 1U;
+	}
+
+out:
+	net_pkt_set_overwrite(pkt, overwrite);
+	net_pkt_cursor_restore(pkt, &backup);
+
+	return hash;
+}
+#endif /* CONFIG_NET_PKT_FLOW_HASH */
+
+#if NET_TC_TX_COUNT > 0
+static struct k_fifo *tx_queue_get(uint8_t tc, struct net_pkt *pkt)
+{
+#if NET_TC_TX_QUEUE_COUNT > 1
+	uint32_t hash = net_pkt_flow_hash(pkt);
+
+	/* The link layer header is added after the queue */
+	if (hash == 0U && (net_pkt_family(pkt) == AF_INET ||
+			   net_pkt_family(pkt) == AF_INET6)) {
+		hash = flow_hash_calc(pkt, 0);
+		net_pkt_set_flow_hash(pkt, hash);
+	}
+
+	return &tx_classes[tc * NET_TC_TX_QUEUE_COUNT +
+			   hash % NET_TC_TX_QUEUE_COUNT].fifo;
+#else
+	ARG_UNUSED(pkt);
+
+	return &tx_classes[tc].fifo;
+#endif
+}
+#endif
+
+#if NET_TC_RX_COUNT > 0
+#if NET_TC_RX_QUEUE_COUNT > 1
+/* Received packets still have their link layer header */
+static uint32_t rx_flow_hash_calc(struct net_pkt *pkt)
+{
+	struct net_if *iface = net_pkt_iface(pkt);
+
+#if defined(CONFIG_NET_L2_ETHERNET)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(ETHERNET)) {
+		size_t offset = sizeof(struct net_eth_hdr) - sizeof(uint16_t);
+		struct net_pkt_cursor backup;
+		uint16_t type;
+
+		net_pkt_cursor_backup(pkt, &backup);
+		net_pkt_cursor_init(pkt);
+
+		if (net_pkt_skip(pkt, offset) || net_pkt_read_be16(pkt, &type)) {
+			type = 0U;
+		} else if (type == NET_ETH_PTYPE_VLAN &&
+			   !net_pkt_skip(pkt, sizeof(type)) &&
+			   !net_pkt_read_be16(pkt, &type)) {
+			offset += 2 * sizeof(type);
+		}
+
+		net_pkt_cursor_restore(pkt, &backup);
+
+		if (type != NET_ETH_PTYPE_IP && type != NET_ETH_PTYPE_IPV6) {
+			return 0U;
+		}
+
+		return flow_hash_calc(pkt, offset + sizeof(type));
+	}
+#endif
+
+#if defined(CONFIG_NET_L2_DUMMY)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(DUMMY)) {
+		return flow_hash_calc(pkt, 0);
+	}
+#endif
+
+	ARG_UNUSED(iface);
+
+	return 0U;
+}
+#endif
+
+static uint8_t rx_queue_index(uint8_t tc, struct net_pkt *pkt)
+{
+#if NET_TC_RX_QUEUE_COUNT > 1
+	uint32_t hash = net_pkt_flow_hash(pkt);
+
+	if (hash == 0U) {
+		hash = rx_flow_hash_calc(pkt);
+		net_pkt_set_flow_hash(pkt, hash);
+	}
+
+	return tc * NET_TC_RX_QUEUE_COUNT + hash % NET_TC_RX_QUEUE_COUNT;
+#else
+	ARG_UNUSED(pkt);
+
+	return tc;
+#endif
+}
+#endif
+
 bool net_tc_submit_to_tx_queue(uint8_t tc, struct net_pkt *pkt)
 {
 #if NET_TC_TX_COUNT > 0
 	net_pkt_set_tx_stats_tick(pkt, k_cycle_get_32());
 
-	submit_to_queue(&tx_classes[tc].fifo, pkt);
+	submit_to_queue(tx_queue_get(tc, pkt), pkt);
 #else
 	ARG_UNUSED(tc);
 	ARG_UNUSED(pkt);
@@ -65,13 +241,58 @@ void net_tc_submit_to_rx_queue(uint8_t tc, struct net_pkt *pkt)
 #if NET_TC_RX_COUNT > 0
 	net_pkt_set_rx_stats_tick(pkt, k_cycle_get_32());
 
-	submit_to_queue(&rx_classes[tc].fifo, pkt);
+	submit_to_queue(&rx_classes[rx_queue_index(tc, pkt)].fifo, pkt);
 #else
 	ARG_UNUSED(tc);
 	ARG_UNUSED(pkt);
 #endif
 }
 
+void net_tc_submit_list_to_rx_queue(uint8_t tc, sys_slist_t *list)
+{
+#if NET_TC_RX_COUNT > 0
+	uint32_t tick = k_cycle_get_32();
+	sys_snode_t *node;
+
+#if NET_TC_RX_QUEUE_COUNT > 1
+	sys_slist_t queued[NET_TC_RX_QUEUE_COUNT];
+	uint8_t first = tc * NET_TC_RX_QUEUE_COUNT;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(queued); i++) {
+		sys_slist_init(&queued[i]);
+	}
+
+	/* Split the batch by queue, keeping the order within each queue */
+	while ((node = sys_slist_get(list)) != NULL) {
+		net_pkt_set_rx_stats_tick((struct net_pkt *)node, tick);
+
+		sys_slist_append(&queued[rx_queue_index(tc, (struct net_pkt *)node) -
+					 first], node);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(queued); i++) {
+		if (!sys_slist_is_empty(&queued[i])) {
+			(void)k_fifo_put_slist(&rx_classes[first + i].fifo,
+					       &queued[i]);
+		}
+	}
+#else
+	/* The fifo link is the first field of net_pkt, so the packets can
+	 * be moved to the queue as a list in one go.
+	 */
+	SYS_SLIST_FOR_EACH_NODE(list, node) {
+		net_pkt_set_rx_stats_tick((struct net_pkt *)node, tick);
+	}
+
+	(void)k_fifo_put_slist(&rx_classes[tc].fifo, list);
+#endif
+#else
+	ARG_UNUSED(tc);
+	ARG_UNUSED(list);
+#endif
+}
+
 int net_tx_priority2tc(enum net_priority prio)
 {
 #if NET_TC_TX_COUNT > 0
@@ -268,7 +489,38 @@ static void tc_tx_handler(struct k_fifo *fifo)
 }
 #endif
 
-/* Create a fifo for each traffic class we are using. All the network
+#if NET_TC_RX_COUNT > 0 || NET_TC_TX_COUNT > 0
+static void queue_thread_setup(k_tid_t tid, const char *dir, int index,
+			       int queue_count)
+{
+	int queue = index % queue_count;
+
+	if (IS_ENABLED(CONFIG_THREAD_NAME)) {
+		char name[MAX_NAME_LEN];
+
+		if (queue_count > 1) {
+			snprintk(name, sizeof(name), "%s_q[%d.%d]", dir,
+				 index / queue_count, queue);
+		} else {
+			snprintk(name, sizeof(name), "%s_q[%d]", dir, index);
+		}
+
+		k_thread_name_set(tid, name);
+	}
+
+#if defined(CONFIG_NET_TC_QUEUE_CPU_AFFINITY)
+	if (queue_count > 1 &&
+	    k_thread_cpu_pin(tid, queue % arch_num_cpus()) < 0) {
+		NET_ERR("Cannot pin %s queue %d to CPU %d", dir, index,
+			queue % arch_num_cpus());
+	}
+#else
+	ARG_UNUSED(queue);
+#endif
+}
+#endif
+
+/* Create a fifo for each traffic class queue we are using. All the network
  * traffic goes through these classes.
  */
 void net_tc_tx_init(void)
@@ -285,12 +537,12 @@ void net_tc_tx_init(void)
 	net_if_foreach(net_tc_tx_stats_priority_setup, NULL);
 #endif
 
-	for (i = 0; i < NET_TC_TX_COUNT; i++) {
+	for (i = 0; i < TX_QUEUE_COUNT; i++) {
 		uint8_t thread_priority;
 		int priority;
 		k_tid_t tid;
 
-		thread_priority = tx_tc2thread(i);
+		thread_priority = tx_tc2thread(i / NET_TC_TX_QUEUE_COUNT);
 
 		priority = IS_ENABLED(CONFIG_NET_TC_THREAD_COOPERATIVE) ?
 			K_PRIO_COOP(thread_priority) :
@@ -317,12 +569,7 @@ void net_tc_tx_init(void)
 			continue;
 		}
 
-		if (IS_ENABLED(CONFIG_THREAD_NAME)) {
-			char name[MAX_NAME_LEN];
-
-			snprintk(name, sizeof(name), "tx_q[%d]", i);
-			k_thread_name_set(tid, name);
-		}
+		queue_thread_setup(tid, "tx", i, NET_TC_TX_QUEUE_COUNT);
 
 		k_thread_start(tid);
 	}
@@ -343,12 +590,12 @@ void net_tc_rx_init(void)
 	net_if_foreach(net_tc_rx_stats_priority_setup, NULL);
 #endif
 
-	for (i = 0; i < NET_TC_RX_COUNT; i++) {
+	for (i = 0; i < RX_QUEUE_COUNT; i++) {
 		uint8_t thread_priority;
 		int priority;
 		k_tid_t tid;
 
-		thread_priority = rx_tc2thread(i);
+		thread_priority = rx_tc2thread(i / NET_TC_RX_QUEUE_COUNT);
 
 		priority = IS_ENABLED(CONFIG_NET_TC_THREAD_COOPERATIVE) ?
 			K_PRIO_COOP(thread_priority) :
@@ -375,12 +622,7 @@ void net_tc_rx_init(void)
 			continue;
 		}
 
-		if (IS_ENABLED(CONFIG_THREAD_NAME)) {
-			char name[MAX_NAME_LEN];
-
-			snprintk(name, sizeof(name), "rx_q[%d]", i);
-			k_thread_name_set(tid, name);
-		}
+		queue_thread_setup(tid, "rx", i, NET_TC_RX_QUEUE_COUNT);
 
 		k_thread_start(tid);
 	}
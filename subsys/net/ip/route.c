@@ -16,6 +16,7 @@ LOG_MODULE_REGISTER(net_route, CONFIG_NET_ROUTE_LOG_LEVEL);
 #include <limits.h>
 #include <zephyr/types.h>
 #include <zephyr/sys/slist.h>
+#include <zephyr/sys/dlist.h>
 
 #include <zephyr/net/net_pkt.h>
 #include <zephyr/net/net_core.h>
@@ -36,7 +37,27 @@ LOG_MODULE_REGISTER(net_route, CONFIG_NET_ROUTE_LOG_LEVEL);
 /* We keep track of the routes in a separate list so that we can remove
  * the oldest routes (at tail) if needed.
  */
-static sys_slist_t routes;
+static sys_dlist_t routes = SYS_DLIST_STATIC_INIT(&routes);
+
+/* Routes are hashed by their prefix. The number of routes of each prefix
+ * length is tracked so that a lookup only probes the lengths in use,
+ * longest first.
+ */
+static sys_slist_t route_hash[CONFIG_NET_ROUTE_HASH_SIZE];
+static uint16_t prefix_len_count[NET_IPV6_ADDR_SIZE * 8 + 1];
+
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+/* Recent lookup results, flushed whenever a route is added or removed */
+struct route_cache_entry {
+	struct in6_addr dst;
+	struct net_if *iface;
+	struct net_route_entry *route;
+	uint32_t generation;
+};
+
+static struct route_cache_entry route_cache[CONFIG_NET_ROUTE_CACHE_SIZE];
+static uint32_t route_cache_generation = 1U;
+#endif
 
 /* Track currently active route lifetime timers */
 static sys_slist_t active_route_lifetime_timers;
@@ -272,41 +293,127 @@ static int nbr_nexthop_put(struct net_nbr *nbr)
 /* Route was accessed, so place it in front of the routes list */
 static inline void update_route_access(struct net_route_entry *route)
 {
-	sys_slist_find_and_remove(&routes, &route->node);
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_remove(&route->node);
+	sys_dlist_prepend(&routes, &route->node);
 }
 
-struct net_route_entry *net_route_lookup(struct net_if *iface,
-					 struct in6_addr *dst)
+/* FNV-1a hash of the address bits covered by the prefix length */
+static uint32_t route_prefix_hash(const struct in6_addr *addr,
+				  uint8_t prefix_len)
 {
-	struct net_route_entry *route, *found = NULL;
-	uint8_t longest_match = 0U;
+	uint32_t hash = 2166136261U ^ prefix_len;
+	uint8_t len = prefix_len / 8;
 	int i;
 
-	k_mutex_lock(&lock, K_FOREVER);
+	for (i = 0; i < len; i++) {
+		hash = (hash ^ addr->s6_addr[i]) * 16777619U;
+	}
 
-	for (i = 0; i < CONFIG_NET_MAX_ROUTES && longest_match < 128; i++) {
-		struct net_nbr *nbr = get_nbr(i);
+	if (prefix_len % 8) {
+		uint8_t mask = 0xff << (8 - prefix_len % 8);
 
-		if (!nbr->ref) {
-			continue;
-		}
+		hash = (hash ^ (addr->s6_addr[len] & mask)) * 16777619U;
+	}
+
+	return hash;
+}
+
+static inline sys_slist_t *route_bucket(const struct in6_addr *addr,
+					uint8_t prefix_len)
+{
+	uint32_t hash = route_prefix_hash(addr, prefix_len);
+
+	return &route_hash[hash % CONFIG_NET_ROUTE_HASH_SIZE];
+}
+
+static void route_index_add(struct net_route_entry *route)
+{
+	sys_slist_prepend(route_bucket(&route->addr, route->prefix_len),
+			  &route->hash_node);
+	prefix_len_count[route->prefix_len]++;
+
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+	route_cache_generation++;
+#endif
+}
+
+static void route_index_remove(struct net_route_entry *route)
+{
+	if (!sys_slist_find_and_remove(route_bucket(&route->addr,
+						    route->prefix_len),
+				       &route->hash_node)) {
+		return;
+	}
+
+	prefix_len_count[route->prefix_len]--;
+
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+	route_cache_generation++;
+#endif
+}
 
-		if (iface && nbr->iface != iface) {
+static struct net_route_entry *route_index_lookup(struct net_if *iface,
+						  struct in6_addr *dst)
+{
+	struct net_route_entry *route;
+	int len;
+
+	for (len = NET_IPV6_ADDR_SIZE * 8; len >= 0; len--) {
+		if (prefix_len_count[len] == 0U) {
 			continue;
 		}
 
-		route = net_route_data(nbr);
+		SYS_SLIST_FOR_EACH_CONTAINER(route_bucket(dst, len), route,
+					     hash_node) {
+			if (route->prefix_len != len) {
+				continue;
+			}
+
+			if (iface && route->iface != iface) {
+				continue;
+			}
 
-		if (route->prefix_len >= longest_match &&
-		    net_ipv6_is_prefix(dst->s6_addr,
-				       route->addr.s6_addr,
-				       route->prefix_len)) {
-			found = route;
-			longest_match = route->prefix_len;
+			if (net_ipv6_is_prefix(dst->s6_addr,
+					       route->addr.s6_addr, len)) {
+				return route;
+			}
 		}
 	}
 
+	return NULL;
+}
+
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+static struct net_route_entry *route_cache_lookup(struct net_if *iface,
+						  struct in6_addr *dst)
+{
+	uint32_t hash = route_prefix_hash(dst, NET_IPV6_ADDR_SIZE * 8);
+	struct route_cache_entry *entry;
+
+	entry = &route_cache[hash % CONFIG_NET_ROUTE_CACHE_SIZE];
+
+	if (entry->generation != route_cache_generation ||
+	    entry->iface != iface || !net_ipv6_addr_cmp(&entry->dst, dst)) {
+		entry->route = route_index_lookup(iface, dst);
+		entry->iface = iface;
+		entry->generation = route_cache_generation;
+		net_ipaddr_copy(&entry->dst, dst);
+	}
+
+	return entry->route;
+}
+#else
+#define route_cache_lookup route_index_lookup
+#endif
+
+struct net_route_entry *net_route_lookup(struct net_if *iface,
+					 struct in6_addr *dst)
+{
+	struct net_route_entry *found;
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	found = route_cache_lookup(iface, dst);
 	if (found) {
 		net_route_info("Found", found, dst);
 
@@ -402,9 +509,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	nbr = nbr_new(iface, addr, prefix_len);
 	if (!nbr) {
 		/* Remove the oldest route and try again */
-		sys_snode_t *last = sys_slist_peek_tail(&routes);
-
-		sys_slist_find_and_remove(&routes, last);
+		sys_dnode_t *last = sys_dlist_peek_tail(&routes);
 
 		route = CONTAINER_OF(last,
 				     struct net_route_entry,
@@ -453,7 +558,8 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 
 	net_route_update_lifetime(route, lifetime);
 
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_prepend(&routes, &route->node);
+	route_index_add(route);
 
 	tmp = nbr_nexthop_get(iface, nexthop);
 
@@ -595,7 +701,11 @@ int net_route_del(struct net_route_entry *route)
 		}
 	}
 
-	sys_slist_find_and_remove(&routes, &route->node);
+	if (sys_dnode_is_linked(&route->node)) {
+		sys_dlist_remove(&route->node);
+	}
+
+	route_index_remove(route);
 
 	nbr = net_route_get_nbr(route);
 	if (!nbr) {
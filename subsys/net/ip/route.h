@@ -15,6 +15,7 @@
 
 #include <zephyr/kernel.h>
 #include <zephyr/sys/slist.h>
+#include <zephyr/sys/dlist.h>
 
 #include <zephyr/net/net_ip.h>
 #include <zephyr/net/net_timeout.h>
@@ -47,7 +48,10 @@ struct net_route_entry {
 	 * we can remove it if we run out of available routes.
 	 * The oldest one is the last entry in the list.
 	 */
-	sys_snode_t node;
+	sys_dnode_t node;
+
+	/** Node in the hash bucket of the route prefix. */
+	sys_snode_t hash_node;
 
 	/** List of neighbors that the routes go through. */
 	sys_slist_t nexthop;
@@ -319,6 +323,152 @@ int net_route_packet(struct net_pkt *pkt, struct in6_addr *nexthop);
  */
 int net_route_packet_if(struct net_pkt *pkt, struct net_if *iface);
 
+/**
+ * @brief IPv4 route entry.
+ */
+struct net_route_entry_ipv4 {
+	/** Node in the hash bucket of the route prefix. */
+	sys_snode_t node;
+
+	/** Network interface for the route. */
+	struct net_if *iface;
+
+	/** IPv4 destination prefix of the route, host bits cleared. */
+	struct in_addr addr;
+
+	/** Gateway address, unspecified if the prefix is on-link. */
+	struct in_addr gw;
+
+	/** IPv4 prefix length. */
+	uint8_t prefix_len;
+
+	/** Is this entry in use */
+	bool is_used;
+};
+
+typedef void (*net_route_ipv4_cb_t)(struct net_route_entry_ipv4 *entry,
+				    void *user_data);
+
+#if defined(CONFIG_NET_ROUTE_IPV4) && defined(CONFIG_NET_NATIVE)
+/**
+ * @brief Add an IPv4 route to routing table.
+ *
+ * If a route with the same prefix already exists on the interface, its
+ * gateway is updated.
+ *
+ * @param iface Network interface that this route is tied to.
+ * @param addr IPv4 destination address/prefix.
+ * @param prefix_len Length of the IPv4 prefix, 0 for a default route.
+ * @param gw IPv4 gateway address, or unspecified address for on-link prefix.
+ *
+ * @return Return created route entry, NULL if could not be created.
+ */
+struct net_route_entry_ipv4 *net_route_ipv4_add(struct net_if *iface,
+						const struct in_addr *addr,
+						uint8_t prefix_len,
+						const struct in_addr *gw);
+
+/**
+ * @brief Delete an IPv4 route from routing table.
+ *
+ * @param route Existing route entry.
+ *
+ * @return 0 if ok, <0 if error
+ */
+int net_route_ipv4_del(struct net_route_entry_ipv4 *route);
+
+/**
+ * @brief Lookup the longest prefix IPv4 route to a given destination.
+ *
+ * The routing table is not locked anymore when this returns, so the entry
+ * stays valid only as long as the route is not deleted. After that, the
+ * entry may be reused for another route.
+ *
+ * @param iface Network interface. If NULL, then check against all interfaces.
+ * @param dst Destination IPv4 address.
+ *
+ * @return Return route entry related to a given destination address, NULL
+ * if not found.
+ */
+struct net_route_entry_ipv4 *net_route_ipv4_lookup(struct net_if *iface,
+						   const struct in_addr *dst);
+
+/**
+ * @brief Find the IPv4 route with the exact given prefix.
+ *
+ * Unlike net_route_ipv4_lookup(), a route with a longer or shorter prefix
+ * covering @p addr is not returned. The same lifetime rules apply to the
+ * returned entry.
+ *
+ * @param iface Network interface that the route is tied to.
+ * @param addr IPv4 destination prefix, host bits are ignored.
+ * @param prefix_len Length of the IPv4 prefix.
+ *
+ * @return Return the route entry, NULL if not found.
+ */
+struct net_route_entry_ipv4 *net_route_ipv4_find(struct net_if *iface,
+						 const struct in_addr *addr,
+						 uint8_t prefix_len);
+
+/**
+ * @brief Go through all the IPv4 routes and call callback for each route.
+ *
+ * @param cb User-supplied callback function to call.
+ * @param user_data User specified data.
+ *
+ * @return Total number of IPv4 routes found.
+ */
+int net_route_ipv4_foreach(net_route_ipv4_cb_t cb, void *user_data);
+#else
+static inline struct net_route_entry_ipv4 *
+net_route_ipv4_add(struct net_if *iface, const struct in_addr *addr,
+		   uint8_t prefix_len, const struct in_addr *gw)
+{
+	ARG_UNUSED(iface);
+	ARG_UNUSED(addr);
+	ARG_UNUSED(prefix_len);
+	ARG_UNUSED(gw);
+
+	return NULL;
+}
+
+static inline int net_route_ipv4_del(struct net_route_entry_ipv4 *route)
+{
+	ARG_UNUSED(route);
+
+	return -ENOTSUP;
+}
+
+static inline struct net_route_entry_ipv4 *
+net_route_ipv4_lookup(struct net_if *iface, const struct in_addr *dst)
+{
+	ARG_UNUSED(iface);
+	ARG_UNUSED(dst);
+
+	return NULL;
+}
+
+static inline struct net_route_entry_ipv4 *
+net_route_ipv4_find(struct net_if *iface, const struct in_addr *addr,
+		    uint8_t prefix_len)
+{
+	ARG_UNUSED(iface);
+	ARG_UNUSED(addr);
+	ARG_UNUSED(prefix_len);
+
+	return NULL;
+}
+
+static inline int net_route_ipv4_foreach(net_route_ipv4_cb_t cb,
+					 void *user_data)
+{
+	ARG_UNUSED(cb);
+	ARG_UNUSED(user_data);
+
+	return 0;
+}
+#endif /* CONFIG_NET_ROUTE_IPV4 */
+
 #if defined(CONFIG_NET_ROUTE) && defined(CONFIG_NET_NATIVE)
 void net_route_init(void);
 #else
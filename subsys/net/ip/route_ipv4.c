@@ -0,0 +1,317 @@
+/** @file
+ * @brief IPv4 route handling.
+ *
+ */
+
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_route_ipv4, CONFIG_NET_ROUTE_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <zephyr/types.h>
+#include <zephyr/sys/slist.h>
+
+#include <zephyr/net/net_core.h>
+#include <zephyr/net/net_mgmt.h>
+#include <zephyr/net/net_ip.h>
+#include <zephyr/net/net_if.h>
+
+#include "net_private.h"
+#include "route.h"
+
+#define IPV4_PREFIX_LEN_MAX 32
+
+static struct net_route_entry_ipv4 route_pool[CONFIG_NET_MAX_ROUTES_IPV4];
+
+/* Routes are hashed by their prefix. The number of routes of each prefix
+ * length is tracked so that a lookup only probes the lengths in use,
+ * longest first.
+ */
+static sys_slist_t route_hash[CONFIG_NET_ROUTE_HASH_SIZE];
+static uint16_t prefix_len_count[IPV4_PREFIX_LEN_MAX + 1];
+
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+/* Recent lookup results, flushed whenever a route is added or removed */
+struct route_cache_entry {
+	struct in_addr dst;
+	struct net_if *iface;
+	struct net_route_entry_ipv4 *route;
+	uint32_t generation;
+};
+
+static struct route_cache_entry route_cache[CONFIG_NET_ROUTE_CACHE_SIZE];
+static uint32_t route_cache_generation = 1U;
+#endif
+
+static K_MUTEX_DEFINE(lock);
+
+static inline uint32_t prefix_mask(uint8_t prefix_len)
+{
+	if (prefix_len == 0U) {
+		return 0U;
+	}
+
+	return htonl(UINT32_MAX << (IPV4_PREFIX_LEN_MAX - prefix_len));
+}
+
+static inline uint32_t route_prefix_hash(uint32_t addr, uint8_t prefix_len)
+{
+	/* Multiplicative hashing of the masked address */
+	return ((ntohl(addr & prefix_mask(prefix_len)) ^ prefix_len) *
+		2654435761U) >> 8;
+}
+
+static inline sys_slist_t *route_bucket(uint32_t addr, uint8_t prefix_len)
+{
+	uint32_t hash = route_prefix_hash(addr, prefix_len);
+
+	return &route_hash[hash % CONFIG_NET_ROUTE_HASH_SIZE];
+}
+
+static void route_notify(uint32_t event, struct net_route_entry_ipv4 *route)
+{
+#if defined(CONFIG_NET_MGMT_EVENT_INFO)
+	struct net_event_ipv4_route info;
+
+	net_ipaddr_copy(&info.addr, &route->addr);
+	net_ipaddr_copy(&info.gw, &route->gw);
+	info.prefix_len = route->prefix_len;
+
+	net_mgmt_event_notify_with_info(event, route->iface, (void *)&info,
+					sizeof(struct net_event_ipv4_route));
+#else
+	net_mgmt_event_notify(event, route->iface);
+#endif
+}
+
+static struct net_route_entry_ipv4 *route_find(struct net_if *iface,
+					       uint32_t addr,
+					       uint8_t prefix_len)
+{
+	struct net_route_entry_ipv4 *route;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(route_bucket(addr, prefix_len), route,
+				     node) {
+		if (route->prefix_len == prefix_len &&
+		    route->iface == iface &&
+		    route->addr.s_addr == (addr & prefix_mask(prefix_len))) {
+			return route;
+		}
+	}
+
+	return NULL;
+}
+
+static struct net_route_entry_ipv4 *route_index_lookup(struct net_if *iface,
+						       uint32_t dst)
+{
+	struct net_route_entry_ipv4 *route;
+	int len;
+
+	for (len = IPV4_PREFIX_LEN_MAX; len >= 0; len--) {
+		uint32_t prefix;
+
+		if (prefix_len_count[len] == 0U) {
+			continue;
+		}
+
+		prefix = dst & prefix_mask(len);
+
+		SYS_SLIST_FOR_EACH_CONTAINER(route_bucket(dst, len), route,
+					     node) {
+			if (route->prefix_len != len ||
+			    route->addr.s_addr != prefix) {
+				continue;
+			}
+
+			if (iface && route->iface != iface) {
+				continue;
+			}
+
+			return route;
+		}
+	}
+
+	return NULL;
+}
+
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+static struct net_route_entry_ipv4 *route_cache_lookup(struct net_if *iface,
+						       uint32_t dst)
+{
+	uint32_t hash = route_prefix_hash(dst, IPV4_PREFIX_LEN_MAX);
+	struct route_cache_entry *entry;
+
+	entry = &route_cache[hash % CONFIG_NET_ROUTE_CACHE_SIZE];
+
+	if (entry->generation != route_cache_generation ||
+	    entry->iface != iface || entry->dst.s_addr != dst) {
+		entry->route = route_index_lookup(iface, dst);
+		entry->iface = iface;
+		entry->generation = route_cache_generation;
+		entry->dst.s_addr = dst;
+	}
+
+	return entry->route;
+}
+#else
+#define route_cache_lookup route_index_lookup
+#endif
+
+static inline void route_cache_flush(void)
+{
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+	route_cache_generation++;
+#endif
+}
+
+struct net_route_entry_ipv4 *net_route_ipv4_lookup(struct net_if *iface,
+						   const struct in_addr *dst)
+{
+	struct net_route_entry_ipv4 *route;
+
+	k_mutex_lock(&lock, K_FOREVER);
+	route = route_cache_lookup(iface, dst->s_addr);
+	k_mutex_unlock(&lock);
+
+	return route;
+}
+
+struct net_route_entry_ipv4 *net_route_ipv4_find(struct net_if *iface,
+						 const struct in_addr *addr,
+						 uint8_t prefix_len)
+{
+	struct net_route_entry_ipv4 *route;
+
+	NET_ASSERT(iface);
+	NET_ASSERT(addr);
+
+	if (prefix_len > IPV4_PREFIX_LEN_MAX) {
+		return NULL;
+	}
+
+	k_mutex_lock(&lock, K_FOREVER);
+	route = route_find(iface, addr->s_addr, prefix_len);
+	k_mutex_unlock(&lock);
+
+	return route;
+}
+
+struct net_route_entry_ipv4 *net_route_ipv4_add(struct net_if *iface,
+						const struct in_addr *addr,
+						uint8_t prefix_len,
+						const struct in_addr *gw)
+{
+	struct net_route_entry_ipv4 *route;
+	int i;
+
+	NET_ASSERT(iface);
+	NET_ASSERT(addr);
+
+	if (prefix_len > IPV4_PREFIX_LEN_MAX) {
+		return NULL;
+	}
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	route = route_find(iface, addr->s_addr, prefix_len);
+	if (route) {
+		NET_DBG("Updating route %s/%d", net_sprint_ipv4_addr(addr),
+			prefix_len);
+		goto update;
+	}
+
+	for (i = 0; i < CONFIG_NET_MAX_ROUTES_IPV4; i++) {
+		if (!route_pool[i].is_used) {
+			route = &route_pool[i];
+			break;
+		}
+	}
+
+	if (!route) {
+		NET_DBG("No free IPv4 route entries");
+		goto out;
+	}
+
+	route->is_used = true;
+	route->iface = iface;
+	route->prefix_len = prefix_len;
+	route->addr.s_addr = addr->s_addr & prefix_mask(prefix_len);
+
+	sys_slist_prepend(route_bucket(route->addr.s_addr, prefix_len),
+			  &route->node);
+	prefix_len_count[prefix_len]++;
+
+	NET_DBG("Added route %s/%d", net_sprint_ipv4_addr(&route->addr),
+		prefix_len);
+
+update:
+	if (gw) {
+		net_ipaddr_copy(&route->gw, gw);
+	} else {
+		route->gw.s_addr = INADDR_ANY;
+	}
+
+	route_cache_flush();
+	route_notify(NET_EVENT_IPV4_ROUTE_ADD, route);
+
+out:
+	k_mutex_unlock(&lock);
+
+	return route;
+}
+
+int net_route_ipv4_del(struct net_route_entry_ipv4 *route)
+{
+	if (!route) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	if (!route->is_used) {
+		k_mutex_unlock(&lock);
+		return -EINVAL;
+	}
+
+	sys_slist_find_and_remove(route_bucket(route->addr.s_addr,
+					       route->prefix_len),
+				  &route->node);
+	prefix_len_count[route->prefix_len]--;
+	route->is_used = false;
+
+	route_cache_flush();
+
+	NET_DBG("Deleted route %s/%d", net_sprint_ipv4_addr(&route->addr),
+		route->prefix_len);
+
+	route_notify(NET_EVENT_IPV4_ROUTE_DEL, route);
+
+	k_mutex_unlock(&lock);
+
+	return 0;
+}
+
+int net_route_ipv4_foreach(net_route_ipv4_cb_t cb, void *user_data)
+{
+	int i, ret = 0;
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	for (i = 0; i < CONFIG_NET_MAX_ROUTES_IPV4; i++) {
+		if (!route_pool[i].is_used) {
+			continue;
+		}
+
+		cb(&route_pool[i], user_data);
+
+		ret++;
+	}
+
+	k_mutex_unlock(&lock);
+
+	return ret;
+}
@@ -52,7 +52,15 @@ int net_udp_finalize(struct net_pkt *pkt)
 	udp_hdr->len = htons(length);
 
 	if (net_if_need_calc_tx_checksum(net_pkt_iface(pkt))) {
-		udp_hdr->chksum = net_calc_chksum_udp(pkt);
+		if (net_pkt_is_chksum_partial(pkt)) {
+			/* The payload sum is already in the checksum field */
+			uint16_t chksum = net_calc_chksum_hdr(
+				pkt, IPPROTO_UDP, sizeof(struct net_udp_hdr));
+
+			udp_hdr->chksum = chksum == 0U ? 0xffff : chksum;
+		} else {
+			udp_hdr->chksum = net_calc_chksum_udp(pkt);
+		}
 	}
 
 	return net_pkt_set_data(pkt, &udp_access);
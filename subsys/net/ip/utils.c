@@ -26,6 +26,10 @@ LOG_MODULE_REGISTER(net_utils, CONFIG_NET_UTILS_LOG_LEVEL);
 #include <zephyr/net/net_core.h>
 #include <zephyr/net/socketcan.h>
 
+#if defined(CONFIG_X86_64) && defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 char *net_sprint_addr(sa_family_t af, const void *addr)
 {
 #define NBUFS 3
@@ -505,6 +509,42 @@ static uint16_t offset_based_swap8(const uint8_t *data)
 	}
 }
 
+#if defined(CONFIG_X86_64) && defined(__SSE2__)
+/* The SSE registers are part of the context saved for every thread and
+ * interrupt on x86_64, so they can be used from any context. Each 32-bit
+ * word is widened into a 64-bit lane, which leaves room for the carries.
+ * Consumes the data in 32-byte blocks and returns their sum. Shorter
+ * buffers are faster with the generic loop.
+ */
+#define CHKSUM_SSE2_MIN_LEN 128
+
+static uint64_t calc_chksum_sse2(const uint8_t **data, size_t *pending)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i *p = (const __m128i *)*data;
+	__m128i acc_lo = zero;
+	__m128i acc_hi = zero;
+	uint64_t lanes[2];
+
+	while (*pending >= sizeof(__m128i) * 2) {
+		__m128i v0 = _mm_loadu_si128(p);
+		__m128i v1 = _mm_loadu_si128(p + 1);
+
+		*pending -= sizeof(__m128i) * 2;
+		acc_lo = _mm_add_epi64(acc_lo, _mm_unpacklo_epi32(v0, zero));
+		acc_hi = _mm_add_epi64(acc_hi, _mm_unpackhi_epi32(v0, zero));
+		acc_lo = _mm_add_epi64(acc_lo, _mm_unpacklo_epi32(v1, zero));
+		acc_hi = _mm_add_epi64(acc_hi, _mm_unpackhi_epi32(v1, zero));
+		p += 2;
+	}
+
+	_mm_storeu_si128((__m128i *)lanes, _mm_add_epi64(acc_lo, acc_hi));
+	*data = (const uint8_t *)p;
+
+	return lanes[0] + lanes[1];
+}
+#endif
+
 /* Word based checksum calculation based on:
  * https://blogs.igalia.com/dpino/2018/06/14/fast-checksum-computation/
  * It’s not necessary to add octets as 16-bit words. Due to the associative property of addition,
@@ -540,6 +580,51 @@ uint16_t calc_chksum(uint16_t sum_in, const uint8_t *data, size_t len)
 		sum = sum + *((uint16_t *)data);
 		data += sizeof(uint16_t);
 	}
+
+#if defined(CONFIG_64BIT)
+	if ((((uintptr_t)data & 0x04) != 0) && (pending >= sizeof(uint32_t))) {
+		pending -= sizeof(uint32_t);
+		sum = sum + *((uint32_t *)data);
+		data += sizeof(uint32_t);
+	}
+
+#if defined(CONFIG_X86_64) && defined(__SSE2__)
+	if (pending >= CHKSUM_SSE2_MIN_LEN) {
+		sum += calc_chksum_sse2(&data, &pending);
+	}
+#endif
+
+	/* Load 64-bit words and add their 32-bit halves to separate
+	 * accumulators, so that no carry needs to be handled in the loop.
+	 */
+	if (pending >= sizeof(uint64_t)) {
+		const uint64_t *p64 = (const uint64_t *)data;
+		uint64_t sum_hi = 0;
+
+		while (pending >= sizeof(uint64_t) * 4) {
+			uint64_t w0 = p64[0];
+			uint64_t w1 = p64[1];
+			uint64_t w2 = p64[2];
+			uint64_t w3 = p64[3];
+
+			pending -= sizeof(uint64_t) * 4;
+			sum += (uint32_t)w0 + (uint64_t)(uint32_t)w1 +
+			       (uint32_t)w2 + (uint64_t)(uint32_t)w3;
+			sum_hi += (w0 >> 32) + (w1 >> 32) + (w2 >> 32) + (w3 >> 32);
+			p64 += 4;
+		}
+		while (pending >= sizeof(uint64_t)) {
+			pending -= sizeof(uint64_t);
+			sum += (uint32_t)*p64;
+			sum_hi += *p64 >> 32;
+			p64++;
+		}
+
+		sum += sum_hi;
+		data = (uint8_t *)p64;
+	}
+#endif /* CONFIG_64BIT */
+
 	p = (uint32_t *)data;
 
 	/* Do loop unrolling for the very large data sets */
@@ -582,6 +667,28 @@ uint16_t calc_chksum(uint16_t sum_in, const uint8_t *data, size_t len)
 	}
 }
 
+/* Copy the data in blocks that stay in the cache so that each byte is
+ * fetched from memory only once for both the copy and the checksum.
+ */
+#define CHKSUM_COPY_BLOCK 256
+
+uint16_t calc_chksum_copy(uint16_t sum, uint8_t *dst, const uint8_t *src,
+			  size_t len)
+{
+	while (len > 0) {
+		size_t block = MIN(len, CHKSUM_COPY_BLOCK);
+
+		memcpy(dst, src, block);
+		sum = calc_chksum(sum, dst, block);
+
+		dst += block;
+		src += block;
+		len -= block;
+	}
+
+	return sum;
+}
+
 static inline uint16_t pkt_calc_chksum(struct net_pkt *pkt, uint16_t sum)
 {
 	struct net_pkt_cursor *cur = &pkt->cursor;
@@ -620,7 +727,11 @@ static inline uint16_t pkt_calc_chksum(struct net_pkt *pkt, uint16_t sum)
 }
 
 #if defined(CONFIG_NET_IP)
-uint16_t net_calc_chksum(struct net_pkt *pkt, uint8_t proto)
+/* Max transport header length handled by net_calc_chksum_hdr() */
+#define CHKSUM_HDR_MAX_LEN 20
+
+static uint16_t calc_chksum_pkt(struct net_pkt *pkt, uint8_t proto,
+				size_t hdr_len)
 {
 	size_t len = 0U;
 	uint16_t sum = 0U;
@@ -657,7 +768,17 @@ uint16_t net_calc_chksum(struct net_pkt *pkt, uint8_t proto)
 	sum = calc_chksum(sum, pkt->cursor.pos, len);
 	net_pkt_skip(pkt, len + net_pkt_ip_opts_len(pkt));
 
-	sum = pkt_calc_chksum(pkt, sum);
+	if (hdr_len > 0) {
+		uint8_t hdr[CHKSUM_HDR_MAX_LEN] __aligned(4);
+
+		NET_ASSERT(hdr_len <= sizeof(hdr));
+
+		if (net_pkt_read(pkt, hdr, hdr_len) == 0) {
+			sum = calc_chksum(sum, hdr, hdr_len);
+		}
+	} else {
+		sum = pkt_calc_chksum(pkt, sum);
+	}
 
 	sum = (sum == 0U) ? 0xffff : htons(sum);
 
@@ -667,6 +788,17 @@ uint16_t net_calc_chksum(struct net_pkt *pkt, uint8_t proto)
 
 	return ~sum;
 }
+
+uint16_t net_calc_chksum(struct net_pkt *pkt, uint8_t proto)
+{
+	return calc_chksum_pkt(pkt, proto, 0);
+}
+
+uint16_t net_calc_chksum_hdr(struct net_pkt *pkt, uint8_t proto,
+			     size_t hdr_len)
+{
+	return calc_chksum_pkt(pkt, proto, hdr_len);
+}
 #endif
 
 #if defined(CONFIG_NET_IPV4)
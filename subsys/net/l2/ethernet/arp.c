@@ -19,6 +19,7 @@ LOG_MODULE_REGISTER(net_arp, CONFIG_NET_ARP_LOG_LEVEL);
 
 #include "arp.h"
 #include "net_private.h"
+#include "route.h"
 
 #define NET_BUF_TIMEOUT K_MSEC(100)
 #define ARP_REQUEST_TIMEOUT (2 * MSEC_PER_SEC)
@@ -28,7 +29,12 @@ static struct arp_entry arp_entries[CONFIG_NET_ARP_TABLE_SIZE];
 
 static sys_slist_t arp_free_entries;
 static sys_slist_t arp_pending_entries;
-static sys_slist_t arp_table;
+
+/* Resolved entries, hashed by their IPv4 address */
+static sys_slist_t arp_table[CONFIG_NET_ARP_TABLE_HASH_SIZE];
+
+/* Resolved entries, the most recently used first */
+static sys_dlist_t arp_lru;
 
 static struct k_work_delayable arp_request_timer;
 
@@ -56,6 +62,13 @@ static void arp_entry_cleanup(struct arp_entry *entry, bool pending)
 	(void)memset(&entry->eth, 0, sizeof(struct net_eth_addr));
 }
 
+static inline sys_slist_t *arp_table_bucket(const struct in_addr *addr)
+{
+	uint32_t key = ntohl(UNALIGNED_GET(&addr->s_addr));
+
+	return &arp_table[key % CONFIG_NET_ARP_TABLE_HASH_SIZE];
+}
+
 static struct arp_entry *arp_entry_find(sys_slist_t *list,
 					struct net_if *iface,
 					struct in_addr *dst,
@@ -83,22 +96,26 @@ static struct arp_entry *arp_entry_find(sys_slist_t *list,
 static inline struct arp_entry *arp_entry_find_move_first(struct net_if *iface,
 							  struct in_addr *dst)
 {
+	sys_slist_t *bucket = arp_table_bucket(dst);
 	sys_snode_t *prev = NULL;
 	struct arp_entry *entry;
 
 	NET_DBG("dst %s", net_sprint_ipv4_addr(dst));
 
-	entry = arp_entry_find(&arp_table, iface, dst, &prev);
+	entry = arp_entry_find(bucket, iface, dst, &prev);
 	if (entry) {
 		/* Let's assume the target is going to be accessed
 		 * more than once here in a short time frame. So we
-		 * place the entry first in position into the table
+		 * place the entry first in position into its bucket
 		 * in order to reduce subsequent find.
 		 */
-		if (&entry->node != sys_slist_peek_head(&arp_table)) {
-			sys_slist_remove(&arp_table, prev, &entry->node);
-			sys_slist_prepend(&arp_table, &entry->node);
+		if (&entry->node != sys_slist_peek_head(bucket)) {
+			sys_slist_remove(bucket, prev, &entry->node);
+			sys_slist_prepend(bucket, &entry->node);
 		}
+
+		sys_dlist_remove(&entry->lru_node);
+		sys_dlist_prepend(&arp_lru, &entry->lru_node);
 	}
 
 	return entry;
@@ -151,20 +168,29 @@ static struct arp_entry *arp_entry_get_free(void)
 
 static struct arp_entry *arp_entry_get_last_from_table(void)
 {
-	sys_snode_t *node;
+	sys_dnode_t *node;
+	struct arp_entry *entry;
 
-	/* We assume last entry is the oldest one,
-	 * so is the preferred one to be taken out.
+	/* The least recently used entry is the preferred one to be
+	 * taken out.
 	 */
-
-	node = sys_slist_peek_tail(&arp_table);
+	node = sys_dlist_peek_tail(&arp_lru);
 	if (!node) {
 		return NULL;
 	}
 
-	sys_slist_find_and_remove(&arp_table, node);
+	entry = CONTAINER_OF(node, struct arp_entry, lru_node);
 
-	return CONTAINER_OF(node, struct arp_entry, node);
+	sys_dlist_remove(&entry->lru_node);
+	sys_slist_find_and_remove(arp_table_bucket(&entry->ip), &entry->node);
+
+	return entry;
+}
+
+static void arp_entry_register_table(struct arp_entry *entry)
+{
+	sys_slist_prepend(arp_table_bucket(&entry->ip), &entry->node);
+	sys_dlist_prepend(&arp_lru, &entry->lru_node);
 }
 
 
@@ -337,6 +363,7 @@ struct net_pkt *net_arp_prepare(struct net_pkt *pkt,
 				struct in_addr *request_ip,
 				struct in_addr *current_ip)
 {
+	struct net_route_entry_ipv4 *route = NULL;
 	bool is_ipv4_ll_used = false;
 	struct arp_entry *entry;
 	struct in_addr *addr;
@@ -353,13 +380,24 @@ struct net_pkt *net_arp_prepare(struct net_pkt *pkt,
 	}
 
 	/* Is the destination in the local network, if not route via
-	 * the gateway address.
+	 * the routing table entry or the gateway address.
 	 */
 	if (!current_ip && !is_ipv4_ll_used &&
 	    !net_if_ipv4_addr_mask_cmp(net_pkt_iface(pkt), request_ip)) {
 		struct net_if_ipv4 *ipv4 = net_pkt_iface(pkt)->config.ip.ipv4;
 
-		if (ipv4) {
+		if (IS_ENABLED(CONFIG_NET_ROUTE_IPV4)) {
+			route = net_route_ipv4_lookup(net_pkt_iface(pkt),
+						      request_ip);
+		}
+
+		if (route) {
+			if (net_ipv4_is_addr_unspecified(&route->gw)) {
+				addr = request_ip;
+			} else {
+				addr = &route->gw;
+			}
+		} else if (ipv4) {
 			addr = &ipv4->gw;
 			if (net_ipv4_is_addr_unspecified(addr)) {
 				NET_ERR("Gateway not set for iface %p",
@@ -442,10 +480,9 @@ static void arp_gratuitous(struct net_if *iface,
 			   struct in_addr *src,
 			   struct net_eth_addr *hwaddr)
 {
-	sys_snode_t *prev = NULL;
 	struct arp_entry *entry;
 
-	entry = arp_entry_find(&arp_table, iface, src, &prev);
+	entry = arp_entry_find(arp_table_bucket(src), iface, src, NULL);
 	if (entry) {
 		NET_DBG("Gratuitous ARP hwaddr %s -> %s",
 			net_sprint_ll_addr((const uint8_t *)&entry->eth,
@@ -477,10 +514,10 @@ static void arp_update(struct net_if *iface,
 		}
 
 		if (force) {
-			sys_snode_t *prev = NULL;
 			struct arp_entry *entry;
 
-			entry = arp_entry_find(&arp_table, iface, src, &prev);
+			entry = arp_entry_find(arp_table_bucket(src), iface,
+					       src, NULL);
 			if (entry) {
 				memcpy(&entry->eth, hwaddr,
 				       sizeof(struct net_eth_addr));
@@ -499,7 +536,7 @@ static void arp_update(struct net_if *iface,
 					entry->iface = iface;
 					net_ipaddr_copy(&entry->ip, src);
 					memcpy(&entry->eth, hwaddr, sizeof(entry->eth));
-					sys_slist_prepend(&arp_table, &entry->node);
+					arp_entry_register_table(entry);
 				}
 			}
 		}
@@ -511,7 +548,7 @@ static void arp_update(struct net_if *iface,
 	memcpy(&entry->eth, hwaddr, sizeof(struct net_eth_addr));
 
 	/* Inserting entry into the table */
-	sys_slist_prepend(&arp_table, &entry->node);
+	arp_entry_register_table(entry);
 
 	while (!k_fifo_is_empty(&entry->pending_queue)) {
 		pkt = k_fifo_get(&entry->pending_queue, K_FOREVER);
@@ -713,23 +750,30 @@ enum net_verdict net_arp_input(struct net_pkt *pkt,
 
 void net_arp_clear_cache(struct net_if *iface)
 {
-	sys_snode_t *prev = NULL;
+	sys_snode_t *prev;
 	struct arp_entry *entry, *next;
+	int i;
 
 	NET_DBG("Flushing ARP table");
 
 	k_mutex_lock(&arp_mutex, K_FOREVER);
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&arp_table, entry, next, node) {
-		if (iface && iface != entry->iface) {
-			prev = &entry->node;
-			continue;
-		}
+	for (i = 0; i < ARRAY_SIZE(arp_table); i++) {
+		prev = NULL;
 
-		arp_entry_cleanup(entry, false);
+		SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&arp_table[i], entry, next,
+						  node) {
+			if (iface && iface != entry->iface) {
+				prev = &entry->node;
+				continue;
+			}
 
-		sys_slist_remove(&arp_table, prev, &entry->node);
-		sys_slist_prepend(&arp_free_entries, &entry->node);
+			arp_entry_cleanup(entry, false);
+
+			sys_slist_remove(&arp_table[i], prev, &entry->node);
+			sys_dlist_remove(&entry->lru_node);
+			sys_slist_prepend(&arp_free_entries, &entry->node);
+		}
 	}
 
 	prev = NULL;
@@ -773,12 +817,15 @@ int net_arp_foreach(net_arp_cb_t cb, void *user_data)
 {
 	int ret = 0;
 	struct arp_entry *entry;
+	int i;
 
 	k_mutex_lock(&arp_mutex, K_FOREVER);
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&arp_table, entry, node) {
-		ret++;
-		cb(entry, user_data);
+	for (i = 0; i < ARRAY_SIZE(arp_table); i++) {
+		SYS_SLIST_FOR_EACH_CONTAINER(&arp_table[i], entry, node) {
+			ret++;
+			cb(entry, user_data);
+		}
 	}
 
 	k_mutex_unlock(&arp_mutex);
@@ -796,7 +843,11 @@ void net_arp_init(void)
 
 	sys_slist_init(&arp_free_entries);
 	sys_slist_init(&arp_pending_entries);
-	sys_slist_init(&arp_table);
+	sys_dlist_init(&arp_lru);
+
+	for (i = 0; i < ARRAY_SIZE(arp_table); i++) {
+		sys_slist_init(&arp_table[i]);
+	}
 
 	for (i = 0; i < CONFIG_NET_ARP_TABLE_SIZE; i++) {
 		/* Inserting entry as free with initialised packet queue */
@@ -14,8 +14,11 @@ LOG_MODULE_REGISTER(net_eth_bridge, CONFIG_NET_ETHERNET_BRIDGE_LOG_LEVEL);
 #include <zephyr/net/ethernet_bridge.h>
 
 #include <zephyr/sys/slist.h>
+#include <zephyr/sys/byteorder.h>
+#include <string.h>
 
 #include "bridge.h"
+#include "net_private.h"
 
 extern struct eth_bridge _eth_bridge_list_start[];
 extern struct eth_bridge _eth_bridge_list_end[];
@@ -64,6 +67,198 @@ struct eth_bridge *eth_bridge_get_by_index(int index)
 	return &_eth_bridge_list_start[index - 1];
 }
 
+#if defined(CONFIG_NET_ETHERNET_BRIDGE_FDB)
+#define FDB_AGEING_TIME_MS (CONFIG_NET_ETHERNET_BRIDGE_FDB_AGEING_TIME * \
+			    MSEC_PER_SEC)
+
+static inline sys_slist_t *fdb_bucket(struct eth_bridge *br,
+				      const uint8_t *addr)
+{
+	uint32_t hash = sys_get_be32(&addr[2]) ^ sys_get_be16(&addr[0]);
+
+	return &br->fdb_hash[(hash * 2654435761U >> 8) %
+			     CONFIG_NET_ETHERNET_BRIDGE_FDB_HASH_SIZE];
+}
+
+static inline bool fdb_is_expired(struct eth_bridge_fdb_entry *entry,
+				  uint32_t now)
+{
+	return (uint32_t)(now - entry->last_seen) >= FDB_AGEING_TIME_MS;
+}
+
+static void fdb_remove(struct eth_bridge *br,
+		       struct eth_bridge_fdb_entry *entry)
+{
+	sys_slist_find_and_remove(fdb_bucket(br, entry->addr), &entry->node);
+	entry->iface = NULL;
+}
+
+static struct eth_bridge_fdb_entry *fdb_lookup(struct eth_bridge *br,
+					       const uint8_t *addr,
+					       uint32_t now)
+{
+	struct eth_bridge_fdb_entry *entry;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(fdb_bucket(br, addr), entry, node) {
+		if (memcmp(entry->addr, addr, sizeof(entry->addr)) != 0) {
+			continue;
+		}
+
+		if (fdb_is_expired(entry, now)) {
+			fdb_remove(br, entry);
+			br->stats.aged++;
+			return NULL;
+		}
+
+		return entry;
+	}
+
+	return NULL;
+}
+
+/* Return a free entry, or the least recently seen one if the table is full */
+static struct eth_bridge_fdb_entry *fdb_get_free(struct eth_bridge *br,
+						 uint32_t now)
+{
+	struct eth_bridge_fdb_entry *oldest = NULL;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(br->fdb); i++) {
+		struct eth_bridge_fdb_entry *entry = &br->fdb[i];
+
+		if (entry->iface == NULL) {
+			return entry;
+		}
+
+		if (oldest == NULL ||
+		    (uint32_t)(now - entry->last_seen) >
+		    (uint32_t)(now - oldest->last_seen)) {
+			oldest = entry;
+		}
+	}
+
+	fdb_remove(br, oldest);
+	br->stats.aged++;
+
+	return oldest;
+}
+
+static void fdb_learn(struct eth_bridge *br, struct net_if *iface,
+		      const uint8_t *addr, uint32_t now)
+{
+	struct eth_bridge_fdb_entry *entry;
+
+	/* Only unicast source addresses are learned */
+	if (addr[0] & 0x01) {
+		return;
+	}
+
+	entry = fdb_lookup(br, addr, now);
+	if (entry == NULL) {
+		entry = fdb_get_free(br, now);
+		memcpy(entry->addr, addr, sizeof(entry->addr));
+		sys_slist_prepend(fdb_bucket(br, addr), &entry->node);
+		br->stats.learned++;
+
+		NET_DBG("learned %s on iface %p",
+			net_sprint_ll_addr(addr, sizeof(entry->addr)), iface);
+	} else if (entry->iface != iface) {
+		br->stats.moved++;
+
+		NET_DBG("%s moved from iface %p to %p",
+			net_sprint_ll_addr(addr, sizeof(entry->addr)),
+			entry->iface, iface);
+	}
+
+	entry->iface = iface;
+	entry->last_seen = now;
+}
+
+static void fdb_flush(struct eth_bridge *br, struct net_if *iface)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(br->fdb); i++) {
+		if (br->fdb[i].iface == NULL) {
+			continue;
+		}
+
+		if (iface == NULL || br->fdb[i].iface == iface) {
+			fdb_remove(br, &br->fdb[i]);
+		}
+	}
+}
+
+int eth_bridge_fdb_foreach(struct eth_bridge *br, eth_bridge_fdb_cb_t cb,
+			   void *user_data)
+{
+	uint32_t now = k_uptime_get_32();
+	int i, ret = 0;
+
+	lock_bridge(br);
+
+	for (i = 0; i < ARRAY_SIZE(br->fdb); i++) {
+		if (br->fdb[i].iface == NULL ||
+		    fdb_is_expired(&br->fdb[i], now)) {
+			continue;
+		}
+
+		cb(&br->fdb[i], user_data);
+		ret++;
+	}
+
+	k_mutex_unlock(&br->lock);
+
+	return ret;
+}
+
+int eth_bridge_fdb_flush(struct eth_bridge *br, struct net_if *iface)
+{
+	lock_bridge(br);
+	fdb_flush(br, iface);
+	k_mutex_unlock(&br->lock);
+
+	return 0;
+}
+
+int eth_bridge_get_stats(struct eth_bridge *br, struct eth_bridge_stats *stats)
+{
+	lock_bridge(br);
+	memcpy(stats, &br->stats, sizeof(*stats));
+	k_mutex_unlock(&br->lock);
+
+	return 0;
+}
+#else
+#define fdb_flush(...)
+
+int eth_bridge_fdb_foreach(struct eth_bridge *br, eth_bridge_fdb_cb_t cb,
+			   void *user_data)
+{
+	ARG_UNUSED(br);
+	ARG_UNUSED(cb);
+	ARG_UNUSED(user_data);
+
+	return -ENOTSUP;
+}
+
+int eth_bridge_fdb_flush(struct eth_bridge *br, struct net_if *iface)
+{
+	ARG_UNUSED(br);
+	ARG_UNUSED(iface);
+
+	return -ENOTSUP;
+}
+
+int eth_bridge_get_stats(struct eth_bridge *br, struct eth_bridge_stats *stats)
+{
+	ARG_UNUSED(br);
+	ARG_UNUSED(stats);
+
+	return -ENOTSUP;
+}
+#endif /* CONFIG_NET_ETHERNET_BRIDGE_FDB */
+
 int eth_bridge_iface_add(struct eth_bridge *br, struct net_if *iface)
 {
 	struct ethernet_context *ctx = net_if_l2_data(iface);
@@ -116,6 +311,8 @@ int eth_bridge_iface_remove(struct eth_bridge *br, struct net_if *iface)
 	sys_slist_find_and_remove(&br->interfaces, &ctx->bridge.node);
 	ctx->bridge.instance = NULL;
 
+	fdb_flush(br, iface);
+
 	k_mutex_unlock(&br->lock);
 
 	NET_DBG("iface %p removed from bridge %p", iface, br);
@@ -165,63 +362,103 @@ static inline bool is_link_local_addr(struct net_eth_addr *addr)
 	return false;
 }
 
+static void bridge_xmit(struct ethernet_context *ctx,
+			struct ethernet_context *out_ctx,
+			struct net_pkt *pkt)
+{
+	struct net_pkt *out_pkt;
+
+	/* Don't xmit on the same interface as the incoming packet's */
+	if (ctx == out_ctx) {
+		return;
+	}
+
+	/* Skip it if not allowed to transmit */
+	if (!out_ctx->bridge.allow_tx) {
+		return;
+	}
+
+	/* Skip it if not up */
+	if (!net_if_flag_is_set(out_ctx->iface, NET_IF_UP)) {
+		return;
+	}
+
+	out_pkt = net_pkt_shallow_clone(pkt, K_NO_WAIT);
+	if (out_pkt == NULL) {
+		return;
+	}
+
+	NET_DBG("sending pkt %p as %p on iface %p", pkt, out_pkt, out_ctx->iface);
+
+	/*
+	 * Use AF_UNSPEC to avoid interference, set the output
+	 * interface and send the packet.
+	 */
+	net_pkt_set_family(out_pkt, AF_UNSPEC);
+	net_pkt_set_orig_iface(out_pkt, net_pkt_iface(pkt));
+	net_pkt_set_iface(out_pkt, out_ctx->iface);
+	net_if_queue_tx(out_ctx->iface, out_pkt);
+}
+
 enum net_verdict net_eth_bridge_input(struct ethernet_context *ctx,
 				      struct net_pkt *pkt)
 {
 	struct eth_bridge *br = ctx->bridge.instance;
+	struct net_eth_addr *dst;
 	sys_snode_t *node;
 
 	NET_DBG("new pkt %p", pkt);
 
+	dst = (struct net_eth_addr *)net_pkt_lladdr_dst(pkt)->addr;
+
 	/* Drop all link-local packets for now. */
-	if (is_link_local_addr((struct net_eth_addr *)net_pkt_lladdr_dst(pkt))) {
+	if (is_link_local_addr(dst)) {
 		return NET_DROP;
 	}
 
 	lock_bridge(br);
 
-	/*
-	 * Send packet to all registered interfaces for now.
-	 * Eventually we could get smarter with a MAC address cache.
-	 */
-	SYS_SLIST_FOR_EACH_NODE(&br->interfaces, node) {
-		struct ethernet_context *out_ctx;
-		struct net_pkt *out_pkt;
+#if defined(CONFIG_NET_ETHERNET_BRIDGE_FDB)
+	struct eth_bridge_fdb_entry *entry = NULL;
+	uint32_t now = k_uptime_get_32();
 
-		out_ctx = CONTAINER_OF(node, struct ethernet_context, bridge.node);
+	br->stats.rx++;
 
-		/* Don't xmit on the same interface as the incoming packet's */
-		if (ctx == out_ctx) {
-			continue;
-		}
+	fdb_learn(br, ctx->iface, net_pkt_lladdr_src(pkt)->addr, now);
 
-		/* Skip it if not allowed to transmit */
-		if (!out_ctx->bridge.allow_tx) {
-			continue;
-		}
+	if (!(dst->addr[0] & 0x01)) {
+		entry = fdb_lookup(br, dst->addr, now);
+	}
 
-		/* Skip it if not up */
-		if (!net_if_flag_is_set(out_ctx->iface, NET_IF_UP)) {
-			continue;
-		}
+	if (entry != NULL) {
+		struct ethernet_context *out_ctx = net_if_l2_data(entry->iface);
 
-		out_pkt = net_pkt_shallow_clone(pkt, K_NO_WAIT);
-		if (out_pkt == NULL) {
-			continue;
+		if (out_ctx == ctx) {
+			/* Destination is on the segment the frame came from */
+			br->stats.filtered++;
+		} else {
+			br->stats.forwarded++;
+			bridge_xmit(ctx, out_ctx, pkt);
 		}
 
-		NET_DBG("sending pkt %p as %p on iface %p", pkt, out_pkt, out_ctx->iface);
+		goto listeners;
+	}
+
+	br->stats.flooded++;
+#endif /* CONFIG_NET_ETHERNET_BRIDGE_FDB */
+
+	/* Send packet to all registered interfaces */
+	SYS_SLIST_FOR_EACH_NODE(&br->interfaces, node) {
+		struct ethernet_context *out_ctx;
+
+		out_ctx = CONTAINER_OF(node, struct ethernet_context, bridge.node);
 
-		/*
-		 * Use AF_UNSPEC to avoid interference, set the output
-		 * interface and send the packet.
-		 */
-		net_pkt_set_family(out_pkt, AF_UNSPEC);
-		net_pkt_set_orig_iface(out_pkt, net_pkt_iface(pkt));
-		net_pkt_set_iface(out_pkt, out_ctx->iface);
-		net_if_queue_tx(out_ctx->iface, out_pkt);
+		bridge_xmit(ctx, out_ctx, pkt);
 	}
 
+#if defined(CONFIG_NET_ETHERNET_BRIDGE_FDB)
+listeners:
+#endif
 	SYS_SLIST_FOR_EACH_NODE(&br->listeners, node) {
 		struct eth_bridge_listener *l;
 		struct net_pkt *out_pkt;
@@ -201,6 +201,74 @@ static int cmd_bridge_show(const struct shell *sh, size_t argc, char *argv[])
 	return 0;
 }
 
+#if defined(CONFIG_NET_ETHERNET_BRIDGE_FDB)
+static void bridge_fdb_entry_show(struct eth_bridge_fdb_entry *entry,
+				  void *data)
+{
+	const struct shell *sh = data;
+	uint32_t age = k_uptime_get_32() - entry->last_seen;
+
+	shell_fprintf(sh, SHELL_NORMAL,
+		      "%02x:%02x:%02x:%02x:%02x:%02x  %-10d%u\n",
+		      entry->addr[0], entry->addr[1], entry->addr[2],
+		      entry->addr[3], entry->addr[4], entry->addr[5],
+		      net_if_get_by_iface(entry->iface), age / MSEC_PER_SEC);
+}
+
+static void bridge_fdb_show(struct eth_bridge *br, void *data)
+{
+	const struct shell *sh = data;
+	struct eth_bridge_stats stats;
+
+	shell_fprintf(sh, SHELL_NORMAL, "\nBridge %d\n",
+		      eth_bridge_get_index(br));
+	shell_fprintf(sh, SHELL_NORMAL, "address            iface     age (sec)\n");
+
+	eth_bridge_fdb_foreach(br, bridge_fdb_entry_show, data);
+
+	eth_bridge_get_stats(br, &stats);
+
+	shell_fprintf(sh, SHELL_NORMAL,
+		      "rx %u forwarded %u flooded %u filtered %u\n"
+		      "learned %u moved %u aged %u\n",
+		      stats.rx, stats.forwarded, stats.flooded, stats.filtered,
+		      stats.learned, stats.moved, stats.aged);
+}
+#endif /* CONFIG_NET_ETHERNET_BRIDGE_FDB */
+
+static int cmd_bridge_fdb(const struct shell *sh, size_t argc, char *argv[])
+{
+#if defined(CONFIG_NET_ETHERNET_BRIDGE_FDB)
+	int br_idx;
+	struct eth_bridge *br;
+
+	if (argc == 1) {
+		net_eth_bridge_foreach(bridge_fdb_show, (void *)sh);
+		return 0;
+	}
+
+	br_idx = get_idx(sh, argv[1]);
+	if (br_idx < 0) {
+		return br_idx;
+	}
+
+	br = eth_bridge_get_by_index(br_idx);
+	if (br == NULL) {
+		shell_warn(sh, "Bridge %d not found\n", br_idx);
+		return -ENOENT;
+	}
+
+	bridge_fdb_show(br, (void *)sh);
+#else
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_warn(sh, "Set CONFIG_NET_ETHERNET_BRIDGE_FDB to enable "
+		   "forwarding database support.\n");
+#endif
+	return 0;
+}
+
 SHELL_STATIC_SUBCMD_SET_CREATE(bridge_commands,
 	SHELL_CMD_ARG(addif, NULL,
 		  "Add a network interface to a bridge.\n"
@@ -218,6 +286,10 @@ SHELL_STATIC_SUBCMD_SET_CREATE(bridge_commands,
 		  "Show bridge information.\n"
 		  "'bridge show [<bridge_index>]'",
 		  cmd_bridge_show, 1, 1),
+	SHELL_CMD_ARG(fdb, NULL,
+		  "Show learned MAC addresses and forwarding statistics.\n"
+		  "'bridge fdb [<bridge_index>]'",
+		  cmd_bridge_fdb, 1, 1),
 	SHELL_SUBCMD_SET_END
 );
 
@@ -33,19 +33,49 @@ LOG_MODULE_REGISTER(net_ieee802154_6lo_fragment, CONFIG_NET_L2_IEEE802154_LOG_LE
 #define FRAG_REASSEMBLY_TIMEOUT K_SECONDS(CONFIG_NET_L2_IEEE802154_REASSEMBLY_TIMEOUT)
 #define REASS_CACHE_SIZE	CONFIG_NET_L2_IEEE802154_FRAGMENT_REASS_CACHE_SIZE
 
+/* Max datagram size that fits the 11 bit datagram_size field */
+#define DATAGRAM_MAX_SIZE	0x7FF
+#define DATAGRAM_UNITS		DIV_ROUND_UP(DATAGRAM_MAX_SIZE + 1, 8)
+
+/* Room in front of the datagram in the reassemble buffer: the link layer
+ * addresses of the packet are stored there, as the fragment buffers they
+ * point to are freed, and one spare byte as an uncompressed IPv6 header in
+ * the first fragment is one byte longer with its dispatch.
+ */
+#define REASS_LL_ROOM		(2 * NET_LINK_ADDR_MAX_LENGTH)
+#define REASS_HDR_ROOM		(REASS_LL_ROOM + 1)
+
 /**
  *  Reassemble cache : Depends on cache size it used for reassemble
  *  IPv6 packets simultaneously.
+ *
+ *  The cache entries in use are kept in a hash table keyed with the sender
+ *  link layer address, datagram size and tag, so a fragment finds its
+ *  datagram without scanning the whole cache. The reassemble packet holds a
+ *  buffer of the size of the datagram, allocated when the first fragment is
+ *  received, and each fragment is copied to its final place in it.
  */
 struct frag_cache {
+	sys_snode_t node;	       /* Hash bucket or free list node */
+	sys_slist_t *bucket;	       /* Hash bucket of the cache */
 	struct k_work_delayable timer; /* Reassemble timer */
 	struct net_pkt *pkt;	       /* Reassemble packet */
+	struct net_linkaddr_storage src; /* Sender link layer address */
 	uint16_t size;		       /* Datagram size */
 	uint16_t tag;		       /* Datagram tag */
+	uint16_t received;	       /* Received datagram bytes */
+	int16_t frag1_pos;	       /* Buffer position of the first fragment */
+	uint32_t units[DIV_ROUND_UP(DATAGRAM_UNITS, 32)]; /* Received units */
 	bool used;
 };
 
 static struct frag_cache cache[REASS_CACHE_SIZE];
+static sys_slist_t cache_hash[REASS_CACHE_SIZE];
+static sys_slist_t cache_free;
+static bool cache_init_done;
+
+/* Serializes the fragment handling and the reassemble timers */
+static K_MUTEX_DEFINE(cache_lock);
 
 /**
  *  RFC 4944, section 5.3
@@ -256,35 +286,38 @@ static void update_protocol_header_lengths(struct net_pkt *pkt, uint16_t size)
 	}
 }
 
-static inline void clear_reass_cache(uint16_t size, uint16_t tag)
+static void reass_timeout(struct k_work *work);
+
+static void reass_cache_init(void)
 {
-	uint8_t i;
+	int i;
 
-	for (i = 0U; i < REASS_CACHE_SIZE; i++) {
-		if (!(cache[i].size == size && cache[i].tag == tag)) {
-			continue;
-		}
+	for (i = 0; i < REASS_CACHE_SIZE; i++) {
+		k_work_init_delayable(&cache[i].timer, reass_timeout);
+		sys_slist_append(&cache_free, &cache[i].node);
+	}
 
-		if (cache[i].pkt) {
-			net_pkt_unref(cache[i].pkt);
-		}
+	cache_init_done = true;
+}
 
-		cache[i].pkt = NULL;
-		cache[i].size = 0U;
-		cache[i].tag = 0U;
-		cache[i].used = false;
-		k_work_cancel_delayable(&cache[i].timer);
+static inline sys_slist_t *reass_bucket(struct net_linkaddr *src, uint16_t size, uint16_t tag)
+{
+	uint32_t hash = ((uint32_t)tag << 16) | size;
+	uint8_t i;
+
+	for (i = 0U; i < src->len; i++) {
+		hash = hash * 31U + src->addr[i];
 	}
+
+	return &cache_hash[hash % REASS_CACHE_SIZE];
 }
 
-/**
- *  If the reassembly not completed within reassembly timeout discard
- *  the whole packet.
- */
-static void reass_timeout(struct k_work *work)
+static void clear_reass_cache(struct frag_cache *cache)
 {
-	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
-	struct frag_cache *cache = CONTAINER_OF(dwork, struct frag_cache, timer);
+	sys_slist_find_and_remove(cache->bucket, &cache->node);
+	sys_slist_prepend(&cache_free, &cache->node);
+
+	k_work_cancel_delayable(&cache->timer);
 
 	if (cache->pkt) {
 		net_pkt_unref(cache->pkt);
@@ -297,99 +330,104 @@ static void reass_timeout(struct k_work *work)
 }
 
 /**
- *  Upon reception of first fragment with respective of size and tag
- *  create a new cache. If number of unused cache are out then
- *  discard the fragments.
+ *  If the reassembly not completed within reassembly timeout discard
+ *  the whole packet.
  */
-static inline struct frag_cache *set_reass_cache(struct net_pkt *pkt, uint16_t size, uint16_t tag)
+static void reass_timeout(struct k_work *work)
 {
-	int i;
-
-	for (i = 0; i < REASS_CACHE_SIZE; i++) {
-		if (cache[i].used) {
-			continue;
-		}
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct frag_cache *cache = CONTAINER_OF(dwork, struct frag_cache, timer);
 
-		cache[i].pkt = pkt;
-		cache[i].size = size;
-		cache[i].tag = tag;
-		cache[i].used = true;
+	k_mutex_lock(&cache_lock, K_FOREVER);
 
-		k_work_init_delayable(&cache[i].timer, reass_timeout);
-		k_work_reschedule(&cache[i].timer, FRAG_REASSEMBLY_TIMEOUT);
-		return &cache[i];
+	if (cache->used) {
+		NET_DBG("Reassembly of datagram tag %u timed out", cache->tag);
+		clear_reass_cache(cache);
 	}
 
-	return NULL;
+	k_mutex_unlock(&cache_lock);
 }
 
 /**
- *  Return cache if it matches with size and tag of stored caches,
- *  otherwise return NULL.
+ *  Upon reception of first fragment with respective of size and tag
+ *  create a new cache and allocate the buffer of the whole datagram.
+ *  If number of unused cache are out then discard the fragments.
  */
-static inline struct frag_cache *get_reass_cache(uint16_t size, uint16_t tag)
+static struct frag_cache *set_reass_cache(struct net_pkt *pkt, uint16_t size, uint16_t tag)
 {
-	uint8_t i;
-
-	for (i = 0U; i < REASS_CACHE_SIZE; i++) {
-		if (cache[i].used) {
-			if (cache[i].size == size && cache[i].tag == tag) {
-				return &cache[i];
-			}
-		}
+	struct net_linkaddr *src = net_pkt_lladdr_src(pkt);
+	struct frag_cache *cache;
+	sa_family_t family;
+	struct net_buf *buf;
+	size_t remaining;
+	sys_snode_t *node;
+	int ret;
+
+	node = sys_slist_get(&cache_free);
+	if (!node) {
+		return NULL;
 	}
 
-	return NULL;
-}
+	cache = CONTAINER_OF(node, struct frag_cache, node);
 
-static inline void fragment_append(struct net_pkt *pkt, struct net_buf *frag)
-{
-	if (get_datagram_type(frag->data) == NET_6LO_DISPATCH_FRAG1) {
-		/* Always make sure first fragment is inserted first
-		 * This will be useful for fragment_cached_pkt_len()
-		 */
-		frag->frags = pkt->buffer;
-		pkt->buffer = frag;
-	} else {
-		net_pkt_append_buffer(pkt, frag);
-	}
-}
+	family = net_pkt_family(pkt);
+	net_pkt_set_family(pkt, AF_UNSPEC);
+	ret = net_pkt_alloc_buffer(pkt, REASS_HDR_ROOM + size, 0, BUF_TIMEOUT);
+	net_pkt_set_family(pkt, family);
 
-static inline size_t fragment_cached_pkt_len(struct net_pkt *pkt)
-{
-	size_t len = 0U;
-	struct net_buf *frag;
-	int hdr_len;
-	uint8_t *data;
-
-	frag = pkt->buffer;
-	while (frag) {
-		uint16_t hdr_len = NET_6LO_FRAGN_HDR_LEN;
+	if (ret < 0) {
+		NET_DBG("Cannot allocate %u bytes for reassembly", size);
+		sys_slist_prepend(&cache_free, node);
+		return NULL;
+	}
 
-		if (get_datagram_type(frag->data) == NET_6LO_DISPATCH_FRAG1) {
-			hdr_len = NET_6LO_FRAG1_HDR_LEN;
-		}
+	for (buf = pkt->buffer, remaining = REASS_HDR_ROOM + size; buf && remaining;
+	     buf = buf->frags) {
+		size_t len = MIN(net_buf_tailroom(buf), remaining);
 
-		len += frag->len - hdr_len;
+		net_buf_add(buf, len);
+		remaining -= len;
+	}
 
-		frag = frag->frags;
+	cache->pkt = pkt;
+	cache->size = size;
+	cache->tag = tag;
+	cache->received = 0U;
+	cache->frag1_pos = -1;
+	cache->used = true;
+	cache->src.type = src->type;
+	cache->src.len = MIN(src->len, sizeof(cache->src.addr));
+	if (cache->src.len) {
+		memcpy(cache->src.addr, src->addr, cache->src.len);
 	}
+	memset(cache->units, 0, sizeof(cache->units));
 
-	/* 6lo assumes that fragment header has been removed,
-	 * and in our side we assume first buffer is always the first fragment.
-	 */
-	data = pkt->buffer->data;
-	pkt->buffer->data += NET_6LO_FRAG1_HDR_LEN;
+	cache->bucket = reass_bucket(src, size, tag);
+	sys_slist_prepend(cache->bucket, &cache->node);
 
-	hdr_len = net_6lo_uncompress_hdr_diff(pkt);
+	k_work_reschedule(&cache->timer, FRAG_REASSEMBLY_TIMEOUT);
 
-	pkt->buffer->data = data;
+	return cache;
+}
 
-	if (hdr_len == INT_MAX) {
-		return 0;
+/**
+ *  Return cache if it matches with sender, size and tag of stored caches,
+ *  otherwise return NULL.
+ */
+static inline struct frag_cache *get_reass_cache(struct net_linkaddr *src, uint16_t size,
+						 uint16_t tag)
+{
+	struct frag_cache *cache;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(reass_bucket(src, size, tag), cache, node) {
+		if (cache->size == size && cache->tag == tag &&
+		    cache->src.len == src->len &&
+		    (src->len == 0U || !memcmp(cache->src.addr, src->addr, src->len))) {
+			return cache;
+		}
 	}
 
-	return len + hdr_len;
+	return NULL;
 }
 
 static inline uint16_t fragment_offset(struct net_buf *frag)
@@ -401,88 +439,85 @@ static inline uint16_t fragment_offset(struct net_buf *frag)
 	return ((uint16_t)frag->data[NET_FRAG_OFFSET_POS] << 3);
 }
 
-static void fragment_move_back(struct net_pkt *pkt, struct net_buf *frag, struct net_buf *stop)
+/**
+ *  Mark the 8 octet units of the datagram covered by a fragment as received.
+ *  Return false if some of them were already received, in which case the
+ *  fragment is a duplicate or overlaps another one.
+ */
+static bool fragment_mark_received(struct frag_cache *cache, uint16_t offset, uint16_t len)
 {
-	struct net_buf *prev, *current;
-
-	prev = NULL;
-	current = pkt->buffer;
+	uint16_t first = offset >> 3;
+	uint16_t last = (offset + len - 1) >> 3;
+	uint16_t unit;
 
-	while (current && current != stop) {
-		if (fragment_offset(frag) < fragment_offset(current)) {
-			if (prev) {
-				prev->frags = frag;
-			}
-
-			frag->frags = current;
-			break;
+	for (unit = first; unit <= last; unit++) {
+		if (cache->units[unit / 32] & BIT(unit % 32)) {
+			return false;
 		}
+	}
 
-		prev = current;
-		current = current->frags;
+	for (unit = first; unit <= last; unit++) {
+		cache->units[unit / 32] |= BIT(unit % 32);
 	}
+
+	return true;
 }
 
-static inline void fragment_remove_headers(struct net_pkt *pkt)
+static void fragment_keep_lladdr(struct net_linkaddr *addr, uint8_t *room)
 {
-	struct net_buf *frag;
-
-	frag = pkt->buffer;
-	while (frag) {
-		uint16_t hdr_len = NET_6LO_FRAGN_HDR_LEN;
-
-		if (get_datagram_type(frag->data) == NET_6LO_DISPATCH_FRAG1) {
-			hdr_len = NET_6LO_FRAG1_HDR_LEN;
-		}
-
-		memmove(frag->data, frag->data + hdr_len, frag->len - hdr_len);
-		frag->len -= hdr_len;
-
-		frag = frag->frags;
+	if (addr->addr && addr->len <= NET_LINK_ADDR_MAX_LENGTH) {
+		memcpy(room, addr->addr, addr->len);
+		addr->addr = room;
 	}
 }
 
-static inline void fragment_reconstruct_packet(struct net_pkt *pkt)
+/**
+ *  Copy the fragment payload, without the fragment header, to its place in
+ *  the reassemble buffer.
+ */
+static int fragment_copy(struct net_pkt *reass, struct net_buf *frag, uint16_t hdr_len,
+			 uint16_t pos)
 {
-	struct net_buf *prev, *current, *next;
+	bool overwrite = net_pkt_is_being_overwritten(reass);
+	int ret;
 
-	prev = NULL;
-	current = pkt->buffer;
+	net_pkt_set_overwrite(reass, true);
+	net_pkt_cursor_init(reass);
 
-	while (current) {
-		next = current->frags;
+	ret = net_pkt_skip(reass, pos);
 
-		if (!prev || (fragment_offset(prev) > fragment_offset(current))) {
-			prev = current;
-		} else {
-			fragment_move_back(pkt, current, prev);
-		}
-
-		current = next;
+	while (frag && ret == 0) {
+		ret = net_pkt_write(reass, frag->data + hdr_len, frag->len - hdr_len);
+		frag = frag->frags;
+		hdr_len = 0U;
 	}
 
-	/* Let's remove now useless fragmentation headers */
-	fragment_remove_headers(pkt);
-}
+	net_pkt_cursor_init(reass);
+	net_pkt_set_overwrite(reass, overwrite);
 
-static inline bool fragment_packet_valid(struct net_pkt *pkt)
-{
-	return (get_datagram_type(pkt->buffer->data) == NET_6LO_DISPATCH_FRAG1);
+	return ret;
 }
 
 /**
  *  Parse size and tag from the fragment, check if we have any cache
  *  related to it. If not create a new cache.
- *  Remove the fragmentation header and uncompress IPv6 and related headers.
- *  Cache Rx part of fragment along with data buf for the first fragment
- *  in the cache, remaining fragments just cache data fragment, unref
- *  RX pkt. So in both the cases caller can assume packet is consumed.
+ *  Copy the fragment data into the datagram buffer of the cache. The Rx pkt
+ *  of the first received fragment is kept in the cache, the Rx pkt of the
+ *  other fragments is unref'd. So in both the cases caller can assume
+ *  packet is consumed. When all the fragments have been received, the
+ *  datagram is uncompressed and returned in the Rx pkt of the last one.
  */
 static inline enum net_verdict fragment_add_to_cache(struct net_pkt *pkt)
 {
 	bool first_frag = false;
 	struct frag_cache *cache;
+	struct net_pkt *reass;
 	struct net_buf *frag;
+	uint16_t hdr_len;
+	uint16_t offset;
+	int16_t frag1_pos;
+	size_t data_len;
+	int span, pos;
 	uint16_t size;
 	uint16_t tag;
 	uint8_t type;
@@ -490,7 +525,8 @@ static inline enum net_verdict fragment_add_to_cache(struct net_pkt *pkt)
 	frag = pkt->buffer;
 	type = get_datagram_type(frag->data);
 
-	if ((type == NET_6LO_DISPATCH_FRAG1 && frag->len < NET_6LO_FRAG1_HDR_LEN) ||
+	if ((type != NET_6LO_DISPATCH_FRAG1 && type != NET_6LO_DISPATCH_FRAGN) ||
+	    (type == NET_6LO_DISPATCH_FRAG1 && frag->len < NET_6LO_FRAG1_HDR_LEN) ||
 	    (type == NET_6LO_DISPATCH_FRAGN && frag->len < NET_6LO_FRAGN_HDR_LEN)) {
 		return NET_DROP;
 	}
@@ -501,15 +537,51 @@ static inline enum net_verdict fragment_add_to_cache(struct net_pkt *pkt)
 	/* Parse the datagram tag */
 	tag = get_datagram_tag(frag->data + NET_6LO_FRAG_DATAGRAM_SIZE_LEN);
 
-	/* If there are no fragments in the cache means this frag
-	 * is the first one. So cache Rx pkt otherwise not.
-	 */
-	pkt->buffer = NULL;
+	hdr_len = type == NET_6LO_DISPATCH_FRAG1 ? NET_6LO_FRAG1_HDR_LEN : NET_6LO_FRAGN_HDR_LEN;
+	offset = fragment_offset(frag);
+	data_len = net_pkt_get_len(pkt) - hdr_len;
+
+	if (type == NET_6LO_DISPATCH_FRAG1) {
+		int hdr_diff;
 
-	cache = get_reass_cache(size, tag);
+		/* 6lo assumes that fragment header has been removed */
+		frag->data += NET_6LO_FRAG1_HDR_LEN;
+		hdr_diff = net_6lo_uncompress_hdr_diff(pkt);
+		frag->data -= NET_6LO_FRAG1_HDR_LEN;
+
+		if (hdr_diff == INT_MAX) {
+			return NET_DROP;
+		}
+
+		/* The compressed headers are placed so that they end where
+		 * the uncompressed ones would, the gap is removed later.
+		 */
+		span = data_len + hdr_diff;
+		pos = REASS_HDR_ROOM + hdr_diff;
+	} else {
+		span = data_len;
+		pos = REASS_HDR_ROOM + offset;
+	}
+
+	if (size > DATAGRAM_MAX_SIZE || span <= 0 || offset + span > size) {
+		NET_DBG("Invalid fragment offset %u len %d size %u", offset, span, size);
+		return NET_DROP;
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	if (!cache_init_done) {
+		reass_cache_init();
+	}
+
+	cache = get_reass_cache(net_pkt_lladdr_src(pkt), size, tag);
 	if (!cache) {
+		/* Detach the fragment, the packet gets the datagram buffer */
+		pkt->buffer = NULL;
+
 		cache = set_reass_cache(pkt, size, tag);
 		if (!cache) {
+			k_mutex_unlock(&cache_lock);
 			NET_ERR("Could not get a cache entry");
 			pkt->buffer = frag;
 			return NET_DROP;
@@ -518,51 +590,108 @@ static inline enum net_verdict fragment_add_to_cache(struct net_pkt *pkt)
 		first_frag = true;
 	}
 
-	fragment_append(cache->pkt, frag);
+	if (!fragment_mark_received(cache, offset, span)) {
+		k_mutex_unlock(&cache_lock);
+		NET_DBG("Duplicate or overlapping fragment dropped");
+		return NET_DROP;
+	}
 
-	if (fragment_cached_pkt_len(cache->pkt) == cache->size) {
-		if (!first_frag) {
-			/* Assign buffer back to input packet. */
-			pkt->buffer = cache->pkt->buffer;
-			cache->pkt->buffer = NULL;
-		} else {
-			/* in case pkt == cache->pkt, we don't want
-			 * to unref it while clearing the cach.
-			 */
+	if (fragment_copy(cache->pkt, frag, hdr_len, pos) < 0) {
+		NET_ERR("Could not copy the fragment");
+
+		if (first_frag) {
+			/* pkt is unref'd by the caller */
 			cache->pkt = NULL;
+			net_pkt_frag_unref(pkt->buffer);
+			pkt->buffer = frag;
 		}
 
-		clear_reass_cache(size, tag);
+		clear_reass_cache(cache);
+		k_mutex_unlock(&cache_lock);
 
-		if (!fragment_packet_valid(pkt)) {
-			NET_ERR("Invalid fragmented packet");
-			return NET_DROP;
-		}
+		return NET_DROP;
+	}
 
-		fragment_reconstruct_packet(pkt);
+	if (type == NET_6LO_DISPATCH_FRAG1) {
+		cache->frag1_pos = pos;
+	}
 
-		if (!net_6lo_uncompress(pkt)) {
-			NET_ERR("Could not uncompress. Bogus packet?");
-			return NET_DROP;
+	cache->received += span;
+
+	/* The link layer addresses of the packet that completes the
+	 * datagram point to the fragment, move them to the datagram buffer.
+	 */
+	if (cache->received == cache->size) {
+		fragment_keep_lladdr(net_pkt_lladdr_src(pkt), cache->pkt->buffer->data);
+		fragment_keep_lladdr(net_pkt_lladdr_dst(pkt),
+				     cache->pkt->buffer->data + NET_LINK_ADDR_MAX_LENGTH);
+	}
+
+	/* The fragment data is no longer needed */
+	if (!first_frag) {
+		pkt->buffer = NULL;
+	}
+
+	net_buf_unref(frag);
+
+	if (cache->received < cache->size) {
+		k_mutex_unlock(&cache_lock);
+
+		/* Unref Rx part of original packet */
+		if (!first_frag) {
+			net_pkt_unref(pkt);
 		}
 
-		net_pkt_cursor_init(pkt);
+		return NET_OK;
+	}
 
-		update_protocol_header_lengths(pkt, size);
+	reass = cache->pkt;
+	frag1_pos = cache->frag1_pos;
 
-		net_pkt_cursor_init(pkt);
+	/* in case pkt == cache->pkt, we don't want to unref it while
+	 * clearing the cache.
+	 */
+	cache->pkt = NULL;
+	clear_reass_cache(cache);
 
-		NET_DBG("All fragments received and reassembled");
+	k_mutex_unlock(&cache_lock);
 
-		return NET_CONTINUE;
+	if (reass != pkt) {
+		/* Assign the datagram buffer to input packet. */
+		pkt->buffer = reass->buffer;
+		reass->buffer = NULL;
+		net_pkt_unref(reass);
 	}
 
-	/* Unref Rx part of original packet */
-	if (!first_frag) {
-		net_pkt_unref(pkt);
+	if (frag1_pos < 0) {
+		NET_ERR("Invalid fragmented packet");
+		return NET_DROP;
+	}
+
+	/* Remove the room in front of the compressed headers, the link
+	 * layer addresses stay in the headroom of the buffer.
+	 */
+	if (frag1_pos >= pkt->buffer->len) {
+		NET_ERR("Reassembly buffer too small");
+		return NET_DROP;
 	}
 
-	return NET_OK;
+	net_buf_pull(pkt->buffer, frag1_pos);
+
+	if (!net_6lo_uncompress(pkt)) {
+		NET_ERR("Could not uncompress. Bogus packet?");
+		return NET_DROP;
+	}
+
+	net_pkt_cursor_init(pkt);
+
+	update_protocol_header_lengths(pkt, size);
+
+	net_pkt_cursor_init(pkt);
+
+	NET_DBG("All fragments received and reassembled");
+
+	return NET_CONTINUE;
 }
 
 enum net_verdict ieee802154_6lo_reassemble(struct net_pkt *pkt)
@@ -499,7 +499,8 @@ static int capture_disable(const struct device *dev)
 	return 0;
 }
 
-void net_capture_pkt(struct net_if *iface, struct net_pkt *pkt)
+void net_capture_pkt_with_dir(struct net_if *iface, struct net_pkt *pkt,
+			      enum net_capture_dir dir)
 {
 	struct k_mem_slab *orig_slab;
 	struct net_pkt *captured;
@@ -512,6 +513,9 @@ void net_capture_pkt(struct net_if *iface, struct net_pkt *pkt)
 		return;
 	}
 
+	/* The local capture does not take the lock below */
+	net_capture_local_pkt(iface, pkt, dir);
+
 	k_mutex_lock(&lock, K_FOREVER);
 
 	SYS_SLIST_FOR_EACH_NODE_SAFE(&net_capture_devlist, sn, sns) {
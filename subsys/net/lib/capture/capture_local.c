@@ -0,0 +1,507 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_capture, CONFIG_NET_CAPTURE_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <zephyr/kernel_structs.h>
+#include <zephyr/sys/mpsc_pbuf.h>
+#include <zephyr/net/net_core.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/net_l2.h>
+#include <zephyr/net/capture.h>
+
+#if defined(CONFIG_FILE_SYSTEM)
+#include <zephyr/fs/fs.h>
+#endif
+
+/* pcapng block types and link types, see
+ * https://www.ietf.org/archive/id/draft-ietf-opsawg-pcapng-01.html
+ */
+#define PCAPNG_SHB_TYPE 0x0A0D0D0A
+#define PCAPNG_IDB_TYPE 0x00000001
+#define PCAPNG_EPB_TYPE 0x00000006
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4D
+#define PCAPNG_OPT_ENDOFOPT 0
+#define PCAPNG_OPT_EPB_FLAGS 2
+
+#define LINKTYPE_ETHERNET 1
+#define LINKTYPE_RAW 101
+#define LINKTYPE_IEEE802_15_4_NOFCS 230
+
+#define RING_WLEN (CONFIG_NET_CAPTURE_LOCAL_RING_SIZE / sizeof(uint32_t))
+#define RING_COUNT CONFIG_MP_MAX_NUM_CPUS
+
+struct pcapng_shb {
+	uint32_t block_type;
+	uint32_t block_len;
+	uint32_t magic;
+	uint16_t major;
+	uint16_t minor;
+	int64_t section_len;
+	uint32_t block_len_end;
+} __packed;
+
+struct pcapng_idb {
+	uint32_t block_type;
+	uint32_t block_len;
+	uint16_t link_type;
+	uint16_t reserved;
+	uint32_t snaplen;
+	uint32_t block_len_end;
+} __packed;
+
+struct pcapng_epb {
+	uint32_t block_type;
+	uint32_t block_len;
+	uint32_t interface_id;
+	uint32_t ts_high;
+	uint32_t ts_low;
+	uint32_t cap_len;
+	uint32_t orig_len;
+} __packed;
+
+struct pcapng_epb_end {
+	uint16_t flags_code;
+	uint16_t flags_len;
+	uint32_t flags;
+	uint32_t endofopt;
+	uint32_t block_len;
+} __packed;
+
+/* Packet stored in the capture ring, the data follows the header */
+struct capture_record {
+	MPSC_PBUF_HDR;
+	uint32_t wlen : 12;
+	uint32_t dir : 2;
+	uint32_t reserved : 16;
+	uint16_t ifindex;
+	uint16_t cap_len;
+	uint32_t orig_len;
+	uint32_t ts_high;
+	uint32_t ts_low;
+	uint8_t data[];
+};
+
+#define RECORD_WLEN(cap_len) \
+	DIV_ROUND_UP(sizeof(struct capture_record) + (cap_len), sizeof(uint32_t))
+
+/* The wlen field is 12 bits and a record must fit easily into a ring */
+BUILD_ASSERT(RECORD_WLEN(CONFIG_NET_CAPTURE_LOCAL_SNAPLEN) < BIT(12));
+
+static uint32_t ring_storage[RING_COUNT][RING_WLEN];
+static struct mpsc_pbuf_buffer rings[RING_COUNT];
+
+static struct {
+	struct net_if *iface;
+	size_t snaplen;
+	atomic_t active;
+	atomic_t captured;
+	atomic_t dropped;
+	atomic_t drained;
+	bool initialized;
+} local;
+
+/* Serializes start / stop and the draining of the rings */
+static K_MUTEX_DEFINE(local_lock);
+
+static uint32_t record_get_wlen(const union mpsc_pbuf_generic *packet)
+{
+	const struct capture_record *rec = (const struct capture_record *)packet;
+
+	return rec->wlen;
+}
+
+static inline struct mpsc_pbuf_buffer *local_ring(void)
+{
+#if defined(CONFIG_SMP)
+	return &rings[arch_curr_cpu()->id];
+#else
+	return &rings[0];
+#endif
+}
+
+static void rings_init(void)
+{
+	struct mpsc_pbuf_buffer_config config = {
+		.size = RING_WLEN,
+		.get_wlen = record_get_wlen,
+		.flags = IS_POWER_OF_TWO(RING_WLEN) ? MPSC_PBUF_SIZE_POW2 : 0,
+	};
+
+	for (int i = 0; i < RING_COUNT; i++) {
+		config.buf = ring_storage[i];
+		mpsc_pbuf_init(&rings[i], &config);
+	}
+
+	local.initialized = true;
+}
+
+void net_capture_local_pkt(struct net_if *iface, struct net_pkt *pkt,
+			   enum net_capture_dir dir)
+{
+	struct mpsc_pbuf_buffer *ring;
+	struct net_pkt_cursor backup;
+	struct capture_record *rec;
+	size_t len, cap_len;
+	bool overwrite;
+	uint64_t ts;
+
+	if (!atomic_get(&local.active)) {
+		return;
+	}
+
+	if (local.iface != NULL && local.iface != iface) {
+		return;
+	}
+
+	if (!net_pkt_filter_capture_ok(pkt)) {
+		return;
+	}
+
+	len = net_pkt_get_len(pkt);
+	cap_len = MIN(len, local.snaplen);
+	ring = local_ring();
+
+	rec = (struct capture_record *)mpsc_pbuf_alloc(ring, RECORD_WLEN(cap_len),
+						       K_NO_WAIT);
+	if (rec == NULL) {
+		atomic_inc(&local.dropped);
+		return;
+	}
+
+	ts = k_ticks_to_us_floor64(k_uptime_ticks());
+
+	rec->wlen = RECORD_WLEN(cap_len);
+	rec->dir = dir;
+	rec->ifindex = net_if_get_by_iface(iface);
+	rec->cap_len = cap_len;
+	rec->orig_len = len;
+	rec->ts_high = (uint32_t)(ts >> 32);
+	rec->ts_low = (uint32_t)ts;
+
+	overwrite = net_pkt_is_being_overwritten(pkt);
+	net_pkt_cursor_backup(pkt, &backup);
+	net_pkt_set_overwrite(pkt, true);
+	net_pkt_cursor_init(pkt);
+
+	if (net_pkt_read(pkt, rec->data, cap_len) < 0) {
+		rec->cap_len = 0;
+	}
+
+	net_pkt_cursor_restore(pkt, &backup);
+	net_pkt_set_overwrite(pkt, overwrite);
+
+	mpsc_pbuf_commit(ring, (union mpsc_pbuf_generic *)rec);
+
+	atomic_inc(&local.captured);
+}
+
+int net_capture_local_start(struct net_if *iface, size_t snaplen)
+{
+	if (snaplen == 0) {
+		snaplen = CONFIG_NET_CAPTURE_LOCAL_SNAPLEN;
+	}
+
+	if (RECORD_WLEN(snaplen) >= MIN(BIT(12), RING_WLEN / 2)) {
+		NET_DBG("Snap length %zu too large", snaplen);
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&local_lock, K_FOREVER);
+
+	if (atomic_get(&local.active)) {
+		k_mutex_unlock(&local_lock);
+		return -EALREADY;
+	}
+
+	if (!local.initialized) {
+		rings_init();
+	}
+
+	local.iface = iface;
+	local.snaplen = snaplen;
+	atomic_clear(&local.captured);
+	atomic_clear(&local.dropped);
+	atomic_clear(&local.drained);
+
+	atomic_set(&local.active, 1);
+
+	k_mutex_unlock(&local_lock);
+
+	NET_DBG("Local capture started on iface %d snaplen %zu",
+		iface ? net_if_get_by_iface(iface) : 0, snaplen);
+
+	return 0;
+}
+
+int net_capture_local_stop(void)
+{
+	if (!atomic_cas(&local.active, 1, 0)) {
+		return -EALREADY;
+	}
+
+	NET_DBG("Local capture stopped, %u packets captured %u dropped",
+		(uint32_t)atomic_get(&local.captured),
+		(uint32_t)atomic_get(&local.dropped));
+
+	return 0;
+}
+
+bool net_capture_local_get_stats(struct net_capture_local_stats *stats,
+				 size_t *snaplen)
+{
+	stats->captured = (uint32_t)atomic_get(&local.captured);
+	stats->dropped = (uint32_t)atomic_get(&local.dropped);
+	stats->drained = (uint32_t)atomic_get(&local.drained);
+
+	if (snaplen != NULL) {
+		*snaplen = local.snaplen;
+	}
+
+	return atomic_get(&local.active) != 0;
+}
+
+static uint16_t iface_link_type(struct net_if *iface)
+{
+#if defined(CONFIG_NET_L2_ETHERNET)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(ETHERNET)) {
+		return LINKTYPE_ETHERNET;
+	}
+#endif
+
+#if defined(CONFIG_NET_L2_IEEE802154)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(IEEE802154)) {
+		return LINKTYPE_IEEE802_15_4_NOFCS;
+	}
+#endif
+
+	/* Other L2s pass IP packets without a link layer header */
+	return LINKTYPE_RAW;
+}
+
+struct header_data {
+	net_capture_write_cb_t cb;
+	void *user_data;
+	int ret;
+};
+
+static void write_idb(struct net_if *iface, void *user_data)
+{
+	struct header_data *data = user_data;
+	struct pcapng_idb idb = {
+		.block_type = PCAPNG_IDB_TYPE,
+		.block_len = sizeof(idb),
+		.link_type = iface_link_type(iface),
+		.snaplen = local.snaplen,
+		.block_len_end = sizeof(idb),
+	};
+
+	if (data->ret < 0) {
+		return;
+	}
+
+	data->ret = data->cb(&idb, sizeof(idb), data->user_data);
+}
+
+int net_capture_local_write_header(net_capture_write_cb_t cb, void *user_data)
+{
+	struct pcapng_shb shb = {
+		.block_type = PCAPNG_SHB_TYPE,
+		.block_len = sizeof(shb),
+		.magic = PCAPNG_BYTE_ORDER_MAGIC,
+		.major = 1,
+		.minor = 0,
+		.section_len = -1,
+		.block_len_end = sizeof(shb),
+	};
+	struct header_data data = {
+		.cb = cb,
+		.user_data = user_data,
+	};
+
+	data.ret = cb(&shb, sizeof(shb), user_data);
+	if (data.ret < 0) {
+		return data.ret;
+	}
+
+	/* The interface ids of the packet blocks are the interface indexes
+	 * minus one, so every interface gets a description block.
+	 */
+	net_if_foreach(write_idb, &data);
+
+	return data.ret;
+}
+
+static int write_epb(const struct capture_record *rec,
+		     net_capture_write_cb_t cb, void *user_data)
+{
+	static const uint8_t padding[sizeof(uint32_t)];
+	size_t pad_len = ROUND_UP(rec->cap_len, sizeof(uint32_t)) - rec->cap_len;
+	uint32_t block_len = sizeof(struct pcapng_epb) + rec->cap_len + pad_len +
+			     sizeof(struct pcapng_epb_end);
+	struct pcapng_epb epb = {
+		.block_type = PCAPNG_EPB_TYPE,
+		.block_len = block_len,
+		.interface_id = rec->ifindex - 1,
+		.ts_high = rec->ts_high,
+		.ts_low = rec->ts_low,
+		.cap_len = rec->cap_len,
+		.orig_len = rec->orig_len,
+	};
+	struct pcapng_epb_end end = {
+		.flags_code = PCAPNG_OPT_EPB_FLAGS,
+		.flags_len = sizeof(uint32_t),
+		.flags = rec->dir,
+		.endofopt = PCAPNG_OPT_ENDOFOPT,
+		.block_len = block_len,
+	};
+	int ret;
+
+	ret = cb(&epb, sizeof(epb), user_data);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (rec->cap_len > 0) {
+		ret = cb(rec->data, rec->cap_len, user_data);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	if (pad_len > 0) {
+		ret = cb(padding, pad_len, user_data);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return cb(&end, sizeof(end), user_data);
+}
+
+static inline uint64_t record_ts(const struct capture_record *rec)
+{
+	return ((uint64_t)rec->ts_high << 32) | rec->ts_low;
+}
+
+int net_capture_local_drain(net_capture_write_cb_t cb, void *user_data)
+{
+	const struct capture_record *head[RING_COUNT];
+	int count = 0;
+	int ret = 0;
+
+	k_mutex_lock(&local_lock, K_FOREVER);
+
+	if (!local.initialized) {
+		goto out;
+	}
+
+	for (int i = 0; i < RING_COUNT; i++) {
+		head[i] = (const struct capture_record *)mpsc_pbuf_claim(&rings[i]);
+	}
+
+	/* Each ring is in timestamp order, so merging the heads of the rings
+	 * gives the packets of all the CPUs in timestamp order.
+	 */
+	while (true) {
+		int next = -1;
+
+		for (int i = 0; i < RING_COUNT; i++) {
+			if (head[i] == NULL) {
+				continue;
+			}
+
+			if (next < 0 || record_ts(head[i]) < record_ts(head[next])) {
+				next = i;
+			}
+		}
+
+		if (next < 0) {
+			break;
+		}
+
+		ret = write_epb(head[next], cb, user_data);
+
+		mpsc_pbuf_free(&rings[next], (const union mpsc_pbuf_generic *)head[next]);
+		head[next] = NULL;
+
+		if (ret < 0) {
+			break;
+		}
+
+		count++;
+		head[next] = (const struct capture_record *)mpsc_pbuf_claim(&rings[next]);
+	}
+
+	for (int i = 0; i < RING_COUNT; i++) {
+		if (head[i] != NULL) {
+			mpsc_pbuf_free(&rings[i], (const union mpsc_pbuf_generic *)head[i]);
+		}
+	}
+
+	atomic_add(&local.drained, count);
+
+out:
+	k_mutex_unlock(&local_lock);
+
+	return ret < 0 ? ret : count;
+}
+
+#if defined(CONFIG_FILE_SYSTEM)
+static int file_write(const void *data, size_t len, void *user_data)
+{
+	struct fs_file_t *file = user_data;
+	ssize_t ret;
+
+	ret = fs_write(file, data, len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return ret == len ? 0 : -ENOSPC;
+}
+
+int net_capture_local_save(const char *path)
+{
+	struct fs_file_t file;
+	off_t offset;
+	int ret;
+
+	fs_file_t_init(&file);
+
+	ret = fs_open(&file, path, FS_O_CREATE | FS_O_WRITE | FS_O_APPEND);
+	if (ret < 0) {
+		NET_DBG("Cannot open %s (%d)", path, ret);
+		return ret;
+	}
+
+	ret = fs_seek(&file, 0, FS_SEEK_END);
+	if (ret < 0) {
+		goto out;
+	}
+
+	offset = fs_tell(&file);
+	if (offset < 0) {
+		ret = offset;
+		goto out;
+	}
+
+	if (offset == 0) {
+		ret = net_capture_local_write_header(file_write, &file);
+		if (ret < 0) {
+			goto out;
+		}
+	}
+
+	ret = net_capture_local_drain(file_write, &file);
+
+out:
+	fs_close(&file);
+
+	return ret;
+}
+#endif /* CONFIG_FILE_SYSTEM */
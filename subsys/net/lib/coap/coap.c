@@ -52,6 +52,16 @@ static uint16_t message_id;
 static int insert_option(struct coap_packet *cpkt, uint16_t code, const uint8_t *value,
 			 uint16_t len);
 
+static inline void coap_option_index_clear(struct coap_packet *cpkt)
+{
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	cpkt->options = NULL;
+	cpkt->opt_count = 0U;
+#else
+	ARG_UNUSED(cpkt);
+#endif
+}
+
 static inline void encode_u8(struct coap_packet *cpkt, uint16_t offset, uint8_t data)
 {
 	cpkt->data[offset] = data;
@@ -325,6 +335,8 @@ int coap_packet_append_option(struct coap_packet *cpkt, uint16_t code,
 		return -EINVAL;
 	}
 
+	coap_option_index_clear(cpkt);
+
 	if (code < cpkt->delta) {
 		NET_DBG("Option is not added in ascending order");
 		return insert_option(cpkt, code, value, len);
@@ -613,6 +625,7 @@ int coap_packet_parse(struct coap_packet *cpkt, uint8_t *data, uint16_t len,
 	uint16_t delta;
 	uint8_t num;
 	uint8_t tkl;
+	bool indexed;
 	int ret;
 
 	if (!cpkt || !data) {
@@ -633,6 +646,7 @@ int coap_packet_parse(struct coap_packet *cpkt, uint8_t *data, uint16_t len,
 	cpkt->opt_len = 0U;
 	cpkt->hdr_len = 0U;
 	cpkt->delta = 0U;
+	coap_option_index_clear(cpkt);
 
 	/* Token lengths 9-15 are reserved. */
 	tkl = cpkt->data[0] & 0x0f;
@@ -653,16 +667,30 @@ int coap_packet_parse(struct coap_packet *cpkt, uint8_t *data, uint16_t len,
 	opt_len = 0U;
 	delta = 0U;
 	num = 0U;
+	indexed = options != NULL;
 
 	while (1) {
 		struct coap_option *option;
+		uint16_t prev_opt_len = opt_len;
 
 		option = num < opt_num ? &options[num++] : NULL;
 		ret = parse_option(cpkt->data, offset, &offset, cpkt->max_len,
 				   &delta, &opt_len, option);
 		if (ret < 0) {
 			return -EILSEQ;
-		} else if (ret == 0) {
+		}
+
+		if (opt_len == prev_opt_len) {
+			/* The payload marker, nothing was read into the entry */
+			if (option) {
+				num--;
+			}
+		} else if (!option) {
+			/* Not all the options fit in the array */
+			indexed = false;
+		}
+
+		if (ret == 0) {
 			break;
 		}
 	}
@@ -670,6 +698,15 @@ int coap_packet_parse(struct coap_packet *cpkt, uint8_t *data, uint16_t len,
 	cpkt->opt_len = opt_len;
 	cpkt->delta = delta;
 
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	if (indexed) {
+		cpkt->options = options;
+		cpkt->opt_count = num;
+	}
+#else
+	ARG_UNUSED(indexed);
+#endif
+
 	return 0;
 }
 
@@ -682,6 +719,25 @@ int coap_find_options(const struct coap_packet *cpkt, uint16_t code,
 	uint8_t num;
 	int r;
 
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	if (cpkt->options) {
+		uint8_t i;
+
+		/* Options were parsed already, in ascending order */
+		for (i = 0U, num = 0U; i < cpkt->opt_count && num < veclen; i++) {
+			if (cpkt->options[i].delta > code) {
+				break;
+			}
+
+			if (cpkt->options[i].delta == code) {
+				options[num++] = cpkt->options[i];
+			}
+		}
+
+		return num;
+	}
+#endif
+
 	/* Check if there are options to parse */
 	if (cpkt->hdr_len == cpkt->max_len) {
 		return 0;
@@ -1051,6 +1107,8 @@ int insert_option(struct coap_packet *cpkt, uint16_t code, const uint8_t *value,
 	struct coap_option option;
 	int r;
 
+	coap_option_index_clear(cpkt);
+
 	while (offset < cpkt->hdr_len + cpkt->opt_len) {
 		r = parse_option(cpkt->data, offset, &offset, cpkt->hdr_len + cpkt->opt_len,
 				 &opt_delta, &opt_len, &option);
@@ -1241,6 +1299,294 @@ size_t coap_next_block(const struct coap_packet *cpkt,
 	return MAX(ret, 0);
 }
 
+static void block_stream_resize(struct coap_block_stream *stream)
+{
+	uint16_t bytes = coap_block_size_to_bytes(stream->block_size);
+	size_t slots = stream->config.buf ? stream->config.buf_len / bytes : 0;
+
+	stream->slots = MIN(slots, COAP_BLOCK_STREAM_MAX_WINDOW - 1);
+	stream->window = MIN(stream->config.window, stream->slots + 1);
+}
+
+/* Request the blocks of the window that are neither in flight nor received */
+static int block_stream_fill(struct coap_block_stream *stream)
+{
+	uint32_t limit = 1;
+	uint32_t rel;
+	int ret;
+
+	if (stream->negotiated && stream->last != UINT32_MAX) {
+		limit = MIN(stream->window, stream->last - stream->base + 1);
+	}
+
+	for (rel = 0; rel < limit; rel++) {
+		if ((stream->in_flight | stream->buffered) & BIT(rel)) {
+			continue;
+		}
+
+		ret = stream->config.request(stream, stream->base + rel);
+		if (ret < 0) {
+			return ret;
+		}
+
+		stream->in_flight |= BIT(rel);
+	}
+
+	return 0;
+}
+
+static int block_stream_deliver(struct coap_block_stream *stream, const uint8_t *data,
+				uint16_t len)
+{
+	bool last = stream->base == stream->last;
+	int ret;
+
+	ret = stream->config.sink(stream, data, len, stream->offset, last);
+	if (ret < 0) {
+		return ret;
+	}
+
+	stream->offset += len;
+	stream->base++;
+	stream->in_flight >>= 1;
+	stream->buffered >>= 1;
+	stream->retries = stream->config.max_retries;
+	stream->complete = last;
+
+	return 0;
+}
+
+static uint8_t *block_stream_slot(struct coap_block_stream *stream, uint32_t num)
+{
+	return stream->config.buf +
+	       (num % stream->slots) * coap_block_size_to_bytes(stream->block_size);
+}
+
+/* Returns true if a response for block num is awaited */
+static bool block_stream_awaited(const struct coap_block_stream *stream, uint32_t num)
+{
+	uint32_t rel = num - stream->base;
+
+	return num >= stream->base && rel < COAP_BLOCK_STREAM_MAX_WINDOW &&
+	       (stream->in_flight & BIT(rel));
+}
+
+static int block_stream_check_etag(struct coap_block_stream *stream,
+				   const struct coap_packet *response)
+{
+	struct coap_option etag;
+
+	if (coap_find_options(response, COAP_OPTION_ETAG, &etag, 1) != 1 ||
+	    etag.len > sizeof(stream->etag)) {
+		return 0;
+	}
+
+	if (!stream->negotiated) {
+		memcpy(stream->etag, etag.value, etag.len);
+		stream->etag_len = etag.len;
+		return 0;
+	}
+
+	if (etag.len != stream->etag_len || memcmp(etag.value, stream->etag, etag.len) != 0) {
+		NET_DBG("Resource changed during the transfer");
+		return -ESTALE;
+	}
+
+	return 0;
+}
+
+int coap_block_stream_init(struct coap_block_stream *stream,
+			   const struct coap_block_stream_config *config, size_t offset)
+{
+	uint16_t bytes;
+
+	if (!config->request || !config->sink || config->window == 0U) {
+		return -EINVAL;
+	}
+
+	memset(stream, 0, sizeof(*stream));
+
+	stream->config = *config;
+	stream->block_size = config->block_size;
+	stream->last = UINT32_MAX;
+	stream->retries = config->max_retries;
+
+	bytes = coap_block_size_to_bytes(stream->block_size);
+	stream->base = offset / bytes;
+	stream->offset = stream->base * bytes;
+
+	block_stream_resize(stream);
+
+	return 0;
+}
+
+int coap_block_stream_start(struct coap_block_stream *stream)
+{
+	return block_stream_fill(stream);
+}
+
+int coap_block_stream_append_option(const struct coap_block_stream *stream,
+				    struct coap_packet *cpkt, uint32_t num)
+{
+	unsigned int val = 0U;
+
+	SET_BLOCK_SIZE(val, stream->block_size);
+	SET_NUM(val, num);
+
+	return coap_append_option_int(cpkt, COAP_OPTION_BLOCK2, val);
+}
+
+int coap_block_stream_response(struct coap_block_stream *stream, uint32_t num,
+			       const struct coap_packet *response)
+{
+	uint8_t code = coap_header_get_code(response);
+	const uint8_t *payload;
+	uint16_t bytes, len;
+	int block, size, ret;
+
+	if (stream->complete) {
+		return 0;
+	}
+
+	if (!stream->negotiated) {
+		/* Only the first block is in flight until then, the block
+		 * size of the request may not be the one of the stream anymore.
+		 */
+		num = stream->base;
+	}
+
+	if (code != COAP_RESPONSE_CODE_CONTENT) {
+		if (!block_stream_awaited(stream, num)) {
+			return 0;
+		}
+
+		if ((code == COAP_RESPONSE_CODE_SERVICE_UNAVAILABLE ||
+		     code == COAP_RESPONSE_CODE_TOO_MANY_REQUESTS) && stream->window > 1U) {
+			NET_DBG("Parallel requests refused, going on one by one");
+			stream->config.window = 1U;
+			stream->window = 1U;
+			stream->in_flight &= ~BIT(num - stream->base);
+
+			return block_stream_fill(stream);
+		}
+
+		NET_DBG("Unexpected response code %d.%02d", code >> 5, code & 0x1f);
+
+		return -ENOMSG;
+	}
+
+	payload = coap_packet_get_payload(response, &len);
+
+	block = coap_get_option_int(response, COAP_OPTION_BLOCK2);
+	if (block < 0) {
+		/* The server sent the whole resource at once */
+		if (stream->negotiated || stream->offset != 0U) {
+			return -EPROTO;
+		}
+
+		stream->negotiated = true;
+		stream->last = stream->base;
+		stream->in_flight = 0U;
+
+		return block_stream_deliver(stream, payload, len);
+	}
+
+	if (!stream->negotiated) {
+		if (GET_BLOCK_SIZE(block) > stream->block_size) {
+			return -EPROTO;
+		}
+
+		/* The server may only pick a smaller block size, the offset
+		 * stays a multiple of it.
+		 */
+		stream->block_size = GET_BLOCK_SIZE(block);
+		stream->base = stream->offset / coap_block_size_to_bytes(stream->block_size);
+		block_stream_resize(stream);
+	} else if (GET_BLOCK_SIZE(block) != stream->block_size) {
+		return -EPROTO;
+	}
+
+	ret = block_stream_check_etag(stream, response);
+	if (ret < 0) {
+		return ret;
+	}
+
+	stream->negotiated = true;
+	bytes = coap_block_size_to_bytes(stream->block_size);
+
+	size = coap_get_option_int(response, COAP_OPTION_SIZE2);
+	if (size > 0 && stream->total_size == 0U) {
+		stream->total_size = size;
+		stream->last = (size - 1) / bytes;
+	}
+
+	num = GET_NUM(block);
+	if (!block_stream_awaited(stream, num)) {
+		NET_DBG("Duplicate block %u ignored", num);
+		return 0;
+	}
+
+	if (GET_MORE(block)) {
+		if (len != bytes || num >= stream->last) {
+			return -EPROTO;
+		}
+	} else {
+		if (len > bytes) {
+			return -EPROTO;
+		}
+
+		stream->last = num;
+		stream->last_len = len;
+	}
+
+	stream->in_flight &= ~BIT(num - stream->base);
+
+	if (num != stream->base) {
+		memcpy(block_stream_slot(stream, num), payload, len);
+		stream->buffered |= BIT(num - stream->base);
+
+		return block_stream_fill(stream);
+	}
+
+	ret = block_stream_deliver(stream, payload, len);
+
+	/* Then the blocks received ahead of it */
+	while (ret == 0 && !stream->complete && (stream->buffered & BIT(0))) {
+		ret = block_stream_deliver(stream, block_stream_slot(stream, stream->base),
+					   stream->base == stream->last ? stream->last_len : bytes);
+	}
+
+	if (ret < 0 || stream->complete) {
+		return ret;
+	}
+
+	return block_stream_fill(stream);
+}
+
+int coap_block_stream_lost(struct coap_block_stream *stream, uint32_t num)
+{
+	if (stream->complete) {
+		return 0;
+	}
+
+	if (!stream->negotiated) {
+		num = stream->base;
+	}
+
+	if (!block_stream_awaited(stream, num)) {
+		return 0;
+	}
+
+	if (stream->retries == 0U) {
+		return -ETIMEDOUT;
+	}
+
+	stream->retries--;
+	stream->in_flight &= ~BIT(num - stream->base);
+
+	return block_stream_fill(stream);
+}
+
 int coap_pending_init(struct coap_pending *pending,
 		      const struct coap_packet *request,
 		      const struct sockaddr *addr,
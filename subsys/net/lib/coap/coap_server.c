@@ -0,0 +1,1103 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_coap_server, CONFIG_COAP_SERVER_LOG_LEVEL);
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/net/coap.h>
+#include <zephyr/net/coap_service.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/sys/dlist.h>
+
+#define MAX_SERVICES CONFIG_COAP_SERVER_MAX_SERVICES
+#define MAX_OPTIONS CONFIG_COAP_SERVER_MESSAGE_OPTIONS
+#define TRIE_NODES CONFIG_COAP_SERVER_TRIE_NODES
+#define TIMER_SLOTS CONFIG_COAP_SERVER_TIMER_SLOTS
+#define TIMER_TICK_MS CONFIG_COAP_SERVER_TIMER_TICK_MS
+
+/* RFC 7252, section 4.8.2 */
+#define EXCHANGE_LIFETIME_MS (247 * MSEC_PER_SEC)
+
+#define TRIE_UNBUILT -1
+#define TRIE_LINEAR -2
+
+#if defined(CONFIG_NET_TC_THREAD_COOPERATIVE)
+#define THREAD_PRIORITY K_PRIO_COOP(CONFIG_NUM_COOP_PRIORITIES - 1)
+#else
+#define THREAD_PRIORITY K_PRIO_PREEMPT(CONFIG_NUM_PREEMPT_PRIORITIES - 1)
+#endif
+
+BUILD_ASSERT(TRIE_NODES <= INT16_MAX, "Trie node index does not fit");
+
+/* Poll array layout: the wake up socket, then the service sockets */
+#define FD_WAKE 0
+#define FD_SERVICES 1
+#define FD_COUNT (FD_SERVICES + MAX_SERVICES)
+
+/* A node per path segment, children are chained through their siblings */
+struct trie_node {
+	const char *segment;
+	struct coap_resource *resource;
+	int16_t child;
+	int16_t sibling;
+	uint8_t len;
+};
+
+static struct trie_node trie[TRIE_NODES];
+static int16_t trie_used;
+
+/* Confirmable messages of all the services, in the slot of the timer tick
+ * they expire at. Entries further away than a full turn of the wheel are
+ * skipped until their turn comes.
+ */
+static sys_dlist_t timer_wheel[TIMER_SLOTS];
+static uint32_t timer_tick;
+
+static struct zsock_pollfd fds[FD_COUNT];
+static const struct coap_service *polled[MAX_SERVICES];
+static int wake_fd[2] = { -1, -1 };
+static bool server_running;
+static bool server_exit;
+
+/* Protects the service data and the timer wheel */
+static K_MUTEX_DEFINE(coap_lock);
+/* Serializes starting and stopping services */
+static K_MUTEX_DEFINE(server_lock);
+static K_KERNEL_STACK_DEFINE(server_stack, CONFIG_COAP_SERVER_STACK_SIZE);
+static struct k_thread server_thread;
+
+/* Only used from the server thread */
+static uint8_t rx_buf[CONFIG_COAP_SERVER_MESSAGE_SIZE];
+static uint8_t tx_buf[CONFIG_COAP_SERVER_MESSAGE_SIZE];
+static struct coap_option rx_options[MAX_OPTIONS];
+static struct coap_option uri_path[MAX_OPTIONS];
+
+static bool sockaddr_equal(const struct sockaddr *a, const struct sockaddr *b)
+{
+	if (a->sa_family != b->sa_family) {
+		return false;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && a->sa_family == AF_INET) {
+		return net_sin(a)->sin_port == net_sin(b)->sin_port &&
+		       net_ipv4_addr_cmp(&net_sin(a)->sin_addr, &net_sin(b)->sin_addr);
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && a->sa_family == AF_INET6) {
+		return net_sin6(a)->sin6_port == net_sin6(b)->sin6_port &&
+		       net_ipv6_addr_cmp(&net_sin6(a)->sin6_addr, &net_sin6(b)->sin6_addr);
+	}
+
+	return false;
+}
+
+static socklen_t sockaddr_len(const struct sockaddr *addr)
+{
+	return addr->sa_family == AF_INET6 ? sizeof(struct sockaddr_in6) :
+					     sizeof(struct sockaddr_in);
+}
+
+static bool on_server_thread(void)
+{
+	return server_running && k_current_get() == &server_thread;
+}
+
+static void server_wake(void)
+{
+	(void)zsock_send(wake_fd[0], "w", 1, ZSOCK_MSG_DONTWAIT);
+}
+
+static const struct coap_service *resource_service(const struct coap_resource *resource)
+{
+	COAP_SERVICE_FOREACH(service) {
+		if (resource >= service->res_begin && resource < service->res_end) {
+			return service;
+		}
+	}
+
+	return NULL;
+}
+
+static bool is_wildcard(const char *segment, char wildcard)
+{
+	return IS_ENABLED(CONFIG_COAP_URI_WILDCARD) &&
+	       segment[0] == wildcard && segment[1] == '\0';
+}
+
+static bool segment_eq(const char *segment, const struct coap_option *option)
+{
+	return strlen(segment) == option->len &&
+	       memcmp(segment, option->value, option->len) == 0;
+}
+
+/* URI path trie */
+
+static int16_t trie_alloc(const char *segment, struct coap_resource *resource)
+{
+	struct trie_node *node;
+
+	if (trie_used == TRIE_NODES) {
+		return -1;
+	}
+
+	node = &trie[trie_used];
+	node->segment = segment;
+	node->len = segment ? strlen(segment) : 0U;
+	node->resource = resource;
+	node->child = -1;
+	node->sibling = -1;
+
+	return trie_used++;
+}
+
+static int trie_insert(int16_t root, struct coap_resource *resource)
+{
+	const char * const *path = resource->path;
+	int16_t node = root;
+	int16_t *link;
+
+	for (; path && *path; path++) {
+		link = &trie[node].child;
+
+		while (*link >= 0 && strcmp(trie[*link].segment, *path) != 0) {
+			link = &trie[*link].sibling;
+		}
+
+		if (*link < 0) {
+			/* Appended, siblings keep the definition order */
+			*link = trie_alloc(*path, NULL);
+			if (*link < 0) {
+				return -ENOMEM;
+			}
+		}
+
+		node = *link;
+	}
+
+	if (trie[node].resource) {
+		LOG_WRN("Duplicate resource path, the first one is served");
+		return 0;
+	}
+
+	trie[node].resource = resource;
+
+	return 0;
+}
+
+static void trie_build(const struct coap_service *service)
+{
+	int16_t first = trie_used;
+	int16_t root;
+
+	root = trie_alloc(NULL, NULL);
+	if (root < 0) {
+		goto linear;
+	}
+
+	COAP_SERVICE_FOREACH_RESOURCE(service, resource) {
+		if (trie_insert(root, resource) < 0) {
+			goto linear;
+		}
+	}
+
+	service->data->trie_root = root;
+
+	LOG_DBG("%s: %d trie nodes", service->name, trie_used - first);
+
+	return;
+
+linear:
+	LOG_WRN("%s: out of trie nodes, resources are matched linearly", service->name);
+
+	trie_used = first;
+	service->data->trie_root = TRIE_LINEAR;
+}
+
+static struct coap_resource *trie_match(int16_t node, const struct coap_option *path,
+					int count)
+{
+	struct coap_resource *resource;
+	int16_t child;
+
+	if (count == 0) {
+		return trie[node].resource;
+	}
+
+	/* Exact matches take precedence over wildcards */
+	for (child = trie[node].child; child >= 0; child = trie[child].sibling) {
+		if (trie[child].len == path->len &&
+		    memcmp(trie[child].segment, path->value, path->len) == 0) {
+			resource = trie_match(child, path + 1, count - 1);
+			if (resource) {
+				return resource;
+			}
+		}
+	}
+
+	if (!IS_ENABLED(CONFIG_COAP_URI_WILDCARD)) {
+		return NULL;
+	}
+
+	for (child = trie[node].child; child >= 0; child = trie[child].sibling) {
+		if (is_wildcard(trie[child].segment, '+')) {
+			resource = trie_match(child, path + 1, count - 1);
+			if (resource) {
+				return resource;
+			}
+		} else if (is_wildcard(trie[child].segment, '#') && trie[child].resource) {
+			return trie[child].resource;
+		}
+	}
+
+	return NULL;
+}
+
+static bool path_match(const char * const *segments, const struct coap_option *path, int count)
+{
+	int i;
+
+	for (i = 0; segments && segments[i]; i++) {
+		if (is_wildcard(segments[i], '#')) {
+			return i < count;
+		}
+
+		if (i == count) {
+			return false;
+		}
+
+		if (!is_wildcard(segments[i], '+') && !segment_eq(segments[i], &path[i])) {
+			return false;
+		}
+	}
+
+	return i == count;
+}
+
+static struct coap_resource *service_find_resource(const struct coap_service *service,
+						   const struct coap_packet *request)
+{
+	int count;
+
+	count = coap_find_options(request, COAP_OPTION_URI_PATH, uri_path, ARRAY_SIZE(uri_path));
+	if (count < 0) {
+		return NULL;
+	}
+
+	if (service->data->trie_root >= 0) {
+		return trie_match(service->data->trie_root, uri_path, count);
+	}
+
+	COAP_SERVICE_FOREACH_RESOURCE(service, resource) {
+		if (path_match(resource->path, uri_path, count)) {
+			return resource;
+		}
+	}
+
+	return NULL;
+}
+
+/* Retransmission timer wheel */
+
+static uint32_t pending_expiry(const struct coap_service_pending *p)
+{
+	return p->pending.t0 + p->pending.timeout;
+}
+
+static void timer_insert(struct coap_service_pending *p)
+{
+	uint32_t tick = DIV_ROUND_UP(pending_expiry(p), TIMER_TICK_MS);
+
+	if ((int32_t)(tick - timer_tick) <= 0) {
+		tick = timer_tick + 1;
+	}
+
+	sys_dlist_append(&timer_wheel[tick % TIMER_SLOTS], &p->node);
+}
+
+static void pending_free(struct coap_service_pending *p)
+{
+	if (sys_dnode_is_linked(&p->node)) {
+		sys_dlist_remove(&p->node);
+	}
+
+	coap_pending_clear(&p->pending);
+}
+
+static void observer_free(struct coap_resource *resource, struct coap_observer *observer)
+{
+	coap_remove_observer(resource, observer);
+	memset(observer, 0, sizeof(*observer));
+}
+
+/* Drop the observer a rejected or unacknowledged notification was sent to */
+static void pending_drop_observer(struct coap_service_pending *p)
+{
+	struct coap_observer *observer, *tmp;
+	struct coap_packet cpkt;
+	uint8_t token[COAP_TOKEN_MAX_LEN];
+	uint8_t tkl;
+
+	if (coap_packet_parse(&cpkt, p->buf, p->pending.len, NULL, 0) < 0) {
+		return;
+	}
+
+	tkl = coap_header_get_token(&cpkt, token);
+
+	COAP_SERVICE_FOREACH_RESOURCE(p->service, resource) {
+		SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&resource->observers, observer, tmp, list) {
+			if (observer->tkl == tkl && memcmp(observer->token, token, tkl) == 0 &&
+			    sockaddr_equal(&observer->addr, &p->pending.addr)) {
+				LOG_DBG("%s: observer removed", p->service->name);
+				observer_free(resource, observer);
+			}
+		}
+	}
+}
+
+static void pending_expired(struct coap_service_pending *p)
+{
+	if (!coap_pending_cycle(&p->pending)) {
+		LOG_DBG("%s: message 0x%04x not acknowledged", p->service->name, p->pending.id);
+		pending_drop_observer(p);
+		pending_free(p);
+		return;
+	}
+
+	(void)zsock_sendto(p->service->data->sock_fd, p->pending.data, p->pending.len, 0,
+			   &p->pending.addr, sockaddr_len(&p->pending.addr));
+
+	timer_insert(p);
+}
+
+/* Handle the expired messages, returns the poll timeout until the next tick
+ * with a message in the wheel.
+ */
+static int timer_advance(void)
+{
+	struct coap_service_pending *p, *tmp;
+	uint32_t now = k_uptime_get_32();
+	uint32_t tick = now / TIMER_TICK_MS;
+	uint32_t slots = MIN(tick - timer_tick, TIMER_SLOTS);
+	uint32_t first = timer_tick;
+	uint32_t i, slot;
+
+	/* Retransmissions are inserted after the current tick */
+	timer_tick = tick;
+
+	for (i = 1; i <= slots; i++) {
+		slot = (first + i) % TIMER_SLOTS;
+
+		SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&timer_wheel[slot], p, tmp, node) {
+			if ((int32_t)(pending_expiry(p) - now) > 0) {
+				/* Due in a later turn of the wheel */
+				continue;
+			}
+
+			sys_dlist_remove(&p->node);
+			pending_expired(p);
+		}
+	}
+
+	for (i = 1; i <= TIMER_SLOTS; i++) {
+		if (!sys_dlist_is_empty(&timer_wheel[(tick + i) % TIMER_SLOTS])) {
+			return (tick + i) * TIMER_TICK_MS - now;
+		}
+	}
+
+	return -1;
+}
+
+static int pending_add(const struct coap_service *service, const struct coap_packet *cpkt,
+		       const struct sockaddr *addr)
+{
+	struct coap_service_data *data = service->data;
+	struct coap_service_pending *p = NULL;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(data->pending); i++) {
+		if (!data->pending[i].pending.data) {
+			p = &data->pending[i];
+			break;
+		}
+	}
+
+	if (!p) {
+		return -ENOMEM;
+	}
+
+	memcpy(p->buf, cpkt->data, cpkt->offset);
+
+	(void)coap_pending_init(&p->pending, cpkt, addr, CONFIG_COAP_MAX_RETRANSMIT);
+	p->pending.data = p->buf;
+	p->service = service;
+
+	(void)coap_pending_cycle(&p->pending);
+	timer_insert(p);
+
+	return 0;
+}
+
+static void pending_received(const struct coap_service *service,
+			     const struct coap_packet *response, const struct sockaddr *addr)
+{
+	struct coap_service_data *data = service->data;
+	uint16_t id = coap_header_get_id(response);
+	struct coap_service_pending *p;
+	int i;
+
+	k_mutex_lock(&coap_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(data->pending); i++) {
+		p = &data->pending[i];
+
+		if (!p->pending.data || p->pending.id != id ||
+		    !sockaddr_equal(&p->pending.addr, addr)) {
+			continue;
+		}
+
+		if (coap_header_get_type(response) == COAP_TYPE_RESET) {
+			pending_drop_observer(p);
+		}
+
+		pending_free(p);
+		break;
+	}
+
+	k_mutex_unlock(&coap_lock);
+}
+
+/* Message deduplication */
+
+static struct coap_service_exchange *exchange_find(struct coap_service_data *data,
+						   const struct sockaddr *addr, uint16_t id)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(data->exchanges); i++) {
+		if (data->exchanges[i].used && data->exchanges[i].id == id &&
+		    sockaddr_equal(&data->exchanges[i].addr, addr)) {
+			return &data->exchanges[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Returns true if the request was handled already */
+static bool exchange_check(const struct coap_service *service, const struct coap_packet *request,
+			   const struct sockaddr *addr)
+{
+	struct coap_service_data *data = service->data;
+	struct coap_service_exchange *ex;
+	uint32_t now = k_uptime_get_32();
+	bool duplicate = false;
+	int i;
+
+	k_mutex_lock(&coap_lock, K_FOREVER);
+
+	ex = exchange_find(data, addr, coap_header_get_id(request));
+	if (ex && now - ex->timestamp < EXCHANGE_LIFETIME_MS) {
+		LOG_DBG("%s: duplicate message 0x%04x", service->name, ex->id);
+
+		if (ex->len > 0U) {
+			(void)zsock_sendto(data->sock_fd, ex->buf, ex->len, 0, addr,
+					   sockaddr_len(addr));
+		}
+
+		duplicate = true;
+		goto out;
+	}
+
+	if (!ex) {
+		/* Replace the least recently received request */
+		ex = &data->exchanges[0];
+
+		for (i = 0; i < ARRAY_SIZE(data->exchanges) && ex->used; i++) {
+			if (!data->exchanges[i].used ||
+			    (int32_t)(data->exchanges[i].timestamp - ex->timestamp) < 0) {
+				ex = &data->exchanges[i];
+			}
+		}
+	}
+
+	net_ipaddr_copy(&ex->addr, addr);
+	ex->id = coap_header_get_id(request);
+	ex->timestamp = now;
+	ex->len = 0U;
+	ex->used = true;
+
+out:
+	k_mutex_unlock(&coap_lock);
+
+	return duplicate;
+}
+
+static bool exchange_answered(const struct coap_service *service,
+			      const struct coap_packet *request, const struct sockaddr *addr)
+{
+	struct coap_service_exchange *ex;
+	bool answered;
+
+	k_mutex_lock(&coap_lock, K_FOREVER);
+
+	ex = exchange_find(service->data, addr, coap_header_get_id(request));
+	answered = !ex || ex->len > 0U;
+
+	k_mutex_unlock(&coap_lock);
+
+	return answered;
+}
+
+/* Request handling */
+
+static coap_method_t resource_method(const struct coap_resource *resource, uint8_t code)
+{
+	switch (code) {
+	case COAP_METHOD_GET:
+		return resource->get;
+	case COAP_METHOD_POST:
+		return resource->post;
+	case COAP_METHOD_PUT:
+		return resource->put;
+	case COAP_METHOD_DELETE:
+		return resource->del;
+	case COAP_METHOD_FETCH:
+		return resource->fetch;
+	case COAP_METHOD_PATCH:
+		return resource->patch;
+	case COAP_METHOD_IPATCH:
+		return resource->ipatch;
+	default:
+		return NULL;
+	}
+}
+
+static uint8_t error_to_code(int err)
+{
+	switch (err) {
+	case -ENOENT:
+		return COAP_RESPONSE_CODE_NOT_FOUND;
+	case -EPERM:
+		return COAP_RESPONSE_CODE_NOT_ALLOWED;
+	case -EINVAL:
+	case -ENOTSUP:
+		return COAP_RESPONSE_CODE_BAD_REQUEST;
+	default:
+		return COAP_RESPONSE_CODE_INTERNAL_ERROR;
+	}
+}
+
+static void send_empty(const struct coap_service *service, uint8_t type, uint16_t id,
+		       struct sockaddr *addr, socklen_t addr_len)
+{
+	struct coap_packet reply;
+
+	if (coap_packet_init(&reply, tx_buf, sizeof(tx_buf), COAP_VERSION_1, type, 0, NULL,
+			     COAP_CODE_EMPTY, id) == 0) {
+		(void)coap_service_send(service, &reply, addr, addr_len);
+	}
+}
+
+/* Answer a request with a response code and no payload */
+static void send_reply(const struct coap_service *service, const struct coap_packet *request,
+		       uint8_t code, struct sockaddr *addr, socklen_t addr_len)
+{
+	struct coap_packet reply;
+	uint8_t token[COAP_TOKEN_MAX_LEN];
+	uint8_t tkl;
+	int ret;
+
+	if (coap_header_get_type(request) == COAP_TYPE_CON) {
+		ret = coap_ack_init(&reply, request, tx_buf, sizeof(tx_buf), code);
+	} else {
+		tkl = coap_header_get_token(request, token);
+		ret = coap_packet_init(&reply, tx_buf, sizeof(tx_buf), COAP_VERSION_1,
+				       COAP_TYPE_NON_CON, tkl, token, code, coap_next_id());
+	}
+
+	if (ret == 0) {
+		(void)coap_service_send(service, &reply, addr, addr_len);
+	}
+}
+
+static void service_handle(const struct coap_service *service, struct coap_packet *request,
+			   struct sockaddr *addr, socklen_t addr_len)
+{
+	struct coap_resource *resource;
+	coap_method_t method;
+	uint8_t type = coap_header_get_type(request);
+	uint8_t code = coap_header_get_code(request);
+	int ret;
+
+	if (type == COAP_TYPE_ACK || type == COAP_TYPE_RESET) {
+		pending_received(service, request, addr);
+		return;
+	}
+
+	if (code == COAP_CODE_EMPTY || (code & ~COAP_REQUEST_MASK) != 0U) {
+		/* A ping, or a response we did not ask for */
+		if (type == COAP_TYPE_CON) {
+			send_empty(service, COAP_TYPE_RESET, coap_header_get_id(request), addr,
+				   addr_len);
+		}
+
+		return;
+	}
+
+	if (exchange_check(service, request, addr)) {
+		return;
+	}
+
+	resource = service_find_resource(service, request);
+	if (!resource) {
+		ret = -ENOENT;
+	} else {
+		method = resource_method(resource, code);
+		ret = method ? method(resource, request, addr, addr_len) : -EPERM;
+	}
+
+	if (ret < 0) {
+		LOG_DBG("%s: request failed (%d)", service->name, ret);
+		send_reply(service, request, error_to_code(ret), addr, addr_len);
+	} else if (type == COAP_TYPE_CON && !exchange_answered(service, request, addr)) {
+		/* The response follows separately */
+		send_empty(service, COAP_TYPE_ACK, coap_header_get_id(request), addr, addr_len);
+	}
+}
+
+static void service_recv(const struct coap_service *service)
+{
+	struct sockaddr addr;
+	struct coap_packet request;
+	socklen_t addr_len;
+	ssize_t received;
+	int ret;
+
+	while (true) {
+		addr_len = sizeof(addr);
+		received = zsock_recvfrom(service->data->sock_fd, rx_buf, sizeof(rx_buf),
+					  ZSOCK_MSG_DONTWAIT, &addr, &addr_len);
+		if (received < 0) {
+			if (errno != EAGAIN && errno != EWOULDBLOCK) {
+				LOG_ERR("%s: receive error (%d)", service->name, -errno);
+			}
+
+			return;
+		}
+
+		/* The options are indexed, handlers do not parse them again */
+		ret = coap_packet_parse(&request, rx_buf, received, rx_options,
+					ARRAY_SIZE(rx_options));
+		if (ret < 0) {
+			LOG_DBG("%s: invalid message (%d)", service->name, ret);
+			continue;
+		}
+
+		service_handle(service, &request, &addr, addr_len);
+	}
+}
+
+/* Server thread */
+
+static void server_loop(void *p1, void *p2, void *p3)
+{
+	char wake[8];
+	int timeout;
+	int i, ret;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		k_mutex_lock(&coap_lock, K_FOREVER);
+		timeout = timer_advance();
+		k_mutex_unlock(&coap_lock);
+
+		ret = zsock_poll(fds, ARRAY_SIZE(fds), timeout);
+		if (ret < 0) {
+			LOG_ERR("Poll error (%d)", -errno);
+			k_msleep(TIMER_TICK_MS);
+			continue;
+		}
+
+		if (fds[FD_WAKE].revents & ZSOCK_POLLIN) {
+			/* Either the timer wheel changed or the server is stopping */
+			while (zsock_recv(wake_fd[1], wake, sizeof(wake), ZSOCK_MSG_DONTWAIT) > 0) {
+			}
+
+			if (server_exit) {
+				break;
+			}
+		}
+
+		for (i = 0; i < MAX_SERVICES; i++) {
+			if (fds[FD_SERVICES + i].revents & ZSOCK_POLLIN) {
+				service_recv(polled[i]);
+			}
+		}
+	}
+}
+
+static void server_thread_stop(void)
+{
+	if (!server_running) {
+		return;
+	}
+
+	server_exit = true;
+	server_wake();
+
+	(void)k_thread_join(&server_thread, K_FOREVER);
+
+	server_exit = false;
+	server_running = false;
+}
+
+static int server_thread_start(void)
+{
+	int count = 0;
+	int ret, i;
+
+	for (i = 0; i < FD_COUNT; i++) {
+		fds[i].fd = -1;
+		fds[i].events = ZSOCK_POLLIN;
+	}
+
+	COAP_SERVICE_FOREACH(service) {
+		if (service->data->sock_fd < 0) {
+			continue;
+		}
+
+		if (count == MAX_SERVICES) {
+			LOG_ERR("Too many services, max %d", MAX_SERVICES);
+			return -ENOMEM;
+		}
+
+		polled[count] = service;
+		fds[FD_SERVICES + count].fd = service->data->sock_fd;
+		count++;
+	}
+
+	if (count == 0) {
+		return 0;
+	}
+
+	if (wake_fd[0] < 0) {
+		ret = zsock_socketpair(AF_UNIX, SOCK_STREAM, 0, wake_fd);
+		if (ret < 0) {
+			ret = -errno;
+			LOG_ERR("Cannot create wake up socket (%d)", ret);
+			return ret;
+		}
+	}
+
+	fds[FD_WAKE].fd = wake_fd[1];
+
+	k_thread_create(&server_thread, server_stack,
+			K_KERNEL_STACK_SIZEOF(server_stack), server_loop,
+			NULL, NULL, NULL, THREAD_PRIORITY, 0, K_NO_WAIT);
+	k_thread_name_set(&server_thread, "coap_server");
+
+	server_running = true;
+
+	return 0;
+}
+
+static int service_bind(const struct coap_service *service)
+{
+	struct sockaddr_storage addr_storage = { 0 };
+	struct sockaddr *addr = (struct sockaddr *)&addr_storage;
+	const char *host = service->host ? service->host : "";
+	socklen_t addrlen;
+	int fd, ret;
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) &&
+	    zsock_inet_pton(AF_INET6, host, &net_sin6(addr)->sin6_addr) == 1) {
+		addr->sa_family = AF_INET6;
+	} else if (IS_ENABLED(CONFIG_NET_IPV4) &&
+		   zsock_inet_pton(AF_INET, host, &net_sin(addr)->sin_addr) == 1) {
+		addr->sa_family = AF_INET;
+	} else {
+		addr->sa_family = IS_ENABLED(CONFIG_NET_IPV6) ? AF_INET6 : AF_INET;
+	}
+
+	if (addr->sa_family == AF_INET6) {
+		net_sin6(addr)->sin6_port = htons(*service->port);
+		addrlen = sizeof(struct sockaddr_in6);
+	} else {
+		net_sin(addr)->sin_port = htons(*service->port);
+		addrlen = sizeof(struct sockaddr_in);
+	}
+
+	fd = zsock_socket(addr->sa_family, SOCK_DGRAM, IPPROTO_UDP);
+	if (fd < 0) {
+		LOG_ERR("%s: cannot create socket (%d)", service->name, -errno);
+		return -errno;
+	}
+
+	if (zsock_bind(fd, addr, addrlen) < 0) {
+		ret = -errno;
+		LOG_ERR("%s: cannot bind port %u (%d)", service->name, *service->port, ret);
+		goto fail;
+	}
+
+	if (*service->port == 0) {
+		/* Let the application know which ephemeral port was taken */
+		if (zsock_getsockname(fd, addr, &addrlen) < 0) {
+			ret = -errno;
+			goto fail;
+		}
+
+		*service->port = ntohs(addr->sa_family == AF_INET6 ?
+				       net_sin6(addr)->sin6_port : net_sin(addr)->sin_port);
+	}
+
+	LOG_DBG("%s: bound to port %u", service->name, *service->port);
+
+	return fd;
+
+fail:
+	(void)zsock_close(fd);
+
+	return ret;
+}
+
+static void service_reset(const struct coap_service *service)
+{
+	struct coap_service_data *data = service->data;
+	struct coap_observer *observer, *tmp;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(data->pending); i++) {
+		pending_free(&data->pending[i]);
+	}
+
+	COAP_SERVICE_FOREACH_RESOURCE(service, resource) {
+		SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&resource->observers, observer, tmp, list) {
+			observer_free(resource, observer);
+		}
+	}
+
+	memset(data->exchanges, 0, sizeof(data->exchanges));
+}
+
+int coap_service_start(const struct coap_service *service)
+{
+	int ret = 0;
+	int fd;
+
+	k_mutex_lock(&server_lock, K_FOREVER);
+
+	if (service->data->sock_fd >= 0) {
+		ret = -EALREADY;
+		goto out;
+	}
+
+	if (service->data->trie_root == TRIE_UNBUILT) {
+		/* Resources are static, the trie is built once */
+		k_mutex_lock(&coap_lock, K_FOREVER);
+		trie_build(service);
+		k_mutex_unlock(&coap_lock);
+	}
+
+	fd = service_bind(service);
+	if (fd < 0) {
+		ret = fd;
+		goto out;
+	}
+
+	server_thread_stop();
+
+	service->data->sock_fd = fd;
+
+	ret = server_thread_start();
+	if (ret < 0) {
+		service->data->sock_fd = -1;
+		(void)zsock_close(fd);
+		(void)server_thread_start();
+	}
+
+out:
+	k_mutex_unlock(&server_lock);
+
+	return ret;
+}
+
+int coap_service_stop(const struct coap_service *service)
+{
+	int ret = 0;
+
+	if (on_server_thread()) {
+		return -EDEADLK;
+	}
+
+	k_mutex_lock(&server_lock, K_FOREVER);
+
+	if (service->data->sock_fd < 0) {
+		ret = -EALREADY;
+		goto out;
+	}
+
+	server_thread_stop();
+
+	k_mutex_lock(&coap_lock, K_FOREVER);
+	(void)zsock_close(service->data->sock_fd);
+	service->data->sock_fd = -1;
+	service_reset(service);
+	k_mutex_unlock(&coap_lock);
+
+	ret = server_thread_start();
+
+out:
+	k_mutex_unlock(&server_lock);
+
+	return ret;
+}
+
+bool coap_service_is_running(const struct coap_service *service)
+{
+	return service->data->sock_fd >= 0;
+}
+
+int coap_service_send(const struct coap_service *service, const struct coap_packet *cpkt,
+		      const struct sockaddr *addr, socklen_t addr_len)
+{
+	struct coap_service_data *data = service->data;
+	struct coap_service_exchange *ex;
+	uint8_t type = coap_header_get_type(cpkt);
+	int ret = 0;
+
+	if (cpkt->offset > CONFIG_COAP_SERVER_MESSAGE_SIZE) {
+		return -EMSGSIZE;
+	}
+
+	k_mutex_lock(&coap_lock, K_FOREVER);
+
+	if (data->sock_fd < 0) {
+		ret = -EBADF;
+		goto out;
+	}
+
+	if (type == COAP_TYPE_CON) {
+		ret = pending_add(service, cpkt, addr);
+		if (ret < 0) {
+			LOG_WRN("%s: no room for a confirmable message", service->name);
+			goto out;
+		}
+	} else if (type == COAP_TYPE_ACK || type == COAP_TYPE_RESET) {
+		/* Remembered as the answer to a duplicate of the request */
+		ex = exchange_find(data, addr, coap_header_get_id(cpkt));
+		if (ex) {
+			memcpy(ex->buf, cpkt->data, cpkt->offset);
+			ex->len = cpkt->offset;
+		}
+	}
+
+	if (zsock_sendto(data->sock_fd, cpkt->data, cpkt->offset, 0, addr, addr_len) < 0) {
+		ret = -errno;
+		LOG_DBG("%s: send error (%d)", service->name, ret);
+	}
+
+out:
+	k_mutex_unlock(&coap_lock);
+
+	if (ret == 0 && type == COAP_TYPE_CON && !on_server_thread()) {
+		/* The poll timeout may be later than the new retransmission */
+		server_wake();
+	}
+
+	return ret;
+}
+
+int coap_resource_send(const struct coap_resource *resource, const struct coap_packet *cpkt,
+		       const struct sockaddr *addr, socklen_t addr_len)
+{
+	const struct coap_service *service = resource_service(resource);
+
+	if (!service) {
+		return -ENOENT;
+	}
+
+	return coap_service_send(service, cpkt, addr, addr_len);
+}
+
+int coap_resource_parse_observe(struct coap_resource *resource,
+				const struct coap_packet *request,
+				const struct sockaddr *addr)
+{
+	const struct coap_service *service = resource_service(resource);
+	struct coap_observer *observer, *found = NULL;
+	uint8_t token[COAP_TOKEN_MAX_LEN];
+	uint8_t tkl;
+	int observe;
+
+	if (!service) {
+		return -ENOENT;
+	}
+
+	observe = coap_get_option_int(request, COAP_OPTION_OBSERVE);
+	if (observe < 0) {
+		return observe;
+	}
+
+	tkl = coap_header_get_token(request, token);
+
+	k_mutex_lock(&coap_lock, K_FOREVER);
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&resource->observers, observer, list) {
+		if (observer->tkl == tkl && memcmp(observer->token, token, tkl) == 0 &&
+		    sockaddr_equal(&observer->addr, addr)) {
+			found = observer;
+			break;
+		}
+	}
+
+	if (observe == 0 && !found) {
+		observer = coap_observer_next_unused(service->data->observers,
+						     ARRAY_SIZE(service->data->observers));
+		if (!observer) {
+			observe = -ENOMEM;
+			goto out;
+		}
+
+		coap_observer_init(observer, request, addr);
+		(void)coap_register_observer(resource, observer);
+	} else if (observe == 1 && found) {
+		observer_free(resource, found);
+	}
+
+out:
+	k_mutex_unlock(&coap_lock);
+
+	return observe;
+}
+
+static int coap_server_init(const struct device *dev)
+{
+	int i;
+
+	ARG_UNUSED(dev);
+
+	for (i = 0; i < TIMER_SLOTS; i++) {
+		sys_dlist_init(&timer_wheel[i]);
+	}
+
+	timer_tick = k_uptime_get_32() / TIMER_TICK_MS;
+
+	COAP_SERVICE_FOREACH(service) {
+		if (service->flags & COAP_SERVICE_AUTOSTART) {
+			(void)coap_service_start(service);
+		}
+	}
+
+	return 0;
+}
+
+SYS_INIT(coap_server_init, APPLICATION, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
@@ -0,0 +1,219 @@
+/** @file
+ * @brief DNS answer cache
+ *
+ * Remembers resolved addresses and "no such name" answers until their
+ * time to live expires.
+ */
+
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_dns_resolve, CONFIG_DNS_RESOLVER_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <zephyr/types.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+
+#include <zephyr/net/net_ip.h>
+#include <zephyr/net/dns_resolve.h>
+#include "dns_internal.h"
+
+struct dns_cache_entry {
+	/* Uptime in milliseconds when the answer expires */
+	int64_t expires;
+
+	/* Uptime in milliseconds when the answer was last used */
+	int64_t last_used;
+
+	struct sockaddr addrs[CONFIG_DNS_RESOLVER_AI_MAX_ENTRIES];
+
+	enum dns_query_type type;
+
+	/* Number of addresses, 0 for a negative answer */
+	uint8_t count;
+
+	bool in_use;
+
+	char name[CONFIG_DNS_RESOLVER_CACHE_NAME_MAX_LEN + 1];
+};
+
+static struct dns_cache_entry cache[CONFIG_DNS_RESOLVER_CACHE_MAX_ENTRIES];
+static struct dns_resolve_cache_stats cache_stats;
+
+static K_MUTEX_DEFINE(lock);
+
+static inline bool entry_expired(struct dns_cache_entry *entry, int64_t now)
+{
+	return entry->expires <= now;
+}
+
+/* Must be invoked with lock held */
+static struct dns_cache_entry *cache_find(const char *name,
+					  enum dns_query_type type)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (cache[i].in_use && cache[i].type == type &&
+		    strcasecmp(cache[i].name, name) == 0) {
+			return &cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Must be invoked with lock held */
+static struct dns_cache_entry *cache_get_free(int64_t now)
+{
+	struct dns_cache_entry *lru = NULL;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (!cache[i].in_use || entry_expired(&cache[i], now)) {
+			return &cache[i];
+		}
+
+		if (!lru || cache[i].last_used < lru->last_used) {
+			lru = &cache[i];
+		}
+	}
+
+	cache_stats.evictions++;
+
+	NET_DBG("Evicting %s", lru->name);
+
+	return lru;
+}
+
+int dns_cache_find(const char *name, enum dns_query_type type,
+		   struct sockaddr *addrs, int *count)
+{
+	struct dns_cache_entry *entry;
+	int64_t now = k_uptime_get();
+	int ret = -ENOENT;
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	entry = cache_find(name, type);
+	if (!entry) {
+		goto miss;
+	}
+
+	if (entry_expired(entry, now)) {
+		entry->in_use = false;
+		goto miss;
+	}
+
+	entry->last_used = now;
+
+	memcpy(addrs, entry->addrs, entry->count * sizeof(struct sockaddr));
+	*count = entry->count;
+
+	cache_stats.hits++;
+	if (entry->count == 0) {
+		cache_stats.negative_hits++;
+	}
+
+	ret = 0;
+	goto out;
+
+miss:
+	cache_stats.misses++;
+
+out:
+	k_mutex_unlock(&lock);
+
+	return ret;
+}
+
+void dns_cache_add(const char *name, enum dns_query_type type,
+		   const struct sockaddr *addrs, int count, uint32_t ttl)
+{
+	struct dns_cache_entry *entry;
+	int64_t now = k_uptime_get();
+
+	if (ttl == 0U || strlen(name) > CONFIG_DNS_RESOLVER_CACHE_NAME_MAX_LEN) {
+		return;
+	}
+
+	count = MIN(count, CONFIG_DNS_RESOLVER_AI_MAX_ENTRIES);
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	entry = cache_find(name, type);
+	if (!entry) {
+		entry = cache_get_free(now);
+
+		strcpy(entry->name, name);
+		entry->type = type;
+		entry->in_use = true;
+	}
+
+	memcpy(entry->addrs, addrs, count * sizeof(struct sockaddr));
+	entry->count = count;
+	entry->expires = now + (int64_t)ttl * MSEC_PER_SEC;
+	entry->last_used = now;
+
+	cache_stats.insertions++;
+
+	NET_DBG("Cached %s (%d addresses) for %u s", name, count, ttl);
+
+	k_mutex_unlock(&lock);
+}
+
+int dns_resolve_cache_flush(void)
+{
+	int i;
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(cache); i++) {
+		cache[i].in_use = false;
+	}
+
+	k_mutex_unlock(&lock);
+
+	return 0;
+}
+
+int dns_resolve_cache_get_stats(struct dns_resolve_cache_stats *stats)
+{
+	if (!stats) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&lock, K_FOREVER);
+	memcpy(stats, &cache_stats, sizeof(*stats));
+	k_mutex_unlock(&lock);
+
+	return 0;
+}
+
+int dns_resolve_cache_foreach(dns_resolve_cache_cb_t cb, void *user_data)
+{
+	int64_t now = k_uptime_get();
+	int i, ret = 0;
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (!cache[i].in_use || entry_expired(&cache[i], now)) {
+			continue;
+		}
+
+		cb(cache[i].name, cache[i].type, cache[i].count,
+		   (uint32_t)((cache[i].expires - now) / MSEC_PER_SEC),
+		   user_data);
+
+		ret++;
+	}
+
+	k_mutex_unlock(&lock);
+
+	return ret;
+}
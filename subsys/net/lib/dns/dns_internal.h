@@ -18,3 +18,15 @@ int dns_validate_msg(struct dns_resolve_context *ctx,
 		     struct net_buf *dns_cname,
 		     uint16_t *query_hash);
 #endif
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+/* Look up a cached answer. On a hit the cached addresses are copied to
+ * addrs and their number to count, which is 0 for a negative answer.
+ */
+int dns_cache_find(const char *name, enum dns_query_type type,
+		   struct sockaddr *addrs, int *count);
+
+/* Store an answer. A count of 0 stores a negative answer. */
+void dns_cache_add(const char *name, enum dns_query_type type,
+		   const struct sockaddr *addrs, int count, uint32_t ttl);
+#endif
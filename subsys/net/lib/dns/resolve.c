@@ -473,6 +473,10 @@ int dns_validate_msg(struct dns_resolve_context *ctx,
 {
 	struct dns_addrinfo info = { 0 };
 	uint32_t ttl; /* RR ttl, so far it is not passed to caller */
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	struct sockaddr cache_addrs[CONFIG_DNS_RESOLVER_AI_MAX_ENTRIES];
+	uint32_t cache_ttl = UINT32_MAX;
+#endif
 	uint8_t *src, *addr;
 	const char *query_name;
 	int address_size;
@@ -635,6 +639,18 @@ query_known:
 
 			invoke_query_callback(DNS_EAI_INPROGRESS, &info,
 					      &ctx->queries[*query_idx]);
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+			/* The answer is cached as long as its shortest
+			 * lived record.
+			 */
+			if (items < ARRAY_SIZE(cache_addrs)) {
+				memcpy(&cache_addrs[items], &info.ai_addr,
+				       sizeof(struct sockaddr));
+			}
+
+			cache_ttl = MIN(cache_ttl, ttl);
+#endif
 			items++;
 			break;
 
@@ -706,6 +722,26 @@ query_known:
 		ret = DNS_EAI_ALLDONE;
 	}
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	/* The query name is gone if the query was already released */
+	if (ctx->queries[*query_idx].query == NULL) {
+		goto quit;
+	}
+
+	if (items > 0) {
+		dns_cache_add(ctx->queries[*query_idx].query,
+			      ctx->queries[*query_idx].query_type,
+			      cache_addrs,
+			      MIN(items, ARRAY_SIZE(cache_addrs)),
+			      cache_ttl);
+	} else if (dns_header_rcode(dns_msg->msg) == DNS_HEADER_NAMEERROR) {
+		dns_cache_add(ctx->queries[*query_idx].query,
+			      ctx->queries[*query_idx].query_type,
+			      NULL, 0,
+			      CONFIG_DNS_RESOLVER_CACHE_NEGATIVE_TTL);
+	}
+#endif
+
 quit:
 	return ret;
 }
@@ -1105,6 +1141,39 @@ static void query_timeout(struct k_work *work)
 	k_mutex_unlock(&pending_query->ctx->lock);
 }
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+static int answer_from_cache(const char *query, enum dns_query_type type,
+			     dns_resolve_cb_t cb, void *user_data)
+{
+	struct sockaddr addrs[CONFIG_DNS_RESOLVER_AI_MAX_ENTRIES];
+	struct dns_addrinfo info = { 0 };
+	int count, i;
+
+	if (dns_cache_find(query, type, addrs, &count) < 0) {
+		return -ENOENT;
+	}
+
+	if (count == 0) {
+		cb(DNS_EAI_NODATA, NULL, user_data);
+		return 0;
+	}
+
+	for (i = 0; i < count; i++) {
+		memcpy(&info.ai_addr, &addrs[i], sizeof(struct sockaddr));
+		info.ai_family = addrs[i].sa_family;
+		info.ai_addrlen = addrs[i].sa_family == AF_INET6 ?
+			sizeof(struct sockaddr_in6) :
+			sizeof(struct sockaddr_in);
+
+		cb(DNS_EAI_INPROGRESS, &info, user_data);
+	}
+
+	cb(DNS_EAI_ALLDONE, NULL, user_data);
+
+	return 0;
+}
+#endif
+
 int dns_resolve_name(struct dns_resolve_context *ctx,
 		     const char *query,
 		     enum dns_query_type type,
@@ -1182,6 +1251,16 @@ int dns_resolve_name(struct dns_resolve_context *ctx,
 	}
 
 try_resolve:
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	if (answer_from_cache(query, type, cb, user_data) == 0) {
+		if (dns_id) {
+			*dns_id = 0U;
+		}
+
+		return 0;
+	}
+#endif
+
 	k_mutex_lock(&ctx->lock, K_FOREVER);
 
 	if (ctx->state != DNS_RESOLVE_CONTEXT_ACTIVE) {
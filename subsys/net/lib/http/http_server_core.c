@@ -0,0 +1,896 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_http_server, CONFIG_NET_HTTP_SERVER_LOG_LEVEL);
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/http/server.h>
+#include <zephyr/net/http/service.h>
+#include <zephyr/net/http/status.h>
+
+#define MAX_SERVICES CONFIG_HTTP_SERVER_MAX_SERVICES
+#define MAX_CLIENTS CONFIG_HTTP_SERVER_MAX_CLIENTS
+#define INACTIVITY_TIMEOUT_MS (CONFIG_HTTP_SERVER_CLIENT_INACTIVITY_TIMEOUT * MSEC_PER_SEC)
+
+/* Room for the size line in front of the chunk data, the tx buffer is
+ * smaller than 64 kB so the size has at most four hex digits.
+ */
+#define CHUNK_HDR_ROOM (sizeof("ffff\r\n") - 1)
+#define CHUNK_TRAILER_LEN (sizeof("\r\n") - 1)
+#define LAST_CHUNK "0\r\n\r\n"
+
+#if defined(CONFIG_NET_TC_THREAD_COOPERATIVE)
+#define THREAD_PRIORITY K_PRIO_COOP(CONFIG_NUM_COOP_PRIORITIES - 1)
+#else
+#define THREAD_PRIORITY K_PRIO_PREEMPT(CONFIG_NUM_PREEMPT_PRIORITIES - 1)
+#endif
+
+BUILD_ASSERT(CONFIG_HTTP_SERVER_TX_BUFFER_SIZE <= 0xFFFF,
+	     "Chunk size does not fit in the chunk header room");
+
+/* Poll array layout: the wake up socket, the listening sockets and the
+ * clients.
+ */
+#define FD_WAKE 0
+#define FD_SERVICES 1
+#define FD_CLIENTS (FD_SERVICES + MAX_SERVICES)
+#define FD_COUNT (FD_CLIENTS + MAX_CLIENTS)
+
+/* All the sockets are polled in a single call */
+BUILD_ASSERT(CONFIG_NET_SOCKETS_POLL_MAX >= FD_COUNT,
+	     "CONFIG_NET_SOCKETS_POLL_MAX too small for the HTTP server, it needs "
+	     "1 + CONFIG_HTTP_SERVER_MAX_SERVICES + CONFIG_HTTP_SERVER_MAX_CLIENTS");
+
+/* Back off when poll fails for lack of resources */
+#define POLL_ERROR_DELAY_MS 100
+
+struct http_service_state {
+	const struct http_service_desc *desc;
+	size_t clients;
+};
+
+static struct zsock_pollfd fds[FD_COUNT];
+static struct http_service_state services[MAX_SERVICES];
+static struct http_client_ctx clients[MAX_CLIENTS];
+static int wake_fd[2] = { -1, -1 };
+static bool server_running;
+
+static K_MUTEX_DEFINE(server_lock);
+static K_KERNEL_STACK_DEFINE(server_stack, CONFIG_HTTP_SERVER_STACK_SIZE);
+static struct k_thread server_thread;
+
+static const char *status_reason(uint16_t status)
+{
+	switch (status) {
+	case HTTP_200_OK:
+		return "OK";
+	case HTTP_400_BAD_REQUEST:
+		return "Bad Request";
+	case HTTP_404_NOT_FOUND:
+		return "Not Found";
+	case HTTP_405_METHOD_NOT_ALLOWED:
+		return "Method Not Allowed";
+	case HTTP_414_URI_TOO_LONG:
+		return "URI Too Long";
+	default:
+		return "Internal Server Error";
+	}
+}
+
+static const struct http_resource_detail *
+get_resource(const struct http_service_desc *svc, const char *url)
+{
+	size_t path_len = strcspn(url, "?#");
+
+	HTTP_SERVICE_FOREACH_RESOURCE(svc, res) {
+		if (strncmp(res->resource, url, path_len) == 0 &&
+		    res->resource[path_len] == '\0') {
+			return res->detail;
+		}
+	}
+
+	return NULL;
+}
+
+static struct http_client_ctx *parser_client(struct http_parser *parser)
+{
+	return CONTAINER_OF(parser, struct http_client_ctx, parser);
+}
+
+static int dynamic_cb(struct http_client_ctx *client, enum http_data_status status,
+		      uint8_t *data, size_t len)
+{
+	const struct http_resource_detail_dynamic *dyn =
+		(const struct http_resource_detail_dynamic *)client->resource;
+
+	return dyn->cb(client, status, data, len, dyn->user_data);
+}
+
+static bool is_dynamic(struct http_client_ctx *client)
+{
+	return client->resource != NULL &&
+	       client->resource->type == HTTP_RESOURCE_TYPE_DYNAMIC;
+}
+
+static int on_message_begin(struct http_parser *parser)
+{
+	struct http_client_ctx *client = parser_client(parser);
+
+	client->url_len = 0U;
+	client->url[0] = '\0';
+	client->status = HTTP_200_OK;
+	client->resource = NULL;
+
+	return 0;
+}
+
+static int on_url(struct http_parser *parser, const char *at, size_t length)
+{
+	struct http_client_ctx *client = parser_client(parser);
+
+	if (client->status != HTTP_200_OK) {
+		return 0;
+	}
+
+	if (client->url_len + length >= sizeof(client->url)) {
+		client->status = HTTP_414_URI_TOO_LONG;
+		return 0;
+	}
+
+	memcpy(&client->url[client->url_len], at, length);
+	client->url_len += length;
+	client->url[client->url_len] = '\0';
+
+	return 0;
+}
+
+static int on_headers_complete(struct http_parser *parser)
+{
+	struct http_client_ctx *client = parser_client(parser);
+	const struct http_resource_detail *res;
+
+	client->keep_alive = http_should_keep_alive(parser);
+	client->head = parser->method == HTTP_HEAD;
+
+	if (client->status != HTTP_200_OK) {
+		return 0;
+	}
+
+	res = get_resource(client->service, client->url);
+	if (res == NULL) {
+		client->status = HTTP_404_NOT_FOUND;
+		return 0;
+	}
+
+	if (parser->method >= 32 ||
+	    !(res->bitmask_of_supported_http_methods & HTTP_METHOD_BIT(parser->method))) {
+		client->status = HTTP_405_METHOD_NOT_ALLOWED;
+		return 0;
+	}
+
+	client->resource = res;
+
+	return 0;
+}
+
+static int on_body(struct http_parser *parser, const char *at, size_t length)
+{
+	struct http_client_ctx *client = parser_client(parser);
+
+	if (client->status != HTTP_200_OK || !is_dynamic(client)) {
+		return 0;
+	}
+
+	if (dynamic_cb(client, HTTP_SERVER_DATA_MORE, (uint8_t *)at, length) < 0) {
+		client->status = HTTP_500_INTERNAL_SERVER_ERROR;
+	}
+
+	return 0;
+}
+
+static int on_message_complete(struct http_parser *parser)
+{
+	struct http_client_ctx *client = parser_client(parser);
+
+	if (client->status == HTTP_200_OK && is_dynamic(client)) {
+		if (dynamic_cb(client, HTTP_SERVER_DATA_FINAL, NULL, 0) < 0) {
+			client->status = HTTP_500_INTERNAL_SERVER_ERROR;
+		}
+	}
+
+	/* Pipelined requests stay in the buffer until this one is answered */
+	http_parser_pause(parser, 1);
+
+	client->state = HTTP_CLIENT_SEND;
+	client->response = HTTP_RESPONSE_HEADERS;
+
+	return 0;
+}
+
+static const struct http_parser_settings parser_settings = {
+	.on_message_begin = on_message_begin,
+	.on_url = on_url,
+	.on_headers_complete = on_headers_complete,
+	.on_body = on_body,
+	.on_message_complete = on_message_complete,
+};
+
+static struct http_service_state *get_service(const struct http_service_desc *desc)
+{
+	int i;
+
+	for (i = 0; i < MAX_SERVICES; i++) {
+		if (services[i].desc == desc) {
+			return &services[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void client_close(struct http_client_ctx *client)
+{
+	int idx = client - clients;
+
+	LOG_DBG("[%d] Closing connection", client->fd);
+
+	/* Let the resource know that the request it was serving is gone */
+	if (is_dynamic(client) && client->status == HTTP_200_OK &&
+	    !(client->state == HTTP_CLIENT_SEND && client->response == HTTP_RESPONSE_DONE)) {
+		(void)dynamic_cb(client, HTTP_SERVER_DATA_ABORTED, NULL, 0);
+	}
+
+	(void)zsock_close(client->fd);
+
+	get_service(client->service)->clients--;
+
+	client->fd = -1;
+	client->state = HTTP_CLIENT_FREE;
+
+	fds[FD_CLIENTS + idx].fd = -1;
+	fds[FD_CLIENTS + idx].events = 0;
+}
+
+static void client_init(struct http_client_ctx *client, int fd,
+			const struct http_service_desc *svc)
+{
+	client->fd = fd;
+	client->service = svc;
+	client->resource = NULL;
+	client->state = HTTP_CLIENT_RECV;
+	client->data_len = 0;
+	client->tx_buf_len = 0;
+	client->tx_len = 0;
+	client->timeout = k_uptime_get() + INACTIVITY_TIMEOUT_MS;
+
+	http_parser_init(&client->parser, HTTP_REQUEST);
+}
+
+static void header_append(struct http_client_ctx *client, size_t *len,
+			  const char *fmt, ...)
+{
+	size_t size = sizeof(client->tx_buf);
+	va_list ap;
+	int ret;
+
+	va_start(ap, fmt);
+	ret = vsnprintk((char *)client->tx_buf + *len, size - *len, fmt, ap);
+	va_end(ap);
+
+	if (ret > 0) {
+		*len = MIN(*len + ret, size - 1);
+	}
+}
+
+/* Queue the status line and the headers of the response */
+static void response_headers(struct http_client_ctx *client)
+{
+	const struct http_resource_detail *res = client->resource;
+	size_t len = 0;
+
+	header_append(client, &len, "HTTP/1.1 %u %s\r\n", client->status,
+		      status_reason(client->status));
+
+	if (client->status != HTTP_200_OK) {
+		header_append(client, &len, "Content-Length: 0\r\n");
+		client->response = HTTP_RESPONSE_DONE;
+	} else {
+		if (res->content_type != NULL) {
+			header_append(client, &len, "Content-Type: %s\r\n",
+				      res->content_type);
+		}
+
+		if (res->content_encoding != NULL) {
+			header_append(client, &len, "Content-Encoding: %s\r\n",
+				      res->content_encoding);
+		}
+
+		if (res->type == HTTP_RESOURCE_TYPE_STATIC) {
+			const struct http_resource_detail_static *st =
+				(const struct http_resource_detail_static *)res;
+
+			header_append(client, &len, "Content-Length: %zu\r\n",
+				      st->static_data_len);
+
+			/* The content goes out straight from where it is stored */
+			if (!client->head) {
+				client->tx_data = st->static_data;
+				client->tx_len = st->static_data_len;
+			}
+
+			client->response = HTTP_RESPONSE_DONE;
+		} else {
+			/* HTTP/1.0 has no chunked encoding, the end of the
+			 * response is marked by closing the connection.
+			 */
+			client->chunked = client->parser.http_major > 1 ||
+					  client->parser.http_minor > 0;
+			if (client->chunked) {
+				header_append(client, &len, "Transfer-Encoding: chunked\r\n");
+			} else {
+				client->keep_alive = false;
+			}
+
+			client->response = client->head ? HTTP_RESPONSE_DONE :
+							  HTTP_RESPONSE_BODY;
+		}
+	}
+
+	if (!client->keep_alive) {
+		header_append(client, &len, "Connection: close\r\n");
+	} else if (client->parser.http_major == 1 && client->parser.http_minor == 0) {
+		header_append(client, &len, "Connection: keep-alive\r\n");
+	}
+
+	header_append(client, &len, "\r\n");
+
+	client->tx_buf_data = client->tx_buf;
+	client->tx_buf_len = len;
+}
+
+/* Queue the next chunk of a dynamic response */
+static int response_body(struct http_client_ctx *client)
+{
+	uint8_t *data = client->tx_buf + CHUNK_HDR_ROOM;
+	size_t room = sizeof(client->tx_buf) - CHUNK_HDR_ROOM - CHUNK_TRAILER_LEN;
+	char hdr[CHUNK_HDR_ROOM + 1];
+	int hdr_len;
+	int ret;
+
+	ret = dynamic_cb(client, HTTP_SERVER_DATA_RESPONSE, data, room);
+	if (ret < 0) {
+		/* The status line is gone already, all we can do is close */
+		return ret;
+	}
+
+	ret = MIN((size_t)ret, room);
+
+	if (!client->chunked) {
+		client->tx_buf_data = data;
+		client->tx_buf_len = ret;
+
+		if (ret == 0) {
+			client->response = HTTP_RESPONSE_DONE;
+		}
+
+		return 0;
+	}
+
+	if (ret == 0) {
+		client->tx_buf_data = (const uint8_t *)LAST_CHUNK;
+		client->tx_buf_len = sizeof(LAST_CHUNK) - 1;
+		client->response = HTTP_RESPONSE_DONE;
+
+		return 0;
+	}
+
+	/* Frame the data where it is, the size line goes right before it */
+	hdr_len = snprintk(hdr, sizeof(hdr), "%x\r\n", ret);
+	memcpy(data - hdr_len, hdr, hdr_len);
+	memcpy(data + ret, "\r\n", CHUNK_TRAILER_LEN);
+
+	client->tx_buf_data = data - hdr_len;
+	client->tx_buf_len = hdr_len + ret + CHUNK_TRAILER_LEN;
+
+	return 0;
+}
+
+static int client_parse(struct http_client_ctx *client)
+{
+	enum http_errno err;
+	size_t parsed;
+
+	if (client->data_len == 0) {
+		return 0;
+	}
+
+	parsed = http_parser_execute(&client->parser, &parser_settings,
+				     (const char *)client->buffer, client->data_len);
+
+	err = HTTP_PARSER_ERRNO(&client->parser);
+	if (err != HPE_OK && err != HPE_PAUSED) {
+		LOG_DBG("[%d] Parse error %s", client->fd, http_errno_name(err));
+
+		client->status = HTTP_400_BAD_REQUEST;
+		client->resource = NULL;
+		client->keep_alive = false;
+		client->state = HTTP_CLIENT_SEND;
+		client->response = HTTP_RESPONSE_HEADERS;
+		client->data_len = 0;
+
+		return 0;
+	}
+
+	client->data_len -= parsed;
+	memmove(client->buffer, client->buffer + parsed, client->data_len);
+
+	return 0;
+}
+
+static int client_request_done(struct http_client_ctx *client)
+{
+	if (!client->keep_alive) {
+		return -ECONNRESET;
+	}
+
+	client->state = HTTP_CLIENT_RECV;
+	client->resource = NULL;
+	client->timeout = k_uptime_get() + INACTIVITY_TIMEOUT_MS;
+
+	/* Go on with the requests pipelined behind this one */
+	http_parser_pause(&client->parser, 0);
+
+	return client_parse(client);
+}
+
+static int client_send(struct http_client_ctx *client)
+{
+	struct iovec iov[2];
+	struct msghdr msg;
+	ssize_t sent;
+	size_t len;
+	int ret;
+
+	while (client->state == HTTP_CLIENT_SEND) {
+		if (client->tx_buf_len == 0 && client->tx_len == 0) {
+			if (client->response == HTTP_RESPONSE_HEADERS) {
+				response_headers(client);
+			} else if (client->response == HTTP_RESPONSE_BODY) {
+				ret = response_body(client);
+				if (ret < 0) {
+					return ret;
+				}
+			} else {
+				ret = client_request_done(client);
+				if (ret < 0) {
+					return ret;
+				}
+			}
+
+			continue;
+		}
+
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = iov;
+
+		if (client->tx_buf_len > 0) {
+			iov[msg.msg_iovlen].iov_base = (void *)client->tx_buf_data;
+			iov[msg.msg_iovlen].iov_len = client->tx_buf_len;
+			msg.msg_iovlen++;
+		}
+
+		if (client->tx_len > 0) {
+			iov[msg.msg_iovlen].iov_base = (void *)client->tx_data;
+			iov[msg.msg_iovlen].iov_len = client->tx_len;
+			msg.msg_iovlen++;
+		}
+
+		sent = zsock_sendmsg(client->fd, &msg, ZSOCK_MSG_DONTWAIT);
+		if (sent < 0) {
+			if (errno == EAGAIN) {
+				/* Resumed when the socket is writable */
+				return 0;
+			}
+
+			return -errno;
+		}
+
+		len = MIN((size_t)sent, client->tx_buf_len);
+		client->tx_buf_data += len;
+		client->tx_buf_len -= len;
+		sent -= len;
+
+		client->tx_data += sent;
+		client->tx_len -= sent;
+
+		client->timeout = k_uptime_get() + INACTIVITY_TIMEOUT_MS;
+	}
+
+	return 0;
+}
+
+static int client_recv(struct http_client_ctx *client)
+{
+	ssize_t received;
+	int ret;
+
+	received = zsock_recv(client->fd, client->buffer + client->data_len,
+			      sizeof(client->buffer) - client->data_len,
+			      ZSOCK_MSG_DONTWAIT);
+	if (received == 0) {
+		return -ECONNRESET;
+	} else if (received < 0) {
+		return errno == EAGAIN ? 0 : -errno;
+	}
+
+	client->data_len += received;
+	client->timeout = k_uptime_get() + INACTIVITY_TIMEOUT_MS;
+
+	ret = client_parse(client);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return client_send(client);
+}
+
+static void service_accept(struct http_service_state *svc, int listen_fd)
+{
+	struct http_client_ctx *client = NULL;
+	struct sockaddr addr;
+	socklen_t addrlen = sizeof(addr);
+	int fd;
+	int i;
+
+	fd = zsock_accept(listen_fd, &addr, &addrlen);
+	if (fd < 0) {
+		LOG_DBG("accept failed (%d)", -errno);
+		return;
+	}
+
+	if (svc->clients < svc->desc->concurrent) {
+		for (i = 0; i < MAX_CLIENTS; i++) {
+			if (clients[i].state == HTTP_CLIENT_FREE) {
+				client = &clients[i];
+				break;
+			}
+		}
+	}
+
+	if (client == NULL) {
+		LOG_DBG("No room for new client");
+		(void)zsock_close(fd);
+		return;
+	}
+
+	client_init(client, fd, svc->desc);
+	svc->clients++;
+
+	fds[FD_CLIENTS + i].fd = fd;
+
+	LOG_DBG("[%d] New connection on %s", fd, svc->desc->host);
+}
+
+static int service_listen(const struct http_service_desc *svc)
+{
+	struct sockaddr_storage addr_storage = { 0 };
+	struct sockaddr *addr = (struct sockaddr *)&addr_storage;
+	socklen_t addrlen;
+	int optval = 1;
+	int fd, ret;
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) &&
+	    zsock_inet_pton(AF_INET6, svc->host, &net_sin6(addr)->sin6_addr) == 1) {
+		addr->sa_family = AF_INET6;
+	} else if (IS_ENABLED(CONFIG_NET_IPV4) &&
+		   zsock_inet_pton(AF_INET, svc->host, &net_sin(addr)->sin_addr) == 1) {
+		addr->sa_family = AF_INET;
+	} else {
+		/* A host name, or a virtual host, listen on any address */
+		addr->sa_family = IS_ENABLED(CONFIG_NET_IPV4) ? AF_INET : AF_INET6;
+	}
+
+	if (addr->sa_family == AF_INET6) {
+		net_sin6(addr)->sin6_port = htons(*svc->port);
+		addrlen = sizeof(struct sockaddr_in6);
+	} else {
+		net_sin(addr)->sin_port = htons(*svc->port);
+		addrlen = sizeof(struct sockaddr_in);
+	}
+
+	fd = zsock_socket(addr->sa_family, SOCK_STREAM, IPPROTO_TCP);
+	if (fd < 0) {
+		LOG_ERR("Cannot create socket for %s (%d)", svc->host, -errno);
+		return -errno;
+	}
+
+	(void)zsock_setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval));
+
+	if (zsock_bind(fd, addr, addrlen) < 0) {
+		ret = -errno;
+		LOG_ERR("Cannot bind %s:%u (%d)", svc->host, *svc->port, ret);
+		goto fail;
+	}
+
+	if (*svc->port == 0) {
+		/* Let the application know which ephemeral port was taken */
+		if (zsock_getsockname(fd, addr, &addrlen) < 0) {
+			ret = -errno;
+			goto fail;
+		}
+
+		*svc->port = ntohs(addr->sa_family == AF_INET6 ?
+				   net_sin6(addr)->sin6_port : net_sin(addr)->sin_port);
+	}
+
+	if (zsock_listen(fd, svc->backlog) < 0) {
+		ret = -errno;
+		LOG_ERR("Cannot listen on %s:%u (%d)", svc->host, *svc->port, ret);
+		goto fail;
+	}
+
+	LOG_DBG("Listening on %s:%u", svc->host, *svc->port);
+
+	return fd;
+
+fail:
+	(void)zsock_close(fd);
+
+	return ret;
+}
+
+/* Close the clients and the polled sockets, the sending end of the wake
+ * up socket is closed by server_wake_close().
+ */
+static void server_close_all(void)
+{
+	int i;
+
+	for (i = 0; i < MAX_CLIENTS; i++) {
+		if (clients[i].state != HTTP_CLIENT_FREE) {
+			client_close(&clients[i]);
+		}
+	}
+
+	for (i = 0; i < FD_COUNT; i++) {
+		if (fds[i].fd >= 0) {
+			(void)zsock_close(fds[i].fd);
+			fds[i].fd = -1;
+		}
+	}
+}
+
+static void server_wake_close(void)
+{
+	if (wake_fd[0] >= 0) {
+		(void)zsock_close(wake_fd[0]);
+		wake_fd[0] = -1;
+	}
+}
+
+/* Close the idle clients, returns the poll timeout until the next one */
+static int server_check_timeouts(void)
+{
+	int64_t now = k_uptime_get();
+	int64_t next = INT64_MAX;
+	int i;
+
+	for (i = 0; i < MAX_CLIENTS; i++) {
+		if (clients[i].state == HTTP_CLIENT_FREE) {
+			continue;
+		}
+
+		if (clients[i].timeout <= now) {
+			LOG_DBG("[%d] Inactivity timeout", clients[i].fd);
+			client_close(&clients[i]);
+			continue;
+		}
+
+		next = MIN(next, clients[i].timeout);
+	}
+
+	return next == INT64_MAX ? -1 : (int)(next - now);
+}
+
+static void server_loop(void *p1, void *p2, void *p3)
+{
+	struct http_client_ctx *client;
+	int timeout;
+	int ret;
+	int i;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		/* Only the direction a client is waiting for is polled, so a
+		 * client sending a response does not read further requests.
+		 */
+		for (i = 0; i < MAX_CLIENTS; i++) {
+			if (clients[i].state != HTTP_CLIENT_FREE) {
+				fds[FD_CLIENTS + i].events =
+					clients[i].state == HTTP_CLIENT_SEND ?
+					ZSOCK_POLLOUT : ZSOCK_POLLIN;
+			}
+		}
+
+		timeout = server_check_timeouts();
+
+		ret = zsock_poll(fds, FD_COUNT, timeout);
+		if (ret < 0) {
+			ret = -errno;
+
+			if (ret == -ENOMEM || ret == -EINTR || ret == -EAGAIN) {
+				/* Keep serving the clients connected */
+				LOG_WRN("poll failed (%d), retrying", ret);
+				k_msleep(POLL_ERROR_DELAY_MS);
+				continue;
+			}
+
+			LOG_ERR("poll failed (%d)", ret);
+			break;
+		}
+
+		if (fds[FD_WAKE].revents) {
+			break;
+		}
+
+		for (i = 0; i < MAX_SERVICES; i++) {
+			if (fds[FD_SERVICES + i].revents & ZSOCK_POLLIN) {
+				service_accept(&services[i], fds[FD_SERVICES + i].fd);
+			}
+		}
+
+		for (i = 0; i < MAX_CLIENTS; i++) {
+			short revents = fds[FD_CLIENTS + i].revents;
+
+			client = &clients[i];
+
+			if (client->state == HTTP_CLIENT_FREE || revents == 0) {
+				continue;
+			}
+
+			if (revents & (ZSOCK_POLLERR | ZSOCK_POLLNVAL)) {
+				client_close(client);
+				continue;
+			}
+
+			if (client->state == HTTP_CLIENT_SEND) {
+				ret = client_send(client);
+			} else {
+				ret = client_recv(client);
+			}
+
+			if (ret < 0) {
+				client_close(client);
+			}
+		}
+	}
+
+	server_close_all();
+
+	/* When the server stops on its own, mark it as stopped so that it
+	 * can be started again. If http_server_stop() holds the lock, it
+	 * joins this thread and does the same.
+	 */
+	if (k_mutex_lock(&server_lock, K_NO_WAIT) == 0) {
+		server_wake_close();
+		server_running = false;
+		k_mutex_unlock(&server_lock);
+	}
+}
+
+int http_server_start(void)
+{
+	size_t count = 0;
+	int ret = 0;
+	int i;
+
+	k_mutex_lock(&server_lock, K_FOREVER);
+
+	if (server_running) {
+		ret = -EALREADY;
+		goto out;
+	}
+
+	for (i = 0; i < FD_COUNT; i++) {
+		fds[i].fd = -1;
+		fds[i].events = 0;
+	}
+
+	for (i = 0; i < MAX_SERVICES; i++) {
+		services[i].desc = NULL;
+		services[i].clients = 0;
+	}
+
+	for (i = 0; i < MAX_CLIENTS; i++) {
+		clients[i].fd = -1;
+		clients[i].state = HTTP_CLIENT_FREE;
+	}
+
+	HTTP_SERVICE_FOREACH(svc) {
+		if (count == MAX_SERVICES) {
+			LOG_ERR("Too many services, max %d", MAX_SERVICES);
+			ret = -ENOMEM;
+			goto fail;
+		}
+
+		ret = service_listen(svc);
+		if (ret < 0) {
+			goto fail;
+		}
+
+		services[count].desc = svc;
+		services[count].clients = 0;
+
+		fds[FD_SERVICES + count].fd = ret;
+		fds[FD_SERVICES + count].events = ZSOCK_POLLIN;
+		count++;
+	}
+
+	ret = zsock_socketpair(AF_UNIX, SOCK_STREAM, 0, wake_fd);
+	if (ret < 0) {
+		ret = -errno;
+		LOG_ERR("Cannot create wake up socket (%d)", ret);
+		goto fail;
+	}
+
+	fds[FD_WAKE].fd = wake_fd[1];
+	fds[FD_WAKE].events = ZSOCK_POLLIN;
+
+	LOG_DBG("%zu services, %zu bytes per client", count,
+		sizeof(struct http_client_ctx));
+
+	k_thread_create(&server_thread, server_stack,
+			K_KERNEL_STACK_SIZEOF(server_stack), server_loop,
+			NULL, NULL, NULL, THREAD_PRIORITY, 0, K_NO_WAIT);
+	k_thread_name_set(&server_thread, "http_server");
+
+	server_running = true;
+	ret = 0;
+	goto out;
+
+fail:
+	server_close_all();
+	server_wake_close();
+
+out:
+	k_mutex_unlock(&server_lock);
+
+	return ret;
+}
+
+int http_server_stop(void)
+{
+	int ret = 0;
+
+	k_mutex_lock(&server_lock, K_FOREVER);
+
+	if (!server_running) {
+		ret = -EALREADY;
+		goto out;
+	}
+
+	/* The thread may have stopped on its own, in which case the wake up
+	 * fails but the thread is joined all the same.
+	 */
+	(void)zsock_send(wake_fd[0], "x", 1, 0);
+	(void)k_thread_join(&server_thread, K_FOREVER);
+
+	server_wake_close();
+	server_running = false;
+
+out:
+	k_mutex_unlock(&server_lock);
+
+	return ret;
+}
@@ -30,6 +30,9 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 #include <zephyr/net/lwm2m.h>
 #include <zephyr/net/net_ip.h>
 #include <zephyr/net/socket.h>
+#if defined(CONFIG_LWM2M_ENGINE_SOCKET_SERVICE)
+#include <zephyr/net/socket_service.h>
+#endif
 #include <zephyr/sys/printk.h>
 #include <zephyr/types.h>
 #ifdef CONFIG_ARCH_POSIX
@@ -82,9 +85,11 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 static struct lwm2m_obj_path_list observe_paths[LWM2M_ENGINE_MAX_OBSERVER_PATH];
 #define MAX_PERIODIC_SERVICE 10
 
+#if !defined(CONFIG_LWM2M_ENGINE_SOCKET_SERVICE)
 static k_tid_t engine_thread_id;
 static bool suspend_engine_thread;
 static bool active_engine_thread;
+#endif
 
 struct service_node {
 	sys_snode_t node;
@@ -96,11 +101,39 @@ struct service_node {
 static struct service_node service_node_data[MAX_PERIODIC_SERVICE];
 static sys_slist_t engine_service_list;
 
-static K_KERNEL_STACK_DEFINE(engine_thread_stack, CONFIG_LWM2M_ENGINE_STACK_SIZE);
-static struct k_thread engine_thread_data;
+#if defined(CONFIG_LWM2M_ENGINE_SOCKET_SERVICE)
+/* The socket service polls its wake up socket too */
+#define MAX_POLL_FD (CONFIG_NET_SOCKETS_POLL_MAX - 1)
+
+/* The socket events and the periodic engine work both run on the engine
+ * work queue, so they never run concurrently. The work may block, for
+ * example in a DTLS handshake, so it does not run on the system work
+ * queue.
+ */
+static void socket_event_handler(struct k_work *work);
+static void engine_work_handler(struct k_work *work);
+
+static K_KERNEL_STACK_DEFINE(engine_work_q_stack, CONFIG_LWM2M_ENGINE_STACK_SIZE);
+static struct k_work_q engine_work_q;
+static const struct k_work_queue_config engine_work_q_cfg = {
+	.name = "lwm2m-engine",
+};
 
+NET_SOCKET_SERVICE_ASYNC_DEFINE(lwm2m_socket_service, &engine_work_q, socket_event_handler,
+				MAX_POLL_FD);
+static K_WORK_DELAYABLE_DEFINE(engine_work, engine_work_handler);
+static bool engine_paused;
+static bool engine_rd_client_paused;
+/* Set last handed to the socket service, -1 when nothing is registered */
+static struct zsock_pollfd registered_fds[MAX_POLL_FD];
+static int registered_nfds = -1;
+#else
 #define MAX_POLL_FD CONFIG_NET_SOCKETS_POLL_MAX
 
+static K_KERNEL_STACK_DEFINE(engine_thread_stack, CONFIG_LWM2M_ENGINE_STACK_SIZE);
+static struct k_thread engine_thread_data;
+#endif
+
 /* Resources */
 static struct zsock_pollfd sock_fds[MAX_POLL_FD];
 
@@ -116,6 +149,7 @@ int lwm2m_sock_nfds(void) { return sock_nfds; }
 struct lwm2m_block_context *lwm2m_block1_context(void) { return block1_contexts; }
 
 static int lwm2m_socket_update(struct lwm2m_ctx *ctx);
+static void socket_service_update(void);
 
 /* for debugging: to print IP addresses */
 char *lwm2m_sprint_ip_addr(const struct sockaddr *addr)
@@ -272,6 +306,8 @@ int lwm2m_push_queued_buffers(struct lwm2m_ctx *client_ctx)
 		msg = SYS_SLIST_CONTAINER(msg_node, msg, node);
 		sys_slist_append(&msg->ctx->pending_sends, &msg->node);
 	}
+
+	lwm2m_engine_wake_up();
 #endif
 	return 0;
 }
@@ -534,6 +570,8 @@ int lwm2m_socket_add(struct lwm2m_ctx *ctx)
 	sock_fds[sock_nfds].events = ZSOCK_POLLIN;
 	sock_nfds++;
 
+	socket_service_update();
+
 	return 0;
 }
 
@@ -544,6 +582,7 @@ static int lwm2m_socket_update(struct lwm2m_ctx *ctx)
 			continue;
 		}
 		sock_fds[i].fd = ctx->sock_fd;
+		socket_service_update();
 		return 0;
 	}
 	return -1;
@@ -568,22 +607,24 @@ void lwm2m_socket_del(struct lwm2m_ctx *ctx)
 		/* Remove the last entry. */
 		sock_ctx[sock_nfds] = NULL;
 		sock_fds[sock_nfds].fd = -1;
+		socket_service_update();
 		break;
 	}
 }
 
 static void check_notifications(struct lwm2m_ctx *ctx, const int64_t timestamp)
 {
-	struct observe_node *obs;
+	struct observe_node *obs, *tmp;
 	int rc;
 
 	lwm2m_registry_lock();
-	SYS_SLIST_FOR_EACH_CONTAINER(&ctx->observer, obs, node) {
-		if (!obs->event_timestamp || timestamp < obs->event_timestamp) {
-			continue;
+	/* Observers are sorted by their next event, stop at the first one not due */
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(lwm2m_obs_deadline_list(), obs, tmp, deadline_node) {
+		if (timestamp < obs->event_timestamp) {
+			break;
 		}
 		/* Check That There is not pending process*/
-		if (obs->active_tx_operation) {
+		if (obs->ctx != ctx || obs->active_tx_operation) {
 			continue;
 		}
 
@@ -592,8 +633,9 @@ static void check_notifications(struct lwm2m_ctx *ctx, const int64_t timestamp)
 			/* no memory/messages available, retry later */
 			goto cleanup;
 		}
-		obs->event_timestamp =
-			engine_observe_shedule_next_event(obs, ctx->srv_obj_inst, timestamp);
+		/* Moves the observer after the due ones, or out of the list */
+		engine_observe_schedule(
+			obs, engine_observe_shedule_next_event(obs, ctx->srv_obj_inst, timestamp));
 		obs->last_timestamp = timestamp;
 		if (!rc) {
 			/* create at most one notification */
@@ -682,12 +724,184 @@ static void socket_reset_pollfd_events(void)
 	}
 }
 
+/* Run the periodic services, retransmissions and notifications, returns the
+ * time until the next run.
+ */
+static int32_t engine_process(const int64_t timestamp)
+{
+	int32_t timeout, next_retransmit;
+	int i;
+
+	timeout = lwm2m_engine_service(timestamp);
+
+	for (i = 0; i < sock_nfds; ++i) {
+		if (sock_ctx[i] != NULL &&
+		    sys_slist_is_empty(&sock_ctx[i]->pending_sends)) {
+			next_retransmit = retransmit_request(sock_ctx[i], timestamp);
+			if (next_retransmit < timeout) {
+				timeout = next_retransmit;
+			}
+		}
+		if (sock_ctx[i] != NULL &&
+		    sys_slist_is_empty(&sock_ctx[i]->pending_sends) &&
+		    lwm2m_rd_client_is_registred(sock_ctx[i])) {
+			check_notifications(sock_ctx[i], timestamp);
+		}
+	}
+
+	return timeout;
+}
+
+static void socket_handle_events(int i, short revents)
+{
+	int rc;
+
+	if (sock_ctx[i] != NULL && sock_ctx[i]->sock_fd < 0) {
+		return;
+	}
+
+	if ((revents & ZSOCK_POLLERR) ||
+	    (revents & ZSOCK_POLLNVAL) ||
+	    (revents & ZSOCK_POLLHUP)) {
+		LOG_ERR("Poll reported a socket error, %02x.", revents);
+		if (sock_ctx[i] != NULL && sock_ctx[i]->fault_cb != NULL) {
+			sock_ctx[i]->fault_cb(EIO);
+		}
+		return;
+	}
+
+	if (revents & ZSOCK_POLLIN) {
+		while (sock_ctx[i]) {
+			rc = socket_recv_message(sock_ctx[i]);
+			if (rc) {
+				break;
+			}
+		}
+	}
+
+	if (revents & ZSOCK_POLLOUT) {
+		rc = socket_send_message(sock_ctx[i]);
+		/* Drop packets that cannot be send, CoAP layer handles retry */
+		/* Other fatal errors should trigger a recovery */
+		if (rc < 0 && rc != -EAGAIN) {
+			LOG_ERR("send() reported a socket error, %d", -rc);
+			if (sock_ctx[i] != NULL && sock_ctx[i]->fault_cb != NULL) {
+				sock_ctx[i]->fault_cb(-rc);
+			}
+		}
+	}
+}
+
+#if defined(CONFIG_LWM2M_ENGINE_SOCKET_SERVICE)
+/* Register the sockets, polling for POLLOUT only when there is something
+ * to send.
+ */
+static void socket_service_update(void)
+{
+	int ret;
+
+	if (engine_paused) {
+		return;
+	}
+
+	socket_reset_pollfd_events();
+
+	/* Every registration wakes up the service thread to rebuild its poll
+	 * set. The service polls a socket again by itself once its event has
+	 * been handled, so only register when the sockets or their events
+	 * have changed.
+	 */
+	if (registered_nfds == sock_nfds) {
+		int i;
+
+		for (i = 0; i < sock_nfds; i++) {
+			if (registered_fds[i].fd != sock_fds[i].fd ||
+			    registered_fds[i].events != sock_fds[i].events) {
+				break;
+			}
+		}
+
+		if (i == sock_nfds) {
+			return;
+		}
+	}
+
+	ret = net_socket_service_register(&lwm2m_socket_service, sock_fds, sock_nfds, NULL);
+	if (ret < 0) {
+		LOG_ERR("Cannot register sockets (%d)", ret);
+		registered_nfds = -1;
+		return;
+	}
+
+	memcpy(registered_fds, sock_fds, sock_nfds * sizeof(sock_fds[0]));
+	registered_nfds = sock_nfds;
+}
+
+static void socket_event_handler(struct k_work *work)
+{
+	struct net_socket_service_event *pev =
+		CONTAINER_OF(work, struct net_socket_service_event, work);
+	int i;
+
+	if (engine_paused) {
+		return;
+	}
+
+	/* Sockets may have been added or removed since the event */
+	for (i = 0; i < sock_nfds; i++) {
+		if (sock_fds[i].fd == pev->event.fd) {
+			break;
+		}
+	}
+
+	if (i == sock_nfds) {
+		return;
+	}
+
+	socket_handle_events(i, pev->event.revents);
+
+	socket_service_update();
+}
+
+static void engine_work_handler(struct k_work *work)
+{
+	int32_t timeout;
+
+	ARG_UNUSED(work);
+
+	if (engine_paused) {
+		return;
+	}
+
+	timeout = engine_process(k_uptime_get());
+
+	socket_service_update();
+
+	/* Keeps an earlier run requested meanwhile */
+	k_work_schedule_for_queue(&engine_work_q, &engine_work, K_MSEC(timeout));
+}
+
+void lwm2m_engine_wake_up(void)
+{
+	if (!engine_paused) {
+		k_work_reschedule_for_queue(&engine_work_q, &engine_work, K_NO_WAIT);
+	}
+}
+#else
+static void socket_service_update(void)
+{
+}
+
+void lwm2m_engine_wake_up(void)
+{
+}
+
 /* LwM2M main work loop */
 static void socket_loop(void)
 {
 	int i, rc;
 	int64_t timestamp;
-	int32_t timeout, next_retransmit;
+	int32_t timeout;
 	bool rd_client_paused;
 
 	while (1) {
@@ -715,7 +929,7 @@ static void socket_loop(void)
 		}
 
 		timestamp = k_uptime_get();
-		timeout = lwm2m_engine_service(timestamp);
+		timeout = engine_process(timestamp);
 
 		/* wait for sockets */
 		if (sock_nfds < 1) {
@@ -723,21 +937,6 @@ static void socket_loop(void)
 			continue;
 		}
 
-		for (i = 0; i < sock_nfds; ++i) {
-			if (sock_ctx[i] != NULL &&
-			    sys_slist_is_empty(&sock_ctx[i]->pending_sends)) {
-				next_retransmit = retransmit_request(sock_ctx[i], timestamp);
-				if (next_retransmit < timeout) {
-					timeout = next_retransmit;
-				}
-			}
-			if (sock_ctx[i] != NULL &&
-			    sys_slist_is_empty(&sock_ctx[i]->pending_sends) &&
-			    lwm2m_rd_client_is_registred(sock_ctx[i])) {
-				check_notifications(sock_ctx[i], timestamp);
-			}
-		}
-
 		socket_reset_pollfd_events();
 
 		/*
@@ -753,44 +952,11 @@ static void socket_loop(void)
 		}
 
 		for (i = 0; i < sock_nfds; i++) {
-
-			if (sock_ctx[i] != NULL && sock_ctx[i]->sock_fd < 0) {
-				continue;
-			}
-
-			if ((sock_fds[i].revents & ZSOCK_POLLERR) ||
-			    (sock_fds[i].revents & ZSOCK_POLLNVAL) ||
-			    (sock_fds[i].revents & ZSOCK_POLLHUP)) {
-				LOG_ERR("Poll reported a socket error, %02x.", sock_fds[i].revents);
-				if (sock_ctx[i] != NULL && sock_ctx[i]->fault_cb != NULL) {
-					sock_ctx[i]->fault_cb(EIO);
-				}
-				continue;
-			}
-
-			if (sock_fds[i].revents & ZSOCK_POLLIN) {
-				while (sock_ctx[i]) {
-					rc = socket_recv_message(sock_ctx[i]);
-					if (rc) {
-						break;
-					}
-				}
-			}
-
-			if (sock_fds[i].revents & ZSOCK_POLLOUT) {
-				rc = socket_send_message(sock_ctx[i]);
-				/* Drop packets that cannot be send, CoAP layer handles retry */
-				/* Other fatal errors should trigger a recovery */
-				if (rc < 0 && rc != -EAGAIN) {
-					LOG_ERR("send() reported a socket error, %d", -rc);
-					if (sock_ctx[i] != NULL && sock_ctx[i]->fault_cb != NULL) {
-						sock_ctx[i]->fault_cb(-rc);
-					}
-				}
-			}
+			socket_handle_events(i, sock_fds[i].revents);
 		}
 	}
 }
+#endif /* CONFIG_LWM2M_ENGINE_SOCKET_SERVICE */
 
 #if defined(CONFIG_LWM2M_DTLS_SUPPORT) && defined(CONFIG_TLS_CREDENTIALS)
 static int load_tls_credential(struct lwm2m_ctx *client_ctx, uint16_t res_id,
@@ -990,6 +1156,58 @@ int lwm2m_engine_start(struct lwm2m_ctx *client_ctx)
 	return lwm2m_socket_start(client_ctx);
 }
 
+#if defined(CONFIG_LWM2M_ENGINE_SOCKET_SERVICE)
+int lwm2m_engine_pause(void)
+{
+	struct k_work_sync sync;
+	int rc;
+
+	if (engine_paused) {
+		LOG_WRN("Engine already paused");
+		return 0;
+	}
+
+	engine_paused = true;
+	(void)k_work_cancel_delayable_sync(&engine_work, &sync);
+	(void)net_socket_service_unregister(&lwm2m_socket_service);
+	registered_nfds = -1;
+
+	rc = lwm2m_rd_client_pause();
+	engine_rd_client_paused = (rc == 0);
+	if (rc < 0) {
+		LOG_ERR("Could not pause RD client");
+	}
+
+	LOG_INF("LWM2M engine paused");
+	return 0;
+}
+
+int lwm2m_engine_resume(void)
+{
+	int rc;
+
+	if (!engine_paused) {
+		LOG_WRN("LWM2M engine state not ok for resume");
+		return -EPERM;
+	}
+
+	engine_paused = false;
+
+	if (engine_rd_client_paused) {
+		engine_rd_client_paused = false;
+		rc = lwm2m_rd_client_resume();
+		if (rc < 0) {
+			LOG_ERR("Could not resume RD client");
+		}
+	}
+
+	socket_service_update();
+	k_work_reschedule_for_queue(&engine_work_q, &engine_work, K_NO_WAIT);
+
+	LOG_INF("LWM2M engine resume");
+	return 0;
+}
+#else
 int lwm2m_engine_pause(void)
 {
 	if (suspend_engine_thread || !active_engine_thread) {
@@ -1020,6 +1238,7 @@ int lwm2m_engine_resume(void)
 	LOG_INF("LWM2M engine thread resume");
 	return 0;
 }
+#endif /* CONFIG_LWM2M_ENGINE_SOCKET_SERVICE */
 
 static int lwm2m_engine_init(const struct device *dev)
 {
@@ -1036,6 +1255,15 @@ static int lwm2m_engine_init(const struct device *dev)
 		lwm2m_engine_data_cache_init();
 	}
 
+#if defined(CONFIG_LWM2M_ENGINE_SOCKET_SERVICE)
+	/* Sockets are polled by the socket service, their events and the
+	 * engine work are handled by the engine work queue.
+	 */
+	k_work_queue_start(&engine_work_q, engine_work_q_stack,
+			   K_KERNEL_STACK_SIZEOF(engine_work_q_stack), THREAD_PRIORITY,
+			   &engine_work_q_cfg);
+	k_work_schedule_for_queue(&engine_work_q, &engine_work, K_NO_WAIT);
+#else
 	/* start sock receive thread */
 	engine_thread_id = k_thread_create(&engine_thread_data, &engine_thread_stack[0],
 			K_KERNEL_STACK_SIZEOF(engine_thread_stack), (k_thread_entry_t)socket_loop,
@@ -1043,6 +1271,7 @@ static int lwm2m_engine_init(const struct device *dev)
 	k_thread_name_set(&engine_thread_data, "lwm2m-sock-recv");
 	LOG_DBG("LWM2M engine socket receive thread started");
 	active_engine_thread = true;
+#endif
 
 	return 0;
 }
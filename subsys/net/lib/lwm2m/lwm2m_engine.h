@@ -312,6 +312,13 @@ int lwm2m_engine_close_socket_connection(struct lwm2m_ctx *client_ctx);
  */
 int lwm2m_engine_connection_resume(struct lwm2m_ctx *client_ctx);
 
+/**
+ * @brief Runs the engine work as soon as possible, to pick up new pending messages.
+ *
+ * Only needed when the sockets are polled by the socket service, a no-op otherwise.
+ */
+void lwm2m_engine_wake_up(void);
+
 /**
  * @brief Moves all queued messages to pending.
  *
@@ -406,6 +406,7 @@ int lwm2m_send_message_async(struct lwm2m_message *msg)
 	}
 #endif
 	sys_slist_append(&msg->ctx->pending_sends, &msg->node);
+	lwm2m_engine_wake_up();
 
 	if (IS_ENABLED(CONFIG_LWM2M_QUEUE_MODE_ENABLED)) {
 		engine_update_tx_time();
@@ -489,7 +490,6 @@ int lwm2m_register_payload_handler(struct lwm2m_message *msg)
 	struct lwm2m_engine_obj_inst *obj_inst;
 	int ret;
 	sys_slist_t *engine_obj_list = lwm2m_engine_obj_list();
-	sys_slist_t *engine_obj_inst_list = lwm2m_engine_obj_inst_list();
 
 	ret = engine_put_begin(&msg->out, NULL);
 	if (ret < 0) {
@@ -516,14 +516,11 @@ int lwm2m_register_payload_handler(struct lwm2m_message *msg)
 			}
 		}
 
-		SYS_SLIST_FOR_EACH_CONTAINER(engine_obj_inst_list, obj_inst, node) {
-			if (obj_inst->obj->obj_id == obj->obj_id) {
-				ret = engine_put_corelink(
-					&msg->out,
-					&LWM2M_OBJ(obj_inst->obj->obj_id, obj_inst->obj_inst_id));
-				if (ret < 0) {
-					return ret;
-				}
+		SYS_SLIST_FOR_EACH_CONTAINER(&obj->inst_list, obj_inst, obj_node) {
+			ret = engine_put_corelink(
+				&msg->out, &LWM2M_OBJ(obj_inst->obj->obj_id, obj_inst->obj_inst_id));
+			if (ret < 0) {
+				return ret;
 			}
 		}
 	}
@@ -1524,7 +1521,6 @@ int lwm2m_discover_handler(struct lwm2m_message *msg, bool is_bootstrap)
 	int ret;
 	bool reported = false;
 	sys_slist_t *engine_obj_list = lwm2m_engine_obj_list();
-	sys_slist_t *engine_obj_inst_list = lwm2m_engine_obj_inst_list();
 
 	/* Object ID is required in Device Management Discovery (5.4.2). */
 	if (!is_bootstrap && (msg->path.level == LWM2M_PATH_LEVEL_NONE ||
@@ -1586,11 +1582,7 @@ int lwm2m_discover_handler(struct lwm2m_message *msg, bool is_bootstrap)
 			}
 		}
 
-		SYS_SLIST_FOR_EACH_CONTAINER(engine_obj_inst_list, obj_inst, node) {
-			if (obj_inst->obj->obj_id != obj->obj_id) {
-				continue;
-			}
-
+		SYS_SLIST_FOR_EACH_CONTAINER(&obj->inst_list, obj_inst, obj_node) {
 			/* Skip unrelated object instance. */
 			if (msg->path.level > LWM2M_PATH_LEVEL_OBJECT &&
 			    msg->path.obj_inst_id != obj_inst->obj_inst_id) {
@@ -186,6 +186,12 @@ struct lwm2m_engine_obj {
 	/* object list */
 	sys_snode_t node;
 
+	/* registry hash table bucket */
+	sys_snode_t hash_node;
+
+	/* instances of this object, sorted by instance ID */
+	sys_slist_t inst_list;
+
 	/* object field definitions */
 	struct lwm2m_engine_obj_field *fields;
 
@@ -207,6 +213,9 @@ struct lwm2m_engine_obj {
 
 	/* Object is a core object (defined in the official LwM2M spec.) */
 	bool is_core : 1;
+
+	/* Fields are sorted by resource ID, set when registered */
+	bool fields_sorted : 1;
 };
 
 /* Resource instances with this value are considered "not created" yet */
@@ -406,6 +415,12 @@ struct lwm2m_engine_obj_inst {
 	/* instance list */
 	sys_snode_t node;
 
+	/* registry hash table bucket */
+	sys_snode_t hash_node;
+
+	/* instance list of the object */
+	sys_snode_t obj_node;
+
 	struct lwm2m_engine_obj *obj;
 	struct lwm2m_engine_res *resources;
 
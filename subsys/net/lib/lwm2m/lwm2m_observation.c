@@ -59,17 +59,32 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 #define COAP_OPTION_BUF_LEN 13
 #endif
 
+#define OBSERVER_INDEX_SIZE CONFIG_LWM2M_ENGINE_OBSERVER_INDEX_SIZE
+
+/* Index key of the observers of a whole object */
+#define OBSERVER_INDEX_ANY_INST UINT16_MAX
+
 /* Resources */
 static sys_slist_t obs_obj_path_list;
 
 static struct observe_node observe_node_data[CONFIG_LWM2M_ENGINE_MAX_OBSERVER];
 
+/* Single path observers, by object and object instance ID of the path */
+static sys_dlist_t observer_index[OBSERVER_INDEX_SIZE];
+
+/* Composite observers, their paths may span several objects */
+static sys_dlist_t composite_observer_list = SYS_DLIST_STATIC_INIT(&composite_observer_list);
+
+/* Observers with a pending event, the earliest first */
+static sys_dlist_t observer_deadline_list = SYS_DLIST_STATIC_INIT(&observer_deadline_list);
+
 /* External resources */
 struct lwm2m_ctx **lwm2m_sock_ctx(void);
 
 int lwm2m_sock_nfds(void);
 /* Resource wrappers */
 sys_slist_t *lwm2m_obs_obj_path_list(void) { return &obs_obj_path_list; }
+sys_dlist_t *lwm2m_obs_deadline_list(void) { return &observer_deadline_list; }
 
 struct notification_attrs {
 	/* use to determine which value is set */
@@ -333,50 +348,165 @@ int engine_observe_attribute_list_get(sys_slist_t *path_list, struct notificatio
 	return 0;
 }
 
-int lwm2m_notify_observer_path(const struct lwm2m_obj_path *path)
+void engine_observe_schedule(struct observe_node *obs, int64_t timestamp)
+{
+	struct observe_node *iter;
+
+	if (sys_dnode_is_linked(&obs->deadline_node)) {
+		sys_dlist_remove(&obs->deadline_node);
+	}
+
+	obs->event_timestamp = timestamp;
+	if (!timestamp) {
+		return;
+	}
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&observer_deadline_list, iter, deadline_node) {
+		if (iter->event_timestamp > timestamp) {
+			sys_dlist_insert(&iter->deadline_node, &obs->deadline_node);
+			return;
+		}
+	}
+
+	sys_dlist_append(&observer_deadline_list, &obs->deadline_node);
+}
+
+static sys_dlist_t *observer_index_bucket(uint16_t obj_id, uint16_t obj_inst_id)
+{
+	return &observer_index[((uint32_t)obj_id * 2654435761U + obj_inst_id) %
+			       OBSERVER_INDEX_SIZE];
+}
+
+static void observer_index_add(struct observe_node *obs)
+{
+	struct lwm2m_obj_path_list *o_p;
+
+	if (obs->composite) {
+		sys_dlist_append(&composite_observer_list, &obs->index_node);
+		return;
+	}
+
+	o_p = SYS_SLIST_PEEK_HEAD_CONTAINER(&obs->path_list, o_p, node);
+	if (!o_p) {
+		return;
+	}
+
+	sys_dlist_append(observer_index_bucket(o_p->path.obj_id,
+					       o_p->path.level >= LWM2M_PATH_LEVEL_OBJECT_INST
+						       ? o_p->path.obj_inst_id
+						       : OBSERVER_INDEX_ANY_INST),
+			 &obs->index_node);
+}
+
+static void observer_index_remove(struct observe_node *obs)
+{
+	if (sys_dnode_is_linked(&obs->index_node)) {
+		sys_dlist_remove(&obs->index_node);
+	}
+
+	if (sys_dnode_is_linked(&obs->deadline_node)) {
+		sys_dlist_remove(&obs->deadline_node);
+	}
+}
+
+static int lwm2m_notify_observer_index(sys_dlist_t *list, const struct lwm2m_obj_path *path)
 {
 	struct observe_node *obs;
 	struct notification_attrs nattrs = {0};
 	int64_t timestamp;
-	int ret = 0;
+	int ret, count = 0;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(list, obs, index_node) {
+		if (!lwm2m_notify_observer_list(&obs->path_list, path)) {
+			continue;
+		}
+
+		/* update the event time for this observer */
+		ret = engine_observe_attribute_list_get(&obs->path_list, &nattrs,
+							obs->ctx->srv_obj_inst);
+		if (ret < 0) {
+			return ret;
+		}
+
+		if (nattrs.pmin) {
+			timestamp = obs->last_timestamp + MSEC_PER_SEC * nattrs.pmin;
+		} else {
+			/* Trig immediately */
+			timestamp = k_uptime_get();
+		}
+
+		if (!obs->event_timestamp || obs->event_timestamp > timestamp) {
+			obs->resource_update = true;
+			engine_observe_schedule(obs, timestamp);
+		}
+
+		LOG_DBG("NOTIFY EVENT %u/%u/%u", path->obj_id, path->obj_inst_id, path->res_id);
+		count++;
+	}
+
+	return count;
+}
+
+static int notify_observer_path(const struct lwm2m_obj_path *path)
+{
+	sys_dlist_t *obj_bucket, *inst_bucket;
+	int count = 0;
+	int ret;
 	int i;
-	struct lwm2m_ctx **sock_ctx = lwm2m_sock_ctx();
 
 	if (path->level < LWM2M_PATH_LEVEL_OBJECT) {
 		return 0;
 	}
 
 	/* look for observers which match our resource */
-	for (i = 0; i < lwm2m_sock_nfds(); ++i) {
-		SYS_SLIST_FOR_EACH_CONTAINER(&sock_ctx[i]->observer, obs, node) {
-			if (lwm2m_notify_observer_list(&obs->path_list, path)) {
-				/* update the event time for this observer */
-				ret = engine_observe_attribute_list_get(&obs->path_list, &nattrs,
-									sock_ctx[i]->srv_obj_inst);
-				if (ret < 0) {
-					return ret;
-				}
+	if (path->level == LWM2M_PATH_LEVEL_OBJECT) {
+		/* Observers of any instance of the object match */
+		for (i = 0; i < OBSERVER_INDEX_SIZE; i++) {
+			ret = lwm2m_notify_observer_index(&observer_index[i], path);
+			if (ret < 0) {
+				return ret;
+			}
 
-				if (nattrs.pmin) {
-					timestamp =
-						obs->last_timestamp + MSEC_PER_SEC * nattrs.pmin;
-				} else {
-					/* Trig immediately */
-					timestamp = k_uptime_get();
-				}
+			count += ret;
+		}
+	} else {
+		obj_bucket = observer_index_bucket(path->obj_id, OBSERVER_INDEX_ANY_INST);
+		inst_bucket = observer_index_bucket(path->obj_id, path->obj_inst_id);
 
-				if (!obs->event_timestamp || obs->event_timestamp > timestamp) {
-					obs->resource_update = true;
-					obs->event_timestamp = timestamp;
-				}
+		ret = lwm2m_notify_observer_index(obj_bucket, path);
+		if (ret < 0) {
+			return ret;
+		}
+
+		count += ret;
 
-				LOG_DBG("NOTIFY EVENT %u/%u/%u", path->obj_id, path->obj_inst_id,
-					path->res_id);
-				ret++;
+		if (inst_bucket != obj_bucket) {
+			ret = lwm2m_notify_observer_index(inst_bucket, path);
+			if (ret < 0) {
+				return ret;
 			}
+
+			count += ret;
 		}
 	}
 
+	ret = lwm2m_notify_observer_index(&composite_observer_list, path);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return count + ret;
+}
+
+int lwm2m_notify_observer_path(const struct lwm2m_obj_path *path)
+{
+	int ret;
+
+	/* The observers are rescheduled in the lists walked by the engine */
+	lwm2m_registry_lock();
+	ret = notify_observer_path(path);
+	lwm2m_registry_unlock();
+
 	return ret;
 }
 
@@ -430,17 +560,19 @@ static void engine_observe_node_init(struct observe_node *obs, const uint8_t *to
 	memcpy(obs->token, token, tkl);
 	obs->tkl = tkl;
 
+	obs->ctx = ctx;
 	obs->last_timestamp = k_uptime_get();
 	if (att_pmax) {
-		obs->event_timestamp = obs->last_timestamp + MSEC_PER_SEC * att_pmax;
+		engine_observe_schedule(obs, obs->last_timestamp + MSEC_PER_SEC * att_pmax);
 	} else {
-		obs->event_timestamp = 0;
+		engine_observe_schedule(obs, 0);
 	}
 	obs->resource_update = false;
 	obs->active_tx_operation = false;
 	obs->format = format;
 	obs->counter = OBSERVE_COUNTER_START;
 	sys_slist_append(&ctx->observer, &obs->node);
+	observer_index_add(obs);
 
 	SYS_SLIST_FOR_EACH_CONTAINER(&obs->path_list, tmp, node) {
 		LOG_DBG("OBSERVER ADDED %u/%u/%u/%u(%u)", tmp->path.obj_id, tmp->path.obj_inst_id,
@@ -702,6 +834,7 @@ void remove_observer_from_list(struct lwm2m_ctx *ctx, sys_snode_t *prev_node,
 {
 	struct lwm2m_obj_path_list *o_p, *tmp;
 
+	observer_index_remove(obs);
 	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&obs->path_list, o_p, tmp, node) {
 		remove_observer_path_from_list(ctx, obs, o_p, NULL);
 	}
@@ -936,7 +1069,7 @@ static int lwm2m_engine_observer_timestamp_update(sys_slist_t *observer,
 			/* Disable Automatic Notify */
 			timestamp = 0;
 		}
-		obs->event_timestamp = timestamp;
+		engine_observe_schedule(obs, timestamp);
 
 		(void)memset(&nattrs, 0, sizeof(nattrs));
 	}
@@ -1652,3 +1785,18 @@ void lwm2m_engine_clear_duplicate_path(sys_slist_t *lwm2m_path_list, sys_slist_t
 		}
 	}
 }
+
+static int lwm2m_observation_init(const struct device *dev)
+{
+	int i;
+
+	ARG_UNUSED(dev);
+
+	for (i = 0; i < OBSERVER_INDEX_SIZE; i++) {
+		sys_dlist_init(&observer_index[i]);
+	}
+
+	return 0;
+}
+
+SYS_INIT(lwm2m_observation_init, APPLICATION, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
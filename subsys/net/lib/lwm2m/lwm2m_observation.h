@@ -14,6 +14,9 @@ int lwm2m_notify_observer_path(const struct lwm2m_obj_path *path);
 
 struct observe_node {
 	sys_snode_t node;
+	sys_dnode_t index_node;	      /* Observation index bucket */
+	sys_dnode_t deadline_node;    /* Pending events, sorted by event_timestamp */
+	struct lwm2m_ctx *ctx;	      /* Client context of the observer */
 	sys_slist_t path_list;	      /* List of Observation path */
 	uint8_t token[MAX_TOKEN_LEN]; /* Observation Token */
 	int64_t event_timestamp;      /* Timestamp for trig next Notify  */
@@ -35,6 +38,14 @@ void clear_attrs(void *ref);
 int64_t engine_observe_shedule_next_event(struct observe_node *obs, uint16_t srv_obj_inst,
 					  const int64_t timestamp);
 
+/**
+ * Set the time of the next event of an observer
+ *
+ * @param obs observer
+ * @param timestamp uptime of the next notification, 0 for none
+ */
+void engine_observe_schedule(struct observe_node *obs, int64_t timestamp);
+
 void remove_observer_from_list(struct lwm2m_ctx *ctx, sys_snode_t *prev_node,
 			       struct observe_node *obs);
 
@@ -88,4 +99,5 @@ void lwm2m_engine_clear_duplicate_path(sys_slist_t *lwm2m_path_list, sys_slist_t
 
 /* Resources */
 sys_slist_t *lwm2m_obs_obj_path_list(void);
+sys_dlist_t *lwm2m_obs_deadline_list(void);
 #endif /* LWM2M_OBSERVATION_H */
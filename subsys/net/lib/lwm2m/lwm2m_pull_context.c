@@ -17,6 +17,7 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 
 #include <zephyr/net/http/parser.h>
 #include <zephyr/net/socket.h>
+#include <zephyr/sys/byteorder.h>
 
 #include "lwm2m_pull_context.h"
 #include "lwm2m_engine.h"
@@ -30,7 +31,24 @@ static K_SEM_DEFINE(lwm2m_pull_sem, 1, 1);
 static char proxy_uri[LWM2M_PACKAGE_URI_LEN];
 #endif
 
+#define PULL_WINDOW CONFIG_LWM2M_FIRMWARE_UPDATE_PULL_WINDOW
+
+/* One message and reply per request in flight, plus the one being released
+ * while the next requests are sent.
+ */
+BUILD_ASSERT(PULL_WINDOW <= CONFIG_LWM2M_ENGINE_MAX_PENDING &&
+	     PULL_WINDOW <= CONFIG_LWM2M_ENGINE_MAX_REPLIES &&
+	     PULL_WINDOW < CONFIG_LWM2M_ENGINE_MAX_MESSAGES,
+	     "Not enough LwM2M messages for the firmware pull window");
+
+#if PULL_WINDOW > 1
+/* Blocks received ahead of the one written next */
+static uint8_t window_buf[(PULL_WINDOW - 1) * CONFIG_LWM2M_COAP_BLOCK_SIZE];
+#endif
+
 static void do_transmit_timeout_cb(struct lwm2m_message *msg);
+static int do_firmware_transfer_reply_cb(const struct coap_packet *response,
+					 struct coap_reply *reply, const struct sockaddr *from);
 
 static struct firmware_pull_context {
 	uint8_t obj_inst_id;
@@ -40,7 +58,9 @@ static struct firmware_pull_context {
 	lwm2m_engine_set_data_cb_t write_cb;
 
 	struct lwm2m_ctx firmware_ctx;
-	struct coap_block_context block_ctx;
+	struct coap_block_stream stream;
+	/* Random token prefix of the transfer, followed by the block number */
+	uint8_t token[4];
 } context;
 
 static enum service_state {
@@ -90,10 +110,10 @@ static void cleanup_context(void)
 	lwm2m_engine_update_service_period(pull_service, 1);
 }
 
-static int transfer_request(struct coap_block_context *ctx, uint8_t *token, uint8_t tkl,
-			    coap_reply_t reply_cb)
+static int transfer_request(struct coap_block_stream *stream, uint32_t num)
 {
 	struct lwm2m_message *msg;
+	uint8_t token[sizeof(context.token) + sizeof(num)];
 	int ret;
 	char *cursor;
 #if !defined(CONFIG_LWM2M_FIRMWARE_UPDATE_PULL_COAP_PROXY_SUPPORT)
@@ -111,9 +131,11 @@ static int transfer_request(struct coap_block_context *ctx, uint8_t *token, uint
 	msg->type = COAP_TYPE_CON;
 	msg->code = COAP_METHOD_GET;
 	msg->mid = coap_next_id();
+	memcpy(token, context.token, sizeof(context.token));
+	sys_put_be32(num, &token[sizeof(context.token)]);
 	msg->token = token;
-	msg->tkl = tkl;
-	msg->reply_cb = reply_cb;
+	msg->tkl = sizeof(token);
+	msg->reply_cb = do_firmware_transfer_reply_cb;
 	msg->message_timeout_cb = do_transmit_timeout_cb;
 
 	ret = lwm2m_init_message(msg);
@@ -179,7 +201,7 @@ static int transfer_request(struct coap_block_context *ctx, uint8_t *token, uint
 	}
 #endif
 
-	ret = coap_append_block2_option(&msg->cpkt, ctx);
+	ret = coap_block_stream_append_option(stream, &msg->cpkt, num);
 	if (ret < 0) {
 		LOG_ERR("Unable to add block2 option.");
 		goto cleanup;
@@ -215,20 +237,59 @@ cleanup:
 	return ret;
 }
 
+static int firmware_write(struct coap_block_stream *stream, const uint8_t *data, size_t len,
+			  size_t offset, bool last)
+{
+	struct lwm2m_engine_res *res = NULL;
+	size_t write_buflen, chunk;
+	uint8_t *write_buf;
+	int ret;
+
+	if (len == 0 || !context.write_cb) {
+		return 0;
+	}
+
+	LOG_DBG("total: %zd, current: %zd", stream->total_size, offset);
+
+	/* look up firmware package resource */
+	ret = lwm2m_engine_get_resource("5/0/0", &res);
+	if (ret < 0) {
+		return ret;
+	}
+
+	/* get buffer data */
+	write_buf = res->res_instances->data_ptr;
+	write_buflen = res->res_instances->max_data_len;
+
+	/* check for user override to buffer */
+	if (res->pre_write_cb) {
+		write_buf = res->pre_write_cb(0, 0, 0, &write_buflen);
+	}
+
+	/* flush incoming data to write_cb */
+	while (len > 0) {
+		chunk = MIN(len, write_buflen);
+		memcpy(write_buf, data, chunk);
+		data += chunk;
+		len -= chunk;
+
+		ret = context.write_cb(context.obj_inst_id, 0, 0, write_buf, chunk,
+				       last && (len == 0U), stream->total_size);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
 static int do_firmware_transfer_reply_cb(const struct coap_packet *response,
 					 struct coap_reply *reply, const struct sockaddr *from)
 {
 	int ret;
-	bool last_block;
 	uint8_t token[8];
 	uint8_t tkl;
-	uint16_t payload_len, payload_offset, len;
 	struct coap_packet *check_response = (struct coap_packet *)response;
-	struct lwm2m_engine_res *res = NULL;
-	size_t write_buflen;
-	uint8_t resp_code, *write_buf;
-	struct coap_block_context received_block_ctx;
-	const uint8_t *payload_start;
 
 	/* token is used to determine a valid ACK vs a separated response */
 	tkl = coap_header_get_token(check_response, token);
@@ -246,93 +307,22 @@ static int do_firmware_transfer_reply_cb(const struct coap_packet *response,
 		}
 	}
 
-	/* Check response code from server. Expecting (2.05) */
-	resp_code = coap_header_get_code(check_response);
-	if (resp_code != COAP_RESPONSE_CODE_CONTENT) {
-		LOG_ERR("Unexpected response from server: %d.%d",
-			COAP_RESPONSE_CODE_CLASS(resp_code), COAP_RESPONSE_CODE_DETAIL(resp_code));
-		ret = -ENOMSG;
-		goto error;
+	if (tkl != sizeof(token) || memcmp(token, context.token, sizeof(context.token)) != 0) {
+		LOG_WRN("Response to an unknown request ignored");
+		return 0;
 	}
 
-	/* save main firmware block context */
-	memcpy(&received_block_ctx, &context.block_ctx, sizeof(context.block_ctx));
-
-	ret = coap_update_from_block(check_response, &context.block_ctx);
+	/* Blocks are written in order, the next requests are sent from the
+	 * request callback of the stream.
+	 */
+	ret = coap_block_stream_response(&context.stream,
+					 sys_get_be32(&token[sizeof(context.token)]), response);
 	if (ret < 0) {
-		LOG_ERR("Error from block update: %d", ret);
-		ret = -EFAULT;
+		LOG_ERR("Error from block transfer: %d", ret);
 		goto error;
 	}
 
-	/* test for duplicate transfer */
-	if (context.block_ctx.current < received_block_ctx.current) {
-		LOG_WRN("Duplicate packet ignored");
-
-		/* restore main firmware block context */
-		memcpy(&context.block_ctx, &received_block_ctx, sizeof(context.block_ctx));
-
-		/* set reply->user_data to error to avoid releasing */
-		reply->user_data = (void *)COAP_REPLY_STATUS_ERROR;
-		return 0;
-	}
-
-	/* Reach last block if ret equals to 0 */
-	last_block = !coap_next_block(check_response, &context.block_ctx);
-
-	/* Process incoming data */
-	payload_start = coap_packet_get_payload(response, &payload_len);
-	if (payload_len > 0) {
-		payload_offset = payload_start - response->data;
-		LOG_DBG("total: %zd, current: %zd", context.block_ctx.total_size,
-			context.block_ctx.current);
-
-		/* look up firmware package resource */
-		ret = lwm2m_engine_get_resource("5/0/0", &res);
-		if (ret < 0) {
-			goto error;
-		}
-
-		/* get buffer data */
-		write_buf = res->res_instances->data_ptr;
-		write_buflen = res->res_instances->max_data_len;
-
-		/* check for user override to buffer */
-		if (res->pre_write_cb) {
-			write_buf = res->pre_write_cb(0, 0, 0, &write_buflen);
-		}
-
-		if (context.write_cb) {
-			/* flush incoming data to write_cb */
-			while (payload_len > 0) {
-				len = (payload_len > write_buflen) ? write_buflen : payload_len;
-				payload_len -= len;
-				/* check for end of packet */
-				if (buf_read(write_buf, len, CPKT_BUF_READ(response),
-					     &payload_offset) < 0) {
-					/* malformed packet */
-					ret = -EFAULT;
-					goto error;
-				}
-
-				ret = context.write_cb(context.obj_inst_id, 0, 0, write_buf, len,
-						       last_block && (payload_len == 0U),
-						       context.block_ctx.total_size);
-				if (ret < 0) {
-					goto error;
-				}
-			}
-		}
-	}
-
-	if (!last_block) {
-		/* More block(s) to come, setup next transfer */
-		ret = transfer_request(&context.block_ctx, token, tkl,
-				       do_firmware_transfer_reply_cb);
-		if (ret < 0) {
-			goto error;
-		}
-	} else {
+	if (coap_block_stream_is_complete(&context.stream)) {
 		/* Download finished */
 		context.result_cb(context.obj_inst_id, 0);
 		cleanup_context();
@@ -356,6 +346,16 @@ static void do_transmit_timeout_cb(struct lwm2m_message *msg)
 
 static void firmware_transfer(void)
 {
+	struct coap_block_stream_config config = {
+		.request = transfer_request,
+		.sink = firmware_write,
+		.block_size = lwm2m_default_block_size(),
+		.window = PULL_WINDOW,
+#if PULL_WINDOW > 1
+		.buf = window_buf,
+		.buf_len = sizeof(window_buf),
+#endif
+	};
 	int ret;
 	char *server_addr;
 
@@ -391,10 +391,16 @@ static void firmware_transfer(void)
 
 	LOG_INF("Connecting to server %s", context.uri);
 
-	/* reset block transfer context */
-	coap_block_transfer_init(&context.block_ctx, lwm2m_default_block_size(), 0);
-	ret = transfer_request(&context.block_ctx, coap_next_token(), 8,
-			       do_firmware_transfer_reply_cb);
+	/* reset block transfer context, the CoAP retransmissions are the only
+	 * retries of a lost request.
+	 */
+	ret = coap_block_stream_init(&context.stream, &config, 0);
+	if (ret < 0) {
+		goto error;
+	}
+
+	memcpy(context.token, coap_next_token(), sizeof(context.token));
+	ret = coap_block_stream_start(&context.stream);
 	if (ret < 0) {
 		goto error;
 	}
@@ -436,7 +442,6 @@ int lwm2m_pull_context_start_transfer(char *uri, struct requesting_object req, k
 	context.write_cb = req.write_cb;
 
 	(void)memset(&context.firmware_ctx, 0, sizeof(struct lwm2m_ctx));
-	(void)memset(&context.block_ctx, 0, sizeof(struct coap_block_context));
 	context.firmware_ctx.sock_fd = -1;
 
 	firmware_transfer();
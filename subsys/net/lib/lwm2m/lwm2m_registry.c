@@ -54,6 +54,24 @@ void lwm2m_registry_unlock(void)
 static sys_slist_t engine_obj_list;
 static sys_slist_t engine_obj_inst_list;
 
+/* Lookup indexes, the lists above keep the registration order */
+#define REGISTRY_HASH_SIZE CONFIG_LWM2M_ENGINE_REGISTRY_HASH_SIZE
+
+static sys_slist_t engine_obj_hash[REGISTRY_HASH_SIZE];
+static sys_slist_t engine_obj_inst_hash[REGISTRY_HASH_SIZE];
+
+static inline sys_slist_t *obj_bucket(uint16_t obj_id)
+{
+	return &engine_obj_hash[obj_id % REGISTRY_HASH_SIZE];
+}
+
+static inline sys_slist_t *obj_inst_bucket(uint16_t obj_id, uint16_t obj_inst_id)
+{
+	/* Instance IDs are mostly small and consecutive, spread objects apart */
+	return &engine_obj_inst_hash[((uint32_t)obj_id * 2654435761U + obj_inst_id) %
+				     REGISTRY_HASH_SIZE];
+}
+
 /* Resource wrappers */
 sys_slist_t *lwm2m_engine_obj_list(void) { return &engine_obj_list; }
 
@@ -77,7 +95,16 @@ void lwm2m_register_obj(struct lwm2m_engine_obj *obj)
 	access_control_add_obj(obj->obj_id, server_obj_inst_id);
 #endif /* CONFIG_LWM2M_RD_CLIENT_SUPPORT_BOOTSTRAP */
 #endif /* CONFIG_LWM2M_ACCESS_CONTROL_ENABLE */
+	obj->fields_sorted = true;
+	for (int i = 1; i < obj->field_count; i++) {
+		if (obj->fields[i - 1].res_id >= obj->fields[i].res_id) {
+			obj->fields_sorted = false;
+			break;
+		}
+	}
+
 	sys_slist_append(&engine_obj_list, &obj->node);
+	sys_slist_append(obj_bucket(obj->obj_id), &obj->hash_node);
 	k_mutex_unlock(&registry_lock);
 }
 
@@ -89,6 +116,7 @@ void lwm2m_unregister_obj(struct lwm2m_engine_obj *obj)
 #endif
 	engine_remove_observer_by_id(obj->obj_id, -1);
 	sys_slist_find_and_remove(&engine_obj_list, &obj->node);
+	sys_slist_find_and_remove(obj_bucket(obj->obj_id), &obj->hash_node);
 	k_mutex_unlock(&registry_lock);
 }
 
@@ -96,7 +124,11 @@ struct lwm2m_engine_obj *get_engine_obj(int obj_id)
 {
 	struct lwm2m_engine_obj *obj;
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&engine_obj_list, obj, node) {
+	if (obj_id < 0 || obj_id > UINT16_MAX) {
+		return NULL;
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(obj_bucket(obj_id), obj, hash_node) {
 		if (obj->obj_id == obj_id) {
 			return obj;
 		}
@@ -109,12 +141,33 @@ struct lwm2m_engine_obj_field *lwm2m_get_engine_obj_field(struct lwm2m_engine_ob
 {
 	int i;
 
-	if (obj && obj->fields && obj->field_count > 0) {
-		for (i = 0; i < obj->field_count; i++) {
+	if (!obj || !obj->fields || obj->field_count == 0) {
+		return NULL;
+	}
+
+	if (obj->fields_sorted) {
+		int lo = 0;
+		int hi = obj->field_count - 1;
+
+		while (lo <= hi) {
+			i = lo + (hi - lo) / 2;
+
 			if (obj->fields[i].res_id == res_id) {
 				return &obj->fields[i];
+			} else if (obj->fields[i].res_id < res_id) {
+				lo = i + 1;
+			} else {
+				hi = i - 1;
 			}
 		}
+
+		return NULL;
+	}
+
+	for (i = 0; i < obj->field_count; i++) {
+		if (obj->fields[i].res_id == res_id) {
+			return &obj->fields[i];
+		}
 	}
 
 	return NULL;
@@ -140,7 +193,23 @@ static void engine_register_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
 	access_control_add(obj_inst->obj->obj_id, obj_inst->obj_inst_id, server_obj_inst_id);
 #endif /* CONFIG_LWM2M_RD_CLIENT_SUPPORT_BOOTSTRAP */
 #endif /* CONFIG_LWM2M_ACCESS_CONTROL_ENABLE */
+	struct lwm2m_engine_obj_inst *iter, *prev = NULL;
+
 	sys_slist_append(&engine_obj_inst_list, &obj_inst->node);
+	sys_slist_append(obj_inst_bucket(obj_inst->obj->obj_id, obj_inst->obj_inst_id),
+			 &obj_inst->hash_node);
+
+	/* Keep the instances of the object in ID order for next_engine_obj_inst() */
+	SYS_SLIST_FOR_EACH_CONTAINER(&obj_inst->obj->inst_list, iter, obj_node) {
+		if (iter->obj_inst_id > obj_inst->obj_inst_id) {
+			break;
+		}
+
+		prev = iter;
+	}
+
+	sys_slist_insert(&obj_inst->obj->inst_list, prev ? &prev->obj_node : NULL,
+			 &obj_inst->obj_node);
 }
 
 static void engine_unregister_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
@@ -150,13 +219,20 @@ static void engine_unregister_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
 #endif
 	engine_remove_observer_by_id(obj_inst->obj->obj_id, obj_inst->obj_inst_id);
 	sys_slist_find_and_remove(&engine_obj_inst_list, &obj_inst->node);
+	sys_slist_find_and_remove(obj_inst_bucket(obj_inst->obj->obj_id, obj_inst->obj_inst_id),
+				  &obj_inst->hash_node);
+	sys_slist_find_and_remove(&obj_inst->obj->inst_list, &obj_inst->obj_node);
 }
 
 struct lwm2m_engine_obj_inst *get_engine_obj_inst(int obj_id, int obj_inst_id)
 {
 	struct lwm2m_engine_obj_inst *obj_inst;
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&engine_obj_inst_list, obj_inst, node) {
+	if (obj_id < 0 || obj_id > UINT16_MAX || obj_inst_id < 0 || obj_inst_id > UINT16_MAX) {
+		return NULL;
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(obj_inst_bucket(obj_id, obj_inst_id), obj_inst, hash_node) {
 		if (obj_inst->obj->obj_id == obj_id && obj_inst->obj_inst_id == obj_inst_id) {
 			return obj_inst;
 		}
@@ -167,16 +243,20 @@ struct lwm2m_engine_obj_inst *get_engine_obj_inst(int obj_id, int obj_inst_id)
 
 struct lwm2m_engine_obj_inst *next_engine_obj_inst(int obj_id, int obj_inst_id)
 {
-	struct lwm2m_engine_obj_inst *obj_inst, *next = NULL;
+	struct lwm2m_engine_obj *obj = get_engine_obj(obj_id);
+	struct lwm2m_engine_obj_inst *obj_inst;
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&engine_obj_inst_list, obj_inst, node) {
-		if (obj_inst->obj->obj_id == obj_id && obj_inst->obj_inst_id > obj_inst_id &&
-		    (!next || next->obj_inst_id > obj_inst->obj_inst_id)) {
-			next = obj_inst;
+	if (!obj) {
+		return NULL;
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&obj->inst_list, obj_inst, obj_node) {
+		if (obj_inst->obj_inst_id > obj_inst_id) {
+			return obj_inst;
 		}
 	}
 
-	return next;
+	return NULL;
 }
 
 int lwm2m_create_obj_inst(uint16_t obj_id, uint16_t obj_inst_id,
@@ -392,10 +472,16 @@ int path_to_objs(const struct lwm2m_obj_path *path, struct lwm2m_engine_obj_inst
 		return -ENOENT;
 	}
 
-	for (i = 0; i < oi->resource_count; i++) {
-		if (oi->resources[i].res_id == path->res_id) {
-			r = &oi->resources[i];
-			break;
+	/* Resources are normally initialized in the order of the fields */
+	i = of - oi->obj->fields;
+	if (i < oi->resource_count && oi->resources[i].res_id == path->res_id) {
+		r = &oi->resources[i];
+	} else {
+		for (i = 0; i < oi->resource_count; i++) {
+			if (oi->resources[i].res_id == path->res_id) {
+				r = &oi->resources[i];
+				break;
+			}
 		}
 	}
 
@@ -409,10 +495,16 @@ int path_to_objs(const struct lwm2m_obj_path *path, struct lwm2m_engine_obj_inst
 		return -ENOENT;
 	}
 
-	for (i = 0; i < r->res_inst_count; i++) {
-		if (r->res_instances[i].res_inst_id == path->res_inst_id) {
-			ri = &r->res_instances[i];
-			break;
+	/* Resource instance IDs mostly match their index */
+	if (path->res_inst_id < r->res_inst_count &&
+	    r->res_instances[path->res_inst_id].res_inst_id == path->res_inst_id) {
+		ri = &r->res_instances[path->res_inst_id];
+	} else {
+		for (i = 0; i < r->res_inst_count; i++) {
+			if (r->res_instances[i].res_inst_id == path->res_inst_id) {
+				ri = &r->res_instances[i];
+				break;
+			}
 		}
 	}
 
@@ -167,6 +167,225 @@ static int client_write_msg(struct mqtt_client *client,
 	return 0;
 }
 
+#if CONFIG_MQTT_PUBLISH_WINDOW > 0
+static struct mqtt_outgoing *outgoing_find(struct mqtt_client *client,
+					   uint16_t message_id)
+{
+	struct mqtt_outgoing *entry;
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(client->internal.outgoing); i++) {
+		entry = &client->internal.outgoing[i];
+
+		if (entry->state != MQTT_OUTGOING_FREE &&
+		    entry->param.message_id == message_id) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+static struct mqtt_outgoing *outgoing_find_free(struct mqtt_client *client)
+{
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(client->internal.outgoing); i++) {
+		if (client->internal.outgoing[i].state == MQTT_OUTGOING_FREE) {
+			return &client->internal.outgoing[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Checks that the window has room for the QoS 1 and QoS 2 messages that are
+ * not tracked yet.
+ */
+static int outgoing_check(struct mqtt_client *client,
+			  const struct mqtt_publish_param *params, size_t count)
+{
+	size_t needed = 0;
+	size_t i;
+
+	for (i = 0; i < count; i++) {
+		if (params[i].message.topic.qos != MQTT_QOS_0_AT_MOST_ONCE &&
+		    outgoing_find(client, params[i].message_id) == NULL) {
+			needed++;
+		}
+	}
+
+	for (i = 0; i < ARRAY_SIZE(client->internal.outgoing) && needed > 0;
+	     i++) {
+		if (client->internal.outgoing[i].state == MQTT_OUTGOING_FREE) {
+			needed--;
+		}
+	}
+
+	return needed == 0 ? 0 : -ENOBUFS;
+}
+
+static void outgoing_track(struct mqtt_client *client,
+			   const struct mqtt_publish_param *param)
+{
+	struct mqtt_outgoing *entry;
+
+	if (param->message.topic.qos == MQTT_QOS_0_AT_MOST_ONCE) {
+		return;
+	}
+
+	/* A message sent again by the application keeps its entry. */
+	entry = outgoing_find(client, param->message_id);
+	if (entry == NULL) {
+		entry = outgoing_find_free(client);
+		__ASSERT_NO_MSG(entry != NULL);
+	}
+
+	entry->param = *param;
+	entry->state = MQTT_OUTGOING_PUBLISHED;
+	entry->timestamp = mqtt_sys_tick_in_ms_get();
+}
+
+/* Sends an entry again, without closing the connection on error. */
+static int outgoing_send(struct mqtt_client *client,
+			 struct mqtt_outgoing *entry)
+{
+	struct mqtt_pubrel_param pubrel = {
+		.message_id = entry->param.message_id,
+	};
+	struct iovec io_vector[2];
+	struct buf_ctx packet;
+	struct msghdr msg;
+	int err_code;
+
+	tx_buf_init(client, &packet);
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = io_vector;
+
+	if (entry->state == MQTT_OUTGOING_RELEASED) {
+		err_code = publish_release_encode(&pubrel, &packet);
+		msg.msg_iovlen = 1;
+	} else {
+		entry->param.dup_flag = 1U;
+		err_code = publish_encode(&entry->param, &packet);
+		msg.msg_iovlen = 2;
+	}
+
+	if (err_code < 0) {
+		return err_code;
+	}
+
+	io_vector[0].iov_base = packet.cur;
+	io_vector[0].iov_len = packet.end - packet.cur;
+	io_vector[1].iov_base = entry->param.message.payload.data;
+	io_vector[1].iov_len = entry->param.message.payload.len;
+
+	err_code = mqtt_transport_write_msg(client, &msg);
+	if (err_code < 0) {
+		return err_code;
+	}
+
+	NET_DBG("[CID %p]: Retransmitted message id 0x%04x", client,
+		entry->param.message_id);
+
+	entry->timestamp = mqtt_sys_tick_in_ms_get();
+	client->internal.last_activity = entry->timestamp;
+
+	return 0;
+}
+
+static int outgoing_retransmit(struct mqtt_client *client)
+{
+	struct mqtt_outgoing *entry;
+	int err_code;
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(client->internal.outgoing); i++) {
+		entry = &client->internal.outgoing[i];
+
+		if (entry->state == MQTT_OUTGOING_FREE ||
+		    mqtt_elapsed_time_in_ms_get(entry->timestamp) <
+		    CONFIG_MQTT_PUBLISH_RETRANSMIT_TIMEOUT) {
+			continue;
+		}
+
+		err_code = outgoing_send(client, entry);
+		if (err_code < 0) {
+			return err_code;
+		}
+	}
+
+	return 0;
+}
+
+void mqtt_outgoing_ack(struct mqtt_client *client, uint8_t type,
+		       uint16_t message_id)
+{
+	struct mqtt_outgoing *entry;
+
+	entry = outgoing_find(client, message_id);
+	if (entry == NULL) {
+		return;
+	}
+
+	if (type == MQTT_PKT_TYPE_PUBREC) {
+		/* The application releases the message on MQTT_EVT_PUBREC,
+		 * the release is retransmitted from now on.
+		 */
+		entry->state = MQTT_OUTGOING_RELEASED;
+		entry->timestamp = mqtt_sys_tick_in_ms_get();
+	} else {
+		entry->state = MQTT_OUTGOING_FREE;
+	}
+}
+
+int mqtt_outgoing_resume(struct mqtt_client *client, bool session_present)
+{
+	struct mqtt_outgoing *entry;
+	int err_code;
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(client->internal.outgoing); i++) {
+		entry = &client->internal.outgoing[i];
+
+		if (entry->state == MQTT_OUTGOING_FREE) {
+			continue;
+		}
+
+		if (!session_present) {
+			NET_WARN("[CID %p]: Message id 0x%04x dropped with the "
+				 "session", client, entry->param.message_id);
+			entry->state = MQTT_OUTGOING_FREE;
+			continue;
+		}
+
+		err_code = outgoing_send(client, entry);
+		if (err_code < 0) {
+			return err_code;
+		}
+	}
+
+	return 0;
+}
+#else
+static inline int outgoing_check(struct mqtt_client *client,
+				 const struct mqtt_publish_param *params,
+				 size_t count)
+{
+	return 0;
+}
+
+static inline void outgoing_track(struct mqtt_client *client,
+				  const struct mqtt_publish_param *param)
+{
+}
+
+static inline int outgoing_retransmit(struct mqtt_client *client)
+{
+	return 0;
+}
+#endif /* CONFIG_MQTT_PUBLISH_WINDOW > 0 */
+
 void mqtt_client_init(struct mqtt_client *client)
 {
 	NULL_PARAM_CHECK_VOID(client);
@@ -236,13 +455,66 @@ static int verify_tx_state(const struct mqtt_client *client)
 	return 0;
 }
 
+/* Encodes the headers of up to CONFIG_MQTT_PUBLISH_BATCH_SIZE messages after
+ * each other in the TX buffer, and sends them with their payloads in a single
+ * transport write. Returns the number of messages sent.
+ */
+static int publish_write(struct mqtt_client *client,
+			 const struct mqtt_publish_param *params, size_t count)
+{
+	struct iovec io_vector[2 * CONFIG_MQTT_PUBLISH_BATCH_SIZE];
+	struct buf_ctx packet;
+	struct msghdr msg;
+	int err_code;
+	size_t i;
+
+	count = MIN(count, CONFIG_MQTT_PUBLISH_BATCH_SIZE);
+
+	tx_buf_init(client, &packet);
+
+	for (i = 0; i < count; i++) {
+		err_code = publish_encode(&params[i], &packet);
+		if (err_code == -ENOMEM && i > 0) {
+			/* TX buffer full, send the messages encoded so far. */
+			break;
+		}
+
+		if (err_code < 0) {
+			return err_code;
+		}
+
+		io_vector[2 * i].iov_base = packet.cur;
+		io_vector[2 * i].iov_len = packet.end - packet.cur;
+		io_vector[2 * i + 1].iov_base = params[i].message.payload.data;
+		io_vector[2 * i + 1].iov_len = params[i].message.payload.len;
+
+		packet.cur = packet.end;
+		packet.end = client->tx_buf + client->tx_buf_size;
+	}
+
+	memset(&msg, 0, sizeof(msg));
+
+	msg.msg_iov = io_vector;
+	msg.msg_iovlen = 2 * i;
+
+	err_code = client_write_msg(client, &msg);
+	if (err_code < 0) {
+		return err_code;
+	}
+
+	count = i;
+
+	for (i = 0; i < count; i++) {
+		outgoing_track(client, &params[i]);
+	}
+
+	return count;
+}
+
 int mqtt_publish(struct mqtt_client *client,
 		 const struct mqtt_publish_param *param)
 {
 	int err_code;
-	struct buf_ctx packet;
-	struct iovec io_vector[2];
-	struct msghdr msg;
 
 	NULL_PARAM_CHECK(client);
 	NULL_PARAM_CHECK(param);
@@ -254,33 +526,68 @@ int mqtt_publish(struct mqtt_client *client,
 
 	mqtt_mutex_lock(client);
 
-	tx_buf_init(client, &packet);
-
 	err_code = verify_tx_state(client);
 	if (err_code < 0) {
 		goto error;
 	}
 
-	err_code = publish_encode(param, &packet);
+	err_code = outgoing_check(client, param, 1);
 	if (err_code < 0) {
 		goto error;
 	}
 
-	io_vector[0].iov_base = packet.cur;
-	io_vector[0].iov_len = packet.end - packet.cur;
-	io_vector[1].iov_base = param->message.payload.data;
-	io_vector[1].iov_len = param->message.payload.len;
+	err_code = publish_write(client, param, 1);
+	if (err_code > 0) {
+		err_code = 0;
+	}
 
-	memset(&msg, 0, sizeof(msg));
+error:
+	NET_DBG("[CID %p]:[State 0x%02x]: << result 0x%08x",
+			 client, client->internal.state, err_code);
 
-	msg.msg_iov = io_vector;
-	msg.msg_iovlen = ARRAY_SIZE(io_vector);
+	mqtt_mutex_unlock(client);
 
-	err_code = client_write_msg(client, &msg);
+	return err_code;
+}
+
+int mqtt_publish_batch(struct mqtt_client *client,
+		       const struct mqtt_publish_param *params, size_t count)
+{
+	int err_code;
+
+	NULL_PARAM_CHECK(client);
+	NULL_PARAM_CHECK(params);
+
+	NET_DBG("[CID %p]:[State 0x%02x]: >> %zu messages", client,
+		 client->internal.state, count);
+
+	mqtt_mutex_lock(client);
+
+	err_code = verify_tx_state(client);
+	if (err_code < 0) {
+		goto error;
+	}
+
+	err_code = outgoing_check(client, params, count);
+	if (err_code < 0) {
+		goto error;
+	}
+
+	while (count > 0) {
+		err_code = publish_write(client, params, count);
+		if (err_code < 0) {
+			goto error;
+		}
+
+		params += err_code;
+		count -= err_code;
+	}
+
+	err_code = 0;
 
 error:
 	NET_DBG("[CID %p]:[State 0x%02x]: << result 0x%08x",
-			 client, client->internal.state, err_code);
+		 client, client->internal.state, err_code);
 
 	mqtt_mutex_unlock(client);
 
@@ -601,6 +908,17 @@ int mqtt_live(struct mqtt_client *client)
 
 	mqtt_mutex_lock(client);
 
+	if (MQTT_HAS_STATE(client, MQTT_STATE_CONNECTED)) {
+		err_code = outgoing_retransmit(client);
+		if (err_code < 0) {
+			NET_ERR("Retransmission failed, err_code = %d, "
+				"closing connection", err_code);
+			client_disconnect(client, err_code, true);
+			mqtt_mutex_unlock(client);
+			return err_code;
+		}
+	}
+
 	elapsed_time = mqtt_elapsed_time_in_ms_get(
 				client->internal.last_activity);
 	if ((client->keepalive > 0) &&
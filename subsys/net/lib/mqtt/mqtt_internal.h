@@ -147,6 +147,51 @@ enum mqtt_state {
 	MQTT_STATE_CONNECTED            = 0x00000004,
 };
 
+/**@brief States of an outgoing publish message awaiting acknowledgment. */
+enum mqtt_outgoing_state {
+	/** Free entry. */
+	MQTT_OUTGOING_FREE,
+
+	/** PUBLISH sent, awaiting PUBACK or PUBREC. */
+	MQTT_OUTGOING_PUBLISHED,
+
+	/** PUBREC received, awaiting PUBCOMP. */
+	MQTT_OUTGOING_RELEASED,
+};
+
+#if CONFIG_MQTT_PUBLISH_WINDOW > 0
+/**@brief Updates the outgoing publish message acknowledged by the peer.
+ *
+ * @param[in] client Identifies the client for which the packet was received.
+ * @param[in] type MQTT_PKT_TYPE_PUBACK, MQTT_PKT_TYPE_PUBREC or
+ *                 MQTT_PKT_TYPE_PUBCOMP.
+ * @param[in] message_id Message id of the acknowledged message.
+ */
+void mqtt_outgoing_ack(struct mqtt_client *client, uint8_t type,
+		       uint16_t message_id);
+
+/**@brief Retransmits the outgoing publish messages of a resumed session, or
+ *        drops them if the broker has not kept the session.
+ *
+ * @param[in] client Identifies the client which got connected.
+ * @param[in] session_present Session Present flag of the CONNACK.
+ *
+ * @return 0 if the procedure is successful, an error code otherwise.
+ */
+int mqtt_outgoing_resume(struct mqtt_client *client, bool session_present);
+#else
+static inline void mqtt_outgoing_ack(struct mqtt_client *client, uint8_t type,
+				     uint16_t message_id)
+{
+}
+
+static inline int mqtt_outgoing_resume(struct mqtt_client *client,
+				       bool session_present)
+{
+	return 0;
+}
+#endif
+
 /**@brief Notify application about MQTT event.
  *
  * @param[in] client Identifies the client for which event occurred.
@@ -42,6 +42,9 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 						MQTT_CONNECTION_ACCEPTED) {
 				/* Set state. */
 				MQTT_SET_STATE(client, MQTT_STATE_CONNECTED);
+
+				err_code = mqtt_outgoing_resume(client,
+					evt.param.connack.session_present_flag);
 			} else {
 				err_code = -ECONNREFUSED;
 			}
@@ -77,6 +80,11 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 		evt.type = MQTT_EVT_PUBACK;
 		err_code = publish_ack_decode(buf, &evt.param.puback);
 		evt.result = err_code;
+
+		if (err_code == 0) {
+			mqtt_outgoing_ack(client, MQTT_PKT_TYPE_PUBACK,
+					  evt.param.puback.message_id);
+		}
 		break;
 
 	case MQTT_PKT_TYPE_PUBREC:
@@ -85,6 +93,11 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 		evt.type = MQTT_EVT_PUBREC;
 		err_code = publish_receive_decode(buf, &evt.param.pubrec);
 		evt.result = err_code;
+
+		if (err_code == 0) {
+			mqtt_outgoing_ack(client, MQTT_PKT_TYPE_PUBREC,
+					  evt.param.pubrec.message_id);
+		}
 		break;
 
 	case MQTT_PKT_TYPE_PUBREL:
@@ -101,6 +114,11 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 		evt.type = MQTT_EVT_PUBCOMP;
 		err_code = publish_complete_decode(buf, &evt.param.pubcomp);
 		evt.result = err_code;
+
+		if (err_code == 0) {
+			mqtt_outgoing_ack(client, MQTT_PKT_TYPE_PUBCOMP,
+					  evt.param.pubcomp.message_id);
+		}
 		break;
 
 	case MQTT_PKT_TYPE_SUBACK:
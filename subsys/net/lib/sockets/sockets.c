@@ -366,6 +366,51 @@ static void zsock_accepted_cb(struct net_context *new_ctx,
 	}
 }
 
+#if defined(CONFIG_NET_TCP_GRO)
+/* Merge the data of an in-order TCP segment into the last packet of the
+ * receive queue if the reader has not picked that packet up yet. The TCP
+ * layer leaves the packet cursor at the start of the segment data, so
+ * everything in front of the cursor is protocol headers which can be
+ * dropped. Must be called with the socket lock held.
+ */
+static bool zsock_gro_merge(struct net_context *ctx, struct net_pkt *pkt)
+{
+	struct net_pkt *last_pkt;
+	struct net_buf *buf;
+	size_t len;
+
+	if (net_context_get_type(ctx) != SOCK_STREAM) {
+		return false;
+	}
+
+	last_pkt = k_fifo_peek_tail(&ctx->recv_q);
+	if (!last_pkt || net_pkt_eof(last_pkt)) {
+		return false;
+	}
+
+	len = net_pkt_remaining_data(pkt);
+	if (len == 0 ||
+	    net_pkt_remaining_data(last_pkt) + len > CONFIG_NET_TCP_GRO_MAX_SIZE) {
+		return false;
+	}
+
+	buf = pkt->buffer;
+	while (buf != pkt->cursor.buf) {
+		buf = net_buf_frag_del(NULL, buf);
+	}
+
+	net_buf_pull(buf, pkt->cursor.pos - buf->data);
+	net_buf_frag_add(last_pkt->buffer, buf);
+
+	pkt->buffer = NULL;
+
+	net_stats_update_tcp_seg_coalesced(net_pkt_iface(pkt));
+	net_pkt_unref(pkt);
+
+	return true;
+}
+#endif /* CONFIG_NET_TCP_GRO */
+
 static void zsock_received_cb(struct net_context *ctx,
 			      struct net_pkt *pkt,
 			      union net_ip_header *ip_hdr,
@@ -408,6 +453,12 @@ static void zsock_received_cb(struct net_context *ctx,
 	/* Normal packet */
 	net_pkt_set_eof(pkt, false);
 
+#if defined(CONFIG_NET_TCP_GRO)
+	if (zsock_gro_merge(ctx, pkt)) {
+		goto unlock;
+	}
+#endif
+
 	net_pkt_set_rx_stats_tick(pkt, k_cycle_get_32());
 
 	k_fifo_put(&ctx->recv_q, pkt);
@@ -898,93 +949,182 @@ ssize_t z_impl_zsock_sendmsg(int sock, const struct msghdr *msg, int flags)
 	VTABLE_CALL(sendmsg, sock, msg, flags);
 }
 
+static int zsock_sendmmsg_ctx(struct net_context *ctx,
+			      struct mmsghdr *msgvec,
+			      unsigned int vlen, int flags)
+{
+	unsigned int i;
+	ssize_t ret;
+
+	for (i = 0; i < vlen; i++) {
+		ret = zsock_sendmsg_ctx(ctx, &msgvec[i].msg_hdr, flags);
+		if (ret < 0) {
+			break;
+		}
+
+		msgvec[i].msg_len = ret;
+	}
+
+	/* Report the error only if nothing could be sent, otherwise it is
+	 * returned by the next call.
+	 */
+	if (i == 0 && vlen > 0) {
+		return -1;
+	}
+
+	return i;
+}
+
+int z_impl_zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+			  unsigned int vlen, int flags)
+{
+	VTABLE_CALL(sendmmsg, sock, msgvec, vlen, flags);
+}
+
 #ifdef CONFIG_USERSPACE
-static inline ssize_t z_vrfy_zsock_sendmsg(int sock,
-					   const struct msghdr *msg,
-					   int flags)
+static void msghdr_free_user_copy(struct msghdr *msg)
 {
-	struct msghdr msg_copy;
 	size_t i;
-	int ret;
 
-	Z_OOPS(z_user_from_copy(&msg_copy, (void *)msg, sizeof(msg_copy)));
+	k_free(msg->msg_name);
+	k_free(msg->msg_control);
+
+	if (msg->msg_iov) {
+		for (i = 0; i < msg->msg_iovlen; i++) {
+			k_free(msg->msg_iov[i].iov_base);
+		}
 
-	msg_copy.msg_name = NULL;
-	msg_copy.msg_control = NULL;
+		k_free(msg->msg_iov);
+	}
+}
 
-	msg_copy.msg_iov = z_user_alloc_from_copy(msg->msg_iov,
+/* Replace the user space pointers in a msghdr, that has already been
+ * copied to kernel memory, with kernel copies of the data they point to.
+ */
+static int msghdr_copy_from_user(struct msghdr *msg)
+{
+	const struct iovec *iov = msg->msg_iov;
+	void *name = msg->msg_name;
+	void *control = msg->msg_control;
+	size_t i;
+
+	msg->msg_name = NULL;
+	msg->msg_control = NULL;
+
+	msg->msg_iov = z_user_alloc_from_copy(iov,
 				       msg->msg_iovlen * sizeof(struct iovec));
-	if (!msg_copy.msg_iov) {
-		errno = ENOMEM;
-		goto fail;
+	if (!msg->msg_iov) {
+		msg->msg_iovlen = 0;
+		return -ENOMEM;
 	}
 
 	for (i = 0; i < msg->msg_iovlen; i++) {
-		msg_copy.msg_iov[i].iov_base =
+		msg->msg_iov[i].iov_base =
 			z_user_alloc_from_copy(msg->msg_iov[i].iov_base,
 					       msg->msg_iov[i].iov_len);
-		if (!msg_copy.msg_iov[i].iov_base) {
-			errno = ENOMEM;
+		if (!msg->msg_iov[i].iov_base) {
+			/* Only free the buffers copied so far */
+			msg->msg_iovlen = i;
 			goto fail;
 		}
-
-		msg_copy.msg_iov[i].iov_len = msg->msg_iov[i].iov_len;
 	}
 
 	if (msg->msg_namelen > 0) {
-		msg_copy.msg_name = z_user_alloc_from_copy(msg->msg_name,
-							   msg->msg_namelen);
-		if (!msg_copy.msg_name) {
-			errno = ENOMEM;
+		msg->msg_name = z_user_alloc_from_copy(name, msg->msg_namelen);
+		if (!msg->msg_name) {
 			goto fail;
 		}
 	}
 
 	if (msg->msg_controllen > 0) {
-		msg_copy.msg_control = z_user_alloc_from_copy(msg->msg_control,
+		msg->msg_control = z_user_alloc_from_copy(control,
 							  msg->msg_controllen);
-		if (!msg_copy.msg_control) {
-			errno = ENOMEM;
+		if (!msg->msg_control) {
 			goto fail;
 		}
 	}
 
-	ret = z_impl_zsock_sendmsg(sock, (const struct msghdr *)&msg_copy,
-				   flags);
+	return 0;
 
-	k_free(msg_copy.msg_name);
-	k_free(msg_copy.msg_control);
+fail:
+	msghdr_free_user_copy(msg);
 
-	for (i = 0; i < msg_copy.msg_iovlen; i++) {
-		k_free(msg_copy.msg_iov[i].iov_base);
+	return -ENOMEM;
+}
+
+static inline ssize_t z_vrfy_zsock_sendmsg(int sock,
+					   const struct msghdr *msg,
+					   int flags)
+{
+	struct msghdr msg_copy;
+	int ret;
+
+	Z_OOPS(z_user_from_copy(&msg_copy, (void *)msg, sizeof(msg_copy)));
+
+	if (msghdr_copy_from_user(&msg_copy) < 0) {
+		errno = ENOMEM;
+		return -1;
 	}
 
-	k_free(msg_copy.msg_iov);
+	ret = z_impl_zsock_sendmsg(sock, (const struct msghdr *)&msg_copy,
+				   flags);
+
+	msghdr_free_user_copy(&msg_copy);
 
 	return ret;
+}
+#include <syscalls/zsock_sendmsg_mrsh.c>
 
-fail:
-	if (msg_copy.msg_name) {
-		k_free(msg_copy.msg_name);
+static inline int z_vrfy_zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	struct mmsghdr *vec_copy;
+	unsigned int copied;
+	unsigned int i;
+	size_t size;
+	int ret = -1;
+
+	if (vlen == 0) {
+		return 0;
 	}
 
-	if (msg_copy.msg_control) {
-		k_free(msg_copy.msg_control);
+	Z_OOPS(Z_SYSCALL_VERIFY_MSG(!size_mul_overflow(vlen, sizeof(*msgvec),
+						       &size),
+				    "vlen too large"));
+
+	/* All the messages are validated and copied in one pass, so the
+	 * socket lock is taken only once for the whole vector.
+	 */
+	vec_copy = z_user_alloc_from_copy(msgvec, size);
+	if (!vec_copy) {
+		errno = ENOMEM;
+		return -1;
 	}
 
-	if (msg_copy.msg_iov) {
-		for (i = 0; i < msg_copy.msg_iovlen; i++) {
-			if (msg_copy.msg_iov[i].iov_base) {
-				k_free(msg_copy.msg_iov[i].iov_base);
-			}
+	for (copied = 0; copied < vlen; copied++) {
+		if (msghdr_copy_from_user(&vec_copy[copied].msg_hdr) < 0) {
+			errno = ENOMEM;
+			goto out;
 		}
+	}
 
-		k_free(msg_copy.msg_iov);
+	ret = z_impl_zsock_sendmmsg(sock, vec_copy, vlen, flags);
+
+	for (i = 0; ret > 0 && i < (unsigned int)ret; i++) {
+		Z_OOPS(z_user_to_copy(&msgvec[i].msg_len, &vec_copy[i].msg_len,
+				      sizeof(msgvec[i].msg_len)));
 	}
 
-	return -1;
+out:
+	for (i = 0; i < copied; i++) {
+		msghdr_free_user_copy(&vec_copy[i].msg_hdr);
+	}
+
+	k_free(vec_copy);
+
+	return ret;
 }
-#include <syscalls/zsock_sendmsg_mrsh.c>
+#include <syscalls/zsock_sendmmsg_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
 static int sock_get_pkt_src_addr(struct net_pkt *pkt,
@@ -1090,6 +1230,50 @@ error:
 	return ret;
 }
 
+static int sock_get_src_addr(struct net_context *ctx,
+			     struct net_pkt *pkt,
+			     struct sockaddr *src_addr,
+			     socklen_t *addrlen)
+{
+	if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
+	    net_if_is_ip_offloaded(net_context_get_iface(ctx))) {
+		/*
+		 * Packets from offloaded IP stack do not have IP
+		 * headers, so src address cannot be figured out at this
+		 * point. The best we can do is returning remote address
+		 * if that was set using connect() call.
+		 */
+		if (ctx->flags & NET_CONTEXT_REMOTE_ADDR_SET) {
+			memcpy(src_addr, &ctx->remote,
+			       MIN(*addrlen, sizeof(ctx->remote)));
+		} else {
+			return -ENOTSUP;
+		}
+	} else {
+		int rv;
+
+		rv = sock_get_pkt_src_addr(pkt, net_context_get_proto(ctx),
+					   src_addr, *addrlen);
+		if (rv < 0) {
+			LOG_ERR("sock_get_pkt_src_addr %d", rv);
+			return rv;
+		}
+	}
+
+	/* addrlen is a value-result argument, set to actual
+	 * size of source address
+	 */
+	if (src_addr->sa_family == AF_INET) {
+		*addrlen = sizeof(struct sockaddr_in);
+	} else if (src_addr->sa_family == AF_INET6) {
+		*addrlen = sizeof(struct sockaddr_in6);
+	} else {
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
 void net_socket_update_tc_rx_time(struct net_pkt *pkt, uint32_t end_tick)
 {
 	net_pkt_set_rx_stats_tick(pkt, end_tick);
@@ -1191,42 +1375,11 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 	net_pkt_cursor_backup(pkt, &backup);
 
 	if (src_addr && addrlen) {
-		if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
-		    net_if_is_ip_offloaded(net_context_get_iface(ctx))) {
-			/*
-			 * Packets from offloaded IP stack do not have IP
-			 * headers, so src address cannot be figured out at this
-			 * point. The best we can do is returning remote address
-			 * if that was set using connect() call.
-			 */
-			if (ctx->flags & NET_CONTEXT_REMOTE_ADDR_SET) {
-				memcpy(src_addr, &ctx->remote,
-				       MIN(*addrlen, sizeof(ctx->remote)));
-			} else {
-				errno = ENOTSUP;
-				goto fail;
-			}
-		} else {
-			int rv;
-
-			rv = sock_get_pkt_src_addr(pkt, net_context_get_proto(ctx),
-						   src_addr, *addrlen);
-			if (rv < 0) {
-				errno = -rv;
-				LOG_ERR("sock_get_pkt_src_addr %d", rv);
-				goto fail;
-			}
-		}
+		int rv;
 
-		/* addrlen is a value-result argument, set to actual
-		 * size of source address
-		 */
-		if (src_addr->sa_family == AF_INET) {
-			*addrlen = sizeof(struct sockaddr_in);
-		} else if (src_addr->sa_family == AF_INET6) {
-			*addrlen = sizeof(struct sockaddr_in6);
-		} else {
-			errno = ENOTSUP;
+		rv = sock_get_src_addr(ctx, pkt, src_addr, addrlen);
+		if (rv < 0) {
+			errno = -rv;
 			goto fail;
 		}
 	}
@@ -1440,6 +1593,468 @@ ssize_t z_vrfy_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
 #include <syscalls/zsock_recvfrom_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
+static ssize_t zsock_recv_dgram_msg(struct net_context *ctx,
+				    struct msghdr *msg, int flags,
+				    k_timeout_t timeout)
+{
+	size_t read_len = 0;
+	struct net_pkt *pkt;
+	size_t recv_len;
+	size_t i;
+	int ret;
+
+	if (!K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		ret = zsock_wait_data(ctx, &timeout);
+		if (ret < 0) {
+			errno = -ret;
+			return -1;
+		}
+	}
+
+	pkt = k_fifo_get(&ctx->recv_q, timeout);
+	if (!pkt) {
+		errno = EAGAIN;
+		return -1;
+	}
+
+	msg->msg_flags = 0;
+
+	if (msg->msg_name && msg->msg_namelen > 0) {
+		ret = sock_get_src_addr(ctx, pkt, msg->msg_name,
+					&msg->msg_namelen);
+		if (ret < 0) {
+			errno = -ret;
+			goto fail;
+		}
+	}
+
+	recv_len = net_pkt_remaining_data(pkt);
+
+	for (i = 0; i < msg->msg_iovlen && read_len < recv_len; i++) {
+		size_t len = MIN(msg->msg_iov[i].iov_len, recv_len - read_len);
+
+		if (net_pkt_read(pkt, msg->msg_iov[i].iov_base, len)) {
+			errno = ENOBUFS;
+			goto fail;
+		}
+
+		read_len += len;
+	}
+
+	if (read_len < recv_len) {
+		msg->msg_flags |= ZSOCK_MSG_TRUNC;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS)) {
+		net_socket_update_tc_rx_time(pkt, k_cycle_get_32());
+	}
+
+	net_pkt_unref(pkt);
+
+	return (flags & ZSOCK_MSG_TRUNC) ? recv_len : read_len;
+
+fail:
+	net_pkt_unref(pkt);
+
+	return -1;
+}
+
+static int zsock_recvmmsg_ctx(struct net_context *ctx,
+			      struct mmsghdr *msgvec,
+			      unsigned int vlen, int flags)
+{
+	k_timeout_t timeout = K_FOREVER;
+	unsigned int i;
+	ssize_t ret;
+	uint64_t end;
+
+	if (net_context_get_type(ctx) != SOCK_DGRAM ||
+	    (flags & ZSOCK_MSG_PEEK)) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	} else {
+		net_context_get_option(ctx, NET_OPT_RCVTIMEO, &timeout, NULL);
+	}
+
+	end = sys_clock_timeout_end_calc(timeout);
+
+	for (i = 0; i < vlen; i++) {
+		ret = zsock_recv_dgram_msg(ctx, &msgvec[i].msg_hdr, flags,
+					   timeout);
+		if (ret < 0) {
+			break;
+		}
+
+		msgvec[i].msg_len = ret;
+
+		if (flags & ZSOCK_MSG_WAITFORONE) {
+			timeout = K_NO_WAIT;
+		} else {
+			timeout_recalc(end, &timeout);
+		}
+	}
+
+	/* Report the error only if nothing was received, otherwise it is
+	 * returned by the next call.
+	 */
+	if (i == 0 && vlen > 0) {
+		return -1;
+	}
+
+	return i;
+}
+
+int z_impl_zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+			  unsigned int vlen, int flags)
+{
+	VTABLE_CALL(recvmmsg, sock, msgvec, vlen, flags);
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	struct mmsghdr *vec_copy;
+	unsigned int copied;
+	unsigned int i;
+	size_t size;
+	int ret = -1;
+
+	if (vlen == 0) {
+		return 0;
+	}
+
+	Z_OOPS(Z_SYSCALL_VERIFY_MSG(!size_mul_overflow(vlen, sizeof(*msgvec),
+						       &size),
+				    "vlen too large"));
+
+	vec_copy = z_user_alloc_from_copy(msgvec, size);
+	if (!vec_copy) {
+		errno = ENOMEM;
+		return -1;
+	}
+
+	/* The data is received directly to the user buffers, so only the
+	 * iovec arrays need to be copied after the buffers are validated.
+	 */
+	for (copied = 0; copied < vlen; copied++) {
+		struct msghdr *msg = &vec_copy[copied].msg_hdr;
+
+		msg->msg_control = NULL;
+		msg->msg_controllen = 0;
+
+		msg->msg_iov = z_user_alloc_from_copy(msg->msg_iov,
+				       msg->msg_iovlen * sizeof(struct iovec));
+		if (!msg->msg_iov) {
+			errno = ENOMEM;
+			goto out;
+		}
+
+		for (i = 0; i < msg->msg_iovlen; i++) {
+			if (Z_SYSCALL_MEMORY_WRITE(msg->msg_iov[i].iov_base,
+						   msg->msg_iov[i].iov_len)) {
+				errno = EFAULT;
+				copied++;
+				goto out;
+			}
+		}
+
+		if (msg->msg_name &&
+		    Z_SYSCALL_MEMORY_WRITE(msg->msg_name, msg->msg_namelen)) {
+			errno = EFAULT;
+			copied++;
+			goto out;
+		}
+	}
+
+	ret = z_impl_zsock_recvmmsg(sock, vec_copy, vlen, flags);
+
+	for (i = 0; ret > 0 && i < (unsigned int)ret; i++) {
+		Z_OOPS(z_user_to_copy(&msgvec[i].msg_len, &vec_copy[i].msg_len,
+				      sizeof(msgvec[i].msg_len)));
+		Z_OOPS(z_user_to_copy(&msgvec[i].msg_hdr.msg_namelen,
+				      &vec_copy[i].msg_hdr.msg_namelen,
+				      sizeof(socklen_t)));
+		Z_OOPS(z_user_to_copy(&msgvec[i].msg_hdr.msg_flags,
+				      &vec_copy[i].msg_hdr.msg_flags,
+				      sizeof(int)));
+	}
+
+out:
+	for (i = 0; i < copied; i++) {
+		k_free(vec_copy[i].msg_hdr.msg_iov);
+	}
+
+	k_free(vec_copy);
+
+	return ret;
+}
+#include <syscalls/zsock_recvmmsg_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY)
+struct zsock_zerocopy_data {
+	zsock_zerocopy_cb_t cb;
+	void *user_data;
+	const void *buf;
+	size_t len;
+};
+
+static void zsock_zerocopy_destroy(struct net_buf *buf)
+{
+	struct zsock_zerocopy_data data =
+		*(struct zsock_zerocopy_data *)net_buf_user_data(buf);
+
+	/* Release the buffer first so that the callback can queue the
+	 * next send right away.
+	 */
+	net_buf_destroy(buf);
+
+	if (data.cb) {
+		data.cb(data.buf, data.len, data.user_data);
+	}
+}
+
+NET_BUF_POOL_DEFINE(zsock_zerocopy_pool, CONFIG_NET_SOCKETS_ZEROCOPY_BUF_COUNT,
+		    0, sizeof(struct zsock_zerocopy_data),
+		    zsock_zerocopy_destroy);
+
+static struct net_context *get_native_ctx(int sock, struct k_mutex **lock)
+{
+	const struct socket_op_vtable *vtable;
+	void *obj;
+
+	obj = get_sock_vtable(sock, &vtable, lock);
+	if (obj == NULL) {
+		errno = EBADF;
+		return NULL;
+	}
+
+	/* Only native sockets have a net_context to pass buffers to */
+	if (vtable != &sock_fd_op_vtable) {
+		errno = EOPNOTSUPP;
+		return NULL;
+	}
+
+	return obj;
+}
+
+static ssize_t zsock_sendto_zerocopy_ctx(struct net_context *ctx,
+					 const void *buf, size_t len,
+					 int flags,
+					 const struct sockaddr *dest_addr,
+					 socklen_t addrlen,
+					 zsock_zerocopy_cb_t cb,
+					 void *user_data)
+{
+	k_timeout_t timeout = K_FOREVER;
+	uint32_t retry_timeout = WAIT_BUFS_INITIAL_MS;
+	struct zsock_zerocopy_data *data;
+	uint64_t buf_timeout = 0;
+	struct net_buf *frag;
+	uint64_t end;
+	int status;
+
+	if (net_context_get_type(ctx) != SOCK_DGRAM) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	} else {
+		net_context_get_option(ctx, NET_OPT_SNDTIMEO, &timeout, NULL);
+		buf_timeout = sys_clock_timeout_end_calc(MAX_WAIT_BUFS);
+	}
+
+	end = sys_clock_timeout_end_calc(timeout);
+
+	frag = net_buf_alloc_with_data(&zsock_zerocopy_pool, (void *)buf, len,
+				       timeout);
+	if (!frag) {
+		errno = ENOBUFS;
+		return -1;
+	}
+
+	data = net_buf_user_data(frag);
+	data->cb = cb;
+	data->user_data = user_data;
+	data->buf = buf;
+	data->len = len;
+
+	timeout_recalc(end, &timeout);
+
+	status = net_context_recv(ctx, zsock_received_cb,
+				  K_NO_WAIT, ctx->user_data);
+	if (status < 0) {
+		errno = -status;
+		status = -1;
+		goto out;
+	}
+
+	while (1) {
+		status = net_context_sendto_buf(ctx, frag, dest_addr, addrlen,
+						NULL, timeout, ctx->user_data);
+		if (status < 0) {
+			status = send_check_and_wait(ctx, status, buf_timeout,
+						     timeout, &retry_timeout);
+			if (status < 0) {
+				goto out;
+			}
+
+			/* Update the timeout value in case loop is repeated. */
+			timeout_recalc(end, &timeout);
+
+			continue;
+		}
+
+		break;
+	}
+
+out:
+	/* The packet keeps its own reference until it has been sent, the
+	 * completion callback is called when the last one is released.
+	 */
+	net_buf_unref(frag);
+
+	return status;
+}
+
+ssize_t zsock_sendto_zerocopy(int sock, const void *buf, size_t len,
+			      int flags, const struct sockaddr *dest_addr,
+			      socklen_t addrlen, zsock_zerocopy_cb_t cb,
+			      void *user_data)
+{
+	struct net_context *ctx;
+	struct k_mutex *lock;
+	ssize_t ret;
+
+	ctx = get_native_ctx(sock, &lock);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	ret = zsock_sendto_zerocopy_ctx(ctx, buf, len, flags, dest_addr,
+					addrlen, cb, user_data);
+
+	k_mutex_unlock(lock);
+
+	return ret;
+}
+
+static ssize_t zsock_recv_zerocopy_ctx(struct net_context *ctx,
+				       struct net_pkt **pkt, int flags,
+				       struct sockaddr *src_addr,
+				       socklen_t *addrlen)
+{
+	enum net_sock_type sock_type = net_context_get_type(ctx);
+	k_timeout_t timeout = K_FOREVER;
+	struct net_pkt *rx;
+	size_t len;
+	int ret;
+
+	if (sock_type == SOCK_STREAM) {
+		if (net_context_get_state(ctx) != NET_CONTEXT_CONNECTED) {
+			errno = ENOTCONN;
+			return -1;
+		}
+	} else if (sock_type != SOCK_DGRAM) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	} else if (!sock_is_eof(ctx) && !sock_is_error(ctx)) {
+		net_context_get_option(ctx, NET_OPT_RCVTIMEO, &timeout, NULL);
+
+		ret = zsock_wait_data(ctx, &timeout);
+		if (ret < 0) {
+			errno = -ret;
+			return -1;
+		}
+	}
+
+	rx = k_fifo_get(&ctx->recv_q, K_NO_WAIT);
+	if (!rx) {
+		if (sock_type == SOCK_STREAM && sock_is_error(ctx)) {
+			errno = POINTER_TO_INT(ctx->user_data);
+			return -1;
+		} else if (sock_type == SOCK_STREAM && sock_is_eof(ctx)) {
+			return 0;
+		}
+
+		errno = EAGAIN;
+		return -1;
+	}
+
+	if (sock_type == SOCK_DGRAM && src_addr && addrlen) {
+		ret = sock_get_src_addr(ctx, rx, src_addr, addrlen);
+		if (ret < 0) {
+			net_pkt_unref(rx);
+			errno = -ret;
+			return -1;
+		}
+	}
+
+	len = net_pkt_remaining_data(rx);
+
+	if (sock_type == SOCK_STREAM) {
+		if (net_pkt_eof(rx)) {
+			sock_set_eof(ctx);
+		}
+
+		/* The data is considered consumed once handed over */
+		net_context_update_recv_wnd(ctx, len);
+
+		if (len == 0) {
+			net_pkt_unref(rx);
+			return 0;
+		}
+	}
+
+	if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS)) {
+		net_socket_update_tc_rx_time(rx, k_cycle_get_32());
+	}
+
+	*pkt = rx;
+
+	return len;
+}
+
+ssize_t zsock_recv_zerocopy(int sock, struct net_pkt **pkt, int flags,
+			    struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	struct net_context *ctx;
+	struct k_mutex *lock;
+	ssize_t ret;
+
+	if (pkt == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	ctx = get_native_ctx(sock, &lock);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	ret = zsock_recv_zerocopy_ctx(ctx, pkt, flags, src_addr, addrlen);
+
+	k_mutex_unlock(lock);
+
+	return ret;
+}
+#endif /* CONFIG_NET_SOCKETS_ZEROCOPY */
+
 /* As this is limited function, we don't follow POSIX signature, with
  * "..." instead of last arg.
  */
@@ -2549,6 +3164,18 @@ static ssize_t sock_sendmsg_vmeth(void *obj, const struct msghdr *msg,
 	return zsock_sendmsg_ctx(obj, msg, flags);
 }
 
+static int sock_sendmmsg_vmeth(void *obj, struct mmsghdr *msgvec,
+			       unsigned int vlen, int flags)
+{
+	return zsock_sendmmsg_ctx(obj, msgvec, vlen, flags);
+}
+
+static int sock_recvmmsg_vmeth(void *obj, struct mmsghdr *msgvec,
+			       unsigned int vlen, int flags)
+{
+	return zsock_recvmmsg_ctx(obj, msgvec, vlen, flags);
+}
+
 static ssize_t sock_recvfrom_vmeth(void *obj, void *buf, size_t max_len,
 				   int flags, struct sockaddr *src_addr,
 				   socklen_t *addrlen)
@@ -2604,6 +3231,8 @@ const struct socket_op_vtable sock_fd_op_vtable = {
 	.setsockopt = sock_setsockopt_vmeth,
 	.getpeername = sock_getpeername_vmeth,
 	.getsockname = sock_getsockname_vmeth,
+	.sendmmsg = sock_sendmmsg_vmeth,
+	.recvmmsg = sock_recvmmsg_vmeth,
 };
 
 #if defined(CONFIG_NET_NATIVE)
@@ -74,6 +74,10 @@ struct socket_op_vtable {
 			   socklen_t *addrlen);
 	int (*getsockname)(void *obj, struct sockaddr *addr,
 			   socklen_t *addrlen);
+	int (*sendmmsg)(void *obj, struct mmsghdr *msgvec, unsigned int vlen,
+			int flags);
+	int (*recvmmsg)(void *obj, struct mmsghdr *msgvec, unsigned int vlen,
+			int flags);
 };
 
 size_t msghdr_non_empty_iov_count(const struct msghdr *msg);
@@ -0,0 +1,268 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_sock_svc, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <errno.h>
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/socket_service.h>
+
+#include "sockets_internal.h"
+
+#if defined(CONFIG_NET_TC_THREAD_COOPERATIVE)
+#define THREAD_PRIORITY K_PRIO_COOP(CONFIG_NUM_COOP_PRIORITIES - 1)
+#else
+#define THREAD_PRIORITY K_PRIO_PREEMPT(CONFIG_NUM_PREEMPT_PRIORITIES - 1)
+#endif
+
+/* Poll array layout: the wake up socket, then the service sockets */
+#define FD_WAKE 0
+#define FD_SERVICES 1
+#define FD_COUNT CONFIG_NET_SOCKETS_POLL_MAX
+
+/* Back off when poll fails, so that a bad socket does not spin the thread */
+#define POLL_ERROR_DELAY_MS 100
+
+BUILD_ASSERT(FD_COUNT > FD_SERVICES, "No room for the service sockets");
+
+/* Only used from the service thread */
+static struct zsock_pollfd poll_fds[FD_COUNT];
+static struct net_socket_service_event *polled[FD_COUNT];
+
+static int wake_fd[2] = { -1, -1 };
+static atomic_t wakeups;
+
+/* Protects the events of all the services */
+static K_MUTEX_DEFINE(service_lock);
+static K_KERNEL_STACK_DEFINE(service_stack, CONFIG_NET_SOCKETS_SERVICE_STACK_SIZE);
+static struct k_thread service_thread;
+
+static void service_wake(void)
+{
+	(void)zsock_send(wake_fd[0], "w", 1, ZSOCK_MSG_DONTWAIT);
+}
+
+static void service_work(struct k_work *work)
+{
+	struct net_socket_service_event *pev =
+		CONTAINER_OF(work, struct net_socket_service_event, work);
+
+	pev->svc->handler(work);
+
+	k_mutex_lock(&service_lock, K_FOREVER);
+	pev->busy = false;
+	k_mutex_unlock(&service_lock);
+
+	/* A socket served from the service thread is polled again anyway */
+	if (pev->svc->work_q != NULL) {
+		service_wake();
+	}
+}
+
+/* Number of sockets registered by the other services */
+static int service_fds_count(const struct net_socket_service_desc *except)
+{
+	int count = 0;
+
+	NET_SOCKET_SERVICE_FOREACH(service) {
+		if (service == except) {
+			continue;
+		}
+
+		for (int i = 0; i < service->pev_len; i++) {
+			if (service->pev[i].event.fd >= 0) {
+				count++;
+			}
+		}
+	}
+
+	return count;
+}
+
+int net_socket_service_register(const struct net_socket_service_desc *service,
+				struct zsock_pollfd *fds, int len, void *user_data)
+{
+	int count = 0;
+	int i;
+
+	if (service == NULL || len < 0 || (len > 0 && fds == NULL)) {
+		return -EINVAL;
+	}
+
+	if (len > service->pev_len) {
+		return -ENOMEM;
+	}
+
+	if (wake_fd[0] < 0) {
+		return -ENETDOWN;
+	}
+
+	for (i = 0; i < len; i++) {
+		if (fds[i].fd >= 0) {
+			count++;
+		}
+	}
+
+	k_mutex_lock(&service_lock, K_FOREVER);
+
+	/* All the sockets are polled at once */
+	if (count > 0 && service_fds_count(service) + count > FD_COUNT - FD_SERVICES) {
+		k_mutex_unlock(&service_lock);
+		NET_DBG("%s: too many sockets, max %d for all the services", service->owner,
+			FD_COUNT - FD_SERVICES);
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < service->pev_len; i++) {
+		struct net_socket_service_event *pev = &service->pev[i];
+
+		pev->event.fd = i < len ? fds[i].fd : -1;
+		pev->event.events = i < len ? fds[i].events : 0;
+		pev->event.revents = 0;
+		pev->user_data = user_data;
+	}
+
+	k_mutex_unlock(&service_lock);
+
+	NET_DBG("%s: %d socket(s) registered", service->owner, len);
+
+	service_wake();
+
+	return 0;
+}
+
+uint32_t net_socket_service_wakeups(void)
+{
+	return (uint32_t)atomic_get(&wakeups);
+}
+
+/* Fill the poll array with the sockets that are not being served */
+static int service_fds_build(void)
+{
+	int count = FD_SERVICES;
+
+	k_mutex_lock(&service_lock, K_FOREVER);
+
+	NET_SOCKET_SERVICE_FOREACH(service) {
+		for (int i = 0; i < service->pev_len; i++) {
+			struct net_socket_service_event *pev = &service->pev[i];
+
+			if (pev->event.fd < 0 || pev->busy) {
+				continue;
+			}
+
+			/* Registrations never exceed the poll array */
+			__ASSERT_NO_MSG(count < FD_COUNT);
+
+			poll_fds[count].fd = pev->event.fd;
+			poll_fds[count].events = pev->event.events;
+			poll_fds[count].revents = 0;
+			polled[count] = pev;
+			count++;
+		}
+	}
+
+	k_mutex_unlock(&service_lock);
+
+	return count;
+}
+
+static void service_dispatch(struct net_socket_service_event *pev, int fd, short revents)
+{
+	const struct net_socket_service_desc *service = pev->svc;
+
+	k_mutex_lock(&service_lock, K_FOREVER);
+
+	/* The socket may have been unregistered while polling */
+	if (pev->event.fd != fd) {
+		k_mutex_unlock(&service_lock);
+		return;
+	}
+
+	pev->event.revents = revents;
+	pev->busy = true;
+
+	k_mutex_unlock(&service_lock);
+
+	if (service->work_q == NULL) {
+		service_work(&pev->work);
+	} else {
+		(void)k_work_submit_to_queue(service->work_q, &pev->work);
+	}
+}
+
+static void service_loop(void *p1, void *p2, void *p3)
+{
+	char wake[8];
+	int count, i, ret;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	poll_fds[FD_WAKE].fd = wake_fd[1];
+	poll_fds[FD_WAKE].events = ZSOCK_POLLIN;
+
+	while (true) {
+		count = service_fds_build();
+
+		poll_fds[FD_WAKE].revents = 0;
+
+		ret = zsock_poll_internal(poll_fds, count, K_FOREVER);
+		if (ret < 0) {
+			LOG_ERR("Poll error (%d)", -errno);
+			k_msleep(POLL_ERROR_DELAY_MS);
+			continue;
+		}
+
+		atomic_inc(&wakeups);
+
+		if (poll_fds[FD_WAKE].revents & ZSOCK_POLLIN) {
+			/* The registered sockets changed */
+			while (zsock_recv(wake_fd[1], wake, sizeof(wake), ZSOCK_MSG_DONTWAIT) > 0) {
+			}
+		}
+
+		for (i = FD_SERVICES; i < count; i++) {
+			if (poll_fds[i].revents != 0) {
+				service_dispatch(polled[i], poll_fds[i].fd, poll_fds[i].revents);
+			}
+		}
+	}
+}
+
+static int socket_service_init(const struct device *dev)
+{
+	int ret;
+
+	ARG_UNUSED(dev);
+
+	NET_SOCKET_SERVICE_FOREACH(service) {
+		for (int i = 0; i < service->pev_len; i++) {
+			k_work_init(&service->pev[i].work, service_work);
+			service->pev[i].event.fd = -1;
+			service->pev[i].svc = service;
+		}
+	}
+
+	ret = zsock_socketpair(AF_UNIX, SOCK_STREAM, 0, wake_fd);
+	if (ret < 0) {
+		ret = -errno;
+		LOG_ERR("Cannot create wake up socket (%d)", ret);
+		return ret;
+	}
+
+	k_thread_create(&service_thread, service_stack,
+			K_KERNEL_STACK_SIZEOF(service_stack), service_loop,
+			NULL, NULL, NULL, THREAD_PRIORITY, 0, K_NO_WAIT);
+	k_thread_name_set(&service_thread, "net_socket_service");
+
+	return 0;
+}
+
+SYS_INIT(socket_service_init, POST_KERNEL, CONFIG_NET_SOCKETS_SERVICE_INIT_PRIO);
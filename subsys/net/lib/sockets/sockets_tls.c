@@ -51,6 +51,7 @@ LOG_MODULE_REGISTER(net_sock_tls, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #include <mbedtls/error.h>
 #include <mbedtls/platform.h>
 #include <mbedtls/ssl_cache.h>
+#include <mbedtls/ssl_ticket.h>
 #endif /* CONFIG_MBEDTLS */
 
 #include "sockets_internal.h"
@@ -99,8 +100,11 @@ struct dtls_timing_context {
 
 /** TLS peer address/session ID mapping. */
 struct tls_session_cache {
-	/** Creation time. */
-	int64_t timestamp;
+	/** Link in the hash bucket of the peer address. */
+	sys_snode_t hash_node;
+
+	/** Link in the list of entries in the order of their last use. */
+	sys_dnode_t lru_node;
 
 	/** Peer address. */
 	struct sockaddr peer_addr;
@@ -138,6 +142,9 @@ __net_socket struct tls_context {
 	/** Information whether TLS handshake is currently in progress. */
 	bool handshake_in_progress;
 
+	/** Information whether the server resumed the session of its peer. */
+	bool session_resumed;
+
 	/** Information whether TLS handshake is complete or not. */
 	struct k_sem tls_established;
 
@@ -172,6 +179,11 @@ __net_socket struct tls_context {
 		/** Session cache enabled on a socket. */
 		bool cache_enabled;
 
+#if CONFIG_NET_SOCKETS_TLS_TX_COALESCE_SIZE > 0
+		/** Small writes collected into larger TLS records. */
+		bool tx_coalesce;
+#endif
+
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
 		/* DTLS handshake timeout */
 		uint32_t dtls_handshake_timeout_min;
@@ -193,6 +205,19 @@ __net_socket struct tls_context {
 	socklen_t dtls_peer_addrlen;
 #endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
 
+#if CONFIG_NET_SOCKETS_TLS_TX_COALESCE_SIZE > 0
+	/** Writes not yet sent in a TLS record. */
+	uint8_t tx_buf[CONFIG_NET_SOCKETS_TLS_TX_COALESCE_SIZE];
+
+	/** Length of data in tx_buf. */
+	size_t tx_len;
+
+	/** Information whether the last write of tx_buf did not complete,
+	 * mbedTLS then expects the same data to be written again.
+	 */
+	bool tx_stalled;
+#endif
+
 #if defined(CONFIG_MBEDTLS)
 	/** mbedTLS context. */
 	mbedtls_ssl_context ssl;
@@ -220,10 +245,24 @@ static struct tls_context tls_contexts[CONFIG_NET_SOCKETS_TLS_MAX_CONTEXTS];
 
 static struct tls_session_cache client_cache[CONFIG_NET_SOCKETS_TLS_MAX_CLIENT_SESSION_COUNT];
 
+/* Stored client sessions, hashed by their peer address */
+static sys_slist_t client_cache_hash[CONFIG_NET_SOCKETS_TLS_CLIENT_SESSION_HASH_SIZE];
+
+/* All client cache entries, most recently used first and unused last */
+static sys_dlist_t client_cache_lru;
+
+/* A mutex for protecting the client session cache. */
+static struct k_mutex client_cache_lock;
+
 #if defined(MBEDTLS_SSL_CACHE_C)
 static mbedtls_ssl_cache_context server_cache;
 #endif
 
+#if defined(MBEDTLS_SSL_TICKET_C)
+static mbedtls_ssl_ticket_context server_ticket;
+static bool server_ticket_ready;
+#endif
+
 /* A mutex for protecting TLS context allocation. */
 static struct k_mutex context_lock;
 
@@ -236,6 +275,13 @@ static void tls_session_cache_reset(void)
 	}
 
 	(void)memset(client_cache, 0, sizeof(client_cache));
+	(void)memset(client_cache_hash, 0, sizeof(client_cache_hash));
+
+	sys_dlist_init(&client_cache_lru);
+
+	for (int i = 0; i < ARRAY_SIZE(client_cache); i++) {
+		sys_dlist_append(&client_cache_lru, &client_cache[i].lru_node);
+	}
 }
 
 bool net_socket_is_tls(void *obj)
@@ -313,13 +359,17 @@ static int tls_init(const struct device *unused)
 #endif
 
 	(void)memset(tls_contexts, 0, sizeof(tls_contexts));
-	(void)memset(client_cache, 0, sizeof(client_cache));
+	tls_session_cache_reset();
 
 	k_mutex_init(&context_lock);
+	k_mutex_init(&client_cache_lock);
 
 #if defined(MBEDTLS_SSL_CACHE_C)
 	mbedtls_ssl_cache_init(&server_cache);
 #endif
+#if defined(MBEDTLS_SSL_TICKET_C)
+	mbedtls_ssl_ticket_init(&server_ticket);
+#endif
 
 	return 0;
 }
@@ -509,42 +559,80 @@ static bool peer_addr_cmp(const struct sockaddr *addr,
 	return false;
 }
 
-static int tls_session_save(const struct sockaddr *peer_addr,
-			    mbedtls_ssl_session *session)
+static sys_slist_t *tls_session_bucket(const struct sockaddr *peer_addr)
 {
-	struct tls_session_cache *entry = NULL;
-	size_t session_len;
-	int ret;
+	uint32_t key = 0U;
 
-	for (int i = 0; i < ARRAY_SIZE(client_cache); i++) {
-		if (client_cache[i].session == NULL) {
-			/* New entry. */
-			if (entry == NULL || entry->session != NULL) {
-				entry = &client_cache[i];
-			}
-		} else {
-			if (peer_addr_cmp(&client_cache[i].peer_addr, peer_addr)) {
-				/* Reuse old entry for given address. */
-				entry = &client_cache[i];
-				break;
-			}
+	if (IS_ENABLED(CONFIG_NET_IPV6) && peer_addr->sa_family == AF_INET6) {
+		const struct sockaddr_in6 *addr6 = net_sin6(peer_addr);
 
-			/* Remember the oldest entry and reuse if needed. */
-			if (entry == NULL ||
-			    (entry->session != NULL &&
-			     entry->timestamp < client_cache[i].timestamp)) {
-				entry = &client_cache[i];
-			}
+		key = ntohl(UNALIGNED_GET(&addr6->sin6_addr.s6_addr32[3])) ^
+		      ntohs(addr6->sin6_port);
+	} else if (IS_ENABLED(CONFIG_NET_IPV4) && peer_addr->sa_family == AF_INET) {
+		const struct sockaddr_in *addr4 = net_sin(peer_addr);
+
+		key = ntohl(UNALIGNED_GET(&addr4->sin_addr.s_addr)) ^
+		      ntohs(addr4->sin_port);
+	}
+
+	return &client_cache_hash[key % ARRAY_SIZE(client_cache_hash)];
+}
+
+static struct tls_session_cache *tls_session_find(const struct sockaddr *peer_addr)
+{
+	struct tls_session_cache *entry;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(tls_session_bucket(peer_addr), entry,
+				     hash_node) {
+		if (peer_addr_cmp(&entry->peer_addr, peer_addr)) {
+			return entry;
 		}
 	}
 
-	/* Allocate session and save */
+	return NULL;
+}
 
+/* Free the session of an entry and make it the first one to be reused. */
+static void tls_session_discard(struct tls_session_cache *entry)
+{
 	if (entry->session != NULL) {
 		mbedtls_free(entry->session);
 		entry->session = NULL;
+		entry->session_len = 0;
+
+		(void)sys_slist_find_and_remove(
+			tls_session_bucket(&entry->peer_addr),
+			&entry->hash_node);
 	}
 
+	sys_dlist_remove(&entry->lru_node);
+	sys_dlist_append(&client_cache_lru, &entry->lru_node);
+}
+
+static void tls_session_touch(struct tls_session_cache *entry)
+{
+	sys_dlist_remove(&entry->lru_node);
+	sys_dlist_prepend(&client_cache_lru, &entry->lru_node);
+}
+
+static int tls_session_save(const struct sockaddr *peer_addr,
+			    mbedtls_ssl_session *session)
+{
+	struct tls_session_cache *entry;
+	size_t session_len;
+	int ret;
+
+	entry = tls_session_find(peer_addr);
+	if (entry == NULL) {
+		/* Take an unused entry, or the least recently used one. */
+		entry = CONTAINER_OF(sys_dlist_peek_tail(&client_cache_lru),
+				     struct tls_session_cache, lru_node);
+	}
+
+	/* Allocate session and save */
+
+	tls_session_discard(entry);
+
 	(void)mbedtls_ssl_session_save(session, NULL, 0, &session_len);
 
 	entry->session = mbedtls_calloc(1, session_len);
@@ -563,26 +651,21 @@ static int tls_session_save(const struct sockaddr *peer_addr,
 	}
 
 	entry->session_len = session_len;
-	entry->timestamp = k_uptime_get();
 	memcpy(&entry->peer_addr, peer_addr, sizeof(*peer_addr));
 
+	sys_slist_prepend(tls_session_bucket(peer_addr), &entry->hash_node);
+	tls_session_touch(entry);
+
 	return 0;
 }
 
 static int tls_session_get(const struct sockaddr *peer_addr,
 			   mbedtls_ssl_session *session)
 {
-	struct tls_session_cache *entry = NULL;
+	struct tls_session_cache *entry;
 	int ret;
 
-	for (int i = 0; i < ARRAY_SIZE(client_cache); i++) {
-		if (client_cache[i].session != NULL &&
-		    peer_addr_cmp(&client_cache[i].peer_addr, peer_addr)) {
-			entry = &client_cache[i];
-			break;
-		}
-	}
-
+	entry = tls_session_find(peer_addr);
 	if (entry == NULL) {
 		return -ENOENT;
 	}
@@ -591,11 +674,12 @@ static int tls_session_get(const struct sockaddr *peer_addr,
 				       entry->session_len);
 	if (ret < 0) {
 		/* Discard corrupted session data. */
-		mbedtls_free(entry->session);
-		entry->session = NULL;
+		tls_session_discard(entry);
 		return -EIO;
 	}
 
+	tls_session_touch(entry);
+
 	return 0;
 }
 
@@ -620,7 +704,9 @@ static void tls_session_store(struct tls_context *context,
 		goto exit;
 	}
 
+	k_mutex_lock(&client_cache_lock, K_FOREVER);
 	ret = tls_session_save(&peer_addr, &session);
+	k_mutex_unlock(&client_cache_lock);
 	if (ret < 0) {
 		NET_ERR("Failed to save session for %p", context);
 	}
@@ -644,7 +730,9 @@ static void tls_session_restore(struct tls_context *context,
 	memcpy(&peer_addr, addr, addrlen);
 	mbedtls_ssl_session_init(&session);
 
+	k_mutex_lock(&client_cache_lock, K_FOREVER);
 	ret = tls_session_get(&peer_addr, &session);
+	k_mutex_unlock(&client_cache_lock);
 	if (ret < 0) {
 		NET_DBG("Session not found for %p", context);
 		goto exit;
@@ -661,14 +749,102 @@ exit:
 
 static void tls_session_purge(void)
 {
+	k_mutex_lock(&client_cache_lock, K_FOREVER);
 	tls_session_cache_reset();
+	k_mutex_unlock(&client_cache_lock);
 
 #if defined(MBEDTLS_SSL_CACHE_C)
 	mbedtls_ssl_cache_free(&server_cache);
 	mbedtls_ssl_cache_init(&server_cache);
 #endif
+
+#if defined(MBEDTLS_SSL_TICKET_C)
+	/* New ticket keys are generated for the next server session, so
+	 * that tickets issued so far are no longer accepted.
+	 */
+	k_mutex_lock(&context_lock, K_FOREVER);
+	mbedtls_ssl_ticket_free(&server_ticket);
+	mbedtls_ssl_ticket_init(&server_ticket);
+	server_ticket_ready = false;
+	k_mutex_unlock(&context_lock);
+#endif
+}
+
+#if defined(MBEDTLS_SSL_CACHE_C)
+static int tls_session_cache_get(void *data, mbedtls_ssl_session *session)
+{
+	struct tls_context *context = data;
+	int ret;
+
+	ret = mbedtls_ssl_cache_get(&server_cache, session);
+	if (ret == 0) {
+		context->session_resumed = true;
+	}
+
+	return ret;
+}
+
+static int tls_session_cache_set(void *data,
+				 const mbedtls_ssl_session *session)
+{
+	ARG_UNUSED(data);
+
+	return mbedtls_ssl_cache_set(&server_cache, session);
+}
+#endif /* MBEDTLS_SSL_CACHE_C */
+
+#if defined(MBEDTLS_SSL_TICKET_C)
+static int tls_session_ticket_write(void *data,
+				    const mbedtls_ssl_session *session,
+				    unsigned char *start,
+				    const unsigned char *end,
+				    size_t *tlen, uint32_t *lifetime)
+{
+	ARG_UNUSED(data);
+
+	return mbedtls_ssl_ticket_write(&server_ticket, session, start, end,
+					tlen, lifetime);
+}
+
+static int tls_session_ticket_parse(void *data, mbedtls_ssl_session *session,
+				    unsigned char *buf, size_t len)
+{
+	struct tls_context *context = data;
+	int ret;
+
+	ret = mbedtls_ssl_ticket_parse(&server_ticket, session, buf, len);
+	if (ret == 0) {
+		context->session_resumed = true;
+	}
+
+	return ret;
 }
 
+static int tls_session_ticket_setup(void)
+{
+	int ret = 0;
+
+	k_mutex_lock(&context_lock, K_FOREVER);
+
+	if (!server_ticket_ready) {
+		ret = mbedtls_ssl_ticket_setup(
+			&server_ticket, tls_ctr_drbg_random, NULL,
+			MBEDTLS_CIPHER_AES_256_GCM,
+			CONFIG_NET_SOCKETS_TLS_SESSION_TICKET_LIFETIME);
+		server_ticket_ready = (ret == 0);
+	}
+
+	k_mutex_unlock(&context_lock);
+
+	if (ret != 0) {
+		NET_ERR("Failed to set up session tickets, err: 0x%x.", -ret);
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+#endif /* MBEDTLS_SSL_TICKET_C */
+
 static inline int time_left(uint32_t start, uint32_t timeout)
 {
 	uint32_t elapsed = k_uptime_get_32() - start;
@@ -847,6 +1023,87 @@ static int tls_rx(void *ctx, unsigned char *buf, size_t len)
 	return received;
 }
 
+#if CONFIG_NET_SOCKETS_TLS_TX_COALESCE_SIZE > 0
+static inline bool tls_tx_coalesce_enabled(struct tls_context *ctx)
+{
+	return ctx->options.tx_coalesce;
+}
+
+/* Send the collected writes, returns 0 or an mbedTLS error code. */
+static int tls_tx_flush(struct tls_context *ctx)
+{
+	int ret;
+
+	while (ctx->tx_len > 0) {
+		ret = mbedtls_ssl_write(&ctx->ssl, ctx->tx_buf, ctx->tx_len);
+		if (ret < 0) {
+			ctx->tx_stalled = true;
+			return ret;
+		}
+
+		/* Records are limited by the maximum content length, the rest
+		 * goes into the next one.
+		 */
+		ctx->tx_len -= ret;
+		memmove(ctx->tx_buf, ctx->tx_buf + ret, ctx->tx_len);
+	}
+
+	ctx->tx_stalled = false;
+
+	return 0;
+}
+
+/* Collect a write, returns its length or an mbedTLS error code. */
+static int tls_tx_coalesce(struct tls_context *ctx, const void *buf,
+			   size_t len)
+{
+	int ret;
+
+	/* Data of a write that did not complete must not change before it
+	 * is written again.
+	 */
+	if (ctx->tx_stalled || ctx->tx_len + len > sizeof(ctx->tx_buf)) {
+		ret = tls_tx_flush(ctx);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	if (len >= sizeof(ctx->tx_buf)) {
+		/* Nothing to gain from copying, nothing is pending either. */
+		return mbedtls_ssl_write(&ctx->ssl, buf, len);
+	}
+
+	memcpy(ctx->tx_buf + ctx->tx_len, buf, len);
+	ctx->tx_len += len;
+
+	if (ctx->tx_len == sizeof(ctx->tx_buf)) {
+		/* The data is accepted, an error is reported by the next
+		 * call sending it.
+		 */
+		(void)tls_tx_flush(ctx);
+	}
+
+	return len;
+}
+#else
+static inline bool tls_tx_coalesce_enabled(struct tls_context *ctx)
+{
+	return false;
+}
+
+static inline int tls_tx_flush(struct tls_context *ctx)
+{
+	return 0;
+}
+
+static inline int tls_tx_coalesce(struct tls_context *ctx, const void *buf,
+				  size_t len)
+{
+	return mbedtls_ssl_write(&ctx->ssl, buf, len);
+}
+#endif /* CONFIG_NET_SOCKETS_TLS_TX_COALESCE_SIZE > 0 */
+
 #if defined(MBEDTLS_X509_CRT_PARSE_C)
 static bool crt_is_pem(const unsigned char *buf, size_t buflen)
 {
@@ -1067,6 +1324,13 @@ static int tls_mbedtls_reset(struct tls_context *context)
 	}
 
 	k_sem_reset(&context->tls_established);
+	context->session_resumed = false;
+
+#if CONFIG_NET_SOCKETS_TLS_TX_COALESCE_SIZE > 0
+	/* Collected writes belong to the session being reset. */
+	context->tx_len = 0;
+	context->tx_stalled = false;
+#endif
 
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
 	/* Server role: reset the address so that a new
@@ -1283,9 +1547,23 @@ static int tls_mbedtls_init(struct tls_context *context, bool is_server)
 
 #if defined(MBEDTLS_SSL_CACHE_C)
 	if (is_server && context->options.cache_enabled) {
-		mbedtls_ssl_conf_session_cache(&context->config, &server_cache,
-					       mbedtls_ssl_cache_get,
-					       mbedtls_ssl_cache_set);
+		mbedtls_ssl_conf_session_cache(&context->config, context,
+					       tls_session_cache_get,
+					       tls_session_cache_set);
+	}
+#endif
+
+#if defined(MBEDTLS_SSL_TICKET_C)
+	if (is_server && context->options.cache_enabled) {
+		ret = tls_session_ticket_setup();
+		if (ret < 0) {
+			return ret;
+		}
+
+		mbedtls_ssl_conf_session_tickets_cb(&context->config,
+						    tls_session_ticket_write,
+						    tls_session_ticket_parse,
+						    context);
 	}
 #endif
 
@@ -1603,6 +1881,18 @@ static int tls_opt_session_cache_get(struct tls_context *context,
 	return 0;
 }
 
+static int tls_opt_session_resumed_get(struct tls_context *context,
+				       void *optval, socklen_t *optlen)
+{
+	if (*optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	*(int *)optval = context->session_resumed ? 1 : 0;
+
+	return 0;
+}
+
 static int tls_opt_session_cache_purge_set(struct tls_context *context,
 					   const void *optval, socklen_t optlen)
 {
@@ -1615,6 +1905,80 @@ static int tls_opt_session_cache_purge_set(struct tls_context *context,
 	return 0;
 }
 
+static int tls_opt_tx_flush_set(struct tls_context *context,
+				const void *optval, socklen_t optlen)
+{
+	int ret;
+
+	ARG_UNUSED(optval);
+	ARG_UNUSED(optlen);
+
+	if (context->type != SOCK_STREAM) {
+		return -EOPNOTSUPP;
+	}
+
+	/* Use the blocking mode of the underlying socket. */
+	context->flags = 0;
+
+	ret = tls_tx_flush(context);
+	if (ret == MBEDTLS_ERR_SSL_WANT_READ ||
+	    ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+		return -EAGAIN;
+	} else if (ret < 0) {
+		return -EIO;
+	}
+
+	return 0;
+}
+
+#if CONFIG_NET_SOCKETS_TLS_TX_COALESCE_SIZE > 0
+static int tls_opt_tx_coalesce_set(struct tls_context *context,
+				   const void *optval, socklen_t optlen)
+{
+	int *val = (int *)optval;
+	int ret;
+
+	if (!optval) {
+		return -EINVAL;
+	}
+
+	if (sizeof(int) != optlen) {
+		return -EINVAL;
+	}
+
+	if (context->type != SOCK_STREAM) {
+		return -EOPNOTSUPP;
+	}
+
+	if (*val == TLS_TX_COALESCE_DISABLED) {
+		ret = tls_opt_tx_flush_set(context, NULL, 0);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	context->options.tx_coalesce = (*val == TLS_TX_COALESCE_ENABLED);
+
+	return 0;
+}
+
+static int tls_opt_tx_coalesce_get(struct tls_context *context,
+				   void *optval, socklen_t *optlen)
+{
+	int tx_coalesce = context->options.tx_coalesce ?
+			  TLS_TX_COALESCE_ENABLED :
+			  TLS_TX_COALESCE_DISABLED;
+
+	if (*optlen != sizeof(tx_coalesce)) {
+		return -EINVAL;
+	}
+
+	*(int *)optval = tx_coalesce;
+
+	return 0;
+}
+#endif /* CONFIG_NET_SOCKETS_TLS_TX_COALESCE_SIZE > 0 */
+
 static int tls_opt_peer_verify_set(struct tls_context *context,
 				   const void *optval, socklen_t optlen)
 {
@@ -1770,9 +2134,10 @@ int ztls_close_ctx(struct tls_context *ctx)
 {
 	int ret, err = 0;
 
-	/* Try to send close notification. */
+	/* Try to send collected writes and close notification. */
 	ctx->flags = 0;
 
+	(void)tls_tx_flush(ctx);
 	(void)mbedtls_ssl_close_notify(&ctx->ssl);
 
 	err = tls_release(ctx);
@@ -1906,7 +2271,12 @@ static ssize_t send_tls(struct tls_context *ctx, const void *buf,
 {
 	int ret;
 
-	ret = mbedtls_ssl_write(&ctx->ssl, buf, len);
+	if (tls_tx_coalesce_enabled(ctx)) {
+		ret = tls_tx_coalesce(ctx, buf, len);
+	} else {
+		ret = mbedtls_ssl_write(&ctx->ssl, buf, len);
+	}
+
 	if (ret >= 0) {
 		return ret;
 	}
@@ -2325,13 +2695,23 @@ ssize_t ztls_recvfrom_ctx(struct tls_context *ctx, void *buf, size_t max_len,
 		return -1;
 	}
 
-	ctx->flags = flags;
-
 	/* TLS */
 	if (ctx->type == SOCK_STREAM) {
+		if (tls_tx_coalesce_enabled(ctx)) {
+			/* The peer may be waiting for the collected writes
+			 * before answering, a failure is reported on send.
+			 */
+			ctx->flags = flags & ZSOCK_MSG_DONTWAIT;
+			(void)tls_tx_flush(ctx);
+		}
+
+		ctx->flags = flags;
+
 		return recv_tls(ctx, buf, max_len, flags);
 	}
 
+	ctx->flags = flags;
+
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
 	/* DTLS */
 	if (ctx->options.role == MBEDTLS_SSL_IS_SERVER) {
@@ -2373,6 +2753,16 @@ static int ztls_poll_prepare_ctx(struct tls_context *ctx,
 	int ret;
 	short events = pfd->events;
 
+	/* The peer may be waiting for the collected writes before
+	 * answering, so send them before waiting. This must not block,
+	 * what cannot be sent now is sent by the next call.
+	 */
+	if ((pfd->events & (ZSOCK_POLLIN | ZSOCK_POLLOUT)) &&
+	    tls_tx_coalesce_enabled(ctx)) {
+		ctx->flags = ZSOCK_MSG_DONTWAIT;
+		(void)tls_tx_flush(ctx);
+	}
+
 	/* DTLS client should wait for the handshake to complete before
 	 * it actually starts to poll for data.
 	 */
@@ -2775,6 +3165,16 @@ int ztls_getsockopt_ctx(struct tls_context *ctx, int level, int optname,
 		err = tls_opt_session_cache_get(ctx, optval, optlen);
 		break;
 
+	case TLS_SESSION_RESUMED:
+		err = tls_opt_session_resumed_get(ctx, optval, optlen);
+		break;
+
+#if CONFIG_NET_SOCKETS_TLS_TX_COALESCE_SIZE > 0
+	case TLS_TX_COALESCE:
+		err = tls_opt_tx_coalesce_get(ctx, optval, optlen);
+		break;
+#endif
+
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
 	case TLS_DTLS_HANDSHAKE_TIMEOUT_MIN:
 		err = tls_opt_dtls_handshake_timeout_get(ctx, optval,
@@ -2807,8 +3207,20 @@ int ztls_setsockopt_ctx(struct tls_context *ctx, int level, int optname,
 	int err;
 
 	if (level != SOL_TLS) {
-		return zsock_setsockopt(ctx->sock, level, optname,
-					optval, optlen);
+		err = zsock_setsockopt(ctx->sock, level, optname,
+				       optval, optlen);
+
+		if (err == 0 && tls_tx_coalesce_enabled(ctx) &&
+		    level == IPPROTO_TCP && optname == TCP_NODELAY &&
+		    optval != NULL && optlen == sizeof(int) &&
+		    *(const int *)optval != 0) {
+			/* Like a corked TCP socket, send what is pending
+			 * when no more delay is wanted.
+			 */
+			(void)tls_opt_tx_flush_set(ctx, NULL, 0);
+		}
+
+		return err;
 	}
 
 	switch (optname) {
@@ -2848,6 +3260,16 @@ int ztls_setsockopt_ctx(struct tls_context *ctx, int level, int optname,
 		err = tls_opt_session_cache_purge_set(ctx, optval, optlen);
 		break;
 
+#if CONFIG_NET_SOCKETS_TLS_TX_COALESCE_SIZE > 0
+	case TLS_TX_COALESCE:
+		err = tls_opt_tx_coalesce_set(ctx, optval, optlen);
+		break;
+#endif
+
+	case TLS_TX_FLUSH:
+		err = tls_opt_tx_flush_set(ctx, optval, optlen);
+		break;
+
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
 	case TLS_DTLS_HANDSHAKE_TIMEOUT_MIN:
 		err = tls_opt_dtls_handshake_timeout_set(ctx, optval,
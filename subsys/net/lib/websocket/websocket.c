@@ -576,29 +576,34 @@ static int sendmsg_all(int sock, const struct msghdr *message, int flags)
 }
 #endif /* !defined(CONFIG_NET_TEST) */
 
-static int websocket_prepare_and_send(struct websocket_context *ctx,
-				      uint8_t *header, size_t header_len,
-				      uint8_t *payload, size_t payload_len,
-				      int32_t timeout)
+/* Send a frame, io_vector[0] holds the header and the rest the payload. */
+static int websocket_sendmsg(struct websocket_context *ctx,
+			     struct iovec *io_vector, size_t iovlen,
+			     int32_t timeout)
 {
-	struct iovec io_vector[2];
 	struct msghdr msg;
 
-	io_vector[0].iov_base = header;
-	io_vector[0].iov_len = header_len;
-	io_vector[1].iov_base = payload;
-	io_vector[1].iov_len = payload_len;
-
 	memset(&msg, 0, sizeof(msg));
 
 	msg.msg_iov = io_vector;
-	msg.msg_iovlen = ARRAY_SIZE(io_vector);
+	msg.msg_iovlen = iovlen;
 
 	if (HEXDUMP_SENT_PACKETS) {
-		LOG_HEXDUMP_DBG(header, header_len, "Header");
-		if ((payload != NULL) && (payload_len > 0)) {
-			LOG_HEXDUMP_DBG(payload, payload_len, "Payload");
-		} else {
+		bool has_payload = false;
+
+		LOG_HEXDUMP_DBG(io_vector[0].iov_base, io_vector[0].iov_len,
+				"Header");
+
+		for (size_t i = 1; i < iovlen; i++) {
+			if ((io_vector[i].iov_base != NULL) &&
+			    (io_vector[i].iov_len > 0)) {
+				LOG_HEXDUMP_DBG(io_vector[i].iov_base,
+						io_vector[i].iov_len, "Payload");
+				has_payload = true;
+			}
+		}
+
+		if (!has_payload) {
 			LOG_DBG("No payload");
 		}
 	}
@@ -607,7 +612,8 @@ static int websocket_prepare_and_send(struct websocket_context *ctx,
 	/* Simulate a case where the payload is split to two. The unit test
 	 * does not set mask bit in this case.
 	 */
-	return verify_sent_and_received_msg(&msg, !(header[1] & BIT(7)));
+	return verify_sent_and_received_msg(
+		&msg, !(((uint8_t *)io_vector[0].iov_base)[1] & BIT(7)));
 #else
 	k_timeout_t tout = K_FOREVER;
 
@@ -620,43 +626,67 @@ static int websocket_prepare_and_send(struct websocket_context *ctx,
 #endif /* CONFIG_NET_TEST */
 }
 
-int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
-		       enum websocket_opcode opcode, bool mask, bool final,
-		       int32_t timeout)
+static int websocket_prepare_and_send(struct websocket_context *ctx,
+				      uint8_t *header, size_t header_len,
+				      uint8_t *payload, size_t payload_len,
+				      int32_t timeout)
 {
-	struct websocket_context *ctx;
-	uint8_t header[MAX_HEADER_LEN], hdr_len = 2;
-	uint8_t *data_to_send = (uint8_t *)payload;
-	int ret;
+	struct iovec io_vector[2];
 
-	if (opcode != WEBSOCKET_OPCODE_DATA_TEXT &&
-	    opcode != WEBSOCKET_OPCODE_DATA_BINARY &&
-	    opcode != WEBSOCKET_OPCODE_CONTINUE &&
-	    opcode != WEBSOCKET_OPCODE_CLOSE &&
-	    opcode != WEBSOCKET_OPCODE_PING &&
-	    opcode != WEBSOCKET_OPCODE_PONG) {
-		return -EINVAL;
-	}
+	io_vector[0].iov_base = header;
+	io_vector[0].iov_len = header_len;
+	io_vector[1].iov_base = payload;
+	io_vector[1].iov_len = payload_len;
 
-	ctx = z_get_fd_obj(ws_sock, NULL, 0);
-	if (ctx == NULL) {
-		return -EBADF;
+	return websocket_sendmsg(ctx, io_vector, ARRAY_SIZE(io_vector), timeout);
+}
+
+void websocket_mask_payload(uint8_t *payload, size_t payload_len,
+			    uint32_t masking_value, uint64_t offset)
+{
+	const uintptr_t align = sizeof(uintptr_t) - 1;
+	uint8_t mask[sizeof(uint32_t)];
+	size_t i = 0;
+
+	sys_put_be32(masking_value, mask);
+
+	/* XOR byte by byte until the payload is word aligned */
+	while (i < payload_len && ((uintptr_t)&payload[i] & align) != 0) {
+		payload[i] ^= mask[(offset + i) % 4];
+		i++;
 	}
 
-#if !defined(CONFIG_NET_TEST)
-	/* Websocket unit test does not use context from pool but allocates
-	 * its own, hence skip the check.
-	 */
+	if (payload_len - i >= sizeof(uintptr_t)) {
+		uint8_t pattern[sizeof(uintptr_t)];
+		uintptr_t word_mask;
 
-	if (!PART_OF_ARRAY(contexts, ctx)) {
-		return -ENOENT;
+		/* The word size is a multiple of the mask size, so every
+		 * word is masked with the same pattern.
+		 */
+		for (size_t j = 0; j < sizeof(pattern); j++) {
+			pattern[j] = mask[(offset + i + j) % 4];
+		}
+
+		memcpy(&word_mask, pattern, sizeof(word_mask));
+
+		while (payload_len - i >= sizeof(uintptr_t)) {
+			*(uintptr_t *)&payload[i] ^= word_mask;
+			i += sizeof(uintptr_t);
+		}
 	}
-#endif /* !defined(CONFIG_NET_TEST) */
 
-	NET_DBG("[%p] Len %zd %s/%d/%s", ctx, payload_len, opcode2str(opcode),
-		mask, final ? "final" : "more");
+	for (; i < payload_len; i++) {
+		payload[i] ^= mask[(offset + i) % 4];
+	}
+}
+
+static size_t websocket_header_build(uint8_t *header, uint64_t payload_len,
+				     enum websocket_opcode opcode, bool mask,
+				     bool final, uint32_t masking_value)
+{
+	size_t hdr_len = 2;
 
-	memset(header, 0, sizeof(header));
+	memset(header, 0, MAX_HEADER_LEN);
 
 	/* Is this the last packet? */
 	header[0] = final ? BIT(7) : 0;
@@ -676,40 +706,78 @@ int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
 		hdr_len += 2;
 	} else {
 		header[1] |= 127;
-		header[2] = 0;
-		header[3] = 0;
-		header[4] = 0;
-		header[5] = 0;
-		header[6] = payload_len >> 24;
-		header[7] = payload_len >> 16;
-		header[8] = payload_len >> 8;
-		header[9] = payload_len;
+		sys_put_be64(payload_len, &header[2]);
 		hdr_len += 8;
 	}
 
 	/* Add masking value if needed */
 	if (mask) {
-		int i;
+		sys_put_be32(masking_value, &header[hdr_len]);
+		hdr_len += 4;
+	}
 
-		ctx->masking_value = sys_rand32_get();
+	return hdr_len;
+}
 
-		header[hdr_len++] |= ctx->masking_value >> 24;
-		header[hdr_len++] |= ctx->masking_value >> 16;
-		header[hdr_len++] |= ctx->masking_value >> 8;
-		header[hdr_len++] |= ctx->masking_value;
+static bool websocket_opcode_is_valid(enum websocket_opcode opcode)
+{
+	return opcode == WEBSOCKET_OPCODE_DATA_TEXT ||
+	       opcode == WEBSOCKET_OPCODE_DATA_BINARY ||
+	       opcode == WEBSOCKET_OPCODE_CONTINUE ||
+	       opcode == WEBSOCKET_OPCODE_CLOSE ||
+	       opcode == WEBSOCKET_OPCODE_PING ||
+	       opcode == WEBSOCKET_OPCODE_PONG;
+}
 
-		if ((payload != NULL) && (payload_len > 0)) {
-			data_to_send = k_malloc(payload_len);
-			if (!data_to_send) {
-				return -ENOMEM;
-			}
+int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
+		       enum websocket_opcode opcode, bool mask, bool final,
+		       int32_t timeout)
+{
+	struct websocket_context *ctx;
+	uint8_t header[MAX_HEADER_LEN];
+	size_t hdr_len;
+	uint8_t *data_to_send = (uint8_t *)payload;
+	int ret;
+
+	if (!websocket_opcode_is_valid(opcode)) {
+		return -EINVAL;
+	}
 
-			memcpy(data_to_send, payload, payload_len);
+	ctx = z_get_fd_obj(ws_sock, NULL, 0);
+	if (ctx == NULL) {
+		return -EBADF;
+	}
 
-			for (i = 0; i < payload_len; i++) {
-				data_to_send[i] ^= ctx->masking_value >> (8 * (3 - i % 4));
-			}
+#if !defined(CONFIG_NET_TEST)
+	/* Websocket unit test does not use context from pool but allocates
+	 * its own, hence skip the check.
+	 */
+
+	if (!PART_OF_ARRAY(contexts, ctx)) {
+		return -ENOENT;
+	}
+#endif /* !defined(CONFIG_NET_TEST) */
+
+	NET_DBG("[%p] Len %zd %s/%d/%s", ctx, payload_len, opcode2str(opcode),
+		mask, final ? "final" : "more");
+
+	if (mask) {
+		ctx->masking_value = sys_rand32_get();
+	}
+
+	hdr_len = websocket_header_build(header, payload_len, opcode, mask,
+					 final, ctx->masking_value);
+
+	if (mask && (payload != NULL) && (payload_len > 0)) {
+		data_to_send = k_malloc(payload_len);
+		if (!data_to_send) {
+			return -ENOMEM;
 		}
+
+		memcpy(data_to_send, payload, payload_len);
+
+		websocket_mask_payload(data_to_send, payload_len,
+				       ctx->masking_value, 0);
 	}
 
 	ret = websocket_prepare_and_send(ctx, header, hdr_len,
@@ -732,6 +800,90 @@ quit:
 	return ret - hdr_len;
 }
 
+int websocket_send_frame(int ws_sock, const struct iovec *iov, size_t iovcnt,
+			 enum websocket_opcode opcode, bool mask, bool final,
+			 int32_t timeout)
+{
+	struct websocket_context *ctx;
+	struct iovec io_vector[1 + WEBSOCKET_FRAME_MAX_IOV];
+	uint8_t header[MAX_HEADER_LEN];
+	size_t payload_len = 0;
+	size_t hdr_len;
+	uint64_t offset;
+	int ret;
+
+	if (!websocket_opcode_is_valid(opcode)) {
+		return -EINVAL;
+	}
+
+	if (iovcnt > WEBSOCKET_FRAME_MAX_IOV || (iovcnt > 0 && iov == NULL)) {
+		return -EINVAL;
+	}
+
+	ctx = z_get_fd_obj(ws_sock, NULL, 0);
+	if (ctx == NULL) {
+		return -EBADF;
+	}
+
+#if !defined(CONFIG_NET_TEST)
+	if (!PART_OF_ARRAY(contexts, ctx)) {
+		return -ENOENT;
+	}
+#endif /* !defined(CONFIG_NET_TEST) */
+
+	for (size_t i = 0; i < iovcnt; i++) {
+		payload_len += iov[i].iov_len;
+	}
+
+	NET_DBG("[%p] Len %zd in %zd buffers %s/%d/%s", ctx, payload_len,
+		iovcnt, opcode2str(opcode), mask, final ? "final" : "more");
+
+	if (mask) {
+		ctx->masking_value = sys_rand32_get();
+	}
+
+	hdr_len = websocket_header_build(header, payload_len, opcode, mask,
+					 final, ctx->masking_value);
+
+	io_vector[0].iov_base = header;
+	io_vector[0].iov_len = hdr_len;
+
+	/* The iovecs are updated while sending, use a copy. */
+	offset = 0;
+
+	for (size_t i = 0; i < iovcnt; i++) {
+		io_vector[1 + i] = iov[i];
+
+		if (mask) {
+			websocket_mask_payload(iov[i].iov_base, iov[i].iov_len,
+					       ctx->masking_value, offset);
+			offset += iov[i].iov_len;
+		}
+	}
+
+	ret = websocket_sendmsg(ctx, io_vector, 1 + iovcnt, timeout);
+	if (ret < 0) {
+		NET_DBG("Cannot send ws frame (%d)", ret);
+	}
+
+	if (mask) {
+		/* Masking again gives back the application data */
+		offset = 0;
+
+		for (size_t i = 0; i < iovcnt; i++) {
+			websocket_mask_payload(iov[i].iov_base, iov[i].iov_len,
+					       ctx->masking_value, offset);
+			offset += iov[i].iov_len;
+		}
+	}
+
+	if (ret <= 0) {
+		return ret;
+	}
+
+	return ret - hdr_len;
+}
+
 static uint32_t websocket_opcode2flag(uint8_t data)
 {
 	switch (data & 0x0f) {
@@ -898,16 +1050,29 @@ int websocket_recv_msg(int ws_sock, uint8_t *buf, size_t buf_len,
 #endif /* CONFIG_NET_TEST */
 
 	do {
-		size_t parsed_count;
+		size_t parsed_count = 0;
 
 		if (ctx->recv_buf.count == 0) {
+			/* Payload that is not in the receive buffer yet is
+			 * read directly into the caller buffer.
+			 */
+			bool direct = (ctx->parser_state == WEBSOCKET_PARSER_STATE_PAYLOAD) &&
+				      (payload.count < payload.size);
+			uint8_t *dst = ctx->recv_buf.buf;
+			size_t dst_len = ctx->recv_buf.size;
+
+			if (direct) {
+				dst = &payload.buf[payload.count];
+				dst_len = MIN(ctx->parser_remaining, payload.size - payload.count);
+			}
+
 #if defined(CONFIG_NET_TEST)
-			size_t input_len = MIN(ctx->recv_buf.size,
+			size_t input_len = MIN(dst_len,
 					       test_data->input_len - test_data->input_pos);
 
 			if (input_len > 0) {
-				memcpy(ctx->recv_buf.buf,
-				       &test_data->input_buf[test_data->input_pos], input_len);
+				memcpy(dst, &test_data->input_buf[test_data->input_pos],
+				       input_len);
 				test_data->input_pos += input_len;
 				ret = input_len;
 			} else {
@@ -916,7 +1081,7 @@ int websocket_recv_msg(int ws_sock, uint8_t *buf, size_t buf_len,
 				ret = -1;
 			}
 #else
-			ret = recv(ctx->real_sock, ctx->recv_buf.buf, ctx->recv_buf.size,
+			ret = recv(ctx->real_sock, dst, dst_len,
 				   K_TIMEOUT_EQ(tout, K_NO_WAIT) ? MSG_DONTWAIT : 0);
 #endif /* CONFIG_NET_TEST */
 
@@ -934,16 +1099,27 @@ int websocket_recv_msg(int ws_sock, uint8_t *buf, size_t buf_len,
 				return -ENOTCONN;
 			}
 
-			ctx->recv_buf.count = ret;
+			NET_DBG("[%p] Received %d bytes%s", ctx, ret,
+				direct ? " of payload" : "");
 
-			NET_DBG("[%p] Received %d bytes", ctx, ret);
+			if (direct) {
+				payload.count += ret;
+				ctx->parser_remaining -= ret;
+				if (ctx->parser_remaining == 0) {
+					ctx->parser_state = WEBSOCKET_PARSER_STATE_OPCODE;
+				}
+			} else {
+				ctx->recv_buf.count = ret;
+			}
 		}
 
-		ret = websocket_parse(ctx, &payload);
-		if (ret < 0) {
-			return ret;
+		if (ctx->recv_buf.count > 0) {
+			ret = websocket_parse(ctx, &payload);
+			if (ret < 0) {
+				return ret;
+			}
+			parsed_count = ret;
 		}
-		parsed_count = ret;
 
 		if ((ctx->parser_state == WEBSOCKET_PARSER_STATE_OPCODE) ||
 		    (payload.count >= payload.size)) {
@@ -969,15 +1145,8 @@ int websocket_recv_msg(int ws_sock, uint8_t *buf, size_t buf_len,
 
 	/* Unmask the data */
 	if (ctx->masked) {
-		uint8_t *mask_as_bytes = (uint8_t *)&ctx->masking_value;
-		size_t data_buf_offset = ctx->message_len - ctx->parser_remaining - payload.count;
-
-		for (size_t i = 0; i < payload.count; i++) {
-			size_t m = data_buf_offset % 4;
-
-			payload.buf[i] ^= mask_as_bytes[3 - m];
-			data_buf_offset++;
-		}
+		websocket_mask_payload(payload.buf, payload.count, ctx->masking_value,
+				       ctx->message_len - ctx->parser_remaining - payload.count);
 	}
 
 	return payload.count;
@@ -141,6 +141,17 @@ struct test_data {
 };
 #endif /* CONFIG_NET_TEST */
 
+/**
+ * @brief Mask or unmask websocket payload in place.
+ *
+ * @param payload Payload data.
+ * @param payload_len Length of the payload data.
+ * @param masking_value Masking key of the frame.
+ * @param offset Offset of the payload data within the frame payload.
+ */
+void websocket_mask_payload(uint8_t *payload, size_t payload_len,
+			    uint32_t masking_value, uint64_t offset);
+
 /**
  * @brief Disconnect the Websocket.
  *
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/net/socket.h>
 
@@ -44,6 +45,27 @@ K_THREAD_STACK_DEFINE(zperf_work_q_stack, CONFIG_ZPERF_WORK_Q_STACK_SIZE);
 
 static struct k_work_q zperf_work_q;
 
+/* Duration of a dual test stream when the client asked for a byte count,
+ * the iperf default.
+ */
+#define DUAL_TEST_DEFAULT_DURATION_MS (10 * MSEC_PER_SEC)
+#define DUAL_TEST_DEFAULT_RATE_KBPS 1024
+
+#if CONFIG_NET_ZPERF_MAX_STREAMS > 1
+#define STREAM_THREADS (CONFIG_NET_ZPERF_MAX_STREAMS - 1)
+
+static K_THREAD_STACK_ARRAY_DEFINE(stream_stacks, STREAM_THREADS,
+				   CONFIG_NET_ZPERF_STREAM_STACK_SIZE);
+static struct k_thread stream_threads[STREAM_THREADS];
+static struct zperf_results stream_results[STREAM_THREADS];
+static int stream_ret[STREAM_THREADS];
+static zperf_stream_fn stream_fn;
+static const struct zperf_upload_params *stream_param;
+
+/* Only one upload at a time can use the stream threads */
+static K_MUTEX_DEFINE(streams_lock);
+#endif
+
 int zperf_get_ipv6_addr(char *host, char *prefix_str, struct in6_addr *addr)
 {
 	struct net_if_ipv6_prefix *prefix;
@@ -205,6 +227,217 @@ uint32_t zperf_packet_duration(uint32_t packet_size, uint32_t rate_in_kbps)
 			  (rate_in_kbps * 1024U));
 }
 
+void zperf_client_hdr_fill(struct zperf_client_hdr_v1 *hdr,
+			   const struct zperf_upload_params *param,
+			   bool dual)
+{
+	/* A negative amount is the duration of the test in 10 ms units */
+	int32_t amount = -(int32_t)DIV_ROUND_UP(param->duration_ms, 10U);
+
+	hdr->flags = dual ? htonl(ZPERF_FLAGS_VERSION1 | ZPERF_FLAGS_RUN_NOW) : 0;
+	hdr->num_of_threads = htonl(MAX(param->options.streams, 1));
+	hdr->port = htonl(dual ? param->options.dual_port : 0);
+	hdr->buffer_len = htonl(param->packet_size);
+	hdr->bandwidth = htonl(param->rate_kbps * 1024U);
+	hdr->num_of_bytes = htonl(amount);
+}
+
+static void dual_test_cb(enum zperf_status status,
+			 struct zperf_results *result,
+			 void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	switch (status) {
+	case ZPERF_SESSION_STARTED:
+		NET_INFO("Dual test stream started");
+		break;
+
+	case ZPERF_SESSION_FINISHED:
+		NET_INFO("Dual test stream sent %u packets in %u us",
+			 result->nb_packets_sent, result->client_time_in_us);
+		break;
+
+	case ZPERF_SESSION_ERROR:
+		NET_ERR("Dual test stream failed");
+		break;
+	}
+}
+
+void zperf_dual_test_check(const struct sockaddr *peer,
+			   const struct zperf_client_hdr_v1 *hdr, int proto)
+{
+	const uint32_t dual_flags = ZPERF_FLAGS_VERSION1 | ZPERF_FLAGS_RUN_NOW;
+	struct zperf_upload_params param = { 0 };
+	uint32_t flags = ntohl(UNALIGNED_GET(&hdr->flags));
+	int32_t amount = ntohl(UNALIGNED_GET(&hdr->num_of_bytes));
+	uint16_t port = ntohl(UNALIGNED_GET(&hdr->port));
+	int ret;
+
+	if ((flags & dual_flags) != dual_flags || port == 0U) {
+		return;
+	}
+
+	memcpy(&param.peer_addr, peer, sizeof(param.peer_addr));
+
+	if (peer->sa_family == AF_INET6) {
+		net_sin6(&param.peer_addr)->sin6_port = htons(port);
+	} else {
+		net_sin(&param.peer_addr)->sin_port = htons(port);
+	}
+
+	/* Only timed tests are supported */
+	param.duration_ms = amount < 0 ? (uint32_t)-amount * 10U :
+					 DUAL_TEST_DEFAULT_DURATION_MS;
+	param.packet_size = ntohl(UNALIGNED_GET(&hdr->buffer_len));
+	param.rate_kbps = DIV_ROUND_UP(ntohl(UNALIGNED_GET(&hdr->bandwidth)),
+				       1024U);
+
+	if (param.packet_size == 0U || param.packet_size > PACKET_SIZE_MAX) {
+		param.packet_size = PACKET_SIZE_MAX;
+	}
+
+	if (param.rate_kbps == 0U) {
+		param.rate_kbps = DUAL_TEST_DEFAULT_RATE_KBPS;
+	}
+
+	if (proto == IPPROTO_UDP) {
+		ret = zperf_udp_upload_async(&param, dual_test_cb, NULL);
+	} else {
+		ret = zperf_tcp_upload_async(&param, dual_test_cb, NULL);
+	}
+
+	if (ret < 0) {
+		NET_WARN("Cannot start the dual test stream (%d)", ret);
+	}
+}
+
+/* Busy and total cycles of all the CPUs, 0 if not gathered */
+static void cpu_cycles_get(uint64_t *busy, uint64_t *all)
+{
+#if defined(CONFIG_SCHED_THREAD_USAGE_ALL)
+	k_thread_runtime_stats_t stats;
+
+	if (k_thread_runtime_stats_all_get(&stats) == 0) {
+		*busy = stats.total_cycles;
+		*all = stats.execution_cycles;
+		return;
+	}
+#endif
+
+	*busy = 0U;
+	*all = 0U;
+}
+
+static void results_add(struct zperf_results *sum,
+			const struct zperf_results *result)
+{
+	sum->nb_packets_sent += result->nb_packets_sent;
+	sum->nb_packets_rcvd += result->nb_packets_rcvd;
+	sum->nb_packets_lost += result->nb_packets_lost;
+	sum->nb_packets_outorder += result->nb_packets_outorder;
+	sum->nb_packets_errors += result->nb_packets_errors;
+	sum->total_len += result->total_len;
+
+	/* The streams run in parallel */
+	sum->time_in_us = MAX(sum->time_in_us, result->time_in_us);
+	sum->client_time_in_us = MAX(sum->client_time_in_us,
+				     result->client_time_in_us);
+	sum->jitter_in_us = MAX(sum->jitter_in_us, result->jitter_in_us);
+}
+
+#if CONFIG_NET_ZPERF_MAX_STREAMS > 1
+static void stream_thread(void *p1, void *p2, void *p3)
+{
+	int stream = POINTER_TO_INT(p1);
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	stream_ret[stream - 1] = stream_fn(stream_param, stream,
+					   &stream_results[stream - 1]);
+}
+
+static int run_parallel_streams(const struct zperf_upload_params *param,
+				zperf_stream_fn fn, int streams,
+				struct zperf_results *result)
+{
+	int prio = k_thread_priority_get(k_current_get());
+	int ret;
+
+	if (k_mutex_lock(&streams_lock, K_NO_WAIT) != 0) {
+		return -EBUSY;
+	}
+
+	stream_fn = fn;
+	stream_param = param;
+
+	for (int i = 1; i < streams; i++) {
+		memset(&stream_results[i - 1], 0, sizeof(stream_results[i - 1]));
+
+		k_thread_create(&stream_threads[i - 1], stream_stacks[i - 1],
+				K_THREAD_STACK_SIZEOF(stream_stacks[i - 1]),
+				stream_thread, INT_TO_POINTER(i), NULL, NULL,
+				prio, 0, K_NO_WAIT);
+		k_thread_name_set(&stream_threads[i - 1], "zperf_stream");
+	}
+
+	/* The caller runs the first stream */
+	ret = fn(param, 0, result);
+
+	for (int i = 1; i < streams; i++) {
+		k_thread_join(&stream_threads[i - 1], K_FOREVER);
+
+		results_add(result, &stream_results[i - 1]);
+
+		if (ret >= 0 && stream_ret[i - 1] < 0) {
+			ret = stream_ret[i - 1];
+		}
+	}
+
+	k_mutex_unlock(&streams_lock);
+
+	return ret;
+}
+#endif /* CONFIG_NET_ZPERF_MAX_STREAMS > 1 */
+
+int zperf_run_streams(const struct zperf_upload_params *param,
+		      zperf_stream_fn fn, struct zperf_results *result)
+{
+	int streams = MAX(param->options.streams, 1);
+	uint64_t busy, all, busy_end, all_end;
+	int ret;
+
+	if (streams > CONFIG_NET_ZPERF_MAX_STREAMS) {
+		NET_ERR("Too many streams, max %d",
+			CONFIG_NET_ZPERF_MAX_STREAMS);
+		return -EINVAL;
+	}
+
+	memset(result, 0, sizeof(*result));
+
+	cpu_cycles_get(&busy, &all);
+
+	if (streams == 1) {
+		ret = fn(param, 0, result);
+	} else {
+#if CONFIG_NET_ZPERF_MAX_STREAMS > 1
+		ret = run_parallel_streams(param, fn, streams, result);
+#else
+		ret = -ENOTSUP;
+#endif
+	}
+
+	cpu_cycles_get(&busy_end, &all_end);
+
+	if (all_end > all) {
+		result->cpu_load_permille =
+			(uint32_t)(((busy_end - busy) * 1000U) / (all_end - all));
+	}
+
+	return ret;
+}
+
 void zperf_async_work_submit(struct k_work *work)
 {
 	k_work_submit_to_queue(&zperf_work_q, work);
@@ -45,6 +45,13 @@
 
 #define ZPERF_VERSION "1.1"
 
+/* Client header flags, HEADER_VERSION1 and RUN_NOW in iperf2. A client
+ * setting both asks the server to start a stream back to the port of the
+ * header right away (dual test).
+ */
+#define ZPERF_FLAGS_VERSION1 0x80000000
+#define ZPERF_FLAGS_RUN_NOW 0x00000001
+
 struct zperf_udp_datagram {
 	int32_t id;
 	uint32_t tv_sec;
@@ -103,6 +110,22 @@ int zperf_prepare_upload_sock(const struct sockaddr *peer_addr, int tos,
 
 uint32_t zperf_packet_duration(uint32_t packet_size, uint32_t rate_in_kbps);
 
+void zperf_client_hdr_fill(struct zperf_client_hdr_v1 *hdr,
+			   const struct zperf_upload_params *param,
+			   bool dual);
+void zperf_dual_test_check(const struct sockaddr *peer,
+			   const struct zperf_client_hdr_v1 *hdr, int proto);
+
+/* Run one stream of an upload, the stream creates its own socket */
+typedef int (*zperf_stream_fn)(const struct zperf_upload_params *param,
+			       int stream, struct zperf_results *result);
+
+int zperf_run_streams(const struct zperf_upload_params *param,
+		      zperf_stream_fn fn, struct zperf_results *result);
+
+uint16_t zperf_udp_receiver_port(void);
+uint16_t zperf_tcp_receiver_port(void);
+
 void zperf_async_work_submit(struct k_work *work);
 void zperf_udp_uploader_init(void);
 void zperf_tcp_uploader_init(void);
@@ -423,6 +423,12 @@ static void shell_udp_upload_print_stats(const struct shell *sh,
 		shell_fprintf(sh, SHELL_NORMAL, "\t(");
 		print_number(sh, client_rate_in_kbps, KBPS, KBPS_UNIT);
 		shell_fprintf(sh, SHELL_NORMAL, ")\n");
+
+		if (IS_ENABLED(CONFIG_SCHED_THREAD_USAGE_ALL)) {
+			shell_fprintf(sh, SHELL_NORMAL, "CPU load:\t\t%u.%u %%\n",
+				      results->cpu_load_permille / 10U,
+				      results->cpu_load_permille % 10U);
+		}
 	}
 }
 
@@ -456,6 +462,48 @@ static void shell_tcp_upload_print_stats(const struct shell *sh,
 		shell_fprintf(sh, SHELL_NORMAL, "Rate:\t\t");
 		print_number(sh, client_rate_in_kbps, KBPS, KBPS_UNIT);
 		shell_fprintf(sh, SHELL_NORMAL, "\n");
+
+		if (IS_ENABLED(CONFIG_SCHED_THREAD_USAGE_ALL)) {
+			shell_fprintf(sh, SHELL_NORMAL, "CPU load:\t%u.%u %%\n",
+				      results->cpu_load_permille / 10U,
+				      results->cpu_load_permille % 10U);
+		}
+	}
+}
+
+static void shell_print_round_trip(const struct shell *sh, const char *name,
+				   uint32_t value_in_us)
+{
+	shell_fprintf(sh, SHELL_NORMAL, "%s", name);
+	print_number(sh, value_in_us, TIME_US, TIME_US_UNIT);
+	shell_fprintf(sh, SHELL_NORMAL, "\n");
+}
+
+static void shell_udp_latency_print_stats(const struct shell *sh,
+					  struct zperf_results *results)
+{
+	shell_fprintf(sh, SHELL_NORMAL, "-\nLatency test completed!\n");
+
+	shell_fprintf(sh, SHELL_NORMAL, "Num requests:\t\t%u\n",
+		      results->nb_packets_sent);
+	shell_fprintf(sh, SHELL_NORMAL, "Num replies:\t\t%u\n",
+		      results->nb_packets_rcvd);
+	shell_fprintf(sh, SHELL_NORMAL, "Num replies lost:\t%u\n",
+		      results->nb_packets_lost);
+	shell_fprintf(sh, SHELL_NORMAL, "Num replies late:\t%u\n",
+		      results->nb_packets_outorder);
+
+	shell_print_round_trip(sh, "Round trip min:\t\t", results->latency_min_us);
+	shell_print_round_trip(sh, "Round trip avg:\t\t", results->latency_avg_us);
+	shell_print_round_trip(sh, "Round trip p50:\t\t", results->latency_p50_us);
+	shell_print_round_trip(sh, "Round trip p99:\t\t", results->latency_p99_us);
+	shell_print_round_trip(sh, "Round trip p99.9:\t", results->latency_p999_us);
+	shell_print_round_trip(sh, "Round trip max:\t\t", results->latency_max_us);
+
+	if (IS_ENABLED(CONFIG_SCHED_THREAD_USAGE_ALL)) {
+		shell_fprintf(sh, SHELL_NORMAL, "CPU load:\t\t%u.%u %%\n",
+			      results->cpu_load_permille / 10U,
+			      results->cpu_load_permille % 10U);
 	}
 }
 
@@ -501,6 +549,66 @@ static void tcp_upload_cb(enum zperf_status status,
 	}
 }
 
+static void prepare_peer(const struct zperf_upload_params *param)
+{
+	if (IS_ENABLED(CONFIG_NET_IPV6) && param->peer_addr.sa_family == AF_INET6) {
+		struct sockaddr_in6 *ipv6 =
+				(struct sockaddr_in6 *)&param->peer_addr;
+		/* For IPv6, we should make sure that neighbor discovery
+		 * has been done for the peer. So send ping here, wait
+		 * some time and start the test after that.
+		 */
+		net_icmpv6_send_echo_request(net_if_get_default(),
+					     &ipv6->sin6_addr, 0, 0, 0, NULL, 0);
+
+		k_sleep(K_SECONDS(1));
+	}
+}
+
+static void tcp_session_cb(enum zperf_status status,
+			   struct zperf_results *result,
+			   void *user_data);
+
+/* The peer sends the dual test stream to the local download server, start
+ * it if needed.
+ */
+static int prepare_dual_test(const struct shell *sh,
+			     struct zperf_upload_params *param, bool is_udp)
+{
+	struct zperf_download_params download = { .port = DEF_PORT };
+	uint16_t port;
+	int ret;
+
+	port = is_udp ? zperf_udp_receiver_port() : zperf_tcp_receiver_port();
+	if (port == 0U) {
+		if (is_udp) {
+			ret = zperf_udp_download(&download, udp_session_cb,
+						 (void *)sh);
+		} else {
+			ret = zperf_tcp_download(&download, tcp_session_cb,
+						 (void *)sh);
+		}
+
+		if (ret < 0) {
+			shell_fprintf(sh, SHELL_ERROR,
+				      "Failed to start the dual test server (%d)\n",
+				      ret);
+			return ret;
+		}
+
+		k_yield();
+
+		port = download.port;
+	}
+
+	shell_fprintf(sh, SHELL_NORMAL, "Dual test, receiving on port %u\n",
+		      port);
+
+	param->options.dual_port = port;
+
+	return 0;
+}
+
 static int execute_upload(const struct shell *sh,
 			  const struct zperf_upload_params *param,
 			  bool is_udp, bool async)
@@ -516,21 +624,16 @@ static int execute_upload(const struct shell *sh,
 		      param->packet_size);
 	shell_fprintf(sh, SHELL_NORMAL, "Rate:\t\t%u kbps\n",
 		      param->rate_kbps);
-	shell_fprintf(sh, SHELL_NORMAL, "Starting...\n");
 
-	if (IS_ENABLED(CONFIG_NET_IPV6) && param->peer_addr.sa_family == AF_INET6) {
-		struct sockaddr_in6 *ipv6 =
-				(struct sockaddr_in6 *)&param->peer_addr;
-		/* For IPv6, we should make sure that neighbor discovery
-		 * has been done for the peer. So send ping here, wait
-		 * some time and start the test after that.
-		 */
-		net_icmpv6_send_echo_request(net_if_get_default(),
-					     &ipv6->sin6_addr, 0, 0, 0, NULL, 0);
-
-		k_sleep(K_SECONDS(1));
+	if (param->options.streams > 1) {
+		shell_fprintf(sh, SHELL_NORMAL, "Streams:\t%u\n",
+			      param->options.streams);
 	}
 
+	shell_fprintf(sh, SHELL_NORMAL, "Starting...\n");
+
+	prepare_peer(param);
+
 	if (is_udp && IS_ENABLED(CONFIG_NET_UDP)) {
 		uint32_t packet_duration =
 			zperf_packet_duration(param->packet_size, param->rate_kbps);
@@ -601,6 +704,42 @@ static int execute_upload(const struct shell *sh,
 	return 0;
 }
 
+static int execute_latency(const struct shell *sh,
+			   const struct zperf_upload_params *param)
+{
+	struct zperf_results results = { 0 };
+	int ret;
+
+	shell_fprintf(sh, SHELL_NORMAL, "Duration:\t");
+	print_number(sh, param->duration_ms * USEC_PER_MSEC, TIME_US,
+		     TIME_US_UNIT);
+	shell_fprintf(sh, SHELL_NORMAL, "\n");
+	shell_fprintf(sh, SHELL_NORMAL, "Packet size:\t%u bytes\n",
+		      param->packet_size);
+
+	if (param->rate_kbps != 0U) {
+		shell_fprintf(sh, SHELL_NORMAL, "Rate:\t\t%u kbps\n",
+			      param->rate_kbps);
+	} else {
+		shell_fprintf(sh, SHELL_NORMAL, "Rate:\t\tback to back\n");
+	}
+
+	shell_fprintf(sh, SHELL_NORMAL, "Starting...\n");
+
+	prepare_peer(param);
+
+	ret = zperf_udp_latency(param, &results);
+	if (ret < 0) {
+		shell_fprintf(sh, SHELL_ERROR,
+			      "UDP latency test failed (%d)\n", ret);
+		return ret;
+	}
+
+	shell_udp_latency_print_stats(sh, &results);
+
+	return 0;
+}
+
 static int parse_arg(size_t *i, size_t argc, char *argv[])
 {
 	int res = -1;
@@ -631,13 +770,15 @@ static int parse_arg(size_t *i, size_t argc, char *argv[])
 }
 
 static int shell_cmd_upload(const struct shell *sh, size_t argc,
-			     char *argv[], enum net_ip_protocol proto)
+			     char *argv[], enum net_ip_protocol proto,
+			     bool latency)
 {
 	struct zperf_upload_params param = { 0 };
 	struct sockaddr_in6 ipv6 = { .sin6_family = AF_INET6 };
 	struct sockaddr_in ipv4 = { .sin_family = AF_INET };
 	char *port_str;
 	bool async = false;
+	bool dual = false;
 	bool is_udp;
 	int start = 0;
 	size_t opt_cnt = 0;
@@ -680,6 +821,27 @@ static int shell_cmd_upload(const struct shell *sh, size_t argc,
 			opt_cnt += 1;
 			break;
 
+		case 'P': {
+			int streams = parse_arg(&i, argc, argv);
+
+			if (streams < 1 ||
+			    streams > CONFIG_NET_ZPERF_MAX_STREAMS) {
+				shell_fprintf(sh, SHELL_WARNING,
+					      "Number of streams must be 1 - %d\n",
+					      CONFIG_NET_ZPERF_MAX_STREAMS);
+				return -ENOEXEC;
+			}
+
+			param.options.streams = streams;
+			opt_cnt += 2;
+			break;
+		}
+
+		case 'd':
+			dual = true;
+			opt_cnt += 1;
+			break;
+
 		default:
 			shell_fprintf(sh, SHELL_WARNING,
 				      "Unrecognized argument: %s\n", argv[i]);
@@ -687,6 +849,12 @@ static int shell_cmd_upload(const struct shell *sh, size_t argc,
 		}
 	}
 
+	if (latency && (async || dual || param.options.streams > 1)) {
+		shell_fprintf(sh, SHELL_WARNING,
+			      "Latency test supports only the -S option\n");
+		return -ENOEXEC;
+	}
+
 	start += opt_cnt;
 	argc -= opt_cnt;
 
@@ -792,17 +960,30 @@ static int shell_cmd_upload(const struct shell *sh, size_t argc,
 		param.rate_kbps = 10U;
 	}
 
+	if (latency) {
+		return execute_latency(sh, &param);
+	}
+
+	if (dual && prepare_dual_test(sh, &param, is_udp) < 0) {
+		return -ENOEXEC;
+	}
+
 	return execute_upload(sh, &param, is_udp, async);
 }
 
 static int cmd_tcp_upload(const struct shell *sh, size_t argc, char *argv[])
 {
-	return shell_cmd_upload(sh, argc, argv, IPPROTO_TCP);
+	return shell_cmd_upload(sh, argc, argv, IPPROTO_TCP, false);
 }
 
 static int cmd_udp_upload(const struct shell *sh, size_t argc, char *argv[])
 {
-	return shell_cmd_upload(sh, argc, argv, IPPROTO_UDP);
+	return shell_cmd_upload(sh, argc, argv, IPPROTO_UDP, false);
+}
+
+static int cmd_udp_latency(const struct shell *sh, size_t argc, char *argv[])
+{
+	return shell_cmd_upload(sh, argc, argv, IPPROTO_UDP, true);
 }
 
 static int shell_cmd_upload2(const struct shell *sh, size_t argc,
@@ -812,6 +993,7 @@ static int shell_cmd_upload2(const struct shell *sh, size_t argc,
 	sa_family_t family;
 	uint8_t is_udp;
 	bool async = false;
+	bool dual = false;
 	int start = 0;
 	size_t opt_cnt = 0;
 
@@ -853,6 +1035,27 @@ static int shell_cmd_upload2(const struct shell *sh, size_t argc,
 			opt_cnt += 1;
 			break;
 
+		case 'P': {
+			int streams = parse_arg(&i, argc, argv);
+
+			if (streams < 1 ||
+			    streams > CONFIG_NET_ZPERF_MAX_STREAMS) {
+				shell_fprintf(sh, SHELL_WARNING,
+					      "Number of streams must be 1 - %d\n",
+					      CONFIG_NET_ZPERF_MAX_STREAMS);
+				return -ENOEXEC;
+			}
+
+			param.options.streams = streams;
+			opt_cnt += 2;
+			break;
+		}
+
+		case 'd':
+			dual = true;
+			opt_cnt += 1;
+			break;
+
 		default:
 			shell_fprintf(sh, SHELL_WARNING,
 				      "Unrecognized argument: %s\n", argv[i]);
@@ -930,6 +1133,10 @@ static int shell_cmd_upload2(const struct shell *sh, size_t argc,
 		param.rate_kbps = 10U;
 	}
 
+	if (dual && prepare_dual_test(sh, &param, is_udp) < 0) {
+		return -ENOEXEC;
+	}
+
 	return execute_upload(sh, &param, is_udp, async);
 }
 
@@ -1136,7 +1343,7 @@ SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_tcp_download,
 SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_tcp,
 	SHELL_CMD(upload, NULL,
 		  "[<options>] <dest ip> <dest port> <duration> <packet size>[K]\n"
-		  "<options>     command options (optional): [-S tos -a]\n"
+		  "<options>     command options (optional): [-S tos -a -P streams -d]\n"
 		  "<dest ip>     IP destination\n"
 		  "<dest port>   port destination\n"
 		  "<duration>    of the test in seconds\n"
@@ -1145,13 +1352,15 @@ SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_tcp,
 		  "Available options:\n"
 		  "-S tos: Specify IPv4/6 type of service\n"
 		  "-a: Asynchronous call (shell will not block for the upload)\n"
+		  "-P streams: Number of parallel streams\n"
+		  "-d: Dual test, the server sends a stream back at the same time\n"
 		  "-n: Disable Nagle's algorithm\n"
 		  "Example: tcp upload 192.0.2.2 1111 1 1K\n"
 		  "Example: tcp upload 2001:db8::2\n",
 		  cmd_tcp_upload),
 	SHELL_CMD(upload2, NULL,
 		  "[<options>] v6|v4 <duration> <packet size>[K] <baud rate>[K|M]\n"
-		  "<options>     command options (optional): [-S tos -a]\n"
+		  "<options>     command options (optional): [-S tos -a -P streams -d]\n"
 		  "<v6|v4>:      Use either IPv6 or IPv4\n"
 		  "<duration>    Duration of the test in seconds\n"
 		  "<packet size> Size of the packet in byte or kilobyte "
@@ -1159,6 +1368,8 @@ SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_tcp,
 		  "Available options:\n"
 		  "-S tos: Specify IPv4/6 type of service\n"
 		  "-a: Asynchronous call (shell will not block for the upload)\n"
+		  "-P streams: Number of parallel streams\n"
+		  "-d: Dual test, the server sends a stream back at the same time\n"
 		  "Example: tcp upload2 v6 1 1K\n"
 		  "Example: tcp upload2 v4\n"
 		  "-n: Disable Nagle's algorithm\n"
@@ -1188,7 +1399,7 @@ SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_udp,
 	SHELL_CMD(upload, NULL,
 		  "[<options>] <dest ip> [<dest port> <duration> <packet size>[K] "
 							"<baud rate>[K|M]]\n"
-		  "<options>     command options (optional): [-S tos -a]\n"
+		  "<options>     command options (optional): [-S tos -a -P streams -d]\n"
 		  "<dest ip>     IP destination\n"
 		  "<dest port>   port destination\n"
 		  "<duration>    of the test in seconds\n"
@@ -1198,12 +1409,14 @@ SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_udp,
 		  "Available options:\n"
 		  "-S tos: Specify IPv4/6 type of service\n"
 		  "-a: Asynchronous call (shell will not block for the upload)\n"
+		  "-P streams: Number of parallel streams\n"
+		  "-d: Dual test, the server sends a stream back at the same time\n"
 		  "Example: udp upload 192.0.2.2 1111 1 1K 1M\n"
 		  "Example: udp upload 2001:db8::2\n",
 		  cmd_udp_upload),
 	SHELL_CMD(upload2, NULL,
 		  "[<options>] v6|v4 [<duration> <packet size>[K] <baud rate>[K|M]]\n"
-		  "<options>     command options (optional): [-S tos -a]\n"
+		  "<options>     command options (optional): [-S tos -a -P streams -d]\n"
 		  "<v6|v4>:      Use either IPv6 or IPv4\n"
 		  "<duration>    Duration of the test in seconds\n"
 		  "<packet size> Size of the packet in byte or kilobyte "
@@ -1212,6 +1425,8 @@ SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_udp,
 		  "Available options:\n"
 		  "-S tos: Specify IPv4/6 type of service\n"
 		  "-a: Asynchronous call (shell will not block for the upload)\n"
+		  "-P streams: Number of parallel streams\n"
+		  "-d: Dual test, the server sends a stream back at the same time\n"
 		  "Example: udp upload2 v4 1 1K 1M\n"
 		  "Example: udp upload2 v6\n"
 #if defined(CONFIG_NET_IPV6) && defined(MY_IP6ADDR_SET)
@@ -1224,6 +1439,21 @@ SHELL_STATIC_SUBCMD_SET_CREATE(zperf_cmd_udp,
 #endif
 		  ,
 		  cmd_udp_upload2),
+	SHELL_CMD(latency, NULL,
+		  "[<options>] <dest ip> [<dest port> <duration> <packet size>[K] "
+							"<rate>[K|M]]\n"
+		  "<options>     command options (optional): [-S tos]\n"
+		  "<dest ip>     IP of a UDP echo server\n"
+		  "<dest port>   port destination\n"
+		  "<duration>    of the test in seconds\n"
+		  "<packet size> Size of the packet in byte or kilobyte "
+							"(with suffix K)\n"
+		  "<rate>        Request rate in kilobyte or megabyte, 0 to send "
+							"back to back\n"
+		  "Available options:\n"
+		  "-S tos: Specify IPv4/6 type of service\n"
+		  "Example: udp latency 192.0.2.2 4242 10 64 0\n",
+		  cmd_udp_latency),
 	SHELL_CMD(download, &zperf_cmd_udp_download,
 		  "[<port>]\n"
 		  "Example: udp download 5001\n",
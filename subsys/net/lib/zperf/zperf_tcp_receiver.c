@@ -48,7 +48,8 @@ static bool tcp_server_stop;
 static uint16_t tcp_server_port;
 static K_SEM_DEFINE(tcp_server_run, 0, 1);
 
-static void tcp_received(const struct sockaddr *addr, size_t datalen)
+static void tcp_received(const struct sockaddr *addr, const uint8_t *data,
+			 size_t datalen)
 {
 	struct session *session;
 	int64_t time;
@@ -73,6 +74,12 @@ static void tcp_received(const struct sockaddr *addr, size_t datalen)
 				       tcp_user_data);
 		}
 
+		if (datalen >= sizeof(struct zperf_client_hdr_v1)) {
+			zperf_dual_test_check(addr,
+				(const struct zperf_client_hdr_v1 *)data,
+				IPPROTO_TCP);
+		}
+
 		__fallthrough;
 	case STATE_ONGOING:
 		session->counter++;
@@ -317,7 +324,7 @@ use_existing_ipv6:
 					ret = 0;
 				}
 
-				tcp_received(&sock_addr[i], ret);
+				tcp_received(&sock_addr[i], buf, ret);
 
 				if (ret == 0) {
 					zsock_close(fds[i].fd);
@@ -393,6 +400,11 @@ int zperf_tcp_download(const struct zperf_download_params *param,
 	return 0;
 }
 
+uint16_t zperf_tcp_receiver_port(void)
+{
+	return tcp_server_running ? tcp_server_port : 0U;
+}
+
 int zperf_tcp_download_stop(void)
 {
 	if (!tcp_server_running) {
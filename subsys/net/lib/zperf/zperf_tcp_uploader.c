@@ -16,15 +16,17 @@ LOG_MODULE_DECLARE(net_zperf, CONFIG_NET_ZPERF_LOG_LEVEL);
 
 #include "zperf_internal.h"
 
+/* Shared by the streams, only read while uploading */
 static char sample_packet[PACKET_SIZE_MAX];
 
 static struct zperf_async_upload_context tcp_async_upload_ctx;
 
-static int tcp_upload(int sock,
-		      unsigned int duration_in_ms,
-		      unsigned int packet_size,
+static int tcp_upload(int sock, int stream,
+		      const struct zperf_upload_params *param,
 		      struct zperf_results *results)
 {
+	unsigned int duration_in_ms = param->duration_ms;
+	unsigned int packet_size = param->packet_size;
 	int64_t duration = sys_clock_timeout_end_calc(K_MSEC(duration_in_ms));
 	int64_t start_time, last_print_time, end_time, remaining;
 	uint32_t nb_packets = 0U, nb_errors = 0U;
@@ -37,18 +39,26 @@ static int tcp_upload(int sock,
 		packet_size = PACKET_SIZE_MAX;
 	}
 
+	/* The first stream carries the dual test request, ahead of the
+	 * data.
+	 */
+	if (stream == 0 && param->options.dual_port != 0U) {
+		struct zperf_client_hdr_v1 hdr;
+
+		zperf_client_hdr_fill(&hdr, param, true);
+
+		ret = zsock_send(sock, &hdr, sizeof(hdr), 0);
+		if (ret < 0) {
+			NET_ERR("Failed to send the dual test request (%d)",
+				errno);
+			return -errno;
+		}
+	}
+
 	/* Start the loop */
 	start_time = k_uptime_ticks();
 	last_print_time = start_time;
 
-	(void)memset(sample_packet, 'z', sizeof(sample_packet));
-
-	/* Set the "flags" field in start of the packet to be 0.
-	 * As the protocol is not properly described anywhere, it is
-	 * not certain if this is a proper thing to do.
-	 */
-	(void)memset(sample_packet, 0, sizeof(uint32_t));
-
 	do {
 		/* Send the packet */
 		ret = zsock_send(sock, sample_packet, packet_size, 0);
@@ -76,6 +86,11 @@ static int tcp_upload(int sock,
 
 #if defined(CONFIG_ARCH_POSIX)
 		k_busy_wait(100 * USEC_PER_MSEC);
+
+		/* The busy wait does not reschedule, let the other streams
+		 * run.
+		 */
+		k_yield();
 #else
 		k_yield();
 #endif
@@ -108,16 +123,12 @@ static int tcp_upload(int sock,
 	return 0;
 }
 
-int zperf_tcp_upload(const struct zperf_upload_params *param,
-		     struct zperf_results *result)
+static int tcp_upload_stream(const struct zperf_upload_params *param,
+			     int stream, struct zperf_results *result)
 {
 	int sock;
 	int ret;
 
-	if (param == NULL || result == NULL) {
-		return -EINVAL;
-	}
-
 	sock = zperf_prepare_upload_sock(&param->peer_addr, param->options.tos,
 					 IPPROTO_TCP);
 	if (sock < 0) {
@@ -129,16 +140,35 @@ int zperf_tcp_upload(const struct zperf_upload_params *param,
 			     &param->options.tcp_nodelay,
 			     sizeof(param->options.tcp_nodelay)) != 0) {
 		NET_WARN("Failed to set IPPROTO_TCP - TCP_NODELAY socket option.");
+		zsock_close(sock);
 		return -EINVAL;
 	}
 
-	ret = tcp_upload(sock, param->duration_ms, param->packet_size, result);
+	ret = tcp_upload(sock, stream, param, result);
 
 	zsock_close(sock);
 
 	return ret;
 }
 
+int zperf_tcp_upload(const struct zperf_upload_params *param,
+		     struct zperf_results *result)
+{
+	if (param == NULL || result == NULL) {
+		return -EINVAL;
+	}
+
+	(void)memset(sample_packet, 'z', sizeof(sample_packet));
+
+	/* Set the "flags" field in start of the packet to be 0.
+	 * As the protocol is not properly described anywhere, it is
+	 * not certain if this is a proper thing to do.
+	 */
+	(void)memset(sample_packet, 0, sizeof(uint32_t));
+
+	return zperf_run_streams(param, tcp_upload_stream, result);
+}
+
 static void tcp_upload_async_work(struct k_work *work)
 {
 	struct zperf_async_upload_context *upload_ctx =
@@ -0,0 +1,257 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_zperf, CONFIG_NET_ZPERF_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/net/socket.h>
+#include <zephyr/net/zperf.h>
+
+#include "zperf_internal.h"
+
+/* Time to wait for the echo of a request */
+#define LATENCY_TIMEOUT_MS 1000
+
+/* Round trip time histogram: 1 us buckets up to 16 us, then 8 buckets per
+ * power of two, so a bucket is at most 1/8 of its values wide. Round trips
+ * above 2^24 us go to the last bucket.
+ */
+#define HIST_LINEAR_BITS 4
+#define HIST_LINEAR BIT(HIST_LINEAR_BITS)
+#define HIST_SUB_BITS 3
+#define HIST_SUB BIT(HIST_SUB_BITS)
+#define HIST_MAX_BITS 24
+#define HIST_BUCKETS (HIST_LINEAR + (HIST_MAX_BITS - HIST_LINEAR_BITS) * HIST_SUB)
+
+static uint8_t latency_packet[PACKET_SIZE_MAX];
+static uint32_t latency_hist[HIST_BUCKETS];
+
+/* Protects the packet and the histogram */
+static K_MUTEX_DEFINE(latency_lock);
+
+static uint32_t hist_index(uint32_t us)
+{
+	uint32_t msb;
+
+	if (us < HIST_LINEAR) {
+		return us;
+	}
+
+	msb = 31U - __builtin_clz(us);
+	if (msb >= HIST_MAX_BITS) {
+		return HIST_BUCKETS - 1;
+	}
+
+	return HIST_LINEAR + (msb - HIST_LINEAR_BITS) * HIST_SUB +
+	       ((us >> (msb - HIST_SUB_BITS)) & (HIST_SUB - 1));
+}
+
+/* Highest value of a bucket */
+static uint32_t hist_value(uint32_t index)
+{
+	uint32_t msb, sub;
+
+	if (index < HIST_LINEAR) {
+		return index;
+	}
+
+	index -= HIST_LINEAR;
+	msb = HIST_LINEAR_BITS + index / HIST_SUB;
+	sub = index % HIST_SUB;
+
+	return ((HIST_SUB + sub + 1U) << (msb - HIST_SUB_BITS)) - 1U;
+}
+
+/* Percentile in 1/10000, bounded by the largest measured value */
+static uint32_t hist_percentile(uint32_t count, uint32_t per_10000,
+				uint32_t max)
+{
+	uint32_t rank = DIV_ROUND_UP((uint64_t)count * per_10000, 10000U);
+	uint32_t sum = 0U;
+
+	for (int i = 0; i < HIST_BUCKETS; i++) {
+		sum += latency_hist[i];
+
+		if (sum >= rank) {
+			return MIN(hist_value(i), max);
+		}
+	}
+
+	return max;
+}
+
+static int udp_latency(int sock, const struct zperf_upload_params *param,
+		       struct zperf_results *results)
+{
+	struct zperf_udp_datagram *datagram =
+		(struct zperf_udp_datagram *)latency_packet;
+	struct zperf_udp_datagram reply;
+	unsigned int packet_size = param->packet_size;
+	uint32_t interval = 0U;
+	uint32_t min = UINT32_MAX, max = 0U;
+	uint64_t sum = 0U;
+	uint32_t id = 0U;
+	int64_t duration, start_time, end_time;
+	struct timeval rcvtimeo = {
+		.tv_sec = LATENCY_TIMEOUT_MS / MSEC_PER_SEC,
+		.tv_usec = (LATENCY_TIMEOUT_MS % MSEC_PER_SEC) * USEC_PER_MSEC,
+	};
+	int ret;
+
+	if (packet_size > PACKET_SIZE_MAX) {
+		NET_WARN("Packet size too large! max size: %u",
+			 PACKET_SIZE_MAX);
+		packet_size = PACKET_SIZE_MAX;
+	} else if (packet_size < sizeof(struct zperf_udp_datagram)) {
+		NET_WARN("Packet size set to the min size: %zu",
+			 sizeof(struct zperf_udp_datagram));
+		packet_size = sizeof(struct zperf_udp_datagram);
+	}
+
+	if (param->rate_kbps != 0U) {
+		interval = zperf_packet_duration(packet_size, param->rate_kbps);
+	}
+
+	ret = zsock_setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &rcvtimeo,
+			       sizeof(rcvtimeo));
+	if (ret < 0) {
+		NET_ERR("setsockopt error (%d)", errno);
+		return -errno;
+	}
+
+	(void)memset(latency_packet, 'z', sizeof(latency_packet));
+	(void)memset(latency_hist, 0, sizeof(latency_hist));
+
+	duration = sys_clock_timeout_end_calc(K_MSEC(param->duration_ms));
+	start_time = k_uptime_ticks();
+
+	do {
+		int64_t loop_time = k_uptime_ticks();
+		uint32_t secs = k_ticks_to_ms_ceil32(loop_time) / 1000U;
+		uint32_t sent, rtt;
+
+		datagram->id = htonl(id);
+		datagram->tv_sec = htonl(secs);
+		datagram->tv_usec = htonl(k_ticks_to_us_ceil32(loop_time) -
+					  secs * USEC_PER_SEC);
+
+		sent = k_cycle_get_32();
+
+		ret = zsock_send(sock, latency_packet, packet_size, 0);
+		if (ret < 0) {
+			NET_ERR("Failed to send the packet (%d)", errno);
+			return -errno;
+		}
+
+		results->nb_packets_sent++;
+
+		/* Wait for the echo, the late echoes of previous requests
+		 * are dropped.
+		 */
+		while (true) {
+			ret = zsock_recv(sock, &reply, sizeof(reply), 0);
+			if (ret < 0 || (ret == sizeof(reply) &&
+					ntohl(reply.id) == id)) {
+				break;
+			}
+
+			results->nb_packets_outorder++;
+		}
+
+		rtt = k_cyc_to_us_floor32(k_cycle_get_32() - sent);
+
+		if (ret < 0) {
+			if (errno != EAGAIN) {
+				NET_ERR("Failed to receive packet (%d)", errno);
+				return -errno;
+			}
+
+			results->nb_packets_lost++;
+		} else {
+			results->nb_packets_rcvd++;
+			latency_hist[hist_index(rtt)]++;
+			sum += rtt;
+			min = MIN(min, rtt);
+			max = MAX(max, rtt);
+		}
+
+		id++;
+
+		if (rtt < interval) {
+			k_sleep(K_USEC(interval - rtt));
+		} else if (IS_ENABLED(CONFIG_ARCH_POSIX)) {
+			/* The time does not advance while the CPU is busy */
+			k_busy_wait(USEC_PER_MSEC);
+		}
+	} while (duration - k_uptime_ticks() > 0);
+
+	end_time = k_uptime_ticks();
+
+	results->client_time_in_us = k_ticks_to_us_ceil32(end_time - start_time);
+	results->packet_size = packet_size;
+	results->total_len = results->nb_packets_rcvd * packet_size;
+
+	if (results->nb_packets_rcvd == 0U) {
+		return 0;
+	}
+
+	results->latency_min_us = min;
+	results->latency_max_us = max;
+	results->latency_avg_us = sum / results->nb_packets_rcvd;
+	results->latency_p50_us =
+		hist_percentile(results->nb_packets_rcvd, 5000U, max);
+	results->latency_p99_us =
+		hist_percentile(results->nb_packets_rcvd, 9900U, max);
+	results->latency_p999_us =
+		hist_percentile(results->nb_packets_rcvd, 9990U, max);
+
+	return 0;
+}
+
+static int udp_latency_stream(const struct zperf_upload_params *param,
+			      int stream, struct zperf_results *result)
+{
+	int sock;
+	int ret;
+
+	ARG_UNUSED(stream);
+
+	sock = zperf_prepare_upload_sock(&param->peer_addr, param->options.tos,
+					 IPPROTO_UDP);
+	if (sock < 0) {
+		return sock;
+	}
+
+	ret = udp_latency(sock, param, result);
+
+	zsock_close(sock);
+
+	return ret;
+}
+
+int zperf_udp_latency(const struct zperf_upload_params *param,
+		      struct zperf_results *result)
+{
+	int ret;
+
+	if (param == NULL || result == NULL) {
+		return -EINVAL;
+	}
+
+	if (param->options.streams > 1 || param->options.dual_port != 0U) {
+		return -EINVAL;
+	}
+
+	if (k_mutex_lock(&latency_lock, K_NO_WAIT) != 0) {
+		return -EBUSY;
+	}
+
+	ret = zperf_run_streams(param, udp_latency_stream, result);
+
+	k_mutex_unlock(&latency_lock);
+
+	return ret;
+}
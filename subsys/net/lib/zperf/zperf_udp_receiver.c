@@ -38,6 +38,7 @@ static struct sockaddr_in *in4_addr_my;
 #define SOCK_ID_MAX 2
 
 #define UDP_RECEIVER_BUF_SIZE 1500
+#define UDP_BATCH CONFIG_NET_ZPERF_UDP_BATCH
 #define POLL_TIMEOUT_MS 100
 
 static K_THREAD_STACK_DEFINE(udp_receiver_stack_area, UDP_RECEIVER_STACK_SIZE);
@@ -144,6 +145,13 @@ static void udp_received(int sock, const struct sockaddr *addr, uint8_t *data,
 				udp_session_cb(ZPERF_SESSION_STARTED, NULL,
 					       udp_user_data);
 			}
+
+			if (datalen >= sizeof(*hdr) +
+				       sizeof(struct zperf_client_hdr_v1)) {
+				zperf_dual_test_check(addr,
+					(struct zperf_client_hdr_v1 *)(data + sizeof(*hdr)),
+					IPPROTO_UDP);
+			}
 		}
 		break;
 	case STATE_ONGOING:
@@ -229,9 +237,59 @@ static void udp_received(int sock, const struct sockaddr *addr, uint8_t *data,
 	}
 }
 
-static void udp_server_session(void)
+#if UDP_BATCH > 1
+/* Receive the queued datagrams, up to a batch, with one call */
+static int udp_receive(int sock)
+{
+	static uint8_t bufs[UDP_BATCH][UDP_RECEIVER_BUF_SIZE];
+	static struct sockaddr addrs[UDP_BATCH];
+	static struct iovec iov[UDP_BATCH];
+	static struct mmsghdr msgs[UDP_BATCH];
+	int ret;
+
+	for (int i = 0; i < UDP_BATCH; i++) {
+		iov[i].iov_base = bufs[i];
+		iov[i].iov_len = sizeof(bufs[i]);
+
+		memset(&msgs[i].msg_hdr, 0, sizeof(msgs[i].msg_hdr));
+		msgs[i].msg_hdr.msg_name = &addrs[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+		msgs[i].msg_hdr.msg_iov = &iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	ret = zsock_recvmmsg(sock, msgs, UDP_BATCH, ZSOCK_MSG_DONTWAIT);
+	if (ret < 0) {
+		return ret;
+	}
+
+	for (int i = 0; i < ret; i++) {
+		udp_received(sock, &addrs[i], bufs[i], msgs[i].msg_len);
+	}
+
+	return ret;
+}
+#else
+static int udp_receive(int sock)
 {
 	static uint8_t buf[UDP_RECEIVER_BUF_SIZE];
+	struct sockaddr addr;
+	socklen_t addrlen = sizeof(addr);
+	int ret;
+
+	ret = zsock_recvfrom(sock, buf, sizeof(buf), 0, &addr, &addrlen);
+	if (ret < 0) {
+		return ret;
+	}
+
+	udp_received(sock, &addr, buf, ret);
+
+	return 1;
+}
+#endif /* UDP_BATCH > 1 */
+
+static void udp_server_session(void)
+{
 	struct zsock_pollfd fds[SOCK_ID_MAX] = { 0 };
 	int ret;
 
@@ -358,9 +416,6 @@ static void udp_server_session(void)
 		}
 
 		for (int i = 0; i < ARRAY_SIZE(fds); i++) {
-			struct sockaddr addr;
-			socklen_t addrlen = sizeof(addr);
-
 			if ((fds[i].revents & ZSOCK_POLLERR) ||
 			    (fds[i].revents & ZSOCK_POLLNVAL)) {
 				NET_ERR("UDP receiver IPv%d socket error",
@@ -372,15 +427,12 @@ static void udp_server_session(void)
 				continue;
 			}
 
-			ret = zsock_recvfrom(fds[i].fd, buf, sizeof(buf), 0,
-					     &addr, &addrlen);
+			ret = udp_receive(fds[i].fd);
 			if (ret < 0) {
 				NET_ERR("recv failed on IPv%d socket (%d)",
 					(i == SOCK_ID_IPV4) ? 4 : 6, errno);
 				goto error;
 			}
-
-			udp_received(fds[i].fd, &addr, buf, ret);
 		}
 	}
 
@@ -447,6 +499,11 @@ int zperf_udp_download(const struct zperf_download_params *param,
 	return 0;
 }
 
+uint16_t zperf_udp_receiver_port(void)
+{
+	return udp_server_running ? udp_server_port : 0U;
+}
+
 int zperf_udp_download_stop(void)
 {
 	if (!udp_server_running) {
@@ -14,12 +14,18 @@ LOG_MODULE_DECLARE(net_zperf, CONFIG_NET_ZPERF_LOG_LEVEL);
 
 #include "zperf_internal.h"
 
-static uint8_t sample_packet[sizeof(struct zperf_udp_datagram) +
+/* One packet per stream, as the header is written for each datagram */
+static uint8_t sample_packet[CONFIG_NET_ZPERF_MAX_STREAMS]
+			    [sizeof(struct zperf_udp_datagram) +
 			     sizeof(struct zperf_client_hdr_v1) +
 			     PACKET_SIZE_MAX];
 
 static struct zperf_async_upload_context udp_async_upload_ctx;
 
+#define UDP_BATCH CONFIG_NET_ZPERF_UDP_BATCH
+#define UDP_HDR_SIZE (sizeof(struct zperf_udp_datagram) + \
+		      sizeof(struct zperf_client_hdr_v1))
+
 static inline void zperf_upload_decode_stat(const uint8_t *data,
 					    size_t datalen,
 					    struct zperf_results *results)
@@ -45,7 +51,7 @@ static inline void zperf_upload_decode_stat(const uint8_t *data,
 		ntohl(UNALIGNED_GET(&stat->jitter1)) * USEC_PER_SEC;
 }
 
-static inline int zperf_upload_fin(int sock,
+static inline int zperf_upload_fin(int sock, uint8_t *packet,
 				   uint32_t nb_packets,
 				   uint64_t end_time,
 				   uint32_t packet_size,
@@ -65,14 +71,14 @@ static inline int zperf_upload_fin(int sock,
 	};
 
 	while (ret <= 0 && loop-- > 0) {
-		datagram = (struct zperf_udp_datagram *)sample_packet;
+		datagram = (struct zperf_udp_datagram *)packet;
 
 		/* Fill the packet header */
 		datagram->id = htonl(-nb_packets);
 		datagram->tv_sec = htonl(secs);
 		datagram->tv_usec = htonl(usecs);
 
-		hdr = (struct zperf_client_hdr_v1 *)(sample_packet +
+		hdr = (struct zperf_client_hdr_v1 *)(packet +
 						     sizeof(*datagram));
 
 		/* According to iperf documentation (in include/Settings.hpp),
@@ -83,13 +89,13 @@ static inline int zperf_upload_fin(int sock,
 		hdr->flags = 0;
 		hdr->num_of_threads = htonl(1);
 		hdr->port = 0;
-		hdr->buffer_len = sizeof(sample_packet) -
+		hdr->buffer_len = sizeof(sample_packet[0]) -
 			sizeof(*datagram) - sizeof(*hdr);
 		hdr->bandwidth = 0;
 		hdr->num_of_bytes = htonl(packet_size);
 
 		/* Send the packet */
-		ret = zsock_send(sock, sample_packet, packet_size, 0);
+		ret = zsock_send(sock, packet, packet_size, 0);
 		if (ret < 0) {
 			NET_ERR("Failed to send the packet (%d)", errno);
 			continue;
@@ -131,13 +137,64 @@ static inline int zperf_upload_fin(int sock,
 	return 0;
 }
 
-static int udp_upload(int sock, int port,
-		      unsigned int duration_in_ms,
-		      unsigned int packet_size,
-		      unsigned int rate_in_kbps,
+static void udp_fill_header(uint8_t *buf, uint32_t id, uint32_t secs,
+			    uint32_t usecs,
+			    const struct zperf_client_hdr_v1 *client_hdr)
+{
+	struct zperf_udp_datagram *datagram;
+
+	datagram = (struct zperf_udp_datagram *)buf;
+
+	datagram->id = htonl(id);
+	datagram->tv_sec = htonl(secs);
+	datagram->tv_usec = htonl(usecs);
+
+	memcpy(buf + sizeof(*datagram), client_hdr, sizeof(*client_hdr));
+}
+
+#if UDP_BATCH > 1
+/* Send a batch of datagrams with one call. Only the headers differ
+ * between the datagrams, so the payload is shared through the iovec.
+ */
+static int udp_send_batch(int sock, int stream, uint32_t id, uint32_t secs,
+			  uint32_t usecs, unsigned int packet_size,
+			  const struct zperf_client_hdr_v1 *client_hdr)
+{
+	static uint8_t headers[CONFIG_NET_ZPERF_MAX_STREAMS][UDP_BATCH][UDP_HDR_SIZE];
+	static struct iovec iov[CONFIG_NET_ZPERF_MAX_STREAMS][UDP_BATCH][2];
+	static struct mmsghdr msgs[CONFIG_NET_ZPERF_MAX_STREAMS][UDP_BATCH];
+	struct mmsghdr *msg = msgs[stream];
+	size_t hdr_len = MIN(packet_size, UDP_HDR_SIZE);
+
+	for (int i = 0; i < UDP_BATCH; i++) {
+		udp_fill_header(headers[stream][i], id + i, secs, usecs,
+				client_hdr);
+
+		iov[stream][i][0].iov_base = headers[stream][i];
+		iov[stream][i][0].iov_len = hdr_len;
+		iov[stream][i][1].iov_base = sample_packet[stream] + hdr_len;
+		iov[stream][i][1].iov_len = packet_size - hdr_len;
+
+		memset(&msg[i].msg_hdr, 0, sizeof(msg[i].msg_hdr));
+		msg[i].msg_hdr.msg_iov = iov[stream][i];
+		msg[i].msg_hdr.msg_iovlen = packet_size > hdr_len ? 2 : 1;
+	}
+
+	return zsock_sendmmsg(sock, msg, UDP_BATCH, 0);
+}
+#endif /* UDP_BATCH > 1 */
+
+static int udp_upload(int sock, int stream,
+		      const struct zperf_upload_params *param,
 		      struct zperf_results *results)
 {
-	uint32_t packet_duration = zperf_packet_duration(packet_size, rate_in_kbps);
+	uint8_t *packet = sample_packet[stream];
+	unsigned int duration_in_ms = param->duration_ms;
+	unsigned int packet_size = param->packet_size;
+	unsigned int rate_in_kbps = param->rate_kbps;
+	struct zperf_client_hdr_v1 client_hdr;
+	uint32_t packet_duration =
+		zperf_packet_duration(packet_size, rate_in_kbps) * UDP_BATCH;
 	uint64_t duration = sys_clock_timeout_end_calc(K_MSEC(duration_in_ms));
 	uint64_t delay = packet_duration;
 	uint32_t nb_packets = 0U;
@@ -156,16 +213,18 @@ static int udp_upload(int sock, int port,
 		packet_size = sizeof(struct zperf_udp_datagram);
 	}
 
+	/* The first stream carries the dual test request */
+	zperf_client_hdr_fill(&client_hdr, param,
+			      stream == 0 && param->options.dual_port != 0U);
+
 	/* Start the loop */
 	start_time = k_uptime_ticks();
 	last_print_time = start_time;
 	last_loop_time = start_time;
 
-	(void)memset(sample_packet, 'z', sizeof(sample_packet));
+	(void)memset(packet, 'z', sizeof(sample_packet[0]));
 
 	do {
-		struct zperf_udp_datagram *datagram;
-		struct zperf_client_hdr_v1 *hdr;
 		uint32_t secs, usecs;
 		int64_t loop_time;
 		int32_t adjust;
@@ -197,31 +256,28 @@ static int udp_upload(int sock, int port,
 		secs = k_ticks_to_ms_ceil32(loop_time) / 1000U;
 		usecs = k_ticks_to_us_ceil32(loop_time) - secs * USEC_PER_SEC;
 
+#if UDP_BATCH > 1
+		ret = udp_send_batch(sock, stream, nb_packets, secs, usecs,
+				     packet_size, &client_hdr);
+		if (ret < 0) {
+			NET_ERR("Failed to send the packets (%d)", errno);
+			return -errno;
+		} else {
+			nb_packets += ret;
+		}
+#else
 		/* Fill the packet header */
-		datagram = (struct zperf_udp_datagram *)sample_packet;
-
-		datagram->id = htonl(nb_packets);
-		datagram->tv_sec = htonl(secs);
-		datagram->tv_usec = htonl(usecs);
-
-		hdr = (struct zperf_client_hdr_v1 *)(sample_packet +
-						     sizeof(*datagram));
-		hdr->flags = 0;
-		hdr->num_of_threads = htonl(1);
-		hdr->port = htonl(port);
-		hdr->buffer_len = sizeof(sample_packet) -
-			sizeof(*datagram) - sizeof(*hdr);
-		hdr->bandwidth = htonl(rate_in_kbps);
-		hdr->num_of_bytes = htonl(packet_size);
+		udp_fill_header(packet, nb_packets, secs, usecs, &client_hdr);
 
 		/* Send the packet */
-		ret = zsock_send(sock, sample_packet, packet_size, 0);
+		ret = zsock_send(sock, packet, packet_size, 0);
 		if (ret < 0) {
 			NET_ERR("Failed to send the packet (%d)", errno);
 			return -errno;
 		} else {
 			nb_packets++;
 		}
+#endif
 
 		if (IS_ENABLED(CONFIG_NET_ZPERF_LOG_LEVEL_DBG)) {
 			int64_t print_interval = sys_clock_timeout_end_calc(K_SECONDS(1));
@@ -241,6 +297,11 @@ static int udp_upload(int sock, int port,
 		/* Wait */
 #if defined(CONFIG_ARCH_POSIX)
 		k_busy_wait(USEC_PER_MSEC);
+
+		/* The busy wait does not reschedule, let the other streams
+		 * run.
+		 */
+		k_yield();
 #else
 		if (delay != 0) {
 			if (k_us_to_ticks_floor64(delay) > remaining) {
@@ -254,7 +315,7 @@ static int udp_upload(int sock, int port,
 
 	end_time = k_uptime_ticks();
 
-	ret = zperf_upload_fin(sock, nb_packets, end_time, packet_size,
+	ret = zperf_upload_fin(sock, packet, nb_packets, end_time, packet_size,
 			       results);
 	if (ret < 0) {
 		return ret;
@@ -269,41 +330,42 @@ static int udp_upload(int sock, int port,
 	return 0;
 }
 
-int zperf_udp_upload(const struct zperf_upload_params *param,
-		     struct zperf_results *result)
+static int udp_upload_stream(const struct zperf_upload_params *param,
+			     int stream, struct zperf_results *result)
 {
-	int port = 0;
 	int sock;
 	int ret;
 
-	if (param == NULL || result == NULL) {
-		return -EINVAL;
-	}
-
-	if (param->peer_addr.sa_family == AF_INET) {
-		port = ntohs(net_sin(&param->peer_addr)->sin_port);
-	} else if (param->peer_addr.sa_family == AF_INET6) {
-		port = ntohs(net_sin6(&param->peer_addr)->sin6_port);
-	} else {
-		NET_ERR("Invalid address family (%d)",
-			param->peer_addr.sa_family);
-		return -EINVAL;
-	}
-
 	sock = zperf_prepare_upload_sock(&param->peer_addr, param->options.tos,
 					 IPPROTO_UDP);
 	if (sock < 0) {
 		return sock;
 	}
 
-	ret = udp_upload(sock, port, param->duration_ms, param->packet_size,
-			 param->rate_kbps, result);
+	ret = udp_upload(sock, stream, param, result);
 
 	zsock_close(sock);
 
 	return ret;
 }
 
+int zperf_udp_upload(const struct zperf_upload_params *param,
+		     struct zperf_results *result)
+{
+	if (param == NULL || result == NULL) {
+		return -EINVAL;
+	}
+
+	if (param->peer_addr.sa_family != AF_INET &&
+	    param->peer_addr.sa_family != AF_INET6) {
+		NET_ERR("Invalid address family (%d)",
+			param->peer_addr.sa_family);
+		return -EINVAL;
+	}
+
+	return zperf_run_streams(param, udp_upload_stream, result);
+}
+
 static void udp_upload_async_work(struct k_work *work)
 {
 	struct zperf_async_upload_context *upload_ctx =
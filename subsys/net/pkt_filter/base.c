@@ -7,10 +7,61 @@
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(npf_base, CONFIG_NET_PKT_FILTER_LOG_LEVEL);
 
+#include <zephyr/kernel.h>
 #include <zephyr/net/net_core.h>
 #include <zephyr/net/net_pkt_filter.h>
 #include <zephyr/spinlock.h>
 
+#if defined(CONFIG_NET_PKT_FILTER_COMPILED)
+
+/*
+ * Compiled form of a rule list: the tests of every rule are flattened
+ * into one instruction array. Known test functions are turned into
+ * dedicated opcodes so that no indirect call is needed, and the tests
+ * of each rule are sorted cheapest first. A failing test jumps to the
+ * first instruction of the next rule, and every rule ends with a
+ * verdict instruction.
+ */
+
+enum npf_op {
+	NPF_OP_VERDICT,
+	NPF_OP_ETH_TYPE,
+	NPF_OP_IFACE,
+	NPF_OP_ORIG_IFACE,
+	NPF_OP_SIZE,
+	NPF_OP_ETH_SRC,
+	NPF_OP_ETH_DST,
+	NPF_OP_CALL,
+};
+
+struct npf_insn {
+	uint8_t op;
+	bool negate;
+	uint16_t fail;		/* next instruction if the test is false */
+	union {
+		struct npf_test *test;
+		enum net_verdict result;
+	};
+};
+
+struct npf_prog {
+	atomic_t users;
+	struct npf_insn insns[CONFIG_NET_PKT_FILTER_COMPILED_MAX_INSNS];
+};
+
+static struct npf_prog send_progs[2];
+static struct npf_prog recv_progs[2];
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+static struct npf_prog capture_progs[2];
+#endif
+
+static void compile_work_handler(struct k_work *work);
+
+/* Rebuilds the programs of the modified rule lists */
+static K_WORK_DELAYABLE_DEFINE(npf_compile_work, compile_work_handler);
+
+#endif /* CONFIG_NET_PKT_FILTER_COMPILED */
+
 /*
  * Our actual rule lists for supported test points
  */
@@ -18,13 +69,23 @@ LOG_MODULE_REGISTER(npf_base, CONFIG_NET_PKT_FILTER_LOG_LEVEL);
 struct npf_rule_list npf_send_rules = {
 	.rule_head = SYS_SLIST_STATIC_INIT(&send_rules.rule_head),
 	.lock = { },
+	IF_ENABLED(CONFIG_NET_PKT_FILTER_COMPILED, (.progs = send_progs,))
 };
 
 struct npf_rule_list npf_recv_rules = {
 	.rule_head = SYS_SLIST_STATIC_INIT(&recv_rules.rule_head),
 	.lock = { },
+	IF_ENABLED(CONFIG_NET_PKT_FILTER_COMPILED, (.progs = recv_progs,))
 };
 
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+struct npf_rule_list npf_capture_rules = {
+	.rule_head = SYS_SLIST_STATIC_INIT(&capture_rules.rule_head),
+	.lock = { },
+	IF_ENABLED(CONFIG_NET_PKT_FILTER_COMPILED, (.progs = capture_progs,))
+};
+#endif
+
 /*
  * Rule application
  */
@@ -84,19 +145,298 @@ static enum net_verdict lock_evaluate(struct npf_rule_list *rules, struct net_pk
 	return result;
 }
 
+#if defined(CONFIG_NET_PKT_FILTER_COMPILED)
+
+static bool run_insn(const struct npf_insn *insn, struct net_pkt *pkt)
+{
+	switch (insn->op) {
+	case NPF_OP_IFACE:
+		return npf_iface_match(insn->test, pkt);
+	case NPF_OP_ORIG_IFACE:
+		return npf_orig_iface_match(insn->test, pkt);
+	case NPF_OP_SIZE:
+		return npf_size_inbounds(insn->test, pkt);
+#if defined(CONFIG_NET_L2_ETHERNET)
+	case NPF_OP_ETH_TYPE:
+		return npf_eth_type_match(insn->test, pkt);
+	case NPF_OP_ETH_SRC:
+		return npf_eth_addr_match(insn->test, &NET_ETH_HDR(pkt)->src);
+	case NPF_OP_ETH_DST:
+		return npf_eth_addr_match(insn->test, &NET_ETH_HDR(pkt)->dst);
+#endif
+	default:
+		return insn->test->fn(insn->test, pkt);
+	}
+}
+
+static enum net_verdict run_prog(const struct npf_insn *insns, struct net_pkt *pkt)
+{
+	const struct npf_insn *insn = insns;
+
+	while (insn->op != NPF_OP_VERDICT) {
+		if (run_insn(insn, pkt) != insn->negate) {
+			insn++;
+		} else {
+			insn = &insns[insn->fail];
+		}
+	}
+
+	return insn->result;
+}
+
+/*
+ * Lock-free evaluation: the program is pinned with its users count and
+ * only run if it is still the active one after that, so that a writer
+ * never rebuilds a program that is being run.
+ */
+static enum net_verdict prog_evaluate(struct npf_rule_list *rules, struct net_pkt *pkt)
+{
+	struct npf_prog *prog = atomic_ptr_get(&rules->prog);
+	enum net_verdict result;
+
+	if (prog == NULL) {
+		return lock_evaluate(rules, pkt);
+	}
+
+	atomic_inc(&prog->users);
+
+	if (atomic_ptr_get(&rules->prog) != prog) {
+		atomic_dec(&prog->users);
+		return lock_evaluate(rules, pkt);
+	}
+
+	result = run_prog(prog->insns, pkt);
+	atomic_dec(&prog->users);
+
+	return result;
+}
+
+#define filter_evaluate prog_evaluate
+#else
+#define filter_evaluate lock_evaluate
+#endif /* CONFIG_NET_PKT_FILTER_COMPILED */
+
 bool net_pkt_filter_send_ok(struct net_pkt *pkt)
 {
-	enum net_verdict result = lock_evaluate(&npf_send_rules, pkt);
+	enum net_verdict result = filter_evaluate(&npf_send_rules, pkt);
 
 	return result == NET_OK;
 }
 
 bool net_pkt_filter_recv_ok(struct net_pkt *pkt)
 {
-	enum net_verdict result = lock_evaluate(&npf_recv_rules, pkt);
+	enum net_verdict result = filter_evaluate(&npf_recv_rules, pkt);
+
+	return result == NET_OK;
+}
+
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+bool net_pkt_filter_capture_ok(struct net_pkt *pkt)
+{
+	enum net_verdict result = filter_evaluate(&npf_capture_rules, pkt);
 
 	return result == NET_OK;
 }
+#endif
+
+#if defined(CONFIG_NET_PKT_FILTER_COMPILED)
+
+/*
+ * Rule compilation
+ */
+
+static const struct {
+	npf_test_fn_t *fn;
+	uint8_t op;
+	bool negate;
+} npf_known_tests[] = {
+	{ npf_iface_match, NPF_OP_IFACE, false },
+	{ npf_iface_unmatch, NPF_OP_IFACE, true },
+	{ npf_orig_iface_match, NPF_OP_ORIG_IFACE, false },
+	{ npf_orig_iface_unmatch, NPF_OP_ORIG_IFACE, true },
+	{ npf_size_inbounds, NPF_OP_SIZE, false },
+#if defined(CONFIG_NET_L2_ETHERNET)
+	{ npf_eth_type_match, NPF_OP_ETH_TYPE, false },
+	{ npf_eth_type_unmatch, NPF_OP_ETH_TYPE, true },
+	{ npf_eth_src_addr_match, NPF_OP_ETH_SRC, false },
+	{ npf_eth_src_addr_unmatch, NPF_OP_ETH_SRC, true },
+	{ npf_eth_dst_addr_match, NPF_OP_ETH_DST, false },
+	{ npf_eth_dst_addr_unmatch, NPF_OP_ETH_DST, true },
+#endif
+};
+
+static void compile_test(struct npf_insn *insn, struct npf_test *test)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(npf_known_tests); i++) {
+		if (npf_known_tests[i].fn == test->fn) {
+			insn->op = npf_known_tests[i].op;
+			insn->negate = npf_known_tests[i].negate;
+			insn->test = test;
+			return;
+		}
+	}
+
+	insn->op = NPF_OP_CALL;
+	insn->negate = false;
+	insn->test = test;
+}
+
+/*
+ * Tests of a rule are all required to pass, so their order does not
+ * change the verdict. Sort them by opcode (cheapest first), keeping
+ * custom tests in their original order at the end.
+ */
+static void compile_rule(struct npf_insn *insns, struct npf_rule *rule)
+{
+	struct npf_insn insn;
+	unsigned int i, j;
+
+	for (i = 0; i < rule->nb_tests; i++) {
+		compile_test(&insn, rule->tests[i]);
+
+		for (j = i; j > 0 && insns[j - 1].op > insn.op; j--) {
+			insns[j] = insns[j - 1];
+		}
+
+		insns[j] = insn;
+	}
+}
+
+static int compile_rules(sys_slist_t *rule_head, struct npf_insn *insns)
+{
+	struct npf_rule *rule;
+	size_t count = 0;
+	size_t start;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(rule_head, rule, node) {
+		/* Room for the tests, the verdict and the final drop */
+		if (count + rule->nb_tests + 2 > CONFIG_NET_PKT_FILTER_COMPILED_MAX_INSNS) {
+			return -ENOSPC;
+		}
+
+		start = count;
+		compile_rule(&insns[start], rule);
+		count += rule->nb_tests;
+
+		insns[count].op = NPF_OP_VERDICT;
+		insns[count].result = rule->result;
+		count++;
+
+		while (start < count) {
+			insns[start++].fail = count;
+		}
+	}
+
+	insns[count].op = NPF_OP_VERDICT;
+	insns[count].result = count == 0 ? NET_OK : NET_DROP;
+
+	return count + 1;
+}
+
+/*
+ * Rebuild the program of a rule list into its inactive buffer, and
+ * install it under the rule list lock so that it always matches the
+ * list. Returns false if a reader still runs the inactive buffer, so
+ * that the rebuild is retried later instead of waiting for it.
+ */
+static bool compile_prog(struct npf_rule_list *rules)
+{
+	struct npf_prog *spare;
+	k_spinlock_key_t key;
+	int ret;
+
+	spare = &rules->progs[0];
+	if (atomic_ptr_get(&rules->prog) == spare) {
+		spare = &rules->progs[1];
+	}
+
+	if (atomic_get(&spare->users) != 0) {
+		return false;
+	}
+
+	key = k_spin_lock(&rules->lock);
+
+	ret = compile_rules(&rules->rule_head, spare->insns);
+	if (ret < 0) {
+		NET_DBG("rule list %p too large to compile", rules);
+		atomic_ptr_set(&rules->prog, NULL);
+	} else {
+		NET_DBG("rule list %p compiled into %d instructions", rules, ret);
+		atomic_ptr_set(&rules->prog, spare);
+	}
+
+	k_spin_unlock(&rules->lock, key);
+
+	return true;
+}
+
+static void compile_work_handler(struct k_work *work)
+{
+	struct npf_rule_list *lists[] = {
+		&npf_send_rules,
+		&npf_recv_rules,
+		IF_ENABLED(CONFIG_NET_CAPTURE_LOCAL, (&npf_capture_rules,))
+	};
+	bool done = true;
+
+	ARG_UNUSED(work);
+
+	for (size_t i = 0; i < ARRAY_SIZE(lists); i++) {
+		done &= compile_prog(lists[i]);
+	}
+
+	if (!done) {
+		k_work_schedule(&npf_compile_work, K_TICKS(1));
+	}
+}
+
+/*
+ * Called with the rule list lock held once the list was modified. The
+ * active program no longer matches the list, so readers walk the list
+ * until the program is rebuilt by the compile work. Returns the detached
+ * program.
+ */
+static struct npf_prog *detach_prog(struct npf_rule_list *rules)
+{
+	struct npf_prog *old = atomic_ptr_get(&rules->prog);
+
+	atomic_ptr_set(&rules->prog, NULL);
+
+	return old;
+}
+
+static void update_prog(struct npf_rule_list *rules)
+{
+	if (rules->progs != NULL) {
+		(void)k_work_reschedule(&npf_compile_work, K_NO_WAIT);
+	}
+}
+
+/*
+ * The detached program still points to the tests of a removed rule,
+ * which the caller may free once the rule is removed. Wait until the
+ * readers that pinned it before it was detached are done, or until the
+ * compile work reused it, which it only does once it has no reader.
+ */
+static void wait_prog_readers(struct npf_rule_list *rules, struct npf_prog *old)
+{
+	__ASSERT(!k_is_in_isr(), "rules cannot be removed from an ISR");
+
+	if (old == NULL) {
+		return;
+	}
+
+	while (atomic_get(&old->users) != 0 &&
+	       atomic_ptr_get(&rules->prog) != old) {
+		k_sleep(K_TICKS(1));
+	}
+}
+
+#else
+#define detach_prog(rules) NULL
+#define update_prog(rules)
+#define wait_prog_readers(rules, old) ARG_UNUSED(old)
+#endif /* CONFIG_NET_PKT_FILTER_COMPILED */
 
 /*
  * Rule management
@@ -108,8 +448,10 @@ void npf_insert_rule(struct npf_rule_list *rules, struct npf_rule *rule)
 
 	NET_DBG("inserting rule %p into %p", rule, rules);
 	sys_slist_prepend(&rules->rule_head, &rule->node);
+	(void)detach_prog(rules);
 
 	k_spin_unlock(&rules->lock, key);
+	update_prog(rules);
 }
 
 void npf_append_rule(struct npf_rule_list *rules, struct npf_rule *rule)
@@ -121,17 +463,30 @@ void npf_append_rule(struct npf_rule_list *rules, struct npf_rule *rule)
 
 	NET_DBG("appending rule %p into %p", rule, rules);
 	sys_slist_append(&rules->rule_head, &rule->node);
+	(void)detach_prog(rules);
 
 	k_spin_unlock(&rules->lock, key);
+	update_prog(rules);
 }
 
 bool npf_remove_rule(struct npf_rule_list *rules, struct npf_rule *rule)
 {
 	k_spinlock_key_t key = k_spin_lock(&rules->lock);
 	bool result = sys_slist_find_and_remove(&rules->rule_head, &rule->node);
+	struct npf_prog *old = NULL;
+
+	if (result) {
+		old = detach_prog(rules);
+	}
 
 	k_spin_unlock(&rules->lock, key);
 	NET_DBG("removing rule %p from %p: %d", rule, rules, result);
+
+	if (result) {
+		wait_prog_readers(rules, old);
+		update_prog(rules);
+	}
+
 	return result;
 }
 
@@ -139,13 +494,21 @@ bool npf_remove_all_rules(struct npf_rule_list *rules)
 {
 	k_spinlock_key_t key = k_spin_lock(&rules->lock);
 	bool result = !sys_slist_is_empty(&rules->rule_head);
+	struct npf_prog *old = NULL;
 
 	if (result) {
 		sys_slist_init(&rules->rule_head);
+		old = detach_prog(rules);
 		NET_DBG("removing all rules from %p", rules);
 	}
 
 	k_spin_unlock(&rules->lock, key);
+
+	if (result) {
+		wait_prog_readers(rules, old);
+		update_prog(rules);
+	}
+
 	return result;
 }
 
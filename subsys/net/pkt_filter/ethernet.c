@@ -23,7 +23,7 @@ static bool addr_mask_compare(struct net_eth_addr *addr1,
 	return true;
 }
 
-static bool addr_match(struct npf_test *test, struct net_eth_addr *pkt_addr)
+bool npf_eth_addr_match(struct npf_test *test, struct net_eth_addr *pkt_addr)
 {
 	struct npf_test_eth_addr *test_eth_addr =
 			CONTAINER_OF(test, struct npf_test_eth_addr, test);
@@ -45,7 +45,7 @@ bool npf_eth_src_addr_match(struct npf_test *test, struct net_pkt *pkt)
 {
 	struct net_eth_hdr *eth_hdr = NET_ETH_HDR(pkt);
 
-	return addr_match(test, &eth_hdr->src);
+	return npf_eth_addr_match(test, &eth_hdr->src);
 }
 
 bool npf_eth_src_addr_unmatch(struct npf_test *test, struct net_pkt *pkt)
@@ -57,7 +57,7 @@ bool npf_eth_dst_addr_match(struct npf_test *test, struct net_pkt *pkt)
 {
 	struct net_eth_hdr *eth_hdr = NET_ETH_HDR(pkt);
 
-	return addr_match(test, &eth_hdr->dst);
+	return npf_eth_addr_match(test, &eth_hdr->dst);
 }
 
 bool npf_eth_dst_addr_unmatch(struct npf_test *test, struct net_pkt *pkt)
@@ -647,4 +647,219 @@ ZTEST(arp_fn_tests, test_arp)
 	}
 }
 
+#define CACHE_NEIGHBORS 500
+#define CACHE_ROUNDS 10
+
+static void cache_neighbor_addr(int idx, struct in_addr *addr,
+				struct net_eth_addr *lladdr)
+{
+	/* Neighbors are 10.0.0.1 onwards, with matching MAC addresses */
+	*addr = (struct in_addr){ { { 10, 0, (idx + 1) >> 8, (idx + 1) } } };
+	*lladdr = (struct net_eth_addr){
+		{ 0x02, 0x00, 0x5e, 0x00, (idx + 1) >> 8, (idx + 1) } };
+}
+
+static void cache_add_neighbor(struct net_if *iface, struct in_addr *src,
+			       int idx)
+{
+	struct net_eth_hdr *eth_hdr;
+	struct net_arp_hdr *arp_hdr;
+	struct net_eth_addr lladdr;
+	struct in_addr addr;
+	struct net_pkt *pkt;
+
+	cache_neighbor_addr(idx, &addr, &lladdr);
+
+	pkt = net_pkt_alloc_with_buffer(iface, sizeof(struct net_eth_hdr) +
+					sizeof(struct net_arp_hdr),
+					AF_UNSPEC, 0, K_SECONDS(1));
+	zassert_not_null(pkt, "out of mem request");
+
+	setup_eth_header(iface, pkt, net_eth_broadcast_addr(),
+			 NET_ETH_PTYPE_ARP);
+
+	eth_hdr = (struct net_eth_hdr *)net_pkt_data(pkt);
+	net_buf_add(pkt->buffer, sizeof(struct net_eth_hdr));
+	net_buf_pull(pkt->buffer, sizeof(struct net_eth_hdr));
+	arp_hdr = NET_ARP_HDR(pkt);
+
+	/* A request for our address with an unspecified target hardware
+	 * address adds the sender to the cache.
+	 */
+	arp_hdr->hwtype = htons(NET_ARP_HTYPE_ETH);
+	arp_hdr->protocol = htons(NET_ETH_PTYPE_IP);
+	arp_hdr->hwlen = sizeof(struct net_eth_addr);
+	arp_hdr->protolen = sizeof(struct in_addr);
+	arp_hdr->opcode = htons(NET_ARP_REQUEST);
+	memcpy(&arp_hdr->src_hwaddr, &lladdr, sizeof(struct net_eth_addr));
+	(void)memset(&arp_hdr->dst_hwaddr, 0, sizeof(struct net_eth_addr));
+	net_ipv4_addr_copy_raw(arp_hdr->src_ipaddr, (uint8_t *)&addr);
+	net_ipv4_addr_copy_raw(arp_hdr->dst_ipaddr, (uint8_t *)src);
+
+	net_buf_add(pkt->buffer, sizeof(struct net_arp_hdr));
+
+	if (net_arp_input(pkt, eth_hdr) == NET_DROP) {
+		net_pkt_unref(pkt);
+		zassert_true(false, "ARP request %d dropped", idx);
+	}
+
+	/* Let the TX thread send the reply */
+	k_yield();
+}
+
+static void cache_count_cb(struct arp_entry *entry, void *user_data)
+{
+	int *count = user_data;
+
+	(*count)++;
+}
+
+struct cache_find {
+	struct in_addr addr;
+	bool found;
+};
+
+static void cache_find_cb(struct arp_entry *entry, void *user_data)
+{
+	struct cache_find *find = user_data;
+
+	if (net_ipv4_addr_cmp(&entry->ip, &find->addr)) {
+		find->found = true;
+	}
+}
+
+static bool cache_has_neighbor(int idx)
+{
+	struct cache_find find = { 0 };
+	struct net_eth_addr lladdr;
+
+	cache_neighbor_addr(idx, &find.addr, &lladdr);
+	net_arp_foreach(cache_find_cb, &find);
+
+	return find.found;
+}
+
+static struct net_if *cache_setup(struct in_addr *src)
+{
+	struct net_if *iface;
+
+	iface = net_if_lookup_by_dev(DEVICE_GET(net_arp_test));
+
+	if (!net_if_ipv4_addr_lookup(src, NULL)) {
+		struct net_if_addr *ifaddr;
+
+		ifaddr = net_if_ipv4_addr_add(iface, src, NET_ADDR_MANUAL, 0);
+		zassert_not_null(ifaddr, "Cannot add address");
+		ifaddr->addr_state = NET_ADDR_PREFERRED;
+	}
+
+	net_arp_clear_cache(iface);
+
+	req_test = true;
+
+	return iface;
+}
+
+ZTEST(arp_fn_tests, test_arp_cache_lru)
+{
+	struct in_addr src = { { { 192, 168, 0, 1 } } };
+	struct net_eth_addr lladdr;
+	struct net_if *iface;
+	struct in_addr addr;
+	struct net_pkt *pkt;
+	int i;
+
+	if (CONFIG_NET_ARP_TABLE_SIZE < 2) {
+		ztest_test_skip();
+	}
+
+	iface = cache_setup(&src);
+
+	for (i = 0; i < CONFIG_NET_ARP_TABLE_SIZE; i++) {
+		cache_add_neighbor(iface, &src, i);
+	}
+
+	pkt = net_pkt_alloc_with_buffer(iface, sizeof(struct net_ipv4_hdr),
+					AF_INET, 0, K_SECONDS(1));
+	zassert_not_null(pkt, "out of mem");
+
+	(void)memset(net_buf_add(pkt->buffer, sizeof(struct net_ipv4_hdr)), 0,
+		     sizeof(struct net_ipv4_hdr));
+
+	/* Sending to the oldest neighbor makes the second one the least
+	 * recently used, so it is the one replaced by a new neighbor.
+	 */
+	cache_neighbor_addr(0, &addr, &lladdr);
+	zassert_equal_ptr(net_arp_prepare(pkt, &addr, &src), pkt,
+			  "Neighbor 0 not resolved");
+
+	cache_add_neighbor(iface, &src, CONFIG_NET_ARP_TABLE_SIZE);
+
+	zassert_true(cache_has_neighbor(0), "Used neighbor evicted");
+	zassert_false(cache_has_neighbor(1), "LRU neighbor not evicted");
+	zassert_true(cache_has_neighbor(CONFIG_NET_ARP_TABLE_SIZE),
+		     "New neighbor not cached");
+
+	net_pkt_unref(pkt);
+	net_arp_clear_cache(iface);
+}
+
+ZTEST(arp_fn_tests, test_arp_cache_scale)
+{
+	struct in_addr src = { { { 192, 168, 0, 1 } } };
+	struct net_eth_addr lladdr;
+	struct net_if *iface;
+	struct in_addr addr;
+	struct net_pkt *pkt;
+	uint32_t start, cycles;
+	int count = 0;
+	int i, j;
+
+	if (CONFIG_NET_ARP_TABLE_SIZE < CACHE_NEIGHBORS) {
+		ztest_test_skip();
+	}
+
+	iface = cache_setup(&src);
+
+	for (i = 0; i < CACHE_NEIGHBORS; i++) {
+		cache_add_neighbor(iface, &src, i);
+	}
+
+	net_arp_foreach(cache_count_cb, &count);
+	zassert_equal(count, CACHE_NEIGHBORS, "Only %d neighbors cached",
+		      count);
+
+	pkt = net_pkt_alloc_with_buffer(iface, sizeof(struct net_ipv4_hdr),
+					AF_INET, 0, K_SECONDS(1));
+	zassert_not_null(pkt, "out of mem");
+
+	(void)memset(net_buf_add(pkt->buffer, sizeof(struct net_ipv4_hdr)), 0,
+		     sizeof(struct net_ipv4_hdr));
+
+	/* Resolve the link address of every neighbor, as done when
+	 * sending a packet to each of them.
+	 */
+	start = k_cycle_get_32();
+
+	for (j = 0; j < CACHE_ROUNDS; j++) {
+		for (i = 0; i < CACHE_NEIGHBORS; i++) {
+			cache_neighbor_addr(i, &addr, &lladdr);
+
+			zassert_equal_ptr(net_arp_prepare(pkt, &addr, &src),
+					  pkt, "Neighbor %d not resolved", i);
+			zassert_mem_equal(net_pkt_lladdr_dst(pkt)->addr,
+					  &lladdr, sizeof(lladdr),
+					  "Wrong address for neighbor %d", i);
+		}
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	TC_PRINT("%u cycles per TX lookup with %d neighbors\n",
+		 cycles / (CACHE_ROUNDS * CACHE_NEIGHBORS), CACHE_NEIGHBORS);
+
+	net_pkt_unref(pkt);
+	net_arp_clear_cache(iface);
+}
+
 ZTEST_SUITE(arp_fn_tests, NULL, NULL, NULL, NULL, NULL);
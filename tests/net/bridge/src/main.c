@@ -31,10 +31,13 @@ LOG_MODULE_REGISTER(net_test, NET_LOG_LEVEL);
 struct eth_fake_context {
 	struct net_if *iface;
 	struct net_pkt *sent_pkt;
+	int sent_count;
 	uint8_t mac_address[6];
 	bool promisc_mode;
 };
 
+static bool count_only;
+
 static void eth_fake_iface_init(struct net_if *iface)
 {
 	const struct device *dev = net_if_get_device(iface);
@@ -71,6 +74,13 @@ static int eth_fake_send(const struct device *dev,
 		return 0;
 	}
 
+	ctx->sent_count++;
+
+	/* Only count the packets while measuring the forwarding */
+	if (count_only) {
+		return 0;
+	}
+
 	if (ctx->sent_pkt != NULL) {
 		DBG("Fake send found pkt %p while sending %p\n",
 		    ctx->sent_pkt, pkt);
@@ -352,6 +362,199 @@ static void test_recv_with_bridge(void)
 	check_free_packet_count();
 }
 
+#if defined(CONFIG_NET_ETHERNET_BRIDGE_FDB)
+#define FORWARD_FRAMES 32
+
+static const uint8_t host_a[] = { 0x02, 0x00, 0x5e, 0x00, 0x53, 0x0a };
+static const uint8_t host_b[] = { 0x02, 0x00, 0x5e, 0x00, 0x53, 0x0b };
+static const uint8_t host_c[] = { 0x02, 0x00, 0x5e, 0x00, 0x53, 0x0c };
+
+static void recv_frame(struct net_if *iface, const uint8_t *src,
+		       const uint8_t *dst)
+{
+	static const uint8_t data[] = { 'f', 'd', 'b', '\0' };
+	struct net_eth_hdr eth_hdr;
+	struct net_pkt *pkt;
+	int ret;
+
+	pkt = net_pkt_rx_alloc_with_buffer(iface, sizeof(eth_hdr) + sizeof(data),
+					   AF_UNSPEC, 0, K_FOREVER);
+	zassert_not_null(pkt, "");
+
+	memcpy(eth_hdr.src.addr, src, sizeof(eth_hdr.src.addr));
+	memcpy(eth_hdr.dst.addr, dst, sizeof(eth_hdr.dst.addr));
+	eth_hdr.type = htons(NET_ETH_PTYPE_ALL);
+
+	ret = net_pkt_write(pkt, &eth_hdr, sizeof(eth_hdr));
+	zassert_equal(ret, 0, "");
+
+	ret = net_pkt_write(pkt, data, sizeof(data));
+	zassert_equal(ret, 0, "");
+
+	ret = net_recv_data(iface, pkt);
+	zassert_equal(ret, 0, "");
+}
+
+/* Check which interfaces sent the last frame and release it */
+static void check_sent(bool iface0, bool iface2)
+{
+	bool expected[] = { iface0, false, iface2 };
+	int i;
+
+	k_sleep(K_MSEC(100));
+
+	for (i = 0; i < ARRAY_SIZE(expected); i++) {
+		struct net_pkt *pkt = eth_fake_data[i].sent_pkt;
+
+		if (!expected[i]) {
+			zassert_is_null(pkt, "iface%d sent a frame", i);
+			continue;
+		}
+
+		zassert_not_null(pkt, "iface%d did not send a frame", i);
+
+		eth_fake_data[i].sent_pkt = NULL;
+		net_pkt_unref(pkt);
+	}
+}
+
+static void test_fdb_learning(void)
+{
+	struct eth_bridge_stats before, after;
+	int ret;
+
+	ret = eth_bridge_get_stats(&test_bridge, &before);
+	zassert_equal(ret, 0, "");
+
+	/* B is not known yet, so the frame is flooded */
+	recv_frame(fake_iface[0], host_a, host_b);
+	check_sent(false, true);
+
+	/* A was learned on fake_iface[0] */
+	recv_frame(fake_iface[2], host_b, host_a);
+	check_sent(true, false);
+
+	/* B was learned on fake_iface[2] */
+	recv_frame(fake_iface[0], host_a, host_b);
+	check_sent(false, true);
+
+	/* A is on the same segment as C, nothing to forward */
+	recv_frame(fake_iface[0], host_c, host_a);
+	check_sent(false, false);
+
+	/* A moves to fake_iface[2] */
+	recv_frame(fake_iface[2], host_a, host_c);
+	check_sent(true, false);
+
+	recv_frame(fake_iface[0], host_c, host_a);
+	check_sent(false, true);
+
+	ret = eth_bridge_get_stats(&test_bridge, &after);
+	zassert_equal(ret, 0, "");
+
+	zassert_equal(after.rx - before.rx, 6, "");
+	zassert_equal(after.flooded - before.flooded, 1, "");
+	zassert_equal(after.forwarded - before.forwarded, 4, "");
+	zassert_equal(after.filtered - before.filtered, 1, "");
+	zassert_equal(after.moved - before.moved, 1, "");
+
+	check_free_packet_count();
+}
+
+static int count_sent_frames(void)
+{
+	k_sleep(K_MSEC(100));
+
+	return eth_fake_data[0].sent_count + eth_fake_data[1].sent_count +
+	       eth_fake_data[2].sent_count;
+}
+
+static void test_fdb_duplication(void)
+{
+	uint8_t unknown[] = { 0x02, 0x00, 0x5e, 0x00, 0x54, 0x00 };
+	int i, sent_learned, sent_flooded;
+
+	/* With all ports transmitting, flooding duplicates every frame */
+	eth_bridge_iface_allow_tx(fake_iface[1], true);
+	count_only = true;
+
+	for (i = 0; i < ARRAY_SIZE(eth_fake_data); i++) {
+		eth_fake_data[i].sent_count = 0;
+	}
+
+	for (i = 0; i < FORWARD_FRAMES; i++) {
+		if (i % 2) {
+			recv_frame(fake_iface[2], host_b, host_a);
+		} else {
+			recv_frame(fake_iface[0], host_a, host_b);
+		}
+
+		k_sleep(K_MSEC(5));
+	}
+
+	sent_learned = count_sent_frames();
+
+	for (i = 0; i < FORWARD_FRAMES; i++) {
+		unknown[5] = i;
+		recv_frame(fake_iface[0], host_a, unknown);
+
+		k_sleep(K_MSEC(5));
+	}
+
+	sent_flooded = count_sent_frames() - sent_learned;
+
+	count_only = false;
+	eth_bridge_iface_allow_tx(fake_iface[1], false);
+
+	TC_PRINT("learned: %d frames, %d duplicated\n", FORWARD_FRAMES,
+		 sent_learned - FORWARD_FRAMES);
+	TC_PRINT("flooded: %d frames, %d duplicated\n", FORWARD_FRAMES,
+		 sent_flooded - FORWARD_FRAMES);
+
+	zassert_equal(sent_learned, FORWARD_FRAMES, "");
+	zassert_equal(sent_flooded, 2 * FORWARD_FRAMES, "");
+
+	check_free_packet_count();
+}
+
+static void fdb_count_cb(struct eth_bridge_fdb_entry *entry, void *user_data)
+{
+	int *count = user_data;
+
+	if (entry->iface == fake_iface[0]) {
+		(*count)++;
+	}
+}
+
+static void test_fdb_flush(void)
+{
+	struct eth_bridge_stats before, after;
+	int ret, count = 0;
+
+	ret = eth_bridge_fdb_foreach(&test_bridge, fdb_count_cb, &count);
+	zassert_true(ret > 0, "");
+	zassert_true(count > 0, "");
+
+	ret = eth_bridge_fdb_flush(&test_bridge, fake_iface[0]);
+	zassert_equal(ret, 0, "");
+
+	count = 0;
+	eth_bridge_fdb_foreach(&test_bridge, fdb_count_cb, &count);
+	zassert_equal(count, 0, "");
+
+	eth_bridge_get_stats(&test_bridge, &before);
+
+	/* C was only seen on fake_iface[0], so the frame is flooded again */
+	recv_frame(fake_iface[2], host_b, host_c);
+	check_sent(true, false);
+
+	eth_bridge_get_stats(&test_bridge, &after);
+	zassert_equal(after.flooded - before.flooded, 1, "");
+
+	check_free_packet_count();
+}
+#endif /* CONFIG_NET_ETHERNET_BRIDGE_FDB */
+
 static void test_recv_after_bridging(void)
 {
 	int ret;
@@ -374,6 +577,11 @@ ZTEST(net_eth_bridge, test_net_eth_bridge)
 	test_recv_before_bridging();
 	test_setup_bridge();
 	test_recv_with_bridge();
+#if defined(CONFIG_NET_ETHERNET_BRIDGE_FDB)
+	test_fdb_learning();
+	test_fdb_duplication();
+	test_fdb_flush();
+#endif
 	test_recv_after_bridging();
 }
 
@@ -656,4 +656,224 @@ ZTEST(ieee802154_6lo_fragment, test_fragment_ipv6_no_fragmentation_after_iphc)
 	zassert_true(ret);
 }
 
+/* Compress and fragment the data, the fragments are the buffers of the
+ * returned packet.
+ */
+static struct net_pkt *fragment_data(struct net_fragment_data *data)
+{
+	struct ieee802154_6lo_fragment_ctx ctx;
+	struct net_buf *buf, *dfrag;
+	struct net_pkt *f_pkt;
+	struct net_pkt *pkt;
+	int hdr_diff;
+
+	pkt = create_pkt(data);
+	if (!pkt) {
+		return NULL;
+	}
+
+	hdr_diff = net_6lo_compress(pkt, data->iphc);
+	if (hdr_diff < 0 || !ieee802154_6lo_requires_fragmentation(pkt, 0)) {
+		net_pkt_unref(pkt);
+		return NULL;
+	}
+
+	f_pkt = net_pkt_alloc(K_FOREVER);
+	if (!f_pkt) {
+		net_pkt_unref(pkt);
+		return NULL;
+	}
+
+	ieee802154_6lo_fragment_ctx_init(&ctx, pkt, hdr_diff, data->iphc);
+	frame_buf.len = 0U;
+
+	buf = pkt->buffer;
+	while (buf) {
+		buf = ieee802154_6lo_fragment(&ctx, &frame_buf, data->iphc);
+
+		dfrag = net_pkt_get_frag(f_pkt, frame_buf.len, K_FOREVER);
+		if (!dfrag) {
+			net_pkt_unref(f_pkt);
+			f_pkt = NULL;
+			break;
+		}
+
+		memcpy(dfrag->data, frame_buf.data, frame_buf.len);
+		dfrag->len = frame_buf.len;
+
+		net_pkt_frag_add(f_pkt, dfrag);
+
+		frame_buf.len = 0U;
+	}
+
+	net_pkt_unref(pkt);
+
+	return f_pkt;
+}
+
+/* Pass one fragment to reassembly as if it was received. When the datagram
+ * is complete, the reassembled packet is returned in rxpkt.
+ */
+static enum net_verdict reassemble_frame(struct net_buf *buf, struct net_pkt **rxpkt)
+{
+	enum net_verdict verdict;
+	struct net_buf *dfrag;
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_rx_alloc(K_FOREVER);
+	if (!pkt) {
+		return NET_DROP;
+	}
+
+	dfrag = net_pkt_get_frag(pkt, buf->len, K_FOREVER);
+	if (!dfrag) {
+		net_pkt_unref(pkt);
+		return NET_DROP;
+	}
+
+	memcpy(dfrag->data, buf->data, buf->len);
+	dfrag->len = buf->len;
+
+	net_pkt_frag_add(pkt, dfrag);
+	net_pkt_set_overwrite(pkt, true);
+
+	verdict = ieee802154_6lo_reassemble(pkt);
+	if (verdict == NET_DROP) {
+		net_pkt_unref(pkt);
+	} else if (verdict == NET_CONTINUE) {
+		*rxpkt = pkt;
+	}
+
+	return verdict;
+}
+
+ZTEST(ieee802154_6lo_fragment, test_fragment_interleaved)
+{
+	struct net_fragment_data *data[] = { &test_data_2, &test_data_3, &test_data_4 };
+	struct net_pkt *f_pkt[ARRAY_SIZE(data)];
+	struct net_buf *buf[ARRAY_SIZE(data)];
+	struct net_pkt *rxpkt;
+	int done = 0;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(data); i++) {
+		f_pkt[i] = fragment_data(data[i]);
+		zassert_not_null(f_pkt[i], "Cannot fragment datagram %d", i);
+		buf[i] = f_pkt[i]->buffer;
+	}
+
+	/* Fragments of the datagrams arrive mixed with each other */
+	while (done < ARRAY_SIZE(data)) {
+		for (i = 0; i < ARRAY_SIZE(data); i++) {
+			if (!buf[i]) {
+				continue;
+			}
+
+			rxpkt = NULL;
+
+			switch (reassemble_frame(buf[i], &rxpkt)) {
+			case NET_OK:
+				break;
+			case NET_CONTINUE:
+				zassert_true(compare_data(rxpkt, data[i]),
+					     "Datagram %d corrupted", i);
+				net_pkt_unref(rxpkt);
+				done++;
+				break;
+			case NET_DROP:
+				zassert_unreachable("Fragment of datagram %d dropped", i);
+			}
+
+			buf[i] = buf[i]->frags;
+		}
+	}
+
+	for (i = 0; i < ARRAY_SIZE(data); i++) {
+		net_pkt_unref(f_pkt[i]);
+	}
+}
+
+ZTEST(ieee802154_6lo_fragment, test_fragment_duplicate)
+{
+	struct net_pkt *rxpkt = NULL;
+	enum net_verdict verdict;
+	struct net_pkt *f_pkt;
+	struct net_buf *buf;
+
+	f_pkt = fragment_data(&test_data_3);
+	zassert_not_null(f_pkt, "Cannot fragment datagram");
+
+	/* Every fragment is received twice, the copies are dropped */
+	for (buf = f_pkt->buffer; buf; buf = buf->frags) {
+		verdict = reassemble_frame(buf, &rxpkt);
+		if (verdict == NET_CONTINUE) {
+			break;
+		}
+
+		zassert_equal(verdict, NET_OK, "Fragment dropped");
+
+		verdict = reassemble_frame(buf, &rxpkt);
+		zassert_equal(verdict, NET_DROP, "Duplicate fragment accepted");
+	}
+
+	zassert_not_null(rxpkt, "Datagram not reassembled");
+	zassert_true(compare_data(rxpkt, &test_data_3), "Datagram corrupted");
+
+	net_pkt_unref(rxpkt);
+	net_pkt_unref(f_pkt);
+}
+
+#define BENCHMARK_ROUNDS 200
+
+ZTEST(ieee802154_6lo_fragment, test_reassembly_throughput)
+{
+	struct net_pkt *rxpkt;
+	struct net_pkt *f_pkt;
+	struct net_buf *buf;
+	uint64_t cycles = 0;
+	uint32_t start, us;
+	int fragments = 0;
+	int i;
+
+	f_pkt = fragment_data(&test_data_6);
+	zassert_not_null(f_pkt, "Cannot fragment datagram");
+
+	for (i = 0; i < BENCHMARK_ROUNDS; i++) {
+		rxpkt = NULL;
+
+		for (buf = f_pkt->buffer; buf; buf = buf->frags) {
+			enum net_verdict verdict;
+
+			start = k_cycle_get_32();
+			verdict = reassemble_frame(buf, &rxpkt);
+			cycles += k_cycle_get_32() - start;
+
+			zassert_not_equal(verdict, NET_DROP, "Fragment dropped");
+			fragments++;
+		}
+
+		zassert_not_null(rxpkt, "Datagram not reassembled");
+
+		if (i == 0) {
+			zassert_true(compare_data(rxpkt, &test_data_6),
+				     "Datagram corrupted");
+		}
+
+		net_pkt_unref(rxpkt);
+	}
+
+	net_pkt_unref(f_pkt);
+
+	us = k_cyc_to_us_ceil32(cycles);
+
+	TC_PRINT("Reassembled %d datagrams (%d fragments) of %u bytes in %u us\n",
+		 BENCHMARK_ROUNDS, fragments, NET_IPV6UDPH_LEN + test_data_6.len, us);
+
+	if (us > 0) {
+		TC_PRINT("%llu datagrams/s, %llu fragments/s\n",
+			 (uint64_t)BENCHMARK_ROUNDS * USEC_PER_SEC / us,
+			 (uint64_t)fragments * USEC_PER_SEC / us);
+	}
+}
+
 ZTEST_SUITE(ieee802154_6lo_fragment, NULL, NULL, NULL, NULL, NULL);
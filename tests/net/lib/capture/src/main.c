@@ -0,0 +1,319 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_CAPTURE_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/net_core.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_pkt_filter.h>
+#include <zephyr/net/capture.h>
+#include <zephyr/net/dummy.h>
+
+#define PCAPNG_SHB_TYPE 0x0A0D0D0A
+#define PCAPNG_IDB_TYPE 0x00000001
+#define PCAPNG_EPB_TYPE 0x00000006
+#define PCAPNG_EPB_HDR_LEN 28
+#define PCAPNG_EPB_FLAGS_CODE 2
+
+#define BIG_PKT_LEN 100
+#define SMALL_PKT_LEN 20
+#define SNAPLEN 32
+
+static uint8_t pcapng[2048];
+static size_t pcapng_len;
+
+struct fake_dev_context {
+	struct net_if *iface;
+};
+
+static struct fake_dev_context fake_dev_a_data;
+static struct fake_dev_context fake_dev_b_data;
+
+static void fake_dev_iface_init(struct net_if *iface)
+{
+	const struct device *dev = net_if_get_device(iface);
+	struct fake_dev_context *ctx = dev->data;
+
+	ctx->iface = iface;
+}
+
+static int fake_dev_send(const struct device *dev, struct net_pkt *pkt)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static int fake_dev_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return 0;
+}
+
+static const struct dummy_api fake_dev_api = {
+	.iface_api.init = fake_dev_iface_init,
+	.send = fake_dev_send,
+};
+
+NET_DEVICE_INIT_INSTANCE(fake_dev_a, "fake_dev_a", 0, fake_dev_init, NULL,
+			 &fake_dev_a_data, NULL,
+			 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &fake_dev_api,
+			 DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 127);
+
+NET_DEVICE_INIT_INSTANCE(fake_dev_b, "fake_dev_b", 1, fake_dev_init, NULL,
+			 &fake_dev_b_data, NULL,
+			 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &fake_dev_api,
+			 DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 127);
+
+static int buf_write(const void *data, size_t len, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	if (pcapng_len + len > sizeof(pcapng)) {
+		return -ENOMEM;
+	}
+
+	memcpy(&pcapng[pcapng_len], data, len);
+	pcapng_len += len;
+
+	return 0;
+}
+
+static uint32_t get_u32(size_t offset)
+{
+	uint32_t val;
+
+	memcpy(&val, &pcapng[offset], sizeof(val));
+
+	return val;
+}
+
+static void capture(struct net_if *iface, size_t len, enum net_capture_dir dir)
+{
+	struct net_pkt *pkt;
+	size_t i;
+
+	pkt = net_pkt_alloc_with_buffer(iface, len, AF_UNSPEC, 0, K_NO_WAIT);
+	zassert_not_null(pkt, "Cannot allocate pkt");
+
+	for (i = 0; i < len; i++) {
+		zassert_ok(net_pkt_write_u8(pkt, (uint8_t)i), "Cannot write data");
+	}
+
+	net_pkt_cursor_init(pkt);
+
+	net_capture_pkt_with_dir(iface, pkt, dir);
+
+	zassert_equal(net_pkt_get_current_offset(pkt), 0, "Cursor moved");
+
+	net_pkt_unref(pkt);
+}
+
+/* Returns the offset of the first packet block */
+static size_t check_header(void)
+{
+	size_t offset;
+	int idb_count = 0;
+	int if_count = 0;
+
+	zassert_equal(get_u32(0), PCAPNG_SHB_TYPE, "No section header");
+	zassert_equal(get_u32(4), get_u32(get_u32(4) - 4), "Invalid block length");
+
+	offset = get_u32(4);
+
+	while (offset < pcapng_len && get_u32(offset) == PCAPNG_IDB_TYPE) {
+		idb_count++;
+		offset += get_u32(offset + 4);
+	}
+
+	while (net_if_get_by_index(if_count + 1) != NULL) {
+		if_count++;
+	}
+
+	zassert_equal(idb_count, if_count, "Interface blocks missing");
+
+	return offset;
+}
+
+static int count_packets(size_t offset)
+{
+	int count = 0;
+
+	while (offset < pcapng_len) {
+		zassert_equal(get_u32(offset), PCAPNG_EPB_TYPE, "Not a packet block");
+		count++;
+		offset += get_u32(offset + 4);
+	}
+
+	zassert_equal(offset, pcapng_len, "Truncated packet block");
+
+	return count;
+}
+
+static void capture_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	pcapng_len = 0;
+}
+
+static void capture_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	(void)net_capture_local_stop();
+
+	/* Empty the rings for the next test */
+	(void)net_capture_local_drain(buf_write, NULL);
+}
+
+ZTEST(net_capture_local, test_snaplen_and_format)
+{
+	struct net_capture_local_stats stats;
+	size_t offset;
+	uint32_t cap_len;
+	int ret, i;
+
+	ret = net_capture_local_start(NULL, SNAPLEN);
+	zassert_equal(ret, 0, "Cannot start capture (%d)", ret);
+
+	capture(fake_dev_a_data.iface, BIG_PKT_LEN, NET_CAPTURE_DIR_INBOUND);
+	capture(fake_dev_b_data.iface, SMALL_PKT_LEN + 1, NET_CAPTURE_DIR_OUTBOUND);
+
+	ret = net_capture_local_write_header(buf_write, NULL);
+	zassert_equal(ret, 0, "Cannot write header (%d)", ret);
+
+	offset = check_header();
+
+	ret = net_capture_local_drain(buf_write, NULL);
+	zassert_equal(ret, 2, "Invalid packet count (%d)", ret);
+	zassert_equal(count_packets(offset), 2, "Invalid packet block count");
+
+	/* First packet is truncated to the snap length */
+	zassert_equal(get_u32(offset + 8),
+		      net_if_get_by_iface(fake_dev_a_data.iface) - 1,
+		      "Invalid interface id");
+	zassert_equal(get_u32(offset + 20), SNAPLEN, "Invalid captured length");
+	zassert_equal(get_u32(offset + 24), BIG_PKT_LEN, "Invalid original length");
+
+	for (i = 0; i < SNAPLEN; i++) {
+		zassert_equal(pcapng[offset + PCAPNG_EPB_HDR_LEN + i], (uint8_t)i,
+			      "Invalid data at %d", i);
+	}
+
+	zassert_equal(get_u32(offset + PCAPNG_EPB_HDR_LEN + SNAPLEN),
+		      PCAPNG_EPB_FLAGS_CODE | (sizeof(uint32_t) << 16),
+		      "No flags option");
+	zassert_equal(get_u32(offset + PCAPNG_EPB_HDR_LEN + SNAPLEN + 4),
+		      NET_CAPTURE_DIR_INBOUND, "Invalid direction");
+
+	/* Second packet is shorter than the snap length and padded */
+	offset += get_u32(offset + 4);
+	cap_len = get_u32(offset + 20);
+
+	zassert_equal(get_u32(offset + 8),
+		      net_if_get_by_iface(fake_dev_b_data.iface) - 1,
+		      "Invalid interface id");
+	zassert_equal(cap_len, SMALL_PKT_LEN + 1, "Invalid captured length");
+	zassert_equal(get_u32(offset + PCAPNG_EPB_HDR_LEN +
+			      ROUND_UP(cap_len, sizeof(uint32_t)) + 4),
+		      NET_CAPTURE_DIR_OUTBOUND, "Invalid direction");
+
+	zassert_true(net_capture_local_get_stats(&stats, NULL), "Not running");
+	zassert_equal(stats.captured, 2, "Invalid captured count");
+	zassert_equal(stats.drained, 2, "Invalid drained count");
+	zassert_equal(stats.dropped, 0, "Invalid dropped count");
+}
+
+ZTEST(net_capture_local, test_iface_selection)
+{
+	int ret;
+
+	ret = net_capture_local_start(fake_dev_a_data.iface, 0);
+	zassert_equal(ret, 0, "Cannot start capture (%d)", ret);
+
+	capture(fake_dev_a_data.iface, SMALL_PKT_LEN, NET_CAPTURE_DIR_INBOUND);
+	capture(fake_dev_b_data.iface, SMALL_PKT_LEN, NET_CAPTURE_DIR_INBOUND);
+
+	ret = net_capture_local_stop();
+	zassert_equal(ret, 0, "Cannot stop capture (%d)", ret);
+
+	/* Nothing is stored after stopping */
+	capture(fake_dev_a_data.iface, SMALL_PKT_LEN, NET_CAPTURE_DIR_INBOUND);
+
+	ret = net_capture_local_drain(buf_write, NULL);
+	zassert_equal(ret, 1, "Invalid packet count (%d)", ret);
+	zassert_equal(count_packets(0), 1, "Invalid packet block count");
+	zassert_equal(get_u32(8), net_if_get_by_iface(fake_dev_a_data.iface) - 1,
+		      "Invalid interface id");
+}
+
+static NPF_SIZE_MAX(maxsize_small, SMALL_PKT_LEN);
+static NPF_RULE(small_pkt, NET_OK, maxsize_small);
+
+ZTEST(net_capture_local, test_filter)
+{
+	int ret;
+
+	npf_append_capture_rule(&small_pkt);
+	npf_append_capture_rule(&npf_default_drop);
+
+	ret = net_capture_local_start(NULL, 0);
+	zassert_equal(ret, 0, "Cannot start capture (%d)", ret);
+
+	capture(fake_dev_a_data.iface, BIG_PKT_LEN, NET_CAPTURE_DIR_INBOUND);
+	capture(fake_dev_a_data.iface, SMALL_PKT_LEN, NET_CAPTURE_DIR_INBOUND);
+	capture(fake_dev_a_data.iface, BIG_PKT_LEN, NET_CAPTURE_DIR_OUTBOUND);
+
+	zassert_true(npf_remove_all_capture_rules(), "Rules not removed");
+
+	ret = net_capture_local_drain(buf_write, NULL);
+	zassert_equal(ret, 1, "Invalid packet count (%d)", ret);
+	zassert_equal(get_u32(24), SMALL_PKT_LEN, "Wrong packet captured");
+}
+
+ZTEST(net_capture_local, test_ring_full)
+{
+	struct net_capture_local_stats stats;
+	uint64_t ts, prev_ts = 0;
+	size_t offset = 0;
+	int ret, i;
+
+	ret = net_capture_local_start(NULL, 0);
+	zassert_equal(ret, 0, "Cannot start capture (%d)", ret);
+
+	/* The ring cannot hold all of these, extra packets are dropped */
+	for (i = 0; i < 16; i++) {
+		capture(fake_dev_a_data.iface, BIG_PKT_LEN, NET_CAPTURE_DIR_INBOUND);
+	}
+
+	net_capture_local_get_stats(&stats, NULL);
+	zassert_true(stats.dropped > 0, "No packets dropped");
+	zassert_equal(stats.captured + stats.dropped, 16, "Packets lost");
+
+	ret = net_capture_local_drain(buf_write, NULL);
+	zassert_equal(ret, stats.captured, "Invalid packet count (%d)", ret);
+
+	while (offset < pcapng_len) {
+		ts = ((uint64_t)get_u32(offset + 12) << 32) | get_u32(offset + 16);
+		zassert_true(ts >= prev_ts, "Packets not in timestamp order");
+
+		prev_ts = ts;
+		offset += get_u32(offset + 4);
+	}
+
+	/* The ring has room again after draining */
+	capture(fake_dev_a_data.iface, BIG_PKT_LEN, NET_CAPTURE_DIR_INBOUND);
+
+	net_capture_local_get_stats(&stats, NULL);
+	zassert_equal(stats.captured, ret + 1, "Packet not captured after drain");
+}
+
+ZTEST_SUITE(net_capture_local, NULL, NULL, capture_before, capture_after, NULL);
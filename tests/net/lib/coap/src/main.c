@@ -428,6 +428,58 @@ ZTEST(coap, test_parse_req_build_empty_ack)
 			  "Built packet doesn't match reference packet");
 }
 
+ZTEST(coap, test_parse_payload_after_more_options)
+{
+	/* Observe, Uri-Path "foo", Content-Format 0, Uri-Query "a=b" */
+	uint8_t pdu[] = { 0x42, 0x01, 0x12, 0x34, 't', 'k',
+		       0x60, 0x53, 'f', 'o', 'o', 0x11, 0x00,
+		       0x33, 'a', '=', 'b' };
+	/* Uri-Path "foo" and a payload */
+	uint8_t payload_pdu[] = { 0x42, 0x02, 0x12, 0x35, 't', 'k',
+			       0xb3, 'f', 'o', 'o', 0xff, 'x' };
+	static const uint16_t stale[] = {
+		COAP_OPTION_OBSERVE,
+		COAP_OPTION_CONTENT_FORMAT,
+		COAP_OPTION_URI_QUERY,
+	};
+	struct coap_option options[8];
+	struct coap_option found[4];
+	struct coap_packet cpkt;
+	uint8_t *data = data_buf[0];
+	int r;
+
+	memcpy(data, pdu, sizeof(pdu));
+
+	r = coap_packet_parse(&cpkt, data, sizeof(pdu), options,
+			      ARRAY_SIZE(options));
+	zassert_equal(r, 0, "Could not parse packet");
+
+	memcpy(data, payload_pdu, sizeof(payload_pdu));
+
+	/* The same option array is reused, like a server does */
+	r = coap_packet_parse(&cpkt, data, sizeof(payload_pdu), options,
+			      ARRAY_SIZE(options));
+	zassert_equal(r, 0, "Could not parse packet");
+
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	zassert_equal(cpkt.opt_count, 1, "Wrong option count %u",
+		      cpkt.opt_count);
+#endif
+
+	r = coap_find_options(&cpkt, COAP_OPTION_URI_PATH, found,
+			      ARRAY_SIZE(found));
+	zassert_equal(r, 1, "Uri-Path not found");
+	zassert_equal(found[0].len, 3, "Wrong Uri-Path length");
+	zassert_mem_equal(found[0].value, "foo", 3, "Wrong Uri-Path");
+
+	for (int i = 0; i < ARRAY_SIZE(stale); i++) {
+		r = coap_find_options(&cpkt, stale[i], found,
+				      ARRAY_SIZE(found));
+		zassert_equal(r, 0, "Option %u of the previous request found",
+			      stale[i]);
+	}
+}
+
 ZTEST(coap, test_match_path_uri)
 {
 	const char * const resource_path[] = {
@@ -1261,4 +1313,207 @@ ZTEST(coap, test_build_options_out_of_order_1)
 	zassert_equal(cpkt.offset, 52, "Wrong data size");
 }
 
+#define STREAM_RES_SIZE 300
+
+static uint8_t stream_res[STREAM_RES_SIZE];
+static uint8_t stream_sink_buf[STREAM_RES_SIZE];
+static uint8_t stream_window_buf[3 * 64];
+static uint32_t stream_requests[16];
+static int stream_request_count;
+static size_t stream_received;
+static bool stream_last;
+
+static int stream_request(struct coap_block_stream *stream, uint32_t num)
+{
+	zassert_true(stream_request_count < ARRAY_SIZE(stream_requests), "Too many requests");
+	stream_requests[stream_request_count++] = num;
+
+	return 0;
+}
+
+static int stream_sink(struct coap_block_stream *stream, const uint8_t *data, size_t len,
+		       size_t offset, bool last)
+{
+	zassert_equal(offset, stream_received, "Data not in order");
+	zassert_false(stream_last, "Data after the last block");
+
+	memcpy(stream_sink_buf + offset, data, len);
+	stream_received += len;
+	stream_last = last;
+
+	return 0;
+}
+
+static void stream_init(struct coap_block_stream *stream, enum coap_block_size block_size,
+			uint8_t window, size_t buf_len, size_t offset)
+{
+	struct coap_block_stream_config config = {
+		.request = stream_request,
+		.sink = stream_sink,
+		.block_size = block_size,
+		.window = window,
+		.max_retries = 1,
+		.buf = stream_window_buf,
+		.buf_len = buf_len,
+	};
+	int i, r;
+
+	for (i = 0; i < sizeof(stream_res); i++) {
+		stream_res[i] = i * 7;
+	}
+
+	memset(stream_sink_buf, 0, sizeof(stream_sink_buf));
+	stream_request_count = 0;
+	stream_received = offset;
+	stream_last = false;
+
+	r = coap_block_stream_init(stream, &config, offset);
+	zassert_equal(r, 0, "Could not initialize block stream");
+}
+
+/* Answer the request for block num of the given size */
+static int stream_respond(struct coap_block_stream *stream, uint32_t num,
+			  enum coap_block_size szx, uint8_t code, uint8_t etag)
+{
+	uint8_t buf[COAP_BUF_SIZE];
+	struct coap_packet rsp;
+	uint16_t bytes = coap_block_size_to_bytes(szx);
+	size_t offset = num * bytes;
+	size_t len = MIN(bytes, STREAM_RES_SIZE - offset);
+	bool more = offset + len < STREAM_RES_SIZE;
+	int r;
+
+	r = coap_packet_init(&rsp, buf, sizeof(buf), COAP_VERSION_1, COAP_TYPE_ACK, 0, NULL,
+			     code, coap_next_id());
+	zassert_equal(r, 0, "Could not initialize packet");
+
+	if (code == COAP_RESPONSE_CODE_CONTENT) {
+		r = coap_packet_append_option(&rsp, COAP_OPTION_ETAG, &etag, sizeof(etag));
+		zassert_equal(r, 0, "Could not append ETag");
+
+		r = coap_append_option_int(&rsp, COAP_OPTION_BLOCK2,
+					   (num << 4) | (more << 3) | szx);
+		zassert_equal(r, 0, "Could not append Block2");
+
+		r = coap_append_option_int(&rsp, COAP_OPTION_SIZE2, STREAM_RES_SIZE);
+		zassert_equal(r, 0, "Could not append Size2");
+
+		r = coap_packet_append_payload_marker(&rsp);
+		zassert_equal(r, 0, "Could not append payload marker");
+
+		r = coap_packet_append_payload(&rsp, stream_res + offset, len);
+		zassert_equal(r, 0, "Could not append payload");
+	}
+
+	return coap_block_stream_response(stream, num, &rsp);
+}
+
+ZTEST(coap, test_block_stream_window)
+{
+	struct coap_block_stream stream;
+	int r;
+
+	stream_init(&stream, COAP_BLOCK_64, 4, sizeof(stream_window_buf), 0);
+
+	r = coap_block_stream_start(&stream);
+	zassert_equal(r, 0, "Could not start block stream");
+	zassert_equal(stream_request_count, 1, "Window opened before the size is known");
+	zassert_equal(stream_requests[0], 0, "Wrong first block");
+
+	r = stream_respond(&stream, 0, COAP_BLOCK_64, COAP_RESPONSE_CODE_CONTENT, 1);
+	zassert_equal(r, 0, "Could not handle block 0");
+	zassert_equal(stream.total_size, STREAM_RES_SIZE, "Wrong size");
+	zassert_equal(stream_request_count, 5, "Window not filled");
+	zassert_equal(stream_requests[1], 1, "Wrong block requested");
+	zassert_equal(stream_requests[4], 4, "Wrong block requested");
+
+	/* Out of order and duplicate blocks */
+	zassert_equal(stream_respond(&stream, 3, COAP_BLOCK_64, COAP_RESPONSE_CODE_CONTENT, 1), 0);
+	zassert_equal(stream_respond(&stream, 2, COAP_BLOCK_64, COAP_RESPONSE_CODE_CONTENT, 1), 0);
+	zassert_equal(stream_respond(&stream, 3, COAP_BLOCK_64, COAP_RESPONSE_CODE_CONTENT, 1), 0);
+	zassert_equal(stream_received, 64, "Blocks given to the sink out of order");
+
+	zassert_equal(stream_respond(&stream, 1, COAP_BLOCK_64, COAP_RESPONSE_CODE_CONTENT, 1), 0);
+	zassert_equal(stream_received, 256, "Buffered blocks not given to the sink");
+	zassert_equal(stream_request_count, 5, "Block requested past the end");
+	zassert_false(coap_block_stream_is_complete(&stream), "Complete too early");
+
+	zassert_equal(stream_respond(&stream, 4, COAP_BLOCK_64, COAP_RESPONSE_CODE_CONTENT, 1), 0);
+	zassert_true(coap_block_stream_is_complete(&stream), "Transfer not complete");
+	zassert_true(stream_last, "Last block not flagged");
+	zassert_mem_equal(stream_sink_buf, stream_res, STREAM_RES_SIZE, "Wrong data");
+}
+
+ZTEST(coap, test_block_stream_lost)
+{
+	struct coap_block_stream stream;
+	int r;
+
+	stream_init(&stream, COAP_BLOCK_64, 2, 64, 0);
+
+	zassert_equal(coap_block_stream_start(&stream), 0);
+	zassert_equal(stream_respond(&stream, 0, COAP_BLOCK_64, COAP_RESPONSE_CODE_CONTENT, 1), 0);
+	zassert_equal(stream_request_count, 3, "Window not filled");
+
+	r = coap_block_stream_lost(&stream, 2);
+	zassert_equal(r, 0, "Could not retry block 2");
+	zassert_equal(stream_request_count, 4, "Lost block not requested again");
+	zassert_equal(stream_requests[3], 2, "Wrong block requested again");
+
+	r = coap_block_stream_lost(&stream, 2);
+	zassert_equal(r, -ETIMEDOUT, "Retries not limited");
+
+	/* A busy server makes the stream fall back to stop-and-wait */
+	stream_init(&stream, COAP_BLOCK_64, 2, 64, 0);
+
+	zassert_equal(coap_block_stream_start(&stream), 0);
+	zassert_equal(stream_respond(&stream, 0, COAP_BLOCK_64, COAP_RESPONSE_CODE_CONTENT, 1), 0);
+
+	r = stream_respond(&stream, 1, COAP_BLOCK_64, COAP_RESPONSE_CODE_SERVICE_UNAVAILABLE, 1);
+	zassert_equal(r, 0, "Could not fall back to stop-and-wait");
+	zassert_equal(stream_request_count, 4, "Refused block not requested again");
+	zassert_equal(stream_requests[3], 1, "Wrong block requested again");
+
+	zassert_equal(stream_respond(&stream, 2, COAP_BLOCK_64, COAP_RESPONSE_CODE_CONTENT, 1), 0);
+	zassert_equal(stream_respond(&stream, 1, COAP_BLOCK_64, COAP_RESPONSE_CODE_CONTENT, 1), 0);
+	zassert_equal(stream_request_count, 5, "More than one request in flight");
+	zassert_equal(stream_requests[4], 3, "Wrong block requested");
+
+	zassert_equal(stream_respond(&stream, 3, COAP_BLOCK_64, COAP_RESPONSE_CODE_CONTENT, 1), 0);
+	zassert_equal(stream_respond(&stream, 4, COAP_BLOCK_64, COAP_RESPONSE_CODE_CONTENT, 1), 0);
+	zassert_true(coap_block_stream_is_complete(&stream), "Transfer not complete");
+	zassert_mem_equal(stream_sink_buf, stream_res, STREAM_RES_SIZE, "Wrong data");
+
+	r = stream_respond(&stream, 0, COAP_BLOCK_64, COAP_RESPONSE_CODE_NOT_FOUND, 1);
+	zassert_equal(r, 0, "Response after the end not ignored");
+}
+
+ZTEST(coap, test_block_stream_negotiation)
+{
+	struct coap_block_stream stream;
+	int r;
+
+	/* No room to buffer a 128 bytes block, but one of 64 bytes */
+	stream_init(&stream, COAP_BLOCK_128, 2, 64, 130);
+	zassert_equal(stream.offset, 128, "Offset not rounded down to the block size");
+	stream_received = 128;
+
+	zassert_equal(coap_block_stream_start(&stream), 0);
+	zassert_equal(stream_requests[0], 1, "Download not resumed");
+
+	/* The server picks a smaller block size */
+	r = stream_respond(&stream, 2, COAP_BLOCK_64, COAP_RESPONSE_CODE_CONTENT, 1);
+	zassert_equal(r, 0, "Could not handle a smaller block size");
+	zassert_equal(stream_received, 192, "Block not given to the sink");
+	zassert_equal(stream_request_count, 3, "Window not resized");
+	zassert_equal(stream_requests[1], 3, "Wrong block requested");
+	zassert_equal(stream_requests[2], 4, "Wrong block requested");
+
+	r = stream_respond(&stream, 4, COAP_BLOCK_64, COAP_RESPONSE_CODE_CONTENT, 2);
+	zassert_equal(r, -ESTALE, "Resource change not detected");
+
+	r = stream_respond(&stream, 6, COAP_BLOCK_32, COAP_RESPONSE_CODE_CONTENT, 1);
+	zassert_equal(r, -EPROTO, "Block size change not detected");
+}
+
 ZTEST_SUITE(coap, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,598 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+
+#include <zephyr/ztest.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/coap.h>
+#include <zephyr/net/coap_service.h>
+#include <zephyr/sys/byteorder.h>
+
+#define SERVER_ADDR "127.0.0.1"
+#define RECV_TIMEOUT_MS 2500
+#define BENCH_REQUESTS 200
+#define FW_SIZE 4096
+#define FW_BLOCK_SIZE COAP_BLOCK_64
+#define FW_LATENCY_MS 10
+#define FW_WINDOW 4
+
+static uint16_t test_port;
+COAP_SERVICE_DEFINE(test_service, SERVER_ADDR, &test_port, 0);
+
+static const char * const hello_path[] = { "hello", NULL };
+static const char * const count_path[] = { "count", NULL };
+static const char * const separate_path[] = { "separate", NULL };
+static const char * const obs_path[] = { "obs", NULL };
+static const char * const exact_path[] = { "a", "b", NULL };
+static const char * const wildcard_path[] = { "a", "+", "c", NULL };
+static const char * const fw_path[] = { "fw", NULL };
+
+static int get_count;
+
+static struct sockaddr separate_addr;
+static uint8_t separate_token[COAP_TOKEN_MAX_LEN];
+static uint8_t separate_tkl;
+
+/* Piggybacked response to a confirmable request, NON response otherwise */
+static int reply(struct coap_resource *resource, const struct coap_packet *request,
+		 const struct sockaddr *addr, socklen_t addr_len, const char *payload,
+		 int observe)
+{
+	struct coap_packet response;
+	uint8_t token[COAP_TOKEN_MAX_LEN];
+	uint8_t buf[64];
+	uint8_t tkl;
+	int ret;
+
+	if (coap_header_get_type(request) == COAP_TYPE_CON) {
+		ret = coap_ack_init(&response, request, buf, sizeof(buf),
+				    COAP_RESPONSE_CODE_CONTENT);
+	} else {
+		tkl = coap_header_get_token(request, token);
+		ret = coap_packet_init(&response, buf, sizeof(buf), COAP_VERSION_1,
+				       COAP_TYPE_NON_CON, tkl, token, COAP_RESPONSE_CODE_CONTENT,
+				       coap_next_id());
+	}
+
+	if (ret == 0 && observe >= 0) {
+		ret = coap_append_option_int(&response, COAP_OPTION_OBSERVE, observe);
+	}
+
+	if (ret == 0 && payload) {
+		ret = coap_packet_append_payload_marker(&response);
+		if (ret == 0) {
+			ret = coap_packet_append_payload(&response, (const uint8_t *)payload,
+							  strlen(payload));
+		}
+	}
+
+	if (ret < 0) {
+		return ret;
+	}
+
+	return coap_resource_send(resource, &response, addr, addr_len);
+}
+
+static int hello_get(struct coap_resource *resource, struct coap_packet *request,
+		     struct sockaddr *addr, socklen_t addr_len)
+{
+	return reply(resource, request, addr, addr_len, "hello", -1);
+}
+
+static int count_get(struct coap_resource *resource, struct coap_packet *request,
+		     struct sockaddr *addr, socklen_t addr_len)
+{
+	get_count++;
+
+	return reply(resource, request, addr, addr_len, NULL, -1);
+}
+
+static int exact_get(struct coap_resource *resource, struct coap_packet *request,
+		     struct sockaddr *addr, socklen_t addr_len)
+{
+	return reply(resource, request, addr, addr_len, "exact", -1);
+}
+
+static int wildcard_get(struct coap_resource *resource, struct coap_packet *request,
+			struct sockaddr *addr, socklen_t addr_len)
+{
+	return reply(resource, request, addr, addr_len, "wildcard", -1);
+}
+
+/* Nothing is sent, the response follows from the test */
+static int separate_get(struct coap_resource *resource, struct coap_packet *request,
+			struct sockaddr *addr, socklen_t addr_len)
+{
+	ARG_UNUSED(resource);
+	ARG_UNUSED(addr_len);
+
+	memcpy(&separate_addr, addr, sizeof(separate_addr));
+	separate_tkl = coap_header_get_token(request, separate_token);
+
+	return 0;
+}
+
+static int obs_get(struct coap_resource *resource, struct coap_packet *request,
+		   struct sockaddr *addr, socklen_t addr_len)
+{
+	int observe;
+
+	observe = coap_resource_parse_observe(resource, request, addr);
+	if (observe < 0 && observe != -ENOENT) {
+		return observe;
+	}
+
+	return reply(resource, request, addr, addr_len, "obs", observe == 0 ? resource->age : -1);
+}
+
+static void obs_notify(struct coap_resource *resource, struct coap_observer *observer)
+{
+	struct coap_packet notification;
+	uint8_t buf[32];
+	int ret;
+
+	ret = coap_packet_init(&notification, buf, sizeof(buf), COAP_VERSION_1, COAP_TYPE_CON,
+			       observer->tkl, observer->token, COAP_RESPONSE_CODE_CONTENT,
+			       coap_next_id());
+	zassert_ok(ret, "Cannot create notification");
+	zassert_ok(coap_append_option_int(&notification, COAP_OPTION_OBSERVE, resource->age));
+
+	zassert_ok(coap_resource_send(resource, &notification, &observer->addr,
+				      sizeof(struct sockaddr_in)), "Cannot send notification");
+}
+
+static uint8_t fw_byte(size_t offset)
+{
+	return (uint8_t)(offset * 31U + (offset >> 8));
+}
+
+/* Block2 download of FW_SIZE generated bytes */
+static int fw_get(struct coap_resource *resource, struct coap_packet *request,
+		  struct sockaddr *addr, socklen_t addr_len)
+{
+	struct coap_packet response;
+	uint8_t buf[128];
+	uint8_t data[64];
+	int block, szx, num, ret;
+	size_t offset, len, i;
+
+	block = coap_get_option_int(request, COAP_OPTION_BLOCK2);
+	szx = block < 0 ? FW_BLOCK_SIZE : MIN(block & 0x07, FW_BLOCK_SIZE);
+	num = block < 0 ? 0 : block >> 4;
+	offset = num * coap_block_size_to_bytes(szx);
+	len = MIN(coap_block_size_to_bytes(szx), FW_SIZE - MIN(offset, FW_SIZE));
+
+	for (i = 0; i < len; i++) {
+		data[i] = fw_byte(offset + i);
+	}
+
+	ret = coap_ack_init(&response, request, buf, sizeof(buf), COAP_RESPONSE_CODE_CONTENT);
+	if (ret == 0) {
+		ret = coap_append_option_int(&response, COAP_OPTION_BLOCK2,
+					     (num << 4) | ((offset + len < FW_SIZE) << 3) | szx);
+	}
+
+	if (ret == 0) {
+		ret = coap_append_option_int(&response, COAP_OPTION_SIZE2, FW_SIZE);
+	}
+
+	if (ret == 0) {
+		ret = coap_packet_append_payload_marker(&response);
+	}
+
+	if (ret == 0) {
+		ret = coap_packet_append_payload(&response, data, len);
+	}
+
+	if (ret < 0) {
+		return ret;
+	}
+
+	return coap_resource_send(resource, &response, addr, addr_len);
+}
+
+COAP_RESOURCE_DEFINE(hello_resource, test_service, {
+	.get = hello_get,
+	.path = hello_path,
+});
+
+COAP_RESOURCE_DEFINE(count_resource, test_service, {
+	.get = count_get,
+	.path = count_path,
+});
+
+COAP_RESOURCE_DEFINE(wildcard_resource, test_service, {
+	.get = wildcard_get,
+	.path = wildcard_path,
+});
+
+COAP_RESOURCE_DEFINE(exact_resource, test_service, {
+	.get = exact_get,
+	.path = exact_path,
+});
+
+COAP_RESOURCE_DEFINE(separate_resource, test_service, {
+	.get = separate_get,
+	.path = separate_path,
+});
+
+COAP_RESOURCE_DEFINE(obs_resource, test_service, {
+	.get = obs_get,
+	.notify = obs_notify,
+	.path = obs_path,
+});
+
+COAP_RESOURCE_DEFINE(fw_resource, test_service, {
+	.get = fw_get,
+	.path = fw_path,
+});
+
+static int client_fd = -1;
+static uint8_t client_buf[128];
+static int client_len;
+static uint8_t recv_buf[128];
+static int recv_len;
+
+static void client_send(uint8_t type, uint8_t code, uint16_t id, const char * const *path,
+			int observe)
+{
+	struct coap_packet request;
+	int ret;
+
+	ret = coap_packet_init(&request, client_buf, sizeof(client_buf), COAP_VERSION_1, type,
+			       COAP_TOKEN_MAX_LEN, coap_next_token(), code, id);
+	zassert_ok(ret, "Cannot create request");
+
+	if (observe >= 0) {
+		zassert_ok(coap_append_option_int(&request, COAP_OPTION_OBSERVE, observe));
+	}
+
+	for (; path && *path; path++) {
+		ret = coap_packet_append_option(&request, COAP_OPTION_URI_PATH,
+						(const uint8_t *)*path, strlen(*path));
+		zassert_ok(ret, "Cannot add path");
+	}
+
+	client_len = request.offset;
+
+	zassert_equal(zsock_send(client_fd, client_buf, client_len, 0), client_len,
+		      "Cannot send (%d)", errno);
+}
+
+static void client_send_empty(uint8_t type, uint16_t id)
+{
+	struct coap_packet msg;
+
+	zassert_ok(coap_packet_init(&msg, client_buf, sizeof(client_buf), COAP_VERSION_1, type,
+				    0, NULL, COAP_CODE_EMPTY, id));
+	zassert_equal(zsock_send(client_fd, client_buf, msg.offset, 0), msg.offset,
+		      "Cannot send (%d)", errno);
+}
+
+static void client_recv(struct coap_packet *response)
+{
+	recv_len = zsock_recv(client_fd, recv_buf, sizeof(recv_buf), 0);
+	zassert_true(recv_len > 0, "No response (%d)", errno);
+
+	zassert_ok(coap_packet_parse(response, recv_buf, recv_len, NULL, 0),
+		   "Invalid response");
+}
+
+static void expect_response(uint8_t type, uint8_t code, uint16_t id, const char *payload)
+{
+	struct coap_packet response;
+	const uint8_t *data;
+	uint16_t len;
+
+	client_recv(&response);
+
+	zassert_equal(coap_header_get_type(&response), type, "Wrong type");
+	zassert_equal(coap_header_get_code(&response), code, "Wrong code 0x%02x",
+		      coap_header_get_code(&response));
+
+	if (type == COAP_TYPE_ACK) {
+		zassert_equal(coap_header_get_id(&response), id, "Wrong message id");
+	}
+
+	if (payload) {
+		data = coap_packet_get_payload(&response, &len);
+		zassert_equal(len, strlen(payload), "Wrong payload length");
+		zassert_mem_equal(data, payload, len, "Wrong payload");
+	}
+}
+
+static void *coap_server_setup(void)
+{
+	zassert_ok(coap_service_start(&test_service), "Cannot start service");
+	zassert_not_equal(test_port, 0, "Ephemeral port not set");
+
+	return NULL;
+}
+
+static void coap_server_teardown(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	zassert_ok(coap_service_stop(&test_service), "Cannot stop service");
+	zassert_false(coap_service_is_running(&test_service), "Service still running");
+}
+
+static void coap_server_before(void *fixture)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(test_port),
+	};
+	struct timeval optval = {
+		.tv_sec = RECV_TIMEOUT_MS / MSEC_PER_SEC,
+		.tv_usec = (RECV_TIMEOUT_MS % MSEC_PER_SEC) * USEC_PER_MSEC,
+	};
+
+	ARG_UNUSED(fixture);
+
+	zsock_inet_pton(AF_INET, SERVER_ADDR, &addr.sin_addr);
+
+	client_fd = zsock_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	zassert_true(client_fd >= 0, "Cannot create socket (%d)", errno);
+
+	zassert_ok(zsock_setsockopt(client_fd, SOL_SOCKET, SO_RCVTIMEO, &optval, sizeof(optval)),
+		   "Cannot set receive timeout");
+	zassert_ok(zsock_connect(client_fd, (struct sockaddr *)&addr, sizeof(addr)),
+		   "Cannot connect (%d)", errno);
+
+	get_count = 0;
+}
+
+static void coap_server_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	if (client_fd >= 0) {
+		(void)zsock_close(client_fd);
+		client_fd = -1;
+	}
+}
+
+ZTEST(coap_server, test_dispatch)
+{
+	static const char * const wildcard_req[] = { "a", "x", "c", NULL };
+	static const char * const missing_req[] = { "a", "x", NULL };
+	uint16_t id;
+
+	id = coap_next_id();
+	client_send(COAP_TYPE_CON, COAP_METHOD_GET, id, hello_path, -1);
+	expect_response(COAP_TYPE_ACK, COAP_RESPONSE_CODE_CONTENT, id, "hello");
+
+	/* The exact path is preferred over the wildcard defined before it */
+	id = coap_next_id();
+	client_send(COAP_TYPE_CON, COAP_METHOD_GET, id, exact_path, -1);
+	expect_response(COAP_TYPE_ACK, COAP_RESPONSE_CODE_CONTENT, id, "exact");
+
+	id = coap_next_id();
+	client_send(COAP_TYPE_CON, COAP_METHOD_GET, id, wildcard_req, -1);
+	expect_response(COAP_TYPE_ACK, COAP_RESPONSE_CODE_CONTENT, id, "wildcard");
+
+	id = coap_next_id();
+	client_send(COAP_TYPE_CON, COAP_METHOD_GET, id, missing_req, -1);
+	expect_response(COAP_TYPE_ACK, COAP_RESPONSE_CODE_NOT_FOUND, id, NULL);
+
+	id = coap_next_id();
+	client_send(COAP_TYPE_CON, COAP_METHOD_POST, id, hello_path, -1);
+	expect_response(COAP_TYPE_ACK, COAP_RESPONSE_CODE_NOT_ALLOWED, id, NULL);
+
+	client_send(COAP_TYPE_NON_CON, COAP_METHOD_GET, coap_next_id(), hello_path, -1);
+	expect_response(COAP_TYPE_NON_CON, COAP_RESPONSE_CODE_CONTENT, 0, "hello");
+
+	/* A ping is answered with a reset */
+	id = coap_next_id();
+	client_send_empty(COAP_TYPE_CON, id);
+	expect_response(COAP_TYPE_RESET, COAP_CODE_EMPTY, id, NULL);
+}
+
+ZTEST(coap_server, test_deduplication)
+{
+	uint8_t first[sizeof(recv_buf)];
+	int first_len;
+	uint16_t id = coap_next_id();
+
+	client_send(COAP_TYPE_CON, COAP_METHOD_GET, id, count_path, -1);
+	expect_response(COAP_TYPE_ACK, COAP_RESPONSE_CODE_CONTENT, id, NULL);
+
+	memcpy(first, recv_buf, recv_len);
+	first_len = recv_len;
+
+	/* Same message id, as if the ACK was lost */
+	zassert_equal(zsock_send(client_fd, client_buf, client_len, 0), client_len,
+		      "Cannot send (%d)", errno);
+	expect_response(COAP_TYPE_ACK, COAP_RESPONSE_CODE_CONTENT, id, NULL);
+
+	zassert_equal(recv_len, first_len, "Different ACK length");
+	zassert_mem_equal(recv_buf, first, first_len, "Different ACK");
+	zassert_equal(get_count, 1, "Handler called for a duplicate");
+
+	id = coap_next_id();
+	client_send(COAP_TYPE_CON, COAP_METHOD_GET, id, count_path, -1);
+	expect_response(COAP_TYPE_ACK, COAP_RESPONSE_CODE_CONTENT, id, NULL);
+	zassert_equal(get_count, 2, "Handler not called for a new request");
+}
+
+ZTEST(coap_server, test_separate_response)
+{
+	struct coap_packet response;
+	uint8_t buf[32];
+	uint16_t id = coap_next_id();
+	uint16_t response_id;
+
+	client_send(COAP_TYPE_CON, COAP_METHOD_GET, id, separate_path, -1);
+
+	/* Empty ACK first, the handler did not answer */
+	expect_response(COAP_TYPE_ACK, COAP_CODE_EMPTY, id, NULL);
+
+	zassert_ok(coap_packet_init(&response, buf, sizeof(buf), COAP_VERSION_1, COAP_TYPE_CON,
+				    separate_tkl, separate_token, COAP_RESPONSE_CODE_CONTENT,
+				    coap_next_id()));
+	zassert_ok(coap_resource_send(&separate_resource, &response, &separate_addr,
+				      sizeof(struct sockaddr_in)));
+
+	expect_response(COAP_TYPE_CON, COAP_RESPONSE_CODE_CONTENT, 0, NULL);
+	response_id = coap_header_get_id(&response);
+
+	/* Not acknowledged, it is retransmitted */
+	client_recv(&response);
+	zassert_equal(coap_header_get_id(&response), response_id, "Not a retransmission");
+
+	client_send_empty(COAP_TYPE_ACK, response_id);
+
+	zassert_true(zsock_recv(client_fd, recv_buf, sizeof(recv_buf), 0) < 0,
+		     "Retransmitted after the ACK");
+}
+
+ZTEST(coap_server, test_observe)
+{
+	struct coap_packet notification;
+	uint16_t id = coap_next_id();
+
+	client_send(COAP_TYPE_CON, COAP_METHOD_GET, id, obs_path, 0);
+	expect_response(COAP_TYPE_ACK, COAP_RESPONSE_CODE_CONTENT, id, "obs");
+
+	zassert_false(sys_slist_is_empty(&obs_resource.observers), "Observer not registered");
+
+	zassert_ok(coap_resource_notify(&obs_resource), "Cannot notify");
+
+	client_recv(&notification);
+	zassert_equal(coap_header_get_type(&notification), COAP_TYPE_CON, "Wrong type");
+	zassert_equal(coap_get_option_int(&notification, COAP_OPTION_OBSERVE), obs_resource.age,
+		      "Wrong sequence number");
+
+	/* Rejecting the notification ends the observation */
+	client_send_empty(COAP_TYPE_RESET, coap_header_get_id(&notification));
+	k_msleep(100);
+
+	zassert_true(sys_slist_is_empty(&obs_resource.observers), "Observer not removed");
+}
+
+ZTEST(coap_server, test_request_rate)
+{
+	int64_t start, elapsed;
+	uint16_t id;
+	int i;
+
+	start = k_uptime_get();
+
+	for (i = 0; i < BENCH_REQUESTS; i++) {
+		id = coap_next_id();
+		client_send(COAP_TYPE_CON, COAP_METHOD_GET, id, exact_path, -1);
+		expect_response(COAP_TYPE_ACK, COAP_RESPONSE_CODE_CONTENT, id, "exact");
+	}
+
+	elapsed = MAX(k_uptime_get() - start, 1);
+
+	TC_PRINT("%d requests in %lld ms, %lld requests/s\n", BENCH_REQUESTS,
+		 (long long)elapsed, (long long)(BENCH_REQUESTS * MSEC_PER_SEC / elapsed));
+}
+
+/* Time at which the response to a block request may be handled */
+static int64_t fw_deadline[COAP_BLOCK_STREAM_MAX_WINDOW];
+
+static int fw_request(struct coap_block_stream *stream, uint32_t num)
+{
+	struct coap_packet request;
+	uint8_t token[sizeof(num)];
+	int ret;
+
+	sys_put_be32(num, token);
+
+	ret = coap_packet_init(&request, client_buf, sizeof(client_buf), COAP_VERSION_1,
+			       COAP_TYPE_CON, sizeof(token), token, COAP_METHOD_GET,
+			       coap_next_id());
+	zassert_ok(ret, "Cannot create request");
+	zassert_ok(coap_packet_append_option(&request, COAP_OPTION_URI_PATH,
+					     (const uint8_t *)fw_path[0], strlen(fw_path[0])));
+	zassert_ok(coap_block_stream_append_option(stream, &request, num));
+	zassert_ok(coap_append_option_int(&request, COAP_OPTION_SIZE2, 0));
+
+	fw_deadline[num % COAP_BLOCK_STREAM_MAX_WINDOW] = k_uptime_get() + FW_LATENCY_MS;
+
+	zassert_equal(zsock_send(client_fd, client_buf, request.offset, 0), request.offset,
+		      "Cannot send (%d)", errno);
+
+	return 0;
+}
+
+static int fw_sink(struct coap_block_stream *stream, const uint8_t *data, size_t len,
+		   size_t offset, bool last)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		zassert_equal(data[i], fw_byte(offset + i), "Wrong data at %zu", offset + i);
+	}
+
+	zassert_equal(last, offset + len == FW_SIZE, "Wrong last block");
+
+	return 0;
+}
+
+/* Download the firmware resource with the responses delayed to simulate a
+ * link of FW_LATENCY_MS round trip time.
+ */
+static int64_t fw_download(uint8_t window)
+{
+	static uint8_t window_buf[(FW_WINDOW - 1) * 64];
+	struct coap_block_stream_config config = {
+		.request = fw_request,
+		.sink = fw_sink,
+		.block_size = FW_BLOCK_SIZE,
+		.window = window,
+		.buf = window_buf,
+		.buf_len = sizeof(window_buf),
+	};
+	struct coap_block_stream stream;
+	struct coap_packet response;
+	uint8_t token[COAP_TOKEN_MAX_LEN];
+	int64_t start, wait;
+	uint32_t num;
+
+	start = k_uptime_get();
+
+	zassert_ok(coap_block_stream_init(&stream, &config, 0));
+	zassert_ok(coap_block_stream_start(&stream));
+
+	while (!coap_block_stream_is_complete(&stream)) {
+		client_recv(&response);
+		zassert_equal(coap_header_get_token(&response, token), sizeof(num), "Wrong token");
+		num = sys_get_be32(token);
+
+		wait = fw_deadline[num % COAP_BLOCK_STREAM_MAX_WINDOW] - k_uptime_get();
+		if (wait > 0) {
+			k_msleep(wait);
+		}
+
+		zassert_ok(coap_block_stream_response(&stream, num, &response),
+			   "Cannot handle block %u", num);
+	}
+
+	zassert_equal(stream.offset, FW_SIZE, "Wrong size downloaded");
+	zassert_equal(stream.total_size, FW_SIZE, "Wrong size announced");
+
+	return MAX(k_uptime_get() - start, 1);
+}
+
+ZTEST(coap_server, test_block_stream_window)
+{
+	int64_t stop_and_wait, windowed;
+
+	stop_and_wait = fw_download(1);
+	windowed = fw_download(FW_WINDOW);
+
+	TC_PRINT("%d bytes with %d ms latency: %lld ms stop-and-wait, %lld ms with %d blocks "
+		 "in flight\n", FW_SIZE, FW_LATENCY_MS, (long long)stop_and_wait,
+		 (long long)windowed, FW_WINDOW);
+
+	zassert_true(windowed < stop_and_wait, "No gain from the window");
+}
+
+ZTEST_SUITE(coap_server, NULL, coap_server_setup, coap_server_before,
+	    coap_server_after, coap_server_teardown);
@@ -0,0 +1,301 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_DNS_RESOLVER_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/dns_resolve.h>
+
+#define SERVER_PORT 15353
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACK_SIZE)
+#define THREAD_PRIORITY K_PRIO_COOP(2)
+#define QUERY_TIMEOUT 1000 /* ms */
+#define MAX_MSG_SIZE 256
+
+#define DNS_HEADER_LEN 12
+#define DNS_RCODE_NAMEERROR 3
+
+/* Names with these first labels get special answers from the responder */
+#define SHORT_TTL_LABEL "short"
+#define NXDOMAIN_LABEL "nx"
+
+#define ANSWER_ADDR { { { 192, 0, 2, 1 } } }
+#define ANSWER_TTL 300
+#define SHORT_TTL 1
+
+static int server_sock;
+static int queries_received;
+
+struct resolve_result {
+	struct k_sem done;
+	enum dns_resolve_status status;
+	struct in_addr addr;
+	int count;
+};
+
+static struct resolve_result result;
+
+static bool first_label_is(const uint8_t *msg, const char *label)
+{
+	size_t len = strlen(label);
+
+	return msg[DNS_HEADER_LEN] == len &&
+		memcmp(&msg[DNS_HEADER_LEN + 1], label, len) == 0;
+}
+
+/* Turn the query into a response by echoing the question and appending
+ * one A record pointing back to the question name.
+ */
+static int build_response(uint8_t *msg, int len)
+{
+	struct in_addr answer = ANSWER_ADDR;
+	uint32_t ttl = ANSWER_TTL;
+
+	/* Response, recursion desired and available */
+	msg[2] = 0x81;
+	msg[3] = 0x80;
+
+	if (first_label_is(msg, NXDOMAIN_LABEL)) {
+		msg[3] |= DNS_RCODE_NAMEERROR;
+		return len;
+	}
+
+	if (first_label_is(msg, SHORT_TTL_LABEL)) {
+		ttl = SHORT_TTL;
+	}
+
+	UNALIGNED_PUT(htons(1), (uint16_t *)&msg[6]);
+
+	/* Compressed name pointing to the question */
+	msg[len++] = 0xc0;
+	msg[len++] = DNS_HEADER_LEN;
+	UNALIGNED_PUT(htons(1), (uint16_t *)&msg[len]); /* type A */
+	len += sizeof(uint16_t);
+	UNALIGNED_PUT(htons(1), (uint16_t *)&msg[len]); /* class IN */
+	len += sizeof(uint16_t);
+	UNALIGNED_PUT(htonl(ttl), (uint32_t *)&msg[len]);
+	len += sizeof(uint32_t);
+	UNALIGNED_PUT(htons(sizeof(answer)), (uint16_t *)&msg[len]);
+	len += sizeof(uint16_t);
+	memcpy(&msg[len], &answer, sizeof(answer));
+	len += sizeof(answer);
+
+	return len;
+}
+
+static void dns_responder(void)
+{
+	static uint8_t msg[MAX_MSG_SIZE];
+	struct sockaddr_in client;
+	socklen_t client_len;
+	int len;
+
+	while (true) {
+		client_len = sizeof(client);
+
+		len = recvfrom(server_sock, msg, sizeof(msg), 0,
+			       (struct sockaddr *)&client, &client_len);
+		if (len <= DNS_HEADER_LEN ||
+		    len > sizeof(msg) - 16) {
+			continue;
+		}
+
+		queries_received++;
+
+		len = build_response(msg, len);
+
+		(void)sendto(server_sock, msg, len, 0,
+			     (struct sockaddr *)&client, client_len);
+	}
+}
+
+K_THREAD_DEFINE(dns_responder_id, STACK_SIZE,
+		dns_responder, NULL, NULL, NULL,
+		THREAD_PRIORITY, 0, -1);
+
+static void resolve_cb(enum dns_resolve_status status,
+		       struct dns_addrinfo *info, void *user_data)
+{
+	struct resolve_result *res = user_data;
+
+	if (status == DNS_EAI_INPROGRESS && info) {
+		net_ipaddr_copy(&res->addr, &net_sin(&info->ai_addr)->sin_addr);
+		res->count++;
+		return;
+	}
+
+	res->status = status;
+	k_sem_give(&res->done);
+}
+
+static void count_cb(const char *name, enum dns_query_type type,
+		     int addr_count, uint32_t ttl, void *user_data)
+{
+	(*(int *)user_data)++;
+}
+
+static int resolve(const char *name)
+{
+	int ret;
+
+	result.count = 0;
+	result.status = DNS_EAI_SYSTEM;
+
+	ret = dns_get_addr_info(name, DNS_QUERY_TYPE_A, NULL, resolve_cb,
+				&result, QUERY_TIMEOUT);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (k_sem_take(&result.done, K_MSEC(2 * QUERY_TIMEOUT)) < 0) {
+		return -ETIMEDOUT;
+	}
+
+	return result.status;
+}
+
+static void *dns_cache_setup(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+		.sin_addr = INADDR_LOOPBACK_INIT,
+	};
+	int ret;
+
+	k_sem_init(&result.done, 0, 1);
+
+	server_sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	zassert_true(server_sock >= 0, "Cannot create socket (%d)", errno);
+
+	ret = bind(server_sock, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_equal(ret, 0, "Cannot bind socket (%d)", errno);
+
+	k_thread_start(dns_responder_id);
+	k_yield();
+
+	return NULL;
+}
+
+static void dns_cache_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	(void)dns_resolve_cache_flush();
+	queries_received = 0;
+}
+
+ZTEST(net_dns_cache, test_positive_answer)
+{
+	struct dns_resolve_cache_stats before, after;
+	struct in_addr expected = ANSWER_ADDR;
+	int ret;
+
+	zassert_ok(dns_resolve_cache_get_stats(&before), "Cannot get stats");
+
+	ret = resolve("www.example.com");
+	zassert_equal(ret, DNS_EAI_ALLDONE, "Resolve failed (%d)", ret);
+	zassert_equal(queries_received, 1, "Query not sent");
+
+	ret = resolve("WWW.Example.com");
+	zassert_equal(ret, DNS_EAI_ALLDONE, "Resolve failed (%d)", ret);
+	zassert_equal(queries_received, 1, "Cached answer not used");
+	zassert_equal(result.count, 1, "Wrong number of addresses");
+	zassert_true(net_ipv4_addr_cmp(&result.addr, &expected),
+		     "Wrong cached address");
+
+	zassert_ok(dns_resolve_cache_get_stats(&after), "Cannot get stats");
+	zassert_equal(after.hits - before.hits, 1, "Wrong hit count");
+	zassert_equal(after.misses - before.misses, 1, "Wrong miss count");
+	zassert_equal(after.insertions - before.insertions, 1,
+		      "Wrong insertion count");
+}
+
+ZTEST(net_dns_cache, test_ttl_expiry)
+{
+	int ret;
+
+	ret = resolve(SHORT_TTL_LABEL ".example.com");
+	zassert_equal(ret, DNS_EAI_ALLDONE, "Resolve failed (%d)", ret);
+
+	ret = resolve(SHORT_TTL_LABEL ".example.com");
+	zassert_equal(ret, DNS_EAI_ALLDONE, "Resolve failed (%d)", ret);
+	zassert_equal(queries_received, 1, "Cached answer not used");
+
+	k_msleep(SHORT_TTL * MSEC_PER_SEC + 100);
+
+	ret = resolve(SHORT_TTL_LABEL ".example.com");
+	zassert_equal(ret, DNS_EAI_ALLDONE, "Resolve failed (%d)", ret);
+	zassert_equal(queries_received, 2, "Expired answer was used");
+}
+
+ZTEST(net_dns_cache, test_negative_answer)
+{
+	struct dns_resolve_cache_stats before, after;
+	int ret;
+
+	zassert_ok(dns_resolve_cache_get_stats(&before), "Cannot get stats");
+
+	ret = resolve(NXDOMAIN_LABEL ".example.com");
+	zassert_equal(ret, DNS_EAI_NODATA, "Unexpected status (%d)", ret);
+
+	ret = resolve(NXDOMAIN_LABEL ".example.com");
+	zassert_equal(ret, DNS_EAI_NODATA, "Unexpected status (%d)", ret);
+	zassert_equal(queries_received, 1, "Negative answer not cached");
+	zassert_equal(result.count, 0, "Negative answer has addresses");
+
+	zassert_ok(dns_resolve_cache_get_stats(&after), "Cannot get stats");
+	zassert_equal(after.negative_hits - before.negative_hits, 1,
+		      "Wrong negative hit count");
+}
+
+ZTEST(net_dns_cache, test_flush)
+{
+	int count = 0;
+	int ret;
+
+	ret = resolve("flush.example.com");
+	zassert_equal(ret, DNS_EAI_ALLDONE, "Resolve failed (%d)", ret);
+
+	zassert_ok(dns_resolve_cache_flush(), "Cannot flush cache");
+	zassert_equal(dns_resolve_cache_foreach(count_cb, &count), 0,
+		      "Cache not empty");
+	zassert_equal(count, 0, "Flushed answer reported");
+
+	ret = resolve("flush.example.com");
+	zassert_equal(ret, DNS_EAI_ALLDONE, "Resolve failed (%d)", ret);
+	zassert_equal(queries_received, 2, "Flushed answer was used");
+}
+
+ZTEST(net_dns_cache, test_eviction)
+{
+	struct dns_resolve_cache_stats before, after;
+	char name[sizeof("hostNN.example.com")];
+	int i, ret;
+
+	zassert_ok(dns_resolve_cache_get_stats(&before), "Cannot get stats");
+
+	for (i = 0; i <= CONFIG_DNS_RESOLVER_CACHE_MAX_ENTRIES; i++) {
+		snprintk(name, sizeof(name), "host%d.example.com", i);
+
+		ret = resolve(name);
+		zassert_equal(ret, DNS_EAI_ALLDONE, "Resolve failed (%d)", ret);
+	}
+
+	zassert_ok(dns_resolve_cache_get_stats(&after), "Cannot get stats");
+	zassert_equal(after.evictions - before.evictions, 1,
+		      "Wrong eviction count");
+
+	/* The least recently used answer is the one that was replaced */
+	ret = resolve("host0.example.com");
+	zassert_equal(ret, DNS_EAI_ALLDONE, "Resolve failed (%d)", ret);
+	zassert_equal(queries_received,
+		      CONFIG_DNS_RESOLVER_CACHE_MAX_ENTRIES + 2,
+		      "Evicted answer was used");
+}
+
+ZTEST_SUITE(net_dns_cache, NULL, dns_cache_setup, dns_cache_before, NULL, NULL);
@@ -0,0 +1,294 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <zephyr/ztest.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/http/server.h>
+#include <zephyr/net/http/service.h>
+
+#define SERVER_ADDR "127.0.0.1"
+#define RECV_TIMEOUT_MS 2000
+
+#define STATIC_CONTENT "Hello"
+#define STATIC_RESPONSE                                                                            \
+	"HTTP/1.1 200 OK\r\n"                                                                      \
+	"Content-Type: text/plain\r\n"                                                             \
+	"Content-Length: 5\r\n"                                                                    \
+	"\r\n" STATIC_CONTENT
+
+#define DYNAMIC_RESPONSE                                                                           \
+	"HTTP/1.1 200 OK\r\n"                                                                      \
+	"Transfer-Encoding: chunked\r\n"                                                           \
+	"\r\n"                                                                                     \
+	"6\r\nchunk0\r\n"                                                                          \
+	"6\r\nchunk1\r\n"                                                                          \
+	"0\r\n\r\n"
+
+#define NOT_FOUND_RESPONSE                                                                         \
+	"HTTP/1.1 404 Not Found\r\n"                                                               \
+	"Content-Length: 0\r\n"                                                                    \
+	"\r\n"
+
+#define GET(path) "GET " path " HTTP/1.1\r\nHost: test\r\n\r\n"
+
+static uint16_t test_port;
+HTTP_SERVICE_DEFINE(test_service, SERVER_ADDR, &test_port, 4, 2, NULL);
+
+static struct http_resource_detail_static static_detail = {
+	.common = {
+		.bitmask_of_supported_http_methods =
+			HTTP_METHOD_BIT(HTTP_GET) | HTTP_METHOD_BIT(HTTP_HEAD),
+		.type = HTTP_RESOURCE_TYPE_STATIC,
+		.content_type = "text/plain",
+	},
+	.static_data = STATIC_CONTENT,
+	.static_data_len = sizeof(STATIC_CONTENT) - 1,
+};
+
+HTTP_RESOURCE_DEFINE(static_resource, test_service, "/", &static_detail);
+
+static size_t body_len;
+static int chunk_count;
+
+static int dynamic_cb(struct http_client_ctx *client, enum http_data_status status,
+		      uint8_t *data_buffer, size_t data_len, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	switch (status) {
+	case HTTP_SERVER_DATA_MORE:
+	case HTTP_SERVER_DATA_FINAL:
+		body_len += data_len;
+		return 0;
+	case HTTP_SERVER_DATA_RESPONSE:
+		break;
+	default:
+		chunk_count = 0;
+		return 0;
+	}
+
+	/* A POST is answered with the body length, a GET with two chunks */
+	if (chunk_count == (http_client_get_method(client) == HTTP_POST ? 1 : 2)) {
+		chunk_count = 0;
+		return 0;
+	}
+
+	if (http_client_get_method(client) == HTTP_POST) {
+		chunk_count++;
+		return snprintk((char *)data_buffer, data_len, "%zu", body_len);
+	}
+
+	return snprintk((char *)data_buffer, data_len, "chunk%d", chunk_count++);
+}
+
+static struct http_resource_detail_dynamic dynamic_detail = {
+	.common = {
+		.bitmask_of_supported_http_methods =
+			HTTP_METHOD_BIT(HTTP_GET) | HTTP_METHOD_BIT(HTTP_POST),
+		.type = HTTP_RESOURCE_TYPE_DYNAMIC,
+	},
+	.cb = dynamic_cb,
+};
+
+HTTP_RESOURCE_DEFINE(dynamic_resource, test_service, "/dynamic", &dynamic_detail);
+
+static int client_fd = -1;
+static char recv_buf[512];
+
+static int connect_client(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(test_port),
+	};
+	struct timeval optval = {
+		.tv_sec = RECV_TIMEOUT_MS / MSEC_PER_SEC,
+		.tv_usec = (RECV_TIMEOUT_MS % MSEC_PER_SEC) * USEC_PER_MSEC,
+	};
+	int fd;
+
+	zsock_inet_pton(AF_INET, SERVER_ADDR, &addr.sin_addr);
+
+	fd = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(fd >= 0, "Cannot create socket (%d)", errno);
+
+	zassert_ok(zsock_setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &optval, sizeof(optval)),
+		   "Cannot set receive timeout");
+	zassert_ok(zsock_connect(fd, (struct sockaddr *)&addr, sizeof(addr)),
+		   "Cannot connect (%d)", errno);
+
+	return fd;
+}
+
+static void send_str(int fd, const char *str)
+{
+	size_t len = strlen(str);
+
+	zassert_equal(zsock_send(fd, str, len, 0), len, "Cannot send (%d)", errno);
+}
+
+/* Receive exactly the expected data */
+static void expect_str(int fd, const char *expected)
+{
+	size_t len = strlen(expected);
+	size_t received = 0;
+	ssize_t ret;
+
+	zassert_true(len < sizeof(recv_buf), "Expected response too long");
+
+	while (received < len) {
+		ret = zsock_recv(fd, recv_buf + received, len - received, 0);
+		zassert_true(ret > 0, "Response truncated after %zu bytes (%d)",
+			     received, errno);
+		received += ret;
+	}
+
+	recv_buf[received] = '\0';
+	zassert_mem_equal(recv_buf, expected, len, "Unexpected response:\n%s", recv_buf);
+}
+
+static void expect_closed(int fd)
+{
+	char c;
+
+	zassert_equal(zsock_recv(fd, &c, 1, 0), 0, "Connection not closed");
+}
+
+static void *http_server_setup(void)
+{
+	zassert_ok(http_server_start(), "Cannot start server");
+	zassert_not_equal(test_port, 0, "Ephemeral port not set");
+
+	return NULL;
+}
+
+static void http_server_teardown(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	zassert_ok(http_server_stop(), "Cannot stop server");
+}
+
+static void http_server_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	body_len = 0;
+	chunk_count = 0;
+	client_fd = connect_client();
+}
+
+static void http_server_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	if (client_fd >= 0) {
+		(void)zsock_close(client_fd);
+		client_fd = -1;
+	}
+}
+
+ZTEST(http_server, test_keep_alive)
+{
+	send_str(client_fd, GET("/"));
+	expect_str(client_fd, STATIC_RESPONSE);
+
+	/* Same connection, served again */
+	send_str(client_fd, GET("/?query=1"));
+	expect_str(client_fd, STATIC_RESPONSE);
+}
+
+ZTEST(http_server, test_pipelining)
+{
+	/* All requests in one segment, answered in order */
+	send_str(client_fd, GET("/") GET("/dynamic") GET("/missing") GET("/"));
+
+	expect_str(client_fd, STATIC_RESPONSE DYNAMIC_RESPONSE NOT_FOUND_RESPONSE
+			      STATIC_RESPONSE);
+}
+
+ZTEST(http_server, test_chunked)
+{
+	send_str(client_fd, GET("/dynamic"));
+	expect_str(client_fd, DYNAMIC_RESPONSE);
+}
+
+ZTEST(http_server, test_request_body)
+{
+	send_str(client_fd, "POST /dynamic HTTP/1.1\r\n"
+			    "Content-Length: 11\r\n"
+			    "\r\n"
+			    "hello");
+	k_msleep(10);
+	send_str(client_fd, " world");
+
+	expect_str(client_fd, "HTTP/1.1 200 OK\r\n"
+			      "Transfer-Encoding: chunked\r\n"
+			      "\r\n"
+			      "2\r\n11\r\n"
+			      "0\r\n\r\n");
+}
+
+ZTEST(http_server, test_errors)
+{
+	send_str(client_fd, "HEAD /dynamic HTTP/1.1\r\n\r\n");
+	expect_str(client_fd, "HTTP/1.1 405 Method Not Allowed\r\n"
+			      "Content-Length: 0\r\n"
+			      "\r\n");
+
+	send_str(client_fd, "GET /" "0123456789012345678901234567890123456789"
+			    "0123456789012345678901234567890123456789 HTTP/1.1\r\n\r\n");
+	expect_str(client_fd, "HTTP/1.1 414 URI Too Long\r\n"
+			      "Content-Length: 0\r\n"
+			      "\r\n");
+
+	send_str(client_fd, "NOT HTTP\r\n\r\n");
+	expect_str(client_fd, "HTTP/1.1 400 Bad Request\r\n"
+			      "Content-Length: 0\r\n"
+			      "Connection: close\r\n"
+			      "\r\n");
+	expect_closed(client_fd);
+}
+
+ZTEST(http_server, test_connection_close)
+{
+	send_str(client_fd, "HEAD / HTTP/1.1\r\nConnection: close\r\n\r\n");
+	expect_str(client_fd, "HTTP/1.1 200 OK\r\n"
+			      "Content-Type: text/plain\r\n"
+			      "Content-Length: 5\r\n"
+			      "Connection: close\r\n"
+			      "\r\n");
+	expect_closed(client_fd);
+
+	(void)zsock_close(client_fd);
+	client_fd = connect_client();
+
+	/* No chunked encoding for HTTP/1.0, the response ends with the connection */
+	send_str(client_fd, "GET /dynamic HTTP/1.0\r\n\r\n");
+	expect_str(client_fd, "HTTP/1.1 200 OK\r\n"
+			      "Connection: close\r\n"
+			      "\r\n"
+			      "chunk0chunk1");
+	expect_closed(client_fd);
+}
+
+ZTEST(http_server, test_concurrent_clients)
+{
+	int second_fd = connect_client();
+
+	/* Requests on both connections are served independently */
+	send_str(second_fd, GET("/dynamic"));
+	send_str(client_fd, GET("/"));
+
+	expect_str(client_fd, STATIC_RESPONSE);
+	expect_str(second_fd, DYNAMIC_RESPONSE);
+
+	(void)zsock_close(second_fd);
+}
+
+ZTEST_SUITE(http_server, NULL, http_server_setup, http_server_before,
+	    http_server_after, http_server_teardown);
@@ -0,0 +1,188 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "lwm2m_engine.h"
+#include "lwm2m_util.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#define TEMP_SENSOR_OBJECT_ID 3303
+#define TEMP_SENSOR_INSTANCES CONFIG_LWM2M_IPSO_TEMP_SENSOR_INSTANCE_COUNT
+#define NOTIFY_ROUNDS 20
+
+static const uint16_t observed_res[] = { 5700, 5601, 5602, 5701 };
+
+#define OBSERVER_COUNT (TEMP_SENSOR_INSTANCES * ARRAY_SIZE(observed_res))
+
+BUILD_ASSERT(OBSERVER_COUNT <= CONFIG_LWM2M_ENGINE_MAX_OBSERVER);
+
+static struct lwm2m_ctx ctx;
+
+static void add_observer(const struct lwm2m_obj_path *path, uint16_t id)
+{
+	uint8_t token[2] = { id >> 8, id & 0xff };
+	uint8_t buf[32];
+	struct lwm2m_message msg = { 0 };
+	int ret;
+
+	ret = coap_packet_init(&msg.cpkt, buf, sizeof(buf), COAP_VERSION_1, COAP_TYPE_ACK,
+			       0, NULL, COAP_RESPONSE_CODE_CONTENT, 0);
+	zassert_equal(ret, 0);
+
+	msg.ctx = &ctx;
+	msg.out.out_cpkt = &msg.cpkt;
+	msg.path = *path;
+	msg.token = token;
+	msg.tkl = sizeof(token);
+
+	ret = lwm2m_engine_observation_handler(&msg, 0, LWM2M_FORMAT_PLAIN_TEXT, false);
+	zassert_equal(ret, 0, "Cannot add observer (%d)", ret);
+}
+
+static int count_updated_observers(void)
+{
+	struct observe_node *obs;
+	int count = 0;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&ctx.observer, obs, node) {
+		if (obs->resource_update) {
+			obs->resource_update = false;
+			engine_observe_schedule(obs, 0);
+			count++;
+		}
+	}
+
+	return count;
+}
+
+static void *lwm2m_notify_setup(void)
+{
+	int i, j, ret;
+
+	lwm2m_engine_context_init(&ctx);
+
+	for (i = 0; i < TEMP_SENSOR_INSTANCES; i++) {
+		ret = lwm2m_create_object_inst(&LWM2M_OBJ(TEMP_SENSOR_OBJECT_ID, i));
+		zassert_equal(ret, 0);
+
+		for (j = 0; j < ARRAY_SIZE(observed_res); j++) {
+			add_observer(&LWM2M_OBJ(TEMP_SENSOR_OBJECT_ID, i, observed_res[j]),
+				     i * ARRAY_SIZE(observed_res) + j + 1);
+		}
+	}
+
+	return NULL;
+}
+
+static void lwm2m_notify_teardown(void *fixture)
+{
+	int i;
+
+	ARG_UNUSED(fixture);
+
+	lwm2m_engine_context_close(&ctx);
+
+	for (i = 0; i < TEMP_SENSOR_INSTANCES; i++) {
+		(void)lwm2m_delete_object_inst(&LWM2M_OBJ(TEMP_SENSOR_OBJECT_ID, i));
+	}
+}
+
+static void lwm2m_notify_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	(void)count_updated_observers();
+}
+
+ZTEST(lwm2m_notify, test_notify_resource)
+{
+	struct observe_node *obs;
+	struct lwm2m_obj_path_list *o_p;
+	int ret;
+
+	ret = lwm2m_notify_observer_path(&LWM2M_OBJ(TEMP_SENSOR_OBJECT_ID, 2, 5601));
+	zassert_equal(ret, 1, "Invalid observer count (%d)", ret);
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&ctx.observer, obs, node) {
+		if (!obs->resource_update) {
+			continue;
+		}
+
+		o_p = SYS_SLIST_PEEK_HEAD_CONTAINER(&obs->path_list, o_p, node);
+		zassert_equal(o_p->path.obj_inst_id, 2, "Wrong observer notified");
+		zassert_equal(o_p->path.res_id, 5601, "Wrong observer notified");
+	}
+
+	zassert_equal(count_updated_observers(), 1, "Unrelated observers notified");
+}
+
+ZTEST(lwm2m_notify, test_notify_parent_path)
+{
+	int ret;
+
+	ret = lwm2m_notify_observer_path(&LWM2M_OBJ(TEMP_SENSOR_OBJECT_ID, 1));
+	zassert_equal(ret, ARRAY_SIZE(observed_res), "Invalid observer count (%d)", ret);
+	zassert_equal(count_updated_observers(), ARRAY_SIZE(observed_res));
+
+	ret = lwm2m_notify_observer_path(&LWM2M_OBJ(TEMP_SENSOR_OBJECT_ID));
+	zassert_equal(ret, OBSERVER_COUNT, "Invalid observer count (%d)", ret);
+	zassert_equal(count_updated_observers(), OBSERVER_COUNT);
+
+	ret = lwm2m_notify_observer_path(&LWM2M_OBJ(TEMP_SENSOR_OBJECT_ID, 0, 5603));
+	zassert_equal(ret, 0, "Unobserved resource notified");
+}
+
+ZTEST(lwm2m_notify, test_deadline_order)
+{
+	struct observe_node *obs;
+	struct lwm2m_obj_path_list *o_p;
+	int64_t prev = 0;
+	int count = 0;
+
+	/* Notified in the opposite order of the observer list */
+	(void)lwm2m_notify_observer_path(&LWM2M_OBJ(TEMP_SENSOR_OBJECT_ID, 1, 5700));
+	k_msleep(2);
+	(void)lwm2m_notify_observer_path(&LWM2M_OBJ(TEMP_SENSOR_OBJECT_ID, 0, 5700));
+
+	SYS_DLIST_FOR_EACH_CONTAINER(lwm2m_obs_deadline_list(), obs, deadline_node) {
+		zassert_true(obs->event_timestamp >= prev, "Deadlines not sorted");
+		prev = obs->event_timestamp;
+		count++;
+	}
+
+	zassert_equal(count, 2, "Invalid scheduled observer count");
+
+	obs = SYS_DLIST_PEEK_HEAD_CONTAINER(lwm2m_obs_deadline_list(), obs, deadline_node);
+	o_p = SYS_SLIST_PEEK_HEAD_CONTAINER(&obs->path_list, o_p, node);
+	zassert_equal(o_p->path.obj_inst_id, 1, "Earliest observer not first");
+}
+
+ZTEST(lwm2m_notify, test_notify_cost)
+{
+	uint32_t start, cycles;
+	int i, j, k, ret;
+
+	start = k_cycle_get_32();
+
+	for (k = 0; k < NOTIFY_ROUNDS; k++) {
+		for (i = 0; i < TEMP_SENSOR_INSTANCES; i++) {
+			for (j = 0; j < ARRAY_SIZE(observed_res); j++) {
+				ret = lwm2m_notify_observer_path(
+					&LWM2M_OBJ(TEMP_SENSOR_OBJECT_ID, i, observed_res[j]));
+				zassert_equal(ret, 1);
+			}
+		}
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	TC_PRINT("%u cycles per notification with %u observers\n",
+		 cycles / (NOTIFY_ROUNDS * OBSERVER_COUNT), (unsigned int)OBSERVER_COUNT);
+
+	zassert_equal(count_updated_observers(), OBSERVER_COUNT);
+}
+
+ZTEST_SUITE(lwm2m_notify, NULL, lwm2m_notify_setup, NULL, lwm2m_notify_after,
+	    lwm2m_notify_teardown);
@@ -191,18 +191,20 @@ ZTEST(lwm2m_engine, test_check_notifications)
 	struct observe_node obs;
 
 	(void)memset(&ctx, 0x0, sizeof(ctx));
+	(void)memset(&obs, 0x0, sizeof(obs));
 
 	ctx.sock_fd = -1;
 	ctx.load_credentials = NULL;
 	ctx.remote_addr.sa_family = AF_INET;
 	sys_slist_init(&ctx.observer);
 
+	obs.ctx = &ctx;
 	obs.last_timestamp = k_uptime_get();
-	obs.event_timestamp = k_uptime_get() + 1000U;
 	obs.resource_update = false;
 	obs.active_tx_operation = false;
 
 	sys_slist_append(&ctx.observer, &obs.node);
+	engine_observe_schedule(&obs, k_uptime_get() + 1000U);
 
 	lwm2m_rd_client_is_registred_fake.return_val = true;
 	ret = lwm2m_engine_start(&ctx);
@@ -214,6 +216,7 @@ ZTEST(lwm2m_engine, test_check_notifications)
 	zassert_equal(generate_notify_message_fake.call_count, 1, "Notify message not generated");
 	zassert_equal(engine_observe_shedule_next_event_fake.call_count, 1,
 		      "Next observe event not scheduled");
+	zassert_false(sys_dnode_is_linked(&obs.deadline_node), "Observer still scheduled");
 }
 
 ZTEST(lwm2m_engine, test_push_queued_buffers)
@@ -46,6 +46,24 @@ sys_slist_t *lwm2m_obs_obj_path_list(void)
 	return &obs_obj_path_list;
 }
 
+static sys_dlist_t obs_deadline_list = SYS_DLIST_STATIC_INIT(&obs_deadline_list);
+sys_dlist_t *lwm2m_obs_deadline_list(void)
+{
+	return &obs_deadline_list;
+}
+
+void engine_observe_schedule(struct observe_node *obs, int64_t timestamp)
+{
+	if (sys_dnode_is_linked(&obs->deadline_node)) {
+		sys_dlist_remove(&obs->deadline_node);
+	}
+
+	obs->event_timestamp = timestamp;
+	if (timestamp) {
+		sys_dlist_append(&obs_deadline_list, &obs->deadline_node);
+	}
+}
+
 struct zsock_pollfd {
 	int fd;
 	short events;
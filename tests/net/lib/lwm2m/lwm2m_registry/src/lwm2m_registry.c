@@ -294,3 +294,68 @@ ZTEST(lwm2m_registry, test_callbacks)
 	zassert_equal(ret, 0);
 	zassert_equal(callback_checker, 0x7F);
 }
+
+#define LOOKUP_ROUNDS 100
+
+ZTEST(lwm2m_registry, test_instance_index)
+{
+	static const uint16_t inst_ids[] = { 7, 3, 5, 0, 6, 1, 4, 2 };
+	struct lwm2m_engine_obj_inst *obj_inst;
+	uint32_t start, cycles;
+	double sensor_val;
+	int ret, i, j;
+
+	/* Instances are created out of order */
+	for (i = 0; i < ARRAY_SIZE(inst_ids); i++) {
+		ret = lwm2m_create_object_inst(&LWM2M_OBJ(3303, inst_ids[i]));
+		zassert_equal(ret, 0);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(inst_ids); i++) {
+		obj_inst = get_engine_obj_inst(3303, i);
+		zassert_not_null(obj_inst);
+		zassert_equal(obj_inst->obj_inst_id, i);
+	}
+
+	zassert_is_null(get_engine_obj_inst(3303, ARRAY_SIZE(inst_ids)));
+	zassert_is_null(get_engine_obj_inst(3304, 0));
+
+	/* Iteration follows the instance IDs */
+	obj_inst = next_engine_obj_inst(3303, -1);
+	for (i = 0; i < ARRAY_SIZE(inst_ids); i++) {
+		zassert_not_null(obj_inst);
+		zassert_equal(obj_inst->obj_inst_id, i);
+		obj_inst = next_engine_obj_inst(3303, obj_inst->obj_inst_id);
+	}
+
+	zassert_is_null(obj_inst);
+
+	ret = lwm2m_delete_object_inst(&LWM2M_OBJ(3303, 3));
+	zassert_equal(ret, 0);
+	zassert_is_null(get_engine_obj_inst(3303, 3));
+	zassert_equal(next_engine_obj_inst(3303, 2)->obj_inst_id, 4);
+
+	ret = lwm2m_create_object_inst(&LWM2M_OBJ(3303, 3));
+	zassert_equal(ret, 0);
+	zassert_equal(next_engine_obj_inst(3303, 2)->obj_inst_id, 3);
+
+	/* Resource lookup cost, printed for comparison between builds */
+	start = k_cycle_get_32();
+
+	for (j = 0; j < LOOKUP_ROUNDS; j++) {
+		for (i = 0; i < ARRAY_SIZE(inst_ids); i++) {
+			ret = lwm2m_get_f64(&LWM2M_OBJ(3303, i, 5700), &sensor_val);
+			zassert_equal(ret, 0);
+		}
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	TC_PRINT("%u cycles per resource read with %zu instances\n",
+		 cycles / (LOOKUP_ROUNDS * ARRAY_SIZE(inst_ids)), ARRAY_SIZE(inst_ids));
+
+	for (i = 0; i < ARRAY_SIZE(inst_ids); i++) {
+		ret = lwm2m_delete_object_inst(&LWM2M_OBJ(3303, i));
+		zassert_equal(ret, 0);
+	}
+}
@@ -0,0 +1,460 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+
+#include <zephyr/ztest.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/mqtt.h>
+#include <zephyr/sys/byteorder.h>
+
+#define BROKER_ADDR "127.0.0.1"
+#define BROKER_PORT 18830
+#define BROKER_STACK_SIZE 2048
+#define BROKER_MAX_ACKS 16
+#define WAIT_TIMEOUT_MS 2000
+#define LATENCY_MS 10
+#define BENCH_MESSAGES 64
+
+static const uint8_t payload[] = "0123456789abcdef";
+
+/* Minimal broker answering CONNECT and PINGREQ right away, and PUBLISH
+ * after LATENCY_MS to simulate the round trip time of a link.
+ */
+static struct {
+	int listen_fd;
+	int fd;
+	uint8_t buf[512];
+	size_t len;
+	struct {
+		int64_t deadline;
+		uint16_t id;
+	} acks[BROKER_MAX_ACKS];
+	int ack_head;
+	int ack_count;
+	/* PUBACK not sent for the next QoS 1 messages */
+	int drop_acks;
+	int publishes;
+	int dups;
+	size_t payload_bytes;
+} broker = {
+	.listen_fd = -1,
+	.fd = -1,
+};
+
+static K_THREAD_STACK_DEFINE(broker_stack, BROKER_STACK_SIZE);
+static struct k_thread broker_thread_data;
+
+static void broker_send(const uint8_t *data, size_t len)
+{
+	(void)zsock_send(broker.fd, data, len, 0);
+}
+
+static void broker_handle(uint8_t type, const uint8_t *body, size_t len)
+{
+	static const uint8_t connack[] = { 0x20, 0x02, 0x00, 0x00 };
+	static const uint8_t pingresp[] = { 0xd0, 0x00 };
+	uint8_t qos = (type >> 1) & 0x03;
+	size_t offset;
+	int slot;
+
+	switch (type & 0xf0) {
+	case 0x10:
+		broker_send(connack, sizeof(connack));
+		break;
+
+	case 0x30:
+		broker.publishes++;
+		if (type & 0x08) {
+			broker.dups++;
+		}
+
+		offset = sizeof(uint16_t) + sys_get_be16(body);
+		if (qos > 0) {
+			offset += sizeof(uint16_t);
+		}
+
+		broker.payload_bytes += len - offset;
+
+		if (qos == 0) {
+			break;
+		}
+
+		if (broker.drop_acks > 0) {
+			broker.drop_acks--;
+			break;
+		}
+
+		if (broker.ack_count == BROKER_MAX_ACKS) {
+			break;
+		}
+
+		slot = (broker.ack_head + broker.ack_count) % BROKER_MAX_ACKS;
+		broker.acks[slot].deadline = k_uptime_get() + LATENCY_MS;
+		broker.acks[slot].id = sys_get_be16(&body[offset - sizeof(uint16_t)]);
+		broker.ack_count++;
+		break;
+
+	case 0xc0:
+		broker_send(pingresp, sizeof(pingresp));
+		break;
+
+	default:
+		break;
+	}
+}
+
+static void broker_parse(void)
+{
+	size_t pos = 0;
+	size_t hdr_len;
+	uint32_t length;
+	uint8_t byte;
+	int shift;
+
+	while (broker.len - pos >= 2) {
+		hdr_len = 1;
+		length = 0;
+		shift = 0;
+
+		do {
+			if (pos + hdr_len >= broker.len) {
+				goto out;
+			}
+
+			byte = broker.buf[pos + hdr_len++];
+			length |= (byte & 0x7f) << shift;
+			shift += 7;
+		} while (byte & 0x80);
+
+		if (broker.len - pos < hdr_len + length) {
+			break;
+		}
+
+		broker_handle(broker.buf[pos], &broker.buf[pos + hdr_len], length);
+		pos += hdr_len + length;
+	}
+
+out:
+	memmove(broker.buf, &broker.buf[pos], broker.len - pos);
+	broker.len -= pos;
+}
+
+static void broker_send_acks(void)
+{
+	uint8_t puback[] = { 0x40, 0x02, 0x00, 0x00 };
+
+	while (broker.ack_count > 0 &&
+	       broker.acks[broker.ack_head].deadline <= k_uptime_get()) {
+		sys_put_be16(broker.acks[broker.ack_head].id, &puback[2]);
+		broker_send(puback, sizeof(puback));
+
+		broker.ack_head = (broker.ack_head + 1) % BROKER_MAX_ACKS;
+		broker.ack_count--;
+	}
+}
+
+static void broker_thread(void *p1, void *p2, void *p3)
+{
+	struct zsock_pollfd fds[2];
+	int64_t timeout;
+	int ret;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		fds[0].fd = broker.listen_fd;
+		fds[0].events = ZSOCK_POLLIN;
+		fds[1].fd = broker.fd;
+		fds[1].events = ZSOCK_POLLIN;
+
+		timeout = 100;
+		if (broker.ack_count > 0) {
+			timeout = CLAMP(broker.acks[broker.ack_head].deadline - k_uptime_get(),
+					0, timeout);
+		}
+
+		ret = zsock_poll(fds, broker.fd < 0 ? 1 : 2, timeout);
+		if (ret > 0 && (fds[0].revents & ZSOCK_POLLIN)) {
+			ret = zsock_accept(broker.listen_fd, NULL, NULL);
+			if (ret >= 0) {
+				if (broker.fd >= 0) {
+					(void)zsock_close(broker.fd);
+				}
+
+				broker.fd = ret;
+				broker.len = 0;
+				broker.ack_count = 0;
+				continue;
+			}
+		}
+
+		if (broker.fd >= 0 && ret > 0 && fds[1].revents) {
+			ret = zsock_recv(broker.fd, &broker.buf[broker.len],
+					 sizeof(broker.buf) - broker.len, 0);
+			if (ret <= 0) {
+				(void)zsock_close(broker.fd);
+				broker.fd = -1;
+				continue;
+			}
+
+			broker.len += ret;
+			broker_parse();
+		}
+
+		broker_send_acks();
+	}
+}
+
+static struct mqtt_client client;
+static struct sockaddr_in broker_addr;
+static uint8_t rx_buffer[256];
+static uint8_t tx_buffer[256];
+static bool connected;
+static int puback_count;
+static uint16_t next_message_id = 1;
+
+static void mqtt_evt_handler(struct mqtt_client *const c, const struct mqtt_evt *evt)
+{
+	switch (evt->type) {
+	case MQTT_EVT_CONNACK:
+		connected = (evt->result == 0);
+		break;
+
+	case MQTT_EVT_DISCONNECT:
+		connected = false;
+		break;
+
+	case MQTT_EVT_PUBACK:
+		puback_count++;
+		break;
+
+	default:
+		break;
+	}
+}
+
+/* Handles the data received by the client within timeout_ms */
+static void client_process(int timeout_ms)
+{
+	struct zsock_pollfd fds = {
+		.fd = client.transport.tcp.sock,
+		.events = ZSOCK_POLLIN,
+	};
+
+	if (zsock_poll(&fds, 1, timeout_ms) > 0) {
+		zassert_ok(mqtt_input(&client), "Input failed");
+	}
+}
+
+static void client_wait_pubacks(int count)
+{
+	int64_t end = k_uptime_get() + WAIT_TIMEOUT_MS;
+
+	while (puback_count < count) {
+		zassert_true(k_uptime_get() < end, "PUBACK missing (%d/%d)", puback_count,
+			     count);
+		client_process(WAIT_TIMEOUT_MS);
+	}
+}
+
+static void broker_wait_publishes(int count)
+{
+	int64_t end = k_uptime_get() + WAIT_TIMEOUT_MS;
+
+	while (broker.publishes < count) {
+		zassert_true(k_uptime_get() < end, "PUBLISH missing (%d/%d)", broker.publishes,
+			     count);
+		k_msleep(10);
+	}
+}
+
+static void publish_param_init(struct mqtt_publish_param *param, enum mqtt_qos qos)
+{
+	memset(param, 0, sizeof(*param));
+
+	param->message.topic.qos = qos;
+	param->message.topic.topic.utf8 = (const uint8_t *)"sensors";
+	param->message.topic.topic.size = strlen("sensors");
+	param->message.payload.data = (uint8_t *)payload;
+	param->message.payload.len = sizeof(payload) - 1;
+	param->message_id = next_message_id++;
+}
+
+static void *mqtt_client_setup(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(BROKER_PORT),
+	};
+
+	zsock_inet_pton(AF_INET, BROKER_ADDR, &addr.sin_addr);
+	broker_addr = addr;
+
+	broker.listen_fd = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(broker.listen_fd >= 0, "Cannot create socket (%d)", errno);
+	zassert_ok(zsock_bind(broker.listen_fd, (struct sockaddr *)&addr, sizeof(addr)),
+		   "Cannot bind (%d)", errno);
+	zassert_ok(zsock_listen(broker.listen_fd, 1), "Cannot listen (%d)", errno);
+
+	k_thread_create(&broker_thread_data, broker_stack, K_THREAD_STACK_SIZEOF(broker_stack),
+			broker_thread, NULL, NULL, NULL, K_PRIO_COOP(8), 0, K_NO_WAIT);
+
+	return NULL;
+}
+
+static void mqtt_client_before(void *fixture)
+{
+	int64_t end;
+
+	ARG_UNUSED(fixture);
+
+	broker.publishes = 0;
+	broker.dups = 0;
+	broker.drop_acks = 0;
+	broker.payload_bytes = 0;
+	puback_count = 0;
+
+	mqtt_client_init(&client);
+
+	client.broker = &broker_addr;
+	client.evt_cb = mqtt_evt_handler;
+	client.client_id.utf8 = (const uint8_t *)"zephyr";
+	client.client_id.size = strlen("zephyr");
+	client.rx_buf = rx_buffer;
+	client.rx_buf_size = sizeof(rx_buffer);
+	client.tx_buf = tx_buffer;
+	client.tx_buf_size = sizeof(tx_buffer);
+	client.transport.type = MQTT_TRANSPORT_NON_SECURE;
+
+	zassert_ok(mqtt_connect(&client), "Cannot connect");
+
+	end = k_uptime_get() + WAIT_TIMEOUT_MS;
+	while (!connected) {
+		zassert_true(k_uptime_get() < end, "No CONNACK");
+		client_process(WAIT_TIMEOUT_MS);
+	}
+}
+
+static void mqtt_client_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	if (connected) {
+		(void)mqtt_disconnect(&client);
+	} else {
+		(void)mqtt_abort(&client);
+	}
+}
+
+ZTEST(mqtt_client, test_publish_batch)
+{
+	struct mqtt_publish_param params[6];
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(params); i++) {
+		publish_param_init(&params[i], MQTT_QOS_0_AT_MOST_ONCE);
+	}
+
+	zassert_ok(mqtt_publish_batch(&client, params, ARRAY_SIZE(params)),
+		   "Cannot publish batch");
+
+	broker_wait_publishes(ARRAY_SIZE(params));
+	zassert_equal(broker.payload_bytes, ARRAY_SIZE(params) * (sizeof(payload) - 1),
+		      "Wrong payload received");
+}
+
+ZTEST(mqtt_client, test_publish_window)
+{
+	struct mqtt_publish_param param;
+	int i;
+
+	for (i = 0; i < CONFIG_MQTT_PUBLISH_WINDOW; i++) {
+		publish_param_init(&param, MQTT_QOS_1_AT_LEAST_ONCE);
+		zassert_ok(mqtt_publish(&client, &param), "Cannot publish");
+	}
+
+	publish_param_init(&param, MQTT_QOS_1_AT_LEAST_ONCE);
+	zassert_equal(mqtt_publish(&client, &param), -ENOBUFS, "Window not limited");
+
+	/* QoS 0 messages are not tracked */
+	publish_param_init(&param, MQTT_QOS_0_AT_MOST_ONCE);
+	zassert_ok(mqtt_publish(&client, &param), "QoS 0 message limited by the window");
+
+	client_wait_pubacks(CONFIG_MQTT_PUBLISH_WINDOW);
+
+	publish_param_init(&param, MQTT_QOS_1_AT_LEAST_ONCE);
+	zassert_ok(mqtt_publish(&client, &param), "Window not released");
+	client_wait_pubacks(CONFIG_MQTT_PUBLISH_WINDOW + 1);
+}
+
+ZTEST(mqtt_client, test_retransmit)
+{
+	struct mqtt_publish_param param;
+
+	broker.drop_acks = 1;
+
+	publish_param_init(&param, MQTT_QOS_1_AT_LEAST_ONCE);
+	zassert_ok(mqtt_publish(&client, &param), "Cannot publish");
+	broker_wait_publishes(1);
+
+	k_msleep(CONFIG_MQTT_PUBLISH_RETRANSMIT_TIMEOUT / 2);
+	(void)mqtt_live(&client);
+	zassert_equal(broker.publishes, 1, "Retransmitted too early");
+
+	k_msleep(CONFIG_MQTT_PUBLISH_RETRANSMIT_TIMEOUT);
+	(void)mqtt_live(&client);
+	broker_wait_publishes(2);
+	zassert_equal(broker.dups, 1, "DUP flag not set");
+
+	client_wait_pubacks(1);
+}
+
+ZTEST(mqtt_client, test_publish_rate)
+{
+	struct mqtt_publish_param param;
+	int64_t start, one_by_one, windowed;
+	int sent, ret;
+
+	start = k_uptime_get();
+
+	for (sent = 0; sent < BENCH_MESSAGES; sent++) {
+		publish_param_init(&param, MQTT_QOS_1_AT_LEAST_ONCE);
+		zassert_ok(mqtt_publish(&client, &param), "Cannot publish");
+		client_wait_pubacks(sent + 1);
+	}
+
+	one_by_one = MAX(k_uptime_get() - start, 1);
+
+	puback_count = 0;
+	start = k_uptime_get();
+
+	for (sent = 0; puback_count < BENCH_MESSAGES;) {
+		if (sent < BENCH_MESSAGES) {
+			publish_param_init(&param, MQTT_QOS_1_AT_LEAST_ONCE);
+			ret = mqtt_publish(&client, &param);
+			if (ret == 0) {
+				sent++;
+				continue;
+			}
+
+			zassert_equal(ret, -ENOBUFS, "Cannot publish (%d)", ret);
+		}
+
+		client_process(WAIT_TIMEOUT_MS);
+	}
+
+	windowed = MAX(k_uptime_get() - start, 1);
+
+	TC_PRINT("%d QoS 1 messages with %d ms latency: %lld ms one by one, "
+		 "%lld ms with %d in flight\n", BENCH_MESSAGES, LATENCY_MS,
+		 (long long)one_by_one, (long long)windowed, CONFIG_MQTT_PUBLISH_WINDOW);
+
+	zassert_true(windowed < one_by_one, "No gain from the window");
+}
+
+ZTEST_SUITE(mqtt_client, NULL, mqtt_client_setup, mqtt_client_before, mqtt_client_after,
+	    NULL);
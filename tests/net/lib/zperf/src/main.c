@@ -0,0 +1,239 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <zephyr/net/socket.h>
+#include <zephyr/net/zperf.h>
+
+#define SERVER_ADDR "127.0.0.1"
+#define ZPERF_PORT 5001
+#define ECHO_PORT 4242
+
+#define DURATION_MS 1000
+#define PACKET_SIZE 256
+#define RATE_KBPS 256
+#define STREAMS 2
+
+#define SESSION_TIMEOUT K_SECONDS(10)
+
+#define ECHO_STACK_SIZE 1024
+
+static K_THREAD_STACK_DEFINE(echo_stack, ECHO_STACK_SIZE);
+static struct k_thread echo_thread;
+static int echo_sock = -1;
+
+static K_SEM_DEFINE(udp_sessions, 0, 8);
+static K_SEM_DEFINE(tcp_sessions, 0, 8);
+
+static void download_cb(enum zperf_status status, struct zperf_results *result,
+			void *user_data)
+{
+	if (status == ZPERF_SESSION_FINISHED) {
+		k_sem_give(user_data);
+	}
+}
+
+static void echo_entry(void *p1, void *p2, void *p3)
+{
+	static uint8_t buf[PACKET_SIZE];
+	struct sockaddr addr;
+	socklen_t addrlen;
+	ssize_t len;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		addrlen = sizeof(addr);
+
+		len = recvfrom(echo_sock, buf, sizeof(buf), 0, &addr, &addrlen);
+		if (len > 0) {
+			(void)sendto(echo_sock, buf, len, 0, &addr, addrlen);
+		}
+	}
+}
+
+static void upload_params(struct zperf_upload_params *param, uint16_t port)
+{
+	struct sockaddr_in *addr = (struct sockaddr_in *)&param->peer_addr;
+
+	memset(param, 0, sizeof(*param));
+
+	addr->sin_family = AF_INET;
+	addr->sin_port = htons(port);
+	inet_pton(AF_INET, SERVER_ADDR, &addr->sin_addr);
+
+	param->duration_ms = DURATION_MS;
+	param->packet_size = PACKET_SIZE;
+	param->rate_kbps = RATE_KBPS;
+}
+
+static void wait_sessions(struct k_sem *sessions, int count)
+{
+	for (int i = 0; i < count; i++) {
+		zassert_equal(k_sem_take(sessions, SESSION_TIMEOUT), 0,
+			      "Server finished %d sessions out of %d", i, count);
+	}
+}
+
+ZTEST(net_zperf, test_udp_upload_streams)
+{
+	struct zperf_upload_params param;
+	struct zperf_results result;
+	int ret;
+
+	upload_params(&param, ZPERF_PORT);
+	param.options.streams = STREAMS;
+
+	ret = zperf_udp_upload(&param, &result);
+	zassert_equal(ret, 0, "Upload failed (%d)", ret);
+	zassert_true(result.nb_packets_sent > 0, "No packet sent");
+	zassert_true(result.nb_packets_rcvd > 0, "No packet received");
+
+	wait_sessions(&udp_sessions, STREAMS);
+
+	TC_PRINT("UDP, %d streams: %u packets sent, %u received, "
+		 "CPU load %u per mille\n", STREAMS, result.nb_packets_sent,
+		 result.nb_packets_rcvd, result.cpu_load_permille);
+}
+
+ZTEST(net_zperf, test_tcp_upload_streams)
+{
+	struct zperf_upload_params param;
+	struct zperf_results result;
+	int ret;
+
+	upload_params(&param, ZPERF_PORT);
+	param.options.streams = STREAMS;
+
+	ret = zperf_tcp_upload(&param, &result);
+	zassert_equal(ret, 0, "Upload failed (%d)", ret);
+	zassert_true(result.nb_packets_sent > 0, "No packet sent");
+
+	wait_sessions(&tcp_sessions, STREAMS);
+
+	TC_PRINT("TCP, %d streams: %u packets sent, CPU load %u per mille\n",
+		 STREAMS, result.nb_packets_sent, result.cpu_load_permille);
+}
+
+ZTEST(net_zperf, test_too_many_streams)
+{
+	struct zperf_upload_params param;
+	struct zperf_results result;
+
+	upload_params(&param, ZPERF_PORT);
+	param.options.streams = CONFIG_NET_ZPERF_MAX_STREAMS + 1;
+
+	zassert_equal(zperf_udp_upload(&param, &result), -EINVAL,
+		      "Too many streams accepted");
+}
+
+ZTEST(net_zperf, test_tcp_dual)
+{
+	struct zperf_upload_params param;
+	struct zperf_results result;
+	int ret;
+
+	/* The server connects back to its own port. Over the loopback the
+	 * reverse stream shares the uploader buffers with the forward one,
+	 * which is only harmless for TCP, as the header is sent separately.
+	 */
+	upload_params(&param, ZPERF_PORT);
+	param.options.dual_port = ZPERF_PORT;
+
+	ret = zperf_tcp_upload(&param, &result);
+	zassert_equal(ret, 0, "Upload failed (%d)", ret);
+
+	/* The upload and the reverse stream */
+	wait_sessions(&tcp_sessions, 2);
+}
+
+ZTEST(net_zperf, test_udp_latency)
+{
+	struct zperf_upload_params param;
+	struct zperf_results result;
+	int ret;
+
+	upload_params(&param, ECHO_PORT);
+	param.packet_size = 64;
+	param.rate_kbps = 0;
+
+	ret = zperf_udp_latency(&param, &result);
+	zassert_equal(ret, 0, "Latency test failed (%d)", ret);
+	zassert_true(result.nb_packets_rcvd > 0, "No echo received");
+	zassert_equal(result.nb_packets_sent,
+		      result.nb_packets_rcvd + result.nb_packets_lost,
+		      "Requests not accounted for");
+	zassert_true(result.latency_min_us <= result.latency_p50_us &&
+		     result.latency_p50_us <= result.latency_p99_us &&
+		     result.latency_p99_us <= result.latency_p999_us &&
+		     result.latency_p999_us <= result.latency_max_us,
+		     "Percentiles out of order");
+	zassert_true(result.latency_avg_us >= result.latency_min_us &&
+		     result.latency_avg_us <= result.latency_max_us,
+		     "Invalid average");
+
+	TC_PRINT("UDP latency: %u requests, p50 %u us, p99 %u us, "
+		 "p99.9 %u us, max %u us, CPU load %u per mille\n",
+		 result.nb_packets_sent, result.latency_p50_us,
+		 result.latency_p99_us, result.latency_p999_us,
+		 result.latency_max_us, result.cpu_load_permille);
+}
+
+ZTEST(net_zperf, test_latency_options)
+{
+	struct zperf_upload_params param;
+	struct zperf_results result;
+
+	upload_params(&param, ECHO_PORT);
+	param.options.streams = 2;
+
+	zassert_equal(zperf_udp_latency(&param, &result), -EINVAL,
+		      "Latency test with streams accepted");
+}
+
+static void *setup(void)
+{
+	struct zperf_download_params download = { .port = ZPERF_PORT };
+	struct sockaddr_in addr;
+	int ret;
+
+	ret = zperf_udp_download(&download, download_cb, &udp_sessions);
+	zassert_equal(ret, 0, "Cannot start UDP server (%d)", ret);
+
+	ret = zperf_tcp_download(&download, download_cb, &tcp_sessions);
+	zassert_equal(ret, 0, "Cannot start TCP server (%d)", ret);
+
+	echo_sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	zassert_true(echo_sock >= 0, "Cannot create socket (%d)", errno);
+
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(ECHO_PORT);
+	inet_pton(AF_INET, SERVER_ADDR, &addr.sin_addr);
+
+	ret = bind(echo_sock, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_equal(ret, 0, "Cannot bind (%d)", errno);
+
+	k_thread_create(&echo_thread, echo_stack,
+			K_THREAD_STACK_SIZEOF(echo_stack), echo_entry,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(8), 0, K_NO_WAIT);
+
+	/* Let the servers bind */
+	k_sleep(K_MSEC(100));
+
+	return NULL;
+}
+
+static void before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	k_sem_reset(&udp_sessions);
+	k_sem_reset(&tcp_sessions);
+}
+
+ZTEST_SUITE(net_zperf, NULL, setup, before, NULL, NULL);
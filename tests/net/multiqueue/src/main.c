@@ -0,0 +1,274 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_TC_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/net_core.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_ip.h>
+#include <zephyr/net/net_context.h>
+#include <zephyr/net/dummy.h>
+
+#include "ipv4.h"
+#include "udp_internal.h"
+
+#define LOCAL_PORT 4242
+#define FLOW_COUNT 16
+#define PKTS_PER_FLOW 8
+#define WAIT_TIME K_SECONDS(1)
+
+static struct in_addr local_addr = { { { 192, 0, 2, 1 } } };
+static struct in_addr peer_addr = { { { 192, 0, 2, 2 } } };
+
+struct fake_dev_context {
+	struct net_if *iface;
+};
+
+static struct fake_dev_context fake_dev_data;
+
+struct rx_record {
+	k_tid_t thread;
+	uint16_t port;
+	uint16_t seq;
+};
+
+static struct rx_record records[FLOW_COUNT * PKTS_PER_FLOW];
+static atomic_t record_count;
+static struct net_context *udp_ctx;
+static K_SEM_DEFINE(rx_done, 0, ARRAY_SIZE(records));
+
+static void fake_dev_iface_init(struct net_if *iface)
+{
+	const struct device *dev = net_if_get_device(iface);
+	struct fake_dev_context *ctx = dev->data;
+	static uint8_t mac[] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x01 };
+
+	ctx->iface = iface;
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_DUMMY);
+}
+
+static int fake_dev_send(const struct device *dev, struct net_pkt *pkt)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static int fake_dev_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return 0;
+}
+
+static const struct dummy_api fake_dev_api = {
+	.iface_api.init = fake_dev_iface_init,
+	.send = fake_dev_send,
+};
+
+NET_DEVICE_INIT(fake_dev, "fake_dev", fake_dev_init, NULL,
+		&fake_dev_data, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &fake_dev_api,
+		DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 127);
+
+static void recv_cb(struct net_context *context, struct net_pkt *pkt,
+		    union net_ip_header *ip_hdr,
+		    union net_proto_header *proto_hdr,
+		    int status, void *user_data)
+{
+	struct rx_record *rec;
+	atomic_val_t idx;
+	uint16_t seq;
+
+	if (!pkt) {
+		return;
+	}
+
+	idx = atomic_inc(&record_count);
+	if (idx < ARRAY_SIZE(records) &&
+	    net_pkt_read_be16(pkt, &seq) == 0) {
+		rec = &records[idx];
+		rec->thread = k_current_get();
+		rec->port = ntohs(proto_hdr->udp->src_port);
+		rec->seq = seq;
+
+		k_sem_give(&rx_done);
+	}
+
+	net_pkt_unref(pkt);
+}
+
+/* Receive an UDP packet as if the driver had passed it to the stack */
+static int recv_udp(uint16_t src_port, uint16_t seq, uint32_t flow_hash)
+{
+	struct net_pkt *pkt;
+	int ret;
+
+	pkt = net_pkt_rx_alloc_with_buffer(fake_dev_data.iface,
+					   NET_UDPH_LEN + sizeof(seq),
+					   AF_INET, IPPROTO_UDP, WAIT_TIME);
+	if (!pkt) {
+		return -ENOMEM;
+	}
+
+	if (net_ipv4_create(pkt, &peer_addr, &local_addr) ||
+	    net_udp_create(pkt, htons(src_port), htons(LOCAL_PORT)) ||
+	    net_pkt_write_be16(pkt, seq)) {
+		net_pkt_unref(pkt);
+		return -ENOBUFS;
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_ipv4_finalize(pkt, IPPROTO_UDP);
+
+	net_pkt_set_flow_hash(pkt, flow_hash);
+
+	ret = net_recv_data(fake_dev_data.iface, pkt);
+	if (ret < 0) {
+		net_pkt_unref(pkt);
+	}
+
+	return ret;
+}
+
+static int wait_records(int count)
+{
+	while (count-- > 0) {
+		if (k_sem_take(&rx_done, WAIT_TIME) < 0) {
+			return -ETIMEDOUT;
+		}
+	}
+
+	return 0;
+}
+
+static int count_threads(int count)
+{
+	k_tid_t seen[NET_TC_RX_QUEUE_COUNT];
+	int seen_count = 0;
+	int i, j;
+
+	for (i = 0; i < count; i++) {
+		for (j = 0; j < seen_count; j++) {
+			if (seen[j] == records[i].thread) {
+				break;
+			}
+		}
+
+		if (j == seen_count && seen_count < ARRAY_SIZE(seen)) {
+			seen[seen_count++] = records[i].thread;
+		}
+	}
+
+	return seen_count;
+}
+
+static void *multiqueue_setup(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(LOCAL_PORT),
+		.sin_addr = local_addr,
+	};
+	struct net_if_addr *ifaddr;
+	int ret;
+
+	zassert_not_null(fake_dev_data.iface, "Interface not initialized");
+
+	ifaddr = net_if_ipv4_addr_add(fake_dev_data.iface, &local_addr,
+				      NET_ADDR_MANUAL, 0);
+	zassert_not_null(ifaddr, "Cannot add IPv4 address");
+
+	ret = net_context_get(AF_INET, SOCK_DGRAM, IPPROTO_UDP, &udp_ctx);
+	zassert_equal(ret, 0, "Cannot get context (%d)", ret);
+
+	ret = net_context_bind(udp_ctx, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_equal(ret, 0, "Cannot bind context (%d)", ret);
+
+	ret = net_context_recv(udp_ctx, recv_cb, K_NO_WAIT, NULL);
+	zassert_equal(ret, 0, "Cannot set receive callback (%d)", ret);
+
+	return NULL;
+}
+
+static void multiqueue_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	atomic_clear(&record_count);
+	k_sem_reset(&rx_done);
+	memset(records, 0, sizeof(records));
+}
+
+ZTEST(net_multiqueue, test_flows_keep_order)
+{
+	uint16_t last_seq[FLOW_COUNT];
+	k_tid_t flow_thread[FLOW_COUNT];
+	int flow, seq, i, ret;
+
+	/* Interleave the flows like they would arrive from the wire */
+	for (seq = 0; seq < PKTS_PER_FLOW; seq++) {
+		for (flow = 0; flow < FLOW_COUNT; flow++) {
+			ret = recv_udp(1024 + flow, seq, 0);
+			zassert_equal(ret, 0, "Cannot receive packet (%d)", ret);
+		}
+	}
+
+	ret = wait_records(ARRAY_SIZE(records));
+	zassert_equal(ret, 0, "Packets lost, %d received",
+		      (int)atomic_get(&record_count));
+
+	for (flow = 0; flow < FLOW_COUNT; flow++) {
+		flow_thread[flow] = NULL;
+		last_seq[flow] = 0;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(records); i++) {
+		flow = records[i].port - 1024;
+		zassert_true(flow >= 0 && flow < FLOW_COUNT, "Unknown flow");
+
+		if (flow_thread[flow] == NULL) {
+			zassert_equal(records[i].seq, 0, "Flow %d reordered",
+				      flow);
+			flow_thread[flow] = records[i].thread;
+			continue;
+		}
+
+		zassert_equal_ptr(flow_thread[flow], records[i].thread,
+				  "Flow %d processed by two queues", flow);
+		zassert_equal(records[i].seq, last_seq[flow] + 1,
+			      "Flow %d reordered", flow);
+
+		last_seq[flow] = records[i].seq;
+	}
+
+	zassert_true(count_threads(ARRAY_SIZE(records)) > 1,
+		     "All flows processed by one queue");
+}
+
+ZTEST(net_multiqueue, test_driver_flow_hash)
+{
+	int i, ret;
+
+	/* Same addresses and ports, the driver hash alone selects the queue */
+	for (i = 0; i < NET_TC_RX_QUEUE_COUNT; i++) {
+		ret = recv_udp(1024, i, i + 1);
+		zassert_equal(ret, 0, "Cannot receive packet (%d)", ret);
+	}
+
+	ret = wait_records(NET_TC_RX_QUEUE_COUNT);
+	zassert_equal(ret, 0, "Packets lost");
+
+	zassert_equal(count_threads(NET_TC_RX_QUEUE_COUNT),
+		      NET_TC_RX_QUEUE_COUNT, "Driver hash not used");
+}
+
+ZTEST_SUITE(net_multiqueue, NULL, multiqueue_setup, multiqueue_before,
+	    NULL, NULL);
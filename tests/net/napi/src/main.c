@@ -0,0 +1,335 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_CORE_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/net_core.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/dummy.h>
+
+#define WAIT_TIME K_MSEC(500)
+#define TEST_PKT_LEN 64
+
+struct fake_dev_context {
+	struct net_napi napi;
+	struct net_if *iface;
+
+	/* Number of frames waiting in the simulated RX ring */
+	int pending;
+
+	/* Simulated RX interrupt mask state */
+	bool irq_enabled;
+
+	int poll_calls;
+	int received;
+	struct k_sem irq_on;
+
+	/* Give the RX threads a chance to run before the poll returns */
+	bool check_batch;
+
+	/* Packets released by the RX threads while the poll was running */
+	int released_in_poll;
+};
+
+static struct fake_dev_context fake_dev_context_data;
+
+static int fake_dev_poll(struct net_napi *napi, int budget)
+{
+	struct fake_dev_context *ctx =
+		CONTAINER_OF(napi, struct fake_dev_context, napi);
+	static const uint8_t frame[TEST_PKT_LEN];
+	struct k_mem_slab *rx;
+	struct net_pkt *pkt;
+	uint32_t free_count;
+	int done = 0;
+
+	ctx->poll_calls++;
+
+	while (done < budget && ctx->pending > 0) {
+		ctx->pending--;
+		done++;
+
+		pkt = net_pkt_rx_alloc_with_buffer(ctx->iface, sizeof(frame),
+						   AF_UNSPEC, 0, K_NO_WAIT);
+		if (!pkt) {
+			continue;
+		}
+
+		if (net_pkt_write(pkt, frame, sizeof(frame)) < 0 ||
+		    net_napi_recv(napi, ctx->iface, pkt) < 0) {
+			net_pkt_unref(pkt);
+			continue;
+		}
+
+		ctx->received++;
+	}
+
+	if (ctx->check_batch) {
+		/* Packets queued one by one would be processed and released
+		 * while the poll sleeps here.
+		 */
+		net_pkt_get_info(&rx, NULL, NULL, NULL);
+		free_count = k_mem_slab_num_free_get(rx);
+
+		k_msleep(10);
+
+		ctx->released_in_poll += k_mem_slab_num_free_get(rx) -
+					 free_count;
+	}
+
+	if (done < budget) {
+		ctx->irq_enabled = true;
+		k_sem_give(&ctx->irq_on);
+	}
+
+	return done;
+}
+
+/* Simulate a burst of frames raising the RX interrupt */
+static void fake_dev_rx_burst(struct fake_dev_context *ctx, int count)
+{
+	unsigned int key = irq_lock();
+
+	ctx->pending += count;
+
+	if (ctx->irq_enabled) {
+		ctx->irq_enabled = false;
+		net_napi_schedule(&ctx->napi);
+	}
+
+	irq_unlock(key);
+}
+
+static void fake_dev_iface_init(struct net_if *iface)
+{
+	static uint8_t mac[] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x01 };
+	const struct device *dev = net_if_get_device(iface);
+	struct fake_dev_context *ctx = dev->data;
+
+	ctx->iface = iface;
+	ctx->irq_enabled = true;
+	k_sem_init(&ctx->irq_on, 0, K_SEM_MAX_LIMIT);
+
+	net_napi_init(&ctx->napi, fake_dev_poll, 0);
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_DUMMY);
+}
+
+static int fake_dev_send(const struct device *dev, struct net_pkt *pkt)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static int fake_dev_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return 0;
+}
+
+static const struct dummy_api fake_dev_api = {
+	.iface_api.init = fake_dev_iface_init,
+	.send = fake_dev_send,
+};
+
+NET_DEVICE_INIT(fake_dev, "fake_dev", fake_dev_init, NULL,
+		&fake_dev_context_data, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &fake_dev_api,
+		DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 127);
+
+static void wait_for_irq_enabled(struct fake_dev_context *ctx)
+{
+	zassert_equal(k_sem_take(&ctx->irq_on, WAIT_TIME), 0,
+		      "RX interrupt was not re-enabled");
+	zassert_true(ctx->irq_enabled, "RX interrupt is disabled");
+}
+
+static void wait_for_rx_slab_free(int expected)
+{
+	struct k_mem_slab *rx;
+	int i;
+
+	net_pkt_get_info(&rx, NULL, NULL, NULL);
+
+	/* Packets are released once the RX thread has processed them */
+	for (i = 0; i < 10; i++) {
+		if (k_mem_slab_num_free_get(rx) == expected) {
+			break;
+		}
+
+		k_msleep(50);
+	}
+
+	zassert_equal(k_mem_slab_num_free_get(rx), expected,
+		      "Received packets were not released");
+}
+
+static void napi_before(void *fixture)
+{
+	struct fake_dev_context *ctx = &fake_dev_context_data;
+
+	ARG_UNUSED(fixture);
+
+	ctx->poll_calls = 0;
+	ctx->received = 0;
+	ctx->check_batch = false;
+	ctx->released_in_poll = 0;
+	k_sem_reset(&ctx->irq_on);
+}
+
+ZTEST(net_napi, test_poll_within_budget)
+{
+	struct fake_dev_context *ctx = &fake_dev_context_data;
+
+	fake_dev_rx_burst(ctx, CONFIG_NET_NAPI_BUDGET - 1);
+	wait_for_irq_enabled(ctx);
+
+	zassert_equal(ctx->poll_calls, 1, "Unexpected poll calls (%d)",
+		      ctx->poll_calls);
+	zassert_equal(ctx->received, CONFIG_NET_NAPI_BUDGET - 1,
+		      "Unexpected received count (%d)", ctx->received);
+}
+
+ZTEST(net_napi, test_poll_over_budget)
+{
+	struct fake_dev_context *ctx = &fake_dev_context_data;
+	int count = 2 * CONFIG_NET_NAPI_BUDGET + 1;
+
+	fake_dev_rx_burst(ctx, count);
+	wait_for_irq_enabled(ctx);
+
+	/* The interrupt stays off while the whole budget is consumed */
+	zassert_equal(ctx->poll_calls, 3, "Unexpected poll calls (%d)",
+		      ctx->poll_calls);
+	zassert_equal(ctx->pending, 0, "Frames left in the ring");
+}
+
+ZTEST(net_napi, test_poll_exact_budget)
+{
+	struct fake_dev_context *ctx = &fake_dev_context_data;
+
+	/* A full budget needs one more poll to find out the ring is empty */
+	fake_dev_rx_burst(ctx, CONFIG_NET_NAPI_BUDGET);
+	wait_for_irq_enabled(ctx);
+
+	zassert_equal(ctx->poll_calls, 2, "Unexpected poll calls (%d)",
+		      ctx->poll_calls);
+	zassert_equal(ctx->received, CONFIG_NET_NAPI_BUDGET,
+		      "Unexpected received count (%d)", ctx->received);
+}
+
+ZTEST(net_napi, test_batch_released)
+{
+	struct fake_dev_context *ctx = &fake_dev_context_data;
+	struct k_mem_slab *rx;
+	int free_count;
+
+	net_pkt_get_info(&rx, NULL, NULL, NULL);
+	free_count = k_mem_slab_num_free_get(rx);
+
+	fake_dev_rx_burst(ctx, CONFIG_NET_PKT_RX_COUNT / 2);
+	wait_for_irq_enabled(ctx);
+
+	wait_for_rx_slab_free(free_count);
+}
+
+ZTEST(net_napi, test_batch_queued_on_return)
+{
+	struct fake_dev_context *ctx = &fake_dev_context_data;
+	struct k_mem_slab *rx;
+	int free_count;
+
+	net_pkt_get_info(&rx, NULL, NULL, NULL);
+	free_count = k_mem_slab_num_free_get(rx);
+
+	ctx->check_batch = true;
+
+	fake_dev_rx_burst(ctx, CONFIG_NET_NAPI_BUDGET - 1);
+	wait_for_irq_enabled(ctx);
+
+	zassert_equal(ctx->released_in_poll, 0,
+		      "%d packets processed before the poll returned",
+		      ctx->released_in_poll);
+
+	wait_for_rx_slab_free(free_count);
+}
+
+#define PPS_FRAMES 512
+#define PPS_BURST (CONFIG_NET_PKT_RX_COUNT / 2)
+#define PPS_TIMEOUT_MS 1000
+
+static void wait_for_rx_slab_free_busy(struct k_mem_slab *rx, int expected)
+{
+	int64_t end = k_uptime_get() + PPS_TIMEOUT_MS;
+
+	while (k_mem_slab_num_free_get(rx) != expected) {
+		zassert_true(k_uptime_get() < end,
+			     "Received packets were not released");
+		k_yield();
+	}
+}
+
+/* Receive PPS_FRAMES frames in bursts and return the packets per second */
+static uint32_t rx_pps(struct fake_dev_context *ctx, bool napi)
+{
+	static const uint8_t frame[TEST_PKT_LEN];
+	struct k_mem_slab *rx;
+	struct net_pkt *pkt;
+	int free_count;
+	uint32_t start;
+	uint64_t us;
+
+	net_pkt_get_info(&rx, NULL, NULL, NULL);
+	free_count = k_mem_slab_num_free_get(rx);
+
+	start = k_cycle_get_32();
+
+	for (int sent = 0; sent < PPS_FRAMES; sent += PPS_BURST) {
+		if (napi) {
+			fake_dev_rx_burst(ctx, PPS_BURST);
+		} else {
+			for (int i = 0; i < PPS_BURST; i++) {
+				pkt = net_pkt_rx_alloc_with_buffer(
+					ctx->iface, sizeof(frame), AF_UNSPEC, 0,
+					K_NO_WAIT);
+				zassert_not_null(pkt, "Out of packets");
+				zassert_ok(net_pkt_write(pkt, frame,
+							 sizeof(frame)));
+
+				if (net_recv_data(ctx->iface, pkt) < 0) {
+					net_pkt_unref(pkt);
+				}
+			}
+		}
+
+		wait_for_rx_slab_free_busy(rx, free_count);
+	}
+
+	us = k_cyc_to_us_ceil64(k_cycle_get_32() - start);
+
+	return (uint32_t)(PPS_FRAMES * USEC_PER_SEC / MAX(us, 1));
+}
+
+ZTEST(net_napi, test_rx_pps)
+{
+	struct fake_dev_context *ctx = &fake_dev_context_data;
+	uint32_t direct_pps, napi_pps;
+
+	direct_pps = rx_pps(ctx, false);
+	napi_pps = rx_pps(ctx, true);
+
+	wait_for_irq_enabled(ctx);
+
+	TC_PRINT("%d frames in bursts of %d: %u pps direct, %u pps polled\n",
+		 PPS_FRAMES, PPS_BURST, direct_pps, napi_pps);
+}
+
+ZTEST_SUITE(net_napi, NULL, NULL, napi_before, NULL, NULL);
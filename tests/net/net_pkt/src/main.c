@@ -1117,6 +1117,56 @@ ZTEST(net_pkt_test_suite, test_net_pkt_remove_tail)
 	net_pkt_unref(pkt);
 }
 
+ZTEST(net_pkt_test_suite, test_net_pkt_dma_map)
+{
+	struct net_pkt_dma_seg segs[3];
+	struct net_buf *frag;
+	struct net_pkt *pkt;
+	int count, i;
+
+	pkt = net_pkt_alloc_with_buffer(NULL,
+					CONFIG_NET_BUF_DATA_SIZE * 2 + 3,
+					AF_UNSPEC, 0, K_NO_WAIT);
+	zassert_true(pkt != NULL, "Pkt not allocated");
+
+	count = net_pkt_dma_map(pkt, segs, ARRAY_SIZE(segs));
+	zassert_equal(count, -ENODATA, "Empty packet mapped");
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_write(pkt, small_buffer, CONFIG_NET_BUF_DATA_SIZE * 2 + 3);
+
+	/* Empty fragments do not need a descriptor */
+	frag = net_pkt_get_frag(pkt, CONFIG_NET_BUF_DATA_SIZE, K_NO_WAIT);
+	zassert_true(frag != NULL, "Frag not allocated");
+	net_pkt_frag_insert(pkt, frag);
+
+	count = net_pkt_dma_map(pkt, segs, ARRAY_SIZE(segs));
+	zassert_equal(count, 3, "Wrong number of segments");
+
+	for (i = 0, frag = pkt->frags->frags; i < count;
+	     i++, frag = frag->frags) {
+		zassert_equal_ptr(segs[i].frag, frag, "Wrong fragment");
+		zassert_equal(segs[i].len, frag->len, "Wrong length");
+
+		/* Driver buffers are translated like fragments */
+		zassert_equal(segs[i].addr,
+			      net_pkt_dma_map_data(frag->data, frag->len),
+			      "Wrong buffer address");
+
+		if (!IS_ENABLED(CONFIG_MMU)) {
+			zassert_equal(segs[i].addr, POINTER_TO_UINT(frag->data),
+				      "Wrong address");
+		}
+	}
+
+	zassert_equal(segs[2].len, 3, "Wrong last segment length");
+
+	count = net_pkt_dma_map(pkt, segs, ARRAY_SIZE(segs) - 1);
+	zassert_equal(count, -E2BIG, "Too many segments mapped");
+
+	net_pkt_unref(pkt);
+}
+
 ZTEST(net_pkt_test_suite, test_net_pkt_shallow_clone_noleak_buf)
 {
 	const int bufs_to_allocate = 3;
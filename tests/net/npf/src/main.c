@@ -17,6 +17,7 @@ LOG_MODULE_REGISTER(npf_test, NET_LOG_LEVEL);
 #include <zephyr/sys/printk.h>
 
 #include <zephyr/ztest.h>
+#include <zephyr/irq_offload.h>
 
 #include <zephyr/net/net_if.h>
 #include <zephyr/net/ethernet.h>
@@ -314,4 +315,142 @@ ZTEST(net_pkt_filter_test_suite, test_npf_address_mask)
 	test_npf_eth_mac_addr_mask();
 }
 
+/*
+ * Custom test functions are kept as is when rules are compiled, and may
+ * be listed before built-in tests in a rule.
+ */
+
+static bool odd_size_match(struct npf_test *test, struct net_pkt *pkt)
+{
+	ARG_UNUSED(test);
+
+	return (net_pkt_get_len(pkt) & 1) != 0;
+}
+
+static struct {
+	struct npf_test test;
+} odd_size = {
+	.test.fn = odd_size_match,
+};
+
+static NPF_RULE(reject_odd_ip, NET_DROP, odd_size, ip_packet);
+static NPF_RULE(accept_odd_non_ip, NET_OK, odd_size, not_ip_packet,
+		maxsize_200);
+
+ZTEST(net_pkt_filter_test_suite, test_npf_custom_test)
+{
+	struct net_pkt *pkt;
+
+	npf_append_recv_rule(&reject_odd_ip);
+	npf_append_recv_rule(&accept_odd_non_ip);
+	npf_append_recv_rule(&npf_default_ok);
+
+	pkt = build_test_pkt(NET_ETH_PTYPE_IP, 101, NULL);
+	zassert_false(net_pkt_filter_recv_ok(pkt), "");
+	net_pkt_unref(pkt);
+
+	pkt = build_test_pkt(NET_ETH_PTYPE_IP, 100, NULL);
+	zassert_true(net_pkt_filter_recv_ok(pkt), "");
+	net_pkt_unref(pkt);
+
+	pkt = build_test_pkt(NET_ETH_PTYPE_ARP, 101, NULL);
+	zassert_true(net_pkt_filter_recv_ok(pkt), "");
+	net_pkt_unref(pkt);
+
+	/* the default rule is the last one */
+	zassert_true(npf_remove_recv_rule(&npf_default_ok), "");
+	npf_append_recv_rule(&npf_default_drop);
+
+	pkt = build_test_pkt(NET_ETH_PTYPE_ARP, 301, NULL);
+	zassert_false(net_pkt_filter_recv_ok(pkt), "");
+	net_pkt_unref(pkt);
+
+	zassert_true(npf_remove_all_recv_rules(), "");
+}
+
+/*
+ * Rules inserted from an ISR.
+ */
+
+static NPF_RULE(reject_ip, NET_DROP, ip_packet);
+
+static void insert_from_isr(const void *param)
+{
+	npf_insert_recv_rule((struct npf_rule *)param);
+}
+
+ZTEST(net_pkt_filter_test_suite, test_npf_insert_from_isr)
+{
+	struct net_pkt *pkt = build_test_pkt(NET_ETH_PTYPE_IP, 100, NULL);
+
+	npf_append_recv_rule(&npf_default_ok);
+	zassert_true(net_pkt_filter_recv_ok(pkt), "");
+
+	irq_offload(insert_from_isr, &reject_ip);
+
+	/* applies right away, before any compiled program is rebuilt */
+	zassert_false(net_pkt_filter_recv_ok(pkt), "");
+
+	k_msleep(10);
+	zassert_false(net_pkt_filter_recv_ok(pkt), "");
+
+	zassert_true(npf_remove_recv_rule(&reject_ip), "");
+	zassert_true(net_pkt_filter_recv_ok(pkt), "");
+
+	zassert_true(npf_remove_all_recv_rules(), "");
+	net_pkt_unref(pkt);
+}
+
+/*
+ * Filtering cost with a growing number of non matching rules.
+ */
+
+#define COST_RULES 32
+#define COST_ROUNDS 1000
+
+#define COST_RULE_DEFINE(n, _)						\
+	static NPF_ETH_TYPE_MATCH(cost_type_##n, 0x8800 + n);		\
+	static NPF_RULE(cost_rule_##n, NET_DROP, cost_type_##n, maxsize_200)
+#define COST_RULE_ADDR(n, _) &cost_rule_##n
+
+LISTIFY(COST_RULES, COST_RULE_DEFINE, (;));
+
+static struct npf_rule *cost_rules[] = {
+	LISTIFY(COST_RULES, COST_RULE_ADDR, (,))
+};
+
+ZTEST(net_pkt_filter_test_suite, test_npf_eval_cost)
+{
+	struct net_pkt *pkt = build_test_pkt(NET_ETH_PTYPE_IP, 100, NULL);
+	uint32_t start, cycles;
+	int i, j;
+
+	npf_append_recv_rule(&npf_default_ok);
+
+	for (i = 0; i < ARRAY_SIZE(cost_rules); i++) {
+		npf_insert_recv_rule(cost_rules[i]);
+
+		if ((i + 1) % 8 != 0) {
+			continue;
+		}
+
+		/* let the compiled program be rebuilt */
+		k_msleep(10);
+
+		start = k_cycle_get_32();
+
+		for (j = 0; j < COST_ROUNDS; j++) {
+			zassert_true(net_pkt_filter_recv_ok(pkt), "");
+		}
+
+		cycles = k_cycle_get_32() - start;
+
+		TC_PRINT("%d rules: %u cycles per packet\n", i + 1,
+			 cycles / COST_ROUNDS);
+	}
+
+	zassert_true(npf_remove_all_recv_rules(), "");
+	net_pkt_unref(pkt);
+}
+
 ZTEST_SUITE(net_pkt_filter_test_suite, NULL, test_npf_iface, NULL, NULL, NULL);
@@ -0,0 +1,443 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_PKT_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/net_core.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_ip.h>
+#include <zephyr/net/net_mgmt.h>
+#include <zephyr/net/net_context.h>
+#include <zephyr/net/dummy.h>
+
+#define TEST_PKT_LEN 64
+#define POOL_PKT_COUNT 4
+#define POOL_LOW_WATERMARK 1
+#define POOL_HIGH_WATERMARK 3
+
+/* Allocating on the quiet interface must not wait for the busy one */
+#define MAX_ALLOC_LATENCY_MS 10
+#define STARVED_WAIT K_MSEC(50)
+
+NET_PKT_POOL_DEFINE(flood_pool, POOL_PKT_COUNT, 2 * POOL_PKT_COUNT,
+		    POOL_LOW_WATERMARK, POOL_HIGH_WATERMARK);
+
+static struct in_addr quiet_addr = { { { 192, 0, 2, 2 } } };
+static struct in_addr peer_addr = { { { 192, 0, 2, 3 } } };
+
+struct fake_dev_context {
+	struct net_if *iface;
+};
+
+static struct fake_dev_context flood_dev_data;
+static struct fake_dev_context quiet_dev_data;
+
+static struct net_pkt *held[CONFIG_NET_PKT_RX_COUNT + POOL_PKT_COUNT];
+static int held_count;
+
+static int congestion_events;
+static bool congested;
+
+static void fake_dev_iface_init(struct net_if *iface)
+{
+	const struct device *dev = net_if_get_device(iface);
+	struct fake_dev_context *ctx = dev->data;
+	static uint8_t mac[] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x00 };
+
+	ctx->iface = iface;
+
+	/* Each interface gets its own link address */
+	mac[5]++;
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_DUMMY);
+}
+
+static int fake_dev_send(const struct device *dev, struct net_pkt *pkt)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static int fake_dev_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return 0;
+}
+
+static const struct dummy_api fake_dev_api = {
+	.iface_api.init = fake_dev_iface_init,
+	.send = fake_dev_send,
+};
+
+NET_DEVICE_INIT(flood_dev, "flood_dev", fake_dev_init, NULL,
+		&flood_dev_data, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &fake_dev_api,
+		DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 127);
+
+NET_DEVICE_INIT(quiet_dev, "quiet_dev", fake_dev_init, NULL,
+		&quiet_dev_data, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &fake_dev_api,
+		DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 127);
+
+static void pool_cb(struct net_pkt_pool *pool, bool is_congested)
+{
+	ARG_UNUSED(pool);
+
+	congestion_events++;
+	congested = is_congested;
+}
+
+/* Receive packets on the interface and hold on to them, like a flood that
+ * the stack cannot process fast enough.
+ */
+static int flood(struct net_if *iface)
+{
+	struct net_pkt *pkt;
+	int count = 0;
+
+	while (held_count < ARRAY_SIZE(held)) {
+		pkt = net_pkt_rx_alloc_with_buffer(iface, TEST_PKT_LEN,
+						   AF_UNSPEC, 0, K_NO_WAIT);
+		if (!pkt) {
+			break;
+		}
+
+		held[held_count++] = pkt;
+		count++;
+	}
+
+	return count;
+}
+
+static void release(int count)
+{
+	while (count-- > 0 && held_count > 0) {
+		net_pkt_unref(held[--held_count]);
+	}
+}
+
+static struct net_pkt *timed_rx_alloc(struct net_if *iface,
+				      k_timeout_t timeout, int64_t *elapsed)
+{
+	int64_t start = k_uptime_get();
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_rx_alloc_with_buffer(iface, TEST_PKT_LEN, AF_UNSPEC, 0,
+					   timeout);
+
+	*elapsed = k_uptime_get() - start;
+
+	return pkt;
+}
+
+static int shared_rx_free(void)
+{
+	struct k_mem_slab *rx;
+
+	net_pkt_get_info(&rx, NULL, NULL, NULL);
+
+	return k_mem_slab_num_free_get(rx);
+}
+
+static void get_pool_stats(struct net_if *iface,
+			   struct net_stats_pkt_pool *stats)
+{
+	int ret;
+
+	ret = net_mgmt(NET_REQUEST_STATS_GET_PKT_POOL, iface, stats,
+		       sizeof(*stats));
+	zassert_equal(ret, 0, "Cannot get pool statistics (%d)", ret);
+}
+
+static void *pkt_pool_setup(void)
+{
+	struct net_if_addr *ifaddr;
+
+	zassert_not_null(flood_dev_data.iface, "Interface not initialized");
+	zassert_not_null(quiet_dev_data.iface, "Interface not initialized");
+
+	ifaddr = net_if_ipv4_addr_add(quiet_dev_data.iface, &quiet_addr,
+				      NET_ADDR_MANUAL, 0);
+	zassert_not_null(ifaddr, "Cannot add IPv4 address");
+
+	net_if_ipv4_set_netmask(quiet_dev_data.iface,
+				&(struct in_addr){ { { 255, 255, 255, 0 } } });
+
+	return NULL;
+}
+
+static void pkt_pool_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	flood_pool.fallback = false;
+	flood_pool.cb = pool_cb;
+	congestion_events = 0;
+	congested = false;
+}
+
+static void pkt_pool_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	release(held_count);
+
+	(void)net_if_pkt_pool_bind(flood_dev_data.iface, NET_IF_PKT_POOL_RX,
+				   NET_IF_PKT_POOL_ALL_TC, NULL);
+	(void)net_if_pkt_pool_bind(quiet_dev_data.iface, NET_IF_PKT_POOL_TX,
+				   NET_IF_PKT_POOL_ALL_TC, NULL);
+}
+
+ZTEST(net_pkt_pool, test_shared_pool_starvation)
+{
+	struct net_pkt *pkt;
+	int64_t elapsed;
+
+	/* Without a dedicated pool, the flood takes all the packets */
+	flood(flood_dev_data.iface);
+	zassert_equal(shared_rx_free(), 0, "Shared pool not exhausted");
+
+	pkt = timed_rx_alloc(quiet_dev_data.iface, STARVED_WAIT, &elapsed);
+	zassert_is_null(pkt, "Quiet interface was not starved");
+}
+
+ZTEST(net_pkt_pool, test_dedicated_pool_isolation)
+{
+	int shared_free = shared_rx_free();
+	struct net_pkt *pkt;
+	int64_t elapsed;
+	int ret;
+
+	ret = net_if_pkt_pool_bind(flood_dev_data.iface, NET_IF_PKT_POOL_RX,
+				   NET_IF_PKT_POOL_ALL_TC, &flood_pool);
+	zassert_equal(ret, 0, "Cannot bind pool (%d)", ret);
+
+	ret = flood(flood_dev_data.iface);
+	zassert_equal(ret, POOL_PKT_COUNT, "Flood used %d packets", ret);
+	zassert_equal(shared_rx_free(), shared_free,
+		      "Flood used the shared pool");
+
+	pkt = timed_rx_alloc(quiet_dev_data.iface, STARVED_WAIT, &elapsed);
+	zassert_not_null(pkt, "Quiet interface was starved");
+	zassert_true(elapsed <= MAX_ALLOC_LATENCY_MS,
+		     "Allocation took %lld ms", elapsed);
+	zassert_is_null(pkt->pool, "Quiet interface used the dedicated pool");
+
+	net_pkt_unref(pkt);
+}
+
+ZTEST(net_pkt_pool, test_fallback_reserve)
+{
+	struct net_stats_pkt_pool before, after;
+	int shared_free = shared_rx_free();
+	struct net_pkt *pkt;
+	int64_t elapsed;
+	int ret;
+
+	flood_pool.fallback = true;
+
+	ret = net_if_pkt_pool_bind(flood_dev_data.iface, NET_IF_PKT_POOL_RX,
+				   NET_IF_PKT_POOL_ALL_TC, &flood_pool);
+	zassert_equal(ret, 0, "Cannot bind pool (%d)", ret);
+
+	get_pool_stats(flood_dev_data.iface, &before);
+
+	/* The flood borrows from the shared pool, but not the reserve */
+	ret = flood(flood_dev_data.iface);
+	zassert_equal(ret, POOL_PKT_COUNT + shared_free -
+		      CONFIG_NET_PKT_POOL_SHARED_RESERVE,
+		      "Flood used %d packets", ret);
+	zassert_equal(shared_rx_free(), CONFIG_NET_PKT_POOL_SHARED_RESERVE,
+		      "Shared reserve was used");
+
+	get_pool_stats(flood_dev_data.iface, &after);
+	zassert_equal(after.alloc - before.alloc, POOL_PKT_COUNT,
+		      "Wrong dedicated allocation count");
+	zassert_equal(after.fallback - before.fallback,
+		      shared_free - CONFIG_NET_PKT_POOL_SHARED_RESERVE,
+		      "Wrong borrowed count");
+	zassert_true(after.alloc_failed > before.alloc_failed,
+		     "Failed allocation not counted");
+
+	pkt = timed_rx_alloc(quiet_dev_data.iface, STARVED_WAIT, &elapsed);
+	zassert_not_null(pkt, "Quiet interface was starved");
+	zassert_true(elapsed <= MAX_ALLOC_LATENCY_MS,
+		     "Allocation took %lld ms", elapsed);
+
+	net_pkt_unref(pkt);
+}
+
+ZTEST(net_pkt_pool, test_congestion_watermarks)
+{
+	struct net_stats_pkt_pool before, after;
+	int ret;
+
+	ret = net_if_pkt_pool_bind(flood_dev_data.iface, NET_IF_PKT_POOL_RX,
+				   NET_IF_PKT_POOL_ALL_TC, &flood_pool);
+	zassert_equal(ret, 0, "Cannot bind pool (%d)", ret);
+
+	get_pool_stats(flood_dev_data.iface, &before);
+
+	flood(flood_dev_data.iface);
+	zassert_true(net_pkt_pool_is_congested(&flood_pool),
+		     "Pool not congested");
+	zassert_true(congested, "Congestion not signalled");
+	zassert_equal(congestion_events, 1, "Wrong number of events");
+
+	get_pool_stats(flood_dev_data.iface, &after);
+	zassert_equal(after.congested - before.congested, 1,
+		      "Congestion not counted");
+
+	/* Congestion lasts until the high watermark is reached */
+	release(POOL_HIGH_WATERMARK - 1);
+	zassert_true(net_pkt_pool_is_congested(&flood_pool),
+		     "Congestion cleared too early");
+
+	release(1);
+	zassert_false(net_pkt_pool_is_congested(&flood_pool),
+		      "Congestion not cleared");
+	zassert_false(congested, "End of congestion not signalled");
+	zassert_equal(congestion_events, 2, "Wrong number of events");
+}
+
+ZTEST(net_pkt_pool, test_clone_from_pool)
+{
+	struct net_pkt *clone;
+	struct net_buf *frag;
+	int ret;
+
+	ret = net_if_pkt_pool_bind(flood_dev_data.iface, NET_IF_PKT_POOL_RX,
+				   NET_IF_PKT_POOL_ALL_TC, &flood_pool);
+	zassert_equal(ret, 0, "Cannot bind pool (%d)", ret);
+
+	ret = flood(flood_dev_data.iface);
+	zassert_equal(ret, POOL_PKT_COUNT, "Flood used %d packets", ret);
+	release(1);
+
+	/* The clone and its data come from the pool of the original */
+	clone = net_pkt_clone(held[0], K_NO_WAIT);
+	zassert_not_null(clone, "Cannot clone packet");
+	zassert_equal_ptr(clone->pool, &flood_pool,
+			  "Clone not taken from the pool");
+	zassert_equal_ptr(net_buf_pool_get(clone->buffer->pool_id),
+			  flood_pool.data_pool,
+			  "Clone data not taken from the pool");
+
+	frag = net_pkt_get_frag(clone, TEST_PKT_LEN, K_NO_WAIT);
+	zassert_not_null(frag, "Cannot get fragment");
+	zassert_equal_ptr(net_buf_pool_get(frag->pool_id), flood_pool.data_pool,
+			  "Fragment not taken from the pool");
+	net_buf_unref(frag);
+
+	zassert_true(net_pkt_pool_is_congested(&flood_pool),
+		     "Pool not congested");
+
+	/* Freeing the clone is accounted to the pool */
+	net_pkt_unref(clone);
+	release(held_count);
+
+	zassert_false(net_pkt_pool_is_congested(&flood_pool),
+		      "Congestion not cleared");
+}
+
+ZTEST(net_pkt_pool, test_sender_backpressure)
+{
+	struct sockaddr_in local = {
+		.sin_family = AF_INET,
+		.sin_addr = quiet_addr,
+	};
+	struct sockaddr_in peer = {
+		.sin_family = AF_INET,
+		.sin_port = htons(4242),
+		.sin_addr = peer_addr,
+	};
+	static const uint8_t data[TEST_PKT_LEN];
+	struct net_context *ctx;
+	struct net_pkt *pkt;
+	int ret;
+
+	ret = net_if_pkt_pool_bind(quiet_dev_data.iface, NET_IF_PKT_POOL_TX,
+				   NET_IF_PKT_POOL_ALL_TC, &flood_pool);
+	zassert_equal(ret, 0, "Cannot bind pool (%d)", ret);
+
+	ret = net_context_get(AF_INET, SOCK_DGRAM, IPPROTO_UDP, &ctx);
+	zassert_equal(ret, 0, "Cannot get context (%d)", ret);
+
+	ret = net_context_bind(ctx, (struct sockaddr *)&local, sizeof(local));
+	zassert_equal(ret, 0, "Cannot bind context (%d)", ret);
+
+	ret = net_context_sendto(ctx, data, sizeof(data),
+				 (struct sockaddr *)&peer, sizeof(peer),
+				 NULL, K_NO_WAIT, NULL);
+	zassert_equal(ret, sizeof(data), "Send failed (%d)", ret);
+
+	/* Let the TX path release the sent packet */
+	k_msleep(10);
+
+	/* Take the pool down to its low watermark */
+	while (!net_pkt_pool_is_congested(&flood_pool)) {
+		pkt = net_pkt_alloc_from_pool(&flood_pool,
+					      quiet_dev_data.iface, K_NO_WAIT);
+		zassert_not_null(pkt, "Cannot allocate from pool");
+
+		held[held_count++] = pkt;
+	}
+
+	ret = net_context_sendto(ctx, data, sizeof(data),
+				 (struct sockaddr *)&peer, sizeof(peer),
+				 NULL, K_NO_WAIT, NULL);
+	zassert_equal(ret, -ENOBUFS, "Sender not throttled (%d)", ret);
+
+	/* The stack itself can still use the rest of the pool */
+	pkt = net_pkt_alloc_with_buffer(quiet_dev_data.iface, TEST_PKT_LEN,
+					AF_UNSPEC, 0, K_NO_WAIT);
+	zassert_not_null(pkt, "Reserve not available to the stack");
+	zassert_equal_ptr(pkt->pool, &flood_pool, "Wrong pool");
+	held[held_count++] = pkt;
+
+	release(held_count);
+
+	ret = net_context_sendto(ctx, data, sizeof(data),
+				 (struct sockaddr *)&peer, sizeof(peer),
+				 NULL, K_NO_WAIT, NULL);
+	zassert_equal(ret, sizeof(data), "Send failed (%d)", ret);
+
+	net_context_put(ctx);
+}
+
+ZTEST(net_pkt_pool, test_traffic_class_binding)
+{
+	int ret;
+
+	if (NET_TC_TX_COUNT < 2) {
+		ztest_test_skip();
+	}
+
+	ret = net_if_pkt_pool_bind(quiet_dev_data.iface, NET_IF_PKT_POOL_TX,
+				   net_tx_priority2tc(NET_PRIORITY_VO),
+				   &flood_pool);
+	zassert_equal(ret, 0, "Cannot bind pool (%d)", ret);
+
+	zassert_equal_ptr(net_if_pkt_pool_get(quiet_dev_data.iface,
+					      NET_IF_PKT_POOL_TX,
+					      NET_PRIORITY_VO),
+			  &flood_pool, "Pool not used for bound class");
+	zassert_is_null(net_if_pkt_pool_get(quiet_dev_data.iface,
+					    NET_IF_PKT_POOL_TX,
+					    NET_PRIORITY_BK),
+			"Pool used for other class");
+
+	ret = net_if_pkt_pool_bind(quiet_dev_data.iface, NET_IF_PKT_POOL_TX,
+				   NET_TC_TX_COUNT, &flood_pool);
+	zassert_equal(ret, -EINVAL, "Invalid class accepted");
+}
+
+ZTEST_SUITE(net_pkt_pool, NULL, pkt_pool_setup, pkt_pool_before,
+	    pkt_pool_after, NULL);
@@ -544,6 +544,183 @@ static void test_route_preference(void)
 	net_route_del(entry);
 }
 
+static void test_route_longest_prefix(void)
+{
+	struct net_route_entry *host, *prefix, *found;
+	struct in6_addr addr;
+
+	host = net_route_add(my_iface, &dest_addr, 128, &peer_addr,
+			     NET_IPV6_ND_INFINITE_LIFETIME,
+			     NET_ROUTE_PREFERENCE_LOW);
+	zassert_not_null(host, "Host route add failed");
+
+	prefix = net_route_add(my_iface, &generic_addr, 64, &peer_addr,
+			       NET_IPV6_ND_INFINITE_LIFETIME,
+			       NET_ROUTE_PREFERENCE_LOW);
+	zassert_not_null(prefix, "Prefix route add failed");
+
+	found = net_route_lookup(my_iface, &dest_addr);
+	zassert_equal_ptr(found, host, "Longest prefix not selected");
+
+	net_ipaddr_copy(&addr, &generic_addr);
+	addr.s6_addr[15] = 0x42;
+
+	found = net_route_lookup(my_iface, &addr);
+	zassert_equal_ptr(found, prefix, "Prefix route not selected");
+
+	found = net_route_lookup(my_iface, &dest_addr);
+	zassert_equal_ptr(found, host, "Cached lookup mismatch");
+
+	zassert_false(net_route_del(host), "Host route del failed");
+
+	/* Cached result must not survive the route removal */
+	found = net_route_lookup(my_iface, &dest_addr);
+	zassert_equal_ptr(found, prefix, "Fallback to prefix route failed");
+
+	zassert_false(net_route_del(prefix), "Prefix route del failed");
+
+	found = net_route_lookup(my_iface, &dest_addr);
+	zassert_is_null(found, "Route found after delete");
+}
+
+#if defined(CONFIG_NET_ROUTE_IPV4)
+#define IPV4_BENCH_LOOKUPS 1000
+
+static struct net_route_entry_ipv4 *ipv4_routes[CONFIG_NET_MAX_ROUTES_IPV4];
+
+static struct net_route_entry_ipv4 *add_ipv4_route(struct net_if *iface,
+						   const char *prefix,
+						   uint8_t len,
+						   const char *gw)
+{
+	struct in_addr addr, gw_addr = { 0 };
+
+	net_addr_pton(AF_INET, prefix, &addr);
+
+	if (gw) {
+		net_addr_pton(AF_INET, gw, &gw_addr);
+	}
+
+	return net_route_ipv4_add(iface, &addr, len, &gw_addr);
+}
+
+static struct net_route_entry_ipv4 *lookup_ipv4_route(struct net_if *iface,
+						      const char *dst)
+{
+	struct in_addr addr;
+
+	net_addr_pton(AF_INET, dst, &addr);
+
+	return net_route_ipv4_lookup(iface, &addr);
+}
+
+static void count_ipv4_route(struct net_route_entry_ipv4 *route,
+			     void *user_data)
+{
+	ARG_UNUSED(route);
+	ARG_UNUSED(user_data);
+}
+
+static void test_route_ipv4(void)
+{
+	struct net_route_entry_ipv4 *r8, *r16, *r24, *def, *found;
+	struct in_addr gw, dst;
+
+	r8 = add_ipv4_route(my_iface, "10.0.0.0", 8, "192.0.2.1");
+	r16 = add_ipv4_route(my_iface, "10.1.0.0", 16, "192.0.2.2");
+	r24 = add_ipv4_route(my_iface, "10.1.2.99", 24, NULL);
+	def = add_ipv4_route(peer_iface, "0.0.0.0", 0, "198.51.100.1");
+
+	zassert_not_null(r8, "Route add failed");
+	zassert_not_null(r16, "Route add failed");
+	zassert_not_null(r24, "Route add failed");
+	zassert_not_null(def, "Route add failed");
+
+	zassert_equal(net_route_ipv4_foreach(count_ipv4_route, NULL), 4,
+		      "Invalid route count");
+
+	zassert_equal_ptr(lookup_ipv4_route(my_iface, "10.1.2.3"), r24,
+			  "/24 route not selected");
+	zassert_equal_ptr(lookup_ipv4_route(my_iface, "10.1.3.3"), r16,
+			  "/16 route not selected");
+	zassert_equal_ptr(lookup_ipv4_route(my_iface, "10.2.0.1"), r8,
+			  "/8 route not selected");
+	zassert_is_null(lookup_ipv4_route(my_iface, "192.168.1.1"),
+			"Route found for wrong interface");
+	zassert_equal_ptr(lookup_ipv4_route(NULL, "192.168.1.1"), def,
+			  "Default route not selected");
+
+	net_addr_pton(AF_INET, "192.168.1.1", &dst);
+	zassert_equal_ptr(net_if_ipv4_select_src_iface(&dst), peer_iface,
+			  "Route interface not selected");
+
+	/* The host bits of the prefix are ignored and the gateway updated */
+	found = add_ipv4_route(my_iface, "10.1.255.255", 16, "192.0.2.3");
+	zassert_equal_ptr(found, r16, "Route not updated");
+	net_addr_pton(AF_INET, "192.0.2.3", &gw);
+	zassert_true(net_ipv4_addr_cmp(&r16->gw, &gw), "Gateway not updated");
+
+	/* Only the route with the exact prefix is found */
+	net_addr_pton(AF_INET, "10.1.2.0", &dst);
+	zassert_equal_ptr(net_route_ipv4_find(my_iface, &dst, 24), r24,
+			  "/24 route not found");
+	zassert_equal_ptr(net_route_ipv4_find(my_iface, &dst, 8), r8,
+			  "/8 route not found");
+	zassert_is_null(net_route_ipv4_find(my_iface, &dst, 12),
+			"Covering route found for a missing prefix");
+	zassert_is_null(net_route_ipv4_find(peer_iface, &dst, 24),
+			"Route found for wrong interface");
+
+	zassert_ok(net_route_ipv4_del(r24), "Route del failed");
+	zassert_equal_ptr(lookup_ipv4_route(my_iface, "10.1.2.3"), r16,
+			  "Stale route returned after delete");
+	zassert_not_ok(net_route_ipv4_del(r24), "Route del again succeeded");
+
+	zassert_ok(net_route_ipv4_del(r16), "Route del failed");
+	zassert_ok(net_route_ipv4_del(r8), "Route del failed");
+	zassert_ok(net_route_ipv4_del(def), "Route del failed");
+
+	zassert_is_null(lookup_ipv4_route(NULL, "10.1.2.3"),
+			"Route found after delete");
+}
+
+static void test_route_ipv4_lookup_cost(void)
+{
+	struct net_route_entry_ipv4 *route;
+	struct in_addr addr, gw = { 0 };
+	uint32_t start, cycles;
+	int i;
+
+	/* Fill the table with /24 routes and one covering /8 route */
+	for (i = 0; i < ARRAY_SIZE(ipv4_routes); i++) {
+		addr.s_addr = htonl(0x0a000000 | ((i + 1) << 8));
+
+		ipv4_routes[i] = net_route_ipv4_add(my_iface, &addr,
+						    i == 0 ? 8 : 24, &gw);
+		zassert_not_null(ipv4_routes[i], "Route add failed");
+	}
+
+	start = k_cycle_get_32();
+
+	for (i = 0; i < IPV4_BENCH_LOOKUPS; i++) {
+		addr.s_addr = htonl(0x0a000001 |
+				    ((i % ARRAY_SIZE(ipv4_routes) + 1) << 8));
+
+		route = net_route_ipv4_lookup(my_iface, &addr);
+		zassert_not_null(route, "Route lookup failed");
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	TC_PRINT("%d routes, %u cycles per lookup\n",
+		 (int)ARRAY_SIZE(ipv4_routes), cycles / IPV4_BENCH_LOOKUPS);
+
+	for (i = 0; i < ARRAY_SIZE(ipv4_routes); i++) {
+		zassert_ok(net_route_ipv4_del(ipv4_routes[i]),
+			   "Route del failed");
+	}
+}
+#endif /* CONFIG_NET_ROUTE_IPV4 */
 
 /*test case main entry*/
 ZTEST(route_test_suite, test_route)
@@ -564,8 +741,14 @@ ZTEST(route_test_suite, test_route)
 	test_populate_nbr_cache();
 	test_route_add_many();
 	test_route_del_many();
+	test_route_longest_prefix();
 	test_route_lifetime();
 	test_route_preference();
+
+#if defined(CONFIG_NET_ROUTE_IPV4)
+	test_route_ipv4();
+	test_route_ipv4_lookup_cost();
+#endif
 }
 
 ZTEST_SUITE(route_test_suite, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,223 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <zephyr/net/socket.h>
+#include <zephyr/net/socket_service.h>
+
+#define EVENT_TIMEOUT K_MSEC(500)
+#define NO_EVENT_TIMEOUT K_MSEC(100)
+
+struct handler_data {
+	struct k_sem sem;
+	k_tid_t thread;
+	void *user_data;
+	short revents;
+	int count;
+};
+
+static struct handler_data sync_data;
+static struct handler_data async_data;
+
+static void handle_event(struct handler_data *data, struct k_work *work)
+{
+	struct net_socket_service_event *pev =
+		CONTAINER_OF(work, struct net_socket_service_event, work);
+	char buf[8];
+
+	/* Consume the data so that the socket is not ready anymore */
+	(void)zsock_recv(pev->event.fd, buf, sizeof(buf), ZSOCK_MSG_DONTWAIT);
+
+	data->thread = k_current_get();
+	data->user_data = pev->user_data;
+	data->revents = pev->event.revents;
+	data->count++;
+
+	k_sem_give(&data->sem);
+}
+
+static void sync_handler(struct k_work *work)
+{
+	handle_event(&sync_data, work);
+}
+
+static void async_handler(struct k_work *work)
+{
+	handle_event(&async_data, work);
+}
+
+NET_SOCKET_SERVICE_SYNC_DEFINE(sync_service, sync_handler, 2);
+NET_SOCKET_SERVICE_ASYNC_DEFINE(async_service, &k_sys_work_q, async_handler, 2);
+
+static void run_service(const struct net_socket_service_desc *service,
+			struct handler_data *data)
+{
+	struct zsock_pollfd fds[1];
+	int user_data;
+	int sv[2];
+	int ret;
+
+	ret = zsock_socketpair(AF_UNIX, SOCK_STREAM, 0, sv);
+	zassert_equal(ret, 0, "socketpair failed (%d)", errno);
+
+	fds[0].fd = sv[1];
+	fds[0].events = ZSOCK_POLLIN;
+
+	ret = net_socket_service_register(service, fds, ARRAY_SIZE(fds), &user_data);
+	zassert_equal(ret, 0, "Cannot register (%d)", ret);
+
+	for (int i = 1; i <= 3; i++) {
+		ret = zsock_send(sv[0], "x", 1, 0);
+		zassert_equal(ret, 1, "send failed (%d)", errno);
+
+		ret = k_sem_take(&data->sem, EVENT_TIMEOUT);
+		zassert_equal(ret, 0, "Handler not called");
+		zassert_equal(data->count, i, "Handler called %d times", data->count);
+		zassert_equal_ptr(data->user_data, &user_data, "Invalid user data");
+		zassert_true(data->revents & ZSOCK_POLLIN, "Invalid events");
+	}
+
+	ret = net_socket_service_unregister(service);
+	zassert_equal(ret, 0, "Cannot unregister (%d)", ret);
+
+	ret = zsock_send(sv[0], "x", 1, 0);
+	zassert_equal(ret, 1, "send failed (%d)", errno);
+
+	ret = k_sem_take(&data->sem, NO_EVENT_TIMEOUT);
+	zassert_equal(ret, -EAGAIN, "Handler called after unregistering");
+
+	zsock_close(sv[0]);
+	zsock_close(sv[1]);
+}
+
+ZTEST(net_socket_service, test_sync_service)
+{
+	run_service(&sync_service, &sync_data);
+
+	zassert_not_equal(sync_data.thread, k_current_get(), "Handler run by the caller");
+	zassert_not_equal(sync_data.thread, &k_sys_work_q.thread,
+			  "Handler run by the work queue");
+}
+
+ZTEST(net_socket_service, test_async_service)
+{
+	run_service(&async_service, &async_data);
+
+	zassert_equal(async_data.thread, &k_sys_work_q.thread,
+		      "Handler not run by the work queue");
+}
+
+ZTEST(net_socket_service, test_register_errors)
+{
+	struct zsock_pollfd fds[3] = {
+		{ .fd = -1 }, { .fd = -1 }, { .fd = -1 },
+	};
+	int ret;
+
+	ret = net_socket_service_register(&sync_service, fds, ARRAY_SIZE(fds), NULL);
+	zassert_equal(ret, -ENOMEM, "Registered more sockets than the service holds");
+
+	ret = net_socket_service_register(&sync_service, NULL, 1, NULL);
+	zassert_equal(ret, -EINVAL, "Registered without sockets");
+}
+
+ZTEST(net_socket_service, test_register_limit)
+{
+	/* One poll entry is used by the service thread */
+	const int max = CONFIG_NET_SOCKETS_POLL_MAX - 1;
+	struct zsock_pollfd fds[2];
+	int sv[2][2];
+	int ret;
+
+	zassert_equal(max, 3, "Test written for 3 sockets");
+
+	for (int i = 0; i < ARRAY_SIZE(sv); i++) {
+		ret = zsock_socketpair(AF_UNIX, SOCK_STREAM, 0, sv[i]);
+		zassert_equal(ret, 0, "socketpair failed (%d)", errno);
+
+		fds[i].fd = sv[i][1];
+		fds[i].events = ZSOCK_POLLIN;
+	}
+
+	ret = net_socket_service_register(&sync_service, fds, 2, NULL);
+	zassert_equal(ret, 0, "Cannot register (%d)", ret);
+
+	/* The services together cannot have more sockets than can be polled */
+	ret = net_socket_service_register(&async_service, fds, 2, NULL);
+	zassert_equal(ret, -ENOMEM, "Registered more sockets than can be polled");
+
+	ret = net_socket_service_register(&async_service, fds, 1, NULL);
+	zassert_equal(ret, 0, "Cannot register (%d)", ret);
+
+	/* Registering again replaces the sockets of the service */
+	ret = net_socket_service_register(&sync_service, fds, 2, NULL);
+	zassert_equal(ret, 0, "Cannot register again (%d)", ret);
+
+	(void)net_socket_service_unregister(&sync_service);
+	(void)net_socket_service_unregister(&async_service);
+
+	for (int i = 0; i < ARRAY_SIZE(sv); i++) {
+		zsock_close(sv[i][0]);
+		zsock_close(sv[i][1]);
+	}
+}
+
+ZTEST(net_socket_service, test_wakeups)
+{
+	struct zsock_pollfd fds[1];
+	uint32_t wakeups;
+	int sv[2];
+	int ret;
+
+	ret = zsock_socketpair(AF_UNIX, SOCK_STREAM, 0, sv);
+	zassert_equal(ret, 0, "socketpair failed (%d)", errno);
+
+	fds[0].fd = sv[1];
+	fds[0].events = ZSOCK_POLLIN;
+
+	ret = net_socket_service_register(&sync_service, fds, ARRAY_SIZE(fds), NULL);
+	zassert_equal(ret, 0, "Cannot register (%d)", ret);
+
+	/* Let the service thread pick up the registration */
+	k_sleep(NO_EVENT_TIMEOUT);
+	wakeups = net_socket_service_wakeups();
+
+	/* An idle socket does not wake up the service thread */
+	k_sleep(NO_EVENT_TIMEOUT);
+	zassert_equal(net_socket_service_wakeups(), wakeups, "Woken up while idle");
+
+	ret = zsock_send(sv[0], "x", 1, 0);
+	zassert_equal(ret, 1, "send failed (%d)", errno);
+
+	ret = k_sem_take(&sync_data.sem, EVENT_TIMEOUT);
+	zassert_equal(ret, 0, "Handler not called");
+	zassert_true(net_socket_service_wakeups() > wakeups, "Wake up not counted");
+
+	(void)net_socket_service_unregister(&sync_service);
+
+	zsock_close(sv[0]);
+	zsock_close(sv[1]);
+}
+
+static void *setup(void)
+{
+	k_sem_init(&sync_data.sem, 0, 1);
+	k_sem_init(&async_data.sem, 0, 1);
+
+	return NULL;
+}
+
+static void before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	k_sem_reset(&sync_data.sem);
+	k_sem_reset(&async_data.sem);
+	sync_data.count = 0;
+	async_data.count = 0;
+}
+
+ZTEST_SUITE(net_socket_service, NULL, setup, before, NULL, NULL);
@@ -1725,6 +1725,66 @@ ZTEST(net_socket_tcp, test_socket_permission)
 #endif /* CONFIG_USERSPACE */
 }
 
+#define TEST_GRO_SEGMENTS 8
+
+ZTEST(net_socket_tcp, test_v4_gro)
+{
+	/* Test that in-order segments queued for the application are
+	 * returned by a single recv() call when coalescing is enabled.
+	 */
+	int c_sock;
+	int s_sock;
+	int new_sock;
+	int optval = 1;
+	struct sockaddr_in c_saddr;
+	struct sockaddr_in s_saddr;
+	struct sockaddr addr;
+	socklen_t addrlen = sizeof(addr);
+	char rx_buf[TEST_GRO_SEGMENTS * sizeof(TEST_STR_SMALL)];
+	ssize_t recved;
+	int i;
+
+	if (!IS_ENABLED(CONFIG_NET_TCP_GRO)) {
+		ztest_test_skip();
+	}
+
+	prepare_sock_tcp_v4(MY_IPV4_ADDR, ANY_PORT, &c_sock, &c_saddr);
+	prepare_sock_tcp_v4(MY_IPV4_ADDR, SERVER_PORT, &s_sock, &s_saddr);
+
+	test_bind(s_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+	test_listen(s_sock);
+
+	test_connect(c_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+	test_accept(s_sock, &new_sock, &addr, &addrlen);
+
+	zassert_equal(setsockopt(c_sock, IPPROTO_TCP, TCP_NODELAY, &optval,
+				 sizeof(optval)), 0, "setsockopt failed");
+
+	/* Send each string as a separate segment */
+	for (i = 0; i < TEST_GRO_SEGMENTS; i++) {
+		test_send(c_sock, TEST_STR_SMALL, strlen(TEST_STR_SMALL), 0);
+		k_msleep(THREAD_SLEEP);
+	}
+
+	recved = recv(new_sock, rx_buf, sizeof(rx_buf), 0);
+	zassert_equal(recved, TEST_GRO_SEGMENTS * strlen(TEST_STR_SMALL),
+		      "segments were not coalesced (%zd)", recved);
+
+	for (i = 0; i < TEST_GRO_SEGMENTS; i++) {
+		zassert_mem_equal(&rx_buf[i * strlen(TEST_STR_SMALL)],
+				  TEST_STR_SMALL, strlen(TEST_STR_SMALL),
+				  "unexpected data");
+	}
+
+	test_close(c_sock);
+	test_eof(new_sock);
+
+	test_close(new_sock);
+	test_close(s_sock);
+
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+
 static void *setup(void)
 {
 #ifdef CONFIG_USERSPACE
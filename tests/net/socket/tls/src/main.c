@@ -598,4 +598,339 @@ ZTEST(net_socket_tls, test_v6_dtls_sendmsg)
 			  (struct sockaddr *)&server_addr, sizeof(server_addr));
 }
 
+#define RECONNECT_COUNT 4
+
+static void test_session_cache_enable(int sock)
+{
+	int cache = TLS_SESSION_CACHE_ENABLED;
+
+	zassert_equal(setsockopt(sock, SOL_TLS, TLS_SESSION_CACHE,
+				 &cache, sizeof(cache)),
+		      0, "Failed to enable session cache");
+}
+
+static void test_session_cache_purge(int sock)
+{
+	int purge = 0;
+
+	zassert_equal(setsockopt(sock, SOL_TLS, TLS_SESSION_CACHE_PURGE,
+				 &purge, sizeof(purge)),
+		      0, "Failed to purge session cache");
+}
+
+static bool test_session_resumed(int sock)
+{
+	int resumed = -1;
+	socklen_t optlen = sizeof(resumed);
+
+	zassert_equal(getsockopt(sock, SOL_TLS, TLS_SESSION_RESUMED,
+				 &resumed, &optlen),
+		      0, "getsockopt failed (%d)", errno);
+	zassert_true(resumed == 0 || resumed == 1, "Invalid value %d", resumed);
+
+	return resumed == 1;
+}
+
+ZTEST(net_socket_tls, test_v4_session_resumption)
+{
+	int c_sock;
+	int s_sock;
+	int new_sock;
+	struct sockaddr_in c_saddr;
+	struct sockaddr_in s_saddr;
+	struct sockaddr addr;
+	socklen_t addrlen;
+	uint8_t rx_buf[sizeof(TEST_STR_SMALL) - 1];
+	uint32_t start, cycles;
+	uint32_t full_us = 0, resumed_us = 0;
+	int ret;
+
+	prepare_sock_tls_v4(MY_IPV4_ADDR, ANY_PORT, &s_sock, &s_saddr, IPPROTO_TLS_1_2);
+	test_session_cache_enable(s_sock);
+	test_session_cache_purge(s_sock);
+
+	test_bind(s_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+	test_listen(s_sock);
+
+	for (int i = 0; i < RECONNECT_COUNT; i++) {
+		prepare_sock_tls_v4(MY_IPV4_ADDR, ANY_PORT, &c_sock, &c_saddr,
+				    IPPROTO_TLS_1_2);
+		test_config_psk(s_sock, c_sock);
+		test_session_cache_enable(c_sock);
+
+		start = k_cycle_get_32();
+
+		spawn_client_connect_thread(c_sock, (struct sockaddr *)&s_saddr);
+
+		addrlen = sizeof(addr);
+		test_accept(s_sock, &new_sock, &addr, &addrlen);
+
+		k_thread_join(&client_connect_thread, K_FOREVER);
+
+		cycles = k_cycle_get_32() - start;
+
+		/* Only the first connection needs a full handshake. */
+		zassert_equal(test_session_resumed(new_sock), i > 0,
+			      "Connection %d: session %sresumed", i,
+			      i > 0 ? "not " : "");
+
+		if (i == 0) {
+			full_us = k_cyc_to_us_floor32(cycles);
+		} else {
+			resumed_us += k_cyc_to_us_floor32(cycles);
+		}
+
+		/* The connection is usable, whether resumed or not. */
+		test_send(c_sock, TEST_STR_SMALL, sizeof(rx_buf), 0);
+
+		ret = recv(new_sock, rx_buf, sizeof(rx_buf), MSG_WAITALL);
+		zassert_equal(ret, sizeof(rx_buf), "Invalid length received");
+		zassert_mem_equal(rx_buf, TEST_STR_SMALL, sizeof(rx_buf),
+				  "Invalid data received");
+
+		test_close(new_sock);
+		test_close(c_sock);
+	}
+
+	TC_PRINT("Connect: %u us with a full handshake, %u us resumed\n",
+		 full_us, resumed_us / (RECONNECT_COUNT - 1));
+
+	test_session_cache_purge(s_sock);
+
+	test_close(s_sock);
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+
+#define LRU_SERVER_COUNT (CONFIG_NET_SOCKETS_TLS_MAX_CLIENT_SESSION_COUNT + 1)
+
+/* Connect to a server and return whether it resumed the session. */
+static bool test_session_connect(int s_sock, struct sockaddr_in *s_saddr)
+{
+	int c_sock;
+	int new_sock;
+	struct sockaddr_in c_saddr;
+	struct sockaddr addr;
+	socklen_t addrlen = sizeof(addr);
+	bool resumed;
+
+	prepare_sock_tls_v4(MY_IPV4_ADDR, ANY_PORT, &c_sock, &c_saddr,
+			    IPPROTO_TLS_1_2);
+	test_config_psk(s_sock, c_sock);
+	test_session_cache_enable(c_sock);
+
+	spawn_client_connect_thread(c_sock, (struct sockaddr *)s_saddr);
+
+	test_accept(s_sock, &new_sock, &addr, &addrlen);
+
+	k_thread_join(&client_connect_thread, K_FOREVER);
+
+	resumed = test_session_resumed(new_sock);
+
+	test_close(new_sock);
+	test_close(c_sock);
+
+	return resumed;
+}
+
+ZTEST(net_socket_tls, test_v4_session_cache_lru)
+{
+	int s_sock[LRU_SERVER_COUNT];
+	struct sockaddr_in s_saddr[LRU_SERVER_COUNT];
+	int last = LRU_SERVER_COUNT - 1;
+
+	/* The client cache is indexed by the server address, so each server
+	 * listens on its own port.
+	 */
+	for (int i = 0; i < LRU_SERVER_COUNT; i++) {
+		prepare_sock_tls_v4(MY_IPV4_ADDR, SERVER_PORT + i, &s_sock[i],
+				    &s_saddr[i], IPPROTO_TLS_1_2);
+		test_session_cache_enable(s_sock[i]);
+
+		test_bind(s_sock[i], (struct sockaddr *)&s_saddr[i],
+			  sizeof(s_saddr[i]));
+		test_listen(s_sock[i]);
+	}
+
+	test_session_cache_purge(s_sock[0]);
+
+	/* Fill the client cache, all but the last server. */
+	for (int i = 0; i < last; i++) {
+		zassert_false(test_session_connect(s_sock[i], &s_saddr[i]),
+			      "Server %d resumed an unknown session", i);
+	}
+
+	/* Use the oldest session again, the second one is now the least
+	 * recently used.
+	 */
+	zassert_true(test_session_connect(s_sock[0], &s_saddr[0]),
+		     "Session not resumed");
+
+	/* A session with the last server does not fit and replaces it. */
+	zassert_false(test_session_connect(s_sock[last], &s_saddr[last]),
+		      "Server %d resumed an unknown session", last);
+
+	zassert_true(test_session_connect(s_sock[last], &s_saddr[last]),
+		     "Newest session not cached");
+	zassert_true(test_session_connect(s_sock[0], &s_saddr[0]),
+		     "Recently used session evicted");
+
+	for (int i = 2; i < last; i++) {
+		zassert_true(test_session_connect(s_sock[i], &s_saddr[i]),
+			     "Session with server %d evicted", i);
+	}
+
+	zassert_false(test_session_connect(s_sock[1], &s_saddr[1]),
+		      "Least recently used session not evicted");
+
+	test_session_cache_purge(s_sock[0]);
+
+	for (int i = 0; i < LRU_SERVER_COUNT; i++) {
+		test_close(s_sock[i]);
+	}
+
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+
+#define SMALL_WRITE_SIZE 64
+#define SMALL_WRITE_COUNT 16
+#define SMALL_WRITE_ROUNDS 16
+
+static uint8_t small_write_data[SMALL_WRITE_SIZE * SMALL_WRITE_COUNT];
+
+static void test_recv_small_writes(int sock, size_t len)
+{
+	static uint8_t rx_buf[sizeof(small_write_data)];
+	int ret;
+
+	ret = recv(sock, rx_buf, len, MSG_WAITALL);
+	zassert_equal(ret, len, "Invalid length received");
+	zassert_mem_equal(rx_buf, small_write_data, len,
+			  "Invalid data received");
+}
+
+static void test_tx_flush(int sock)
+{
+	int flush = 0;
+
+	zassert_equal(setsockopt(sock, SOL_TLS, TLS_TX_FLUSH,
+				 &flush, sizeof(flush)),
+		      0, "Failed to flush (%d)", errno);
+}
+
+static uint32_t test_small_writes(int c_sock, int s_sock)
+{
+	uint32_t start = k_cycle_get_32();
+
+	for (int round = 0; round < SMALL_WRITE_ROUNDS; round++) {
+		for (int i = 0; i < SMALL_WRITE_COUNT; i++) {
+			test_send(c_sock, small_write_data + i * SMALL_WRITE_SIZE,
+				  SMALL_WRITE_SIZE, 0);
+		}
+
+		test_tx_flush(c_sock);
+		test_recv_small_writes(s_sock, sizeof(small_write_data));
+	}
+
+	return k_cyc_to_us_floor32(k_cycle_get_32() - start);
+}
+
+ZTEST(net_socket_tls, test_v4_tx_coalesce)
+{
+	int c_sock;
+	int s_sock;
+	int new_sock;
+	struct sockaddr_in c_saddr;
+	struct sockaddr_in s_saddr;
+	struct sockaddr addr;
+	socklen_t addrlen = sizeof(addr);
+	int coalesce = TLS_TX_COALESCE_ENABLED;
+	socklen_t optlen = sizeof(coalesce);
+	int nodelay = 1;
+	uint32_t plain_us, coalesced_us;
+	struct pollfd pfd;
+	uint8_t byte;
+	int ret;
+
+	for (int i = 0; i < sizeof(small_write_data); i++) {
+		small_write_data[i] = i;
+	}
+
+	prepare_sock_tls_v4(MY_IPV4_ADDR, ANY_PORT, &c_sock, &c_saddr, IPPROTO_TLS_1_2);
+	prepare_sock_tls_v4(MY_IPV4_ADDR, ANY_PORT, &s_sock, &s_saddr, IPPROTO_TLS_1_2);
+
+	test_config_psk(s_sock, c_sock);
+
+	test_bind(s_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+	test_listen(s_sock);
+
+	spawn_client_connect_thread(c_sock, (struct sockaddr *)&s_saddr);
+
+	test_accept(s_sock, &new_sock, &addr, &addrlen);
+
+	k_thread_join(&client_connect_thread, K_FOREVER);
+
+	plain_us = test_small_writes(c_sock, new_sock);
+
+	ret = setsockopt(c_sock, SOL_TLS, TLS_TX_COALESCE, &coalesce,
+			 sizeof(coalesce));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	coalesce = TLS_TX_COALESCE_DISABLED;
+	ret = getsockopt(c_sock, SOL_TLS, TLS_TX_COALESCE, &coalesce, &optlen);
+	zassert_equal(ret, 0, "getsockopt failed (%d)", errno);
+	zassert_equal(coalesce, TLS_TX_COALESCE_ENABLED, "Coalescing not enabled");
+
+	coalesced_us = test_small_writes(c_sock, new_sock);
+
+	TC_PRINT("%u bytes in %u byte writes: %u us, %u us coalesced\n",
+		 (unsigned int)(sizeof(small_write_data) * SMALL_WRITE_ROUNDS),
+		 SMALL_WRITE_SIZE, plain_us, coalesced_us);
+
+	/* Writes are held until flushed */
+	for (int i = 0; i < 4; i++) {
+		test_send(c_sock, small_write_data + i * SMALL_WRITE_SIZE,
+			  SMALL_WRITE_SIZE, 0);
+	}
+
+	ret = recv(new_sock, &byte, sizeof(byte), MSG_DONTWAIT);
+	zassert_equal(ret, -1, "Coalesced data received before flush");
+	zassert_equal(errno, EAGAIN, "Unexpected errno value %d", errno);
+
+	test_tx_flush(c_sock);
+	test_recv_small_writes(new_sock, 4 * SMALL_WRITE_SIZE);
+
+	/* Receiving on the socket sends them too, the peer may wait for them */
+	test_send(c_sock, small_write_data, SMALL_WRITE_SIZE, 0);
+
+	ret = recv(c_sock, &byte, sizeof(byte), MSG_DONTWAIT);
+	zassert_equal(ret, -1, "Unexpected data received");
+	zassert_equal(errno, EAGAIN, "Unexpected errno value %d", errno);
+
+	test_recv_small_writes(new_sock, SMALL_WRITE_SIZE);
+
+	/* So does polling for data, as done before a receive */
+	test_send(c_sock, small_write_data, SMALL_WRITE_SIZE, 0);
+
+	pfd.fd = c_sock;
+	pfd.events = POLLIN;
+	ret = poll(&pfd, 1, 0);
+	zassert_equal(ret, 0, "Unexpected poll event");
+
+	test_recv_small_writes(new_sock, SMALL_WRITE_SIZE);
+
+	/* And so does disabling the delay of the underlying socket */
+	test_send(c_sock, small_write_data, SMALL_WRITE_SIZE, 0);
+
+	ret = setsockopt(c_sock, IPPROTO_TCP, TCP_NODELAY, &nodelay,
+			 sizeof(nodelay));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	test_recv_small_writes(new_sock, SMALL_WRITE_SIZE);
+
+	test_close(new_sock);
+	test_close(s_sock);
+	test_close(c_sock);
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+
 ZTEST_SUITE(net_socket_tls, NULL, NULL, NULL, NULL, NULL);
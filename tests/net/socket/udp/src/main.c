@@ -14,6 +14,7 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
 
 #include <zephyr/net/socket.h>
 #include <zephyr/net/ethernet.h>
+#include <zephyr/net/net_pkt.h>
 
 #include "ipv6.h"
 #include "../../socket_helpers.h"
@@ -956,6 +957,12 @@ static void eth_fake_iface_init(struct net_if *iface)
 	ethernet_init(iface);
 }
 
+/* Frame captured by the fake driver for the checksum test */
+static uint8_t tx_frame[NET_ETH_MTU + sizeof(struct net_eth_hdr)];
+static size_t tx_frame_len;
+static bool tx_frame_capture;
+static K_SEM_DEFINE(tx_frame_sem, 0, 1);
+
 static int eth_fake_send(const struct device *dev, struct net_pkt *pkt)
 {
 	uint64_t txtime;
@@ -963,6 +970,22 @@ static int eth_fake_send(const struct device *dev, struct net_pkt *pkt)
 	ARG_UNUSED(dev);
 	ARG_UNUSED(pkt);
 
+	if (tx_frame_capture) {
+		tx_frame_len = MIN(net_pkt_get_len(pkt), sizeof(tx_frame));
+
+		net_pkt_cursor_init(pkt);
+		(void)net_pkt_read(pkt, tx_frame, tx_frame_len);
+
+		/* Skip anything else than the UDP datagram, such as ND */
+		if (tx_frame_len > sizeof(struct net_eth_hdr) + NET_IPV6H_LEN &&
+		    tx_frame[sizeof(struct net_eth_hdr) + 6] == IPPROTO_UDP) {
+			tx_frame_capture = false;
+			k_sem_give(&tx_frame_sem);
+		}
+
+		return 0;
+	}
+
 	if (!test_started) {
 		return 0;
 	}
@@ -1099,6 +1122,111 @@ ZTEST_USER(net_socket_udp, test_18_v6_sendmsg_with_txtime)
 	test_started = false;
 }
 
+/* Sum the IPv6 pseudo header and the UDP datagram of a captured frame
+ * byte by byte, independently of the stack checksum routines.
+ */
+static uint16_t frame_udp_v6_sum(const uint8_t *ip, size_t udp_len)
+{
+	const uint8_t *udp = ip + NET_IPV6H_LEN;
+	uint32_t sum = 0U;
+	size_t i;
+
+	/* Source and destination addresses */
+	for (i = 8; i < NET_IPV6H_LEN; i += 2) {
+		sum += (ip[i] << 8) | ip[i + 1];
+	}
+
+	sum += udp_len + IPPROTO_UDP;
+
+	for (i = 0; i + 1 < udp_len; i += 2) {
+		sum += (udp[i] << 8) | udp[i + 1];
+	}
+
+	if (udp_len & 1) {
+		sum += udp[udp_len - 1] << 8;
+	}
+
+	while (sum >> 16) {
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+
+	return sum;
+}
+
+ZTEST(net_socket_udp, test_28_v6_udp_checksum)
+{
+	/* Odd and even parts, so that the iovecs start at both offsets */
+	static const char part1[] = "Zephyr";
+	static const char part2[] = "UDP";
+	struct sockaddr_in6 client_addr;
+	struct iovec io_vector[3];
+	struct msghdr msg = { 0 };
+	const uint8_t *ip;
+	size_t udp_len;
+	int client_sock;
+	ssize_t sent;
+	int rv;
+
+	prepare_sock_udp_v6(MY_IPV6_ADDR_ETH, ANY_PORT, &client_sock, &client_addr);
+
+	rv = bind(client_sock, (struct sockaddr *)&client_addr,
+		  sizeof(client_addr));
+	zassert_equal(rv, 0, "client bind failed");
+
+	io_vector[0].iov_base = (void *)part1;
+	io_vector[0].iov_len = STRLEN(part1);
+	io_vector[1].iov_base = (void *)part2;
+	io_vector[1].iov_len = STRLEN(part2);
+	io_vector[2].iov_base = TEST_STR2;
+	io_vector[2].iov_len = STRLEN(TEST_STR2);
+
+	msg.msg_iov = io_vector;
+	msg.msg_iovlen = ARRAY_SIZE(io_vector);
+	msg.msg_name = &server_addr;
+	msg.msg_namelen = sizeof(server_addr);
+
+	for (int i = 1; i <= ARRAY_SIZE(io_vector); i++) {
+		size_t len = 0;
+
+		/* A single buffer is written with send(), several with
+		 * sendmsg().
+		 */
+		k_sem_reset(&tx_frame_sem);
+		tx_frame_capture = true;
+
+		if (i == 1) {
+			sent = sendto(client_sock, part1, STRLEN(part1), 0,
+				      (struct sockaddr *)&server_addr,
+				      sizeof(server_addr));
+			len = STRLEN(part1);
+		} else {
+			msg.msg_iovlen = i;
+			sent = sendmsg(client_sock, &msg, 0);
+
+			for (int j = 0; j < i; j++) {
+				len += io_vector[j].iov_len;
+			}
+		}
+
+		zassert_equal(sent, len, "send failed (%d)", errno);
+		zassert_equal(k_sem_take(&tx_frame_sem, WAIT_TIME), 0,
+			      "Datagram not sent");
+
+		ip = tx_frame + sizeof(struct net_eth_hdr);
+		udp_len = sizeof(struct net_udp_hdr) + len;
+
+		zassert_equal(tx_frame_len, sizeof(struct net_eth_hdr) +
+			      NET_IPV6H_LEN + udp_len, "Invalid frame length");
+		zassert_equal(ip[6], IPPROTO_UDP, "Not a UDP datagram");
+		zassert_equal(frame_udp_v6_sum(ip, udp_len), 0xffff,
+			      "Invalid UDP checksum %02x%02x with %d part(s)",
+			      ip[NET_IPV6H_LEN + 6], ip[NET_IPV6H_LEN + 7], i);
+	}
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
 void test_msg_trunc(int sock_c, int sock_s, struct sockaddr *addr_c,
 		    socklen_t addrlen_c, struct sockaddr *addr_s,
 		    socklen_t addrlen_s)
@@ -1294,4 +1422,244 @@ ZTEST(net_socket_udp, test_23_v6_dgram_overflow)
 			    BUF_AND_SIZE(test_str_all_tx_bufs));
 }
 
+static K_SEM_DEFINE(zerocopy_done, 0, 1);
+
+static void zerocopy_cb(const void *buf, size_t len, void *user_data)
+{
+	zassert_equal_ptr(user_data, &zerocopy_done, "wrong user data");
+	zassert_not_null(buf, "no buffer");
+	zassert_true(len > 0, "wrong length");
+
+	k_sem_give(&zerocopy_done);
+}
+
+static void comm_sendto_recv_zerocopy(int client_sock,
+				      socklen_t client_addrlen,
+				      int server_sock,
+				      struct sockaddr *server_addr,
+				      socklen_t server_addrlen)
+{
+	struct sockaddr_storage addr;
+	socklen_t addrlen = sizeof(addr);
+	struct net_pkt *pkt;
+	ssize_t len;
+
+	len = zsock_sendto_zerocopy(client_sock, BUF_AND_SIZE(TEST_STR_SMALL),
+				    0, server_addr, server_addrlen,
+				    zerocopy_cb, &zerocopy_done);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "sendto failed (%d)",
+		      errno);
+
+	/* The buffer is released once the packet has been sent */
+	zassert_equal(k_sem_take(&zerocopy_done, K_MSEC(100)), 0,
+		      "completion not called");
+
+	len = zsock_recv_zerocopy(server_sock, &pkt, 0,
+				  (struct sockaddr *)&addr, &addrlen);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "recv failed (%d)", errno);
+	zassert_equal(addrlen, client_addrlen, "unexpected addrlen");
+
+	clear_buf(rx_buf);
+	zassert_equal(net_pkt_read(pkt, rx_buf, len), 0, "read failed");
+	zassert_mem_equal(rx_buf, BUF_AND_SIZE(TEST_STR_SMALL), "wrong data");
+	net_pkt_unref(pkt);
+
+	len = zsock_recv_zerocopy(server_sock, &pkt, ZSOCK_MSG_DONTWAIT,
+				  NULL, NULL);
+	zassert_equal(len, -1, "recv should fail");
+	zassert_equal(errno, EAGAIN, "unexpected errno (%d)", errno);
+}
+
+ZTEST(net_socket_udp, test_24_v4_zerocopy)
+{
+	int rv;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+
+	prepare_sock_udp_v4(MY_IPV4_ADDR, ANY_PORT, &client_sock, &client_addr);
+	prepare_sock_udp_v4(MY_IPV4_ADDR, SERVER_PORT, &server_sock, &server_addr);
+
+	rv = bind(server_sock,
+		  (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	comm_sendto_recv_zerocopy(client_sock, sizeof(client_addr),
+				  server_sock,
+				  (struct sockaddr *)&server_addr,
+				  sizeof(server_addr));
+
+	/* Datagrams that do not fit are rejected, but the buffer is still
+	 * given back.
+	 */
+	rv = zsock_sendto_zerocopy(client_sock, test_str_all_tx_bufs,
+				   NET_ETH_MTU + 1, 0,
+				   (struct sockaddr *)&server_addr,
+				   sizeof(server_addr),
+				   zerocopy_cb, &zerocopy_done);
+	zassert_equal(rv, -1, "sendto should fail");
+	zassert_equal(errno, ENOMEM, "unexpected errno (%d)", errno);
+	zassert_equal(k_sem_take(&zerocopy_done, K_NO_WAIT), 0,
+		      "completion not called");
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
+ZTEST(net_socket_udp, test_25_v6_zerocopy)
+{
+	int rv;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in6 client_addr;
+	struct sockaddr_in6 server_addr;
+
+	prepare_sock_udp_v6(MY_IPV6_ADDR, ANY_PORT, &client_sock, &client_addr);
+	prepare_sock_udp_v6(MY_IPV6_ADDR, SERVER_PORT, &server_sock, &server_addr);
+
+	rv = bind(server_sock,
+		  (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	comm_sendto_recv_zerocopy(client_sock, sizeof(client_addr),
+				  server_sock,
+				  (struct sockaddr *)&server_addr,
+				  sizeof(server_addr));
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
+#define MMSG_COUNT 3
+#define MMSG_LEN (STRLEN(TEST_STR_SMALL) + 1)
+
+static ZTEST_BMEM char mmsg_bufs[MMSG_COUNT + 1][MMSG_LEN + 1];
+
+static void comm_sendmmsg_recvmmsg(int client_sock,
+				   socklen_t client_addrlen,
+				   int server_sock,
+				   struct sockaddr *server_addr,
+				   socklen_t server_addrlen)
+{
+	static const char ids[] = "012";
+	struct mmsghdr tx_msgs[MMSG_COUNT];
+	struct mmsghdr rx_msgs[MMSG_COUNT + 1];
+	struct iovec tx_iov[MMSG_COUNT][2];
+	struct iovec rx_iov[MMSG_COUNT + 1];
+	struct sockaddr_storage addrs[MMSG_COUNT + 1];
+	int rv;
+	int i;
+
+	memset(tx_msgs, 0, sizeof(tx_msgs));
+	memset(rx_msgs, 0, sizeof(rx_msgs));
+
+	for (i = 0; i < MMSG_COUNT; i++) {
+		tx_iov[i][0].iov_base = TEST_STR_SMALL;
+		tx_iov[i][0].iov_len = STRLEN(TEST_STR_SMALL);
+		tx_iov[i][1].iov_base = (void *)&ids[i];
+		tx_iov[i][1].iov_len = 1;
+
+		tx_msgs[i].msg_hdr.msg_name = server_addr;
+		tx_msgs[i].msg_hdr.msg_namelen = server_addrlen;
+		tx_msgs[i].msg_hdr.msg_iov = tx_iov[i];
+		tx_msgs[i].msg_hdr.msg_iovlen = 2;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(rx_msgs); i++) {
+		clear_buf(mmsg_bufs[i]);
+		rx_iov[i].iov_base = mmsg_bufs[i];
+		rx_iov[i].iov_len = sizeof(mmsg_bufs[i]);
+
+		rx_msgs[i].msg_hdr.msg_name = &addrs[i];
+		rx_msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+		rx_msgs[i].msg_hdr.msg_iov = &rx_iov[i];
+		rx_msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	rv = sendmmsg(client_sock, tx_msgs, MMSG_COUNT, 0);
+	zassert_equal(rv, MMSG_COUNT, "sendmmsg failed (%d)", errno);
+
+	for (i = 0; i < MMSG_COUNT; i++) {
+		zassert_equal(tx_msgs[i].msg_len, MMSG_LEN, "wrong msg_len");
+	}
+
+	/* Let all the datagrams arrive before receiving them in one go */
+	k_msleep(100);
+
+	rv = recvmmsg(server_sock, rx_msgs, ARRAY_SIZE(rx_msgs),
+		      MSG_WAITFORONE);
+	zassert_equal(rv, MMSG_COUNT, "recvmmsg failed (%d)", errno);
+
+	for (i = 0; i < MMSG_COUNT; i++) {
+		zassert_equal(rx_msgs[i].msg_len, MMSG_LEN, "wrong msg_len");
+		zassert_equal(rx_msgs[i].msg_hdr.msg_namelen, client_addrlen,
+			      "wrong msg_namelen");
+		zassert_mem_equal(mmsg_bufs[i], BUF_AND_SIZE(TEST_STR_SMALL),
+				  "wrong data");
+		zassert_equal(mmsg_bufs[i][STRLEN(TEST_STR_SMALL)], ids[i],
+			      "wrong order");
+	}
+
+	rv = recvmmsg(server_sock, rx_msgs, ARRAY_SIZE(rx_msgs), MSG_DONTWAIT);
+	zassert_equal(rv, -1, "recvmmsg should fail");
+	zassert_equal(errno, EAGAIN, "unexpected errno (%d)", errno);
+}
+
+ZTEST_USER(net_socket_udp, test_26_v4_sendmmsg_recvmmsg)
+{
+	int rv;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+
+	prepare_sock_udp_v4(MY_IPV4_ADDR, ANY_PORT, &client_sock, &client_addr);
+	prepare_sock_udp_v4(MY_IPV4_ADDR, SERVER_PORT, &server_sock, &server_addr);
+
+	rv = bind(server_sock,
+		  (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	comm_sendmmsg_recvmmsg(client_sock, sizeof(client_addr),
+			       server_sock,
+			       (struct sockaddr *)&server_addr,
+			       sizeof(server_addr));
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
+ZTEST_USER(net_socket_udp, test_27_v6_sendmmsg_recvmmsg)
+{
+	int rv;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in6 client_addr;
+	struct sockaddr_in6 server_addr;
+
+	prepare_sock_udp_v6(MY_IPV6_ADDR, ANY_PORT, &client_sock, &client_addr);
+	prepare_sock_udp_v6(MY_IPV6_ADDR, SERVER_PORT, &server_sock, &server_addr);
+
+	rv = bind(server_sock,
+		  (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	comm_sendmmsg_recvmmsg(client_sock, sizeof(client_addr),
+			       server_sock,
+			       (struct sockaddr *)&server_addr,
+			       sizeof(server_addr));
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
 ZTEST_SUITE(net_socket_udp, NULL, NULL, NULL, NULL, NULL);
@@ -12,6 +12,7 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_WEBSOCKET_LOG_LEVEL);
 #include <zephyr/net/net_ip.h>
 #include <zephyr/net/socket.h>
 #include <zephyr/net/websocket.h>
+#include <zephyr/sys/byteorder.h>
 #include <zephyr/sys/fdtable.h>
 
 #include "websocket_internal.h"
@@ -480,6 +481,64 @@ ZTEST(net_websocket, test_recv_in_small_buffer)
 			  "Invalid message, should be '%s' was '%s'", frame1_msg, recv_buf);
 }
 
+ZTEST(net_websocket, test_send_frame_lorem_ipsum)
+{
+	static struct websocket_context ctx;
+	static uint8_t payload[sizeof(lorem_ipsum) - 1];
+	struct iovec iov;
+	int fd, ret;
+
+	memset(&ctx, 0, sizeof(ctx));
+
+	ctx.recv_buf.buf = temp_recv_buf;
+	ctx.recv_buf.size = sizeof(temp_recv_buf);
+
+	test_msg_len = sizeof(payload);
+	memcpy(payload, lorem_ipsum, sizeof(payload));
+
+	iov.iov_base = payload;
+	iov.iov_len = sizeof(payload);
+
+	fd = test_fd_alloc(&ctx);
+	ret = websocket_send_frame(fd, &iov, 1, WEBSOCKET_OPCODE_DATA_TEXT,
+				   true, true, SYS_FOREVER_MS);
+	zassert_equal(ret, test_msg_len,
+		      "Should have sent %zd bytes but sent %d instead",
+		      test_msg_len, ret);
+	zassert_mem_equal(payload, lorem_ipsum, sizeof(payload),
+			  "Payload not restored after sending");
+
+	z_free_fd(fd);
+}
+
+ZTEST(net_websocket, test_mask_payload)
+{
+	static const uint32_t masking_value = 0xe17e8eb9;
+	static uint8_t data[64 + sizeof(uint64_t)];
+	uint8_t mask[sizeof(uint32_t)];
+
+	sys_put_be32(masking_value, mask);
+
+	/* Every start alignment, length and offset within the frame */
+	for (size_t start = 0; start < sizeof(uint64_t); start++) {
+		for (size_t len = 0; len <= 64; len += 7) {
+			for (uint64_t offset = 0; offset < 4; offset++) {
+				memcpy(&data[start], lorem_ipsum, len);
+
+				websocket_mask_payload(&data[start], len,
+						       masking_value, offset);
+
+				for (size_t i = 0; i < len; i++) {
+					zassert_equal(data[start + i],
+						      lorem_ipsum[i] ^ mask[(offset + i) % 4],
+						      "Invalid mask at %zd (start %zd len %zd "
+						      "offset %d)", i, start, len, (int)offset);
+				}
+			}
+		}
+	}
+}
+
 static void *setup(void)
 {
 	k_thread_system_pool_assign(k_current_get());
@@ -0,0 +1,354 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_WEBSOCKET_LOG_LEVEL);
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <zephyr/net/socket.h>
+#include <zephyr/net/websocket.h>
+#include <zephyr/sys/base64.h>
+#include <zephyr/sys/byteorder.h>
+
+#include <mbedtls/sha1.h>
+
+#define SERVER_ADDR "127.0.0.1"
+#define SERVER_PORT 8080
+
+#define WS_MAGIC "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+#define WS_KEY_FIELD "Sec-WebSocket-Key: "
+
+#define MSG_SIZE 1024
+#define MSG_ROUNDS 64
+#define TIMEOUT_MS 5000
+
+#define SERVER_STACK_SIZE 2048
+#define SERVER_HEADER_MAX_LEN 14
+
+static K_THREAD_STACK_DEFINE(server_stack, SERVER_STACK_SIZE);
+static struct k_thread server_thread;
+static int listen_sock = -1;
+
+static uint8_t server_buf[SERVER_HEADER_MAX_LEN + MSG_SIZE];
+static uint8_t tmp_buf[256];
+static uint8_t send_buf[MSG_SIZE];
+static uint8_t recv_buf[MSG_SIZE];
+
+static int recv_all(int sock, uint8_t *buf, size_t len)
+{
+	size_t received = 0;
+	ssize_t ret;
+
+	while (received < len) {
+		ret = recv(sock, buf + received, len - received, 0);
+		if (ret <= 0) {
+			return -1;
+		}
+
+		received += ret;
+	}
+
+	return 0;
+}
+
+static int send_all(int sock, const uint8_t *buf, size_t len)
+{
+	ssize_t ret;
+
+	while (len > 0) {
+		ret = send(sock, buf, len, 0);
+		if (ret < 0) {
+			return -1;
+		}
+
+		buf += ret;
+		len -= ret;
+	}
+
+	return 0;
+}
+
+static int server_handshake(int sock)
+{
+	char *req = (char *)server_buf;
+	uint8_t digest[20];
+	char accept[32];
+	char key[64];
+	size_t len = 0;
+	size_t olen;
+	char *start, *end;
+	ssize_t ret;
+
+	/* Read the HTTP upgrade request */
+	do {
+		ret = recv(sock, &req[len], sizeof(server_buf) - 1 - len, 0);
+		if (ret <= 0) {
+			return -1;
+		}
+
+		len += ret;
+		req[len] = '\0';
+	} while (strstr(req, "\r\n\r\n") == NULL);
+
+	start = strstr(req, WS_KEY_FIELD);
+	if (start == NULL) {
+		return -1;
+	}
+
+	start += sizeof(WS_KEY_FIELD) - 1;
+	end = strstr(start, "\r\n");
+	if (end == NULL || (end - start) + sizeof(WS_MAGIC) > sizeof(key)) {
+		return -1;
+	}
+
+	memcpy(key, start, end - start);
+	memcpy(&key[end - start], WS_MAGIC, sizeof(WS_MAGIC));
+
+	mbedtls_sha1((const unsigned char *)key, strlen(key), digest);
+
+	if (base64_encode((uint8_t *)accept, sizeof(accept), &olen, digest,
+			  sizeof(digest)) < 0) {
+		return -1;
+	}
+
+	len = snprintk(req, sizeof(server_buf),
+		       "HTTP/1.1 101 Switching Protocols\r\n"
+		       "Upgrade: websocket\r\n"
+		       "Connection: Upgrade\r\n"
+		       "Sec-WebSocket-Accept: %s\r\n\r\n", accept);
+
+	return send_all(sock, server_buf, len);
+}
+
+/* Echo the frames received from the client back unmasked, until it closes
+ * the connection.
+ */
+static void server_echo(int sock)
+{
+	uint8_t *header = server_buf;
+	uint8_t *payload = &server_buf[SERVER_HEADER_MAX_LEN];
+	uint8_t mask[4];
+	uint64_t len;
+	size_t hdr_len;
+	bool masked;
+
+	while (recv_all(sock, header, 2) == 0) {
+		masked = (header[1] & BIT(7)) != 0;
+		len = header[1] & 0x7f;
+		hdr_len = 2;
+
+		if (len == 126) {
+			if (recv_all(sock, &header[2], 2) < 0) {
+				return;
+			}
+
+			len = sys_get_be16(&header[2]);
+			hdr_len += 2;
+		} else if (len == 127) {
+			if (recv_all(sock, &header[2], 8) < 0) {
+				return;
+			}
+
+			len = sys_get_be64(&header[2]);
+			hdr_len += 8;
+		}
+
+		if (len > MSG_SIZE) {
+			return;
+		}
+
+		if (masked && recv_all(sock, mask, sizeof(mask)) < 0) {
+			return;
+		}
+
+		if (recv_all(sock, payload, len) < 0) {
+			return;
+		}
+
+		if ((header[0] & 0x0f) == WEBSOCKET_OPCODE_CLOSE) {
+			return;
+		}
+
+		for (size_t i = 0; masked && i < len; i++) {
+			payload[i] ^= mask[i % 4];
+		}
+
+		/* Same header without the mask bit, right before the payload */
+		header[1] &= ~BIT(7);
+		memmove(payload - hdr_len, header, hdr_len);
+
+		if (send_all(sock, payload - hdr_len, hdr_len + len) < 0) {
+			return;
+		}
+	}
+}
+
+static void server_entry(void *p1, void *p2, void *p3)
+{
+	int sock;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		sock = accept(listen_sock, NULL, NULL);
+		if (sock < 0) {
+			continue;
+		}
+
+		if (server_handshake(sock) == 0) {
+			server_echo(sock);
+		}
+
+		close(sock);
+	}
+}
+
+static int ws_connect(void)
+{
+	struct websocket_request req;
+	struct sockaddr_in addr;
+	int sock, ws_sock, ret;
+
+	sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(sock >= 0, "Cannot create socket (%d)", errno);
+
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(SERVER_PORT);
+	inet_pton(AF_INET, SERVER_ADDR, &addr.sin_addr);
+
+	ret = connect(sock, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_equal(ret, 0, "Cannot connect (%d)", errno);
+
+	memset(&req, 0, sizeof(req));
+
+	req.host = SERVER_ADDR;
+	req.url = "/";
+	req.tmp_buf = tmp_buf;
+	req.tmp_buf_len = sizeof(tmp_buf);
+
+	ws_sock = websocket_connect(sock, &req, TIMEOUT_MS, NULL);
+	zassert_true(ws_sock >= 0, "Websocket handshake failed (%d)", ws_sock);
+
+	return ws_sock;
+}
+
+static void recv_echo(int ws_sock, size_t len)
+{
+	uint64_t remaining = 0;
+	uint32_t message_type;
+	size_t total = 0;
+	int ret;
+
+	memset(recv_buf, 0, len);
+
+	do {
+		ret = websocket_recv_msg(ws_sock, &recv_buf[total],
+					 sizeof(recv_buf) - total,
+					 &message_type, &remaining, TIMEOUT_MS);
+		zassert_true(ret >= 0, "Cannot receive echo (%d)", ret);
+
+		total += ret;
+	} while (remaining > 0 || total < len);
+
+	zassert_equal(total, len, "Echo length mismatch (%zd)", total);
+	zassert_true(message_type & WEBSOCKET_FLAG_BINARY, "Echo is not binary");
+	zassert_mem_equal(recv_buf, send_buf, len, "Echo data mismatch");
+}
+
+static void report(const char *name, int64_t start)
+{
+	uint32_t ms = MAX(k_uptime_delta(&start), 1);
+
+	TC_PRINT("%s: %u bytes echoed in %u ms, %u kB/s\n", name,
+		 MSG_SIZE * MSG_ROUNDS, ms, (MSG_SIZE * MSG_ROUNDS) / ms);
+}
+
+ZTEST(net_websocket_echo, test_echo_send_msg)
+{
+	int64_t start;
+	int ws_sock, ret;
+
+	ws_sock = ws_connect();
+
+	start = k_uptime_get();
+
+	for (int i = 0; i < MSG_ROUNDS; i++) {
+		ret = websocket_send_msg(ws_sock, send_buf, sizeof(send_buf),
+					 WEBSOCKET_OPCODE_DATA_BINARY, true,
+					 true, TIMEOUT_MS);
+		zassert_equal(ret, sizeof(send_buf), "Cannot send (%d)", ret);
+
+		recv_echo(ws_sock, sizeof(send_buf));
+	}
+
+	report("websocket_send_msg", start);
+
+	websocket_disconnect(ws_sock);
+}
+
+ZTEST(net_websocket_echo, test_echo_send_frame)
+{
+	struct iovec iov[2] = {
+		{ .iov_base = send_buf, .iov_len = sizeof(send_buf) / 2 },
+		{ .iov_base = &send_buf[sizeof(send_buf) / 2],
+		  .iov_len = sizeof(send_buf) / 2 },
+	};
+	int64_t start;
+	int ws_sock, ret;
+
+	ws_sock = ws_connect();
+
+	start = k_uptime_get();
+
+	for (int i = 0; i < MSG_ROUNDS; i++) {
+		ret = websocket_send_frame(ws_sock, iov, ARRAY_SIZE(iov),
+					   WEBSOCKET_OPCODE_DATA_BINARY, true,
+					   true, TIMEOUT_MS);
+		zassert_equal(ret, sizeof(send_buf), "Cannot send (%d)", ret);
+
+		/* The echo is compared with the restored application data */
+		recv_echo(ws_sock, sizeof(send_buf));
+	}
+
+	report("websocket_send_frame", start);
+
+	websocket_disconnect(ws_sock);
+}
+
+static void *setup(void)
+{
+	struct sockaddr_in addr;
+	int ret;
+
+	for (size_t i = 0; i < sizeof(send_buf); i++) {
+		send_buf[i] = i;
+	}
+
+	listen_sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(listen_sock >= 0, "Cannot create socket (%d)", errno);
+
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(SERVER_PORT);
+	inet_pton(AF_INET, SERVER_ADDR, &addr.sin_addr);
+
+	ret = bind(listen_sock, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_equal(ret, 0, "Cannot bind (%d)", errno);
+
+	ret = listen(listen_sock, 1);
+	zassert_equal(ret, 0, "Cannot listen (%d)", errno);
+
+	k_thread_create(&server_thread, server_stack,
+			K_THREAD_STACK_SIZEOF(server_stack), server_entry,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(8), 0, K_NO_WAIT);
+
+	return NULL;
+}
+
+ZTEST_SUITE(net_websocket_echo, NULL, setup, NULL, NULL, NULL);
@@ -21,6 +21,7 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_UTILS_LOG_LEVEL);
 #include <zephyr/sys/printk.h>
 #include <zephyr/net/net_core.h>
 #include <zephyr/net/net_ip.h>
+#include <zephyr/net/net_pkt.h>
 #include <zephyr/net/ethernet.h>
 #include <zephyr/linker/sections.h>
 
@@ -923,4 +924,169 @@ ZTEST(test_utils_fn, test_ip_checksum)
 	}
 }
 
+/* Sums computed independently, see RFC 1071 section 3 for the first one */
+static const uint8_t rfc1071_data[] = {
+	0x00, 0x01, 0xf2, 0x03, 0xf4, 0xf5, 0xf6, 0xf7
+};
+
+static const struct {
+	size_t len;
+	uint16_t sum;
+} checksum_kat[] = {
+	{ 1, 0x0100 },
+	{ 3, 0x1008 },
+	{ 33, 0x8817 },
+	{ 127, 0x9ce3 },
+	{ 129, 0x1e5e },
+	{ 255, 0x3ec6 },
+	{ 1023, 0xfe06 },
+	{ 1499, 0xbc44 },
+};
+
+ZTEST(test_utils_fn, test_ip_checksum_known_answers)
+{
+	static uint8_t buf[CHECKSUM_TEST_LENGTH + 8];
+
+	for (int offset = 0; offset < 8; offset++) {
+		memcpy(buf + offset, rfc1071_data, sizeof(rfc1071_data));
+
+		zassert_equal(calc_chksum(0, buf + offset, sizeof(rfc1071_data)),
+			      0xddf2, "RFC 1071 sum at offset %d", offset);
+		zassert_equal(calc_chksum(0, buf + offset, sizeof(rfc1071_data) - 1),
+			      0xdcfb, "RFC 1071 odd sum at offset %d", offset);
+	}
+
+	for (int i = 0; i < CHECKSUM_TEST_LENGTH; i++) {
+		testdata[i] = (uint8_t)(i * 7 + 1);
+	}
+
+	for (int offset = 0; offset < 8; offset++) {
+		memcpy(buf + offset, testdata, CHECKSUM_TEST_LENGTH);
+
+		for (int i = 0; i < ARRAY_SIZE(checksum_kat); i++) {
+			zassert_equal(calc_chksum(0, buf + offset, checksum_kat[i].len),
+				      checksum_kat[i].sum,
+				      "Sum of %zu bytes at offset %d",
+				      checksum_kat[i].len, offset);
+		}
+	}
+}
+
+#define CHECKSUM_BENCH_ROUNDS 1000
+
+ZTEST(test_utils_fn, test_ip_checksum_bench)
+{
+	static const size_t lengths[] = { 64, 512, CHECKSUM_TEST_LENGTH - 1 };
+	volatile uint16_t sum = 0U;
+	uint32_t start, cycles;
+
+	for (int i = 0; i < CHECKSUM_TEST_LENGTH; i++) {
+		testdata[i] = (uint8_t)i;
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(lengths); i++) {
+		for (int offset = 0; offset < 2; offset++) {
+			start = k_cycle_get_32();
+
+			for (int j = 0; j < CHECKSUM_BENCH_ROUNDS; j++) {
+				sum = calc_chksum(sum, testdata + offset, lengths[i]);
+			}
+
+			cycles = k_cycle_get_32() - start;
+
+			TC_PRINT("%zu bytes at offset %d: %u cycles per KiB\n",
+				 lengths[i], offset,
+				 (uint32_t)((uint64_t)cycles * 1024U /
+					    (CHECKSUM_BENCH_ROUNDS * lengths[i])));
+		}
+	}
+}
+
+static uint8_t copydata[CHECKSUM_TEST_LENGTH + 8];
+
+ZTEST(test_utils_fn, test_ip_checksum_copy)
+{
+	uint16_t sum_got;
+	uint16_t sum_exp;
+
+	for (int i = 0; i < CHECKSUM_TEST_LENGTH; i++) {
+		testdata[i] = (uint8_t)(i + 7) * 31;
+	}
+
+	for (int offset = 0; offset < 8; offset++) {
+		for (int length = 1; length <= CHECKSUM_TEST_LENGTH - 8;
+		     length += (length < 64) ? 1 : 61) {
+			memset(copydata, 0, sizeof(copydata));
+
+			sum_exp = calc_chksum(length, testdata + offset, length);
+			sum_got = calc_chksum_copy(length, copydata + (7 - offset),
+						   testdata + offset, length);
+
+			zassert_equal(sum_got, sum_exp,
+				      "Checksum mismatch offset %d length %d",
+				      offset, length);
+			zassert_mem_equal(copydata + (7 - offset),
+					  testdata + offset, length,
+					  "Copy mismatch offset %d length %d",
+					  offset, length);
+		}
+	}
+}
+
+#define CHECKSUM_PKT_LENGTH 500
+
+ZTEST(test_utils_fn, test_pkt_write_chksum)
+{
+	static const size_t parts[] = { 1, 2, 3, 5, 64, 127, 128, 170 };
+	struct net_pkt *pkt;
+	uint16_t sum_got = 0U;
+	uint16_t sum_exp;
+	size_t offset = 0;
+
+	for (int i = 0; i < CHECKSUM_PKT_LENGTH; i++) {
+		testdata[i] = (uint8_t)(i + 3) * 11;
+	}
+
+	pkt = net_pkt_alloc_with_buffer(NULL, CHECKSUM_PKT_LENGTH, AF_INET, 0,
+					K_NO_WAIT);
+	zassert_not_null(pkt, "Cannot allocate pkt");
+
+	/* Write in parts of odd and even length so that the data does not
+	 * follow the fragment boundaries.
+	 */
+	for (int i = 0; i < ARRAY_SIZE(parts); i++) {
+		uint16_t part = 0U;
+		uint32_t tmp;
+
+		zassert_equal(net_pkt_write_chksum(pkt, testdata + offset,
+						   parts[i], &part), 0,
+			      "Write failed");
+
+		if (offset & 1) {
+			part = __bswap_16(part);
+		}
+
+		tmp = (uint32_t)sum_got + part;
+		sum_got = (uint16_t)((tmp & 0xffff) + (tmp >> 16));
+		offset += parts[i];
+	}
+
+	zassert_equal(offset, CHECKSUM_PKT_LENGTH, "Invalid test data");
+	zassert_equal(net_pkt_get_len(pkt), CHECKSUM_PKT_LENGTH,
+		      "Invalid pkt length");
+
+	memset(copydata, 0, sizeof(copydata));
+	net_pkt_cursor_init(pkt);
+	zassert_equal(net_pkt_read(pkt, copydata, CHECKSUM_PKT_LENGTH), 0,
+		      "Read failed");
+	zassert_mem_equal(copydata, testdata, CHECKSUM_PKT_LENGTH,
+			  "Data mismatch");
+
+	sum_exp = calc_chksum(0, testdata, CHECKSUM_PKT_LENGTH);
+	zassert_equal(sum_got, sum_exp, "Checksum mismatch %x vs %x",
+		      sum_got, sum_exp);
+
+	net_pkt_unref(pkt);
+}
+
 ZTEST_SUITE(test_utils_fn, NULL, NULL, NULL, NULL, NULL);